@@ -995,7 +995,11 @@ namespace quda {
 
   /**
      @brief Generate a random noise spinor.  This variant just
-     requires a seed and will create and destroy the random number state.
+     requires a seed: the noise is drawn from counter-based Philox
+     streams keyed on the seed and the global site index, so it needs
+     no generator state and is independent of the process grid, the
+     thread count and the location of the field.  Host fields in
+     space-spin-color order are filled in place.
      @param src The colorspinorfield
      @param seed Seed
      @param type The type of noise to create (QUDA_NOISE_GAUSSIAN or QUDA_NOISE_UNIFORM)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <invert_quda.h>
+#include <tiered_vector_store.h>
 #include <vector>
 #include <complex_quda.h>
 
@@ -16,7 +17,8 @@ namespace quda {
 	We use this to set (per-level) parameters */
     QudaEigParam  &eig_global;
 
-    /** Buffer for Ritz vectors 
+    /** Buffer for Ritz vectors, which may hold fewer than tot_dim
+        components in which case the remainder are kept in host memory
         For staggered: we need to reduce dimensionality of each component?
      */
     ColorSpinorField *RV;  
@@ -96,6 +98,10 @@ namespace quda {
     /** Deflation matrix operation result */
     ColorSpinorField *Av_sloppy;
 
+    /** The deflation space: the components of RV followed by any
+        vectors spilled to host memory */
+    TieredVectorStore *rv;
+
 
   public:
     /** 
@@ -142,15 +148,13 @@ namespace quda {
 
     /**
        @brief Load the eigen space vectors from file
-       @param RV Loaded eigen-space vectors (pre-allocated)
      */
-    void loadVectors(ColorSpinorField *RV);
+    void loadVectors();
 
     /**
        @brief Save the eigen space vectors in file
-       @param RV Save eigen-space vectors from here
      */
-    void saveVectors(ColorSpinorField *RV);
+    void saveVectors();
 
     /**
        @brief Test whether the deflation space is complete
@@ -1103,14 +1103,19 @@ public:
 			    ColorSpinorField &Tmp1, ColorSpinorField &Tmp2) const = 0;
 
 
-    unsigned long long flops() const { return dirac->Flops(); }
+    unsigned long long flops() const { return dirac ? dirac->Flops() : 0; }
 
 
     QudaMatPCType getMatPCType() const { return dirac->getMatPCType(); }
     
     virtual int getStencilSteps() const = 0; 
 
-    std::string Type() const { return typeid(*dirac).name(); }
+    /**
+       @return The type of the underlying Dirac operator, or that of
+       the matrix itself when it wraps an operator with no Dirac
+       object, e.g., a host reference implementation
+    */
+    std::string Type() const { return dirac ? typeid(*dirac).name() : typeid(*this).name(); }
     
     bool isStaggered() const {
       return (Type() == typeid(DiracStaggeredPC).name() ||
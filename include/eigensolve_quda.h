@@ -4,6 +4,7 @@
 #include <quda_internal.h>
 #include <dirac_quda.h>
 #include <color_spinor_field.h>
+#include <vector_compression.h>
 
 namespace quda
 {
@@ -40,6 +41,12 @@ protected:
 
     double *residua;
 
+    // Chebyshev filter estimation
+    //----------------------------
+    int poly_deg_max;        /** Maximum polynomial degree when the filter is estimated */
+    long long n_mat_vec;     /** Number of operator applications */
+    long long n_mat_vec_est; /** Number of operator applications spent estimating the filter */
+
     // Device side vector workspace
     std::vector<ColorSpinorField *> r;
     std::vector<ColorSpinorField *> d_vecs_tmp;
@@ -95,6 +102,37 @@ public:
     */
     void chebyOp(const DiracMatrix &mat, ColorSpinorField &out, const ColorSpinorField &in);
 
+    /**
+       @brief Estimate the Chebyshev filter from a few Lanczos steps on
+       the operator.  a_max is the Lanczos upper bound on the spectrum
+       with a safety margin.  a_min is placed at a Weyl-law estimate of
+       the nEv-th eigenvalue, and the degree is the lowest that damps
+       [a_min, a_max] by poly_acc_rate relative to the estimated
+       nConv-th eigenvalue.
+       @param[in] mat Matrix operator
+       @param[in] in Vector used to create the work space
+    */
+    void estimateChebyParams(const DiracMatrix &mat, const ColorSpinorField &in);
+
+    /**
+       @brief Re-estimate the Chebyshev filter at a restart, using the
+       Rayleigh quotients of the nConv-th and nEv-th Ritz vectors in
+       place of the Weyl-law estimates.  Since a new filter invalidates
+       the Krylov space, the filter is only replaced when a_min or the
+       degree changes significantly.
+       @param[in] mat Matrix operator
+       @param[in] kSpace Krylov space, with the Ritz vectors first
+       @param[in] n_ritz Number of Ritz vectors in kSpace
+       @return Whether the filter was replaced
+    */
+    bool updateChebyParams(const DiracMatrix &mat, std::vector<ColorSpinorField *> &kSpace, int n_ritz);
+
+    /**
+       @brief Print the Chebyshev filter parameters and the operator
+       applications spent on them
+    */
+    void printChebyParams() const;
+
     /**
        @brief Orthogonalise input vector r against
        vector space v using block-BLAS
@@ -105,6 +143,36 @@ public:
     */
     Complex blockOrthogonalize(std::vector<ColorSpinorField *> v, std::vector<ColorSpinorField *> r, int j);
 
+    /**
+       @brief Rotate a vector space onto a new basis in a single pass,
+       kSpace[locked + i] = sum_j kSpace[locked + j] * rot[j * keep + i]
+       for i < keep and j < dim.  The rotation is one multi-blas call,
+       so each basis vector is read once per tile of output vectors
+       rather than once per output vector.  The new vectors are formed
+       in the scratch vectors kSpace[offset, offset + keep), which are
+       created if needed, and then swapped into place.
+       @param[in,out] kSpace The vector space
+       @param[in] rot Row-major dim x keep rotation matrix
+       @param[in] offset Index of the first scratch vector (>= locked + dim)
+       @param[in] dim Number of vectors being rotated
+       @param[in] keep Number of vectors in the new basis
+       @param[in] locked Number of leading vectors left untouched
+    */
+    static void rotateVecs(std::vector<ColorSpinorField *> &kSpace, const double *rot, int offset, int dim, int keep,
+                           int locked);
+
+    /**
+       @brief Complex variant of the single pass basis rotation
+       @param[in,out] kSpace The vector space
+       @param[in] rot Row-major dim x keep rotation matrix
+       @param[in] offset Index of the first scratch vector (>= locked + dim)
+       @param[in] dim Number of vectors being rotated
+       @param[in] keep Number of vectors in the new basis
+       @param[in] locked Number of leading vectors left untouched
+    */
+    static void rotateVecs(std::vector<ColorSpinorField *> &kSpace, const Complex *rot, int offset, int dim, int keep,
+                           int locked);
+
     /**
        @brief Deflate vector with Eigenvectors
        @param[in] vec_defl The deflated vector
@@ -143,18 +211,22 @@ public:
     void computeEvals(const DiracMatrix &mat, std::vector<ColorSpinorField *> &evecs, std::vector<Complex> &evals, int k);
 
     /**
-       @brief Load vectors from file
+       @brief Load vectors from file, either written through QIO or
+       by a CompressedVectorStore
        @param[in] eig_vecs The eigenvectors to load
        @param[in] file The filename to load
     */
-    void loadVectors(std::vector<ColorSpinorField *> &eig_vecs, std::string file);
+    static void loadVectors(std::vector<ColorSpinorField *> &eig_vecs, std::string file);
 
     /**
        @brief Save vectors to file
        @param[in] eig_vecs The eigenvectors to save
        @param[in] file The filename to save
+       @param[in] compress Compression parameters, the vectors are
+       written at full precision through QIO if compression is disabled
     */
-    void saveVectors(const std::vector<ColorSpinorField *> &eig_vecs, std::string file);
+    static void saveVectors(const std::vector<ColorSpinorField *> &eig_vecs, std::string file,
+                            const VectorCompressionParam &compress = VectorCompressionParam());
 
     /**
        @brief Load and check eigenpairs from file
@@ -231,6 +303,85 @@ public:
 
   };
 
+  /**
+     @brief Block Thick Restarted Lanczos Method.  Each Lanczos step
+     advances a block of block_size vectors, so the inner products and
+     orthogonalization of a step are carried out with multi-blas and
+     multi-reduce kernels over the whole block, and the Rayleigh-Ritz
+     is performed on the Hermitian block-tridiagonal (arrow after a
+     restart) projection of the operator.
+  */
+  class BLKTRLM : public EigenSolver
+  {
+
+public:
+    const DiracMatrix &mat;
+    /**
+       @brief Constructor for Block Thick Restarted Eigensolver class
+       @param eig_param The eigensolver parameters
+       @param mat The operator to solve
+       @param profile Time Profile
+    */
+    BLKTRLM(QudaEigParam *eig_param, const DiracMatrix &mat, TimeProfile &profile);
+
+    /**
+       @brief Destructor for Block Thick Restarted Eigensolver class
+    */
+    virtual ~BLKTRLM();
+
+    int block_size; /** Number of vectors advanced per Lanczos step */
+
+    // Projected operator, nKr x nKr Hermitian and stored row-major
+    std::vector<Complex> T;
+
+    // Off-diagonal block coupling the residual block to the last block of the Krylov space
+    std::vector<Complex> beta_last;
+
+    // Ritz values (wanted end of the spectrum first) and their eigenvectors of T, stored column by column
+    std::vector<double> ritz_val;
+    std::vector<Complex> ritz_mat;
+
+    // Used to clone vectors and resize arrays.
+    ColorSpinorParam csParam;
+
+    /**
+       @brief Compute eigenpairs
+       @param[in] kSpace Krylov vector space
+       @param[in] evals Computed eigenvalues
+    */
+    void operator()(std::vector<ColorSpinorField *> &kSpace, std::vector<Complex> &evals);
+
+    /**
+       @brief Block Lanczos step: extends the Krylov space by one
+       block, writing the next block into v[j + block_size]...
+       @param[in] v Vector space
+       @param[in] j Index of the first vector of the block being computed
+    */
+    void blockLanczosStep(std::vector<ColorSpinorField *> &v, int j);
+
+    /**
+       @brief Orthonormalize a block of vectors in place with two
+       passes of Cholesky QR, such that on input q = q_out * R
+       @param[in,out] q Block of vectors
+       @param[out] R Upper triangular block_size x block_size factor, row-major
+    */
+    void orthonormalizeBlock(std::vector<ColorSpinorField *> &q, Complex *R);
+
+    /**
+       @brief Get the eigendecomposition of the projected operator and
+       the residua of the Ritz pairs
+    */
+    void eigensolveFromBlockArrowMat();
+
+    /**
+       @brief Rotate the Krylov space onto the leading Ritz vectors and
+       rebuild the projected operator as an arrow matrix
+       @param[in] kSpace The Krylov space
+       @param[in] n_keep Number of Ritz vectors to keep
+    */
+    void computeKeptRitz(std::vector<ColorSpinorField *> &kSpace, int n_keep);
+  };
+
   /**
      arpack_solve()
 
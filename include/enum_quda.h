@@ -125,6 +125,8 @@ extern "C" {
     QUDA_CA_CGNE_INVERTER,
     QUDA_CA_CGNR_INVERTER,
     QUDA_CA_GCR_INVERTER,
+    QUDA_GCRODR_INVERTER,
+    QUDA_POLYNOMIAL_INVERTER,
     QUDA_INVALID_INVERTER = QUDA_INVALID_ENUM
   } QudaInverterType;
 
@@ -132,6 +134,7 @@ extern "C" {
     QUDA_EIG_TR_LANCZOS, // Thick restarted lanczos solver
     QUDA_EIG_IR_LANCZOS, // Implicitly Restarted Lanczos solver (not implemented)
     QUDA_EIG_IR_ARNOLDI, // Implicitly Restarted Arnoldi solver (not implemented)
+    QUDA_EIG_BLK_TR_LANCZOS, // Block Thick restarted lanczos solver
     QUDA_EIG_INVALID = QUDA_INVALID_ENUM
   } QudaEigType;
 
@@ -339,6 +342,8 @@ extern "C" {
     QUDA_LEXICOGRAPHIC_SITE_ORDER, // lexicographic ordering
     QUDA_EVEN_ODD_SITE_ORDER, // QUDA and QDP use this
     QUDA_ODD_EVEN_SITE_ORDER, // CPS uses this
+    QUDA_BLOCKED_SITE_ORDER,  // even-odd with each parity ordered by 4-d tiles (host fields only)
+    QUDA_MORTON_SITE_ORDER,   // even-odd with each parity ordered along a Morton curve (host fields only)
     QUDA_INVALID_SITE_ORDER = QUDA_INVALID_ENUM
   } QudaSiteOrder;
 
@@ -515,6 +520,13 @@ extern "C" {
     QUDA_CONTRACT_GAMMA_INVALID = QUDA_INVALID_ENUM
   } QudaContractGamma;
 
+  typedef enum QudaWFlowType_s {
+    QUDA_WFLOW_TYPE_WILSON,   // Wilson action
+    QUDA_WFLOW_TYPE_SYMANZIK, // tree-level Symanzik (Luscher-Weisz) action
+    QUDA_WFLOW_TYPE_ZEUTHEN,  // Symanzik action with the O(a^2) improved flow equation
+    QUDA_WFLOW_TYPE_INVALID = QUDA_INVALID_ENUM
+  } QudaWFlowType;
+
   // Allows to choose an appropriate external library
   typedef enum QudaExtLibType_s {
     QUDA_CUSOLVE_EXTLIB,
@@ -123,12 +123,15 @@
 #define QUDA_CA_CGNE_INVERTER 23
 #define QUDA_CA_CGNR_INVERTER 24
 #define QUDA_CA_GCR_INVERTER 25
+#define QUDA_GCRODR_INVERTER 26
+#define QUDA_POLYNOMIAL_INVERTER 27
 #define QUDA_INVALID_INVERTER QUDA_INVALID_ENUM
 
 #define QudaEigType integer(4)
 #define QUDA_EIG_TR_LANCZOS 0 // Thick Restarted Lanczos Solver
 #define QUDA_EIG_IR_LANCZOS 1 // Implicitly restarted Lanczos solver (not yet implemented)
 #define QUDA_EIG_IR_ARNOLDI 2 // Implicitly restarted Arnoldi solver (not yet implemented)
+#define QUDA_EIG_BLK_TR_LANCZOS 3 // Block Thick Restarted Lanczos Solver
 #define QUDA_EIG_INVALID QUDA_INVALID_ENUM
 
 #define QudaEigSpectrumType integer(4)
@@ -309,6 +312,8 @@
 #define QUDA_LEXICOGRAPHIC_SITE_ORDER 0 // lexicographic ordering
 #define QUDA_EVEN_ODD_SITE_ORDER 1 // QUDA and QDP use this
 #define QUDA_ODD_EVEN_SITE_ORDER 2 // CPS uses this
+#define QUDA_BLOCKED_SITE_ORDER 3 // even-odd with each parity ordered by 4-d tiles (host fields only)
+#define QUDA_MORTON_SITE_ORDER 4 // even-odd with each parity ordered along a Morton curve (host fields only)
 #define QUDA_INVALID_SITE_ORDER QUDA_INVALID_ENUM
   
 ! Degree of freedom ordering
@@ -459,6 +464,12 @@
 #define QUDA_CONTRACT_GAMMA_S34 15
 #define QUDA_CONTRACT_GAMMA_INVALID QUDA_INVALID_ENUM
 
+#define QudaWFlowType integer(4)
+#define QUDA_WFLOW_TYPE_WILSON   0
+#define QUDA_WFLOW_TYPE_SYMANZIK 1
+#define QUDA_WFLOW_TYPE_ZEUTHEN  2
+#define QUDA_WFLOW_TYPE_INVALID QUDA_INVALID_ENUM
+
 #define QudaExtLibType integer(4)
 #define QUDA_CUSOLVE_EXTLIB 0
 #define QUDA_EIGEN_EXTLIB 1
@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+   @file fft_quda.h
+
+   @brief Backend-neutral interface to the 4-d complex-to-complex FFTs
+   of a lattice field, as used by the Fourier-accelerated gauge
+   fixing.  A field is Volume() complex numbers in lexicographic
+   order, x fastest.  A plan is created for a lattice and precision
+   with a backend, and then transforms any number of fields:
+
+   - cuFFT for device fields: two batched 2-d transforms with the
+     lattice transposed in between, so that the momentum-space field
+     is in (z,t,x,y) order;
+
+   - a built-in mixed-radix FFT for host fields: each dimension is
+     transformed in turn, with the pencils (the lines along that
+     dimension) gathered in tiles into thread-local buffers, where a
+     Stockham autosort FFT with radix-4, 2, 3 and 5 butterflies (and a
+     plain DFT for any other prime factor) runs across the pencils of
+     the tile in SIMD lanes;
+
+   - FFTW for host fields, when QUDA is built with QUDA_FFTW, using
+     its threaded 4-d plans.
+
+   The transforms are unnormalized, with the forward transform taking
+   the exp(-i p.x) sign as in cuFFT and FFTW.
+ */
+
+#include <quda_internal.h>
+
+namespace quda {
+
+  enum FFTBackend { FFT_BACKEND_CUFFT, FFT_BACKEND_BUILTIN, FFT_BACKEND_FFTW, FFT_BACKEND_INVALID };
+
+  /**
+     @brief The backend used for host fields: the one named by the
+     environment variable QUDA_FFT_BACKEND ("builtin" or "fftw"),
+     else FFTW when QUDA is built with it, else the built-in FFT
+   */
+  FFTBackend hostFFTBackend();
+
+  /**
+     @brief Name of a backend, for reporting
+   */
+  const char *fftBackendString(FFTBackend backend);
+
+  /**
+     @brief A plan for the 4-d FFT of fields on a lattice
+   */
+  class FFTPlan
+  {
+  protected:
+    int X[4];
+    long long volume;
+    QudaPrecision precision;
+    FFTBackend backend;
+    int layout[4]; // dimensions of the momentum-space field, fastest first
+
+    FFTPlan(const int *X, QudaPrecision precision, FFTBackend backend);
+
+  public:
+    virtual ~FFTPlan() { }
+
+    /**
+       @brief Create a plan
+       @param[in] backend The backend
+       @param[in] X Lattice dimensions
+       @param[in] precision Precision of the fields (single or double)
+       @return The plan, to be deleted by the caller
+     */
+    static FFTPlan *create(FFTBackend backend, const int *X, QudaPrecision precision);
+
+    /**
+       @brief Forward transform in to out.  The input field may be
+       overwritten, and must not alias the output.
+     */
+    virtual void forward(void *in, void *out) = 0;
+
+    /**
+       @brief Backward (inverse, unnormalized) transform in to out.
+       The input field may be overwritten, and must not alias the
+       output.
+     */
+    virtual void backward(void *in, void *out) = 0;
+
+    /**
+       @brief The lattice dimensions in the order of the
+       momentum-space field, fastest first: momentum p is at
+       p[l[0]] + X[l[0]] * (p[l[1]] + X[l[1]] * (...)) with l = Layout()
+     */
+    const int *Layout() const { return layout; }
+
+    FFTBackend Backend() const { return backend; }
+    long long Volume() const { return volume; }
+
+    /**
+       @brief Nominal flops of one transform, 5 V log2(V)
+     */
+    long long flops() const;
+
+    /**
+       @brief Bytes of one transform, assuming each pass over the
+       field reads and writes it once
+     */
+    virtual long long bytes() const = 0;
+  };
+
+} // namespace quda
@@ -0,0 +1,111 @@
+#pragma once
+
+/**
+   @file gauge_ensemble.h
+
+   @brief Streaming analysis of a gauge ensemble.  The configurations
+   are read in turn into one of two host buffers by a background
+   thread while the previous configuration runs through a pipeline of
+   gauge operations (smearing, gradient flow and measurements), so
+   that reading and computing overlap.  The measurements are streamed
+   as JSON lines, one record per measurement, as each configuration
+   completes.
+ */
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <quda.h>
+
+namespace quda
+{
+
+  /**
+     Reads the configuration in a file into the host link arrays
+     gauge[4], in QDP order with the precision (cpu_prec) and local
+     dimensions (X) of the ensemble.  When prefetching it is called
+     from a background thread, concurrently with the pipeline, so a
+     reader that communicates (e.g., read_gauge_field with QIO) needs
+     a thread-safe communications layer or prefetching disabled.
+     read_gauge_field itself is wrapped as
+
+       [&](const std::string &file, void **gauge) {
+         read_gauge_field(file.c_str(), gauge, param.cpu_prec, param.X, argc, argv);
+       }
+  */
+  typedef std::function<void(const std::string &file, void **gauge)> GaugeReader;
+
+  /**
+     One stage of the analysis pipeline.  The smearing and flow stages
+     replace the field seen by the stages that follow them, the flow
+     and measurement stages emit records.
+  */
+  struct GaugeOperation {
+    enum Type { APE, STOUT, OVRIMP_STOUT, WFLOW, MEASURE };
+
+    Type type;
+    int n_steps;             // smearing steps
+    double alpha;            // APE smearing parameter
+    double rho;              // STOUT smearing parameter
+    double epsilon;          // over-improvement parameter
+    QudaWFlowType flow_type; // flow action
+    double t_max;            // final flow time
+    double step;             // flow step size (initial step size if adaptive)
+    double tolerance;        // adaptive flow tolerance (zero for a fixed step size)
+    int meas_interval;       // flow measurement interval (zero for none)
+
+    static GaugeOperation ape(int n_steps, double alpha);
+    static GaugeOperation stout(int n_steps, double rho);
+    static GaugeOperation ovrImpStout(int n_steps, double rho, double epsilon);
+    static GaugeOperation wflow(QudaWFlowType flow_type, double t_max, double step, double tolerance = 0.0,
+                                int meas_interval = 1);
+    static GaugeOperation measure();
+  };
+
+  /**
+     Where the time of an ensemble analysis went
+  */
+  struct EnsembleSummary {
+    int n_configs;       // configurations analyzed
+    double read_secs;    // time spent reading, in the background when prefetching
+    double wait_secs;    // time the pipeline waited for a configuration to be read
+    double compute_secs; // time spent in the pipeline
+    double total_secs;   // wall-clock time of the analysis
+  };
+
+  /**
+     @brief Run every configuration of an ensemble through a pipeline
+     of gauge operations.  The next configuration is read by a
+     background thread into a second host buffer while the current one
+     is processed.  Each measurement is written to out (on rank 0) as
+     a JSON object on its own line, with the configuration index and
+     file, the index and type of the stage that made it, and the
+     observables:
+
+       {"config": 0, "file": "...", "op": 1, "type": "measure", "plaquette": [p, p_s, p_t],
+        "polyakov_loop": [re, im], "rectangle": r, "E": e, "Q": q}
+       {"config": 0, "file": "...", "op": 2, "type": "wflow", "t": t, "plaquette": p,
+        "E_plaq": e, "E": e, "t2E": t^2 e, "Q": q}
+
+     The output is flushed after each configuration.
+
+     @param[in] files The configuration files, in the order analyzed
+     @param[in] pipeline The operations applied to each configuration
+     @param[in] param Layout of the configurations: cpu_prec, X,
+     gauge_order (which must be QDP) and the boundary conditions; on
+     the device the pipeline runs at cuda_prec
+     @param[in] reader Reads a configuration into host link arrays
+     @param[out] out Stream the records are written to
+     @param[in] location Where the pipeline runs (the measurements are
+     always made on the host)
+     @param[in] prefetch Whether to read the next configuration in the
+     background
+     @return Timing summary
+  */
+  EnsembleSummary analyzeEnsemble(const std::vector<std::string> &files, const std::vector<GaugeOperation> &pipeline,
+                                  const QudaGaugeParam &param, const GaugeReader &reader, std::ostream &out,
+                                  QudaFieldLocation location = QUDA_CPU_FIELD_LOCATION, bool prefetch = true);
+
+} // namespace quda
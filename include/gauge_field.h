@@ -47,6 +47,9 @@ namespace quda {
     /** Size of MILC site struct (only if gauge_order=MILC_SITE_GAUGE_ORDER) */
     size_t site_size;
 
+    /** Ordering of the sites within each parity (host fields only may be reordered) */
+    QudaSiteOrder siteOrder;
+
     // Default constructor
     GaugeFieldParam(void *const h_gauge = NULL) :
       LatticeFieldParam(),
@@ -68,7 +71,8 @@ namespace quda {
       staggeredPhaseApplied(false),
       i_mu(0.0),
       site_offset(0),
-      site_size(0)
+      site_size(0),
+      siteOrder(QUDA_EVEN_ODD_SITE_ORDER)
     {
     }
 
@@ -95,7 +99,8 @@ namespace quda {
       staggeredPhaseApplied(false),
       i_mu(0.0),
       site_offset(0),
-      site_size(0)
+      site_size(0),
+      siteOrder(QUDA_EVEN_ODD_SITE_ORDER)
     {
     }
 
@@ -108,7 +113,7 @@ namespace quda {
       create(QUDA_REFERENCE_FIELD_CREATE), geometry(QUDA_VECTOR_GEOMETRY),
       compute_fat_link_max(false), staggeredPhaseType(param.staggered_phase_type),
       staggeredPhaseApplied(param.staggered_phase_applied), i_mu(param.i_mu),
-      site_offset(param.gauge_offset), site_size(param.site_size)
+      site_offset(param.gauge_offset), site_size(param.site_size), siteOrder(QUDA_EVEN_ODD_SITE_ORDER)
 	{
 	  switch(link_type) {
 	  case QUDA_SU3_LINKS:
@@ -223,6 +228,11 @@ namespace quda {
       */
       size_t site_size;
 
+      /**
+         Ordering of the sites within each parity
+      */
+      QudaSiteOrder siteOrder;
+
       /**
          Compute the required extended ghost zone sizes and offsets
          @param[in] R Radius of the ghost zone
@@ -342,6 +352,11 @@ namespace quda {
      */
     size_t SiteSize() const { return site_size; }
 
+    /**
+       @return The ordering of the sites within each parity
+     */
+    QudaSiteOrder SiteOrder() const { return siteOrder; }
+
     /**
        Set all field elements to zero (virtual)
     */
@@ -709,6 +724,16 @@ namespace quda {
   void copyExtendedGauge(GaugeField &out, const GaugeField &in,
 			 QudaFieldLocation location, void *Out=0, void *In=0);
 
+  /**
+     This function creates a copy of a gauge field extended by R[d]
+     sites in each dimension, with the halo filled by an extended
+     ghost exchange.  Defined in copy_gauge_extended.cu.
+     @param in The input field, which must not be extended
+     @param R The halo depth in each dimension
+     @return The extended field, which the caller must delete
+  */
+  GaugeField *extendGaugeField(const GaugeField &in, const int *R);
+
   /**
      This function is used for  extracting the gauge ghost zone from a
      gauge field array.  Defined in extract_gauge_ghost.cu.
@@ -2144,14 +2144,35 @@ namespace quda {
       typedef typename mapper<Float>::type RegType;
       Float *gauge[QUDA_MAX_DIM];
       const int volumeCB;
+      void *backup_h; //! host memory for backing up the field when tuning
     QDPOrder(const GaugeField &u, Float *gauge_=0, Float **ghost_=0)
-      : LegacyOrder<Float,length>(u, ghost_), volumeCB(u.VolumeCB())
+      : LegacyOrder<Float,length>(u, ghost_), volumeCB(u.VolumeCB()), backup_h(nullptr)
 	{ for (int i=0; i<4; i++) gauge[i] = gauge_ ? ((Float**)gauge_)[i] : ((Float**)u.Gauge_p())[i]; }
-    QDPOrder(const QDPOrder &order) : LegacyOrder<Float,length>(order), volumeCB(order.volumeCB) {
+    QDPOrder(const QDPOrder &order) : LegacyOrder<Float,length>(order), volumeCB(order.volumeCB), backup_h(nullptr) {
 	for(int i=0; i<4; i++) gauge[i] = order.gauge[i];
       }
       virtual ~QDPOrder() { ; }
 
+      /**
+	 @brief Backup the field when tuning a host launch
+      */
+      void save() {
+	if (backup_h) errorQuda("Already allocated host backup");
+	const size_t bytes = 2 * volumeCB * length * sizeof(Float);
+	backup_h = safe_malloc(this->geometry * bytes);
+	for (int d=0; d<this->geometry; d++) memcpy(static_cast<char*>(backup_h) + d*bytes, gauge[d], bytes);
+      }
+
+      /**
+	 @brief Restore the field after tuning a host launch
+      */
+      void load() {
+	const size_t bytes = 2 * volumeCB * length * sizeof(Float);
+	for (int d=0; d<this->geometry; d++) memcpy(gauge[d], static_cast<char*>(backup_h) + d*bytes, bytes);
+	host_free(backup_h);
+	backup_h = nullptr;
+      }
+
       __device__ __host__ inline void load(RegType v[length], int x, int dir, int parity, Float inphase = 1.0) const
       {
 #if defined( __CUDA_ARCH__) && !defined(DISABLE_TROVE)
@@ -2293,14 +2314,34 @@ namespace quda {
     Float *gauge;
     const int volumeCB;
     const int geometry;
+    void *backup_h; //! host memory for backing up the field when tuning
   MILCOrder(const GaugeField &u, Float *gauge_=0, Float **ghost_=0) :
     LegacyOrder<Float,length>(u, ghost_), gauge(gauge_ ? gauge_ : (Float*)u.Gauge_p()),
-      volumeCB(u.VolumeCB()), geometry(u.Geometry()) { ; }
+      volumeCB(u.VolumeCB()), geometry(u.Geometry()), backup_h(nullptr) { ; }
   MILCOrder(const MILCOrder &order) : LegacyOrder<Float,length>(order),
-      gauge(order.gauge), volumeCB(order.volumeCB), geometry(order.geometry)
+      gauge(order.gauge), volumeCB(order.volumeCB), geometry(order.geometry), backup_h(nullptr)
       { ; }
     virtual ~MILCOrder() { ; }
 
+    /**
+       @brief Backup the field when tuning a host launch
+    */
+    void save() {
+      if (backup_h) errorQuda("Already allocated host backup");
+      const size_t bytes = 2 * volumeCB * geometry * length * sizeof(Float);
+      backup_h = safe_malloc(bytes);
+      memcpy(backup_h, gauge, bytes);
+    }
+
+    /**
+       @brief Restore the field after tuning a host launch
+    */
+    void load() {
+      memcpy(gauge, backup_h, 2 * volumeCB * geometry * length * sizeof(Float));
+      host_free(backup_h);
+      backup_h = nullptr;
+    }
+
     __device__ __host__ inline void load(RegType v[length], int x, int dir, int parity, Float inphase = 1.0) const
     {
 #if defined( __CUDA_ARCH__) && !defined(DISABLE_TROVE)
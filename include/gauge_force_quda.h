@@ -1,10 +1,56 @@
 #ifndef _GAUGE_FORCE_QUDA_H
 #define _GAUGE_FORCE_QUDA_H
 
+#include <vector>
+
 namespace quda {
 
   /**
-     @brief Compute the gauge-force contribution to the momentum
+     A node of a compiled path table: one link of the partial product
+     of one or more paths that start with the same links.
+  */
+  struct GaugePathNode {
+    int dir;      // direction of the link
+    int dx[4];    // displacement of the site of the link from x
+    int odd;      // parity of the displacement
+    int depth;    // number of links preceding this one in the path
+    int dagger;   // whether the path runs backwards along the link
+    double coeff; // sum of the coefficients of the paths ending here
+  };
+
+  /**
+     @brief The paths of a gauge action compiled into a prefix tree
+     for each direction.  Paths sharing their leading links share the
+     nodes of those links, so that each distinct partial product is
+     evaluated once per site.  The nodes of a tree are stored in
+     depth-first order, so the parent of a node is the last node
+     preceding it at the depth above.
+   */
+  struct GaugePathPlan {
+    std::vector<GaugePathNode> nodes; // the trees of the four directions in turn
+    int begin[5];                     // the tree of direction mu is nodes [begin[mu], begin[mu+1])
+    int max_depth;                    // length of the longest path
+    int num_paths;                    // number of paths with non-zero coefficient
+    long long naive_multiplies;       // matrix multiplies per site walking each path separately
+    long long multiplies;             // matrix multiplies per site walking the trees
+
+    /**
+       @brief Compile a path table
+       @param[in] input_path Host-array holding all path contributions for the gauge action
+       @param[in] length Host array holding the length of all paths
+       @param[in] path_coeff Coefficient of each path
+       @param[in] num_paths Numer of paths
+     */
+    GaugePathPlan(int ***input_path, const int *length, const double *path_coeff, int num_paths);
+  };
+
+  /**
+     @brief Compute the gauge-force contribution to the momentum.  The
+     paths are compiled into a GaugePathPlan, which is evaluated on
+     the device or threaded over the sites on the host according to
+     the location of the fields.  On the host the momentum must be in
+     MILC order with reconstruct 10 and the gauge field in QDP or MILC
+     order.
      @param[out] mom Momentum field
      @param[in] u Gauge field (extended when running no multiple GPUs)
      @param[in] coeff Step-size coefficient
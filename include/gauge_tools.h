@@ -1,3 +1,4 @@
+#include <vector>
 #include <random_quda.h>
 
 namespace quda
@@ -9,10 +10,36 @@ namespace quda
      @param[in] U The gauge field upon which to compute the plaquette
      @return double3 variable returning (plaquette, spatial plaquette,
      temporal plaquette) site averages normalized such that each
-     plaquette is in the range [0,1]
+     plaquette is in the range [0,1].  Host fields in QDP or MILC
+     order are extended internally when the lattice is partitioned.
    */
   double3 plaquette(const GaugeField &U);
 
+  /**
+     @brief Gauge observables measured in a single pass over the links
+  */
+  struct GaugeObservables {
+    double3 plaquette;     // (plaquette, spatial plaquette, temporal plaquette) as returned by plaquette()
+    double2 polyakov_loop; // average trace of the Polyakov loop, normalized to 1 for the unit field
+    double rectangle;      // average 1x2 rectangle, normalized to 1 for the unit field
+    double E;              // energy density from the clover
+    double Q;              // topological charge from the clover
+  };
+
+  /**
+     @brief Measure the plaquettes, the Polyakov loop, the rectangles,
+     the energy density and the topological charge of a host gauge
+     field in one pass: each thread walks the time line through a
+     spatial site, measuring the local observables at every site on
+     it while multiplying up the temporal links.  The sums are reduced
+     in a fixed order, so the results do not depend on the number of
+     threads.
+
+     @param[in] U Host gauge field in QDP or MILC order
+     @return The observables
+  */
+  GaugeObservables gaugeObservables(const GaugeField &U);
+
   /**
      @brief Generate Gaussian distributed su(N) or SU(N) fields.  If U
      is a momentum field, then we generate random Gaussian distributed
@@ -40,6 +67,12 @@ namespace quda
      distribution (sigma = 0 results in a free field, and sigma = 1 has
      maximum disorder).
 
+     This variant draws from counter-based Philox streams keyed on the
+     seed, the global site index and the direction, so it needs no
+     generator state and the field is independent of the process grid
+     and the thread count.  Host fields are supported in QDP or MILC
+     order without reconstruction, and are filled in place.
+
      @param[out] U The GaugeField
      @param[in] seed The seed used for the RNG
      @param[in] sigma Wdith of the Gaussian distribution
@@ -53,8 +86,10 @@ namespace quda
      @param[out] dataDs Output smeared field
      @param[in] dataOr Input gauge field
      @param[in] alpha smearing parameter
+     @param[in] halo Number of halo layers of the extended fields to
+     smear in addition to the interior (none if nullptr)
   */
-  void APEStep(GaugeField &dataDs, const GaugeField &dataOr, double alpha);
+  void APEStep(GaugeField &dataDs, const GaugeField &dataOr, double alpha, const int *halo = nullptr);
 
   /**
      @brief Apply STOUT smearing to the gauge field
@@ -62,8 +97,10 @@ namespace quda
      @param[out] dataDs Output smeared field
      @param[in] dataOr Input gauge field
      @param[in] rho smearing parameter
+     @param[in] halo Number of halo layers of the extended fields to
+     smear in addition to the interior (none if nullptr)
   */
-  void STOUTStep(GaugeField &dataDs, const GaugeField &dataOr, double rho);
+  void STOUTStep(GaugeField &dataDs, const GaugeField &dataOr, double rho, const int *halo = nullptr);
 
   /**
      @brief Apply Over Improved STOUT smearing to the gauge field
@@ -72,8 +109,101 @@ namespace quda
      @param[in] dataOr Input gauge field
      @param[in] rho smearing parameter
      @param[in] epsilon smearing parameter
+     @param[in] halo Number of halo layers of the extended fields to
+     smear in addition to the interior (none if nullptr)
   */
-  void OvrImpSTOUTStep(GaugeField &dataDs, const GaugeField &dataOr, double rho, double epsilon);
+  void OvrImpSTOUTStep(GaugeField &dataDs, const GaugeField &dataOr, double rho, double epsilon,
+                       const int *halo = nullptr);
+
+  /**
+     @brief Apply nSteps of APE smearing to the gauge field.  The
+     steps ping-pong between two extended fields whose halo is depth
+     sites deep in the partitioned dimensions.  Each step also smears
+     the part of the halo that is still valid, which shrinks by one
+     site per step, so the halo is only exchanged once every depth
+     steps.
+
+     @param[out] dataDs Output smeared field (may alias dataOr)
+     @param[in] dataOr Input gauge field
+     @param[in] nSteps Number of smearing steps
+     @param[in] alpha smearing parameter
+     @param[in] depth Halo depth, a multiple of two (zero selects the
+     default of two steps)
+  */
+  void APEnStep(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, double alpha, int depth = 0);
+
+  /**
+     @brief Apply nSteps of STOUT smearing to the gauge field,
+     exchanging the halo once every depth steps (see APEnStep)
+
+     @param[out] dataDs Output smeared field (may alias dataOr)
+     @param[in] dataOr Input gauge field
+     @param[in] nSteps Number of smearing steps
+     @param[in] rho smearing parameter
+     @param[in] depth Halo depth, a multiple of two (zero selects the
+     default of two steps)
+  */
+  void STOUTnStep(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, double rho, int depth = 0);
+
+  /**
+     @brief Apply nSteps of Over Improved STOUT smearing to the gauge
+     field.  The rectangles reach two sites, so the halo is exchanged
+     once every depth/2 steps (see APEnStep)
+
+     @param[out] dataDs Output smeared field (may alias dataOr)
+     @param[in] dataOr Input gauge field
+     @param[in] nSteps Number of smearing steps
+     @param[in] rho smearing parameter
+     @param[in] epsilon smearing parameter
+     @param[in] depth Halo depth, a multiple of two (zero selects the
+     default of two steps)
+  */
+  void OvrImpSTOUTnStep(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, double rho, double epsilon,
+                        int depth = 0);
+
+  /**
+     @brief Gauge observables measured along the gradient flow
+  */
+  struct WFlowObservables {
+    double t;         // flow time
+    double plaquette; // average plaquette, normalized to [0,1]
+    double E_plaq;    // energy density from the plaquette
+    double E_clover;  // energy density from the clover
+    double Q;         // topological charge from the clover
+  };
+
+  /**
+     @brief Measure the plaquette, the energy density and the
+     topological charge of the gauge field
+
+     @param[in] U Input gauge field
+     @return The observables at flow time zero
+  */
+  WFlowObservables WFlowMeasure(const GaugeField &U);
+
+  /**
+     @brief Integrate the gradient flow of the gauge field to flow time
+     t_max with the third-order Runge-Kutta scheme of Luscher
+     (arXiv:1006.4518).  With a nonzero tolerance the step size is
+     adapted after every step from the distance between the
+     third-order and an embedded second-order integrator (Fritzsch and
+     Ramos, arXiv:1301.4388), rejecting and repeating steps whose
+     distance exceeds the tolerance.  Measurements are made within the
+     first stage of a step, which reads the same links.
+
+     @param[out] out Gauge field at flow time t_max
+     @param[in] in Gauge field at flow time zero
+     @param[in] type Flow action
+     @param[in] t_max Final flow time
+     @param[in] epsilon Step size, or the initial step size if adaptive
+     @param[in] tolerance Maximum distance per step between the two
+     integrators (zero for a fixed step size)
+     @param[in] meas_interval Measure every meas_interval steps and at
+     t_max (zero for no measurements)
+     @return The measured observables
+  */
+  std::vector<WFlowObservables> WFlow(GaugeField &out, const GaugeField &in, QudaWFlowType type, double t_max,
+                                      double epsilon, double tolerance = 0.0, int meas_interval = 1);
 
   /**
    * @brief Gauge fixing with overrelaxation with support for single and multi GPU.
@@ -98,7 +228,32 @@ namespace quda
 		       const int stopWtheta);
 
   /**
-   * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
+     @brief Gauge fixing observables after a step of gauge fixing
+  */
+  struct GaugeFixObservables {
+    int step;      // steps done
+    double action; // gauge fixing functional
+    double theta;  // theta, the norm of the gauge condition
+    double delta;  // change of the functional in this step
+  };
+
+  /**
+     @brief Convergence history and timings of a gauge fixing run
+  */
+  struct GaugeFixHistory {
+    std::vector<GaugeFixObservables> steps;
+    double secs;             // total time
+    double fft_secs;         // time in FFTs (host fields only)
+    double gflops;           // Gflop/s over the run
+    const char *fft_backend; // name of the FFT backend used
+  };
+
+  /**
+   * @brief Gauge fixing with Steepest descent method with FFTs with
+   * support for a single GPU or a single host process.  Device fields
+   * are transformed with cuFFT.  Host fields must be in QDP or MILC
+   * order with no reconstruction, and are transformed with the
+   * backend given by hostFFTBackend (see fft_quda.h).
    * @param[in,out] data, quda gauge field
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
@@ -109,17 +264,22 @@ namespace quda
    * value is zero then the method stops when iteration reachs the
    * maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
+   * @param[out] history, if set, the observables after every step and the timings
    */
-  void gaugefixingFFT( cudaGaugeField& data, const int gauge_dir,
+  void gaugefixingFFT( GaugeField& data, const int gauge_dir,
 		       const int Nsteps,
 		       const int verbose_interval,
 		       const double alpha,
 		       const int autotune,
                        const double tolerance,
-		       const int stopWtheta);
+		       const int stopWtheta,
+		       GaugeFixHistory *history = nullptr);
 
   /**
-     @brief Compute the Fmunu tensor
+     @brief Compute the Fmunu tensor.  On the host the tensor must be
+     in MILC order and the gauge field in QDP or MILC order, and the
+     gauge field is extended internally when the lattice is
+     partitioned.
      @param[out] Fmunu The Fmunu tensor
      @param[in] gauge The gauge field upon which to compute the Fmnu tensor
    */
@@ -135,7 +295,8 @@ namespace quda
   /**
      @brief Compute the topological charge density per lattice site
      @param[in] Fmunu The Fmunu tensor, usually calculated from a smeared configuration
-     @param[out] qDensity The topological charge at each lattice site
+     @param[out] qDensity The topological charge at each lattice site,
+     in the same location as Fmunu
      @return double The total topological charge
   */
   double computeQChargeDensity(const GaugeField &Fmunu, void *result);
@@ -0,0 +1,189 @@
+#pragma once
+
+/**
+   @file host_parallel.h
+
+   @brief Host execution layer for CPU-location kernels.  Kernels are
+   written as a functor over (parity, x_cb) and launched with
+   parallel_for or parallel_reduce using the TuneParam returned by
+   tuneLaunch.  For host launches (Tunable::hostLaunch) the autotuner
+   selects the number of threads (block.x) and the schedule (grid.x
+   is the chunk size of a dynamic schedule, with zero denoting a
+   static partition), and these are stored in the tunecache alongside
+   the device launch parameters of other kernels.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <tune_quda.h>
+
+namespace quda {
+
+  /**
+     @brief Launch parameters for a host kernel that is not tuned:
+     all available threads with a static partition.
+     @return The default host launch parameters
+   */
+  inline TuneParam hostDefaultParam()
+  {
+    TuneParam tp;
+    tp.block = dim3(hostMaxThreads(), 1, 1);
+    tp.grid = dim3(0, 1, 1);
+    return tp;
+  }
+
+  /**
+     @brief Apply f(parity, x_cb) to every site of a checkerboarded
+     field, parallelized over the combined (parity, x_cb) index.
+     @param[in] tp Host launch parameters (thread count and schedule)
+     @param[in] nParity Number of parities to loop over
+     @param[in] volumeCB Checkerboarded volume
+     @param[in] f Functor taking (parity, x_cb)
+   */
+  template <typename F> void parallel_for(const TuneParam &tp, int nParity, int volumeCB, F &&f)
+  {
+    const int threads = tp.block.x;
+    const int chunk = tp.grid.x;
+    const int n = nParity * volumeCB;
+
+    if (chunk == 0) {
+#pragma omp parallel for num_threads(threads) schedule(static)
+      for (int i = 0; i < n; i++) f(i / volumeCB, i % volumeCB);
+    } else {
+#pragma omp parallel for num_threads(threads) schedule(dynamic, chunk)
+      for (int i = 0; i < n; i++) f(i / volumeCB, i % volumeCB);
+    }
+  }
+
+  /**
+     @brief Reduce f(parity, x_cb) over every site of a checkerboarded
+     field.  Each thread accumulates its own partial result which are
+     then combined with r, so r must be associative and commutative
+     (e.g., max or xor) for the result to be independent of the
+     launch parameters.
+     @param[in] tp Host launch parameters (thread count and schedule)
+     @param[in] nParity Number of parities to loop over
+     @param[in] volumeCB Checkerboarded volume
+     @param[in] init Identity element of the reduction
+     @param[in] f Functor taking (parity, x_cb) and returning T
+     @param[in] r Binary reduction operator
+     @return The reduced value
+   */
+  template <typename T, typename F, typename R>
+  T parallel_reduce(const TuneParam &tp, int nParity, int volumeCB, T init, F &&f, R &&r)
+  {
+    const int threads = tp.block.x;
+    const int chunk = tp.grid.x;
+    const int n = nParity * volumeCB;
+    T result = init;
+
+#pragma omp parallel num_threads(threads)
+    {
+      T partial = init;
+      if (chunk == 0) {
+#pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; i++) partial = r(partial, f(i / volumeCB, i % volumeCB));
+      } else {
+#pragma omp for schedule(dynamic, chunk) nowait
+        for (int i = 0; i < n; i++) partial = r(partial, f(i / volumeCB, i % volumeCB));
+      }
+#pragma omp critical
+      result = r(result, partial);
+    }
+
+    return result;
+  }
+
+  /**
+     @brief As parallel_reduce, with the master thread first running
+     g() before it joins the reduction, so that work done by g (e.g.,
+     a halo exchange, since the master is the thread that may call
+     the communications layer) overlaps with the other threads'
+     share of the sites.  With a static partition the master's share
+     of the sites still waits for g, so a dynamic schedule is usually
+     the better choice, which the autotuner will find.
+     @param[in] tp Host launch parameters (thread count and schedule)
+     @param[in] nParity Number of parities to loop over
+     @param[in] volumeCB Checkerboarded volume
+     @param[in] init Identity element of the reduction
+     @param[in] f Functor taking (parity, x_cb) and returning T
+     @param[in] r Binary reduction operator
+     @param[in] g Functor run by the master thread
+     @return The reduced value
+   */
+  template <typename T, typename F, typename R, typename G>
+  T parallel_reduce_overlap(const TuneParam &tp, int nParity, int volumeCB, T init, F &&f, R &&r, G &&g)
+  {
+    const int threads = tp.block.x;
+    const int chunk = tp.grid.x;
+    const int n = nParity * volumeCB;
+    T result = init;
+
+#pragma omp parallel num_threads(threads)
+    {
+#pragma omp master
+      g();
+      T partial = init;
+      if (chunk == 0) {
+#pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; i++) partial = r(partial, f(i / volumeCB, i % volumeCB));
+      } else {
+#pragma omp for schedule(dynamic, chunk) nowait
+        for (int i = 0; i < n; i++) partial = r(partial, f(i / volumeCB, i % volumeCB));
+      }
+#pragma omp critical
+      result = r(result, partial);
+    }
+
+    return result;
+  }
+
+  /**
+     @brief Reduce f(parity, x_cb) over every site of a checkerboarded
+     field in a fixed order, so that the result is reproducible for
+     reductions that are not associative, e.g., floating-point sums.
+     The combined (parity, x_cb) index is split into blocks of
+     reduce_block consecutive sites, each of which is reduced serially
+     in index order, and the partial results of the blocks are then
+     combined serially in block order.  The launch parameters only
+     decide which thread reduces which block, so the result is
+     independent of them.
+     @param[in] tp Host launch parameters (thread count and schedule)
+     @param[in] nParity Number of parities to loop over
+     @param[in] volumeCB Checkerboarded volume
+     @param[in] init Identity element of the reduction
+     @param[in] f Functor taking (parity, x_cb) and returning T
+     @param[in] r Binary reduction operator
+     @return The reduced value
+   */
+  template <typename T, typename F, typename R>
+  T parallel_reduce_ordered(const TuneParam &tp, int nParity, int volumeCB, T init, F &&f, R &&r)
+  {
+    constexpr int reduce_block = 1024;
+    const int threads = tp.block.x;
+    const int chunk = std::max(1, static_cast<int>(tp.grid.x) / reduce_block);
+    const int n = nParity * volumeCB;
+    const int nBlocks = (n + reduce_block - 1) / reduce_block;
+    std::vector<T> partial(nBlocks, init);
+
+    auto block = [&](int b) {
+      T sum = init;
+      const int end = std::min(n, (b + 1) * reduce_block);
+      for (int i = b * reduce_block; i < end; i++) sum = r(sum, f(i / volumeCB, i % volumeCB));
+      partial[b] = sum;
+    };
+
+    if (tp.grid.x == 0) {
+#pragma omp parallel for num_threads(threads) schedule(static)
+      for (int b = 0; b < nBlocks; b++) block(b);
+    } else {
+#pragma omp parallel for num_threads(threads) schedule(dynamic, chunk)
+      for (int b = 0; b < nBlocks; b++) block(b);
+    }
+
+    T result = init;
+    for (int b = 0; b < nBlocks; b++) result = r(result, partial[b]);
+    return result;
+  }
+
+} // namespace quda
@@ -6,6 +6,7 @@
 #include <color_spinor_field.h>
 #include <qio_field.h>
 #include <eigensolve_quda.h>
+#include <tiered_vector_store.h>
 #include <vector>
 #include <memory>
 
@@ -602,6 +603,54 @@ namespace quda {
     void blocksolve(ColorSpinorField& out, ColorSpinorField& in);
   };
 
+  /**
+     @brief Block conjugate-gradient solver (BCGrQ) for a set of
+     right-hand sides sharing one Krylov space.  The block residual is
+     kept orthonormal with a rank-revealing orthonormalization, so
+     linearly dependent directions and converged systems are deflated
+     from the block rather than causing a breakdown.
+   */
+  class BlockCG : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+    long long matvecs;
+
+  public:
+    BlockCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~BlockCG();
+
+    /**
+       @brief Solve a single system, for which this reduces to CG
+       @param out Solution vector
+       @param in Right-hand side
+    */
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    /**
+       @brief Solve for each component of a composite field
+       @param out Composite solution field
+       @param in Composite right-hand side field
+    */
+    void blocksolve(ColorSpinorField &out, ColorSpinorField &in);
+
+    /**
+       @brief Solve A x_i = b_i for all i together.  On return
+       param.true_res_offset[i] and param.iter_res_offset[i] hold the
+       relative residual of each system and param.iter the number of
+       block iterations.
+       @param x Solution vectors, used as the initial guess
+       @param b Right-hand sides
+    */
+    void solve(std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &b);
+
+    /**
+       @return The number of matrix-vector products of the last solve
+    */
+    long long MatVecs() const { return matvecs; }
+  };
+
 
 
   class CG3 : public Solver {
@@ -673,8 +722,8 @@ namespace quda {
   class MPCG : public Solver {
     private:
       const DiracMatrix &mat;
-      void computeMatrixPowers(cudaColorSpinorField out[], cudaColorSpinorField &in, int nvec);
-      void computeMatrixPowers(std::vector<cudaColorSpinorField>& out, std::vector<cudaColorSpinorField>& in, int nsteps);
+      void computeMatrixPowers(ColorSpinorField *out[], ColorSpinorField &in, int nvec);
+      void computeMatrixPowers(std::vector<ColorSpinorField*>& out, std::vector<ColorSpinorField*>& in, int nsteps);
 
 
     public:
@@ -743,7 +792,7 @@ namespace quda {
 
   private:
     DiracMatrix &mat;
-    void computeMatrixPowers(std::vector<cudaColorSpinorField>& pr, cudaColorSpinorField& p, cudaColorSpinorField& r, int nsteps);
+    void computeMatrixPowers(std::vector<ColorSpinorField*>& pr, ColorSpinorField& p, ColorSpinorField& r, int nsteps);
 
   public:
     MPBiCGstab(DiracMatrix &mat, SolverParam &param, TimeProfile &profile);
@@ -880,6 +929,60 @@ namespace quda {
     void operator()(ColorSpinorField &out, ColorSpinorField &in);
   };
 
+  /**
+     @brief Polynomial preconditioner: out = p(A) in, where 1 - z p(z)
+     is the GMRES (minimum-residual) polynomial of degree param.maxiter.  The
+     polynomial is constructed on first application from an Arnoldi
+     run on the right-hand side, after which it is applied with
+     matrix-vector products and local blas alone, in product form over
+     the harmonic Ritz values (Loe and Morgan).  Intended for use as
+     the preconditioner K of GCR or PCG, where it replaces the global
+     reductions of roughly param.maxiter outer iterations.
+   */
+  class PolynomialPreconditioner : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+    const bool hermitian;
+
+    std::vector<Complex> theta; //! Leja-ordered roots of the residual polynomial 1 - z p(z)
+    bool init;
+
+    ColorSpinorField *wp;       //! product of the factors (1 - A / theta_j) applied so far
+    ColorSpinorField *Awp;      //! mat * w
+    ColorSpinorField *tmpp;     //! temporary for mat-vec
+    ColorSpinorField *y_sloppy; //! sloppy accumulator when the precisions differ
+    ColorSpinorField *in_sloppy; //! sloppy copy of the input when the precisions differ
+
+    /**
+       @brief Construct the polynomial from an Arnoldi run
+       @param[in] v Starting vector
+    */
+    void construct(ColorSpinorField &v);
+
+  public:
+    /**
+       @param mat Outer operator, used for the true residual when the
+       polynomial is run as a standalone solver
+       @param matSloppy Operator the polynomial is built from and applied with
+       @param hermitian Whether the operator is Hermitian (e.g., as the
+       preconditioner of PCG), in which case the roots are constrained to be real
+    */
+    PolynomialPreconditioner(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile,
+                             bool hermitian = false);
+    virtual ~PolynomialPreconditioner();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    /**
+       @return The degree of the residual polynomial once constructed,
+       including any roots added for stability; each application costs
+       one less matrix-vector product
+    */
+    int Degree() const { return theta.size(); }
+  };
+
   /**
      @brief Communication-avoiding CG solver.  This solver does
      un-preconditioned CG, running in steps of nKrylov, build up a
@@ -1035,9 +1138,9 @@ public:
   class SD : public Solver {
     private:
       const DiracMatrix &mat;
-      cudaColorSpinorField *Ar;
-      cudaColorSpinorField *r;
-      cudaColorSpinorField *y;
+      ColorSpinorField *Ar;
+      ColorSpinorField *r;
+      ColorSpinorField *y;
       bool init;
 
     public:
@@ -1149,11 +1252,62 @@ public:
 
       (*this)(out, in, p, r2_old.get());
 
-      for (auto& pp : p) delete pp;   
+      for (auto& pp : p) delete pp;
     }
 
   };
 
+  /**
+     @brief Refinement of the shifted systems (A + shift_i) x_i = b
+     left under-converged by a multi-shift solve.  The systems are
+     solved by CG in lock-step: each iteration applies the operator to
+     every active search direction back to back, and the local inner
+     products of all the systems are summed over the nodes together,
+     so there are two global reductions per iteration whatever the
+     number of shifts.  Each system drops out once its true residual
+     has met its tolerance.
+  */
+  class MultiShiftRefineCG : public MultiShiftSolver {
+
+  protected:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+
+  public:
+    MultiShiftRefineCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~MultiShiftRefineCG();
+
+    /**
+       @brief Refine a subset of the shifted systems.  The true and
+       iterated residuals of system j are returned in
+       param.true_res_offset[idx[j]] etc.
+       @param x The solutions, which are used as the initial guesses
+       @param b The right-hand side
+       @param idx The index of each system in the multi-shift solve
+       @param shift The shift of each system relative to the operators
+       @param tol The L2 tolerance of each system
+    */
+    void operator()(std::vector<ColorSpinorField *> x, ColorSpinorField &b, const std::vector<int> &idx,
+                    const std::vector<double> &shift, const std::vector<double> &tol);
+
+    /**
+       @brief Refine every shifted system using param.offset and param.tol_offset
+       @param out The solutions, which are used as the initial guesses
+       @param in The right-hand side
+    */
+    void operator()(std::vector<ColorSpinorField *> out, ColorSpinorField &in)
+    {
+      std::vector<int> idx(out.size());
+      std::vector<double> shift(out.size()), tol(out.size());
+      for (unsigned int i = 0; i < out.size(); i++) {
+        idx[i] = i;
+        shift[i] = param.offset[i];
+        tol[i] = param.tol_offset[i];
+      }
+      (*this)(out, in, idx, shift, tol);
+    }
+  };
+
 
 
   /**
@@ -1215,6 +1369,18 @@ public:
     void operator()(ColorSpinorField &x, ColorSpinorField &b,
 		    std::vector<ColorSpinorField*> p,
 		    std::vector<ColorSpinorField*> q);
+
+    /**
+       @brief Variant for bases held in a TieredVectorStore.  The
+       basis is not orthogonalized, since that would require writing
+       back the spilled vectors, and the normal equations are instead
+       diagonally rescaled before the factorization.
+       @param x The optimum for the solution vector.
+       @param b The source vector in the equation to be solved. This is not preserved.
+       @param p The basis vectors in which we are building the guess
+       @param q The basis vectors multiplied by A
+    */
+    void operator()(ColorSpinorField &x, ColorSpinorField &b, TieredVectorStore &p, TieredVectorStore &q);
   };
 
   using ColorSpinorFieldSet = ColorSpinorField;
@@ -1322,5 +1488,109 @@ public:
 
   };
 
+  /**
+     @brief The subspace recycled by GCRO-DR: U and its image C = A U
+     under the operator, with C^dagger C = I.  This is held at the
+     storage precision between solves, so that it can be carried from
+     one call to invertQuda to the next.
+  */
+  struct RecycleSpace {
+    std::vector<ColorSpinorField *> U; //! the recycled subspace
+    std::vector<ColorSpinorField *> C; //! its image under the operator
+    QudaPrecision precision;           //! storage precision
+    std::vector<double> op_key;        //! identifies the operator C was computed with
+    bool stale;                        //! whether C must be recomputed for a new operator
+    int solves;                        //! number of solves that have updated the space
+    int first_iter;                    //! iterations of the first solve (no recycling)
+
+    RecycleSpace(QudaPrecision precision) : precision(precision), stale(false), solves(0), first_iter(0) {}
+    ~RecycleSpace() { clear(); }
+
+    int Dim() const { return U.size(); }
+
+    void clear()
+    {
+      for (auto v : U) delete v;
+      for (auto v : C) delete v;
+      U.clear();
+      C.clear();
+      stale = false;
+      solves = 0;
+      first_iter = 0;
+    }
+  };
+
+  /**
+     @brief GCRO-DR, GMRES with deflated restarting that recycles its
+     deflation space between solves.
+
+     M. L. Parks et al, "Recycling Krylov subspaces for sequences of
+     linear systems", SIAM J. Sci. Comput. 28 (2006) p. 1651-1674
+
+     The first nev harmonic Ritz vectors of each restart cycle form the
+     recycled subspace U, with C = A U, and the remaining max_search_dim
+     - nev Arnoldi vectors of each cycle are built orthogonal to C.  If
+     param.deflation_op points to a RecycleSpace the subspace is taken
+     from and returned to it, so that successive solves start from the
+     subspace of the previous one.  If the space is marked stale the
+     operator has changed, and C is recomputed from U before use.
+  */
+  class GCRODR : public Solver {
+
+  private:
+    DiracMatrix &mat;
+    DiracMatrix &matSloppy;
+
+    RecycleSpace *recycle; //! persistent recycled subspace (if any)
+
+    std::vector<ColorSpinorField *> V;    //! Arnoldi basis vectors, size max_search_dim + 1
+    std::vector<ColorSpinorField *> U;    //! recycled subspace at the sloppy precision
+    std::vector<ColorSpinorField *> C;    //! its image under the operator
+    std::vector<ColorSpinorField *> Unew; //! next recycled subspace
+    std::vector<ColorSpinorField *> Cnew; //! its image under the operator
+
+    ColorSpinorField *rp;       //! residual vector
+    ColorSpinorField *tmpp;     //! temporary for mat-vec
+    ColorSpinorField *r_sloppy; //! sloppy residual vector
+    ColorSpinorField *e_sloppy; //! sloppy solution accumulator
+    ColorSpinorField *tmp_sloppy; //! temporary for sloppy mat-vec
+
+    bool init;
+
+    /**
+       @brief Build the Arnoldi basis V[0..n] from V[0], keeping each
+       vector orthogonal to the first k vectors of C
+       @param[out] H The (n+1) x n Hessenberg matrix (column major)
+       @param[out] B The k x n projections of A V onto C (column major)
+       @param[in] n Number of Arnoldi steps
+       @param[in] k Number of vectors of C to project out
+       @return Number of steps taken, less than n if the Krylov space
+       became invariant (breakdown)
+    */
+    int arnoldi(Complex *H, Complex *B, int n, int k);
+
+    /**
+       @brief Orthonormalize C = A U, applying the same transformation
+       to U so that the relation is preserved
+       @param[in] k Dimension of the subspace
+    */
+    void orthonormalizeC(int k);
+
+    /**
+       @brief Load the recycled subspace, recomputing C if the operator has changed
+       @return The number of matrix-vector products spent
+    */
+    int load();
+
+    /** @brief Return the recycled subspace to the persistent space */
+    void store();
+
+  public:
+    GCRODR(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~GCRODR();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+  };
+
 } // namespace quda
 
@@ -1,6 +1,7 @@
 #include <cub_helper.cuh>
 #include <multigrid_helper.cuh>
 #include <fast_intdiv.h>
+#include <host_parallel.h>
 
 // this removes ghost accessor reducing the parameter space needed
 #define DISABLE_GHOST true // do not rename this (it is both a template parameter and a macro)
@@ -102,11 +103,10 @@ namespace quda {
 
 #ifndef __CUDACC_RTC___
   template <typename sumFloat, typename Float, int nSpin, int spinBlockSize, int nColor, int coarseSpin, int nVec, typename Arg>
-  void blockOrthoCPU(Arg &arg) {
+  void blockOrthoCPU(Arg &arg, const TuneParam &tp) {
 
     // loop over geometric blocks
-#pragma omp parallel for
-    for (int x_coarse=0; x_coarse<arg.coarseVolume; x_coarse++) {
+    parallel_for(tp, 1, arg.coarseVolume, [&](int, int x_coarse) {
 
       // loop over number of block orthos
       for (int n = 0; n < arg.nBlockOrtho; n++) {
@@ -224,7 +224,7 @@ namespace quda {
 
       } // n
 
-    } // x_coarse
+    }); // x_coarse
   }
 #endif
 
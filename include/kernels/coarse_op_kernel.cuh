@@ -5,6 +5,7 @@
 #include <index_helper.cuh>
 #include <gamma.cuh>
 #include <linalg.cuh>
+#include <host_parallel.h>
 
 #define max_color_per_block 8
 
@@ -194,18 +195,15 @@ namespace quda {
   } // computeUV
 
   template<bool from_coarse, typename Float, int dim, QudaDirection dir, int fineSpin, int fineColor, int coarseSpin, int coarseColor, typename Arg>
-  void ComputeUVCPU(Arg &arg) {
+  void ComputeUVCPU(Arg &arg, const TuneParam &tp) {
 
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
+    parallel_for(tp, 2, arg.fineVolumeCB, [&](int parity, int x_cb) {
 	for (int ic_c=0; ic_c < coarseColor; ic_c++) // coarse color
 	  if (dir == QUDA_FORWARDS) // only for preconditioned clover is V != AV
 	    computeUV<from_coarse,Float,dim,dir,fineSpin,fineColor,coarseSpin,coarseColor>(arg, arg.V, parity, x_cb, ic_c);
 	  else
 	    computeUV<from_coarse,Float,dim,dir,fineSpin,fineColor,coarseSpin,coarseColor>(arg, arg.AV, parity, x_cb, ic_c);
-      } // c/b volume
-    }   // parity
+      }); // parity and c/b volume
   }
 
   template<bool from_coarse, typename Float, int dim, QudaDirection dir, int fineSpin, int fineColor, int coarseSpin, int coarseColor, typename Arg>
@@ -269,19 +267,17 @@ namespace quda {
 
   } // computeAV
 
-  template <typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg> void ComputeAVCPU(Arg &arg)
+  template <typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
+  void ComputeAVCPU(Arg &arg, const TuneParam &tp)
   {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
-        for (int ch = 0; ch < 2; ch++) { // Loop over chiral blocks
+    parallel_for(tp, 2, arg.fineVolumeCB, [&](int parity, int x_cb) {
+      for (int ch = 0; ch < 2; ch++) { // Loop over chiral blocks
 
-          for (int ic_c = 0; ic_c < coarseColor; ic_c++) { // coarse color
-            computeAV<Float, fineSpin, fineColor, coarseColor>(arg, parity, x_cb, ch, ic_c);
-          }
+        for (int ic_c = 0; ic_c < coarseColor; ic_c++) { // coarse color
+          computeAV<Float, fineSpin, fineColor, coarseColor>(arg, parity, x_cb, ch, ic_c);
         }
-      } // c/b volume
-    }   // parity
+      }
+    }); // parity and c/b volume
   }
 
   template <typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
@@ -329,14 +325,11 @@ namespace quda {
   } // computeTMAV
 
   template<typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
-  void ComputeTMAVCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
+  void ComputeTMAVCPU(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.fineVolumeCB, [&](int parity, int x_cb) {
 	for (int v=0; v<coarseColor; v++) // coarse color
 	  computeTMAV<Float,fineSpin,fineColor,coarseColor,Arg>(arg, parity, x_cb, v);
-      } // c/b volume
-    }   // parity
+      }); // parity and c/b volume
   }
 
   template<typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
@@ -398,17 +391,12 @@ namespace quda {
     return max;
   }
 
-  template <typename Float, bool twist, typename Arg> void ComputeCloverInvMaxCPU(Arg &arg)
+  template <typename Float, bool twist, typename Arg> void ComputeCloverInvMaxCPU(Arg &arg, const TuneParam &tp)
   {
-    Float max = 0.0;
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for reduction(max:max)
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
-        Float max_x = computeCloverInvMax<Float, twist, Arg>(arg, parity, x_cb);
-        max = max > max_x ? max : max_x;
-      } // c/b volume
-    }   // parity
-    arg.max_h = max;
+    arg.max_h = parallel_reduce(
+      tp, 2, arg.fineVolumeCB, static_cast<Float>(0.0),
+      [&](int parity, int x_cb) { return computeCloverInvMax<Float, twist, Arg>(arg, parity, x_cb); },
+      [](Float a, Float b) { return a > b ? a : b; });
   }
 
   template <typename Float, bool twist, typename Arg> __global__ void ComputeCloverInvMaxGPU(Arg arg)
@@ -488,18 +476,16 @@ namespace quda {
       for (int c = 0; c < fineColor; c++) arg.AV(parity, x_cb, 2 * ch + s, c, ic_c) = AV(s, c);
   } // computeTMCAV
 
-  template <typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg> void ComputeTMCAVCPU(Arg &arg)
+  template <typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
+  void ComputeTMCAVCPU(Arg &arg, const TuneParam &tp)
   {
-    for (int parity = 0; parity < 2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
-        for (int ch = 0; ch < 2; ch++) {
-          for (int ic_c = 0; ic_c < coarseColor; ic_c++) { // coarse color
-            computeTMCAV<Float, fineSpin, fineColor, coarseColor, Arg>(arg, parity, x_cb, ch, ic_c);
-          }
+    parallel_for(tp, 2, arg.fineVolumeCB, [&](int parity, int x_cb) {
+      for (int ch = 0; ch < 2; ch++) {
+        for (int ic_c = 0; ic_c < coarseColor; ic_c++) { // coarse color
+          computeTMCAV<Float, fineSpin, fineColor, coarseColor, Arg>(arg, parity, x_cb, ch, ic_c);
         }
-      } // c/b volume
-    }   // parity
+      }
+    }); // parity and c/b volume
   }
 
   template <typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
@@ -776,20 +762,17 @@ namespace quda {
   }
 
   template<bool from_coarse, typename Float, int dim, QudaDirection dir, int fineSpin, int fineColor, int coarseSpin, int coarseColor, typename Arg>
-  void ComputeVUVCPU(Arg arg) {
+  void ComputeVUVCPU(Arg arg, const TuneParam &tp) {
 
     Gamma<Float, QUDA_DEGRAND_ROSSI_GAMMA_BASIS, dim> gamma;
     constexpr bool shared_atomic = false; // not supported on CPU
     constexpr bool parity_flip = true;
 
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) { // Loop over fine volume
+    parallel_for(tp, 2, arg.fineVolumeCB, [&](int parity, int x_cb) { // Loop over fine volume
 	for (int c_row=0; c_row<coarseColor; c_row++)
 	  for (int c_col=0; c_col<coarseColor; c_col++)
 	    computeVUV<shared_atomic,parity_flip,from_coarse,Float,dim,dir,fineSpin,fineColor,coarseSpin,coarseColor>(arg, gamma, parity, x_cb, c_row, c_col, 0, 0);
-      } // c/b volume
-    } // parity
+      }); // parity and c/b volume
   }
 
   // compute indices for shared-atomic kernel
@@ -895,17 +878,14 @@ namespace quda {
   }
 
   template<typename Float, int nSpin, int nColor, typename Arg>
-  void ComputeYReverseCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
+  void ComputeYReverseCPU(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.coarseVolumeCB, [&](int parity, int x_cb) {
 	for (int ic_c = 0; ic_c < nColor; ic_c++) { //Color row
 	  for (int jc_c = 0; jc_c < nColor; jc_c++) { //Color col
 	    computeYreverse<Float,nSpin,nColor,Arg>(arg, parity, x_cb, ic_c, jc_c);
 	  }
 	}
-      } // c/b volume
-    } // parity
+      }); // parity and c/b volume
   }
 
   template<typename Float, int nSpin, int nColor, typename Arg>
@@ -985,17 +965,14 @@ namespace quda {
   }
 
   template <bool from_coarse, typename Float, int fineSpin, int coarseSpin, int fineColor, int coarseColor, typename Arg>
-  void ComputeCoarseCloverCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
+  void ComputeCoarseCloverCPU(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.fineVolumeCB, [&](int parity, int x_cb) {
         for (int jc_c=0; jc_c<coarseColor; jc_c++) {
           for (int ic_c=0; ic_c<coarseColor; ic_c++) {
             computeCoarseClover<from_coarse,Float,fineSpin,coarseSpin,fineColor,coarseColor>(arg, parity, x_cb, ic_c, jc_c);
           }
         }
-      } // c/b volume
-    } // parity
+      }); // parity and c/b volume
   }
 
   template <bool from_coarse, typename Float, int fineSpin, int coarseSpin, int fineColor, int coarseColor, typename Arg>
@@ -1017,17 +994,14 @@ namespace quda {
 
   //Adds the identity matrix to the coarse local term.
   template<typename Float, int nSpin, int nColor, typename Arg>
-  void AddCoarseDiagonalCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
+  void AddCoarseDiagonalCPU(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.coarseVolumeCB, [&](int parity, int x_cb) {
         for(int s = 0; s < nSpin; s++) { //Spin
          for(int c = 0; c < nColor; c++) { //Color
 	   arg.X_atomic(0,parity,x_cb,s,s,c,c) += complex<Float>(1.0,0.0);
          } //Color
         } //Spin
-      } // x_cb
-    } //parity
+      }); // parity and x_cb
    }
 
 
@@ -1047,13 +1021,11 @@ namespace quda {
 
   //Adds the twisted-mass term to the coarse local term.
   template<typename Float, int nSpin, int nColor, typename Arg>
-  void AddCoarseTmDiagonalCPU(Arg &arg) {
+  void AddCoarseTmDiagonalCPU(Arg &arg, const TuneParam &tp) {
 
     const complex<Float> mu(0., arg.mu*arg.mu_factor);
 
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
+    parallel_for(tp, 2, arg.coarseVolumeCB, [&](int parity, int x_cb) {
 	for(int s = 0; s < nSpin/2; s++) { //Spin
           for(int c = 0; c < nColor; c++) { //Color
             arg.X_atomic(0,parity,x_cb,s,s,c,c) += mu;
@@ -1064,8 +1036,7 @@ namespace quda {
             arg.X_atomic(0,parity,x_cb,s,s,c,c) -= mu;
           } //Color
 	} //Spin
-      } // x_cb
-    } //parity
+      }); // parity and x_cb
   }
 
   //Adds the twisted-mass term to the coarse local term.
@@ -1130,17 +1101,14 @@ namespace quda {
   }
 
   template<typename Float, int nSpin, int nColor, typename Arg>
-  void ConvertCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
+  void ConvertCPU(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.coarseVolumeCB, [&](int parity, int x_cb) {
 	for(int c_row = 0; c_row < nColor; c_row++) { //Color row
 	  for(int c_col = 0; c_col < nColor; c_col++) { //Color column
 	    convert<Float,nSpin,nColor,Arg>(arg, parity, x_cb, c_row, c_col);
 	  }
 	}
-      } // c/b volume
-    } // parity
+      }); // parity and c/b volume
   }
 
   template<typename Float, int nSpin, int nColor, typename Arg>
@@ -1178,17 +1146,14 @@ namespace quda {
   }
 
   template<typename Float, int nSpin, int nColor, typename Arg>
-  void RescaleYCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-      for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
+  void RescaleYCPU(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.coarseVolumeCB, [&](int parity, int x_cb) {
 	for(int c_row = 0; c_row < nColor; c_row++) { //Color row
 	  for(int c_col = 0; c_col < nColor; c_col++) { //Color column
 	    rescaleY<Float,nSpin,nColor,Arg>(arg, parity, x_cb, c_row, c_col);
 	  }
 	}
-      } // c/b volume
-    } // parity
+      }); // parity and c/b volume
   }
 
   template<typename Float, int nSpin, int nColor, typename Arg>
@@ -1,5 +1,6 @@
 #include <gauge_field_order.h>
 #include <index_helper.cuh>
+#include <host_parallel.h>
 
 namespace quda {
 
@@ -97,21 +98,23 @@ namespace quda {
     return yHatMax;
   }
 
-  template <typename Float, int n, bool compute_max_only, typename Arg> void CalculateYhatCPU(Arg &arg)
+  template <typename Float, int n, bool compute_max_only, typename Arg>
+  void CalculateYhatCPU(Arg &arg, const TuneParam &tp)
   {
-    Float max = 0.0;
-    for (int d=0; d<4; d++) {
-      for (int parity=0; parity<2; parity++) {
-#pragma omp parallel for
-        for (int x_cb = 0; x_cb < arg.Y.VolumeCB(); x_cb++) {
+    Float max = parallel_reduce(
+      tp, 2, arg.Y.VolumeCB(), static_cast<Float>(0.0),
+      [&](int parity, int x_cb) {
+        Float max = 0.0;
+        for (int d = 0; d < 4; d++) {
           for (int i = 0; i < n; i++)
             for (int j = 0; j < n; j++) {
               Float max_x = computeYhat<Float, n, compute_max_only>(arg, d, x_cb, parity, i, j);
               if (compute_max_only) max = max > max_x ? max : max_x;
             }
-        }
-      } //parity
-    } // dimension
+        } // dimension
+        return max;
+      },
+      [](Float a, Float b) { return a > b ? a : b; });
     if (compute_max_only) *arg.max_h = max;
   }
 
@@ -2,6 +2,7 @@
 #include <color_spinor_field_order.h>
 #include <index_helper.cuh>
 #include <cub_helper.cuh> // for vector_type
+#include <host_parallel.h>
 #if (__COMPUTE_CAPABILITY__ >= 300 || __CUDA_ARCH__ >= 300)
 #include <generics/shfl.h>
 #endif
@@ -349,7 +350,7 @@ namespace quda {
 
   // CPU kernel for applying the coarse Dslash to a vector
   template <typename Float, int nDim, int Ns, int Nc, int Mc, bool dslash, bool clover, bool dagger, DslashType type, typename Arg>
-  void coarseDslash(Arg arg)
+  void coarseDslash(Arg &arg, const TuneParam &tp)
   {
     // the fine-grain parameters mean nothing for CPU variant
     const int color_stride = 1;
@@ -358,21 +359,18 @@ namespace quda {
     const int dir = 0;
     const int dim = 0;
 
-    for (int parity= 0; parity < arg.nParity; parity++) {
-      // for full fields then set parity from loop else use arg setting
-      parity = (arg.nParity == 2) ? parity : arg.parity;
+    parallel_for(tp, arg.nParity, arg.volumeCB, [&](int parity, int x_cb) { // 4-d volume
+	// for full fields then set parity from loop else use arg setting
+	parity = (arg.nParity == 2) ? parity : arg.parity;
 
-      for (int src_idx = 0; src_idx < arg.dim[4]; src_idx++) {
-	//#pragma omp parallel for
-	for(int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
+	for (int src_idx = 0; src_idx < arg.dim[4]; src_idx++) {
 	  for (int s=0; s<2; s++) {
 	    for (int color_block=0; color_block<Nc; color_block+=Mc) { // Mc=Nc means all colors in a thread
 	      coarseDslash<Float,nDim,Ns,Nc,Mc,color_stride,dim_thread_split,dslash,clover,dagger,type,dir,dim>(arg, x_cb, src_idx, parity, s, color_block, color_offset);
 	    }
 	  }
-	} // 4-d volumeCB
-      } // src index
-    } // parity
+	} // src index
+      }); // parity and 4-d volumeCB
 
   }
 
@@ -25,19 +25,23 @@ namespace quda
   };
 
   template <int mu, int nu, typename Float, typename Arg>
-  __device__ __forceinline__ void computeFmunuCore(Arg &arg, int idx, int parity)
+  __device__ __host__ __forceinline__ void computeFmunuCore(Arg &arg, int idx, int parity_)
   {
 
     typedef Matrix<complex<Float>, 3> Link;
 
+    // the extended dimensions are formed in a local copy so that arg
+    // stays intact when it is shared by several sites, as on the host
     int x[4];
-    auto &X = arg.X;
+    int X[4];
+    for (int dir = 0; dir < 4; ++dir) X[dir] = arg.X[dir];
 
-    getCoords(x, idx, X, parity);
+    getCoords(x, idx, X, parity_);
     for (int dir = 0; dir < 4; ++dir) {
       x[dir] += arg.border[dir];
       X[dir] += 2 * arg.border[dir];
     }
+    const int parity = (parity_ + arg.border[0] + arg.border[1] + arg.border[2] + arg.border[3]) & 1;
 
     Link F;
     { // U(x,mu) U(x+mu,nu) U[dagger](x+nu,mu) U[dagger](x,nu)
@@ -161,17 +165,12 @@ namespace quda
     }
 
     constexpr int munu_idx = (mu * (mu - 1)) / 2 + nu; // lower-triangular indexing
-    arg.f(munu_idx, idx, parity) = F;
+    arg.f(munu_idx, idx, parity_) = F;
   }
 
-  template <typename Float, typename Arg> __global__ void computeFmunuKernel(Arg arg)
+  template <typename Float, typename Arg>
+  __device__ __host__ __forceinline__ void computeFmunuSite(Arg &arg, int x_cb, int parity, int mu_nu)
   {
-    int x_cb = threadIdx.x + blockIdx.x * blockDim.x;
-    int parity = threadIdx.y + blockIdx.y * blockDim.y;
-    int mu_nu = threadIdx.z + blockIdx.z * blockDim.z;
-    if (x_cb >= arg.threads) return;
-    if (mu_nu >= 6) return;
-
     switch (mu_nu) { // F[1,0], F[2,0], F[2,1], F[3,0], F[3,1], F[3,2]
     case 0: computeFmunuCore<1, 0, Float>(arg, x_cb, parity); break;
     case 1: computeFmunuCore<2, 0, Float>(arg, x_cb, parity); break;
@@ -182,25 +181,15 @@ namespace quda
     }
   }
 
-  template <typename Float, typename Arg> void computeFmunuCPU(Arg &arg)
+  template <typename Float, typename Arg> __global__ void computeFmunuKernel(Arg arg)
   {
-    for (int parity = 0; parity < 2; parity++) {
-      for (int x_cb = 0; x_cb < arg.threads; x_cb++) {
-        for (int mu = 0; mu < 4; mu++) {
-          for (int nu = 0; nu < mu; nu++) {
-            int mu_nu = (mu * (mu - 1)) / 2 + nu;
-            switch (mu_nu) { // F[1,0], F[2,0], F[2,1], F[3,0], F[3,1], F[3,2]
-            case 0: computeFmunuCore<1, 0, Float>(arg, x_cb, parity); break;
-            case 1: computeFmunuCore<2, 0, Float>(arg, x_cb, parity); break;
-            case 2: computeFmunuCore<2, 1, Float>(arg, x_cb, parity); break;
-            case 3: computeFmunuCore<3, 0, Float>(arg, x_cb, parity); break;
-            case 4: computeFmunuCore<3, 1, Float>(arg, x_cb, parity); break;
-            case 5: computeFmunuCore<3, 2, Float>(arg, x_cb, parity); break;
-            }
-          }
-        }
-      }
-    }
+    int x_cb = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y + blockIdx.y * blockDim.y;
+    int mu_nu = threadIdx.z + blockIdx.z * blockDim.z;
+    if (x_cb >= arg.threads) return;
+    if (mu_nu >= 6) return;
+
+    computeFmunuSite<Float>(arg, x_cb, parity, mu_nu);
   }
 
 } // namespace quda
@@ -16,7 +16,12 @@ namespace quda
 
     GaugeDs dest;
 
-    GaugeAPEArg(GaugeOr &origin, GaugeDs &dest, const GaugeField &data, const Float alpha, const Float tolerance) :
+    /**
+       @param[in] halo Number of halo layers of the extended field to
+       smear in addition to the interior (none if nullptr)
+    */
+    GaugeAPEArg(GaugeOr &origin, GaugeDs &dest, const GaugeField &data, const Float alpha, const Float tolerance,
+                const int *halo = nullptr) :
       threads(1),
       origin(origin),
       dest(dest),
@@ -24,7 +29,7 @@ namespace quda
       tolerance(tolerance)
     {
       for (int dir = 0; dir < 4; ++dir) {
-        border[dir] = data.R()[dir];
+        border[dir] = data.R()[dir] - (halo ? halo[dir] : 0);
         X[dir] = data.X()[dir] - border[dir] * 2;
         threads *= X[dir];
       }
@@ -33,20 +38,9 @@ namespace quda
   };
 
   template <typename Float, typename Arg, typename Link>
-  __host__ __device__ void computeStaple(Arg &arg, int idx, int parity, int dir, Link &staple)
+  __host__ __device__ void computeStaple(Arg &arg, const int *x, const int *X, int parity, int dir, Link &staple)
   {
 
-    // compute spacetime dimensions and parity
-    int X[4];
-    for (int dr = 0; dr < 4; ++dr) X[dr] = arg.X[dr];
-
-    int x[4];
-    getCoords(x, idx, X, parity);
-    for (int dr = 0; dr < 4; ++dr) {
-      x[dr] += arg.border[dr];
-      X[dr] += 2 * arg.border[dr];
-    }
-
     setZero(&staple);
 
     // I believe most users won't want to include time staples in smearing
@@ -93,15 +87,13 @@ namespace quda
     }
   }
 
-  template <typename Float, typename Arg> __global__ void computeAPEStep(Arg arg)
+  /**
+     @brief APE smearing of the link U_dir(x), where (idx, parity)
+     index the sites of the region being smeared.  This is the body of
+     both the device kernel and the host loop.
+  */
+  template <typename Float, typename Arg> __host__ __device__ inline void apeSite(Arg &arg, int idx, int parity, int dir)
   {
-
-    int idx = threadIdx.x + blockIdx.x * blockDim.x;
-    int parity = threadIdx.y + blockIdx.y * blockDim.y;
-    int dir = threadIdx.z + blockIdx.z * blockDim.z;
-    if (idx >= arg.threads) return;
-    if (dir >= 3) return;
-    typedef complex<Float> Complex;
     typedef Matrix<complex<Float>, 3> Link;
 
     int X[4];
@@ -113,13 +105,16 @@ namespace quda
       x[dr] += arg.border[dr];
       X[dr] += 2 * arg.border[dr];
     }
+    // parity in the extended field, which differs from that within the
+    // region when the border has odd depth
+    parity = (parity + arg.border[0] + arg.border[1] + arg.border[2] + arg.border[3]) & 1;
 
     int dx[4] = {0, 0, 0, 0};
     // Only spatial dimensions are smeared
     {
       Link U, S, TestU, I;
       // This function gets stap = S_{mu,nu} i.e., the staple of length 3,
-      computeStaple<Float>(arg, idx, parity, dir, S);
+      computeStaple<Float>(arg, x, X, parity, dir, S);
       //
       // |- > -|                /- > -/                /- > -
       // ^     v               ^     v                ^
@@ -142,4 +137,14 @@ namespace quda
     }
   }
 
+  template <typename Float, typename Arg> __global__ void computeAPEStep(Arg arg)
+  {
+    int idx = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y + blockIdx.y * blockDim.y;
+    int dir = threadIdx.z + blockIdx.z * blockDim.z;
+    if (idx >= arg.threads) return;
+    if (dir >= 3) return;
+    apeSite<Float>(arg, idx, parity, dir);
+  }
+
 } // namespace quda
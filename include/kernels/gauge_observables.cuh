@@ -0,0 +1,122 @@
+#include <gauge_field_order.h>
+#include <index_helper.cuh>
+#include <quda_matrix.h>
+#include <kernels/gauge_wilson_flow.cuh>
+
+namespace quda
+{
+
+  /**
+     Sums reduced by the observables pass: the spatial and temporal
+     plaquettes, the rectangles, the clover energy density and the
+     topological charge.
+  */
+  typedef vector_type<double, 5> GaugeObsReduceType;
+
+  template <typename Float, typename Gauge> struct GaugeObservablesArg {
+    int threads; // number of spatial sites
+    int X[4];    // interior dimensions
+    int E[4];    // extended dimensions
+    int border[4];
+    Gauge origin;
+    complex<double> *polyakov; // Polyakov line through the local time extent at each spatial site
+    GaugeObsReduceType result;
+
+    GaugeObservablesArg(const Gauge &origin, const GaugeField &u, complex<double> *polyakov) :
+      origin(origin),
+      polyakov(polyakov)
+    {
+      for (int dir = 0; dir < 4; ++dir) {
+        border[dir] = u.R()[dir];
+        E[dir] = u.X()[dir];
+        X[dir] = u.X()[dir] - border[dir] * 2;
+      }
+      threads = X[0] * X[1] * X[2];
+    }
+  };
+
+  /**
+     @brief Sum of the traces of the two rectangles in the (mu, nu)
+     plane that start at x, of extent two along mu and along nu
+  */
+  template <typename Float, typename Arg>
+  __host__ __device__ inline double rectangles(Arg &arg, const int *x, const int *X, int parity, int mu, int nu)
+  {
+    typedef Matrix<complex<Float>, 3> Link;
+    int dx[4] = {0, 0, 0, 0};
+
+    Link Umu = arg.origin(mu, linkIndexShift(x, dx, X), parity);
+    Link Unu = arg.origin(nu, linkIndexShift(x, dx, X), parity);
+    dx[mu]++;
+    Link Umu_pmu = arg.origin(mu, linkIndexShift(x, dx, X), 1 - parity);
+    Link Unu_pmu = arg.origin(nu, linkIndexShift(x, dx, X), 1 - parity);
+    dx[mu]++;
+    Link Unu_p2mu = arg.origin(nu, linkIndexShift(x, dx, X), parity);
+    dx[mu]--;
+    dx[nu]++;
+    Link Umu_pmu_pnu = arg.origin(mu, linkIndexShift(x, dx, X), parity);
+    Link Unu_pmu_pnu = arg.origin(nu, linkIndexShift(x, dx, X), parity);
+    dx[mu]--;
+    Link Umu_pnu = arg.origin(mu, linkIndexShift(x, dx, X), 1 - parity);
+    Link Unu_pnu = arg.origin(nu, linkIndexShift(x, dx, X), 1 - parity);
+    dx[nu]++;
+    Link Umu_p2nu = arg.origin(mu, linkIndexShift(x, dx, X), parity);
+
+    double r = getTrace(Umu * Umu_pmu * Unu_p2mu * conj(Umu_pmu_pnu) * conj(Umu_pnu) * conj(Unu)).real();
+    r += getTrace(Umu * Unu_pmu * Unu_pmu_pnu * conj(Umu_p2nu) * conj(Unu_pnu) * conj(Unu)).real();
+    return r;
+  }
+
+  /**
+     @brief Measure the local observables at every site of the time
+     line through the spatial site s, and form the product of the
+     temporal links along it.  The plaquettes are taken from the
+     clover leaves, each of which is the plaquette of one of the four
+     sites it touches, so that their sum over the lattice is that of
+     the plaquettes.
+  */
+  template <typename Float, typename Arg> __host__ __device__ inline GaugeObsReduceType gaugeObservablesSite(Arg &arg, int s)
+  {
+    typedef Matrix<complex<Float>, 3> Link;
+    typedef Matrix<complex<double>, 3> Line;
+
+    GaugeObsReduceType value;
+    Line P;
+    setIdentity(&P);
+
+    int x[4];
+    x[0] = s % arg.X[0] + arg.border[0];
+    x[1] = (s / arg.X[0]) % arg.X[1] + arg.border[1];
+    x[2] = s / (arg.X[0] * arg.X[1]) + arg.border[2];
+    int dx[4] = {0, 0, 0, 0};
+
+    for (int t = 0; t < arg.X[3]; t++) {
+      x[3] = t + arg.border[3];
+      const int parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+
+      Link F[6]; // F[1,0], F[2,0], F[2,1], F[3,0], F[3,1], F[3,2]
+      for (int mu = 1; mu < 4; mu++) {
+        for (int nu = 0; nu < mu; nu++) {
+          Link C = cloverLeaves<Float>(arg, x, arg.E, parity, mu, nu);
+          value[mu == 3 ? 1 : 0] += 0.25 * getTrace(C).real();
+          value[2] += rectangles<Float>(arg, x, arg.E, parity, mu, nu);
+          makeAntiHerm(C);
+          Link &Fmunu = F[(mu * (mu - 1)) / 2 + nu];
+          Fmunu = static_cast<Float>(0.25) * C;
+          value[3] -= getTrace(Fmunu * Fmunu).real();
+        }
+      }
+      double Q = getTrace(F[0] * F[5]).real() + getTrace(F[3] * F[2]).real() - getTrace(F[1] * F[4]).real();
+      value[4] += Q / (Pi2 * Pi2);
+
+      Link U = arg.origin(3, linkIndexShift(x, dx, arg.E), parity);
+      Line Ud;
+      for (int i = 0; i < 9; i++) Ud.data[i] = complex<double>(U.data[i].real(), U.data[i].imag());
+      P = P * Ud;
+    }
+
+    for (int i = 0; i < 9; i++) arg.polyakov[9 * s + i] = P.data[i];
+    return value;
+  }
+
+} // namespace quda
@@ -24,6 +24,28 @@ namespace quda
     }
   };
 
+  /**
+     @brief Topological charge density of the site (x_cb, parity),
+     which is also written out when the density is requested
+  */
+  template <typename Float, typename Arg> __device__ __host__ inline double qChargeSite(Arg &arg, int x_cb, int parity)
+  {
+    // Load the field-strength tensor from global memory
+    Matrix<complex<Float>, 3> F[] = {arg.data(0, x_cb, parity), arg.data(1, x_cb, parity), arg.data(2, x_cb, parity),
+                                     arg.data(3, x_cb, parity), arg.data(4, x_cb, parity), arg.data(5, x_cb, parity)};
+
+    double Q1 = getTrace(F[0] * F[5]).real();
+    double Q2 = getTrace(F[1] * F[4]).real();
+    double Q3 = getTrace(F[3] * F[2]).real();
+    double Q_idx = (Q1 + Q3 - Q2) / (Pi2 * Pi2);
+
+    if (Arg::density) {
+      int idx = x_cb + parity * arg.threads;
+      arg.qDensity[idx] = Q_idx;
+    }
+    return Q_idx;
+  }
+
   // Core routine for computing the topological charge from the field strength
   template <int blockSize, typename Float, typename Arg> __global__ void qChargeComputeKernel(Arg arg)
   {
@@ -33,23 +55,9 @@ namespace quda
     double Q = 0.0;
 
     while (x_cb < arg.threads) {
-      // Load the field-strength tensor from global memory
-      Matrix<complex<Float>, 3> F[] = {arg.data(0, x_cb, parity), arg.data(1, x_cb, parity), arg.data(2, x_cb, parity),
-                                       arg.data(3, x_cb, parity), arg.data(4, x_cb, parity), arg.data(5, x_cb, parity)};
-
-      double Q1 = getTrace(F[0] * F[5]).real();
-      double Q2 = getTrace(F[1] * F[4]).real();
-      double Q3 = getTrace(F[3] * F[2]).real();
-      double Q_idx = (Q1 + Q3 - Q2);
-      Q += Q_idx;
-
-      if (Arg::density) {
-        int idx = x_cb + parity * arg.threads;
-        arg.qDensity[idx] = Q_idx / (Pi2 * Pi2);
-      }
+      Q += qChargeSite<Float>(arg, x_cb, parity);
       x_cb += blockDim.x * gridDim.x;
     }
-    Q /= (Pi2 * Pi2);
 
     reduce2d<blockSize, 2>(arg, Q);
   }
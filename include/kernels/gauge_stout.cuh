@@ -16,7 +16,12 @@ namespace quda
 
     GaugeDs dest;
 
-    GaugeSTOUTArg(GaugeOr &origin, GaugeDs &dest, const GaugeField &data, const Float rho, const Float tolerance) :
+    /**
+       @param[in] halo Number of halo layers of the extended field to
+       smear in addition to the interior (none if nullptr)
+    */
+    GaugeSTOUTArg(GaugeOr &origin, GaugeDs &dest, const GaugeField &data, const Float rho, const Float tolerance,
+                  const int *halo = nullptr) :
         threads(1),
         origin(origin),
         dest(dest),
@@ -24,7 +29,7 @@ namespace quda
         tolerance(tolerance)
     {
       for (int dir = 0; dir < 4; ++dir) {
-        border[dir] = data.R()[dir];
+        border[dir] = data.R()[dir] - (halo ? halo[dir] : 0);
         X[dir] = data.X()[dir] - border[dir] * 2;
         threads *= X[dir];
       }
@@ -32,25 +37,18 @@ namespace quda
     }
   };
 
+  /**
+     @param[in] n_mu Staples are summed over the directions mu < n_mu
+  */
   template <typename Float, typename Arg, typename Link>
-  __host__ __device__ void computeStaple(Arg &arg, int idx, int parity, int dir, Link &staple)
+  __host__ __device__ void computeStaple(Arg &arg, const int *x, const int *X, int parity, int dir, Link &staple,
+                                        int n_mu = 3)
   {
 
-    // compute spacetime dimensions and parity
-    int X[4];
-    for (int dr = 0; dr < 4; ++dr) X[dr] = arg.X[dr];
-
-    int x[4];
-    getCoords(x, idx, X, parity);
-    for (int dr = 0; dr < 4; ++dr) {
-      x[dr] += arg.border[dr];
-      X[dr] += 2 * arg.border[dr];
-    }
-
     setZero(&staple);
 
     // I believe most users won't want to include time staples in smearing
-    for (int mu = 0; mu < 3; mu++) {
+    for (int mu = 0; mu < n_mu; mu++) {
 
       // identify directions orthogonal to the link.
       if (mu != dir) {
@@ -93,14 +91,13 @@ namespace quda
     }
   }
 
-  template <typename Float, typename Arg> __global__ void computeSTOUTStep(Arg arg)
+  /**
+     @brief STOUT smearing of the link U_dir(x), where (idx, parity) index the
+     sites of the region being smeared.  This is the body of both the
+     device kernel and the host loop.
+  */
+  template <typename Float, typename Arg> __host__ __device__ inline void stoutSite(Arg &arg, int idx, int parity, int dir)
   {
-
-    int idx = threadIdx.x + blockIdx.x * blockDim.x;
-    int parity = threadIdx.y + blockIdx.y * blockDim.y;
-    int dir = threadIdx.z + blockIdx.z * blockDim.z;
-    if (idx >= arg.threads) return;
-    if (dir >= 3) return;
     typedef complex<Float> Complex;
     typedef Matrix<complex<Float>, 3> Link;
 
@@ -113,6 +110,9 @@ namespace quda
       x[dr] += arg.border[dr];
       X[dr] += 2 * arg.border[dr];
     }
+    // parity in the extended field, which differs from that within the
+    // region when the border has odd depth
+    parity = (parity + arg.border[0] + arg.border[1] + arg.border[2] + arg.border[3]) & 1;
 
     int dx[4] = {0, 0, 0, 0};
     // Only spatial dimensions are smeared
@@ -122,7 +122,7 @@ namespace quda
       Complex i_2(0, 0.5);
 
       // This function gets stap = S_{mu,nu} i.e., the staple of length 3,
-      computeStaple<Float>(arg, idx, parity, dir, Stap);
+      computeStaple<Float>(arg, x, X, parity, dir, Stap);
       //
       // |- > -|                /- > -/                /- > -
       // ^     v               ^     v                ^
@@ -195,6 +195,16 @@ namespace quda
     }
   }
 
+  template <typename Float, typename Arg> __global__ void computeSTOUTStep(Arg arg)
+  {
+    int idx = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y + blockIdx.y * blockDim.y;
+    int dir = threadIdx.z + blockIdx.z * blockDim.z;
+    if (idx >= arg.threads) return;
+    if (dir >= 3) return;
+    stoutSite<Float>(arg, idx, parity, dir);
+  }
+
   //------------------------//
   // Over-Improved routines //
   //------------------------//
@@ -210,8 +220,12 @@ namespace quda
 
     GaugeDs dest;
 
+    /**
+       @param[in] halo Number of halo layers of the extended field to
+       smear in addition to the interior (none if nullptr)
+    */
     GaugeOvrImpSTOUTArg(GaugeOr &origin, GaugeDs &dest, const GaugeField &data, const Float rho, const Float epsilon,
-        const Float tolerance) :
+        const Float tolerance, const int *halo = nullptr) :
         threads(1),
         origin(origin),
         dest(dest),
@@ -220,7 +234,7 @@ namespace quda
         tolerance(tolerance)
     {
       for (int dir = 0; dir < 4; ++dir) {
-        border[dir] = data.R()[dir];
+        border[dir] = data.R()[dir] - (halo ? halo[dir] : 0);
         X[dir] = data.X()[dir] - border[dir] * 2;
         threads *= X[dir];
       }
@@ -229,20 +243,10 @@ namespace quda
   };
 
   template <typename Float, typename Arg, typename Link>
-  __host__ __device__ void computeStapleRectangle(Arg &arg, int idx, int parity, int dir, Link &staple, Link &rectangle)
+  __host__ __device__ void computeStapleRectangle(Arg &arg, const int *x, const int *X, int parity, int dir,
+                                                  Link &staple, Link &rectangle)
   {
 
-    // compute spacetime dimensions and parity
-    int X[4];
-    for (int dr = 0; dr < 4; ++dr) X[dr] = arg.X[dr];
-
-    int x[4];
-    getCoords(x, idx, X, parity);
-    for (int dr = 0; dr < 4; ++dr) {
-      x[dr] += arg.border[dr];
-      X[dr] += 2 * arg.border[dr];
-    }
-
     setZero(&staple);
     setZero(&rectangle);
 
@@ -460,14 +464,13 @@ namespace quda
     }
   }
 
-  template <typename Float, typename Arg> __global__ void computeOvrImpSTOUTStep(Arg arg)
+  /**
+     @brief Over-improved STOUT smearing of the link U_dir(x), where (idx, parity) index the
+     sites of the region being smeared.  This is the body of both the
+     device kernel and the host loop.
+  */
+  template <typename Float, typename Arg> __host__ __device__ inline void ovrImpStoutSite(Arg &arg, int idx, int parity, int dir)
   {
-
-    int idx = threadIdx.x + blockIdx.x * blockDim.x;
-    int parity = threadIdx.y + blockIdx.y * blockDim.y;
-    int dir = threadIdx.z + blockIdx.z * blockDim.z;
-    if (idx >= arg.threads) return;
-    // if (dir >= 3) return;
     typedef complex<Float> Complex;
     typedef Matrix<complex<Float>, 3> Link;
 
@@ -480,6 +483,9 @@ namespace quda
       x[dr] += arg.border[dr];
       X[dr] += 2 * arg.border[dr];
     }
+    // parity in the extended field, which differs from that within the
+    // region when the border has odd depth
+    parity = (parity + arg.border[0] + arg.border[1] + arg.border[2] + arg.border[3]) & 1;
 
     double staple_coeff = (5.0 - 2.0 * arg.epsilon) / 3.0;
     double rectangle_coeff = (1.0 - arg.epsilon) / 12.0;
@@ -494,7 +500,7 @@ namespace quda
       // This function gets stap = S_{mu,nu} i.e., the staple of length 3,
       // and the 1x2 and 2x1 rectangles of length 5. From the following paper:
       // https://arxiv.org/abs/0801.1165
-      computeStapleRectangle<Float>(arg, idx, parity, dir, Stap, Rect);
+      computeStapleRectangle<Float>(arg, x, X, parity, dir, Stap, Rect);
 
       // Get link U
       U = arg.origin(dir, linkIndexShift(x, dx, X), parity);
@@ -565,4 +571,14 @@ namespace quda
     }
   }
 
+  template <typename Float, typename Arg> __global__ void computeOvrImpSTOUTStep(Arg arg)
+  {
+    int idx = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y + blockIdx.y * blockDim.y;
+    int dir = threadIdx.z + blockIdx.z * blockDim.z;
+    if (idx >= arg.threads) return;
+    if (dir >= 4) return;
+    ovrImpStoutSite<Float>(arg, idx, parity, dir);
+  }
+
 } // namespace quda
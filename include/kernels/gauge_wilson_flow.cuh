@@ -0,0 +1,343 @@
+#include <gauge_field_order.h>
+#include <index_helper.cuh>
+#include <quda_matrix.h>
+#include <su3_project.cuh>
+#include <cub_helper.cuh>
+#include <kernels/gauge_stout.cuh>
+
+#ifndef Pi2
+#define Pi2 6.2831853071795864769252867665590
+#endif
+
+namespace quda
+{
+
+  /**
+     Sums reduced by a flow step: the plaquette, the clover energy
+     density and the topological charge, followed by the maximum
+     distance between the third- and second-order integrators.
+  */
+  typedef vector_type<double, 4> WFlowReduceType;
+
+  /**
+     @brief Reduction operator for WFlowReduceType: sums the
+     observables and takes the maximum of the distance.
+  */
+  struct WFlowReducer {
+    __device__ __host__ inline WFlowReduceType operator()(const WFlowReduceType &a, const WFlowReduceType &b) const
+    {
+      WFlowReduceType c;
+#pragma unroll
+      for (int i = 0; i < 3; i++) c[i] = a[i] + b[i];
+      c[3] = a[3] > b[3] ? a[3] : b[3];
+      return c;
+    }
+  };
+
+  template <typename Float, typename Gauge> struct GaugeWFlowArg : public ReduceArg<WFlowReduceType> {
+    int threads; // number of active threads required
+    int X[4];    // grid dimensions
+    int border[4];
+    Gauge origin; // W_i, the input of this stage
+    Gauge dest;   // W_{i+1}
+    Gauge acc;    // Runge-Kutta accumulator, in the Lie algebra
+    Gauge force;  // force of the Symanzik action (Zeuthen flow only)
+    Gauge w0;     // W_0, the input of the step (error estimate only)
+    Gauge low;    // second-order estimate of W_3 (error estimate only)
+    const QudaWFlowType type;
+    const int stage;     // Runge-Kutta stage, or -1 to measure only
+    const Float epsilon; // step size
+    const bool measure;  // measure the observables on the input
+    const bool estimate; // estimate the local integration error
+
+    /**
+       Unused accessors (e.g. force for the Wilson flow) alias origin
+       and are never dereferenced.
+       @param[in] halo Number of halo layers of the extended field to
+       compute in addition to the interior (none if nullptr)
+    */
+    GaugeWFlowArg(const Gauge &origin, const Gauge &dest, const Gauge &acc, const Gauge &force, const Gauge &w0,
+                  const Gauge &low, const GaugeField &data, QudaWFlowType type, int stage, Float epsilon,
+                  bool measure, bool estimate, const int *halo = nullptr) :
+      ReduceArg<WFlowReduceType>(),
+      threads(1),
+      origin(origin),
+      dest(dest),
+      acc(acc),
+      force(force),
+      w0(w0),
+      low(low),
+      type(type),
+      stage(stage),
+      epsilon(epsilon),
+      measure(measure),
+      estimate(estimate)
+    {
+      for (int dir = 0; dir < 4; ++dir) {
+        border[dir] = data.R()[dir] - (halo ? halo[dir] : 0);
+        X[dir] = data.X()[dir] - border[dir] * 2;
+        threads *= X[dir];
+      }
+      threads /= 2;
+    }
+  };
+
+  /**
+     @brief Coordinates of the site (idx, parity) of the region in the
+     extended field, returning the parity in the extended field
+  */
+  template <typename Arg> __host__ __device__ inline int wflowCoords(const Arg &arg, int x[4], int X[4], int idx, int parity)
+  {
+    for (int dr = 0; dr < 4; ++dr) X[dr] = arg.X[dr];
+    getCoords(x, idx, X, parity);
+    for (int dr = 0; dr < 4; ++dr) {
+      x[dr] += arg.border[dr];
+      X[dr] += 2 * arg.border[dr];
+    }
+    return (parity + arg.border[0] + arg.border[1] + arg.border[2] + arg.border[3]) & 1;
+  }
+
+  /**
+     @brief exp(A) for a traceless anti-Hermitian A
+  */
+  template <typename Float, typename Link> __host__ __device__ inline Link expAntiHerm(const Link &A)
+  {
+    Link Q = complex<Float>(0.0, -1.0) * A;
+    Link exp_iQ;
+    exponentiate_iQ(Q, &exp_iQ);
+    return exp_iQ;
+  }
+
+  /**
+     @brief Force of the flow action on the link U_dir(x), i.e., the
+     traceless anti-Hermitian part of the staples times U_dir(x)^dag.
+     The Zeuthen flow starts from the Symanzik force.
+  */
+  template <typename Float, typename Arg, typename Link>
+  __host__ __device__ inline Link wflowForce(Arg &arg, const int *x, const int *X, int parity, int dir, const Link &U)
+  {
+    Link Omega;
+    if (arg.type == QUDA_WFLOW_TYPE_WILSON) {
+      Link Stap;
+      computeStaple<Float>(arg, x, X, parity, dir, Stap, 4);
+      Omega = Stap * conj(U);
+    } else {
+      // tree-level Symanzik coefficients c0 = 5/3, c1 = -1/12
+      Link Stap, Rect;
+      computeStapleRectangle<Float>(arg, x, X, parity, dir, Stap, Rect);
+      Omega = (static_cast<Float>(5.0 / 3.0) * Stap - static_cast<Float>(1.0 / 12.0) * Rect) * conj(U);
+    }
+    makeAntiHerm(Omega);
+    return Omega;
+  }
+
+  /**
+     @brief Zeuthen flow force (1 + 1/12 nabla*_dir nabla_dir) F on
+     U_dir(x), applying the covariant second derivative along dir to
+     the Symanzik force F stored by the force kernel
+  */
+  template <typename Float, typename Arg, typename Link>
+  __host__ __device__ inline Link zeuthenForce(Arg &arg, const int *x, const int *X, int parity, int dir, const Link &U)
+  {
+    int dx[4] = {0, 0, 0, 0};
+    Link F = arg.force(dir, linkIndexShift(x, dx, X), parity);
+
+    dx[dir]++;
+    Link Fp = arg.force(dir, linkIndexShift(x, dx, X), 1 - parity);
+    dx[dir] -= 2;
+    Link Fm = arg.force(dir, linkIndexShift(x, dx, X), 1 - parity);
+    Link Um = arg.origin(dir, linkIndexShift(x, dx, X), 1 - parity);
+
+    Link D = U * Fp * conj(U) + conj(Um) * Fm * Um - static_cast<Float>(2.0) * F;
+    Link Z = F + static_cast<Float>(1.0 / 12.0) * D;
+    makeAntiHerm(Z);
+    return Z;
+  }
+
+  /**
+     @brief Symanzik force of the link U_dir(x) for the Zeuthen flow,
+     where (idx, parity) index the sites of the region
+  */
+  template <typename Float, typename Arg> __host__ __device__ inline void wflowForceSite(Arg &arg, int idx, int parity, int dir)
+  {
+    typedef Matrix<complex<Float>, 3> Link;
+    int x[4], X[4];
+    parity = wflowCoords(arg, x, X, idx, parity);
+    int dx[4] = {0, 0, 0, 0};
+    Link U = arg.origin(dir, linkIndexShift(x, dx, X), parity);
+    arg.force(dir, linkIndexShift(x, dx, X), parity) = wflowForce<Float>(arg, x, X, parity, dir, U);
+  }
+
+  template <typename Float, typename Arg> __global__ void computeWFlowForce(Arg arg)
+  {
+    int idx = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y + blockIdx.y * blockDim.y;
+    int dir = threadIdx.z + blockIdx.z * blockDim.z;
+    if (idx >= arg.threads) return;
+    if (dir >= 4) return;
+    wflowForceSite<Float>(arg, idx, parity, dir);
+  }
+
+  /**
+     @brief Clover leaves of the (mu, nu) plane at x: the sum of the
+     four plaquettes in the plane that start and end at x
+  */
+  template <typename Float, typename Arg>
+  __host__ __device__ inline Matrix<complex<Float>, 3> cloverLeaves(Arg &arg, const int *x, const int *X, int parity,
+                                                                   int mu, int nu)
+  {
+    typedef Matrix<complex<Float>, 3> Link;
+    int dx[4] = {0, 0, 0, 0};
+
+    // the twelve distinct links of the four leaves
+    Link Umu = arg.origin(mu, linkIndexShift(x, dx, X), parity);
+    Link Unu = arg.origin(nu, linkIndexShift(x, dx, X), parity);
+    dx[mu]++;
+    Link Unu_pmu = arg.origin(nu, linkIndexShift(x, dx, X), 1 - parity);
+    dx[nu]--;
+    Link Unu_pmu_mnu = arg.origin(nu, linkIndexShift(x, dx, X), parity);
+    dx[mu]--;
+    Link Umu_mnu = arg.origin(mu, linkIndexShift(x, dx, X), 1 - parity);
+    Link Unu_mnu = arg.origin(nu, linkIndexShift(x, dx, X), 1 - parity);
+    dx[mu]--;
+    Link Umu_mmu_mnu = arg.origin(mu, linkIndexShift(x, dx, X), parity);
+    Link Unu_mmu_mnu = arg.origin(nu, linkIndexShift(x, dx, X), parity);
+    dx[nu]++;
+    Link Umu_mmu = arg.origin(mu, linkIndexShift(x, dx, X), 1 - parity);
+    Link Unu_mmu = arg.origin(nu, linkIndexShift(x, dx, X), 1 - parity);
+    dx[nu]++;
+    Link Umu_mmu_pnu = arg.origin(mu, linkIndexShift(x, dx, X), parity);
+    dx[mu]++;
+    Link Umu_pnu = arg.origin(mu, linkIndexShift(x, dx, X), 1 - parity);
+
+    Link C = Umu * Unu_pmu * conj(Umu_pnu) * conj(Unu);
+    C += Unu * conj(Umu_mmu_pnu) * conj(Unu_mmu) * Umu_mmu;
+    C += conj(Umu_mmu) * conj(Unu_mmu_mnu) * Umu_mmu_mnu * Unu_mnu;
+    C += conj(Unu_mnu) * Umu_mnu * Unu_pmu_mnu * conj(Umu);
+    return C;
+  }
+
+  /**
+     @brief Measure the observables at x: the plaquette sum, the
+     clover energy density E = -sum_{mu<nu} tr(F_munu F_munu) and the
+     topological charge density, with F the traceless anti-Hermitian
+     part of the clover
+  */
+  template <typename Float, typename Arg>
+  __host__ __device__ inline void wflowMeasure(Arg &arg, const int *x, const int *X, int parity, WFlowReduceType &obs)
+  {
+    typedef Matrix<complex<Float>, 3> Link;
+    Link F[6]; // F[1,0], F[2,0], F[2,1], F[3,0], F[3,1], F[3,2]
+
+    double plaq = 0.0, E = 0.0;
+#pragma unroll
+    for (int mu = 1; mu < 4; mu++) {
+#pragma unroll
+      for (int nu = 0; nu < mu; nu++) {
+        Link C = cloverLeaves<Float>(arg, x, X, parity, mu, nu);
+        plaq += 0.25 * getTrace(C).real();
+        makeAntiHerm(C);
+        Link &Fmunu = F[(mu * (mu - 1)) / 2 + nu];
+        Fmunu = static_cast<Float>(0.25) * C;
+        E -= getTrace(Fmunu * Fmunu).real();
+      }
+    }
+    double Q = getTrace(F[0] * F[5]).real() + getTrace(F[3] * F[2]).real() - getTrace(F[1] * F[4]).real();
+
+    obs[0] += plaq;
+    obs[1] += E;
+    obs[2] += Q / (Pi2 * Pi2);
+  }
+
+  /**
+     @brief One stage of the third-order Runge-Kutta integrator of
+     Luscher (arXiv:1006.4518) for all links of the site (idx, parity),
+     using the low-storage form
+
+       acc = 1/4 Z0,                    W1 = exp(acc) W0
+       acc = 8/9 Z1 - 17/9 acc,         W2 = exp(acc) W1
+       acc = 3/4 Z2 - acc,              W3 = exp(acc) W2
+
+     with Zi = epsilon Z(Wi).  The second-order estimate
+     exp(2 Z1 - Z0) W0 of Fritzsch and Ramos (arXiv:1301.4388) is formed
+     at the second stage and compared with W3 at the last.  The
+     observables are measured on the input when requested, which on
+     the first stage is W0 at no extra memory traffic.
+  */
+  template <typename Float, typename Arg>
+  __host__ __device__ inline WFlowReduceType wflowSite(Arg &arg, int idx, int parity)
+  {
+    typedef Matrix<complex<Float>, 3> Link;
+
+    int x[4], X[4];
+    parity = wflowCoords(arg, x, X, idx, parity);
+
+    WFlowReduceType value;
+    if (arg.measure) wflowMeasure<Float>(arg, x, X, parity, value);
+    if (arg.stage < 0) return value;
+
+    int dx[4] = {0, 0, 0, 0};
+    const int index = linkIndexShift(x, dx, X);
+
+    for (int dir = 0; dir < 4; dir++) {
+      Link U = arg.origin(dir, index, parity);
+      Link Z = arg.type == QUDA_WFLOW_TYPE_ZEUTHEN ? zeuthenForce<Float>(arg, x, X, parity, dir, U) :
+                                                     wflowForce<Float>(arg, x, X, parity, dir, U);
+      Z = arg.epsilon * Z;
+
+      Link A;
+      switch (arg.stage) {
+      case 0: A = static_cast<Float>(0.25) * Z; break;
+      case 1: {
+        Link A0 = arg.acc(dir, index, parity);
+        A = static_cast<Float>(8.0 / 9.0) * Z - static_cast<Float>(17.0 / 9.0) * A0;
+        if (arg.estimate) {
+          Link W0 = arg.w0(dir, index, parity);
+          arg.low(dir, index, parity) = expAntiHerm<Float>(static_cast<Float>(2.0) * Z - static_cast<Float>(4.0) * A0) * W0;
+        }
+        break;
+      }
+      default: {
+        Link A1 = arg.acc(dir, index, parity);
+        A = static_cast<Float>(0.75) * Z - A1;
+        break;
+      }
+      }
+
+      U = expAntiHerm<Float>(A) * U;
+      arg.dest(dir, index, parity) = U;
+      if (arg.stage < 2) arg.acc(dir, index, parity) = A;
+
+      if (arg.stage == 2 && arg.estimate) {
+        Link W = arg.low(dir, index, parity);
+        Link D = U - W;
+        double d = 0.0;
+#pragma unroll
+        for (int i = 0; i < 3; i++)
+#pragma unroll
+          for (int j = 0; j < 3; j++) d += abs(D(i, j));
+        d /= 9.0;
+        value[3] = value[3] > d ? value[3] : d;
+      }
+    }
+
+    return value;
+  }
+
+  template <int blockSize, typename Float, typename Arg> __global__ void computeWFlowStep(Arg arg)
+  {
+    int idx = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y;
+
+    WFlowReduceType value;
+    WFlowReducer r;
+    while (idx < arg.threads) {
+      value = r(value, wflowSite<Float>(arg, idx, parity));
+      idx += blockDim.x * gridDim.x;
+    }
+
+    // perform final inter-block reduction and write out result
+    reduce2d<blockSize, 2, WFlowReduceType, false, WFlowReducer>(arg, value);
+  }
+
+} // namespace quda
@@ -2,6 +2,7 @@
 #include <cub_helper.cuh>
 #include <multigrid_helper.cuh>
 #include <fast_intdiv.h>
+#include <host_parallel.h>
 
 // enabling CTA swizzling improves spatial locality of MG blocks reducing cache line wastage
 #ifndef SWIZZLE
@@ -86,41 +87,47 @@ namespace quda {
 
   }
 
+  /**
+     Host restrictor: each coarse site gathers the contributions of
+     its aggregate through the coarse_to_fine look up table, so that
+     the coarse sites may be processed in parallel without atomics.
+  */
   template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, int coarse_colors_per_thread, typename Arg>
-  void Restrict(Arg arg) {
-    for (int parity_coarse=0; parity_coarse<2; parity_coarse++) 
-      for (int x_coarse_cb=0; x_coarse_cb<arg.out.VolumeCB(); x_coarse_cb++)
-	for (int s=0; s<coarseSpin; s++) 
-	  for (int c=0; c<coarseColor; c++)
-	    arg.out(parity_coarse, x_coarse_cb, s, c) = 0.0;
-
-    // loop over fine degrees of freedom
-    for (int parity=0; parity<arg.nParity; parity++) {
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-
-      for (int x_cb=0; x_cb<arg.in.VolumeCB(); x_cb++) {
-
-	int x = parity*arg.in.VolumeCB() + x_cb;
-	int x_coarse = arg.fine_to_coarse[x];
-	int parity_coarse = (x_coarse >= arg.out.VolumeCB()) ? 1 : 0;
-	int x_coarse_cb = x_coarse - parity_coarse*arg.out.VolumeCB();
-	
-	for (int coarse_color_block=0; coarse_color_block<coarseColor; coarse_color_block+=coarse_colors_per_thread) {
-	  complex<Float> tmp[fineSpin*coarse_colors_per_thread];
-	  rotateCoarseColor<Float,fineSpin,fineColor,coarseColor,coarse_colors_per_thread>
-	    (tmp, arg.in, arg.V, parity, arg.nParity, x_cb, coarse_color_block);
-
-	  for (int s=0; s<fineSpin; s++) {
-	    for (int coarse_color_local=0; coarse_color_local<coarse_colors_per_thread; coarse_color_local++) {
-	      int c = coarse_color_block + coarse_color_local;
-	      arg.out(parity_coarse,x_coarse_cb,arg.spin_map(s,parity),c) += tmp[s*coarse_colors_per_thread+coarse_color_local];
+  void Restrict(Arg &arg, const TuneParam &tp) {
+    const int block_size = arg.in.VolumeCB() / (2 * arg.out.VolumeCB()); // fine points per aggregate per parity
+
+    parallel_for(tp, 2, arg.out.VolumeCB(), [&](int parity_coarse, int x_coarse_cb) {
+	const int x_coarse = parity_coarse*arg.out.VolumeCB() + x_coarse_cb;
+
+	complex<Float> out[coarseSpin*coarseColor];
+	for (int i=0; i<coarseSpin*coarseColor; i++) out[i] = 0.0;
+
+	// loop over fine degrees of freedom in this aggregate
+	for (int parity=0; parity<arg.nParity; parity++) {
+	  parity = (arg.nParity == 2) ? parity : arg.parity;
+
+	  for (int b=0; b<block_size; b++) {
+	    int x_cb = arg.coarse_to_fine[(x_coarse*2 + parity)*block_size + b] - parity*arg.in.VolumeCB();
+
+	    for (int coarse_color_block=0; coarse_color_block<coarseColor; coarse_color_block+=coarse_colors_per_thread) {
+	      complex<Float> tmp[fineSpin*coarse_colors_per_thread];
+	      rotateCoarseColor<Float,fineSpin,fineColor,coarseColor,coarse_colors_per_thread>
+		(tmp, arg.in, arg.V, parity, arg.nParity, x_cb, coarse_color_block);
+
+	      for (int s=0; s<fineSpin; s++) {
+		for (int coarse_color_local=0; coarse_color_local<coarse_colors_per_thread; coarse_color_local++) {
+		  int c = coarse_color_block + coarse_color_local;
+		  out[arg.spin_map(s,parity)*coarseColor+c] += tmp[s*coarse_colors_per_thread+coarse_color_local];
+		}
+	      }
 	    }
 	  }
-
 	}
-      }
-    }
 
+	for (int s=0; s<coarseSpin; s++)
+	  for (int c=0; c<coarseColor; c++)
+	    arg.out(parity_coarse, x_coarse_cb, s, c) = out[s*coarseColor+c];
+      }); // parity and coarse c/b volume
   }
 
   /**
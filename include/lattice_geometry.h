@@ -0,0 +1,163 @@
+#pragma once
+
+/**
+   @file lattice_geometry.h
+
+   @brief Precomputed site coordinates and neighbour-index tables for
+   host stencil code.  Host references and kernels otherwise decode
+   the coordinates of every site, and re-encode the displaced
+   coordinates, for every neighbour they touch, which costs a chain of
+   integer divisions and modulos per hop.  A LatticeGeometry decodes
+   the lattice once (using int_fastdiv) and builds a compact table per
+   displacement on first use, so a stencil reduces to table lookups.
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <quda_internal.h>
+#include <fast_intdiv.h>
+
+namespace quda {
+
+  /**
+     @brief Host lattice geometry in the even-odd ordering used by host
+     fields: a site is addressed by its full index i = parity*volumeCB
+     + x_cb.  Displaced sites are returned either in the local lattice,
+     with periodic wrapping (no halo), or in the extended lattice of
+     dimensions X + 2R when a halo depth R is given.  In the latter
+     case the displacement must stay within the halo, and the returned
+     index is the full even-odd index of the extended lattice.
+   */
+  class LatticeGeometry
+  {
+    static constexpr int max_hop = 6;                 // tables are cached for |dx[d]| <= max_hop
+    static constexpr int n_hop = 2 * max_hop + 1;     // displacements per dimension
+    static constexpr int n_table = n_hop * n_hop * n_hop * n_hop;
+
+    int X[4];
+    int R[4];
+    int E[4];
+    int volume;
+    int volumeCB;
+    int volumeEx;
+    int volumeExCB;
+    bool halo;
+
+    std::vector<int> coord; // four local coordinates per site
+
+    mutable std::unique_ptr<std::atomic<const int *>[]> table;
+    mutable std::vector<std::unique_ptr<int[]>> table_store;
+    mutable std::mutex table_mutex;
+
+    static int tableIndex(const int dx[4])
+    {
+      return (((dx[3] + max_hop) * n_hop + dx[2] + max_hop) * n_hop + dx[1] + max_hop) * n_hop + dx[0] + max_hop;
+    }
+
+  public:
+    /**
+       @brief Decode the coordinates of every site
+       @param[in] X Local lattice dimensions
+       @param[in] R Halo depth of the extended lattice the neighbours
+       index into (nullptr for a periodic local lattice)
+     */
+    LatticeGeometry(const int *X, const int *R = nullptr);
+
+    int Volume() const { return volume; }
+    int VolumeCB() const { return volumeCB; }
+    int VolumeEx() const { return volumeEx; }
+    const int *Dims() const { return X; }
+    const int *Halo() const { return R; }
+
+    /**
+       @brief Coordinates of a site
+       @param[out] x Local coordinates
+       @param[in] i Full even-odd index of the site
+     */
+    void Coords(int x[4], int i) const
+    {
+      for (int d = 0; d < 4; d++) x[d] = coord[4 * i + d];
+    }
+
+    /**
+       @return Lexicographic index of the site with full even-odd index i
+     */
+    int LexIndex(int i) const
+    {
+      const int *x = &coord[4 * i];
+      return ((x[3] * X[2] + x[2]) * X[1] + x[1]) * X[0] + x[0];
+    }
+
+    /**
+       @brief Full even-odd index of a site given by (possibly out of
+       range) local coordinates, wrapped periodically or placed in the
+       extended lattice
+       @param[in] x Local coordinates
+       @return Full even-odd index of the site
+     */
+    int Index(const int x[4]) const;
+
+    /**
+       @brief Neighbour index of a single site.  This reads the cached
+       table when the displacement is within range and otherwise
+       computes the index directly; loops over the lattice should hoist
+       Neighbors() instead.
+       @param[in] i Full even-odd index of the site
+       @param[in] dx Displacement in each dimension
+       @return Full even-odd index of the displaced site
+     */
+    int Neighbor(int i, const int dx[4]) const
+    {
+      bool cached = true;
+      for (int d = 0; d < 4; d++) cached = cached && dx[d] >= -max_hop && dx[d] <= max_hop;
+      if (cached) return Neighbors(dx)[i];
+
+      int y[4];
+      for (int d = 0; d < 4; d++) y[d] = coord[4 * i + d] + dx[d];
+      return Index(y);
+    }
+
+    /**
+       @brief Neighbour table for a given displacement, built on first
+       use and then shared.  Safe to call from within parallel regions.
+       @param[in] dx Displacement in each dimension, |dx[d]| <= 6
+       @return Table of length Volume() mapping the full even-odd index
+       of a site to that of the displaced site
+     */
+    const int *Neighbors(const int dx[4]) const
+    {
+      for (int d = 0; d < 4; d++)
+        if (dx[d] < -max_hop || dx[d] > max_hop) errorQuda("Displacement %d exceeds maximum %d", dx[d], max_hop);
+      const int *t = table[tableIndex(dx)].load(std::memory_order_acquire);
+      return t ? t : buildTable(dx);
+    }
+
+    /**
+       @brief Neighbour table for a displacement along one dimension
+       @param[in] dim Dimension of the displacement
+       @param[in] hop Signed number of hops
+     */
+    const int *Neighbors(int dim, int hop) const
+    {
+      int dx[4] = {0, 0, 0, 0};
+      dx[dim] = hop;
+      return Neighbors(dx);
+    }
+
+  private:
+    const int *buildTable(const int dx[4]) const;
+  };
+
+  /**
+     @brief Return the cached geometry for the given dimensions and
+     halo depth, creating it on first use
+     @param[in] X Local lattice dimensions
+     @param[in] R Halo depth (nullptr for a periodic local lattice)
+     @return The lattice geometry
+   */
+  const LatticeGeometry &getLatticeGeometry(const int *X, const int *R = nullptr);
+
+} // namespace quda
@@ -8,16 +8,16 @@ namespace quda {
 
   /**
      @brief Compute the fat and long links for an improved staggered
-     (Kogut-Susskind) fermions.
+     (Kogut-Susskind) fermions.  The fields may be on the device or,
+     with the order and precision of the input links and no
+     reconstruction, on the host, where the staples run threaded.
      @param fat[out] The computed fat link
      @param lng[out] The computed long link (only computed if lng!=0)
-     @param u[in] The input gauge field
+     @param u[in] The input gauge field, extended by the halo depth
+     in the partitioned dimensions
      @param coeff[in] Array of path coefficients
   */
-  void fatLongKSLink(cudaGaugeField* fat,
-		     cudaGaugeField* lng,
-		     const cudaGaugeField& gauge,
-		     const double* coeff);
+  void fatLongKSLink(GaugeField *fat, GaugeField *lng, const GaugeField &gauge, const double *coeff);
   
 } // namespace quda
 
@@ -8,3 +8,12 @@
  * @return          0 if numa affinity was set
  */
 int setNumaAffinityNVML(int deviceid);
+
+/**
+ * pins each host (OpenMP) thread to its own cpu within the affinity mask of the calling process,
+ * with the cpus ordered by NUMA node starting from that of the calling thread, such that the
+ * teams used by the host execution layer (host_parallel.h) are packed onto the fewest nodes.
+ * This should be called after setNumaAffinityNVML so that the mask is local to the device.
+ * @return          0 if the host threads were pinned
+ */
+int setHostThreadAffinity();
@@ -4,6 +4,7 @@
 
 
 #include <random_quda.h>
+#include <random_philox.h>
 #include <quda.h>
 
 
@@ -11,6 +12,19 @@
 namespace quda {
   
 
+  /**
+   * @brief Statistics of heatbath and overrelaxation sweeps, accumulated
+   * by Monte on this process: zero-initialize before the first call.
+   * The acceptance of the SU(2) heatbath is updates / trials.
+   */
+  struct MonteStats {
+    long long updates;  // SU(2) subgroup heatbath updates
+    long long trials;   // SU(2) candidates drawn by the heatbath
+    long long failures; // SU(2) updates with no candidate accepted (the link is still changed)
+    double hb_secs;     // time in heatbath sweeps
+    double ovr_secs;    // time in overrelaxation sweeps
+  };
+
   /** @brief Perform heatbath and overrelaxation. Performs nhb heatbath steps followed by nover overrelaxation steps.
    *
    * @param[in,out] data Gauge field
@@ -18,8 +32,25 @@ namespace quda {
    * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
    * @param[in] nhb number of heatbath steps
    * @param[in] nover number of overrelaxation steps
+   * @param[in,out] stats if set, accumulates the heatbath statistics and timings
+   */
+  void Monte( cudaGaugeField& data, RNG &rngstate, double Beta, int nhb, int nover, MonteStats *stats = nullptr);
+
+  /** @brief Perform heatbath and overrelaxation on a host gauge field. Performs nhb heatbath steps followed by nover overrelaxation steps.
+   *
+   * The random numbers of each heatbath sweep are drawn from a Philox stream per link,
+   * so the result does not depend on the number of threads or the process grid.  On a
+   * partitioned lattice the field must be extended with an even border in the partitioned
+   * dimensions; the halo links are exchanged while the interior is updated.
+   *
+   * @param[in,out] data Host gauge field in QDP or MILC order
+   * @param[in,out] rng Philox generator, advanced once per heatbath step
+   * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
+   * @param[in] nhb number of heatbath steps
+   * @param[in] nover number of overrelaxation steps
+   * @param[in,out] stats if set, accumulates the heatbath statistics and timings
    */
-  void Monte( cudaGaugeField& data, RNG &rngstate, double Beta, int nhb, int nover);
+  void Monte( GaugeField& data, PhiloxRNG &rng, double Beta, int nhb, int nover, MonteStats *stats = nullptr);
 
   /** @brief Perform a cold start to the gauge field, identity SU(3) matrix, also fills the ghost links in multi-GPU case (no need to exchange data)
    *
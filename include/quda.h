@@ -88,6 +88,8 @@ extern "C" {
     size_t mom_offset; /**< Offset into MILC site struct to the momentum field (only if gauge_order=MILC_SITE_GAUGE_ORDER) */
     size_t site_size; /**< Size of MILC site struct (only if gauge_order=MILC_SITE_GAUGE_ORDER) */
 
+    QudaFieldLocation compute_location; /**< Where the link fattening, gauge force and FFT gauge fixing are computed (default QUDA_CUDA_FIELD_LOCATION) */
+
   } QudaGaugeParam;
 
 
@@ -128,6 +130,7 @@ extern "C" {
     int maxiter; /**< Maximum number of iterations in the linear solver */
     double reliable_delta; /**< Reliable update tolerance */
     double reliable_delta_refinement; /**< Reliable update tolerance used in post multi-shift solver refinement */
+    int batched_refinement; /**< Whether to refine the under-converged shifts of a multi-shift solve together rather than one at a time */
     int use_alternative_reliable; /**< Whether to use alternative reliable updates */
     int use_sloppy_partial_accumulator; /**< Whether to keep the partial solution accumuator in sloppy precision */
 
@@ -367,6 +370,22 @@ extern "C" {
     /** Precision to store the chronological basis in */
     QudaPrecision chrono_precision;
 
+    /** The number of chronological basis vectors kept in device memory, the
+        remainder are stored in host memory (0 keeps every vector on the device) */
+    int chrono_resident_dim;
+
+    /** Precision to store the host resident chronological basis vectors in */
+    QudaPrecision chrono_spill_precision;
+
+    /** Precision to store the subspace recycled by GCRO-DR between solves in
+        (its dimension is nev and the Krylov subspace dimension max_search_dim) */
+    QudaPrecision cuda_prec_recycle;
+
+    /** Whether GCRO-DR keeps the recycled subspace when the gauge field or the
+        operator parameters change, recomputing its image under the new
+        operator (1), or discards it (0) */
+    int recycle_keep_on_update;
+
     /** Which external library to use in the linear solvers (MAGMA or Eigen) */
     QudaExtLibType extlib_type;
 
@@ -393,6 +412,14 @@ extern "C" {
     double a_min;
     double a_max;
 
+    /** Estimate a_min, a_max and poly_deg automatically, in which case poly_deg is the maximum degree.
+        Only supported by the TR Lanczos and block TR Lanczos eigensolvers, not with arpack_check **/
+    QudaBoolean poly_acc_auto;
+
+    /** Target damping of the filtered spectrum relative to the nConv-th eigenvalue per application of the
+        automatically chosen polynomial **/
+    double poly_acc_rate;
+
     /** What type of Dirac operator we are using **/
     /** If !(use_norm_op) && !(use_dagger) use M. **/
     /** If use_dagger, use Mdag **/
@@ -424,6 +451,10 @@ extern "C" {
     int check_interval;
     /** For IRLM/IRAM, quit after n restarts **/
     int max_restarts;
+    /** For block TRLM, the number of Krylov vectors advanced per Lanczos step **/
+    int block_size;
+    /** The number of operator applications performed by the eigensolver (returned) **/
+    int iter;
 
     /** In the test function, cross check the device result against ARPACK **/
     QudaBoolean arpack_check;
@@ -449,6 +480,13 @@ extern "C" {
     /** The memory type used to keep the Ritz vectors */
     QudaMemoryType mem_type_ritz;
 
+    /** The number of Ritz vectors kept with mem_type_ritz, the remainder are
+        stored in host memory (0 keeps every vector resident) */
+    int ritz_resident_dim;
+
+    /** Precision to store the host resident Ritz vectors in */
+    QudaPrecision ritz_spill_precision;
+
     /** Location where deflation should be done */
     QudaFieldLocation location;
 
@@ -461,6 +499,15 @@ extern "C" {
     /** Filename prefix for where to save the null-space vectors */
     char vec_outfile[256];
 
+    /** Number of block-local basis vectors used to compress saved vectors (0 saves them uncompressed) */
+    int vec_compress_n_basis;
+
+    /** Local block dimensions of the compressed vector store */
+    int vec_compress_block_size[4];
+
+    /** Target relative quantization error of each compressed vector */
+    double vec_compress_tol;
+
     /** The Gflops rate of the eigensolver setup */
     double gflops;
 
@@ -635,6 +682,13 @@ extern "C" {
     /** Filename prefix for where to save the null-space vectors */
     char vec_outfile[QUDA_MAX_MG_LEVEL][256];
 
+    /** Number of block-local basis vectors used to compress saved null-space vectors, with blocks of
+        geo_block_size (0 saves them uncompressed) */
+    int vec_compress_n_basis[QUDA_MAX_MG_LEVEL];
+
+    /** Target relative quantization error of each compressed null-space vector */
+    double vec_compress_tol[QUDA_MAX_MG_LEVEL];
+
     /** Whether to use and initial guess during coarse grid deflation */
     QudaBoolean coarse_guess;
 
@@ -1029,6 +1083,12 @@ extern "C" {
   void pack_ghost(void **cpuLink, void **cpuGhost, int nFace,
       QudaPrecision precision);
 
+  /**
+   * Compute the fat (and optionally long and unitarized) links of
+   * improved staggered fermions.  With param->compute_location set to
+   * QUDA_CPU_FIELD_LOCATION the links are computed on the host, in the
+   * order (QDP or MILC) and precision (cpu_prec) of the input links.
+   */
   void computeKSLinkQuda(void* fatlink, void* longlink, void* ulink, void* inlink,
                          double *path_coeff, QudaGaugeParam *param);
 
@@ -1046,6 +1106,11 @@ extern "C" {
    * @param max_length The maximum number of non-zero of links in any path in the action
    * @param dt The integration step size (for MILC this is dt*beta/3)
    * @param param The parameters of the external fields and the computation settings
+   *
+   * With param->compute_location set to QUDA_CPU_FIELD_LOCATION the
+   * force is computed on the host, directly on the momentum (in MILC
+   * order) and gauge field (QDP or MILC order) passed in, which
+   * excludes the resident fields.
    */
   int computeGaugeForceQuda(void* mom, void* sitelink,  int*** input_path_buf, int* path_length,
 			    double* loop_coeff, int num_paths, int max_length, double dt,
@@ -1253,6 +1318,17 @@ extern "C" {
    */
   void performOvrImpSTOUTnStep(unsigned int nSteps, double rho, double epsilon);
 
+  /**
+   * Performs the gradient flow on gaugePrecise to flow time t_max and stores the result in gaugeSmeared,
+   * printing the plaquette, energy density and topological charge measured along the flow.
+   * @param wflow_type   Flow action (Wilson, Symanzik or Zeuthen)
+   * @param t_max        Final flow time
+   * @param epsilon      Step size, or the initial step size if adaptive
+   * @param tolerance    Local error tolerance of the adaptive step size (zero for a fixed step size)
+   * @param meas_interval Measure every meas_interval steps and at t_max (zero for no measurements)
+   */
+  void performWFlowQuda(QudaWFlowType wflow_type, double t_max, double epsilon, double tolerance, int meas_interval);
+
   /**
    * Calculates the topological charge from gaugeSmeared, if it exist, or from gaugePrecise if no smeared fields are present.
    */
@@ -1312,6 +1388,10 @@ extern "C" {
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
    * @param[in] param The parameters of the external fields and the computation settings
    * @param[out] timeinfo
+   *
+   * With param->compute_location set to QUDA_CPU_FIELD_LOCATION the
+   * gauge field (QDP or MILC order) is fixed in place on the host,
+   * which excludes the resident fields.
    */
   int computeGaugeFixingFFTQuda(void* gauge,
                       const unsigned int gauge_dir,
@@ -1330,6 +1410,11 @@ extern "C" {
    */
   void flushChronoQuda(int index);
 
+  /**
+   * @brief Discard the subspace recycled between GCRO-DR solves
+   */
+  void flushRecycleQuda(void);
+
 
   /**
   * Open/Close MAGMA library
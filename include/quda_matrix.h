@@ -1208,6 +1208,14 @@ namespace quda {
       //We now find: exp(iQ) = f0*I + f1*Q + f2*Q^2
       //      where       fj = fj(c0,c1), j=0,1,2.
 
+      //[34] Test for c0 < 0.  The fj are calculated with c0 > 0, so
+      //the sign must be taken before theta, and all fj converted.
+      int parity = 0;
+      if(c0 < 0) {
+	c0 *= -1.0;
+	parity = 1;
+      }
+
       //[17]
       c0_max = 2*pow(c1*inv3,1.5);
 
@@ -1240,14 +1248,6 @@ namespace quda {
       else sinc_w = sin(w_p)/w_p;
 
 
-      //[34] Test for c0 < 0.
-      int parity = 0;
-      if(c0 < 0) {
-	c0 *= -1.0;
-	parity = 1;
-	//calculate fj with c0 > 0 and then convert all fj.
-      }
-
       //Get all the numerators for fj,
       //[30] f0
       hj_re = (u_sq - w_sq)*exp_2iu_re + 8*u_sq*cos_w*exp_iu_re + 2*u_p*(3*u_sq + w_sq)*sinc_w*exp_iu_im;
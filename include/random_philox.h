@@ -0,0 +1,233 @@
+#pragma once
+
+/**
+   @file random_philox.h
+
+   @brief Counter-based random numbers with the Philox-4x32-10
+   generator of Salmon et al., "Parallel random numbers: as easy as
+   1, 2, 3" (SC11).  A random block is a pure function of a 128-bit
+   counter and a 64-bit key, so a stream needs no stored state beyond
+   its position: any site, link or thread can start its own stream
+   from (seed, subsequence, offset), and the numbers drawn do not
+   depend on which thread draws them or in which order.
+ */
+
+#include <quda_internal.h>
+
+namespace quda {
+
+  /**
+     @brief State of a Philox stream: the counter of the next block,
+     the key, and the block being consumed
+   */
+  struct PhiloxState {
+    unsigned int counter[4];
+    unsigned int key[2];
+    unsigned int block[4];
+    int used; // words of block already returned
+  };
+
+  /**
+     @brief The upper 32 bits of the 64-bit product a * b
+   */
+  __host__ __device__ inline unsigned int philoxMulHi(unsigned int a, unsigned int b)
+  {
+#ifdef __CUDA_ARCH__
+    return __umulhi(a, b);
+#else
+    return static_cast<unsigned int>((static_cast<unsigned long long>(a) * b) >> 32);
+#endif
+  }
+
+  /**
+     @brief The Philox-4x32-10 bijection: out = philox(counter, key)
+     @param[out] out The random block
+     @param[in] counter The counter
+     @param[in] key The key
+   */
+  __host__ __device__ inline void philox4x32(unsigned int out[4], const unsigned int counter[4], const unsigned int key[2])
+  {
+    constexpr unsigned int M0 = 0xD2511F53, M1 = 0xCD9E8D57; // multipliers
+    constexpr unsigned int W0 = 0x9E3779B9, W1 = 0xBB67AE85; // Weyl sequence of the key
+    unsigned int c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    unsigned int k0 = key[0], k1 = key[1];
+
+#pragma unroll
+    for (int round = 0; round < 10; round++) {
+      const unsigned int hi0 = philoxMulHi(M0, c0), lo0 = M0 * c0;
+      const unsigned int hi1 = philoxMulHi(M1, c2), lo1 = M1 * c2;
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = lo1;
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = lo0;
+      k0 += W0;
+      k1 += W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+  /**
+     @brief Start a stream, analogous to curand_init: streams with
+     the same seed and different subsequences are independent, and
+     offset skips that many blocks (of four 32-bit words) of the
+     subsequence.  The subsequence is the upper half of the counter
+     and the offset the lower half, so every subsequence has 2^64
+     blocks.
+     @param[out] state The stream
+     @param[in] seed Seed (the key)
+     @param[in] subsequence Subsequence, e.g., a global site index
+     @param[in] offset Blocks to skip
+   */
+  __host__ __device__ inline void philoxInit(PhiloxState &state, unsigned long long seed,
+                                             unsigned long long subsequence, unsigned long long offset)
+  {
+    state.key[0] = static_cast<unsigned int>(seed);
+    state.key[1] = static_cast<unsigned int>(seed >> 32);
+    state.counter[0] = static_cast<unsigned int>(offset);
+    state.counter[1] = static_cast<unsigned int>(offset >> 32);
+    state.counter[2] = static_cast<unsigned int>(subsequence);
+    state.counter[3] = static_cast<unsigned int>(subsequence >> 32);
+    state.used = 4;
+  }
+
+  /**
+     @brief The next 32 random bits of a stream
+   */
+  __host__ __device__ inline unsigned int philoxNext(PhiloxState &state)
+  {
+    if (state.used == 4) {
+      philox4x32(state.block, state.counter, state.key);
+      if (++state.counter[0] == 0) ++state.counter[1];
+      state.used = 0;
+    }
+    return state.block[state.used++];
+  }
+
+  /**
+     @brief Convert random words to a number in (0,1): 24 random bits
+     of one word in single precision and 53 bits of two words in
+     double
+     @param[in] word The random words
+   */
+  template <class Real> __host__ __device__ inline Real philoxUniform(const unsigned int *word);
+
+  template <> __host__ __device__ inline float philoxUniform<float>(const unsigned int *word)
+  {
+    return (static_cast<float>(word[0] >> 8) + 0.5f) * 5.9604644775390625e-08f; // 2^-24
+  }
+
+  template <> __host__ __device__ inline double philoxUniform<double>(const unsigned int *word)
+  {
+    const unsigned long long hi = word[0] >> 5; // 27 bits
+    const unsigned long long lo = word[1] >> 6; // 26 bits
+    return (static_cast<double>((hi << 26) | lo) + 0.5) * 1.1102230246251565e-16; // 2^-53
+  }
+
+  /**
+     @brief Return a random number in (0,1) from a Philox stream
+   */
+  template <class Real> __host__ __device__ inline Real Random(PhiloxState &state);
+
+  template <> __host__ __device__ inline float Random<float>(PhiloxState &state)
+  {
+    const unsigned int word = philoxNext(state);
+    return philoxUniform<float>(&word);
+  }
+
+  template <> __host__ __device__ inline double Random<double>(PhiloxState &state)
+  {
+    unsigned int word[2];
+    word[0] = philoxNext(state);
+    word[1] = philoxNext(state);
+    return philoxUniform<double>(word);
+  }
+
+  /**
+     @brief Return a random number in (a,b) from a Philox stream
+   */
+  template <class Real> __host__ __device__ inline Real Random(PhiloxState &state, Real a, Real b)
+  {
+    return a + (b - a) * Random<Real>(state);
+  }
+
+  /**
+     @brief Random block of a site, addressed directly without a
+     stream: block b of stream id s of site x is the Philox of the
+     counter (b, s, x) with the seed as key.  This is block b of
+     philoxInit(state, seed, x, s << 32), so the stream id plays the
+     role of the epoch of PhiloxRNG, but a kernel can compute any
+     block it needs, in any order and on any thread.
+     @param[out] out The random block
+     @param[in] seed Seed (the key)
+     @param[in] site Global index of the site
+     @param[in] stream Stream id, e.g., the direction of a link
+     @param[in] block Index of the block
+   */
+  __host__ __device__ inline void philoxBlock(unsigned int out[4], unsigned long long seed, unsigned long long site,
+                                              unsigned int stream, unsigned int block)
+  {
+    const unsigned int counter[4]
+      = {block, stream, static_cast<unsigned int>(site), static_cast<unsigned int>(site >> 32)};
+    const unsigned int key[2] = {static_cast<unsigned int>(seed), static_cast<unsigned int>(seed >> 32)};
+    philox4x32(out, counter, key);
+  }
+
+  /**
+     @brief Lexicographic index of a site on the global lattice.
+     Keying streams on it rather than on a local or thread index makes
+     the random numbers independent of the process grid.
+     @param[in] x Coordinates of the site on the local lattice
+     @param[in] offset Coordinates of the local lattice origin on the global lattice
+     @param[in] global Dimensions of the global lattice
+     @param[in] nDim Number of dimensions
+   */
+  __host__ __device__ inline unsigned long long globalSiteIndex(const int *x, const int *offset, const int *global,
+                                                                int nDim = 4)
+  {
+    unsigned long long index = 0;
+    for (int d = nDim - 1; d >= 0; d--) index = index * global[d] + offset[d] + x[d];
+    return index;
+  }
+
+  /**
+     @brief Host handle on a family of Philox streams.  It holds the
+     seed and an epoch, the number of times the streams have been
+     advanced: the stream of subsequence s in epoch e starts at block
+     e * 2^32 of s, so each epoch gives every subsequence 2^32 blocks
+     of its own.  An algorithm draws from the subsequences it needs
+     (one per site or link, say) and then advances the epoch, which is
+     all the state a counter-based generator has to carry between
+     calls.
+   */
+  class PhiloxRNG
+  {
+    unsigned long long seed;
+    unsigned long long epoch;
+
+  public:
+    PhiloxRNG(unsigned long long seed, unsigned long long epoch = 0) : seed(seed), epoch(epoch) { }
+
+    unsigned long long Seed() const { return seed; }
+    unsigned long long Epoch() const { return epoch; }
+
+    /**
+       @brief Move on to the next epoch
+     */
+    void advance() { epoch++; }
+
+    /**
+       @brief The stream of a subsequence in the current epoch
+     */
+    PhiloxState State(unsigned long long subsequence) const
+    {
+      PhiloxState state;
+      philoxInit(state, seed, subsequence, epoch << 32);
+      return state;
+    }
+  };
+
+} // namespace quda
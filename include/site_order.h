@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+   @file site_order.h
+
+   @brief Cache-friendly site orderings for host fields.  Host fields
+   are stored even-odd with each parity in lexicographic order, so the
+   z and t neighbours of a site are a full slice away in memory.  The
+   blocked and Morton orderings keep the even-odd split but permute the
+   sites within each parity such that nearby sites are stored nearby,
+   and come with precomputed neighbour tables for host stencils.
+ */
+
+#include <vector>
+#include <quda_internal.h>
+
+namespace quda {
+
+  class ColorSpinorField;
+  class GaugeField;
+
+  /**
+     @brief Permutation of the sites within each parity of a 4-d
+     checkerboarded lattice.  The permutation is defined on the
+     checkerboarded coordinates (x/2, y, z, t), so it is the same for
+     both parities and parity subset fields may be reordered without
+     knowing which parity they hold.
+   */
+  class SiteOrdering
+  {
+    QudaSiteOrder order;
+    int X[4];     // full local lattice dimensions
+    int block[4]; // tile size in checkerboarded coordinates (blocked order only)
+    int volumeCB;
+
+    std::vector<int> storage; // checkerboard index -> storage index
+    std::vector<int> cb;      // storage index -> checkerboard index
+    std::vector<int> nbr[2];  // per parity: 8 neighbour storage indices per storage site
+
+  public:
+    /**
+       @brief Construct the ordering and its neighbour tables
+       @param[in] X Local lattice dimensions
+       @param[in] order Site order (even-odd, blocked or Morton)
+       @param[in] block Tile dimensions for the blocked order, in full
+       lattice coordinates (default 4^4)
+     */
+    SiteOrdering(const int *X, QudaSiteOrder order, const int *block = nullptr);
+
+    QudaSiteOrder Order() const { return order; }
+    int VolumeCB() const { return volumeCB; }
+
+    /**
+       @return Storage index of the site with checkerboard index x_cb
+     */
+    int Index(int x_cb) const { return storage[x_cb]; }
+
+    /**
+       @return Checkerboard index of the site at storage index s
+     */
+    int CbIndex(int s) const { return cb[s]; }
+
+    /**
+       @brief Storage index of a nearest neighbour.  Neighbours wrap
+       around the local volume, so this is suitable for single-process
+       host stencils and references.
+       @param[in] parity Parity of the site
+       @param[in] s Storage index of the site
+       @param[in] dim Dimension of the hop
+       @param[in] dir Forwards (0) or backwards (1)
+       @return Storage index of the neighbour, in the other parity
+     */
+    int Neighbor(int parity, int s, int dim, int dir) const { return nbr[parity][8 * s + 2 * dim + dir]; }
+
+    /**
+       @return Neighbour table for the given parity, with entry
+       8*s + 2*dim + dir as described in Neighbor()
+     */
+    const int *Neighbors(int parity) const { return nbr[parity].data(); }
+  };
+
+  /**
+     @brief Return the cached ordering for the given dimensions and
+     order, creating it on first use
+     @param[in] X Local lattice dimensions
+     @param[in] order Site order
+     @return The site ordering
+   */
+  const SiteOrdering &getSiteOrdering(const int *X, QudaSiteOrder order);
+
+  /**
+     @brief Whether the site order is one of the host-only
+     cache-friendly orders
+   */
+  inline bool isReorderedSiteOrder(QudaSiteOrder order)
+  {
+    return order == QUDA_BLOCKED_SITE_ORDER || order == QUDA_MORTON_SITE_ORDER;
+  }
+
+  /**
+     @brief Copy a host color-spinor field into another with a
+     different site order.  Both fields must have the same precision
+     and a site-contiguous field order (space-spin-color or
+     space-color-spin); 5-d fields are reordered per 4-d slice.
+     @param[out] out Destination field, in its own site order
+     @param[in] in Source field
+   */
+  void reorderSites(ColorSpinorField &out, const ColorSpinorField &in);
+
+  /**
+     @brief Copy a host gauge field into another with a different
+     site order.  Both fields must have the same precision,
+     reconstruction and geometry and be in QDP or MILC order.  Only
+     the body of the field is reordered: ghost zones are not supported
+     for reordered gauge fields.
+     @param[out] out Destination field, in its own site order
+     @param[in] in Source field
+   */
+  void reorderSites(GaugeField &out, const GaugeField &in);
+
+} // namespace quda
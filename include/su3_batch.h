@@ -0,0 +1,500 @@
+#pragma once
+
+/**
+   @file su3_batch.h
+
+   @brief Host SU(3) arithmetic on batches of matrices stored as a
+   structure of arrays.  A batch holds W matrices, with each of the 18
+   real components of the batch stored as a contiguous array of W
+   lanes.  Every operation is then a sequence of loops over the lanes
+   with no dependence between them, which are marked for
+   vectorization so that each loop compiles to SIMD instructions (and
+   to fused multiply-adds where the target has them, e.g., with the
+   -march=native of the release build).  The default width fills a
+   64-byte vector, i.e., eight doubles or sixteen floats.
+
+   The operations agree with the scalar Matrix<complex<Float>,3>
+   operations of quda_matrix.h to rounding, and may alias their
+   inputs and outputs.  Host gauge code batches W consecutive sites
+   with set() and get() and applies the operations to the batch.
+ */
+
+#include <cmath>
+#include <limits>
+#include <quda_matrix.h>
+
+namespace quda {
+
+  /**
+     @brief The number of lanes of a batch that fills a 64-byte vector
+   */
+  template <typename Float> constexpr int su3BatchWidth() { return 64 / sizeof(Float); }
+
+  /**
+     @brief A batch of W 3x3 complex matrices.  Component (i,j) of
+     lane l is (re[3*i+j][l], im[3*i+j][l]).  Batches allocated on the
+     heap must be 64-byte aligned, e.g., with posix_memalign, since
+     operator new only respects the alignment from C++17.
+   */
+  template <typename Float, int W = su3BatchWidth<Float>()> struct SU3Batch {
+    static constexpr int width = W;
+    alignas(64) Float re[9][W];
+    alignas(64) Float im[9][W];
+
+    /**
+       @brief Set lane l to the matrix m
+     */
+    inline void set(int l, const Matrix<complex<Float>, 3> &m)
+    {
+      for (int k = 0; k < 9; k++) {
+        re[k][l] = m.data[k].real();
+        im[k][l] = m.data[k].imag();
+      }
+    }
+
+    /**
+       @brief The matrix in lane l
+     */
+    inline Matrix<complex<Float>, 3> get(int l) const
+    {
+      Matrix<complex<Float>, 3> m;
+      for (int k = 0; k < 9; k++) m.data[k] = complex<Float>(re[k][l], im[k][l]);
+      return m;
+    }
+
+    inline void zero()
+    {
+      for (int k = 0; k < 9; k++) {
+#pragma omp simd
+        for (int l = 0; l < W; l++) re[k][l] = im[k][l] = 0.0;
+      }
+    }
+
+    inline void identity()
+    {
+      for (int k = 0; k < 9; k++) {
+#pragma omp simd
+        for (int l = 0; l < W; l++) {
+          re[k][l] = (k % 4 == 0) ? 1.0 : 0.0;
+          im[k][l] = 0.0;
+        }
+      }
+    }
+  };
+
+  /**
+     @brief Accumulate coeff * op(a) op(b) into r, or set r to it,
+     where op is the identity or the adjoint
+     @tparam dagger_a Whether to take the adjoint of a
+     @tparam dagger_b Whether to take the adjoint of b
+     @tparam accumulate Whether to add to r rather than overwrite it
+   */
+  template <bool dagger_a, bool dagger_b, bool accumulate, typename Float, int W>
+  inline void mulBatch(SU3Batch<Float, W> &r, const SU3Batch<Float, W> &a, const SU3Batch<Float, W> &b, Float coeff)
+  {
+    constexpr Float sa = dagger_a ? -1.0 : 1.0;
+    constexpr Float sb = dagger_b ? -1.0 : 1.0;
+    alignas(64) Float c_re[9][W];
+    alignas(64) Float c_im[9][W];
+
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        Float *cr = c_re[3 * i + j], *ci = c_im[3 * i + j];
+#pragma omp simd
+        for (int l = 0; l < W; l++) cr[l] = ci[l] = 0.0;
+        for (int k = 0; k < 3; k++) {
+          const int ia = dagger_a ? 3 * k + i : 3 * i + k;
+          const int ib = dagger_b ? 3 * j + k : 3 * k + j;
+          const Float *ar = a.re[ia], *ai = a.im[ia], *br = b.re[ib], *bi = b.im[ib];
+#pragma omp simd
+          for (int l = 0; l < W; l++) {
+            cr[l] += ar[l] * br[l] - (sa * sb) * ai[l] * bi[l];
+            ci[l] += sb * ar[l] * bi[l] + sa * ai[l] * br[l];
+          }
+        }
+      }
+    }
+
+    for (int k = 0; k < 9; k++) {
+#pragma omp simd
+      for (int l = 0; l < W; l++) {
+        r.re[k][l] = accumulate ? r.re[k][l] + coeff * c_re[k][l] : c_re[k][l];
+        r.im[k][l] = accumulate ? r.im[k][l] + coeff * c_im[k][l] : c_im[k][l];
+      }
+    }
+  }
+
+  /**
+     @brief c = op(a) op(b), e.g., mul<false, true>(c, a, b) sets
+     c = a b^dagger
+   */
+  template <bool dagger_a, bool dagger_b, typename Float, int W>
+  inline void mul(SU3Batch<Float, W> &c, const SU3Batch<Float, W> &a, const SU3Batch<Float, W> &b)
+  {
+    mulBatch<dagger_a, dagger_b, false>(c, a, b, static_cast<Float>(1.0));
+  }
+
+  /**
+     @brief c += coeff op(a) op(b), as when summing staples
+   */
+  template <bool dagger_a, bool dagger_b, typename Float, int W>
+  inline void mulAdd(SU3Batch<Float, W> &c, const SU3Batch<Float, W> &a, const SU3Batch<Float, W> &b, Float coeff)
+  {
+    mulBatch<dagger_a, dagger_b, true>(c, a, b, coeff);
+  }
+
+  /**
+     @brief c = a^dagger
+   */
+  template <typename Float, int W> inline void adjoint(SU3Batch<Float, W> &c, const SU3Batch<Float, W> &a)
+  {
+    for (int i = 0; i < 3; i++) {
+      for (int j = i; j < 3; j++) {
+        const int ij = 3 * i + j, ji = 3 * j + i;
+#pragma omp simd
+        for (int l = 0; l < W; l++) {
+          const Float re_ij = a.re[ij][l], im_ij = a.im[ij][l];
+          c.re[ij][l] = a.re[ji][l];
+          c.im[ij][l] = -a.im[ji][l];
+          c.re[ji][l] = re_ij;
+          c.im[ji][l] = -im_ij;
+        }
+      }
+    }
+  }
+
+  /**
+     @brief c = a + coeff b
+   */
+  template <typename Float, int W>
+  inline void axpy(SU3Batch<Float, W> &c, const SU3Batch<Float, W> &a, Float coeff, const SU3Batch<Float, W> &b)
+  {
+    for (int k = 0; k < 9; k++) {
+#pragma omp simd
+      for (int l = 0; l < W; l++) {
+        c.re[k][l] = a.re[k][l] + coeff * b.re[k][l];
+        c.im[k][l] = a.im[k][l] + coeff * b.im[k][l];
+      }
+    }
+  }
+
+  /**
+     @brief The traces of the matrices of a batch
+     @param[out] tr_re Real parts of the traces
+     @param[out] tr_im Imaginary parts of the traces
+   */
+  template <typename Float, int W> inline void trace(Float tr_re[W], Float tr_im[W], const SU3Batch<Float, W> &a)
+  {
+#pragma omp simd
+    for (int l = 0; l < W; l++) {
+      tr_re[l] = a.re[0][l] + a.re[4][l] + a.re[8][l];
+      tr_im[l] = a.im[0][l] + a.im[4][l] + a.im[8][l];
+    }
+  }
+
+  /**
+     @brief Re Tr(a b^dagger), the building block of plaquettes and
+     actions, without forming the product
+   */
+  template <typename Float, int W>
+  inline void realTraceNA(Float tr[W], const SU3Batch<Float, W> &a, const SU3Batch<Float, W> &b)
+  {
+#pragma omp simd
+    for (int l = 0; l < W; l++) tr[l] = 0.0;
+    for (int k = 0; k < 9; k++) {
+#pragma omp simd
+      for (int l = 0; l < W; l++) tr[l] += a.re[k][l] * b.re[k][l] + a.im[k][l] * b.im[k][l];
+    }
+  }
+
+  /**
+     @brief The determinants of the matrices of a batch
+   */
+  template <typename Float, int W>
+  inline void determinant(Float det_re[W], Float det_im[W], const SU3Batch<Float, W> &a)
+  {
+#pragma omp simd
+    for (int l = 0; l < W; l++) {
+      // cofactors of the first row
+      const Float c0_re = a.re[4][l] * a.re[8][l] - a.im[4][l] * a.im[8][l] - a.re[5][l] * a.re[7][l] + a.im[5][l] * a.im[7][l];
+      const Float c0_im = a.re[4][l] * a.im[8][l] + a.im[4][l] * a.re[8][l] - a.re[5][l] * a.im[7][l] - a.im[5][l] * a.re[7][l];
+      const Float c1_re = a.re[5][l] * a.re[6][l] - a.im[5][l] * a.im[6][l] - a.re[3][l] * a.re[8][l] + a.im[3][l] * a.im[8][l];
+      const Float c1_im = a.re[5][l] * a.im[6][l] + a.im[5][l] * a.re[6][l] - a.re[3][l] * a.im[8][l] - a.im[3][l] * a.re[8][l];
+      const Float c2_re = a.re[3][l] * a.re[7][l] - a.im[3][l] * a.im[7][l] - a.re[4][l] * a.re[6][l] + a.im[4][l] * a.im[6][l];
+      const Float c2_im = a.re[3][l] * a.im[7][l] + a.im[3][l] * a.re[7][l] - a.re[4][l] * a.im[6][l] - a.im[4][l] * a.re[6][l];
+      det_re[l] = a.re[0][l] * c0_re - a.im[0][l] * c0_im + a.re[1][l] * c1_re - a.im[1][l] * c1_im + a.re[2][l] * c2_re
+        - a.im[2][l] * c2_im;
+      det_im[l] = a.re[0][l] * c0_im + a.im[0][l] * c0_re + a.re[1][l] * c1_im + a.im[1][l] * c1_re + a.re[2][l] * c2_im
+        + a.im[2][l] * c2_re;
+    }
+  }
+
+  /**
+     @brief c = a^{-1}, from the cofactors of a
+   */
+  template <typename Float, int W> inline void inverse(SU3Batch<Float, W> &c, const SU3Batch<Float, W> &a)
+  {
+    alignas(64) Float adj_re[9][W];
+    alignas(64) Float adj_im[9][W];
+
+    // adj(a)(j,i) is the cofactor of a(i,j)
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        const int i1 = (i + 1) % 3, i2 = (i + 2) % 3, j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        const int p = 3 * i1 + j1, q = 3 * i2 + j2, r = 3 * i1 + j2, s = 3 * i2 + j1;
+#pragma omp simd
+        for (int l = 0; l < W; l++) {
+          adj_re[3 * j + i][l] = a.re[p][l] * a.re[q][l] - a.im[p][l] * a.im[q][l] - a.re[r][l] * a.re[s][l] + a.im[r][l] * a.im[s][l];
+          adj_im[3 * j + i][l] = a.re[p][l] * a.im[q][l] + a.im[p][l] * a.re[q][l] - a.re[r][l] * a.im[s][l] - a.im[r][l] * a.re[s][l];
+        }
+      }
+    }
+
+    // det = sum_j a(0,j) adj(j,0)
+    alignas(64) Float inv_re[W];
+    alignas(64) Float inv_im[W];
+#pragma omp simd
+    for (int l = 0; l < W; l++) {
+      const Float det_re = a.re[0][l] * adj_re[0][l] - a.im[0][l] * adj_im[0][l] + a.re[1][l] * adj_re[3][l]
+        - a.im[1][l] * adj_im[3][l] + a.re[2][l] * adj_re[6][l] - a.im[2][l] * adj_im[6][l];
+      const Float det_im = a.re[0][l] * adj_im[0][l] + a.im[0][l] * adj_re[0][l] + a.re[1][l] * adj_im[3][l]
+        + a.im[1][l] * adj_re[3][l] + a.re[2][l] * adj_im[6][l] + a.im[2][l] * adj_re[6][l];
+      const Float norm_inv = static_cast<Float>(1.0) / (det_re * det_re + det_im * det_im);
+      inv_re[l] = det_re * norm_inv;
+      inv_im[l] = -det_im * norm_inv;
+    }
+
+    for (int k = 0; k < 9; k++) {
+#pragma omp simd
+      for (int l = 0; l < W; l++) {
+        c.re[k][l] = adj_re[k][l] * inv_re[l] - adj_im[k][l] * inv_im[l];
+        c.im[k][l] = adj_re[k][l] * inv_im[l] + adj_im[k][l] * inv_re[l];
+      }
+    }
+  }
+
+  /**
+     @brief e = exp(iQ) for traceless Hermitian Q, by the
+     Cayley-Hamilton method of Morningstar and Peardon
+     (hep-lat/0311018) as in exponentiate_iQ, as used by STOUT
+     smearing and the gradient flow.  Below a small Tr Q^2 the
+     coefficients f_j are taken from the Taylor series instead, which
+     also covers Q = 0.
+   */
+  template <typename Float, int W> inline void expiQ(SU3Batch<Float, W> &e, const SU3Batch<Float, W> &Q)
+  {
+    SU3Batch<Float, W> Q2;
+    mul<false, false>(Q2, Q, Q);
+
+    alignas(64) Float c0[W], c1[W];
+    alignas(64) Float tr_im[W];
+    determinant(c0, tr_im, Q);
+    trace(c1, tr_im, Q2);
+
+    // coefficients of exp(iQ) = f0 I + f1 Q + f2 Q^2
+    alignas(64) Float f0_re[W], f0_im[W], f1_re[W], f1_im[W], f2_re[W], f2_im[W];
+    const Float small = std::pow(std::numeric_limits<Float>::epsilon(), static_cast<Float>(0.4));
+    constexpr Float inv3 = 1.0 / 3.0;
+
+#pragma omp simd
+    for (int l = 0; l < W; l++) {
+      const Float c1_l = static_cast<Float>(0.5) * c1[l];
+      const bool negative = c0[l] < 0;
+      const Float c0_l = negative ? -c0[l] : c0[l];
+
+      // [17], [23]-[25], guarding the ratio against rounding and Q = 0
+      const Float c0_max = 2 * std::pow(c1_l * inv3, static_cast<Float>(1.5));
+      Float ratio = c0_max > 0 ? c0_l / c0_max : 0;
+      ratio = ratio > 1 ? 1 : ratio;
+      const Float theta = std::acos(ratio);
+      const Float u = std::sqrt(c1_l * inv3) * std::cos(theta * inv3);
+      const Float w = std::sqrt(c1_l) * std::sin(theta * inv3);
+
+      const Float u_sq = u * u;
+      const Float w_sq = w * w;
+      const Float exp_iu_re = std::cos(u);
+      const Float exp_iu_im = std::sin(u);
+      const Float exp_2iu_re = exp_iu_re * exp_iu_re - exp_iu_im * exp_iu_im;
+      const Float exp_2iu_im = 2 * exp_iu_re * exp_iu_im;
+      const Float cos_w = std::cos(w);
+      const Float sinc_w = (w < static_cast<Float>(0.05) && w > static_cast<Float>(-0.05)) ?
+        1 - (w_sq / 6) * (1 - (w_sq * static_cast<Float>(0.05)) * (1 - (w_sq / 42) * (1 - (w_sq / 72)))) :
+        std::sin(w) / w;
+
+      const bool series = c1_l < small;
+      const Float denom_inv = series ? 0 : 1 / (9 * u_sq - w_sq);
+
+      // [30]-[32]
+      Float h0_re = (u_sq - w_sq) * exp_2iu_re + 8 * u_sq * cos_w * exp_iu_re + 2 * u * (3 * u_sq + w_sq) * sinc_w * exp_iu_im;
+      Float h0_im = (u_sq - w_sq) * exp_2iu_im - 8 * u_sq * cos_w * exp_iu_im + 2 * u * (3 * u_sq + w_sq) * sinc_w * exp_iu_re;
+      Float h1_re = 2 * u * exp_2iu_re - 2 * u * cos_w * exp_iu_re + (3 * u_sq - w_sq) * sinc_w * exp_iu_im;
+      Float h1_im = 2 * u * exp_2iu_im + 2 * u * cos_w * exp_iu_im + (3 * u_sq - w_sq) * sinc_w * exp_iu_re;
+      Float h2_re = exp_2iu_re - cos_w * exp_iu_re - 3 * u * sinc_w * exp_iu_im;
+      Float h2_im = exp_2iu_im + cos_w * exp_iu_im - 3 * u * sinc_w * exp_iu_re;
+
+      // [34] fj(-c0,c1) = (-1)^j fj^*(c0,c1)
+      f0_re[l] = h0_re * denom_inv;
+      f0_im[l] = (negative ? -h0_im : h0_im) * denom_inv;
+      f1_re[l] = (negative ? -h1_re : h1_re) * denom_inv;
+      f1_im[l] = h1_im * denom_inv;
+      f2_re[l] = h2_re * denom_inv;
+      f2_im[l] = (negative ? -h2_im : h2_im) * denom_inv;
+
+      // exp(iQ) = 1 + iQ - Q^2/2 - iQ^3/6 + Q^4/24, with Q^3 = c1 Q + c0
+      if (series) {
+        f0_re[l] = 1;
+        f0_im[l] = -c0[l] / 6;
+        f1_re[l] = c0[l] / 24;
+        f1_im[l] = 1 - c1_l / 6;
+        f2_re[l] = -static_cast<Float>(0.5) + c1_l / 24;
+        f2_im[l] = 0;
+      }
+    }
+
+    for (int k = 0; k < 9; k++) {
+      const bool diagonal = (k % 4 == 0);
+#pragma omp simd
+      for (int l = 0; l < W; l++) {
+        const Float q_re = Q.re[k][l], q_im = Q.im[k][l], q2_re = Q2.re[k][l], q2_im = Q2.im[k][l];
+        e.re[k][l] = (diagonal ? f0_re[l] : 0) + f1_re[l] * q_re - f1_im[l] * q_im + f2_re[l] * q2_re - f2_im[l] * q2_im;
+        e.im[k][l] = (diagonal ? f0_im[l] : 0) + f1_re[l] * q_im + f1_im[l] * q_re + f2_re[l] * q2_im + f2_im[l] * q2_re;
+      }
+    }
+  }
+
+  /**
+     @brief e = exp(a) for traceless anti-Hermitian a, such as the
+     momentum in the gauge update (cf. expsu3), via exp(iQ) with
+     Q = -i a
+   */
+  template <typename Float, int W> inline void expAntiHerm(SU3Batch<Float, W> &e, const SU3Batch<Float, W> &a)
+  {
+    SU3Batch<Float, W> Q;
+    for (int k = 0; k < 9; k++) {
+#pragma omp simd
+      for (int l = 0; l < W; l++) {
+        Q.re[k][l] = a.im[k][l];
+        Q.im[k][l] = -a.re[k][l];
+      }
+    }
+    expiQ(e, Q);
+  }
+
+  /**
+     @brief Reunitarize a batch in place by Gram-Schmidt: the first
+     row is normalized, the second orthogonalized against it and
+     normalized, and the third row is reconstructed as the conjugate
+     of their cross product (as in the reconstruct-12 format), so the
+     result is in SU(3).
+   */
+  template <typename Float, int W> inline void reunitarize(SU3Batch<Float, W> &u)
+  {
+#pragma omp simd
+    for (int l = 0; l < W; l++) {
+      Float n0 = 0;
+      for (int j = 0; j < 3; j++) n0 += u.re[j][l] * u.re[j][l] + u.im[j][l] * u.im[j][l];
+      n0 = 1 / std::sqrt(n0);
+      for (int j = 0; j < 3; j++) {
+        u.re[j][l] *= n0;
+        u.im[j][l] *= n0;
+      }
+
+      // row1 -= (row0^dagger . row1) row0
+      Float p_re = 0, p_im = 0;
+      for (int j = 0; j < 3; j++) {
+        p_re += u.re[j][l] * u.re[3 + j][l] + u.im[j][l] * u.im[3 + j][l];
+        p_im += u.re[j][l] * u.im[3 + j][l] - u.im[j][l] * u.re[3 + j][l];
+      }
+      Float n1 = 0;
+      for (int j = 0; j < 3; j++) {
+        u.re[3 + j][l] -= p_re * u.re[j][l] - p_im * u.im[j][l];
+        u.im[3 + j][l] -= p_re * u.im[j][l] + p_im * u.re[j][l];
+        n1 += u.re[3 + j][l] * u.re[3 + j][l] + u.im[3 + j][l] * u.im[3 + j][l];
+      }
+      n1 = 1 / std::sqrt(n1);
+      for (int j = 0; j < 3; j++) {
+        u.re[3 + j][l] *= n1;
+        u.im[3 + j][l] *= n1;
+      }
+
+      // row2 = conj(row0 x row1)
+      for (int j = 0; j < 3; j++) {
+        const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        u.re[6 + j][l] = u.re[j1][l] * u.re[3 + j2][l] - u.im[j1][l] * u.im[3 + j2][l] - u.re[j2][l] * u.re[3 + j1][l]
+          + u.im[j2][l] * u.im[3 + j1][l];
+        u.im[6 + j][l] = -(u.re[j1][l] * u.im[3 + j2][l] + u.im[j1][l] * u.re[3 + j2][l] - u.re[j2][l] * u.im[3 + j1][l]
+                           - u.im[j2][l] * u.re[3 + j1][l]);
+      }
+    }
+  }
+
+  /**
+     @brief Project a batch onto SU(3) in place, as polarSu3: the
+     unitary factor of the polar decomposition is found by the Newton
+     iteration u -> (u + u^{-dagger}) / 2, until every lane is unitary
+     to the tolerance tol, and the phase of the determinant is then
+     divided out.
+     @param[in,out] u The batch projected
+     @param[in] tol Tolerance on the unitarity of every lane
+     @param[in] max_iter Maximum number of iterations
+     @return The number of iterations taken
+   */
+  template <typename Float, int W> inline int polarProject(SU3Batch<Float, W> &u, Float tol, int max_iter = 100)
+  {
+    SU3Batch<Float, W> inv;
+    inverse(inv, u);
+
+    int iter = 0;
+    Float deviation;
+    do {
+      // u = (u + inv^dagger) / 2
+      for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+          const int ij = 3 * i + j, ji = 3 * j + i;
+#pragma omp simd
+          for (int l = 0; l < W; l++) {
+            u.re[ij][l] = static_cast<Float>(0.5) * (u.re[ij][l] + inv.re[ji][l]);
+            u.im[ij][l] = static_cast<Float>(0.5) * (u.im[ij][l] - inv.im[ji][l]);
+          }
+        }
+      }
+      inverse(inv, u);
+
+      // the largest deviation of u^{-1} from u^dagger
+      deviation = 0;
+      for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+          const int ij = 3 * i + j, ji = 3 * j + i;
+#pragma omp simd reduction(max : deviation)
+          for (int l = 0; l < W; l++) {
+            const Float d = std::fmax(std::fabs(u.re[ij][l] - inv.re[ji][l]), std::fabs(u.im[ij][l] + inv.im[ji][l]));
+            deviation = d > deviation ? d : deviation;
+          }
+        }
+      }
+    } while (!(deviation <= tol) && ++iter < max_iter);
+
+    // divide out the phase of the determinant
+    alignas(64) Float det_re[W], det_im[W];
+    determinant(det_re, det_im, u);
+    alignas(64) Float c_re[W], c_im[W];
+#pragma omp simd
+    for (int l = 0; l < W; l++) {
+      const Float mod = std::pow(det_re[l] * det_re[l] + det_im[l] * det_im[l], static_cast<Float>(-1.0 / 6.0));
+      const Float angle = std::atan2(det_im[l], det_re[l]);
+      c_re[l] = mod * std::cos(angle / -3);
+      c_im[l] = mod * std::sin(angle / -3);
+    }
+    for (int k = 0; k < 9; k++) {
+#pragma omp simd
+      for (int l = 0; l < W; l++) {
+        const Float re = u.re[k][l], im = u.im[k][l];
+        u.re[k][l] = c_re[l] * re - c_im[l] * im;
+        u.im[k][l] = c_re[l] * im + c_im[l] * re;
+      }
+    }
+
+    return iter;
+  }
+
+} // namespace quda
@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+   @file tiered_vector_store.h
+
+   @brief Two-tier storage for large vector sets such as deflation
+   spaces and chronological bases.  The first n_resident vectors are
+   kept as fields at the resident location (normally the device),
+   while the remainder are spilled to host memory, optionally at a
+   lower precision.  Operations over the set stream the spilled
+   vectors back a block at a time, prefetching the next block while
+   the current one is being used, so the size of the set is bounded by
+   host rather than device memory.
+ */
+
+#include <functional>
+#include <future>
+#include <vector>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+
+namespace quda
+{
+
+  class TieredVectorStore
+  {
+    ColorSpinorParam param;       // parameters of the resident vectors
+    int n_max;                    // capacity of the store
+    int n_resident;               // vectors kept at the resident location
+    QudaPrecision spill_precision; // precision of the spilled vectors
+    int block_size;               // spilled vectors staged per block
+    int size;                     // number of vectors held
+
+    std::vector<ColorSpinorField *> resident;
+    bool own_resident;
+
+    std::vector<char *> spilled; // host images of the spilled vectors
+    size_t spill_bytes;          // bytes per spilled image (including the norm)
+    size_t spill_norm_offset;    // offset of the norm in each image
+
+    std::vector<ColorSpinorField *> stage[2];       // staging blocks at the resident precision
+    std::vector<ColorSpinorField *> spill_stage[2]; // staging blocks at the spill precision
+    std::future<void> host_copy[2];                 // host side prefetch of each staging block
+    cudaStream_t copy_stream;                       // device side prefetch stream
+    cudaEvent_t copy_event[2];                      // completion of each device side prefetch
+
+    void init();
+    ColorSpinorField &residentField(int i);
+    char *spillImage(int i);
+    void spill(char *image, const ColorSpinorField &v);
+    void prefetch(int buffer, int first, int n);
+    std::vector<ColorSpinorField *> &wait(int buffer, int n);
+
+  public:
+    /**
+       @brief Create an empty store whose vectors are created on demand
+       @param[in] param Parameters of the resident vectors
+       @param[in] n_max Capacity of the store
+       @param[in] n_resident Number of vectors kept at the resident location
+       @param[in] spill_precision Precision of the spilled vectors
+       @param[in] block_size Number of spilled vectors staged at a time
+     */
+    TieredVectorStore(const ColorSpinorParam &param, int n_max, int n_resident, QudaPrecision spill_precision,
+                      int block_size = 8);
+
+    /**
+       @brief Create an empty store around existing fields, which form
+       the resident tier and are not owned by the store
+       @param[in] resident The resident fields
+       @param[in] n_max Capacity of the store
+       @param[in] spill_precision Precision of the spilled vectors
+       @param[in] block_size Number of spilled vectors staged at a time
+     */
+    TieredVectorStore(const std::vector<ColorSpinorField *> &resident, int n_max, QudaPrecision spill_precision,
+                      int block_size = 8);
+
+    virtual ~TieredVectorStore();
+
+    /** @return Number of vectors held */
+    int Size() const { return size; }
+
+    /** @return Capacity of the store */
+    int Capacity() const { return n_max; }
+
+    /** @return Number of vectors held at the resident location */
+    int NumResident() const { return std::min(size, n_resident); }
+
+    /** @return Whether every vector is held at the resident location */
+    bool AllResident() const { return size <= n_resident; }
+
+    /** @return The resident vectors, in order */
+    std::vector<ColorSpinorField *> Resident() const
+    {
+      return std::vector<ColorSpinorField *>(resident.begin(), resident.begin() + NumResident());
+    }
+
+    /** @return The parameters of the resident vectors */
+    const ColorSpinorParam &Param() const { return param; }
+
+    /**
+       @brief Set vector i, extending the store if i is its size
+       @param[in] i Index of the vector
+       @param[in] v The new value
+     */
+    void set(int i, const ColorSpinorField &v);
+
+    /**
+       @brief Copy out vector i
+       @param[out] v The value of vector i
+       @param[in] i Index of the vector
+     */
+    void get(ColorSpinorField &v, int i);
+
+    /**
+       @brief Insert a vector at the front, moving every other vector
+       back by one and dropping the last if the store is full
+       @param[in] v The vector to insert
+     */
+    void pushFront(const ColorSpinorField &v);
+
+    /** @brief Remove every vector */
+    void clear() { size = 0; }
+
+    /**
+       @brief Apply a function to the first n vectors a block at a
+       time.  The resident vectors form the first block, and spilled
+       vectors are staged at the resident location and precision, with
+       the next block prefetched while f runs.  The staged fields must
+       not be modified.
+       @param[in] f Function called with the block and the index of its first vector
+       @param[in] n Number of vectors (-1 for all)
+     */
+    void apply(const std::function<void(std::vector<ColorSpinorField *> &, int)> &f, int n = -1);
+
+    /**
+       @brief Compute result[i*y.size() + j] = <v_i, y_j> for the first n vectors
+       @param[out] result The inner products
+       @param[in] y The vectors to project
+       @param[in] n Number of vectors (-1 for all)
+     */
+    void cDotProduct(Complex *result, std::vector<ColorSpinorField *> &y, int n = -1);
+
+    /**
+       @brief Compute result[i*y.Size() + j] = <v_i, y_j> between two stores
+       @param[out] result The inner products
+       @param[in] y The other store, which may be this one
+       @param[in] n Number of vectors of this store (-1 for all)
+     */
+    void cDotProduct(Complex *result, TieredVectorStore &y, int n = -1);
+
+    /**
+       @brief Compute y_j += sum_i a[i*y.size() + j] v_i over the first n vectors
+       @param[in] a The coefficients
+       @param[in,out] y The vectors to update
+       @param[in] n Number of vectors (-1 for all)
+     */
+    void caxpy(const Complex *a, std::vector<ColorSpinorField *> &y, int n = -1);
+
+    /** @return Bytes of host memory held by spilled vectors */
+    size_t SpilledBytes() const { return spilled.size() * spill_bytes; }
+  };
+
+} // namespace quda
@@ -61,6 +61,14 @@ namespace quda {
    */
   const std::map<TuneKey, TuneParam> &getTuneCache();
 
+  /**
+   * @brief The number of threads available to host (CPU field)
+   * kernels, e.g., the OpenMP thread limit, or one if QUDA was built
+   * without OpenMP.
+   * @return Maximum number of host threads
+   */
+  int hostMaxThreads();
+
   class Tunable {
 
   protected:
@@ -262,6 +270,66 @@ namespace quda {
 
     virtual bool advanceAux(TuneParam &param) const { return false; }
 
+    /**
+       @brief Whether this instance launches on the host.  Host
+       launches are executed by the host execution layer
+       (host_parallel.h), which reinterprets the launch parameters:
+       block.x is the number of threads and grid.x is the chunk size
+       of a dynamic schedule, with zero denoting a static partition.
+       @return True if this is a host launch
+    */
+    virtual bool hostLaunch() const { return false; }
+
+    /**
+       @brief The largest chunk size tried when tuning a host launch
+    */
+    virtual unsigned int maxHostChunk() const { return 1024; }
+
+    /**
+       @brief Initial host launch: a single thread with a static
+       partition
+    */
+    void initHostTuneParam(TuneParam &param) const
+    {
+      param.block = dim3(1, 1, 1);
+      param.grid = dim3(0, 1, 1);
+      param.shared_bytes = 0;
+    }
+
+    /**
+       @brief Default host launch when tuning is disabled: all
+       available threads with a static partition
+    */
+    void defaultHostTuneParam(TuneParam &param) const
+    {
+      initHostTuneParam(param);
+      param.block.x = hostMaxThreads();
+    }
+
+    /**
+       @brief Advance the host launch parameters.  For each thread
+       count (doubling up to hostMaxThreads()) we try the static
+       partition followed by dynamic scheduling with chunk sizes
+       1, 4, 16, ... up to maxHostChunk().
+       @return False once the search space is exhausted
+    */
+    bool advanceHostTuneParam(TuneParam &param) const
+    {
+      if (param.grid.x < maxHostChunk()) {
+        param.grid.x = param.grid.x ? 4 * param.grid.x : 1;
+        return true;
+      }
+      param.grid.x = 0;
+
+      const unsigned int max_threads = hostMaxThreads();
+      if (param.block.x < max_threads) {
+        param.block.x = std::min(2 * param.block.x, max_threads);
+        return true;
+      }
+      param.block.x = 1;
+      return false;
+    }
+
     char aux[TuneKey::aux_n];
 
     int writeAuxString(const char *format, ...) {
@@ -302,7 +370,14 @@ namespace quda {
     virtual std::string paramString(const TuneParam &param) const
       {
 	std::stringstream ps;
-	ps << param;
+	if (hostLaunch()) {
+	  ps << "threads=" << param.block.x << ", schedule=";
+	  if (param.grid.x) ps << "dynamic,chunk=" << param.grid.x;
+	  else ps << "static";
+	  ps << ", aux=(" << param.aux.x << "," << param.aux.y << "," << param.aux.z << "," << param.aux.w << ")";
+	} else {
+	  ps << param;
+	}
 	return ps.str();
       }
 
@@ -318,6 +393,11 @@ namespace quda {
 
     virtual void initTuneParam(TuneParam &param) const
     {
+      if (hostLaunch()) {
+        initHostTuneParam(param);
+        return;
+      }
+
       const unsigned int max_threads = deviceProp.maxThreadsDim[0];
       const unsigned int max_blocks = deviceProp.maxGridSize[0];
       const int min_grid_size = minGridSize();
@@ -343,12 +423,18 @@ namespace quda {
     /** sets default values for when tuning is disabled */
     virtual void defaultTuneParam(TuneParam &param) const
     {
+      if (hostLaunch()) {
+        defaultHostTuneParam(param);
+        return;
+      }
+
       initTuneParam(param);
       if (tuneGridDim()) param.grid = dim3(maxGridSize(), 1, 1);
     }
 
     virtual bool advanceTuneParam(TuneParam &param) const
     {
+      if (hostLaunch()) return advanceHostTuneParam(param);
       return advanceSharedBytes(param) || advanceBlockDim(param) || advanceGridDim(param) || advanceAux(param);
     }
 
@@ -358,6 +444,12 @@ namespace quda {
      */
     void checkLaunchParam(TuneParam &param) {
 
+      if (hostLaunch()) {
+        if (param.block.x < 1 || param.block.x > (unsigned)hostMaxThreads())
+          errorQuda("Requested host thread count %d outside of range [1,%d]", param.block.x, hostMaxThreads());
+        return;
+      }
+
       if (param.block.x*param.block.y*param.block.z > (unsigned)deviceProp.maxThreadsPerBlock)
         errorQuda("Requested block size %dx%dx%d=%d greater than hardware limit %d",
                   param.block.x, param.block.y, param.block.z, param.block.x*param.block.y*param.block.z, deviceProp.maxThreadsPerBlock);
@@ -35,8 +35,14 @@ namespace quda {
 
   void unitarizeLinksCPU(cpuGaugeField& outfield, const cpuGaugeField &infield);
 
-  void unitarizeLinks(cudaGaugeField& outfield, const cudaGaugeField &infield, int *fails);
-  void unitarizeLinks(cudaGaugeField& outfield, int *fails);
+  /**
+   * @brief Unitarize the links of a device field, or of a host field
+   * in QDP or MILC order without reconstruction.  The number of links
+   * that fail the unitarity check is added to fails, a device pointer
+   * for device fields and a host pointer for host fields.
+   */
+  void unitarizeLinks(GaugeField& outfield, const GaugeField &infield, int *fails);
+  void unitarizeLinks(GaugeField& outfield, int *fails);
   
   bool isUnitary(const cpuGaugeField& field, double max_error);
 
@@ -53,9 +53,9 @@ bool getRankVerbosity();
 char *getPrintBuffer();
 
 /**
-   @brief Returns a string of the form
-   ",omp_threads=$OMP_NUM_THREADS", which can be used for storing the
-   number of OMP threads for CPU functions recorded in the tune cache.
+   @brief Returns a string of the form ",omp_threads=N", where N is
+   the number of host threads available (see hostMaxThreads), which
+   can be used for keying CPU functions recorded in the tune cache.
    @return Returns the string
 */
 char* getOmpThreadStr();
@@ -0,0 +1,134 @@
+#pragma once
+
+/**
+   @file vector_compression.h
+
+   @brief Compressed storage of eigenvector and null-space sets that
+   exploits local coherence: low modes which are orthogonal on the
+   whole lattice are close to linearly dependent when restricted to a
+   small block.  The lattice is partitioned into blocks, split by
+   chirality as for the multigrid aggregates, and the first n_basis
+   vectors are orthonormalized within each aggregate and kept at full
+   precision.  Every vector is then stored as its coefficients in the
+   aggregate bases.  The coefficients are quantized in groups, each
+   with its own scale and with the narrowest storage (dropped, 8-bit,
+   16-bit, float or double) that keeps the quantization error of the
+   vector within the requested tolerance.
+ */
+
+#include <string>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+
+namespace quda
+{
+
+  struct VectorCompressionParam {
+    int block_size[4]; /** Local dimensions of the blocks */
+    int n_basis;       /** Number of basis vectors per aggregate (0 disables compression) */
+    double tol;        /** Target relative quantization error of every vector */
+
+    VectorCompressionParam();
+    VectorCompressionParam(const QudaEigParam &param);
+    VectorCompressionParam(const QudaMultigridParam &param, int level);
+  };
+
+  class CompressedVectorStore
+  {
+    static constexpr int group_size = 16; // coefficients per quantization group
+
+    struct Coefficients {
+      std::vector<unsigned char> bits; // storage width of each group
+      std::vector<float> scale;        // scale of each group
+      std::vector<char> data;          // the quantized groups
+    };
+
+    VectorCompressionParam param;
+
+    int X[4];                  // local lattice dimensions of the full lattice
+    int Ls;                    // fifth dimension, each slice is blocked separately
+    QudaSiteSubset site_subset;
+    int nColor;
+    int nSpin;
+    QudaPrecision precision;   // precision of the basis and of the reconstructed vectors
+
+    int n_chiral;              // chiral aggregates per block
+    int chiral_length;         // complex numbers per site and chirality
+    int n_block;               // number of blocks
+    int block_volume;          // sites per block
+    int agg_length;            // complex numbers per aggregate
+    int n_agg;                 // number of aggregates
+    int n_group_agg;           // quantization groups per aggregate
+
+    std::vector<int> block_sites; // the sites of each block, block by block
+    std::vector<char> basis;      // basis vectors [agg][k][agg_length] at precision
+    std::vector<Coefficients> coeff;
+
+    double max_proj_res;       // largest relative residual of the projection onto the bases
+    size_t group_count[5];     // number of groups stored at each width
+
+    void setGeometry(const int *X, int Ls, QudaSiteSubset site_subset, int nColor, int nSpin, QudaPrecision precision);
+    void checkGeometry(const ColorSpinorField &v) const;
+    ColorSpinorField *hostField(const ColorSpinorField &v) const;
+
+    template <typename Float> void addBasis(const Float *v, int k);
+    template <typename Float> void project(const Float *v, int n_k, Coefficients &c);
+    template <typename Float> void expand(const Coefficients &c, Float *v) const;
+
+  public:
+    /**
+       @brief Create an empty store
+       @param[in] param Compression parameters
+     */
+    CompressedVectorStore(const VectorCompressionParam &param);
+
+    /**
+       @brief Compress a set of vectors, the first n_basis of which
+       define the aggregate bases.  Device fields are staged through
+       host memory one vector at a time.
+       @param[in] v The vectors to compress
+     */
+    void compress(const std::vector<ColorSpinorField *> &v);
+
+    /**
+       @brief Reconstruct the stored vectors
+       @param[out] v The reconstructed vectors, of which there must be
+       at most Nvec()
+     */
+    void reconstruct(std::vector<ColorSpinorField *> &v) const;
+
+    /**
+       @brief Write the store to disk, one file per process
+       @param[in] file The file name prefix
+     */
+    void save(const std::string &file) const;
+
+    /**
+       @brief Read a store from disk, replacing the contents of this one
+       @param[in] file The file name prefix
+     */
+    void load(const std::string &file);
+
+    /**
+       @return Whether the file was written by a CompressedVectorStore
+       @param[in] file The file name prefix
+     */
+    static bool isCompressed(const std::string &file);
+
+    /** @return The number of stored vectors */
+    int Nvec() const { return coeff.size(); }
+
+    /** @return The local storage size of the store in bytes */
+    size_t Bytes() const;
+
+    /** @return The local storage size of the uncompressed vectors in bytes */
+    size_t VectorBytes() const;
+
+    /** @return The largest relative residual of a vector projected onto the bases */
+    double ProjectionResidual() const { return max_proj_res; }
+  };
+
+} // namespace quda
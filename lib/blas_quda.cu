@@ -306,6 +306,8 @@ namespace quda {
         } else {
           errorQuda("Not implemented");
         }
+        blas::bytes += Functor<double2, double2>::streams() * x.Bytes();
+        blas::flops += Functor<double2, double2>::flops() * x.Length();
       }
     }
 
@@ -460,6 +462,9 @@ namespace quda {
         } else {
           errorQuda("Not implemented");
         }
+        // the factor two here assumes we are reading and writing to the high precision vector
+        blas::bytes += (Functor<double2, double2>::streams() - 2) * x.Bytes() + 2 * y.Bytes();
+        blas::flops += Functor<double2, double2>::flops() * x.Length();
       }
     }
 
@@ -598,8 +603,17 @@ namespace quda {
 		     ColorSpinorField &y, ColorSpinorField &z) {
       if (!commAsyncReduction())
 	errorQuda("This kernel requires asynchronous reductions to be set");
-      if (x.Location() == QUDA_CPU_FIELD_LOCATION)
-	errorQuda("This kernel cannot be run on CPU fields");
+
+      if (x.Location() == QUDA_CPU_FIELD_LOCATION) {
+        // host reductions are synchronous, so the preceding
+        // cDotProductNormA result is already in the host reduce buffer
+        // and we can form the coefficient here rather than in the kernel
+        double3 Ar3 = static_cast<double3 *>(getHostReduceBuffer())[0];
+        Complex alpha = a * Complex(Ar3.x, Ar3.y) / Ar3.z;
+        uni_blas<caxpyxmaz_, 1, 1>(
+            make_double2(REAL(alpha), IMAG(alpha)), make_double2(0.0, 0.0), make_double2(0.0, 0.0), x, y, z, x, y);
+        return;
+      }
 
       uni_blas<caxpyxmazMR_, 1, 1>(
           make_double2(REAL(a), IMAG(a)), make_double2(0.0, 0.0), make_double2(0.0, 0.0), x, y, z, x, y);
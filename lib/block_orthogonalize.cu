@@ -97,10 +97,10 @@ namespace quda {
        orthogonalization.
      */
     template <typename Rotator, typename Vector, std::size_t... S>
-    void CPU(const std::vector<ColorSpinorField*> &B, std::index_sequence<S...>) {
+    void CPU(const TuneParam &tp, const std::vector<ColorSpinorField*> &B, std::index_sequence<S...>) {
       typedef BlockOrthoArg<Rotator,Vector,nSpin,spinBlockSize,coarseSpin,nVec> Arg;
       Arg arg(V, fine_to_coarse, coarse_to_fine, QUDA_INVALID_PARITY, geo_bs, n_block_ortho, V, B[S]...);
-      blockOrthoCPU<sumType,RegType,nSpin,spinBlockSize,nColor,coarseSpin,nVec,Arg>(arg);
+      blockOrthoCPU<sumType,RegType,nSpin,spinBlockSize,nColor,coarseSpin,nVec,Arg>(arg, tp);
     }
 
     /**
@@ -133,7 +133,7 @@ namespace quda {
 	if (V.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER && B[0]->FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
 	  typedef FieldOrderCB<RegType,nSpin,nColor,nVec,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER,vFloat,vFloat,DISABLE_GHOST> Rotator;
 	  typedef FieldOrderCB<RegType,nSpin,nColor,1,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER,bFloat,bFloat,DISABLE_GHOST> Vector;
-	  CPU<Rotator,Vector>(B, std::make_index_sequence<nVec>());
+	  CPU<Rotator,Vector>(tp, B, std::make_index_sequence<nVec>());
 	} else {
 	  errorQuda("Unsupported field order %d\n", V.FieldOrder());
 	}
@@ -167,20 +167,29 @@ namespace quda {
 #endif
     }
 
+    bool hostLaunch() const { return V.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     bool advanceTuneParam(TuneParam &param) const {
       if (V.Location() == QUDA_CUDA_FIELD_LOCATION) {
 	return advanceSharedBytes(param) || advanceAux(param);
       } else {
-	return false;
+	return advanceHostTuneParam(param);
       }
     }
 
     TuneKey tuneKey() const { return TuneKey(V.VolString(), typeid(*this).name(), aux); }
 
-    void initTuneParam(TuneParam &param) const { defaultTuneParam(param); }
+    void initTuneParam(TuneParam &param) const {
+      if (hostLaunch()) initHostTuneParam(param);
+      else defaultTuneParam(param);
+    }
 
     /** sets default values for when tuning is disabled */
     void defaultTuneParam(TuneParam &param) const {
+      if (hostLaunch()) {
+        defaultHostTuneParam(param);
+        return;
+      }
       param.block = dim3(geoBlockSize/2, V.SiteSubset(), 1);
       param.grid = dim3((minThreads() + param.block.x - 1) / param.block.x, 1, coarseSpin);
       param.shared_bytes = 0;
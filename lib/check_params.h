@@ -127,6 +127,14 @@ void printQudaGaugeParam(QudaGaugeParam *param) {
   P(return_result_mom, INVALID_INT);
 #endif
 
+#if defined INIT_PARAM
+  P(compute_location, QUDA_CUDA_FIELD_LOCATION);
+#elif defined CHECK_PARAM
+  if (param->compute_location == QUDA_INVALID_FIELD_LOCATION) param->compute_location = QUDA_CUDA_FIELD_LOCATION;
+#else
+  P(compute_location, QUDA_INVALID_FIELD_LOCATION);
+#endif
+
 #ifdef INIT_PARAM
   return ret;
 #endif
@@ -149,6 +157,8 @@ void printQudaEigParam(QudaEigParam *param) {
   P(poly_deg, 0);
   P(a_min, 0.0);
   P(a_max, 0.0);
+  P(poly_acc_auto, QUDA_BOOLEAN_NO);
+  P(poly_acc_rate, 1e-2);
   P(use_dagger, QUDA_BOOLEAN_NO);
   P(use_norm_op, QUDA_BOOLEAN_NO);
   P(compute_svd, QUDA_BOOLEAN_NO);
@@ -160,17 +170,21 @@ void printQudaEigParam(QudaEigParam *param) {
   P(tol, 0.0);
   P(check_interval, 0);
   P(max_restarts, 0);
+  P(block_size, 1);
   P(arpack_check, QUDA_BOOLEAN_NO);
   P(nk, 0);
   P(np, 0);
   P(eig_type, QUDA_EIG_TR_LANCZOS);
   P(extlib_type, QUDA_EIGEN_EXTLIB);
   P(mem_type_ritz, QUDA_MEMORY_DEVICE);
+  P(ritz_resident_dim, 0);
 #else
   P(use_poly_acc, QUDA_BOOLEAN_INVALID);
   P(poly_deg, INVALID_INT);
   P(a_min, INVALID_DOUBLE);
   P(a_max, INVALID_DOUBLE);
+  P(poly_acc_auto, QUDA_BOOLEAN_INVALID);
+  P(poly_acc_rate, INVALID_DOUBLE);
   P(use_dagger, QUDA_BOOLEAN_INVALID);
   P(use_norm_op, QUDA_BOOLEAN_INVALID);
   P(compute_svd, QUDA_BOOLEAN_INVALID);
@@ -181,6 +195,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(tol, INVALID_DOUBLE);
   P(check_interval, INVALID_INT);
   P(max_restarts, INVALID_INT);
+  P(block_size, INVALID_INT);
   P(arpack_check, QUDA_BOOLEAN_INVALID);
   P(nk, INVALID_INT);
   P(np, INVALID_INT);
@@ -189,12 +204,26 @@ void printQudaEigParam(QudaEigParam *param) {
   P(eig_type, QUDA_EIG_INVALID);
   P(extlib_type, QUDA_EXTLIB_INVALID);
   P(mem_type_ritz, QUDA_MEMORY_INVALID);
+  P(ritz_resident_dim, INVALID_INT);
+#endif
+
+#if !defined CHECK_PARAM
+  P(ritz_spill_precision, QUDA_INVALID_PRECISION);
+#else
+  // default the spill precision to the Ritz vector precision
+  if (param->ritz_spill_precision == QUDA_INVALID_PRECISION) param->ritz_spill_precision = param->cuda_prec_ritz;
 #endif
 
 #if defined INIT_PARAM
   P(location, QUDA_CUDA_FIELD_LOCATION);
+  P(vec_compress_n_basis, 0);
+  for (int d = 0; d < 4; d++) P(vec_compress_block_size[d], 4);
+  P(vec_compress_tol, 1e-3);
 #else
   P(location, QUDA_INVALID_FIELD_LOCATION);
+  P(vec_compress_n_basis, INVALID_INT);
+  for (int d = 0; d < 4; d++) P(vec_compress_block_size[d], INVALID_INT);
+  P(vec_compress_tol, INVALID_DOUBLE);
 #endif
 
 #ifdef INIT_PARAM
@@ -330,6 +359,12 @@ void printQudaInvertParam(QudaInvertParam *param) {
   if (param->reliable_delta_refinement == INVALID_DOUBLE) param->reliable_delta_refinement = param->reliable_delta;
 #endif
 
+#if defined INIT_PARAM
+  P(batched_refinement, 1); /**< Default is to refine the shifts together */
+#else
+  P(batched_refinement, INVALID_INT);
+#endif
+
 #ifdef INIT_PARAM
   P(use_alternative_reliable, 0); /**< Default is to not use alternative relative updates, e.g., use delta to determine reliable trigger */
   P(use_sloppy_partial_accumulator, 0); /**< Default is to use a high-precision accumulator (not yet supported in all solvers) */
@@ -562,19 +597,37 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(chrono_replace_last, 0);
   P(chrono_max_dim, 0);
   P(chrono_index, 0);
+  P(chrono_resident_dim, 0);
 #else
   P(chrono_use_resident, INVALID_INT);
   P(chrono_make_resident, INVALID_INT);
   P(chrono_replace_last, INVALID_INT);
   P(chrono_max_dim, INVALID_INT);
   P(chrono_index, INVALID_INT);
+  P(chrono_resident_dim, INVALID_INT);
 #endif
 
 #if !defined CHECK_PARAM
   P(chrono_precision, QUDA_INVALID_PRECISION);
+  P(chrono_spill_precision, QUDA_INVALID_PRECISION);
 #else
   // default the chrono precision to using outer precision
   if (param->chrono_precision == QUDA_INVALID_PRECISION) param->chrono_precision = param->cuda_prec;
+  // default the spill precision to the chrono precision
+  if (param->chrono_spill_precision == QUDA_INVALID_PRECISION) param->chrono_spill_precision = param->chrono_precision;
+#endif
+
+#if !defined CHECK_PARAM
+  P(cuda_prec_recycle, QUDA_INVALID_PRECISION);
+#else
+  // default the recycled subspace to the sloppy precision it is used at
+  if (param->cuda_prec_recycle == QUDA_INVALID_PRECISION) param->cuda_prec_recycle = param->cuda_prec_sloppy;
+#endif
+
+#if defined INIT_PARAM
+  P(recycle_keep_on_update, 1);
+#else
+  P(recycle_keep_on_update, INVALID_INT);
 #endif
 
 #if defined INIT_PARAM
@@ -795,6 +848,16 @@ void printQudaMultigridParam(QudaMultigridParam *param) {
 #endif
   }
 
+  for (int i = 0; i < n_level - 1; i++) {
+#ifdef INIT_PARAM
+    P(vec_compress_n_basis[i], 0);
+    P(vec_compress_tol[i], 1e-3);
+#else
+    P(vec_compress_n_basis[i], INVALID_INT);
+    P(vec_compress_tol[i], INVALID_DOUBLE);
+#endif
+  }
+
 #ifdef INIT_PARAM
   P(gflops, 0.0);
   P(secs, 0.0);
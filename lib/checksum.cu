@@ -1,5 +1,6 @@
 #include <gauge_field_order.h>
 #include <cub_helper.cuh>
+#include <host_parallel.h>
 
 namespace quda {
 
@@ -22,12 +23,14 @@ namespace quda {
   template <typename Arg>
   uint64_t ChecksumCPU(const Arg &arg)
   {
-    uint64_t checksum_ = 0;
-    for (int parity=0; parity<2; parity++)
-      for (int x_cb=0; x_cb<arg.volumeCB; x_cb++)
-	for (int d=0; d<arg.U.geometry; d++)
-	  checksum_ ^= siteChecksum(arg, d, parity, x_cb);
-    return checksum_;
+    // xor is associative and commutative so the result is independent of the partitioning
+    return parallel_reduce(hostDefaultParam(), 2, arg.volumeCB, uint64_t(0),
+                           [&](int parity, int x_cb) {
+                             uint64_t checksum_ = 0;
+                             for (int d=0; d<arg.U.geometry; d++) checksum_ ^= siteChecksum(arg, d, parity, x_cb);
+                             return checksum_;
+                           },
+                           [](uint64_t a, uint64_t b) { return a ^ b; });
   }
 
   template <typename T, int Nc>
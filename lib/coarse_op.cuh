@@ -201,15 +201,15 @@ namespace quda {
 	if (type == COMPUTE_UV) {
 
 	  if (dir == QUDA_BACKWARDS) {
-	    if      (dim==0) ComputeUVCPU<from_coarse,Float,0,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==1) ComputeUVCPU<from_coarse,Float,1,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==2) ComputeUVCPU<from_coarse,Float,2,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==3) ComputeUVCPU<from_coarse,Float,3,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
+	    if      (dim==0) ComputeUVCPU<from_coarse,Float,0,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==1) ComputeUVCPU<from_coarse,Float,1,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==2) ComputeUVCPU<from_coarse,Float,2,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==3) ComputeUVCPU<from_coarse,Float,3,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
 	  } else if (dir == QUDA_FORWARDS) {
-	    if      (dim==0) ComputeUVCPU<from_coarse,Float,0,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==1) ComputeUVCPU<from_coarse,Float,1,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==2) ComputeUVCPU<from_coarse,Float,2,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==3) ComputeUVCPU<from_coarse,Float,3,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
+	    if      (dim==0) ComputeUVCPU<from_coarse,Float,0,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==1) ComputeUVCPU<from_coarse,Float,1,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==2) ComputeUVCPU<from_coarse,Float,2,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==3) ComputeUVCPU<from_coarse,Float,3,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
 	  } else {
 	    errorQuda("Undefined direction %d", dir);
 	  }
@@ -218,7 +218,7 @@ namespace quda {
 
 	  if (from_coarse) errorQuda("ComputeAV should only be called from the fine grid");
 #if defined(GPU_CLOVER_DIRAC) && !defined(COARSECOARSE)
-          ComputeAVCPU<Float,fineSpin,fineColor,coarseColor>(arg);
+          ComputeAVCPU<Float,fineSpin,fineColor,coarseColor>(arg, tp);
 #else
           errorQuda("Clover dslash has not been built");
 #endif
@@ -227,7 +227,7 @@ namespace quda {
 
 	  if (from_coarse) errorQuda("ComputeTMAV should only be called from the fine grid");
 #if defined(GPU_TWISTED_MASS_DIRAC) && !defined(COARSECOARSE)
-          ComputeTMAVCPU<Float,fineSpin,fineColor,coarseColor>(arg);
+          ComputeTMAVCPU<Float,fineSpin,fineColor,coarseColor>(arg, tp);
 #else
           errorQuda("Twisted mass dslash has not been built");
 #endif
@@ -236,7 +236,7 @@ namespace quda {
 
 	  if (from_coarse) errorQuda("ComputeTMCAV should only be called from the fine grid");
 #if defined(GPU_TWISTED_CLOVER_DIRAC) && !defined(COARSECOARSE)
-          ComputeTMCAVCPU<Float,fineSpin,fineColor,coarseColor>(arg);
+          ComputeTMCAVCPU<Float,fineSpin,fineColor,coarseColor>(arg, tp);
 #else
           errorQuda("Twisted clover dslash has not been built");
 #endif
@@ -245,7 +245,7 @@ namespace quda {
 
 	  if (from_coarse) errorQuda("ComputeInvCloverMax should only be called from the fine grid");
 #if defined(DYNAMIC_CLOVER) && !defined(COARSECOARSE)
-          ComputeCloverInvMaxCPU<Float, false>(arg);
+          ComputeCloverInvMaxCPU<Float, false>(arg, tp);
 #else
           errorQuda("ComputeInvCloverMax only enabled with dynamic clover");
 #endif
@@ -254,7 +254,7 @@ namespace quda {
 
           if (from_coarse) errorQuda("ComputeInvCloverMax should only be called from the fine grid");
 #if defined(DYNAMIC_CLOVER) && !defined(COARSECOARSE)
-          ComputeCloverInvMaxCPU<Float, true>(arg);
+          ComputeCloverInvMaxCPU<Float, true>(arg, tp);
 #else
 	  errorQuda("ComputeInvCloverMax only enabled with dynamic clover");
 #endif
@@ -264,44 +264,44 @@ namespace quda {
           arg.dim_index = 4*(dir==QUDA_BACKWARDS ? 0 : 1) + dim;
 
           if (dir == QUDA_BACKWARDS) {
-	    if      (dim==0) ComputeVUVCPU<from_coarse,Float,0,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==1) ComputeVUVCPU<from_coarse,Float,1,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==2) ComputeVUVCPU<from_coarse,Float,2,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==3) ComputeVUVCPU<from_coarse,Float,3,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
+	    if      (dim==0) ComputeVUVCPU<from_coarse,Float,0,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==1) ComputeVUVCPU<from_coarse,Float,1,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==2) ComputeVUVCPU<from_coarse,Float,2,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==3) ComputeVUVCPU<from_coarse,Float,3,QUDA_BACKWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
 	  } else if (dir == QUDA_FORWARDS) {
-	    if      (dim==0) ComputeVUVCPU<from_coarse,Float,0,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==1) ComputeVUVCPU<from_coarse,Float,1,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==2) ComputeVUVCPU<from_coarse,Float,2,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
-	    else if (dim==3) ComputeVUVCPU<from_coarse,Float,3,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg);
+	    if      (dim==0) ComputeVUVCPU<from_coarse,Float,0,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==1) ComputeVUVCPU<from_coarse,Float,1,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==2) ComputeVUVCPU<from_coarse,Float,2,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
+	    else if (dim==3) ComputeVUVCPU<from_coarse,Float,3,QUDA_FORWARDS,fineSpin,fineColor,coarseSpin,coarseColor>(arg, tp);
 	  } else {
 	    errorQuda("Undefined direction %d", dir);
 	  }
 
         } else if (type == COMPUTE_COARSE_CLOVER) {
 
-          ComputeCoarseCloverCPU<from_coarse,Float,fineSpin,coarseSpin,fineColor,coarseColor>(arg);
+          ComputeCoarseCloverCPU<from_coarse,Float,fineSpin,coarseSpin,fineColor,coarseColor>(arg, tp);
 
         } else if (type == COMPUTE_REVERSE_Y) {
 
-          ComputeYReverseCPU<Float,coarseSpin,coarseColor>(arg);
+          ComputeYReverseCPU<Float,coarseSpin,coarseColor>(arg, tp);
 
         } else if (type == COMPUTE_DIAGONAL) {
 
-          AddCoarseDiagonalCPU<Float,coarseSpin,coarseColor>(arg);
+          AddCoarseDiagonalCPU<Float,coarseSpin,coarseColor>(arg, tp);
 
         } else if (type == COMPUTE_TMDIAGONAL) {
 
-          AddCoarseTmDiagonalCPU<Float,coarseSpin,coarseColor>(arg);
+          AddCoarseTmDiagonalCPU<Float,coarseSpin,coarseColor>(arg, tp);
 
         } else if (type == COMPUTE_CONVERT) {
 
           arg.dim_index = 4*(dir==QUDA_BACKWARDS ? 0 : 1) + dim;
-	  ConvertCPU<Float,coarseSpin,coarseColor>(arg);
+	  ConvertCPU<Float,coarseSpin,coarseColor>(arg, tp);
 
         } else if (type == COMPUTE_RESCALE) {
 
           arg.dim_index = 4*(dir==QUDA_BACKWARDS ? 0 : 1) + dim;
-	  RescaleYCPU<Float,coarseSpin,coarseColor>(arg);
+	  RescaleYCPU<Float,coarseSpin,coarseColor>(arg, tp);
 
         } else {
           errorQuda("Undefined compute type %d", type);
@@ -692,9 +692,12 @@ namespace quda {
       return ( (!arg.shared_atomic && !from_coarse && type == COMPUTE_VUV) || type == COMPUTE_COARSE_CLOVER) ? false : Tunable::advanceSharedBytes(param);
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     bool advanceTuneParam(TuneParam &param) const {
-      // only do autotuning if we have device fields
-      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION && Y.MemType() == QUDA_MEMORY_DEVICE) return Tunable::advanceTuneParam(param);
+      // only do autotuning if we have device fields or are running on the host
+      if (hostLaunch() || (meta.Location() == QUDA_CUDA_FIELD_LOCATION && Y.MemType() == QUDA_MEMORY_DEVICE))
+        return Tunable::advanceTuneParam(param);
       else return false;
     }
 
@@ -55,9 +55,9 @@ namespace quda {
       if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
 
         if (compute_max_only)
-          CalculateYhatCPU<Float, n, true, Arg>(arg);
+          CalculateYhatCPU<Float, n, true, Arg>(arg, tp);
         else
-          CalculateYhatCPU<Float, n, false, Arg>(arg);
+          CalculateYhatCPU<Float, n, false, Arg>(arg, tp);
 
       } else {
         if (compute_max_only) {
@@ -95,8 +95,11 @@ namespace quda {
     // no locality in this kernel so no point in shared-memory tuning
     bool advanceSharedBytes(TuneParam &param) const { return false; }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     bool advanceTuneParam(TuneParam &param) const {
-      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION && meta.MemType() == QUDA_MEMORY_DEVICE) return Tunable::advanceTuneParam(param);
+      if (hostLaunch() || (meta.Location() == QUDA_CUDA_FIELD_LOCATION && meta.MemType() == QUDA_MEMORY_DEVICE))
+        return Tunable::advanceTuneParam(param);
       else return false;
     }
 
@@ -11,6 +11,7 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
 #include <tune_quda.h>
+#include <host_parallel.h>
 #include <utility> // for std::swap
 
 #define PRESERVE_SPINOR_NORM
@@ -120,18 +121,16 @@ namespace quda {
 
   /** CPU function to reorder spinor fields.  */
   template <typename FloatOut, typename FloatIn, int Ns, int Nc, typename Arg, typename Basis>
-  void copyColorSpinor(Arg &arg, const Basis &basis) {
+  void copyColorSpinor(Arg &arg, const Basis &basis, const TuneParam &tp) {
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
-    for (int parity = 0; parity<arg.nParity; parity++) {
-      for (int x=0; x<arg.volumeCB; x++) {
+    parallel_for(tp, arg.nParity, arg.volumeCB, [&](int parity, int x) {
 	ColorSpinor<RegTypeIn, Nc, Ns> in = arg.in(x, (parity+arg.inParity)&1);
 	ColorSpinor<RegTypeOut, Nc, Ns> out;
 	basis(out.data, in.data);
 	arg.out(x, (parity+arg.outParity)&1) = out;
-      }
-    }
+      });
   }
 
   /** CUDA kernel to reorder spinor fields.  Adopts a similar form as the CPU version, using the same inlined functions. */
@@ -169,19 +168,21 @@ namespace quda {
       : TunableVectorY(arg.nParity), arg(arg), meta(in), location(location) {
       if (out.GammaBasis()!=in.GammaBasis()) errorQuda("Cannot change gamma basis for nSpin=%d\n", Ns);
       writeAuxString("out_stride=%d,in_stride=%d", arg.out.stride, arg.in.stride);
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
     }
     virtual ~CopyColorSpinor() { ; }
   
     void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (location == QUDA_CPU_FIELD_LOCATION) {
-	copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, PreserveBasis<Ns,Nc>());
+	copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, PreserveBasis<Ns,Nc>(), tp);
       } else {
-	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 	copyColorSpinorKernel<FloatOut, FloatIn, Ns, Nc>
 	  <<<tp.grid, tp.block, tp.shared_bytes, stream>>> (arg, PreserveBasis<Ns,Nc>());
       }
     }
 
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
     TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
     long long flops() const { return 0; } 
     long long bytes() const { return arg.in.Bytes() + arg.out.Bytes(); }
@@ -220,24 +221,25 @@ namespace quda {
       } else {
 	errorQuda("Basis change from %d to %d not supported", in.GammaBasis(), out.GammaBasis());
       }
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
     }
     virtual ~CopyColorSpinor() { ; }
 
     void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (location == QUDA_CPU_FIELD_LOCATION) {
 	if (out.GammaBasis()==in.GammaBasis()) {
-	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, PreserveBasis<Ns,Nc>());
+	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, PreserveBasis<Ns,Nc>(), tp);
 	} else if (out.GammaBasis() == QUDA_UKQCD_GAMMA_BASIS && in.GammaBasis() == QUDA_DEGRAND_ROSSI_GAMMA_BASIS) {
-	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, NonRelBasis<Ns,Nc>());
+	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, NonRelBasis<Ns,Nc>(), tp);
 	} else if (in.GammaBasis() == QUDA_UKQCD_GAMMA_BASIS && out.GammaBasis() == QUDA_DEGRAND_ROSSI_GAMMA_BASIS) {
-	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, RelBasis<Ns,Nc>());
+	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, RelBasis<Ns,Nc>(), tp);
 	} else if (out.GammaBasis() == QUDA_UKQCD_GAMMA_BASIS && in.GammaBasis() == QUDA_CHIRAL_GAMMA_BASIS) {
-	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, ChiralToNonRelBasis<Ns,Nc>());
+	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, ChiralToNonRelBasis<Ns,Nc>(), tp);
 	} else if (in.GammaBasis() == QUDA_UKQCD_GAMMA_BASIS && out.GammaBasis() == QUDA_CHIRAL_GAMMA_BASIS) {
-	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, NonRelToChiralBasis<Ns,Nc>());
+	  copyColorSpinor<FloatOut, FloatIn, Ns, Nc>(arg, NonRelToChiralBasis<Ns,Nc>(), tp);
 	}
       } else {
-	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 	if (out.GammaBasis()==in.GammaBasis()) {
 	  copyColorSpinorKernel<FloatOut, FloatIn, Ns, Nc>
 	    <<<tp.grid, tp.block, tp.shared_bytes, stream>>> (arg, PreserveBasis<Ns,Nc>());
@@ -257,6 +259,7 @@ namespace quda {
       }
     }
 
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
     TuneKey tuneKey() const { return TuneKey(in.VolString(), typeid(*this).name(), aux); }
     long long flops() const { return 0; }
     long long bytes() const { return arg.in.Bytes() + arg.out.Bytes(); }
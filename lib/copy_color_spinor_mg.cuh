@@ -11,6 +11,7 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
 #include <tune_quda.h>
+#include <host_parallel.h>
 #include <utility> // for std::swap
 
 namespace quda {
@@ -19,14 +20,14 @@ namespace quda {
 
   /** CPU function to reorder spinor fields.  */
   template <typename FloatOut, typename FloatIn, int Ns, int Nc, typename OutOrder, typename InOrder>
-    void packSpinor(OutOrder &outOrder, const InOrder &inOrder, int volume) {
-    for (int x=0; x<volume; x++) {
+    void packSpinor(OutOrder &outOrder, const InOrder &inOrder, int volume, const TuneParam &tp) {
+    parallel_for(tp, 1, volume, [&](int, int x) {
       for (int s=0; s<Ns; s++) {
 	for (int c=0; c<Nc; c++) {
 	  outOrder(0, x, s, c) = inOrder(0, x, s, c);
 	}
       }
-    }
+    });
   }
 
   /** CUDA kernel to reorder spinor fields.  Adopts a similar form as the CPU version, using the same inlined functions. */
@@ -59,21 +60,25 @@ namespace quda {
 
   public:
     CopySpinor(OutOrder &out, const InOrder &in, const ColorSpinorField &meta, QudaFieldLocation location)
-      : out(out), in(in), meta(meta), location(location) { }
+      : out(out), in(in), meta(meta), location(location) {
+      strcpy(aux, meta.AuxString());
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
+    }
     virtual ~CopySpinor() { ; }
 
     void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (location == QUDA_CPU_FIELD_LOCATION) {
-	packSpinor<FloatOut, FloatIn, Ns, Nc>(out, in, meta.VolumeCB());
+	packSpinor<FloatOut, FloatIn, Ns, Nc>(out, in, meta.VolumeCB(), tp);
       } else {
-	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 	packSpinorKernel<FloatOut, FloatIn, Ns, Nc, OutOrder, InOrder>
 	  <<<tp.grid, tp.block, tp.shared_bytes, stream>>>
 	  (out, in, meta.VolumeCB());
       }
     }
 
-    TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), meta.AuxString()); }
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
+    TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
 
     long long flops() const { return 0; }
     long long bytes() const { return in.Bytes() + out.Bytes(); }
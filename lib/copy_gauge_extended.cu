@@ -1,5 +1,6 @@
 #include <tune_quda.h>
 #include <gauge_field_order.h>
+#include <host_parallel.h>
 
 namespace quda {
 
@@ -90,12 +91,10 @@ namespace quda {
   }
 
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder, bool regularToextended>
-  void copyGaugeEx(CopyGaugeExArg<OutOrder,InOrder> arg) {
-    for (int parity=0; parity<2; parity++) {
-      for(int X=0; X<arg.volume/2; X++){
-  copyGaugeEx<FloatOut, FloatIn, length, OutOrder, InOrder, regularToextended>(arg, X, parity);
-      }
-    }
+  void copyGaugeEx(CopyGaugeExArg<OutOrder,InOrder> arg, const TuneParam &tp) {
+    parallel_for(tp, 2, arg.volume/2, [&](int parity, int X) {
+      copyGaugeEx<FloatOut, FloatIn, length, OutOrder, InOrder, regularToextended>(arg, X, parity);
+    });
   }
 
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder, bool regularToextended>
@@ -119,11 +118,13 @@ namespace quda {
 
     bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
     unsigned int minThreads() const { return arg.volume/2; }
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
 
   public:
     CopyGaugeEx(CopyGaugeExArg<OutOrder,InOrder> &arg, const GaugeField &meta, QudaFieldLocation location)
       : arg(arg), meta(meta), location(location) {
       writeAuxString("out_stride=%d,in_stride=%d,geometry=%d",arg.out.stride,arg.in.stride,arg.geometry);
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
     }
     virtual ~CopyGaugeEx() { ; }
 
@@ -131,8 +132,8 @@ namespace quda {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 
       if (location == QUDA_CPU_FIELD_LOCATION) {
-	if(arg.regularToextended) copyGaugeEx<FloatOut, FloatIn, length, OutOrder, InOrder, true>(arg);
-	else copyGaugeEx<FloatOut, FloatIn, length, OutOrder, InOrder, false>(arg);
+	if(arg.regularToextended) copyGaugeEx<FloatOut, FloatIn, length, OutOrder, InOrder, true>(arg, tp);
+	else copyGaugeEx<FloatOut, FloatIn, length, OutOrder, InOrder, false>(arg, tp);
       } else if (location == QUDA_CUDA_FIELD_LOCATION) {
 	if(arg.regularToextended) copyGaugeExKernel<FloatOut, FloatIn, length, OutOrder, InOrder, true>
 				    <<<tp.grid, tp.block, tp.shared_bytes, stream>>>(arg);
@@ -372,4 +373,24 @@ namespace quda {
 
   }
 
+  GaugeField *extendGaugeField(const GaugeField &in, const int *R)
+  {
+    if (in.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED) errorQuda("Gauge field is already extended");
+
+    GaugeFieldParam param(in);
+    for (int d = 0; d < 4; d++) {
+      param.x[d] = in.X()[d] + 2 * R[d];
+      param.r[d] = R[d];
+    }
+    param.pad = 0;
+    param.nFace = 1;
+    param.ghostExchange = QUDA_GHOST_EXCHANGE_EXTENDED;
+    param.create = QUDA_NULL_FIELD_CREATE;
+
+    GaugeField *out = GaugeField::Create(param);
+    copyExtendedGauge(*out, in, in.Location());
+    out->exchangeExtendedGhost(R, false);
+    return out;
+  }
+
 } // namespace quda
@@ -22,10 +22,7 @@ namespace quda {
     bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
     unsigned int minThreads() const { return size; }
 
-    bool advanceTuneParam(TuneParam &param) const {
-      // only do autotuning if we are doing the copy on the GPU
-      return location == QUDA_CUDA_FIELD_LOCATION ? TunableVectorYZ::advanceTuneParam(param) : false;
-    }
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
 
 public:
     CopyGauge(Arg &arg, const GaugeField &out, const GaugeField &in, QudaFieldLocation location)
@@ -47,6 +44,7 @@ public:
 #ifdef FINE_GRAINED_ACCESS
       strcat(aux,",fine-grained");
 #endif
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
 
 #ifdef JITIFY
 #ifdef FINE_GRAINED_ACCESS
@@ -83,9 +81,9 @@ public:
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (location == QUDA_CPU_FIELD_LOCATION) {
         if (!is_ghost) {
-          copyGauge<FloatOut, FloatIn, length>(arg);
+          copyGauge<FloatOut, FloatIn, length>(arg, tp);
         } else {
-          copyGhost<FloatOut, FloatIn, length>(arg);
+          copyGhost<FloatOut, FloatIn, length>(arg, tp);
         }
       } else if (location == QUDA_CUDA_FIELD_LOCATION) {
 #ifdef JITIFY
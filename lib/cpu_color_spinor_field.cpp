@@ -4,6 +4,7 @@
 #include <iostream>
 #include <typeinfo>
 #include <color_spinor_field.h>
+#include <site_order.h>
 #include <comm_quda.h> // for comm_drand()
 
 namespace quda {
@@ -143,6 +144,11 @@ namespace quda {
       errorQuda("Field order %d not supported", fieldOrder);
     }
 
+    if (isReorderedSiteOrder(siteOrder) && fieldOrder != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER
+        && fieldOrder != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      errorQuda("Site order %d not supported for field order %d", siteOrder, fieldOrder);
+    }
+
     if (create != QUDA_REFERENCE_FIELD_CREATE) {
       // array of 4-d fields
       if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) {
@@ -201,7 +207,9 @@ namespace quda {
 
   void cpuColorSpinorField::copy(const cpuColorSpinorField &src) {
     checkField(*this, src);
-    if (fieldOrder == src.fieldOrder && bytes == src.Bytes()) {
+    if (siteOrder != src.siteOrder && (isReorderedSiteOrder(siteOrder) || isReorderedSiteOrder(src.siteOrder))) {
+      reorderSites(*this, src);
+    } else if (fieldOrder == src.fieldOrder && bytes == src.Bytes()) {
       if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) 
         for (int i=0; i<x[nDim-1]; i++) memcpy(((void**)v)[i], ((void**)src.v)[i], bytes/x[nDim-1]);
       else 
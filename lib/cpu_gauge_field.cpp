@@ -1,5 +1,6 @@
 #include <quda_internal.h>
 #include <gauge_field.h>
+#include <site_order.h>
 #include <assert.h>
 #include <string.h>
 #include <typeinfo>
@@ -24,6 +25,11 @@ namespace quda {
     if (reconstruct == QUDA_RECONSTRUCT_10 && order != QUDA_MILC_GAUGE_ORDER && order != QUDA_MILC_SITE_GAUGE_ORDER) {
       errorQuda("10-reconstruction only supported with MILC gauge order");
     }
+    if (siteOrder != QUDA_EVEN_ODD_SITE_ORDER) {
+      if (!isReorderedSiteOrder(siteOrder)) errorQuda("Site order %d not supported", siteOrder);
+      if (order != QUDA_QDP_GAUGE_ORDER && order != QUDA_MILC_GAUGE_ORDER)
+        errorQuda("Site order %d only supported for QDP and MILC gauge order", siteOrder);
+    }
 
     int siteDim=0;
     if (geometry == QUDA_SCALAR_GEOMETRY) siteDim = 1;
@@ -136,6 +142,7 @@ namespace quda {
   void cpuGaugeField::exchangeGhost(QudaLinkDirection link_direction) {
     if (geometry != QUDA_VECTOR_GEOMETRY && geometry != QUDA_COARSE_GEOMETRY)
       errorQuda("Cannot exchange for %d geometry gauge field", geometry);
+    if (siteOrder != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Ghost exchange not supported for site order %d", siteOrder);
 
     if ( (link_direction == QUDA_LINK_BIDIRECTIONAL || link_direction == QUDA_LINK_FORWARDS) && geometry != QUDA_COARSE_GEOMETRY)
       errorQuda("Cannot request exchange of forward links on non-coarse geometry");
@@ -169,6 +176,7 @@ namespace quda {
   void cpuGaugeField::injectGhost(QudaLinkDirection link_direction) {
     if (geometry != QUDA_VECTOR_GEOMETRY && geometry != QUDA_COARSE_GEOMETRY)
       errorQuda("Cannot exchange for %d geometry gauge field", geometry);
+    if (siteOrder != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Ghost exchange not supported for site order %d", siteOrder);
 
     if (link_direction != QUDA_LINK_BACKWARDS)
       errorQuda("link_direction = %d not supported", link_direction);
@@ -186,7 +194,8 @@ namespace quda {
   }
 
   void cpuGaugeField::exchangeExtendedGhost(const int *R, bool no_comms_fill) {
-    
+    if (siteOrder != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Ghost exchange not supported for site order %d", siteOrder);
+
     void *send[QUDA_MAX_DIM];
     void *recv[QUDA_MAX_DIM];
     size_t bytes[QUDA_MAX_DIM];
@@ -271,6 +280,13 @@ namespace quda {
       fat_link_max = 1.0;
     }
 
+    if (siteOrder != src.SiteOrder()) {
+      if (typeid(src) != typeid(cpuGaugeField))
+        errorQuda("Cannot copy into site order %d, copy into an even-odd host field and reorder", siteOrder);
+      reorderSites(*this, src);
+      return;
+    }
+
     if (typeid(src) == typeid(cudaGaugeField)) {
 
       if (reorder_location() == QUDA_CPU_FIELD_LOCATION) {
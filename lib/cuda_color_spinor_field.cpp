@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include <color_spinor_field.h>
+#include <site_order.h>
 #include <blas_quda.h>
 #include <dslash_quda.h>
 
@@ -163,6 +164,8 @@ namespace quda {
 
   void cudaColorSpinorField::create(const QudaFieldCreate create) {
 
+    if (isReorderedSiteOrder(siteOrder)) errorQuda("Site order %d only supported for host fields", siteOrder);
+
     if (siteSubset == QUDA_FULL_SITE_SUBSET && siteOrder != QUDA_EVEN_ODD_SITE_ORDER) {
       errorQuda("Subset not implemented");
     }
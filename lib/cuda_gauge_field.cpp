@@ -8,6 +8,8 @@ namespace quda {
   cudaGaugeField::cudaGaugeField(const GaugeFieldParam &param) :
     GaugeField(param), gauge(0), even(0), odd(0)
   {
+    if (siteOrder != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Site order %d only supported for host fields", siteOrder);
+
     if ((order == QUDA_QDP_GAUGE_ORDER || order == QUDA_QDPJIT_GAUGE_ORDER) &&
         create != QUDA_REFERENCE_FIELD_CREATE) {
       errorQuda("QDP ordering only supported for reference fields");
@@ -631,6 +633,8 @@ namespace quda {
     if (this == &src) return;
 
     checkField(src);
+    if (src.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+      errorQuda("Cannot copy from site order %d, reorder the host field to even-odd first", src.SiteOrder());
 
     if (link_type == QUDA_ASQTAD_FAT_LINKS) {
       fat_link_max = src.LinkMax();
@@ -749,6 +753,8 @@ namespace quda {
   void cudaGaugeField::saveCPUField(cpuGaugeField &cpu) const
   {
     static_cast<LatticeField&>(cpu).checkField(*this);
+    if (cpu.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+      errorQuda("Cannot save to site order %d, save to an even-odd host field and reorder", cpu.SiteOrder());
 
     if (reorder_location() == QUDA_CUDA_FIELD_LOCATION) {
 
@@ -1,4 +1,5 @@
 #include <deflation.h>
+#include <eigensolve_quda.h>
 #include <qio_field.h>
 #include <string.h>
 
@@ -20,18 +21,25 @@ namespace quda
   static auto pinned_allocator = [] (size_t bytes ) { return static_cast<Complex*>(pool_pinned_malloc(bytes)); };
   static auto pinned_deleter   = [] (Complex *hptr) { pool_pinned_free(hptr); };
 
+  // number of Ritz vectors formed per multiblas call in reduce()
+  static constexpr int rotate_tile = 16;
+
   Deflation::Deflation(DeflationParam &param, TimeProfile &profile) :
     param(param),
     profile(profile),
     r(nullptr),
     Av(nullptr),
     r_sloppy(nullptr),
-    Av_sloppy(nullptr)
+    Av_sloppy(nullptr),
+    rv(nullptr)
   {
+    // vectors beyond the components of RV are spilled to host memory
+    rv = new TieredVectorStore(param.RV->Components(), param.tot_dim, param.eig_global.ritz_spill_precision);
+
     // for reporting level 1 is the fine level but internally use level 0 for indexing
-    printfQuda("Creating deflation space of %d vectors.\n", param.tot_dim);
+    printfQuda("Creating deflation space of %d vectors (%d resident).\n", param.tot_dim, param.RV->CompositeDim());
 
-    if (param.eig_global.import_vectors) loadVectors(param.RV); // whether to load eigenvectors
+    if (param.eig_global.import_vectors) loadVectors(); // whether to load eigenvectors
     // create aux fields
     ColorSpinorParam csParam(param.RV->Component(0));
     csParam.create = QUDA_ZERO_FIELD_CREATE;
@@ -76,6 +84,8 @@ namespace quda
     if (r)  delete r;
     if (Av) delete Av;
 
+    if (rv) delete rv;
+
     if (getVerbosity() >= QUDA_SUMMARIZE) profile.Print();
   }
 
@@ -114,13 +124,12 @@ namespace quda
       errorQuda("Library type %d is currently not supported", param.eig_global.extlib_type);
     }
 
-    std::vector<ColorSpinorField*> rv(param.RV->Components().begin(), param.RV->Components().begin() + param.cur_dim);
     std::vector<ColorSpinorField*> res;
     res.push_back(r);
 
     for (int i = 0; i < nevs_to_print; i++) {
       zero(*r);
-      blas::caxpy(&projm.get()[i * param.ld], rv, res); // multiblas
+      rv->caxpy(&projm.get()[i * param.ld], res, param.cur_dim); // multiblas
       *r_sloppy = *r;
       param.matDeflation(*Av_sloppy, *r_sloppy);
       double3 dotnorm = cDotProductNormA(*r_sloppy, *Av_sloppy);
@@ -148,11 +157,10 @@ namespace quda
     ColorSpinorField *b_sloppy = param.RV->Precision() != b.Precision() ? r_sloppy : &b;
     *b_sloppy = b;
 
-    std::vector<ColorSpinorField*> rv_(param.RV->Components().begin(), param.RV->Components().begin()+param.cur_dim);
     std::vector<ColorSpinorField*> in_;
     in_.push_back(static_cast<ColorSpinorField*>(b_sloppy));
 
-    blas::cDotProduct(vec.get(), rv_, in_);//<i, b>
+    rv->cDotProduct(vec.get(), in_, param.cur_dim);//<i, b>
 
     if (!param.use_inv_ritz) {
       if (param.eig_global.extlib_type == QUDA_MAGMA_EXTLIB) {
@@ -179,7 +187,7 @@ namespace quda
     std::vector<ColorSpinorField*> out_;
     out_.push_back(&x);
 
-    blas::caxpy(vec.get(), rv_, out_); //multiblas
+    rv->caxpy(vec.get(), out_, param.cur_dim); //multiblas
 
     check_nrm2 = norm2(x);
     printfQuda("\nDeflated guess spinor norm (gpu): %1.15e\n", sqrt(check_nrm2));
@@ -195,61 +203,49 @@ namespace quda
 
     const int first_idx = param.cur_dim;
 
-    if (param.RV->CompositeDim() < (first_idx + nev) || param.tot_dim < (first_idx + nev)) {
+    if (rv->Capacity() < (first_idx + nev) || param.tot_dim < (first_idx + nev)) {
       warningQuda("\nNot enough space to add %d vectors. Keep deflation space unchanged.\n", nev);
       return;
     }
 
-    for(int i = 0; i < nev; i++) blas::copy(param.RV->Component(first_idx+i), Vm.Component(i));
-
     printfQuda("\nConstruct projection matrix..\n");
 
-    // Block MGS orthogonalization
-    // The degree to which we interpolate between modified GramSchmidt and GramSchmidt (performance vs stability)
-    const int cdot_pipeline_length  = 4;
+    // Block classical Gram-Schmidt, applied twice for stability: each
+    // pass streams the existing space once, so spilled vectors are
+    // fetched twice per new vector rather than once per pipeline step
+    std::unique_ptr<Complex[]> alpha(new Complex[first_idx + nev]);
+    std::vector<ColorSpinorField *> vi_;
+    vi_.push_back(r);
 
     for (int i = first_idx; i < (first_idx + nev); i++) {
-      std::unique_ptr<Complex[]> alpha(new Complex[i]);
-
-      ColorSpinorField *accum = param.eig_global.cuda_prec_ritz != QUDA_DOUBLE_PRECISION ? r : &param.RV->Component(i);
-      *accum = param.RV->Component(i);
-
-      int offset = 0;
-      while (offset < i) {
-        const int local_length = (i - offset) > cdot_pipeline_length ? cdot_pipeline_length : (i - offset);
-
-        std::vector<ColorSpinorField *> vj_(param.RV->Components().begin() + offset,
-                                            param.RV->Components().begin() + offset + local_length);
-        std::vector<ColorSpinorField *> vi_;
-        vi_.push_back(accum);
+      *r = Vm.Component(i - first_idx);
 
-        blas::cDotProduct(alpha.get(), vj_, vi_);
-        for (int j = 0; j < local_length; j++) alpha[j] = -alpha[j];
-        blas::caxpy(alpha.get(), vj_, vi_); // i-<j,i>j
-
-        offset += cdot_pipeline_length;
+      for (int pass = 0; pass < 2 && i > 0; pass++) {
+        rv->cDotProduct(alpha.get(), vi_, i);
+        for (int j = 0; j < i; j++) alpha[j] = -alpha[j];
+        rv->caxpy(alpha.get(), vi_, i); // i-<j,i>j
       }
 
-      alpha[0] = blas::norm2(*accum);
+      alpha[0] = blas::norm2(*r);
 
       if (alpha[0].real() > 1e-16)
-        blas::ax(1.0 / sqrt(alpha[0].real()), *accum);
+        blas::ax(1.0 / sqrt(alpha[0].real()), *r);
       else
         errorQuda("Cannot orthogonalize %dth vector", i);
 
-      param.RV->Component(i) = *accum;
+      rv->set(i, *r);
 
-      param.matDeflation(*Av_sloppy, param.RV->Component(i)); // precision must match!
+      *r_sloppy = *r;
+      param.matDeflation(*Av_sloppy, *r_sloppy); // precision must match!
       // load diagonal:
       *Av = *Av_sloppy;
-      param.matProj[i * param.ld + i] = cDotProduct(*accum, *Av);
+      param.matProj[i * param.ld + i] = cDotProduct(*r, *Av);
 
       if (i > 0) {
-        std::vector<ColorSpinorField *> vj_(param.RV->Components().begin(), param.RV->Components().begin() + i);
         std::vector<ColorSpinorField *> av_;
         av_.push_back(Av_sloppy);
 
-        blas::cDotProduct(alpha.get(), vj_, av_);
+        rv->cDotProduct(alpha.get(), av_, i);
 
         for (int j = 0; j < i; j++) {
           param.matProj[i * param.ld + j] = alpha[j];
@@ -303,31 +299,43 @@ namespace quda
       }
     }
 
-    ColorSpinorParam csParam(param.RV->Component(0));
-    // Create an eigenvector set:
-    csParam.create = QUDA_ZERO_FIELD_CREATE;
-    // csParam.setPrecision(search_space_prec);//eigCG internal search space precision: must be adjustable.
-    csParam.is_composite = true;
-    csParam.composite_dim = max_nev;
-
-    csParam.mem_type = QUDA_MEMORY_MAPPED;
-    std::unique_ptr<ColorSpinorField> buff(ColorSpinorField::Create(csParam));
+    // the new Ritz vectors are held in host memory until the old ones are no longer needed
+    TieredVectorStore buff(rv->Param(), max_nev, 0, rv->Param().Precision());
+
+    // The Ritz vectors are formed a tile at a time with one multiblas
+    // call per tile, so the search space is read once per tile rather
+    // than once per Ritz vector.  The tile is bounded by the widest
+    // single multiblas kernel, beyond which there is no saving.
+    const int tile = std::min(max_nev, rotate_tile);
+    std::vector<std::unique_ptr<ColorSpinorField>> ritz(tile);
+    std::vector<ColorSpinorField *> ritz_ptr(tile);
+    ColorSpinorParam rParam(*r);
+    rParam.create = QUDA_NULL_FIELD_CREATE;
+    for (int i = 0; i < tile; i++) {
+      ritz[i].reset(ColorSpinorField::Create(rParam));
+      ritz_ptr[i] = ritz[i].get();
+    }
+    std::vector<Complex> rotation(param.cur_dim * tile);
 
     int idx = 0;
     double relerr = 0.0;
     bool do_residual_check = (tol != 0.0);
 
     while ((relerr < tol) && (idx < max_nev)) {
-      std::vector<ColorSpinorField *> rv(param.RV->Components().begin(), param.RV->Components().begin() + param.cur_dim);
-      std::vector<ColorSpinorField *> res;
-      res.push_back(r);
-
-      blas::zero(*r);
-      blas::caxpy(&projm.get()[idx * param.ld], rv, res); // multiblas
-      blas::copy(buff->Component(idx), *r);
+      if (idx % tile == 0) {
+        const int n = std::min(tile, max_nev - idx);
+        std::vector<ColorSpinorField *> res(ritz_ptr.begin(), ritz_ptr.begin() + n);
+        for (int k = 0; k < param.cur_dim; k++)
+          for (int l = 0; l < n; l++) rotation[k * n + l] = projm.get()[(idx + l) * param.ld + k];
+
+        for (auto &v : res) blas::zero(*v);
+        rv->caxpy(rotation.data(), res, param.cur_dim); // multiblas
+      }
+      ColorSpinorField &ritz_vec = *ritz_ptr[idx % tile];
+      buff.set(idx, ritz_vec);
 
       if (do_residual_check) { // if tol=0.0 then disable relative residual norm check
-        *r_sloppy = *r;
+        *r_sloppy = ritz_vec;
         param.matDeflation(*Av_sloppy, *r_sloppy);
         double3 dotnorm = cDotProductNormA(*r_sloppy, *Av_sloppy);
         double eval = dotnorm.x / dotnorm.z;
@@ -341,74 +349,68 @@ namespace quda
 
     printfQuda("\nReserved eigenvectors: %d\n", idx);
     // copy all the stuff to cudaRitzVectors set:
-    for (int i = 0; i < idx; i++) blas::copy(param.RV->Component(i), buff->Component(i));
+    rv->clear();
+    for (int i = 0; i < idx; i++) {
+      buff.get(*ritz_ptr[0], i);
+      rv->set(i, *ritz_ptr[0]);
+    }
 
     // reset current dimension:
     param.cur_dim = idx; // idx never exceeds cur_dim.
     param.tot_dim = idx;
   }
 
-  //supports seperate reading or single file read
-  void Deflation::loadVectors(ColorSpinorField *RV)
+  // the vectors are staged through host fields, since the space may
+  // be larger than its resident part
+  static std::vector<ColorSpinorField *> createHostVectors(const ColorSpinorParam &param, int n)
   {
-    if (RV->IsComposite()) errorQuda("Not a composite field");
+    ColorSpinorParam csParam(param);
+    csParam.location = QUDA_CPU_FIELD_LOCATION;
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    csParam.setPrecision(param.Precision() < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : param.Precision());
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+
+    std::vector<ColorSpinorField *> v;
+    for (int i = 0; i < n; i++) v.push_back(ColorSpinorField::Create(csParam));
+    return v;
+  }
 
+  //supports seperate reading or single file read
+  void Deflation::loadVectors()
+  {
     profile.TPSTOP(QUDA_PROFILE_INIT);
     profile.TPSTART(QUDA_PROFILE_IO);
 
     std::string vec_infile(param.eig_global.vec_infile);
-    std::vector<ColorSpinorField *> &B = RV->Components();
+    if (strcmp(vec_infile.c_str(), "") == 0) errorQuda("No eigenspace file defined");
 
-    const int Nvec = B.size();
-    printfQuda("Start loading %d vectors from %s\n", Nvec, vec_infile.c_str());
+    std::vector<ColorSpinorField *> B = createHostVectors(rv->Param(), rv->Capacity());
+    EigenSolver::loadVectors(B, vec_infile);
 
-    void **V = new void*[Nvec];
-    for (int i = 0; i < Nvec; i++) {
-      V[i] = B[i]->V();
-      if (V[i] == NULL) {
-	printfQuda("Could not allocate V[%d]\n", i);
-      }
-    }
-
-    if (strcmp(vec_infile.c_str(),"")!=0) {
-      read_spinor_field(vec_infile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
-			B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
-    } else {
-      errorQuda("No eigenspace file defined");
+    rv->clear();
+    for (unsigned int i = 0; i < B.size(); i++) {
+      rv->set(i, *B[i]);
+      delete B[i];
     }
 
-    printfQuda("Done loading vectors\n");
     profile.TPSTOP(QUDA_PROFILE_IO);
     profile.TPSTART(QUDA_PROFILE_INIT);
   }
 
-  void Deflation::saveVectors(ColorSpinorField *RV)
+  void Deflation::saveVectors()
   {
-    if (RV->IsComposite()) errorQuda("Not a composite field");
-
     profile.TPSTOP(QUDA_PROFILE_INIT);
     profile.TPSTART(QUDA_PROFILE_IO);
 
     std::string vec_outfile(param.eig_global.vec_outfile);
-    std::vector<ColorSpinorField*> &B = RV->Components();
 
     if (strcmp(param.eig_global.vec_outfile,"")!=0) {
-      const int Nvec = B.size();
-      printfQuda("Start saving %d vectors to %s\n", Nvec, vec_outfile.c_str());
-
-      void **V = static_cast<void**>(safe_malloc(Nvec*sizeof(void*)));
-      for (int i=0; i<Nvec; i++) {
-	V[i] = B[i]->V();
-	if (V[i] == NULL) {
-	  printfQuda("Could not allocate V[%d]\n", i);
-	}
-      }
+      std::vector<ColorSpinorField *> B = createHostVectors(rv->Param(), rv->Size());
+      for (unsigned int i = 0; i < B.size(); i++) rv->get(*B[i], i);
 
-      write_spinor_field(vec_outfile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
-			 B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
+      EigenSolver::saveVectors(B, vec_outfile, VectorCompressionParam(param.eig_global));
 
-      host_free(V);
-      printfQuda("Done saving vectors\n");
+      for (auto b : B) delete b;
     }
 
     profile.TPSTOP(QUDA_PROFILE_IO);
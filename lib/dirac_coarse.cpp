@@ -21,7 +21,8 @@ namespace quda {
       Y_h(Y_h), X_h(X_h), Xinv_h(Xinv_h), Yhat_h(Yhat_h),
       Y_d(Y_d), X_d(X_d), Xinv_d(Xinv_d), Yhat_d(Yhat_d),
       enable_gpu( Y_d ? true : false), enable_cpu(Y_h ? true : false), gpu_setup(true),
-      init_gpu(enable_gpu ? false : true), init_cpu(enable_cpu ? false : true), mapped(Y_d->MemType() == QUDA_MEMORY_MAPPED)
+      init_gpu(enable_gpu ? false : true), init_cpu(enable_cpu ? false : true),
+      mapped(Y_d ? Y_d->MemType() == QUDA_MEMORY_MAPPED : false)
   {
 
   }
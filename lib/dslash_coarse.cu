@@ -142,12 +142,19 @@ namespace quda {
       }
     }
 
+    bool hostLaunch() const { return out.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     virtual void initTuneParam(TuneParam &param) const
     {
       param.aux = make_int4(1,1,1,1);
       color_col_stride = param.aux.x;
       dim_threads = param.aux.y;
 
+      if (hostLaunch()) {
+        initHostTuneParam(param);
+        return;
+      }
+
       TunableVectorY::initTuneParam(param);
       param.block.z = dim_threads * 2;
       param.grid.z = 2*(Nc/Mc);
@@ -162,6 +169,11 @@ namespace quda {
       color_col_stride = param.aux.x;
       dim_threads = param.aux.y;
 
+      if (hostLaunch()) {
+        defaultHostTuneParam(param);
+        return;
+      }
+
       TunableVectorY::defaultTuneParam(param);
       // ensure that the default x block size is divisible by the warpSize
       param.block.x = deviceProp.warpSize;
@@ -189,6 +201,7 @@ namespace quda {
       strcat(aux, compile_type_str(out));
       strcat(aux, out.AuxString());
       strcat(aux, comm_dim_partitioned_string());
+      if (out.Location() == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
 
       // record the location of where each pack buffer is in [2*dim+dir] ordering
       // 0 - no packing
@@ -216,17 +229,17 @@ namespace quda {
 
     inline void apply(const cudaStream_t &stream) {
 
+      const TuneParam &tp = tuneLaunch(*this, getTuning(), getVerbosity());
+
       if (out.Location() == QUDA_CPU_FIELD_LOCATION) {
 
 	if (out.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || Y.FieldOrder() != QUDA_QDP_GAUGE_ORDER)
 	  errorQuda("Unsupported field order colorspinor=%d gauge=%d combination\n", inA.FieldOrder(), Y.FieldOrder());
 
 	DslashCoarseArg<Float,yFloat,ghostFloat,Ns,Nc,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER,QUDA_QDP_GAUGE_ORDER> arg(out, inA, inB, Y, X, (Float)kappa, parity);
-	coarseDslash<Float,nDim,Ns,Nc,Mc,dslash,clover,dagger,type>(arg);
+	coarseDslash<Float,nDim,Ns,Nc,Mc,dslash,clover,dagger,type>(arg, tp);
       } else {
 
-        const TuneParam &tp = tuneLaunch(*this, getTuning(), getVerbosity());
-
 	if (out.FieldOrder() != QUDA_FLOAT2_FIELD_ORDER || Y.FieldOrder() != QUDA_FLOAT2_GAUGE_ORDER)
 	  errorQuda("Unsupported field order colorspinor=%d gauge=%d combination\n", inA.FieldOrder(), Y.FieldOrder());
 
@@ -313,12 +326,14 @@ namespace quda {
 
     void preTune() {
       saveOut = new char[out.Bytes()];
-      cudaMemcpy(saveOut, out.V(), out.Bytes(), cudaMemcpyDeviceToHost);
+      if (out.Location() == QUDA_CPU_FIELD_LOCATION) memcpy(saveOut, out.V(), out.Bytes());
+      else cudaMemcpy(saveOut, out.V(), out.Bytes(), cudaMemcpyDeviceToHost);
     }
 
     void postTune()
     {
-      cudaMemcpy(out.V(), saveOut, out.Bytes(), cudaMemcpyHostToDevice);
+      if (out.Location() == QUDA_CPU_FIELD_LOCATION) memcpy(out.V(), saveOut, out.Bytes());
+      else cudaMemcpy(out.V(), saveOut, out.Bytes(), cudaMemcpyHostToDevice);
       delete[] saveOut;
     }
 
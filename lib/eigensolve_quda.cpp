@@ -22,6 +22,12 @@ namespace quda
 
   using namespace Eigen;
 
+  // Chebyshev filter estimation
+  static constexpr int cheby_est_steps = 30;      // Lanczos steps used to bound the spectrum
+  static constexpr double cheby_margin = 0.1;     // relative safety margin on a_max
+  static constexpr double cheby_update_tol = 0.2; // relative change in a_min or degree that replaces the filter
+  static constexpr int cheby_deg_max = 500;       // maximum degree if none is given
+
   // Eigensolver class
   //-----------------------------------------------------------------------------
   EigenSolver::EigenSolver(QudaEigParam *eig_param, TimeProfile &profile) :
@@ -52,6 +58,10 @@ namespace quda
     num_locked = 0;
     num_keep = 0;
 
+    poly_deg_max = eig_param->poly_deg > 0 ? eig_param->poly_deg : cheby_deg_max;
+    n_mat_vec = 0;
+    n_mat_vec_est = 0;
+
     // Sanity checks
     if (nKr <= nEv) errorQuda("nKr=%d is less than or equal to nEv=%d\n", nKr, nEv);
     if (nEv < nConv) errorQuda("nConv=%d is greater than nEv=%d\n", nConv, nEv);
@@ -117,6 +127,11 @@ namespace quda
       if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Creating TR Lanczos eigensolver\n");
       eig_solver = new TRLM(eig_param, mat, profile);
       break;
+    case QUDA_EIG_BLK_TR_LANCZOS:
+      if (getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("Creating Block TR Lanczos eigensolver with block size %d\n", eig_param->block_size);
+      eig_solver = new BLKTRLM(eig_param, mat, profile);
+      break;
     default: errorQuda("Invalid eig solver type");
     }
     return eig_solver;
@@ -133,6 +148,7 @@ namespace quda
       if (!tmp2) tmp2 = ColorSpinorField::Create(param);
     }
     mat(out, in, *tmp1, *tmp2);
+    n_mat_vec++;
   }
 
   void EigenSolver::chebyOp(const DiracMatrix &mat, ColorSpinorField &out, const ColorSpinorField &in)
@@ -203,6 +219,144 @@ namespace quda
     delete tmp2;
   }
 
+  // Lowest degree whose Chebyshev filter on [a_min, a_max] damps that
+  // interval by rate relative to lambda_conv, with a_min at lambda_edge
+  static void chebyFilter(double a_max, double lambda_conv, double lambda_edge, double rate, int deg_max,
+                          double &a_min, int &poly_deg)
+  {
+    a_min = std::max(lambda_edge, lambda_conv + 1e-3 * (a_max - lambda_conv));
+    a_min = std::min(a_min, 0.9 * a_max);
+
+    // |T_n| <= 1 on [a_min, a_max], while at lambda_conv the argument is g > 1
+    const double delta = (a_max - a_min) / 2.0;
+    const double g = 1.0 + (a_min - lambda_conv) / delta;
+    if (!(g > 1.0)) {
+      // lambda_conv is not below the filtered interval (e.g., a_max is
+      // underestimated), so no degree reaches the rate: use the largest
+      poly_deg = deg_max;
+      return;
+    }
+    // clamp before the conversion, as g close to one gives a degree beyond any int
+    const double degree = std::min(ceil(acosh(1.0 / rate) / acosh(g)), (double)deg_max);
+
+    // chebyOp applies a polynomial of degree poly_deg - 1
+    poly_deg = std::min(std::max((int)degree + 1, 2), deg_max);
+  }
+
+  void EigenSolver::estimateChebyParams(const DiracMatrix &mat, const ColorSpinorField &in)
+  {
+    if (eig_param->poly_acc_rate <= 0.0 || eig_param->poly_acc_rate >= 1.0)
+      errorQuda("Invalid Chebyshev filter target rate %e", eig_param->poly_acc_rate);
+
+    const long long n_mat_vec_start = n_mat_vec;
+
+    ColorSpinorParam param(in);
+    param.create = QUDA_ZERO_FIELD_CREATE;
+    ColorSpinorField *v = ColorSpinorField::Create(param);
+    ColorSpinorField *v_old = ColorSpinorField::Create(param);
+    ColorSpinorField *w = ColorSpinorField::Create(param);
+
+    if (v->Location() == QUDA_CPU_FIELD_LOCATION) {
+      v->Source(QUDA_RANDOM_SOURCE);
+    } else {
+      spinorNoise(*v, 4321, QUDA_NOISE_UNIFORM);
+    }
+    blas::ax(1.0 / sqrt(blas::norm2(*v)), *v);
+
+    // Plain Lanczos without reorthogonalisation, the extremal Ritz values converge first
+    int steps = std::min(nKr, cheby_est_steps);
+    std::vector<double> alpha_est(steps), beta_est(steps);
+    for (int j = 0; j < steps; j++) {
+      matVec(mat, *w, *v);
+      alpha_est[j] = blas::reDotProduct(*v, *w);
+      blas::axpy(-alpha_est[j], *v, *w);
+      if (j > 0) blas::axpy(-beta_est[j - 1], *v_old, *w);
+      beta_est[j] = sqrt(blas::norm2(*w));
+      if (beta_est[j] == 0.0) { // invariant subspace
+        steps = j + 1;
+        break;
+      }
+      std::swap(v_old, v);
+      std::swap(v, w);
+      blas::ax(1.0 / beta_est[j], *v);
+    }
+
+    delete w;
+    delete v_old;
+    delete v;
+
+    SelfAdjointEigenSolver<MatrixXd> eigensolver;
+    VectorXd diag = Map<VectorXd>(alpha_est.data(), steps);
+    VectorXd sub_diag = Map<VectorXd>(beta_est.data(), steps - 1);
+    eigensolver.computeFromTridiagonal(diag, sub_diag);
+    const VectorXd &theta = eigensolver.eigenvalues();
+    const MatrixXd &y = eigensolver.eigenvectors();
+
+    // Extremal Ritz values widened by their residuals
+    const double upper = theta(steps - 1) + beta_est[steps - 1] * fabs(y(steps - 1, steps - 1));
+    const double lower = std::max(theta(0) - beta_est[steps - 1] * fabs(y(steps - 1, 0)), 0.0);
+
+    // Weyl's law for a four dimensional lattice operator: near the
+    // bottom of the spectrum the eigenvalue count grows as lambda^2
+    const double n_dof = 0.5 * in.RealLength() * comm_size();
+    auto weyl = [&](int k) { return lower + (upper - lower) * sqrt(k / n_dof); };
+
+    eig_param->a_max = (1.0 + cheby_margin) * upper;
+    chebyFilter(eig_param->a_max, weyl(nConv), weyl(nEv), eig_param->poly_acc_rate, poly_deg_max, eig_param->a_min,
+                eig_param->poly_deg);
+
+    n_mat_vec_est += n_mat_vec - n_mat_vec_start;
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Spectrum bounded by [%e, %e] after %d Lanczos steps\n", lower, upper, steps);
+    printChebyParams();
+  }
+
+  bool EigenSolver::updateChebyParams(const DiracMatrix &mat, std::vector<ColorSpinorField *> &kSpace, int n_ritz)
+  {
+    if (n_ritz < nConv) return false;
+
+    const long long n_mat_vec_start = n_mat_vec;
+
+    ColorSpinorParam param(*kSpace[0]);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *tmp = ColorSpinorField::Create(param);
+    auto rayleigh = [&](ColorSpinorField &v) {
+      matVec(mat, *tmp, v);
+      return blas::reDotProduct(v, *tmp) / blas::norm2(v);
+    };
+    const double lambda_conv = rayleigh(*kSpace[nConv - 1]);
+    const double lambda_edge = rayleigh(*kSpace[std::min(nEv, n_ritz) - 1]);
+    delete tmp;
+
+    n_mat_vec_est += n_mat_vec - n_mat_vec_start;
+
+    double a_min;
+    int poly_deg;
+    chebyFilter(eig_param->a_max, lambda_conv, lambda_edge, eig_param->poly_acc_rate, poly_deg_max, a_min, poly_deg);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Chebyshev filter re-estimate: lambda[%d] = %e lambda[%d] = %e gives a_min = %e degree %d\n",
+                 nConv - 1, lambda_conv, std::min(nEv, n_ritz) - 1, lambda_edge, a_min, poly_deg);
+
+    if (fabs(a_min - eig_param->a_min) <= cheby_update_tol * eig_param->a_min
+        && abs(poly_deg - eig_param->poly_deg) <= cheby_update_tol * eig_param->poly_deg)
+      return false;
+
+    eig_param->a_min = a_min;
+    eig_param->poly_deg = poly_deg;
+    printChebyParams();
+    return true;
+  }
+
+  void EigenSolver::printChebyParams() const
+  {
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Chebyshev filter a_min = %e a_max = %e degree %d: %lld operator applications, %lld of them "
+                 "estimating the filter\n",
+                 eig_param->a_min, eig_param->a_max, std::max(eig_param->poly_deg - 1, 1), n_mat_vec, n_mat_vec_est);
+  }
+
   // Orthogonalise r against V_[j]
   Complex EigenSolver::blockOrthogonalize(std::vector<ColorSpinorField *> vecs, std::vector<ColorSpinorField *> rvec,
                                           int j)
@@ -225,6 +379,55 @@ namespace quda
     return sum;
   }
 
+  // Block axpy onto the rotated basis, real and complex coefficients
+  static inline void blockAxpy(const double *a, std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y)
+  {
+    blas::axpy(a, x, y);
+  }
+
+  static inline void blockAxpy(const Complex *a, std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y)
+  {
+    blas::caxpy(a, x, y);
+  }
+
+  template <typename T>
+  static void rotateVecsImpl(std::vector<ColorSpinorField *> &kSpace, const T *rot, int offset, int dim, int keep,
+                             int locked)
+  {
+    if (offset < locked + dim) errorQuda("Scratch offset %d overlaps the %d vectors being rotated", offset, locked + dim);
+
+    if ((int)kSpace.size() < offset + keep) {
+      ColorSpinorParam csParam(*kSpace[0]);
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      for (int i = kSpace.size(); i < offset + keep; i++) {
+        if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printfQuda("Adding %d vector to kSpace\n", i);
+        kSpace.push_back(ColorSpinorField::Create(csParam));
+      }
+    }
+
+    std::vector<ColorSpinorField *> vecs_ptr(kSpace.begin() + locked, kSpace.begin() + locked + dim);
+    std::vector<ColorSpinorField *> kSpace_ptr(kSpace.begin() + offset, kSpace.begin() + offset + keep);
+    for (auto &v : kSpace_ptr) blas::zero(*v);
+
+    // Multi-BLAS rotation: the kernels tile over both x and y so every
+    // basis vector is streamed once per tile of output vectors
+    blockAxpy(rot, vecs_ptr, kSpace_ptr);
+
+    for (int i = 0; i < keep; i++) std::swap(kSpace[locked + i], kSpace[offset + i]);
+  }
+
+  void EigenSolver::rotateVecs(std::vector<ColorSpinorField *> &kSpace, const double *rot, int offset, int dim,
+                               int keep, int locked)
+  {
+    rotateVecsImpl(kSpace, rot, offset, dim, keep, locked);
+  }
+
+  void EigenSolver::rotateVecs(std::vector<ColorSpinorField *> &kSpace, const Complex *rot, int offset, int dim,
+                               int keep, int locked)
+  {
+    rotateVecsImpl(kSpace, rot, offset, dim, keep, locked);
+  }
+
   // Deflate vec, place result in vec_defl
   void EigenSolver::deflate(std::vector<ColorSpinorField *> vec_defl, std::vector<ColorSpinorField *> vec,
                             std::vector<ColorSpinorField *> eig_vecs, std::vector<Complex> evals)
@@ -361,6 +564,15 @@ namespace quda
 
   void EigenSolver::loadVectors(std::vector<ColorSpinorField *> &eig_vecs, std::string vec_infile)
   {
+    if (CompressedVectorStore::isCompressed(vec_infile)) {
+      if (getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("Start loading %04d compressed vectors from %s\n", (int)eig_vecs.size(), vec_infile.c_str());
+      CompressedVectorStore store {VectorCompressionParam()};
+      store.load(vec_infile);
+      store.reconstruct(eig_vecs);
+      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Done loading vectors\n");
+      return;
+    }
 
 #ifdef HAVE_QIO
     const int Nvec = eig_vecs.size();
@@ -409,8 +621,18 @@ namespace quda
 #endif
   }
 
-  void EigenSolver::saveVectors(const std::vector<ColorSpinorField *> &eig_vecs, std::string vec_outfile)
+  void EigenSolver::saveVectors(const std::vector<ColorSpinorField *> &eig_vecs, std::string vec_outfile,
+                                const VectorCompressionParam &compress)
   {
+    if (compress.n_basis > 0) {
+      if (getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("Start saving %d compressed vectors to %s\n", (int)eig_vecs.size(), vec_outfile.c_str());
+      CompressedVectorStore store(compress);
+      store.compress(eig_vecs);
+      store.save(vec_outfile);
+      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Done saving vectors\n");
+      return;
+    }
 
 #ifdef HAVE_QIO
     const int Nvec = eig_vecs.size();
@@ -578,6 +800,8 @@ namespace quda
     default: errorQuda("Invalid precision %d", prec);
     }
 
+    if (eig_param->use_poly_acc && eig_param->poly_acc_auto) estimateChebyParams(mat, *kSpace[0]);
+
     // Begin TRLM Eigensolver computation
     //---------------------------------------------------------------------------
     if (getVerbosity() >= QUDA_SUMMARIZE) {
@@ -662,6 +886,21 @@ namespace quda
         converged = true;
       }
 
+      // A new Chebyshev filter invalidates the Lanczos factorisation, so
+      // restart from the sum of the kept Ritz vectors
+      if (!converged && eig_param->use_poly_acc && eig_param->poly_acc_auto && num_keep > 1
+          && updateChebyParams(mat, kSpace, num_keep)) {
+        std::vector<double> ones(num_keep - 1, 1.0);
+        std::vector<ColorSpinorField *> kept(kSpace.begin() + 1, kSpace.begin() + num_keep);
+        std::vector<ColorSpinorField *> start(1, kSpace[0]);
+        blas::axpy(ones.data(), kept, start);
+        blas::ax(1.0 / sqrt(blas::norm2(*kSpace[0])), *kSpace[0]);
+        num_keep = 0;
+        num_locked = 0;
+        num_converged = 0;
+        mat_norm = 0.0;
+      }
+
       restart_iter++;
     }
 
@@ -690,6 +929,7 @@ namespace quda
       if (getVerbosity() >= QUDA_SUMMARIZE) {
         printfQuda("TRLM computed the requested %d vectors in %d restart steps and %d OP*x operations.\n", nConv,
                    restart_iter, iter);
+        if (eig_param->use_poly_acc) printChebyParams();
 
         // Dump all Ritz values and residua
         for (int i = 0; i < nConv; i++) {
@@ -707,6 +947,8 @@ namespace quda
       }
     }
 
+    eig_param->iter = iter;
+
     // Local clean-up
     delete r[0];
 
@@ -716,7 +958,7 @@ namespace quda
       // Make an array of size nConv
       std::vector<ColorSpinorField *> vecs_ptr;
       for (int i = 0; i < nConv; i++) { vecs_ptr.push_back(kSpace[i]); }
-      saveVectors(vecs_ptr, eig_param->vec_outfile);
+      saveVectors(vecs_ptr, eig_param->vec_outfile, VectorCompressionParam(*eig_param));
     }
 
     if (getVerbosity() >= QUDA_SUMMARIZE) {
@@ -867,40 +1109,362 @@ namespace quda
     int offset = nKr + 1;
     int dim = nKr - num_locked;
 
-    if ((int)kSpace.size() < offset + iter_keep) {
-      for (int i = kSpace.size(); i < offset + iter_keep; i++) {
-        if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printfQuda("Adding %d vector to kSpace\n", i);
-        kSpace.push_back(ColorSpinorField::Create(csParam));
+    // Rotation matrix for the multi-BLAS axpy, the Ritz vectors are the columns
+    std::vector<double> ritz_mat_keep(dim * iter_keep);
+    for (int j = 0; j < dim; j++)
+      for (int i = 0; i < iter_keep; i++) ritz_mat_keep[j * iter_keep + i] = ritz_mat[i * dim + j];
+
+    rotateVecs(kSpace, ritz_mat_keep.data(), offset, dim, iter_keep, num_locked);
+
+    // Update residual vector
+    std::swap(kSpace[num_locked + iter_keep], kSpace[nKr]);
+
+    for (int i = 0; i < iter_keep; i++) beta[i + num_locked] = beta[nKr - 1] * ritz_mat[dim * (i + 1) - 1];
+  }
+
+  // Block Thick Restarted Lanczos Method constructor
+  BLKTRLM::BLKTRLM(QudaEigParam *eig_param, const DiracMatrix &mat, TimeProfile &profile) :
+    EigenSolver(eig_param, profile),
+    mat(mat),
+    block_size(eig_param->block_size)
+  {
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    // Block thick restart specific checks
+    if (block_size < 1) errorQuda("Invalid block size %d\n", block_size);
+    if (nKr % block_size != 0) errorQuda("nKr=%d must be a multiple of the block size %d\n", nKr, block_size);
+    if (nKr < nEv + 2 * block_size)
+      errorQuda("nKr=%d must be greater than nEv+2*block_size=%d\n", nKr, nEv + 2 * block_size);
+
+    if (!(eig_param->spectrum == QUDA_SPECTRUM_LR_EIG || eig_param->spectrum == QUDA_SPECTRUM_SR_EIG)) {
+      errorQuda("Only real spectrum type (LR or SR) can be passed to the Block TR Lanczos solver");
+    }
+
+    T.resize(nKr * nKr, 0.0);
+    beta_last.resize(block_size * block_size, 0.0);
+    ritz_val.resize(nKr, 0.0);
+    ritz_mat.resize(nKr * nKr, 0.0);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+  }
+
+  void BLKTRLM::operator()(std::vector<ColorSpinorField *> &kSpace, std::vector<Complex> &evals)
+  {
+    // Check to see if we are loading eigenvectors
+    if (strcmp(eig_param->vec_infile, "") != 0) {
+      printfQuda("Loading evecs from file name %s\n", eig_param->vec_infile);
+      loadFromFile(mat, kSpace, evals);
+      return;
+    }
+
+    // Increase Krylov space to nKr vectors plus the residual block
+    ColorSpinorParam csParamClone(*kSpace[0]);
+    csParam = csParamClone;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    for (int i = nConv; i < nKr + block_size; i++) kSpace.push_back(ColorSpinorField::Create(csParam));
+    // Increase evals space to nEv
+    for (int i = nConv; i < nEv; i++) evals.push_back(0.0);
+
+    // The initial block is the initial guess padded with random vectors
+    for (int i = 0; i < block_size; i++) {
+      if (blas::norm2(*kSpace[i]) > 0.0) continue;
+      if (i == 0 && getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Initial residual is zero. Populating with rands.\n");
+      if (kSpace[i]->Location() == QUDA_CPU_FIELD_LOCATION) {
+        kSpace[i]->Source(QUDA_RANDOM_SOURCE);
+      } else {
+        spinorNoise(*kSpace[i], 1234 + i, QUDA_NOISE_UNIFORM);
+      }
+    }
+
+    std::vector<ColorSpinorField *> block(kSpace.begin(), kSpace.begin() + block_size);
+    std::vector<Complex> R(block_size * block_size);
+    orthonormalizeBlock(block, R.data());
+
+    if (eig_param->use_poly_acc && eig_param->poly_acc_auto) estimateChebyParams(mat, *kSpace[0]);
+    //---------------------------------------------------------------------------
+
+    // Begin BLKTRLM Eigensolver computation
+    //---------------------------------------------------------------------------
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("*****************************\n");
+      printfQuda("*** START BLKTRLM SOLUTION **\n");
+      printfQuda("*****************************\n");
+    }
+
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    double mat_norm = 0.0;
+
+    // Loop over restart iterations.
+    while (restart_iter < max_restarts && !converged) {
+
+      for (int step = num_keep; step < nKr; step += block_size) blockLanczosStep(kSpace, step);
+      iter += (nKr - num_keep);
+
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      eigensolveFromBlockArrowMat();
+      profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+      // mat_norm is updated.
+      for (int i = 0; i < nKr; i++)
+        if (fabs(ritz_val[i]) > mat_norm) mat_norm = fabs(ritz_val[i]);
+
+      // Convergence check, from the wanted end of the spectrum
+      num_converged = 0;
+      while (num_converged < nKr && residua[num_converged] < tol * mat_norm) {
+        if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+          printfQuda("**** Converged %d resid=%+.6e condition=%.6e ****\n", num_converged, residua[num_converged],
+                     tol * mat_norm);
+        num_converged++;
       }
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+        printfQuda("%04d converged eigenvalues at restart iter %04d\n", num_converged, restart_iter + 1);
+
+      if (num_converged >= nConv) {
+        computeKeptRitz(kSpace, nConv);
+        converged = true;
+      } else {
+        // Keep the converged pairs and half of the rest, leaving room for at least two
+        // blocks; the extension must be a whole number of blocks
+        int n_keep = std::min(num_converged + (nKr - num_converged) / 2, nKr - 2 * block_size);
+        n_keep -= n_keep % block_size;
+        computeKeptRitz(kSpace, n_keep);
+        num_keep = n_keep;
+
+        // A new Chebyshev filter invalidates the block Lanczos
+        // factorisation, so restart from the kept Ritz vectors folded
+        // into the first block
+        if (eig_param->use_poly_acc && eig_param->poly_acc_auto && updateChebyParams(mat, kSpace, num_keep)) {
+          std::vector<ColorSpinorField *> head(kSpace.begin(), kSpace.begin() + block_size);
+          if (num_keep > block_size) {
+            std::vector<ColorSpinorField *> kept(kSpace.begin() + block_size, kSpace.begin() + num_keep);
+            std::vector<double> fold((num_keep - block_size) * block_size, 0.0);
+            for (int i = 0; i < num_keep - block_size; i++) fold[i * block_size + i % block_size] = 1.0;
+            blas::axpy(fold.data(), kept, head);
+          }
+          orthonormalizeBlock(head, R.data());
+          std::fill(T.begin(), T.end(), 0.0);
+          num_keep = 0;
+          mat_norm = 0.0;
+        }
+      }
+
+      restart_iter++;
     }
 
-    // Array for multi-BLAS axpy
-    double *ritz_mat_col = (double *)safe_malloc((dim - 1) * sizeof(double));
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    eig_param->iter = iter;
+
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+      printfQuda("kSpace size at convergence/max restarts = %d\n", (int)kSpace.size());
+    // Prune the Krylov space back to size when passed to eigensolver
+    for (unsigned int i = nConv; i < kSpace.size(); i++) { delete kSpace[i]; }
+    kSpace.resize(nConv);
+    evals.resize(nConv);
+
+    // Post computation report
+    //---------------------------------------------------------------------------
+    if (!converged) {
+      if (eig_param->require_convergence) {
+        errorQuda("BLKTRLM failed to compute the requested %d vectors with a %d search space and %d Krylov space in %d "
+                  "restart steps. Exiting.",
+                  nConv, nEv, nKr, max_restarts);
+      } else {
+        warningQuda("BLKTRLM failed to compute the requested %d vectors with a %d search space and %d Krylov space in "
+                    "%d restart steps. Continuing with current lanczos factorisation.",
+                    nConv, nEv, nKr, max_restarts);
+      }
+    } else {
+      if (getVerbosity() >= QUDA_SUMMARIZE) {
+        printfQuda("BLKTRLM computed the requested %d vectors in %d restart steps and %d OP*x operations.\n", nConv,
+                   restart_iter, iter);
+        if (eig_param->use_poly_acc) printChebyParams();
+
+        // Dump all Ritz values and residua
+        for (int i = 0; i < nConv; i++) {
+          printfQuda("RitzValue[%04d]: (%+.16e, %+.16e) residual %.16e\n", i, ritz_val[i], 0.0, residua[i]);
+        }
+      }
 
-    for (int i = 0; i < iter_keep; i++) {
-      int k = offset + i;
-      *r[0] = *kSpace[num_locked];
-      blas::ax(ritz_mat[dim * i], *r[0]);
-      *kSpace[k] = *r[0];
+      // Compute eigenvalues
+      r.push_back(ColorSpinorField::Create(csParam));
+      computeEvals(mat, kSpace, evals, nConv);
+      if (getVerbosity() >= QUDA_SUMMARIZE) {
+        for (int i = 0; i < nConv; i++) {
+          printfQuda("EigValue[%04d]: (%+.16e, %+.16e) residual %.16e\n", i, evals[i].real(), evals[i].imag(),
+                     residua[i]);
+        }
+      }
+      delete r[0];
+      r.clear();
+    }
 
-      // Pointers to the relevant vectors
+    // Only save if outfile is defined
+    if (strcmp(eig_param->vec_outfile, "") != 0) {
+      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("saving eigenvectors\n");
+      // Make an array of size nConv
       std::vector<ColorSpinorField *> vecs_ptr;
-      std::vector<ColorSpinorField *> kSpace_ptr;
-      kSpace_ptr.push_back(kSpace[k]);
-      for (int j = 1; j < dim; j++) {
-        vecs_ptr.push_back(kSpace[num_locked + j]);
-        ritz_mat_col[j - 1] = ritz_mat[i * dim + j];
+      for (int i = 0; i < nConv; i++) { vecs_ptr.push_back(kSpace[i]); }
+      saveVectors(vecs_ptr, eig_param->vec_outfile, VectorCompressionParam(*eig_param));
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("*****************************\n");
+      printfQuda("**** END BLKTRLM SOLUTION ***\n");
+      printfQuda("*****************************\n");
+    }
+  }
+
+  // Destructor
+  BLKTRLM::~BLKTRLM() { }
+
+  // Block Thick Restart Member functions
+  //---------------------------------------------------------------------------
+  void BLKTRLM::blockLanczosStep(std::vector<ColorSpinorField *> &v, int j)
+  {
+    const int b = block_size;
+    std::vector<ColorSpinorField *> v_j(v.begin() + j, v.begin() + j + b);
+    std::vector<ColorSpinorField *> w(v.begin() + j + b, v.begin() + j + 2 * b);
+
+    // W = A * V_j
+    for (int k = 0; k < b; k++) chebyOp(mat, *w[k], *v_j[k]);
+
+    // a_j = V_j^dag * W, symmetrised so that T stays exactly Hermitian
+    std::vector<Complex> alpha(b * b);
+    blas::cDotProduct(alpha.data(), v_j, w);
+    for (int l = 0; l < b; l++)
+      for (int k = 0; k < b; k++) T[(j + l) * nKr + j + k] = 0.5 * (alpha[l * b + k] + conj(alpha[k * b + l]));
+
+    // W = W - V_{j-1} * b_{j-1}^dag - V_j * a_j, where after a restart the
+    // first block is instead coupled to all of the kept Ritz vectors
+    int start = (j > num_keep) ? j - b : 0;
+    std::vector<ColorSpinorField *> v_prev(v.begin() + start, v.begin() + j + b);
+    std::vector<Complex> coeff((j + b - start) * b);
+    for (int l = start; l < j + b; l++)
+      for (int k = 0; k < b; k++) coeff[(l - start) * b + k] = -T[l * nKr + j + k];
+    blas::caxpy(coeff.data(), v_prev, w);
+
+    // Orthogonalise W against the Krylov space
+    std::vector<ColorSpinorField *> v_all(v.begin(), v.begin() + j + b);
+    std::vector<Complex> s((j + b) * b);
+    blas::cDotProduct(s.data(), v_all, w);
+    for (auto &s_i : s) s_i *= -1.0;
+    blas::caxpy(s.data(), v_all, w);
+
+    // Prepare next step.
+    // V_{j+1} * b_j = W
+    std::vector<Complex> beta(b * b);
+    orthonormalizeBlock(w, beta.data());
+
+    if (j + b < nKr) {
+      for (int l = 0; l < b; l++) {
+        for (int k = 0; k < b; k++) {
+          T[(j + b + l) * nKr + j + k] = beta[l * b + k];
+          T[(j + k) * nKr + j + b + l] = conj(beta[l * b + k]);
+        }
       }
+    } else {
+      beta_last = beta;
+    }
+  }
 
-      // Multi-BLAS axpy
-      blas::axpy(ritz_mat_col, vecs_ptr, kSpace_ptr);
+  void BLKTRLM::orthonormalizeBlock(std::vector<ColorSpinorField *> &q, Complex *R)
+  {
+    const int b = q.size();
+    MatrixXcd R_total = MatrixXcd::Identity(b, b);
+    std::vector<Complex> G(b * b);
+
+    // Cholesky QR, applied twice since a single pass loses
+    // orthogonality as the square of the condition number of the block
+    for (int pass = 0; pass < 2; pass++) {
+      blas::cDotProduct(G.data(), q, q);
+
+      MatrixXcd gram(b, b);
+      for (int l = 0; l < b; l++)
+        for (int k = 0; k < b; k++) gram(l, k) = G[l * b + k];
+
+      LLT<MatrixXcd> llt(gram);
+      if (llt.info() != Success) errorQuda("Block Lanczos breakdown: block of %d vectors is rank deficient", b);
+      MatrixXcd U = llt.matrixU();
+      MatrixXcd U_inv = U.triangularView<Upper>().solve(MatrixXcd::Identity(b, b));
+
+      // q = q * U^{-1}, in place from the last vector since column k only depends on q_0..q_k
+      for (int k = b - 1; k >= 0; k--) {
+        blas::ax(U_inv(k, k).real(), *q[k]);
+        if (k == 0) break;
+        std::vector<Complex> c(k);
+        for (int l = 0; l < k; l++) c[l] = U_inv(l, k);
+        std::vector<ColorSpinorField *> q_l(q.begin(), q.begin() + k);
+        std::vector<ColorSpinorField *> q_k(1, q[k]);
+        blas::caxpy(c.data(), q_l, q_k);
+      }
+
+      R_total = U * R_total;
     }
 
-    host_free(ritz_mat_col);
+    for (int l = 0; l < b; l++)
+      for (int k = 0; k < b; k++) R[l * b + k] = R_total(l, k);
+  }
 
-    for (int i = 0; i < iter_keep; i++) *kSpace[i + num_locked] = *kSpace[offset + i];
-    *kSpace[num_locked + iter_keep] = *kSpace[nKr];
+  void BLKTRLM::eigensolveFromBlockArrowMat()
+  {
+    profile.TPSTART(QUDA_PROFILE_EIGEN);
+    const int b = block_size;
 
-    for (int i = 0; i < iter_keep; i++) beta[i + num_locked] = beta[nKr - 1] * ritz_mat[dim * (i + 1) - 1];
+    MatrixXcd A(nKr, nKr);
+    for (int i = 0; i < nKr; i++)
+      for (int j = 0; j < nKr; j++) A(i, j) = T[i * nKr + j];
+
+    SelfAdjointEigenSolver<MatrixXcd> eigensolver;
+    eigensolver.compute(A);
+
+    // The eigenvalues are returned in ascending order, so walk them
+    // backwards when the wanted end of the spectrum is the largest
+    for (int i = 0; i < nKr; i++) {
+      int idx = reverse ? nKr - 1 - i : i;
+      ritz_val[i] = eigensolver.eigenvalues()[idx];
+      for (int j = 0; j < nKr; j++) ritz_mat[i * nKr + j] = eigensolver.eigenvectors().col(idx)[j];
+
+      // ||A V y_i - theta_i V y_i|| = ||b_last * (last block of y_i)||
+      double res = 0.0;
+      for (int l = 0; l < b; l++) {
+        Complex sum = 0.0;
+        for (int k = 0; k < b; k++) sum += beta_last[l * b + k] * ritz_mat[i * nKr + nKr - b + k];
+        res += norm(sum);
+      }
+      residua[i] = sqrt(res);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_EIGEN);
+  }
+
+  void BLKTRLM::computeKeptRitz(std::vector<ColorSpinorField *> &kSpace, int n_keep)
+  {
+    const int b = block_size;
+    const int offset = nKr + b;
+
+    // Rotate the Krylov space onto the kept Ritz vectors
+    std::vector<Complex> rotation(nKr * n_keep);
+    for (int j = 0; j < nKr; j++)
+      for (int i = 0; i < n_keep; i++) rotation[j * n_keep + i] = ritz_mat[i * nKr + j];
+    rotateVecs(kSpace, rotation.data(), offset, nKr, n_keep, 0);
+
+    // The kept Ritz vectors are followed by the residual block
+    for (int k = 0; k < b; k++) std::swap(kSpace[n_keep + k], kSpace[nKr + k]);
+
+    // The projection is now diagonal on the kept space, with the
+    // residual block coupled through b_last * (last block of y_i)
+    std::fill(T.begin(), T.end(), 0.0);
+    for (int i = 0; i < n_keep; i++) {
+      T[i * nKr + i] = ritz_val[i];
+      for (int l = 0; l < b; l++) {
+        Complex sum = 0.0;
+        for (int k = 0; k < b; k++) sum += beta_last[l * b + k] * ritz_mat[i * nKr + nKr - b + k];
+        T[(n_keep + l) * nKr + i] = sum;
+        T[i * nKr + n_keep + l] = conj(sum);
+      }
+    }
   }
 } // namespace quda
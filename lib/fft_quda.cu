@@ -0,0 +1,812 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+
+#include <quda_internal.h>
+#include <tune_quda.h>
+#include <host_parallel.h>
+#include <complex_quda.h>
+#include <fft_quda.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef FFTW_LIB
+#include <fftw3.h>
+#endif
+
+#ifdef GPU_GAUGE_ALG
+#include <CUFFT_Plans.h>
+#endif
+
+namespace quda {
+
+  FFTBackend hostFFTBackend()
+  {
+    static FFTBackend backend = FFT_BACKEND_INVALID;
+    if (backend == FFT_BACKEND_INVALID) {
+#ifdef FFTW_LIB
+      backend = FFT_BACKEND_FFTW;
+#else
+      backend = FFT_BACKEND_BUILTIN;
+#endif
+      char *backend_env = getenv("QUDA_FFT_BACKEND");
+      if (backend_env) {
+        if (strcmp(backend_env, "builtin") == 0) {
+          backend = FFT_BACKEND_BUILTIN;
+        } else if (strcmp(backend_env, "fftw") == 0) {
+#ifdef FFTW_LIB
+          backend = FFT_BACKEND_FFTW;
+#else
+          warningQuda("QUDA_FFT_BACKEND=fftw but QUDA has not been built with FFTW, using the built-in FFT");
+#endif
+        } else {
+          errorQuda("QUDA_FFT_BACKEND=%s is not one of builtin or fftw", backend_env);
+        }
+      }
+    }
+    return backend;
+  }
+
+  const char *fftBackendString(FFTBackend backend)
+  {
+    switch (backend) {
+    case FFT_BACKEND_CUFFT: return "cufft";
+    case FFT_BACKEND_BUILTIN: return "builtin";
+    case FFT_BACKEND_FFTW: return "fftw";
+    default: return "invalid";
+    }
+  }
+
+  FFTPlan::FFTPlan(const int *X_, QudaPrecision precision, FFTBackend backend) :
+    volume(1), precision(precision), backend(backend)
+  {
+    for (int d = 0; d < 4; d++) {
+      X[d] = X_[d];
+      volume *= X[d];
+      layout[d] = d;
+    }
+  }
+
+  long long FFTPlan::flops() const { return static_cast<long long>(5.0 * volume * std::log2((double)volume)); }
+
+  /**
+     @brief One stage of a Stockham FFT: the sub-transforms of length
+     n entering the stage are split by a radix-r butterfly into r
+     transforms of length n / r.  Butterfly p (of n / r) combines
+     elements p + k n / r, k < r, and multiplies output t by the
+     twiddle exp(-+ 2 pi i p t / n), for which exp(2 pi i p t / n) is
+     stored at w[r p + t].  For radices other than 2, 3, 4 and 5 the
+     roots exp(2 pi i j / r) of the butterfly are stored in root.
+   */
+  template <typename Float> struct FFTStage {
+    int radix;
+    int n;
+    std::vector<Float> wr, wi;
+    std::vector<Float> root_r, root_i;
+  };
+
+  /**
+     @brief Plan of a 1-d FFT of length n on a tile of W pencils, with
+     element j of lane q at index q + W j of separate real and
+     imaginary arrays.  Each stage reads one pair of arrays and writes
+     the other, so after the last stage the transform is in one of the
+     two in natural order.
+   */
+  template <typename Float> class FFT1d
+  {
+    int n;
+    std::vector<FFTStage<Float>> stages;
+
+    template <int sign> void radix2(const FFTStage<Float> &st, int s, const Float *xr, const Float *xi, Float *yr,
+                                    Float *yi) const
+    {
+      const int m = st.n / 2;
+      for (int p = 0; p < m; p++) {
+        const Float w1r = st.wr[2 * p + 1], w1i = sign * st.wi[2 * p + 1];
+        const Float *x0r = xr + s * p, *x0i = xi + s * p, *x1r = xr + s * (p + m), *x1i = xi + s * (p + m);
+        Float *y0r = yr + s * 2 * p, *y0i = yi + s * 2 * p, *y1r = y0r + s, *y1i = y0i + s;
+#pragma omp simd
+        for (int q = 0; q < s; q++) {
+          const Float dr = x0r[q] - x1r[q], di = x0i[q] - x1i[q];
+          y0r[q] = x0r[q] + x1r[q];
+          y0i[q] = x0i[q] + x1i[q];
+          y1r[q] = dr * w1r - di * w1i;
+          y1i[q] = dr * w1i + di * w1r;
+        }
+      }
+    }
+
+    template <int sign> void radix3(const FFTStage<Float> &st, int s, const Float *xr, const Float *xi, Float *yr,
+                                    Float *yi) const
+    {
+      const int m = st.n / 3;
+      const Float c = -0.5, sn = sign * 0.86602540378443864676; // exp(-+ 2 pi i / 3)
+      for (int p = 0; p < m; p++) {
+        const Float w1r = st.wr[3 * p + 1], w1i = sign * st.wi[3 * p + 1];
+        const Float w2r = st.wr[3 * p + 2], w2i = sign * st.wi[3 * p + 2];
+        const Float *x0r = xr + s * p, *x1r = x0r + s * m, *x2r = x1r + s * m;
+        const Float *x0i = xi + s * p, *x1i = x0i + s * m, *x2i = x1i + s * m;
+        Float *y0r = yr + s * 3 * p, *y1r = y0r + s, *y2r = y1r + s;
+        Float *y0i = yi + s * 3 * p, *y1i = y0i + s, *y2i = y1i + s;
+#pragma omp simd
+        for (int q = 0; q < s; q++) {
+          const Float sr = x1r[q] + x2r[q], si = x1i[q] + x2i[q];
+          const Float dr = x1r[q] - x2r[q], di = x1i[q] - x2i[q];
+          const Float tr = x0r[q] + c * sr, ti = x0i[q] + c * si;
+          const Float b1r = tr - sn * di, b1i = ti + sn * dr;
+          const Float b2r = tr + sn * di, b2i = ti - sn * dr;
+          y0r[q] = x0r[q] + sr;
+          y0i[q] = x0i[q] + si;
+          y1r[q] = b1r * w1r - b1i * w1i;
+          y1i[q] = b1r * w1i + b1i * w1r;
+          y2r[q] = b2r * w2r - b2i * w2i;
+          y2i[q] = b2r * w2i + b2i * w2r;
+        }
+      }
+    }
+
+    template <int sign> void radix4(const FFTStage<Float> &st, int s, const Float *xr, const Float *xi, Float *yr,
+                                    Float *yi) const
+    {
+      const int m = st.n / 4;
+      for (int p = 0; p < m; p++) {
+        const Float w1r = st.wr[4 * p + 1], w1i = sign * st.wi[4 * p + 1];
+        const Float w2r = st.wr[4 * p + 2], w2i = sign * st.wi[4 * p + 2];
+        const Float w3r = st.wr[4 * p + 3], w3i = sign * st.wi[4 * p + 3];
+        const Float *x0r = xr + s * p, *x1r = x0r + s * m, *x2r = x1r + s * m, *x3r = x2r + s * m;
+        const Float *x0i = xi + s * p, *x1i = x0i + s * m, *x2i = x1i + s * m, *x3i = x2i + s * m;
+        Float *y0r = yr + s * 4 * p, *y1r = y0r + s, *y2r = y1r + s, *y3r = y2r + s;
+        Float *y0i = yi + s * 4 * p, *y1i = y0i + s, *y2i = y1i + s, *y3i = y2i + s;
+#pragma omp simd
+        for (int q = 0; q < s; q++) {
+          const Float s02r = x0r[q] + x2r[q], s02i = x0i[q] + x2i[q];
+          const Float d02r = x0r[q] - x2r[q], d02i = x0i[q] - x2i[q];
+          const Float s13r = x1r[q] + x3r[q], s13i = x1i[q] + x3i[q];
+          // (x1 - x3) times exp(-+ i pi / 2)
+          const Float e13r = -sign * (x1i[q] - x3i[q]), e13i = sign * (x1r[q] - x3r[q]);
+          const Float b1r = d02r + e13r, b1i = d02i + e13i;
+          const Float b2r = s02r - s13r, b2i = s02i - s13i;
+          const Float b3r = d02r - e13r, b3i = d02i - e13i;
+          y0r[q] = s02r + s13r;
+          y0i[q] = s02i + s13i;
+          y1r[q] = b1r * w1r - b1i * w1i;
+          y1i[q] = b1r * w1i + b1i * w1r;
+          y2r[q] = b2r * w2r - b2i * w2i;
+          y2i[q] = b2r * w2i + b2i * w2r;
+          y3r[q] = b3r * w3r - b3i * w3i;
+          y3i[q] = b3r * w3i + b3i * w3r;
+        }
+      }
+    }
+
+    template <int sign> void radix5(const FFTStage<Float> &st, int s, const Float *xr, const Float *xi, Float *yr,
+                                    Float *yi) const
+    {
+      const int m = st.n / 5;
+      const Float c1 = 0.30901699437494742410, c2 = -0.80901699437494742410;        // cos(2 pi / 5), cos(4 pi / 5)
+      const Float s1 = sign * 0.95105651629515357212, s2 = sign * 0.58778525229247312917; // -+ sin(2 pi / 5), -+ sin(4 pi / 5)
+      for (int p = 0; p < m; p++) {
+        Float wr[5], wi[5];
+        for (int t = 1; t < 5; t++) {
+          wr[t] = st.wr[5 * p + t];
+          wi[t] = sign * st.wi[5 * p + t];
+        }
+        const Float *x0r = xr + s * p, *x1r = x0r + s * m, *x2r = x1r + s * m, *x3r = x2r + s * m, *x4r = x3r + s * m;
+        const Float *x0i = xi + s * p, *x1i = x0i + s * m, *x2i = x1i + s * m, *x3i = x2i + s * m, *x4i = x3i + s * m;
+        Float *y0r = yr + s * 5 * p, *y0i = yi + s * 5 * p;
+#pragma omp simd
+        for (int q = 0; q < s; q++) {
+          const Float s14r = x1r[q] + x4r[q], s14i = x1i[q] + x4i[q];
+          const Float d14r = x1r[q] - x4r[q], d14i = x1i[q] - x4i[q];
+          const Float s23r = x2r[q] + x3r[q], s23i = x2i[q] + x3i[q];
+          const Float d23r = x2r[q] - x3r[q], d23i = x2i[q] - x3i[q];
+          const Float t1r = x0r[q] + c1 * s14r + c2 * s23r, t1i = x0i[q] + c1 * s14i + c2 * s23i;
+          const Float t2r = x0r[q] + c2 * s14r + c1 * s23r, t2i = x0i[q] + c2 * s14i + c1 * s23i;
+          // i times the odd parts
+          const Float u1r = -(s1 * d14i + s2 * d23i), u1i = s1 * d14r + s2 * d23r;
+          const Float u2r = -(s2 * d14i - s1 * d23i), u2i = s2 * d14r - s1 * d23r;
+          const Float br[5] = {0, t1r + u1r, t2r + u2r, t2r - u2r, t1r - u1r};
+          const Float bi[5] = {0, t1i + u1i, t2i + u2i, t2i - u2i, t1i - u1i};
+          y0r[q] = x0r[q] + s14r + s23r;
+          y0i[q] = x0i[q] + s14i + s23i;
+#pragma unroll
+          for (int t = 1; t < 5; t++) {
+            y0r[q + s * t] = br[t] * wr[t] - bi[t] * wi[t];
+            y0i[q + s * t] = br[t] * wi[t] + bi[t] * wr[t];
+          }
+        }
+      }
+    }
+
+    /** A plain DFT for prime factors other than 2, 3 and 5 */
+    template <int sign> void radixN(const FFTStage<Float> &st, int s, const Float *xr, const Float *xi, Float *yr,
+                                    Float *yi) const
+    {
+      const int r = st.radix;
+      const int m = st.n / r;
+      for (int p = 0; p < m; p++) {
+        for (int t = 0; t < r; t++) {
+          const Float wr = st.wr[r * p + t], wi = sign * st.wi[r * p + t];
+          Float *ytr = yr + s * (r * p + t), *yti = yi + s * (r * p + t);
+#pragma omp simd
+          for (int q = 0; q < s; q++) {
+            Float br = 0.0, bi = 0.0;
+            for (int k = 0; k < r; k++) {
+              const int j = (t * k) % r;
+              const Float cr = st.root_r[j], ci = sign * st.root_i[j];
+              const Float ar = xr[q + s * (p + k * m)], ai = xi[q + s * (p + k * m)];
+              br += ar * cr - ai * ci;
+              bi += ar * ci + ai * cr;
+            }
+            ytr[q] = br * wr - bi * wi;
+            yti[q] = br * wi + bi * wr;
+          }
+        }
+      }
+    }
+
+  public:
+    FFT1d(int n = 1) : n(n)
+    {
+      // radix-4 stages first, then the remaining factors in increasing order
+      std::vector<int> radix;
+      int rest = n;
+      while (rest % 4 == 0) {
+        radix.push_back(4);
+        rest /= 4;
+      }
+      for (int f = 2; rest > 1; f++) {
+        while (rest % f == 0) {
+          radix.push_back(f);
+          rest /= f;
+        }
+      }
+
+      int length = n;
+      for (int r : radix) {
+        FFTStage<Float> st;
+        st.radix = r;
+        st.n = length;
+        st.wr.resize(length);
+        st.wi.resize(length);
+        for (int p = 0; p < length / r; p++) {
+          for (int t = 0; t < r; t++) {
+            const double phase = 2.0 * M_PI * ((long)p * t % length) / length;
+            st.wr[r * p + t] = cos(phase);
+            st.wi[r * p + t] = sin(phase);
+          }
+        }
+        if (r > 5) {
+          st.root_r.resize(r);
+          st.root_i.resize(r);
+          for (int j = 0; j < r; j++) {
+            st.root_r[j] = cos(2.0 * M_PI * j / r);
+            st.root_i[j] = sin(2.0 * M_PI * j / r);
+          }
+        }
+        stages.push_back(st);
+        length /= r;
+      }
+    }
+
+    int Length() const { return n; }
+
+    /**
+       @brief Transform the tile in (xr, xi) of W lanes, using (yr, yi)
+       as the other buffer of the Stockham passes
+       @return Whether the result is in (xr, xi), else it is in (yr, yi)
+     */
+    template <int sign> bool transform(Float *xr, Float *xi, Float *yr, Float *yi, int W) const
+    {
+      int s = W;
+      bool in_x = true;
+      for (const FFTStage<Float> &st : stages) {
+        const Float *ar = in_x ? xr : yr, *ai = in_x ? xi : yi;
+        Float *br = in_x ? yr : xr, *bi = in_x ? yi : xi;
+        switch (st.radix) {
+        case 2: radix2<sign>(st, s, ar, ai, br, bi); break;
+        case 3: radix3<sign>(st, s, ar, ai, br, bi); break;
+        case 4: radix4<sign>(st, s, ar, ai, br, bi); break;
+        case 5: radix5<sign>(st, s, ar, ai, br, bi); break;
+        default: radixN<sign>(st, s, ar, ai, br, bi);
+        }
+        s *= st.radix;
+        in_x = !in_x;
+      }
+      return in_x;
+    }
+  };
+
+  /**
+     @brief Number of pencils in a tile: one 64-byte vector of lanes,
+     so a row of a tile is a cache line of the field for d > 0
+   */
+  template <typename Float> constexpr int fftTileWidth() { return 64 / sizeof(Float); }
+
+  /**
+     @brief The transform along one dimension of the 4-d field.  The
+     field holds V / n pencils of length n = X[d], with element j of
+     pencil (o, i) at o n s + j s + i for the stride s = X[0]...X[d-1].
+     Tiles of W consecutive pencils, i fastest, are gathered into the
+     thread's buffers, transformed and scattered back.  For d > 0 the W
+     lanes of a row are (mostly) contiguous in the field, so the gather
+     and scatter stream through memory as well.
+   */
+  template <typename Float> class FFTHostPass : Tunable
+  {
+    static constexpr int W = fftTileWidth<Float>();
+    const FFT1d<Float> &fft;
+    const int *X;
+    const int d;
+    const long long volume;
+    const int n;
+    const long long s;
+    const int tiles;
+    std::vector<Float> &scratch; // four arrays of n W reals per thread
+    const complex<Float> *in;
+    complex<Float> *out;
+    int sign;
+    std::vector<complex<Float>> backup;
+
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+    bool tuneGridDim() const { return false; }
+    unsigned int minThreads() const { return tiles; }
+
+    template <int sign_> void tile(int t, Float *buf) const
+    {
+      Float *xr = buf, *xi = xr + n * W, *yr = xi + n * W, *yi = yr + n * W;
+      const long long pencils = volume / n;
+      const long long p0 = static_cast<long long>(t) * W;
+      const int width = static_cast<int>(std::min<long long>(W, pencils - p0));
+      long long base[W];
+      for (int w = 0; w < width; w++) base[w] = ((p0 + w) / s) * n * s + (p0 + w) % s;
+      const bool contiguous = base[width - 1] - base[0] == width - 1;
+
+      if (width < W) {
+        for (int j = 0; j < n; j++)
+          for (int w = width; w < W; w++) xr[j * W + w] = xi[j * W + w] = 0.0;
+      }
+      for (int j = 0; j < n; j++) {
+        if (contiguous) {
+          const complex<Float> *row = in + base[0] + j * s;
+#pragma omp simd
+          for (int w = 0; w < width; w++) {
+            xr[j * W + w] = row[w].real();
+            xi[j * W + w] = row[w].imag();
+          }
+        } else {
+          for (int w = 0; w < width; w++) {
+            xr[j * W + w] = in[base[w] + j * s].real();
+            xi[j * W + w] = in[base[w] + j * s].imag();
+          }
+        }
+      }
+
+      const bool in_x = fft.template transform<sign_>(xr, xi, yr, yi, W);
+      const Float *rr = in_x ? xr : yr, *ri = in_x ? xi : yi;
+
+      for (int j = 0; j < n; j++) {
+        if (contiguous) {
+          complex<Float> *row = out + base[0] + j * s;
+#pragma omp simd
+          for (int w = 0; w < width; w++) row[w] = complex<Float>(rr[j * W + w], ri[j * W + w]);
+        } else {
+          for (int w = 0; w < width; w++) out[base[w] + j * s] = complex<Float>(rr[j * W + w], ri[j * W + w]);
+        }
+      }
+    }
+
+  public:
+    FFTHostPass(const FFT1d<Float> &fft, const int *X, int d, std::vector<Float> &scratch) :
+      fft(fft),
+      X(X),
+      d(d),
+      volume(static_cast<long long>(X[0]) * X[1] * X[2] * X[3]),
+      n(X[d]),
+      s(d == 0 ? 1 : static_cast<long long>(X[0]) * (d > 1 ? X[1] : 1) * (d > 2 ? X[2] : 1)),
+      tiles(static_cast<int>((volume / n + W - 1) / W)),
+      scratch(scratch),
+      in(nullptr),
+      out(nullptr),
+      sign(-1)
+    {
+    }
+
+    /**
+       @brief Set the fields and direction of the next apply: in and
+       out may be the same field
+     */
+    void setData(const complex<Float> *in_, complex<Float> *out_, int sign_)
+    {
+      in = in_;
+      out = out_;
+      sign = sign_;
+    }
+
+    static size_t scratchSize(int n) { return static_cast<size_t>(hostMaxThreads()) * 4 * n * W; }
+
+    void apply(const cudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      parallel_for(tp, 1, tiles, [&](int, int t) {
+#ifdef _OPENMP
+        Float *buf = scratch.data() + static_cast<size_t>(omp_get_thread_num()) * 4 * n * W;
+#else
+        Float *buf = scratch.data();
+#endif
+        if (sign < 0)
+          tile<-1>(t, buf);
+        else
+          tile<+1>(t, buf);
+      });
+    }
+
+    bool hostLaunch() const { return true; }
+
+    TuneKey tuneKey() const
+    {
+      std::stringstream vol, aux;
+      vol << X[0] << "x" << X[1] << "x" << X[2] << "x" << X[3];
+      aux << "dim=" << d << ",prec=" << sizeof(Float) << (in == out ? ",inplace" : "") << getOmpThreadStr();
+      return TuneKey(vol.str().c_str(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    void preTune()
+    {
+      if (in == out) backup.assign(out, out + volume);
+    }
+    void postTune()
+    {
+      if (in == out) std::copy(backup.begin(), backup.end(), out);
+      backup.clear();
+    }
+
+    long long flops() const { return static_cast<long long>(5.0 * volume * std::log2((double)n)); }
+    long long bytes() const { return 4LL * sizeof(Float) * volume; }
+  };
+
+  /**
+     @brief The built-in host FFT: the four dimensions are transformed
+     in turn, the first out of place and the rest in place
+   */
+  template <typename Float> class FFTPlanBuiltin : public FFTPlan
+  {
+    FFT1d<Float> fft[4];
+    std::vector<Float> scratch;
+    std::vector<FFTHostPass<Float>> pass;
+
+    template <int sign> void transform(void *in, void *out)
+    {
+      for (int d = 0; d < 4; d++) {
+        complex<Float> *src = static_cast<complex<Float> *>(d == 0 ? in : out);
+        pass[d].setData(src, static_cast<complex<Float> *>(out), sign);
+        pass[d].apply(0);
+      }
+    }
+
+  public:
+    FFTPlanBuiltin(const int *X, QudaPrecision precision) : FFTPlan(X, precision, FFT_BACKEND_BUILTIN)
+    {
+      int max_n = 1;
+      for (int d = 0; d < 4; d++) {
+        fft[d] = FFT1d<Float>(this->X[d]);
+        max_n = std::max(max_n, this->X[d]);
+      }
+      scratch.resize(FFTHostPass<Float>::scratchSize(max_n));
+      pass.reserve(4);
+      for (int d = 0; d < 4; d++) pass.emplace_back(fft[d], this->X, d, scratch);
+    }
+
+    void forward(void *in, void *out) { transform<-1>(in, out); }
+    void backward(void *in, void *out) { transform<+1>(in, out); }
+
+    long long bytes() const { return 4 * 4LL * sizeof(Float) * volume; }
+  };
+
+#ifdef FFTW_LIB
+
+  template <typename Float> struct FFTW;
+
+  template <> struct FFTW<double> {
+    typedef fftw_complex complex_t;
+    typedef fftw_plan plan_t;
+    static plan_t plan(const int *n, complex_t *in, complex_t *out, int sign, unsigned flags)
+    {
+      return fftw_plan_dft(4, n, in, out, sign, flags);
+    }
+    static void execute(const plan_t p, complex_t *in, complex_t *out) { fftw_execute_dft(p, in, out); }
+    static void destroy(plan_t p) { fftw_destroy_plan(p); }
+    static int alignment(void *p) { return fftw_alignment_of(static_cast<double *>(p)); }
+    static void *malloc(size_t bytes) { return fftw_malloc(bytes); }
+    static void free(void *p) { fftw_free(p); }
+    static void threads(int n)
+    {
+      static bool init = false;
+      if (!init) init = fftw_init_threads();
+      fftw_plan_with_nthreads(n);
+    }
+  };
+
+  template <> struct FFTW<float> {
+    typedef fftwf_complex complex_t;
+    typedef fftwf_plan plan_t;
+    static plan_t plan(const int *n, complex_t *in, complex_t *out, int sign, unsigned flags)
+    {
+      return fftwf_plan_dft(4, n, in, out, sign, flags);
+    }
+    static void execute(const plan_t p, complex_t *in, complex_t *out) { fftwf_execute_dft(p, in, out); }
+    static void destroy(plan_t p) { fftwf_destroy_plan(p); }
+    static int alignment(void *p) { return fftwf_alignment_of(static_cast<float *>(p)); }
+    static void *malloc(size_t bytes) { return fftwf_malloc(bytes); }
+    static void free(void *p) { fftwf_free(p); }
+    static void threads(int n)
+    {
+      static bool init = false;
+      if (!init) init = fftwf_init_threads();
+      fftwf_plan_with_nthreads(n);
+    }
+  };
+
+  /**
+     @brief FFTW backend: threaded 4-d plans, measured on scratch
+     fields at creation.  FFTW may only run a plan on fields with the
+     alignment it was planned for, so fields with another alignment
+     use a second pair of plans made without that assumption.
+   */
+  template <typename Float> class FFTPlanFFTW : public FFTPlan
+  {
+    typedef FFTW<Float> fftw;
+    typedef typename fftw::complex_t complex_t;
+    typedef typename fftw::plan_t plan_t;
+    int n[4];
+    plan_t plan[2];           // forward, backward
+    plan_t plan_unaligned[2]; // made when first needed
+    int alignment;
+
+    void execute(int dir, void *in, void *out)
+    {
+      if (fftw::alignment(in) == alignment && fftw::alignment(out) == alignment) {
+        fftw::execute(plan[dir], static_cast<complex_t *>(in), static_cast<complex_t *>(out));
+      } else {
+        if (!plan_unaligned[dir]) {
+          fftw::threads(hostMaxThreads());
+          plan_unaligned[dir] = fftw::plan(n, static_cast<complex_t *>(in), static_cast<complex_t *>(out),
+                                           dir == 0 ? FFTW_FORWARD : FFTW_BACKWARD, FFTW_ESTIMATE | FFTW_UNALIGNED);
+        }
+        fftw::execute(plan_unaligned[dir], static_cast<complex_t *>(in), static_cast<complex_t *>(out));
+      }
+    }
+
+  public:
+    FFTPlanFFTW(const int *X, QudaPrecision precision) :
+      FFTPlan(X, precision, FFT_BACKEND_FFTW), plan_unaligned {nullptr, nullptr}
+    {
+      for (int d = 0; d < 4; d++) n[d] = this->X[3 - d]; // row-major, x fastest
+      complex_t *in = static_cast<complex_t *>(fftw::malloc(volume * sizeof(complex_t)));
+      complex_t *out = static_cast<complex_t *>(fftw::malloc(volume * sizeof(complex_t)));
+      fftw::threads(hostMaxThreads());
+      plan[0] = fftw::plan(n, in, out, FFTW_FORWARD, FFTW_MEASURE | FFTW_DESTROY_INPUT);
+      plan[1] = fftw::plan(n, in, out, FFTW_BACKWARD, FFTW_MEASURE | FFTW_DESTROY_INPUT);
+      if (!plan[0] || !plan[1]) errorQuda("FFTW planning failed for %dx%dx%dx%d", X[0], X[1], X[2], X[3]);
+      alignment = fftw::alignment(in);
+      fftw::free(out);
+      fftw::free(in);
+    }
+
+    ~FFTPlanFFTW()
+    {
+      for (int dir = 0; dir < 2; dir++) {
+        fftw::destroy(plan[dir]);
+        if (plan_unaligned[dir]) fftw::destroy(plan_unaligned[dir]);
+      }
+    }
+
+    void forward(void *in, void *out) { execute(0, in, out); }
+    void backward(void *in, void *out) { execute(1, in, out); }
+
+    long long bytes() const { return 4 * 4LL * sizeof(Float) * volume; }
+  };
+
+#endif // FFTW_LIB
+
+#ifdef GPU_GAUGE_ALG
+
+  template <typename Float>
+  struct FFTRotateArg {
+    int threads;     // number of active threads required
+    int X[4];     // grid dimensions
+    complex<Float> *tmp0;
+    complex<Float> *tmp1;
+    FFTRotateArg(const int *X_){
+      for ( int dir = 0; dir < 4; ++dir ) X[dir] = X_[dir];
+      threads = X[0] * X[1] * X[2] * X[3];
+      tmp0 = 0;
+      tmp1 = 0;
+    }
+  };
+
+  template <int direction, typename Float>
+  __global__ void fft_rotate_kernel_2D2D(FFTRotateArg<Float> arg){ //Cmplx *data_in, Cmplx *data_out){
+    int id = blockIdx.x * blockDim.x + threadIdx.x;
+    if ( id >= arg.threads ) return;
+    if ( direction == 0 ) {
+      int x3 = id / (arg.X[0] * arg.X[1] * arg.X[2]);
+      int x2 = (id / (arg.X[0] * arg.X[1])) % arg.X[2];
+      int x1 = (id / arg.X[0]) % arg.X[1];
+      int x0 = id % arg.X[0];
+
+      int id  =  x0 + (x1 + (x2 + x3 * arg.X[2]) * arg.X[1]) * arg.X[0];
+      int id_out =  x2 + (x3 +  (x0 + x1 * arg.X[0]) * arg.X[3]) * arg.X[2];
+      arg.tmp1[id_out] = arg.tmp0[id];
+      //data_out[id_out] = data_in[id];
+    }
+    if ( direction == 1 ) {
+
+      int x1 = id / (arg.X[2] * arg.X[3] * arg.X[0]);
+      int x0 = (id / (arg.X[2] * arg.X[3])) % arg.X[0];
+      int x3 = (id / arg.X[2]) % arg.X[3];
+      int x2 = id % arg.X[2];
+
+      int id  =  x2 + (x3 +  (x0 + x1 * arg.X[0]) * arg.X[3]) * arg.X[2];
+      int id_out =  x0 + (x1 + (x2 + x3 * arg.X[2]) * arg.X[1]) * arg.X[0];
+      arg.tmp1[id_out] = arg.tmp0[id];
+      //data_out[id_out] = data_in[id];
+    }
+  }
+
+  template<typename Float>
+  class FFTRotate : Tunable {
+    FFTRotateArg<Float> arg;
+    int direction;
+    mutable char aux_string[128];     // used as a label in the autotuner
+    private:
+    unsigned int sharedBytesPerThread() const {
+      return 0;
+    }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const {
+      return 0;
+    }
+    //bool tuneSharedBytes() const { return false; } // Don't tune shared memory
+    bool tuneGridDim() const {
+      return false;
+    }                                              // Don't tune the grid dimensions.
+    unsigned int minThreads() const {
+      return arg.threads;
+    }
+
+    public:
+    FFTRotate(FFTRotateArg<Float> &arg) : arg(arg) {
+      direction = 0;
+    }
+    ~FFTRotate () {
+    }
+    void setDirection(int dir, complex<Float> *data_in, complex<Float> *data_out){
+      direction = dir;
+      arg.tmp0 = data_in;
+      arg.tmp1 = data_out;
+    }
+
+    void apply(const cudaStream_t &stream){
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      if ( direction == 0 )
+        fft_rotate_kernel_2D2D<0, Float ><< < tp.grid, tp.block, 0, stream >> > (arg);
+      else if ( direction == 1 )
+        fft_rotate_kernel_2D2D<1, Float ><< < tp.grid, tp.block, 0, stream >> > (arg);
+      else
+        errorQuda("Error in FFTRotate option.\n");
+    }
+
+    TuneKey tuneKey() const {
+      std::stringstream vol;
+      vol << arg.X[0] << "x";
+      vol << arg.X[1] << "x";
+      vol << arg.X[2] << "x";
+      vol << arg.X[3];
+      sprintf(aux_string,"threads=%d,prec=%lu", arg.threads, sizeof(Float));
+      return TuneKey(vol.str().c_str(), typeid(*this).name(), aux_string);
+
+    }
+
+    long long flops() const {
+      return 0;
+    }
+    long long bytes() const {
+      return 4LL * sizeof(Float) * arg.threads;
+    }
+
+  };
+
+  /**
+     @brief cuFFT backend: a batched 2-d transform of the xy planes,
+     the hypercube rotated from xyzt to ztxy, and a batched 2-d
+     transform of the zt planes
+   */
+  template <typename Float> class FFTPlanCUFFT : public FFTPlan
+  {
+    typedef typename std::conditional<sizeof(Float) == sizeof(float), float2, double2>::type Complex;
+    cufftHandle plan_xy;
+    cufftHandle plan_zt;
+    FFTRotateArg<Float> arg_rotate;
+    FFTRotate<Float> rotate;
+
+  public:
+    FFTPlanCUFFT(const int *X, QudaPrecision precision) :
+      FFTPlan(X, precision, FFT_BACKEND_CUFFT), arg_rotate(X), rotate(arg_rotate)
+    {
+      int4 size = make_int4(X[0], X[1], X[2], X[3]);
+      SetPlanFFT2DMany(plan_zt, size, 0, static_cast<Complex *>(nullptr)); // for space and time ZT
+      SetPlanFFT2DMany(plan_xy, size, 1, static_cast<Complex *>(nullptr)); // with space only XY
+      layout[0] = 2;
+      layout[1] = 3;
+      layout[2] = 0;
+      layout[3] = 1;
+    }
+
+    ~FFTPlanCUFFT()
+    {
+      CUFFT_SAFE_CALL(cufftDestroy(plan_zt));
+      CUFFT_SAFE_CALL(cufftDestroy(plan_xy));
+    }
+
+    void forward(void *in, void *out)
+    {
+      complex<Float> *in_ = static_cast<complex<Float> *>(in), *out_ = static_cast<complex<Float> *>(out);
+      ApplyFFT(plan_xy, in_, out_, CUFFT_FORWARD);
+      rotate.setDirection(0, out_, in_); // xyzt -> ztxy
+      rotate.apply(0);
+      ApplyFFT(plan_zt, in_, out_, CUFFT_FORWARD);
+    }
+
+    void backward(void *in, void *out)
+    {
+      complex<Float> *in_ = static_cast<complex<Float> *>(in), *out_ = static_cast<complex<Float> *>(out);
+      ApplyFFT(plan_zt, in_, out_, CUFFT_INVERSE);
+      rotate.setDirection(1, out_, in_); // ztxy -> xyzt
+      rotate.apply(0);
+      ApplyFFT(plan_xy, in_, out_, CUFFT_INVERSE);
+    }
+
+    long long bytes() const { return 2 * 4LL * sizeof(Float) * volume + rotate.bytes(); }
+  };
+
+#endif // GPU_GAUGE_ALG
+
+  template <typename Float> FFTPlan *createFFTPlan(FFTBackend backend, const int *X, QudaPrecision precision)
+  {
+    switch (backend) {
+    case FFT_BACKEND_CUFFT:
+#ifdef GPU_GAUGE_ALG
+      return new FFTPlanCUFFT<Float>(X, precision);
+#else
+      errorQuda("cuFFT backend has not been built");
+#endif
+    case FFT_BACKEND_BUILTIN: return new FFTPlanBuiltin<Float>(X, precision);
+    case FFT_BACKEND_FFTW:
+#ifdef FFTW_LIB
+      return new FFTPlanFFTW<Float>(X, precision);
+#else
+      errorQuda("FFTW backend has not been built");
+#endif
+    default: errorQuda("FFT backend %d not supported", backend);
+    }
+    return nullptr;
+  }
+
+  FFTPlan *FFTPlan::create(FFTBackend backend, const int *X, QudaPrecision precision)
+  {
+    if (precision == QUDA_DOUBLE_PRECISION) {
+      return createFFTPlan<double>(backend, X, precision);
+    } else if (precision == QUDA_SINGLE_PRECISION) {
+      return createFFTPlan<float>(backend, X, precision);
+    } else {
+      errorQuda("Precision %d not supported", precision);
+    }
+    return nullptr;
+  }
+
+} // namespace quda
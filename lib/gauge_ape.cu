@@ -6,6 +6,7 @@
 #define  SINGLE_TOL	2e-6
 
 #include <jitify_helper.cuh>
+#include <host_parallel.h>
 #include <kernels/gauge_ape.cuh>
 
 namespace quda {
@@ -33,8 +34,8 @@ public:
 
     void apply(const cudaStream_t &stream)
     {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
-        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 #ifdef JITIFY
         using namespace jitify::reflection;
         jitify_error = program->kernel("quda::computeAPEStep")
@@ -45,15 +46,19 @@ public:
         computeAPEStep<Float><<<tp.grid, tp.block, tp.shared_bytes>>>(arg);
 #endif
       } else {
-        errorQuda("CPU not supported yet\n");
-        // computeAPEStepCPU(arg);
+        parallel_for(tp, 2, arg.threads, [&](int parity, int idx) {
+          for (int dir = 0; dir < 3; dir++) apeSite<Float>(arg, idx, parity, dir);
+        });
       }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const
     {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec=" << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -65,28 +70,41 @@ public:
   }; // GaugeAPE
 
   template<typename Float,typename GaugeOr, typename GaugeDs>
-  void APEStep(GaugeOr origin, GaugeDs dest, const GaugeField& dataOr, Float alpha) {
-    GaugeAPEArg<Float,GaugeOr,GaugeDs> arg(origin, dest, dataOr, alpha, dataOr.Precision() == QUDA_DOUBLE_PRECISION ? DOUBLE_TOL : SINGLE_TOL);
+  void APEStep(GaugeOr origin, GaugeDs dest, const GaugeField& dataOr, Float alpha, const int *halo) {
+    GaugeAPEArg<Float,GaugeOr,GaugeDs> arg(origin, dest, dataOr, alpha, dataOr.Precision() == QUDA_DOUBLE_PRECISION ? DOUBLE_TOL : SINGLE_TOL, halo);
     GaugeAPE<Float, GaugeAPEArg<Float, GaugeOr, GaugeDs>> gaugeAPE(arg, dataOr);
     gaugeAPE.apply(0);
-    qudaDeviceSynchronize();
+    if (dataOr.Location() == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
   }
 
-  template <typename Float> void APEStep(GaugeField &dataDs, const GaugeField &dataOr, Float alpha)
+  template <typename Float> void APEStep(GaugeField &dataDs, const GaugeField &dataOr, Float alpha, const int *halo)
   {
 
+    if (dataDs.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (dataDs.Order() == QUDA_QDP_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type G;
+        APEStep(G(dataOr), G(dataDs), dataOr, alpha, halo);
+      } else if (dataDs.Order() == QUDA_MILC_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type G;
+        APEStep(G(dataOr), G(dataDs), dataOr, alpha, halo);
+      } else {
+        errorQuda("Gauge field order %d not supported on the host", dataDs.Order());
+      }
+      return;
+    }
+
     if(dataDs.Reconstruct() == QUDA_RECONSTRUCT_NO) {
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GDs;
 
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
       }
@@ -94,13 +112,13 @@ public:
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GDs;
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
       }
@@ -108,13 +126,13 @@ public:
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GDs;
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha);
+	APEStep(GOr(dataOr), GDs(dataDs), dataOr, alpha, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
             }
@@ -125,7 +143,7 @@ public:
 
 #endif
 
-  void APEStep(GaugeField &dataDs, const GaugeField& dataOr, double alpha) {
+  void APEStep(GaugeField &dataDs, const GaugeField& dataOr, double alpha, const int *halo) {
 
 #ifdef GPU_GAUGE_TOOLS
 
@@ -137,16 +155,29 @@ public:
       errorQuda("Half precision not supported\n");
     }
 
-    if (!dataOr.isNative())
-      errorQuda("Order %d with %d reconstruct not supported", dataOr.Order(), dataOr.Reconstruct());
+    if (dataOr.Location() != dataDs.Location())
+      errorQuda("Origin and destination fields must have the same location");
 
-    if (!dataDs.isNative())
-      errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+    if (dataDs.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      if (!dataOr.isNative())
+        errorQuda("Order %d with %d reconstruct not supported", dataOr.Order(), dataOr.Reconstruct());
+
+      if (!dataDs.isNative())
+        errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+    } else {
+      if (dataOr.Order() != dataDs.Order() || dataDs.Reconstruct() != QUDA_RECONSTRUCT_NO
+          || dataOr.Reconstruct() != QUDA_RECONSTRUCT_NO)
+        errorQuda("Orders %d %d with %d %d reconstruct not supported", dataOr.Order(), dataDs.Order(),
+                  dataOr.Reconstruct(), dataDs.Reconstruct());
+
+      if (dataOr.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER || dataDs.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+        errorQuda("Site orders %d %d not supported", dataOr.SiteOrder(), dataDs.SiteOrder());
+    }
 
     if (dataDs.Precision() == QUDA_SINGLE_PRECISION){
-      APEStep<float>(dataDs, dataOr, (float) alpha);
+      APEStep<float>(dataDs, dataOr, (float) alpha, halo);
     } else if(dataDs.Precision() == QUDA_DOUBLE_PRECISION) {
-      APEStep<double>(dataDs, dataOr, alpha);
+      APEStep<double>(dataDs, dataOr, alpha, halo);
     } else {
       errorQuda("Precision %d not supported", dataDs.Precision());
     }
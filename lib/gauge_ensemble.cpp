@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <future>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <gauge_ensemble.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+namespace quda
+{
+
+  GaugeOperation GaugeOperation::ape(int n_steps, double alpha)
+  {
+    GaugeOperation op = {};
+    op.type = APE;
+    op.n_steps = n_steps;
+    op.alpha = alpha;
+    return op;
+  }
+
+  GaugeOperation GaugeOperation::stout(int n_steps, double rho)
+  {
+    GaugeOperation op = {};
+    op.type = STOUT;
+    op.n_steps = n_steps;
+    op.rho = rho;
+    return op;
+  }
+
+  GaugeOperation GaugeOperation::ovrImpStout(int n_steps, double rho, double epsilon)
+  {
+    GaugeOperation op = {};
+    op.type = OVRIMP_STOUT;
+    op.n_steps = n_steps;
+    op.rho = rho;
+    op.epsilon = epsilon;
+    return op;
+  }
+
+  GaugeOperation GaugeOperation::wflow(QudaWFlowType flow_type, double t_max, double step, double tolerance,
+                                       int meas_interval)
+  {
+    GaugeOperation op = {};
+    op.type = WFLOW;
+    op.flow_type = flow_type;
+    op.t_max = t_max;
+    op.step = step;
+    op.tolerance = tolerance;
+    op.meas_interval = meas_interval;
+    return op;
+  }
+
+  GaugeOperation GaugeOperation::measure()
+  {
+    GaugeOperation op = {};
+    op.type = MEASURE;
+    return op;
+  }
+
+  static const char *operation_str(GaugeOperation::Type type)
+  {
+    switch (type) {
+    case GaugeOperation::APE: return "ape";
+    case GaugeOperation::STOUT: return "stout";
+    case GaugeOperation::OVRIMP_STOUT: return "ovrimp_stout";
+    case GaugeOperation::WFLOW: return "wflow";
+    case GaugeOperation::MEASURE: return "measure";
+    default: errorQuda("Unknown gauge operation %d", type);
+    }
+    return nullptr;
+  }
+
+  /**
+     @brief The leading fields of a record: the configuration, the
+     stage and its type, with the file name escaped as a JSON string
+  */
+  static std::string recordHeader(int config, const std::string &file, int op, GaugeOperation::Type type)
+  {
+    std::string name;
+    for (char c : file) {
+      if (c == '"' || c == '\\') name += '\\';
+      name += c;
+    }
+    char head[64];
+    snprintf(head, sizeof(head), "\"op\": %d, \"type\": \"%s\"", op, operation_str(type));
+    return "{\"config\": " + std::to_string(config) + ", \"file\": \"" + name + "\", " + head;
+  }
+
+  static void writeMeasurement(std::ostream &out, const std::string &header, const GaugeObservables &obs)
+  {
+    if (comm_rank() != 0) return;
+    char body[512];
+    snprintf(body, sizeof(body),
+             ", \"plaquette\": [%.16e, %.16e, %.16e], \"polyakov_loop\": [%.16e, %.16e], \"rectangle\": %.16e, "
+             "\"E\": %.16e, \"Q\": %.16e}\n",
+             obs.plaquette.x, obs.plaquette.y, obs.plaquette.z, obs.polyakov_loop.x, obs.polyakov_loop.y,
+             obs.rectangle, obs.E, obs.Q);
+    out << header << body;
+  }
+
+  static void writeFlowMeasurement(std::ostream &out, const std::string &header, const WFlowObservables &obs)
+  {
+    if (comm_rank() != 0) return;
+    char body[256];
+    snprintf(body, sizeof(body),
+             ", \"t\": %.16e, \"plaquette\": %.16e, \"E_plaq\": %.16e, \"E\": %.16e, \"t2E\": %.16e, \"Q\": %.16e}\n",
+             obs.t, obs.plaquette, obs.E_plaq, obs.E_clover, obs.t * obs.t * obs.E_clover, obs.Q);
+    out << header << body;
+  }
+
+  static void checkOperation(const GaugeOperation &op)
+  {
+    switch (op.type) {
+    case GaugeOperation::APE:
+    case GaugeOperation::STOUT:
+    case GaugeOperation::OVRIMP_STOUT:
+      if (op.n_steps < 0) errorQuda("Invalid number of smearing steps %d", op.n_steps);
+      break;
+    case GaugeOperation::WFLOW:
+      if (op.t_max < 0.0 || op.step <= 0.0 || op.tolerance < 0.0 || op.meas_interval < 0)
+        errorQuda("Invalid flow parameters t_max=%e step=%e tolerance=%e meas_interval=%d", op.t_max, op.step,
+                  op.tolerance, op.meas_interval);
+      break;
+    case GaugeOperation::MEASURE: break;
+    default: errorQuda("Unknown gauge operation %d", op.type);
+    }
+  }
+
+  EnsembleSummary analyzeEnsemble(const std::vector<std::string> &files, const std::vector<GaugeOperation> &pipeline,
+                                  const QudaGaugeParam &param, const GaugeReader &reader, std::ostream &out,
+                                  QudaFieldLocation location, bool prefetch)
+  {
+    EnsembleSummary summary = {};
+    if (param.gauge_order != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Configurations must be read in QDP order, not %d", param.gauge_order);
+    if (location != QUDA_CPU_FIELD_LOCATION && location != QUDA_CUDA_FIELD_LOCATION)
+      errorQuda("Invalid location %d", location);
+    for (auto &op : pipeline) checkOperation(op);
+    if (files.empty()) return summary;
+
+    Timer total, wait, compute;
+    total.Start(__func__, __FILE__, __LINE__);
+
+    // the two read buffers, alternating between configurations
+    GaugeFieldParam bufferParam(nullptr, param);
+    bufferParam.create = QUDA_NULL_FIELD_CREATE;
+    bufferParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    GaugeField *buffer[2] = {GaugeField::Create(bufferParam), prefetch ? GaugeField::Create(bufferParam) : nullptr};
+    if (!prefetch) buffer[1] = buffer[0];
+
+    // the fields the pipeline works on
+    GaugeFieldParam workParam(bufferParam);
+    workParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+    workParam.link_type = QUDA_WILSON_LINKS;
+    if (location == QUDA_CUDA_FIELD_LOCATION) {
+      workParam.location = QUDA_CUDA_FIELD_LOCATION;
+      workParam.reconstruct = QUDA_RECONSTRUCT_NO;
+      workParam.pad = 0;
+      workParam.setPrecision(param.cuda_prec, true);
+    }
+    GaugeField *work = GaugeField::Create(workParam);
+    GaugeField *tmp = GaugeField::Create(workParam);
+    GaugeField *host = nullptr; // host copy for measuring device fields
+
+    // each read records its own time, collected once it has completed
+    double read_secs[2] = {0.0, 0.0};
+    auto read = [&](int i) {
+      Timer timer;
+      timer.Start(__func__, __FILE__, __LINE__);
+      reader(files[i], static_cast<void **>(buffer[i % 2]->Gauge_p()));
+      timer.Stop(__func__, __FILE__, __LINE__);
+      read_secs[i % 2] = timer.Last();
+    };
+
+    std::future<void> pending;
+    if (prefetch) pending = std::async(std::launch::async, read, 0);
+
+    for (int i = 0; i < (int)files.size(); i++) {
+      wait.Start(__func__, __FILE__, __LINE__);
+      if (prefetch) {
+        pending.get();
+      } else {
+        read(i);
+      }
+      wait.Stop(__func__, __FILE__, __LINE__);
+      summary.read_secs += read_secs[i % 2];
+
+      compute.Start(__func__, __FILE__, __LINE__);
+      work->copy(*buffer[i % 2]);
+
+      // the other buffer is free once its configuration has been copied
+      if (prefetch && i + 1 < (int)files.size()) pending = std::async(std::launch::async, read, i + 1);
+
+      for (int k = 0; k < (int)pipeline.size(); k++) {
+        const GaugeOperation &op = pipeline[k];
+        const std::string header = recordHeader(i, files[i], k, op.type);
+
+        switch (op.type) {
+        case GaugeOperation::APE:
+          APEnStep(*tmp, *work, op.n_steps, op.alpha);
+          std::swap(work, tmp);
+          break;
+        case GaugeOperation::STOUT:
+          STOUTnStep(*tmp, *work, op.n_steps, op.rho);
+          std::swap(work, tmp);
+          break;
+        case GaugeOperation::OVRIMP_STOUT:
+          OvrImpSTOUTnStep(*tmp, *work, op.n_steps, op.rho, op.epsilon);
+          std::swap(work, tmp);
+          break;
+        case GaugeOperation::WFLOW: {
+          std::vector<WFlowObservables> obs
+            = WFlow(*tmp, *work, op.flow_type, op.t_max, op.step, op.tolerance, op.meas_interval);
+          std::swap(work, tmp);
+          for (auto &o : obs) writeFlowMeasurement(out, header, o);
+          break;
+        }
+        case GaugeOperation::MEASURE: {
+          const GaugeField *u = work;
+          if (location == QUDA_CUDA_FIELD_LOCATION) {
+            if (!host) {
+              GaugeFieldParam hostParam(bufferParam);
+              hostParam.setPrecision(param.cuda_prec);
+              host = GaugeField::Create(hostParam);
+            }
+            host->copy(*work);
+            u = host;
+          }
+          writeMeasurement(out, header, gaugeObservables(*u));
+          break;
+        }
+        default: errorQuda("Unknown gauge operation %d", op.type);
+        }
+      }
+
+      if (comm_rank() == 0) out.flush();
+      compute.Stop(__func__, __FILE__, __LINE__);
+      summary.n_configs++;
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+        printfQuda("analyzeEnsemble: configuration %d (%s) read in %.3f s, waited %.3f s, processed in %.3f s\n", i,
+                   files[i].c_str(), read_secs[i % 2], wait.Last(), compute.Last());
+    }
+
+    total.Stop(__func__, __FILE__, __LINE__);
+    summary.wait_secs = wait.time;
+    summary.compute_secs = compute.time;
+    summary.total_secs = total.time;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("analyzeEnsemble: %d configurations in %.3f s: read %.3f s, waited for reads %.3f s, pipeline %.3f s\n",
+                 summary.n_configs, summary.total_secs, summary.read_secs, summary.wait_secs, summary.compute_secs);
+
+    if (host) delete host;
+    delete tmp;
+    delete work;
+    if (prefetch) delete buffer[1];
+    delete buffer[0];
+
+    return summary;
+  }
+
+} // namespace quda
@@ -24,7 +24,8 @@ namespace quda {
     staggeredPhaseApplied(u.StaggeredPhaseApplied()),
     i_mu(u.iMu()),
     site_offset(u.SiteOffset()),
-    site_size(u.SiteSize())
+    site_size(u.SiteSize()),
+    siteOrder(u.SiteOrder())
   { }
 
   GaugeField::GaugeField(const GaugeFieldParam &param) :
@@ -49,7 +50,8 @@ namespace quda {
     staggeredPhaseApplied(param.staggeredPhaseApplied),
     i_mu(param.i_mu),
     site_offset(param.site_offset),
-    site_size(param.site_size)
+    site_size(param.site_size),
+    siteOrder(param.siteOrder)
   {
     if (ghost_precision != precision) ghost_precision = precision; // gauge fields require matching precision
 
@@ -297,6 +299,7 @@ namespace quda {
     output << "geometry = " << param.geometry << std::endl;
     output << "staggeredPhaseType = " << param.staggeredPhaseType << std::endl;
     output << "staggeredPhaseApplied = " << param.staggeredPhaseApplied << std::endl;
+    output << "siteOrder = " << param.siteOrder << std::endl;
 
     return output;  // for multiple << operators.
   }
@@ -2,6 +2,7 @@
 #include <gauge_field.h>
 
 #include <jitify_helper.cuh>
+#include <host_parallel.h>
 #include <kernels/field_strength_tensor.cuh>
 
 namespace quda
@@ -21,7 +22,8 @@ private:
 public:
     FmunuCompute(Arg &arg, const GaugeField &meta) : TunableVectorYZ(2, 6), arg(arg), meta(meta)
     {
-      writeAuxString("threads=%d,stride=%d,prec=%lu", arg.threads, meta.Stride(), sizeof(Float));
+      writeAuxString("threads=%d,stride=%d,prec=%lu%s", arg.threads, meta.Stride(), sizeof(Float),
+                     hostLaunch() ? getOmpThreadStr() : "");
       if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
 #ifdef JITIFY
         create_jitify_program("kernels/field_strength_tensor.cuh");
@@ -44,10 +46,15 @@ public:
         computeFmunuKernel<Float><<<tp.grid, tp.block, tp.shared_bytes>>>(arg);
 #endif
       } else {
-        computeFmunuCPU<Float>(arg);
+        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+        parallel_for(tp, 2, arg.threads, [&](int parity, int x_cb) {
+          for (int mu_nu = 0; mu_nu < 6; mu_nu++) computeFmunuSite<Float>(arg, x_cb, parity, mu_nu);
+        });
       }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
 
     long long flops() const { return (2430 + 36) * 6 * 2 * (long long)arg.threads; }
@@ -64,13 +71,30 @@ public:
     FmunuArg<Float, Fmunu, Gauge> arg(f_munu, gauge, meta, meta_ex);
     FmunuCompute<Float, FmunuArg<Float, Fmunu, Gauge>> fmunuCompute(arg, meta);
     fmunuCompute.apply(0);
-    qudaDeviceSynchronize();
-    checkCudaError();
+    if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      qudaDeviceSynchronize();
+      checkCudaError();
+    }
   }
 
   template <typename Float> void computeFmunu(GaugeField &Fmunu, const GaugeField &gauge)
   {
-    if (Fmunu.Order() == QUDA_FLOAT2_GAUGE_ORDER) {
+    if (Fmunu.Location() == QUDA_CPU_FIELD_LOCATION) {
+      // host tensors are stored in MILC order, the only host order
+      // that holds more than four links per site
+      if (Fmunu.Order() != QUDA_MILC_GAUGE_ORDER) errorQuda("Fmunu field order %d not supported", Fmunu.Order());
+      typedef typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type F;
+
+      if (gauge.Order() == QUDA_QDP_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, 3>::type G;
+        computeFmunu<Float>(F(Fmunu), G(gauge), Fmunu, gauge);
+      } else if (gauge.Order() == QUDA_MILC_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type G;
+        computeFmunu<Float>(F(Fmunu), G(gauge), Fmunu, gauge);
+      } else {
+        errorQuda("Gauge field order %d not supported on the host", gauge.Order());
+      }
+    } else if (Fmunu.Order() == QUDA_FLOAT2_GAUGE_ORDER) {
       if (gauge.isNative()) {
         typedef gauge::FloatNOrder<Float, 18, 2, 18> F;
 
@@ -103,14 +127,31 @@ public:
     if (Fmunu.Precision() != gauge.Precision()) {
       errorQuda("Fmunu precision %d must match gauge precision %d", Fmunu.Precision(), gauge.Precision());
     }
+    if (Fmunu.Location() != gauge.Location()) errorQuda("Fmunu and gauge field must have the same location");
+
+    // host fields need not come extended: add the halo here
+    const GaugeField *u = &gauge;
+    if (gauge.Location() == QUDA_CPU_FIELD_LOCATION && gauge.GhostExchange() != QUDA_GHOST_EXCHANGE_EXTENDED) {
+      if (gauge.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Site order %d not supported", gauge.SiteOrder());
+      // one site suffices, but an odd depth would flip the halo parity
+      int R[4];
+      for (int d = 0; d < 4; d++) {
+        R[d] = comm_dim_partitioned(d) ? 2 : 0;
+        if (R[d] > gauge.X()[d])
+          errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", R[d], gauge.X()[d], d);
+      }
+      if (R[0] || R[1] || R[2] || R[3]) u = extendGaugeField(gauge, R);
+    }
 
     if (gauge.Precision() == QUDA_DOUBLE_PRECISION) {
-      computeFmunu<double>(Fmunu, gauge);
+      computeFmunu<double>(Fmunu, *u);
     } else if (gauge.Precision() == QUDA_SINGLE_PRECISION) {
-      computeFmunu<float>(Fmunu, gauge);
+      computeFmunu<float>(Fmunu, *u);
     } else {
       errorQuda("Precision %d not supported", gauge.Precision());
     }
+
+    if (u != &gauge) delete u;
     return;
 #else
     errorQuda("Gauge tools are not built");
@@ -9,11 +9,9 @@
 #include <cub_helper.cuh>
 #include <index_helper.cuh>
 
-#include <cufft.h>
-
-#ifdef GPU_GAUGE_ALG
-#include <CUFFT_Plans.h>
-#endif
+#include <host_parallel.h>
+#include <fft_quda.h>
+#include <gauge_tools.h>
 
 namespace quda {
 
@@ -117,119 +115,6 @@ namespace quda {
   }
 
 
-  template <typename Float>
-  struct GaugeFixFFTRotateArg {
-    int threads;     // number of active threads required
-    int X[4];     // grid dimensions
-    complex<Float> *tmp0;
-    complex<Float> *tmp1;
-    GaugeFixFFTRotateArg(const cudaGaugeField &data){
-      for ( int dir = 0; dir < 4; ++dir ) X[dir] = data.X()[dir];
-      threads = X[0] * X[1] * X[2] * X[3];
-      tmp0 = 0;
-      tmp1 = 0;
-    }
-  };
-
-
-
-  template <int direction, typename Float>
-  __global__ void fft_rotate_kernel_2D2D(GaugeFixFFTRotateArg<Float> arg){ //Cmplx *data_in, Cmplx *data_out){
-    int id = blockIdx.x * blockDim.x + threadIdx.x;
-    if ( id >= arg.threads ) return;
-    if ( direction == 0 ) {
-      int x3 = id / (arg.X[0] * arg.X[1] * arg.X[2]);
-      int x2 = (id / (arg.X[0] * arg.X[1])) % arg.X[2];
-      int x1 = (id / arg.X[0]) % arg.X[1];
-      int x0 = id % arg.X[0];
-
-      int id  =  x0 + (x1 + (x2 + x3 * arg.X[2]) * arg.X[1]) * arg.X[0];
-      int id_out =  x2 + (x3 +  (x0 + x1 * arg.X[0]) * arg.X[3]) * arg.X[2];
-      arg.tmp1[id_out] = arg.tmp0[id];
-      //data_out[id_out] = data_in[id];
-    }
-    if ( direction == 1 ) {
-
-      int x1 = id / (arg.X[2] * arg.X[3] * arg.X[0]);
-      int x0 = (id / (arg.X[2] * arg.X[3])) % arg.X[0];
-      int x3 = (id / arg.X[2]) % arg.X[3];
-      int x2 = id % arg.X[2];
-
-      int id  =  x2 + (x3 +  (x0 + x1 * arg.X[0]) * arg.X[3]) * arg.X[2];
-      int id_out =  x0 + (x1 + (x2 + x3 * arg.X[2]) * arg.X[1]) * arg.X[0];
-      arg.tmp1[id_out] = arg.tmp0[id];
-      //data_out[id_out] = data_in[id];
-    }
-  }
-
-
-
-
-
-
-  template<typename Float>
-  class GaugeFixFFTRotate : Tunable {
-    GaugeFixFFTRotateArg<Float> arg;
-    int direction;
-    mutable char aux_string[128];     // used as a label in the autotuner
-    private:
-    unsigned int sharedBytesPerThread() const {
-      return 0;
-    }
-    unsigned int sharedBytesPerBlock(const TuneParam &param) const {
-      return 0;
-    }
-    //bool tuneSharedBytes() const { return false; } // Don't tune shared memory
-    bool tuneGridDim() const {
-      return false;
-    }                                              // Don't tune the grid dimensions.
-    unsigned int minThreads() const {
-      return arg.threads;
-    }
-
-    public:
-    GaugeFixFFTRotate(GaugeFixFFTRotateArg<Float> &arg) : arg(arg) {
-      direction = 0;
-    }
-    ~GaugeFixFFTRotate () {
-    }
-    void setDirection(int dir, complex<Float> *data_in, complex<Float> *data_out){
-      direction = dir;
-      arg.tmp0 = data_in;
-      arg.tmp1 = data_out;
-    }
-
-    void apply(const cudaStream_t &stream){
-      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      if ( direction == 0 )
-        fft_rotate_kernel_2D2D<0, Float ><< < tp.grid, tp.block, 0, stream >> > (arg);
-      else if ( direction == 1 )
-        fft_rotate_kernel_2D2D<1, Float ><< < tp.grid, tp.block, 0, stream >> > (arg);
-      else
-        errorQuda("Error in GaugeFixFFTRotate option.\n");
-    }
-
-    TuneKey tuneKey() const {
-      std::stringstream vol;
-      vol << arg.X[0] << "x";
-      vol << arg.X[1] << "x";
-      vol << arg.X[2] << "x";
-      vol << arg.X[3];
-      sprintf(aux_string,"threads=%d,prec=%lu", arg.threads, sizeof(Float));
-      return TuneKey(vol.str().c_str(), typeid(*this).name(), aux_string);
-
-    }
-
-    long long flops() const {
-      return 0;
-    }
-    long long bytes() const {
-      return 4LL * sizeof(Float) * arg.threads;
-    }
-
-  };
-
-
   template <typename Float, typename Gauge>
   struct GaugeFixQualityArg : public ReduceArg<double2> {
     int threads;     // number of active threads required
@@ -246,6 +131,42 @@ namespace quda {
     double getTheta(){ return result_h[0].y; }
   };
 
+  /**
+     @brief Compute Delta(x) = A(x) - A(x - mu) at a site, the
+     traceless anti-hermitian part of the divergence of the links,
+     with the site's contributions to the gauge functional and theta
+     @return (functional, theta) of the site
+   */
+  template <typename Float, typename Gauge, int gauge_dir>
+  __host__ __device__ inline double2 siteDelta(Matrix<complex<Float>,3> &delta, Gauge &dataOr, int x[4],
+                                               const int X[4], int idx_cb, int parity){
+    typedef complex<Float> Cmplx;
+    double2 data = make_double2(0.0,0.0);
+    setZero(&delta);
+    for ( int mu = 0; mu < gauge_dir; mu++ ) {
+      Matrix<Cmplx,3> U;
+      dataOr.load((Float *)(U.data), idx_cb, mu, parity);
+      delta -= U;
+    }
+    //18*gauge_dir
+    data.x = -delta(0, 0).x - delta(1, 1).x - delta(2, 2).x;
+    //2
+    for ( int mu = 0; mu < gauge_dir; mu++ ) {
+      Matrix<Cmplx,3> U;
+      dataOr.load((Float*)(U.data),linkIndexM1(x,X,mu), mu, 1 - parity);
+      delta += U;
+    }
+    //18*gauge_dir
+    delta -= conj(delta);
+    //18
+    SubTraceUnit(delta);
+    //12
+    data.y = getRealTraceUVdagger(delta, delta);
+    //35
+    //T=36*gauge_dir+65
+    return data;
+  }
+
   template<int blockSize, int Elems, typename Float, typename Gauge, int gauge_dir>
   __global__ void computeFix_quality(GaugeFixQualityArg<Float, Gauge> argQ){
     int idx_cb = threadIdx.x + blockIdx.x * blockDim.x;
@@ -258,26 +179,10 @@ namespace quda {
       int x[4];
       getCoords(x, idx_cb, argQ.X, parity);
       Matrix<Cmplx,3> delta;
-      setZero(&delta);
-      //idx = linkIndex(x,X);
-      for ( int mu = 0; mu < gauge_dir; mu++ ) {
-        Matrix<Cmplx,3> U;
-        argQ.dataOr.load((Float *)(U.data), idx_cb, mu, parity);
-        delta -= U;
-      }
-      //18*gauge_dir
-      data.x += -delta(0, 0).x - delta(1, 1).x - delta(2, 2).x;
-      //2
-      for ( int mu = 0; mu < gauge_dir; mu++ ) {
-        Matrix<Cmplx,3> U;
-        argQ.dataOr.load((Float*)(U.data),linkIndexM1(x,argQ.X,mu), mu, 1 - parity);
-        delta += U;
-      }
-      //18*gauge_dir
-      delta -= conj(delta);
-      //18
+      double2 site = siteDelta<Float, Gauge, gauge_dir>(delta, argQ.dataOr, x, argQ.X, idx_cb, parity);
+      data.x += site.x;
+      data.y += site.y;
       //SAVE DELTA!!!!!
-      SubTraceUnit(delta);
       int idx = getIndexFull(idx_cb, argQ.X, parity);
       //Saving Delta
       argQ.delta[idx] = delta(0,0);
@@ -286,10 +191,6 @@ namespace quda {
       argQ.delta[idx + 6 * argQ.threads] = delta(1,1);
       argQ.delta[idx + 8 * argQ.threads] = delta(1,2);
       argQ.delta[idx + 10 * argQ.threads] = delta(2,2);
-      //12
-      data.y += getRealTraceUVdagger(delta, delta);
-      //35
-      //T=36*gauge_dir+65
 
       idx_cb += blockDim.x * gridDim.x;
     }
@@ -553,6 +454,26 @@ namespace quda {
     //T=130
   }
 
+  /**
+     @brief The gauge transformation g(x) = 1 + alpha/2 Delta(x),
+     projected back onto SU(3), from the six elements of the upper
+     triangle of Delta(x) stored in de
+   */
+  template <typename Float>
+  __host__ __device__ inline Matrix<complex<Float>,3> deltaRotation( Matrix<complex<Float>,3> &de, Float half_alpha ){
+    typedef complex<Float> Cmplx;
+    de(1,0) = Cmplx(-de(0,1).x, de(0,1).y);
+    de(2,0) = Cmplx(-de(0,2).x, de(0,2).y);
+    de(2,1) = Cmplx(-de(1,2).x, de(1,2).y);
+    Matrix<Cmplx,3> g;
+    setIdentity(&g);
+    g += de * half_alpha;
+    //36
+    reunit_link<Float>( g );
+    //130
+    return g;
+  }
+
 #ifdef GAUGEFIXING_DONT_USE_GX
 
   template <typename Float, typename Gauge>
@@ -584,15 +505,8 @@ namespace quda {
     de(1,2) = arg.delta[idx + 4 * arg.threads];
     de(2,2) = arg.delta[idx + 5 * arg.threads];
 #endif
-    de(1,0) = Cmplx(-de(0,1).x, de(0,1).y);
-    de(2,0) = Cmplx(-de(0,2).x, de(0,2).y);
-    de(2,1) = Cmplx(-de(1,2).x, de(1,2).y);
-    Matrix<Cmplx,3> g;
-    setIdentity(&g);
-    g += de * half_alpha;
-    //36
-    reunit_link<Float>( g );
-    //130
+    Matrix<Cmplx,3> g = deltaRotation<Float>(de, half_alpha);
+    //166
 
 
     for ( int mu = 0; mu < 4; mu++ ) {
@@ -618,15 +532,8 @@ namespace quda {
       de(1,2) = arg.delta[idx + 4 * arg.threads];
       de(2,2) = arg.delta[idx + 5 * arg.threads];
 #endif
-      de(1,0) = Cmplx(-de(0,1).x, de(0,1).y);
-      de(2,0) = Cmplx(-de(0,2).x, de(0,2).y);
-      de(2,1) = Cmplx(-de(1,2).x, de(1,2).y);
-
-      setIdentity(&g0);
-      g0 += de * half_alpha;
-      //36
-      reunit_link<Float>( g0 );
-      //130
+      g0 = deltaRotation<Float>(de, half_alpha);
+      //166
 
       U = U * conj(g0);
       //198
@@ -938,7 +845,7 @@ namespace quda {
   void gaugefixingFFT( Gauge dataOr,  cudaGaugeField& data, \
                        const int Nsteps, const int verbose_interval, \
                        const Float alpha0, const int autotune, const double tolerance, \
-                       const int stopWtheta) {
+                       const int stopWtheta, GaugeFixHistory *history) {
 
     TimeProfile profileInternalGaugeFixFFT("InternalGaugeFixQudaFFT", false);
 
@@ -956,17 +863,10 @@ namespace quda {
 
 
     unsigned int delta_pad = data.X()[0] * data.X()[1] * data.X()[2] * data.X()[3];
-    int4 size = make_int4( data.X()[0], data.X()[1], data.X()[2], data.X()[3] );
-    cufftHandle plan_xy;
-    cufftHandle plan_zt;
 
     GaugeFixArg<Float> arg(data, Elems);
-    SetPlanFFT2DMany( plan_zt, size, 0, arg.delta);     //for space and time ZT
-    SetPlanFFT2DMany( plan_xy, size, 1, arg.delta);    //with space only XY
-
-
-    GaugeFixFFTRotateArg<Float> arg_rotate(data);
-    GaugeFixFFTRotate<Float> GFRotate(arg_rotate);
+    // the momentum-space field is in ztxy order, as assumed by GaugeFixSETINVPSP
+    FFTPlan *fft = FFTPlan::create(FFT_BACKEND_CUFFT, data.X(), data.Precision());
 
     GaugeFixSETINVPSP<Float> setinvpsp(arg);
     setinvpsp.apply(0);
@@ -988,6 +888,7 @@ namespace quda {
     gfixquality.apply(0);
     double action0 = argQ.getAction();
     printf("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, argQ.getAction(), argQ.getTheta());
+    if ( history ) history->steps.push_back({0, argQ.getAction(), argQ.getTheta(), 0.0});
 
     double diff = 0.0;
     int iter = 0;
@@ -999,37 +900,18 @@ namespace quda {
         // it uses gx as temporary array!!!!!!
         //------------------------------------------------------------------------
         complex<Float> *_array = arg.delta + k * delta_pad;
-        //////  2D FFT + 2D FFT
-        //------------------------------------------------------------------------
-        // Perform FFT on xy plane
         //------------------------------------------------------------------------
-        ApplyFFT(plan_xy, _array, arg.gx, CUFFT_FORWARD);
+        // Perform FFT, 2D FFT on xy planes, rotation to ztxy and 2D FFT on zt planes
         //------------------------------------------------------------------------
-        // Rotate hypercube, xyzt -> ztxy
-        //------------------------------------------------------------------------
-        GFRotate.setDirection(0, arg.gx, _array);
-        GFRotate.apply(0);
-        //------------------------------------------------------------------------
-        // Perform FFT on zt plane
-        //------------------------------------------------------------------------
-        ApplyFFT(plan_zt, _array, arg.gx, CUFFT_FORWARD);
+        fft->forward(_array, arg.gx);
         //------------------------------------------------------------------------
         // Normalize FFT and apply pmax^2/p^2
         //------------------------------------------------------------------------
         invpsp.apply(0);
         //------------------------------------------------------------------------
-        // Perform IFFT on zt plane
-        //------------------------------------------------------------------------
-        ApplyFFT(plan_zt, arg.gx, _array, CUFFT_INVERSE);
-        //------------------------------------------------------------------------
-        // Rotate hypercube, ztxy -> xyzt
-        //------------------------------------------------------------------------
-        GFRotate.setDirection(1, _array, arg.gx);
-        GFRotate.apply(0);
-        //------------------------------------------------------------------------
-        // Perform IFFT on xy plane
+        // Perform IFFT, back to xyzt
         //------------------------------------------------------------------------
-        ApplyFFT(plan_xy, arg.gx, _array, CUFFT_INVERSE);
+        fft->backward(arg.gx, _array);
       }
                 #ifdef GAUGEFIXING_DONT_USE_GX
       //------------------------------------------------------------------------
@@ -1052,6 +934,7 @@ namespace quda {
       gfixquality.apply(0);
       double action = argQ.getAction();
       diff = abs(action0 - action);
+      if ( history ) history->steps.push_back({iter + 1, action, argQ.getTheta(), diff});
       if ((iter % verbose_interval) == (verbose_interval - 1))
         printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
       if ( autotune && ((action - action0) < -1e-14) ) {
@@ -1101,55 +984,56 @@ namespace quda {
 
 
     arg.free();
-    CUFFT_SAFE_CALL(cufftDestroy(plan_zt));
-    CUFFT_SAFE_CALL(cufftDestroy(plan_xy));
     checkCudaError();
     qudaDeviceSynchronize();
     profileInternalGaugeFixFFT.TPSTOP(QUDA_PROFILE_COMPUTE);
 
-    if (getVerbosity() > QUDA_SUMMARIZE){
-      double secs = profileInternalGaugeFixFFT.Last(QUDA_PROFILE_COMPUTE);
-      double fftflop = 5.0 * (log2((double)( data.X()[0] * data.X()[1]) ) + log2( (double)(data.X()[2] * data.X()[3] )));
-      fftflop *= (double)( data.X()[0] * data.X()[1] * data.X()[2] * data.X()[3] );
-      double gflops = setinvpsp.flops() + gfixquality.flops();
-      double gbytes = setinvpsp.bytes() + gfixquality.bytes();
-      double flop = invpsp.flops() * Elems;
-      double byte = invpsp.bytes() * Elems;
-      flop += (GFRotate.flops() + fftflop) * Elems * 2;
-      byte += GFRotate.bytes() * Elems * 4;     //includes FFT reads, assuming 1 read and 1 write per site
-      #ifdef GAUGEFIXING_DONT_USE_GX
-      flop += gfixNew.flops();
-      byte += gfixNew.bytes();
-      #else
-      flop += calcGX.flops();
-      byte += calcGX.bytes();
-      flop += gfix.flops();
-      byte += gfix.bytes();
-      #endif
-      flop += gfixquality.flops();
-      byte += gfixquality.bytes();
-      gflops += flop * iter;
-      gbytes += byte * iter;
-      gflops += 4588.0 * data.X()[0]*data.X()[1]*data.X()[2]*data.X()[3]; //Reunitarize at end
-      gbytes += 8.0 * data.X()[0]*data.X()[1]*data.X()[2]*data.X()[3] * dataOr.Bytes() ; //Reunitarize at end
-
-      gflops = (gflops * 1e-9) / (secs);
-      gbytes = gbytes / (secs * 1e9);
-      printfQuda("Time: %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
-    }
+    double secs = profileInternalGaugeFixFFT.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = setinvpsp.flops() + gfixquality.flops();
+    double gbytes = setinvpsp.bytes() + gfixquality.bytes();
+    double flop = invpsp.flops() * Elems;
+    double byte = invpsp.bytes() * Elems;
+    flop += fft->flops() * Elems * 2;
+    byte += fft->bytes() * Elems * 2;
+#ifdef GAUGEFIXING_DONT_USE_GX
+    flop += gfixNew.flops();
+    byte += gfixNew.bytes();
+#else
+    flop += calcGX.flops();
+    byte += calcGX.bytes();
+    flop += gfix.flops();
+    byte += gfix.bytes();
+#endif
+    flop += gfixquality.flops();
+    byte += gfixquality.bytes();
+    gflops += flop * iter;
+    gbytes += byte * iter;
+    gflops += 4588.0 * data.X()[0]*data.X()[1]*data.X()[2]*data.X()[3]; //Reunitarize at end
+    gbytes += 8.0 * data.X()[0]*data.X()[1]*data.X()[2]*data.X()[3] * dataOr.Bytes() ; //Reunitarize at end
+
+    gflops = (gflops * 1e-9) / (secs);
+    gbytes = gbytes / (secs * 1e9);
+    if (getVerbosity() > QUDA_SUMMARIZE) printfQuda("Time: %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
+    if ( history ) {
+      history->secs = secs;
+      history->fft_secs = 0.0;
+      history->gflops = gflops;
+      history->fft_backend = fftBackendString(fft->Backend());
+    }
+    delete fft;
   }
 
   template<int Elems, typename Float, typename Gauge>
   void gaugefixingFFT( Gauge dataOr,  cudaGaugeField& data, const int gauge_dir, \
                        const int Nsteps, const int verbose_interval, const Float alpha, const int autotune, \
-                       const double tolerance, const int stopWtheta) {
+                       const double tolerance, const int stopWtheta, GaugeFixHistory *history) {
     if ( gauge_dir != 3 ) {
       printf("Starting Landau gauge fixing with FFTs...\n");
-      gaugefixingFFT<Elems, Float, Gauge, 4>(dataOr, data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+      gaugefixingFFT<Elems, Float, Gauge, 4>(dataOr, data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
     }
     else {
       printf("Starting Coulomb gauge fixing with FFTs...\n");
-      gaugefixingFFT<Elems, Float, Gauge, 3>(dataOr, data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+      gaugefixingFFT<Elems, Float, Gauge, 3>(dataOr, data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
     }
   }
 
@@ -1158,7 +1042,7 @@ namespace quda {
   template<typename Float>
   void gaugefixingFFT( cudaGaugeField& data, const int gauge_dir, \
                        const int Nsteps, const int verbose_interval, const Float alpha, const int autotune, \
-                       const double tolerance, const int stopWtheta) {
+                       const double tolerance, const int stopWtheta, GaugeFixHistory *history) {
 
     // Switching to FloatNOrder for the gauge field in order to support RECONSTRUCT_12
     // Need to fix this!!
@@ -1167,15 +1051,15 @@ namespace quda {
       if ( data.Reconstruct() == QUDA_RECONSTRUCT_NO ) {
         //printfQuda("QUDA_RECONSTRUCT_NO\n");
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type Gauge;
-        gaugefixingFFT<9, Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        gaugefixingFFT<9, Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
       } else if ( data.Reconstruct() == QUDA_RECONSTRUCT_12 ) {
         //printfQuda("QUDA_RECONSTRUCT_12\n");
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type Gauge;
-        gaugefixingFFT<6, Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        gaugefixingFFT<6, Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
       } else if ( data.Reconstruct() == QUDA_RECONSTRUCT_8 ) {
         //printfQuda("QUDA_RECONSTRUCT_8\n");
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type Gauge;
-        gaugefixingFFT<6, Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        gaugefixingFFT<6, Float>(Gauge(data), data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
 
       } else {
         errorQuda("Reconstruction type %d of gauge field not supported", data.Reconstruct());
@@ -1185,12 +1069,314 @@ namespace quda {
     }
   }
 
+
+  /*
+    Host gauge fixing.  The steps are those of the device version
+    without g(x) stored: Delta(x) is measured with the functional and
+    theta, each of its six independent elements is Fourier
+    accelerated, and the links are rotated by g(x) = 1 + alpha/2
+    Delta(x) projected onto SU(3).  The FFTs use the backend of
+    hostFFTBackend, and the momentum-space field is in the layout
+    reported by the plan.
+  */
+
+  template <typename Float, typename Gauge>
+  struct GaugeFixHostArg {
+    int X[4];
+    int V;
+    int volumeCB;
+    Gauge dataOr;
+    Float *invpsq;
+    complex<Float> *delta; // the six elements of Delta(x), each a full field in lexicographic order
+    complex<Float> *gx;    // momentum-space field
+    Float half_alpha;
+    double action;
+    double theta;
+
+    GaugeFixHostArg(const Gauge &dataOr, const GaugeField &data, Float alpha)
+      : dataOr(dataOr), half_alpha(alpha * 0.5), action(0.0), theta(0.0) {
+      for ( int dir = 0; dir < 4; ++dir ) X[dir] = data.X()[dir];
+      V = X[0] * X[1] * X[2] * X[3];
+      volumeCB = V / 2;
+      invpsq = (Float*)safe_malloc(sizeof(Float) * V);
+      delta = (complex<Float>*)safe_malloc(sizeof(complex<Float>) * V * 6);
+      gx = (complex<Float>*)safe_malloc(sizeof(complex<Float>) * V);
+    }
+    void free(){
+      host_free(invpsq);
+      host_free(delta);
+      host_free(gx);
+    }
+
+    /**
+       @brief Set pmax^2/p^2 with the FFT normalization, as
+       kernel_gauge_set_invpsq, for momenta in the given layout
+     */
+    void setInvpsq(const int *layout){
+      parallel_for(hostDefaultParam(), 1, V, [&](int, int id) {
+          int p[4];
+          int rem = id;
+          for ( int i = 0; i < 4; i++ ) {
+            p[layout[i]] = rem % X[layout[i]];
+            rem /= X[layout[i]];
+          }
+          Float sinsq = 0.0;
+          for ( int dir = 0; dir < 4; dir++ ) {
+            Float s = sin( (Float)p[dir] * FL_UNITARIZE_PI / (Float)X[dir]);
+            sinsq += s * s;
+          }
+          invpsq[id] = sinsq > 0.00001 ? 4.0 / (sinsq * (Float)V) : 0.0;
+        });
+    }
+  };
+
+
+  template<typename Float, typename Gauge, int gauge_dir>
+  class GaugeFixQualityHost : Tunable {
+    GaugeFixHostArg<Float, Gauge> &arg;
+    const GaugeField &meta;
+    private:
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+    bool tuneGridDim() const { return false; }
+    unsigned int minThreads() const { return arg.V; }
+
+    public:
+    GaugeFixQualityHost(GaugeFixHostArg<Float, Gauge> &arg, const GaugeField &meta) : arg(arg), meta(meta) { }
+
+    void apply(const cudaStream_t &stream){
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      auto site = [&](int parity, int idx_cb) {
+        int x[4];
+        getCoords(x, idx_cb, arg.X, parity);
+        Matrix<complex<Float>,3> delta;
+        double2 data = siteDelta<Float, Gauge, gauge_dir>(delta, arg.dataOr, x, arg.X, idx_cb, parity);
+        int idx = getIndexFull(idx_cb, arg.X, parity);
+        arg.delta[idx] = delta(0,0);
+        arg.delta[idx + 1 * arg.V] = delta(0,1);
+        arg.delta[idx + 2 * arg.V] = delta(0,2);
+        arg.delta[idx + 3 * arg.V] = delta(1,1);
+        arg.delta[idx + 4 * arg.V] = delta(1,2);
+        arg.delta[idx + 5 * arg.V] = delta(2,2);
+        return data;
+      };
+      auto sum = [](const double2 &a, const double2 &b) { return make_double2(a.x + b.x, a.y + b.y); };
+      double2 result = parallel_reduce_ordered(tp, 2, arg.volumeCB, make_double2(0.0, 0.0), site, sum);
+      arg.action = result.x / (double)(3 * gauge_dir * arg.V);
+      arg.theta = result.y / (double)(3 * arg.V);
+    }
+
+    bool hostLaunch() const { return true; }
+
+    TuneKey tuneKey() const {
+      std::stringstream aux;
+      aux << "threads=" << arg.V << ",prec=" << sizeof(Float) << ",gaugedir=" << gauge_dir;
+      aux << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    long long flops() const { return (36LL * gauge_dir + 65LL) * arg.V; }
+    long long bytes() const { return (2LL * gauge_dir + 2LL) * 18 * arg.V * sizeof(Float); }
+  };
+
+
+  template<typename Float, typename Gauge>
+  class GaugeFixHost : Tunable {
+    GaugeFixHostArg<Float, Gauge> &arg;
+    const GaugeField &meta;
+    private:
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+    bool tuneGridDim() const { return false; }
+    unsigned int minThreads() const { return arg.V; }
+
+    Matrix<complex<Float>,3> rotation(int idx) const {
+      Matrix<complex<Float>,3> de;
+      de(0,0) = arg.delta[idx + 0 * arg.V];
+      de(0,1) = arg.delta[idx + 1 * arg.V];
+      de(0,2) = arg.delta[idx + 2 * arg.V];
+      de(1,1) = arg.delta[idx + 3 * arg.V];
+      de(1,2) = arg.delta[idx + 4 * arg.V];
+      de(2,2) = arg.delta[idx + 5 * arg.V];
+      return deltaRotation<Float>(de, arg.half_alpha);
+    }
+
+    public:
+    GaugeFixHost(GaugeFixHostArg<Float, Gauge> &arg, const GaugeField &meta) : arg(arg), meta(meta) { }
+
+    void setAlpha(Float alpha){ arg.half_alpha = alpha * 0.5; }
+
+    void apply(const cudaStream_t &stream){
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      // U_mu(x) -> g(x) U_mu(x) g(x+mu)^dagger, so each site only writes its own links
+      parallel_for(tp, 2, arg.volumeCB, [&](int parity, int id) {
+          int x[4];
+          getCoords(x, id, arg.X, parity);
+          Matrix<complex<Float>,3> g = rotation(getIndexFull(id, arg.X, parity));
+          for ( int mu = 0; mu < 4; mu++ ) {
+            Matrix<complex<Float>,3> U;
+            arg.dataOr.load((Float*)(U.data), id, mu, parity);
+            U = g * U * conj(rotation(linkNormalIndexP1(x, arg.X, mu)));
+            arg.dataOr.save((Float*)(U.data), id, mu, parity);
+          }
+        });
+    }
+
+    bool hostLaunch() const { return true; }
+
+    TuneKey tuneKey() const {
+      std::stringstream aux;
+      aux << "threads=" << arg.V << ",prec=" << sizeof(Float);
+      aux << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    void preTune() { arg.dataOr.save(); }
+    void postTune() { arg.dataOr.load(); }
+
+    //g(x) is computed once per site and once per forward neighbour, as in GaugeFixNEW
+    long long flops() const { return 2414LL * arg.V; }
+    long long bytes() const { return ( 4LL * 2 * 18 + 5LL * 12 ) * arg.V * sizeof(Float); }
+  };
+
+
+  template<typename Float, typename Gauge, int gauge_dir>
+  void gaugefixingFFTHost( Gauge dataOr, GaugeField& data, const int Nsteps, const int verbose_interval,
+                           const Float alpha0, const int autotune, const double tolerance,
+                           const int stopWtheta, GaugeFixHistory *history) {
+
+    Timer timer;
+    Timer fft_timer;
+    timer.Start(__func__, __FILE__, __LINE__);
+
+    Float alpha = alpha0;
+    printfQuda("\tAlpha parameter of the Steepest Descent Method: %e\n", alpha);
+    printfQuda("\tAuto tune active: %s\n", autotune ? "yes" : "no");
+    printfQuda("\tStop criterium: %e\n", tolerance);
+    printfQuda("\tStop criterium method: %s\n", stopWtheta ? "theta" : "Delta");
+    printfQuda("\tMaximum number of iterations: %d\n", Nsteps);
+    printfQuda("\tPrint convergence results at every %d steps\n", verbose_interval);
+
+    GaugeFixHostArg<Float, Gauge> arg(dataOr, data, alpha);
+    FFTPlan *fft = FFTPlan::create(hostFFTBackend(), data.X(), data.Precision());
+    printfQuda("\tFFT backend: %s\n", fftBackendString(fft->Backend()));
+    arg.setInvpsq(fft->Layout());
+
+    GaugeFixHost<Float, Gauge> gfix(arg, data);
+    GaugeFixQualityHost<Float, Gauge, gauge_dir> gfixquality(arg, data);
+
+    gfixquality.apply(0);
+    double action0 = arg.action;
+    printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, arg.action, arg.theta);
+    if ( history ) history->steps.push_back({0, arg.action, arg.theta, 0.0});
+
+    double diff = 0.0;
+    int iter = 0;
+    for ( iter = 0; iter < Nsteps; iter++ ) {
+      for ( int k = 0; k < 6; k++ ) {
+        complex<Float> *_array = arg.delta + k * arg.V;
+        fft_timer.Start(__func__, __FILE__, __LINE__);
+        fft->forward(_array, arg.gx);
+        fft_timer.Stop(__func__, __FILE__, __LINE__);
+        parallel_for(hostDefaultParam(), 1, arg.V, [&](int, int id) { arg.gx[id] *= arg.invpsq[id]; });
+        fft_timer.Start(__func__, __FILE__, __LINE__);
+        fft->backward(arg.gx, _array);
+        fft_timer.Stop(__func__, __FILE__, __LINE__);
+      }
+      gfix.apply(0);
+      gfixquality.apply(0);
+      double action = arg.action;
+      diff = abs(action0 - action);
+      if ( history ) history->steps.push_back({iter + 1, action, arg.theta, diff});
+      if ((iter % verbose_interval) == (verbose_interval - 1))
+        printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, arg.action, arg.theta, diff);
+      if ( autotune && ((action - action0) < -1e-14) ) {
+        if ( alpha > 0.01 ) {
+          alpha = 0.95 * alpha;
+          gfix.setAlpha(alpha);
+          printfQuda(">>>>>>>>>>>>>> Warning: changing alpha down -> %.4e\n", alpha );
+        }
+      }
+      if ( stopWtheta ) {   if ( arg.theta < tolerance ) break; }
+      else { if ( diff < tolerance ) break; }
+
+      action0 = action;
+    }
+    if ((iter % verbose_interval) != 0 )
+      printfQuda("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter, arg.action, arg.theta, diff);
+
+    // Reunitarize at end
+    const double unitarize_eps = 1e-14;
+    const double max_error = 1e-10;
+    const int reunit_allow_svd = 1;
+    const int reunit_svd_only  = 0;
+    const double svd_rel_error = 1e-6;
+    const double svd_abs_error = 1e-6;
+    setUnitarizeLinksConstants(unitarize_eps, max_error,
+                               reunit_allow_svd, reunit_svd_only,
+                               svd_rel_error, svd_abs_error);
+    int num_failures = 0;
+    unitarizeLinks(data, data, &num_failures);
+    if ( num_failures > 0 ) errorQuda("Error in the unitarization\n");
+
+    arg.free();
+    timer.Stop(__func__, __FILE__, __LINE__);
+
+    double secs = timer.Last();
+    double flop = gfixquality.flops() + iter * (fft->flops() * 6 * 2 + 6LL * 2 * arg.V + gfix.flops() + gfixquality.flops());
+    double byte = gfixquality.bytes() + iter * (fft->bytes() * 6 * 2 + 6LL * 3 * arg.V * sizeof(Float)
+                                                 + gfix.bytes() + gfixquality.bytes());
+    flop += 4588.0 * arg.V; //Reunitarize at end
+    byte += 8.0 * arg.V * 18 * sizeof(Float); //Reunitarize at end
+    double gflops = (flop * 1e-9) / secs;
+    double gbytes = byte / (secs * 1e9);
+    if (getVerbosity() > QUDA_SUMMARIZE)
+      printfQuda("Time: %6.6f s (FFT %6.6f s), Gflop/s = %6.1f, GB/s = %6.1f\n", secs, fft_timer.time, gflops, gbytes);
+    if ( history ) {
+      history->secs = secs;
+      history->fft_secs = fft_timer.time;
+      history->gflops = gflops;
+      history->fft_backend = fftBackendString(fft->Backend());
+    }
+    delete fft;
+  }
+
+
+  template<typename Float>
+  void gaugefixingFFTHost( GaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval,
+                           const Float alpha, const int autotune, const double tolerance, const int stopWtheta,
+                           GaugeFixHistory *history) {
+    if ( data.Reconstruct() != QUDA_RECONSTRUCT_NO )
+      errorQuda("Reconstruction type %d of host gauge field not supported", data.Reconstruct());
+    if ( data.Order() == QUDA_QDP_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      if ( gauge_dir != 3 ) {
+        printfQuda("Starting Landau gauge fixing with FFTs on the host...\n");
+        gaugefixingFFTHost<Float, Gauge, 4>(Gauge(data), data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
+      } else {
+        printfQuda("Starting Coulomb gauge fixing with FFTs on the host...\n");
+        gaugefixingFFTHost<Float, Gauge, 3>(Gauge(data), data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
+      }
+    } else if ( data.Order() == QUDA_MILC_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      if ( gauge_dir != 3 ) {
+        printfQuda("Starting Landau gauge fixing with FFTs on the host...\n");
+        gaugefixingFFTHost<Float, Gauge, 4>(Gauge(data), data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
+      } else {
+        printfQuda("Starting Coulomb gauge fixing with FFTs on the host...\n");
+        gaugefixingFFTHost<Float, Gauge, 3>(Gauge(data), data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
+      }
+    } else {
+      errorQuda("Gauge field order %d not supported", data.Order());
+    }
+  }
+
 #endif // GPU_GAUGE_ALG
 
 
   /**
-   * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU only.
-   * @param[in,out] data, quda gauge field
+   * @brief Gauge fixing with Steepest descent method with FFTs with support for single GPU or single host process only.
+   * @param[in,out] data, quda gauge field, on the device or on the host in QDP or MILC order
    * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
    * @param[in] Nsteps, maximum number of steps to perform gauge fixing
    * @param[in] verbose_interval, print gauge fixing info when iteration count is a multiple of this
@@ -1198,10 +1384,11 @@ namespace quda {
    * @param[in] autotune, 1 to autotune the method, i.e., if the Fg inverts its tendency we decrease the alpha value 
    * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when iteration reachs the maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterium and 1 to use the theta value
+   * @param[out] history, if set, the observables after every step and the timings
    */
-  void gaugefixingFFT( cudaGaugeField& data, const int gauge_dir, \
+  void gaugefixingFFT( GaugeField& data, const int gauge_dir, \
                        const int Nsteps, const int verbose_interval, const double alpha, const int autotune, \
-                       const double tolerance, const int stopWtheta) {
+                       const double tolerance, const int stopWtheta, GaugeFixHistory *history) {
 
 #ifdef GPU_GAUGE_ALG
 #ifdef MULTI_GPU
@@ -1211,10 +1398,21 @@ namespace quda {
     if ( data.Precision() == QUDA_HALF_PRECISION ) {
       errorQuda("Half precision not supported\n");
     }
+    if ( data.Location() == QUDA_CPU_FIELD_LOCATION ) {
+      if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
+        gaugefixingFFTHost<float> (data, gauge_dir, Nsteps, verbose_interval, (float)alpha, autotune, tolerance, stopWtheta, history);
+      } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
+        gaugefixingFFTHost<double>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
+      } else {
+        errorQuda("Precision %d not supported", data.Precision());
+      }
+      return;
+    }
+    cudaGaugeField &cudaData = static_cast<cudaGaugeField&>(data);
     if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
-      gaugefixingFFT<float> (data, gauge_dir, Nsteps, verbose_interval, (float)alpha, autotune, tolerance, stopWtheta);
+      gaugefixingFFT<float> (cudaData, gauge_dir, Nsteps, verbose_interval, (float)alpha, autotune, tolerance, stopWtheta, history);
     } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
-      gaugefixingFFT<double>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+      gaugefixingFFT<double>(cudaData, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, history);
     } else {
       errorQuda("Precision %d not supported", data.Precision());
     }
@@ -3,11 +3,135 @@
 #include <index_helper.cuh>
 #include <generics/ldg.h>
 #include <tune_quda.h>
+#include <gauge_force_quda.h>
+#include <host_parallel.h>
 
 namespace quda {
 
+  __device__ __host__ inline static int flipDir(int dir) { return (7-dir); }
+  __device__ __host__ inline static bool isForwards(int dir) { return (dir <= 3); }
+
+  // node of the prefix tree of the paths of one direction, with the
+  // children indexed by the step taken
+  struct PathTrie {
+    int child[8];
+    double coeff;
+    PathTrie() : coeff(0.0) { for (int step=0; step<8; step++) child[step] = -1; }
+  };
+
+  /**
+     @brief Append the subtree below a node depth first
+     @param[out] nodes The compiled nodes
+     @param[in] trie The prefix tree
+     @param[in] node The node whose children are appended
+     @param[in] depth The depth of the children
+     @param[in] dx Displacement from x of the site the path has reached
+   */
+  static void compilePaths(std::vector<GaugePathNode> &nodes, const std::vector<PathTrie> &trie, int node,
+                           int depth, const int dx[4])
+  {
+    for (int step=0; step<8; step++) {
+      const int child = trie[node].child[step];
+      if (child < 0) continue;
+
+      GaugePathNode n;
+      n.dir = isForwards(step) ? step : flipDir(step);
+      n.dagger = !isForwards(step);
+      n.depth = depth;
+      n.coeff = trie[child].coeff;
+      for (int d=0; d<4; d++) n.dx[d] = dx[d];
+      if (n.dagger) n.dx[n.dir]--; // if we are going backwards the link is on the adjacent site
+      n.odd = (abs(n.dx[0]) + abs(n.dx[1]) + abs(n.dx[2]) + abs(n.dx[3])) & 1;
+      nodes.push_back(n);
+
+      int next[4] = {n.dx[0], n.dx[1], n.dx[2], n.dx[3]};
+      if (!n.dagger) next[n.dir]++;
+      compilePaths(nodes, trie, child, depth+1, next);
+    }
+  }
+
+  GaugePathPlan::GaugePathPlan(int ***input_path, const int *length, const double *path_coeff, int num_paths_)
+    : max_depth(0), num_paths(0), naive_multiplies(0), multiplies(0)
+  {
+    for (int mu=0; mu<4; mu++) {
+      std::vector<PathTrie> trie(1);
+
+      for (int i=0; i<num_paths_; i++) {
+        if (path_coeff[i] == 0) continue;
+        if (length[i] < 1) errorQuda("Invalid length %d of path %d", length[i], i);
+
+        int node = 0;
+        for (int j=0; j<length[i]; j++) {
+          const int step = input_path[mu][i][j];
+          if (step < 0 || step > 7) errorQuda("Invalid step %d of path %d in direction %d", step, i, mu);
+          if (trie[node].child[step] < 0) {
+            trie[node].child[step] = trie.size();
+            trie.push_back(PathTrie());
+          }
+          node = trie[node].child[step];
+        }
+        trie[node].coeff += path_coeff[i];
+
+        if (length[i] > max_depth) max_depth = length[i];
+        naive_multiplies += length[i] - 1;
+        if (mu == 0) num_paths++;
+      }
+
+      // the paths start from the end of the link in direction mu
+      int dx[4] = {0, 0, 0, 0};
+      dx[mu] = 1;
+      begin[mu] = nodes.size();
+      compilePaths(nodes, trie, 0, 0, dx);
+    }
+    begin[4] = nodes.size();
+
+    // every node below the first level costs one multiply
+    for (auto &n : nodes) if (n.depth > 0) multiplies++;
+  }
+
 #ifdef GPU_GAUGE_FORCE
 
+  /**
+     The longest path the kernel can evaluate, bounding the stack of
+     partial products held per site
+  */
+  constexpr int gauge_force_max_depth = 8;
+
+  /**
+     Accessor for host momentum fields in MILC order, whose
+     anti-Hermitian matrices are stored as 10 reals in the same
+     layout as the reconstruct-10 device fields
+  */
+  template <typename Float> struct MILCMomOrder : public gauge::MILCOrder<Float,10> {
+    typedef gauge::MILCOrder<Float,10> Order;
+    typedef typename mapper<Float>::type RegType;
+    gauge::Reconstruct<11,Float,QUDA_GHOST_EXCHANGE_NO> reconstruct;
+
+    MILCMomOrder(const GaugeField &mom) : Order(mom), reconstruct(mom) { }
+
+    using Order::load;
+    using Order::save;
+
+    __device__ __host__ inline void load(RegType v[18], int x, int dir, int parity, Float inphase = 1.0) const
+    {
+      RegType tmp[10];
+      Order::load(tmp, x, dir, parity);
+      reconstruct.Unpack(v, tmp, x, dir, 0, static_cast<const int*>(nullptr), nullptr);
+    }
+
+    __device__ __host__ inline void save(const RegType v[18], int x, int dir, int parity)
+    {
+      RegType tmp[10];
+      reconstruct.Pack(tmp, v, x);
+      Order::save(tmp, x, dir, parity);
+    }
+
+    __device__ __host__ inline gauge_wrapper<RegType, MILCMomOrder<Float>> operator()(int dim, int x_cb, int parity)
+    {
+      return gauge_wrapper<RegType, MILCMomOrder<Float>>(*this, dim, x_cb, parity);
+    }
+  };
+
   template <typename Mom, typename Gauge>
   struct GaugeForceArg {
     Mom mom;
@@ -18,48 +142,29 @@ namespace quda {
     int E[4]; // the extended volume parameters
     int border[4]; // radius of border
 
-    int num_paths;
-    int path_max_length;
-
     double coeff;
 
-    const int *input_path_d[4];
-    const int *length_d;
-    const double *path_coeff_d;
-
-    int count; // equal to sum of all path lengths.  Used a convenience for computing perf
+    const GaugePathNode *plan; // the compiled paths, on the device for device fields
+    int begin[5];              // the paths of direction mu are plan[begin[mu]] to plan[begin[mu+1]-1]
+    long long multiplies;      // multiplies per site, for computing perf
+    int nodes;
 
-    GaugeForceArg(Mom &mom, const Gauge &u, int num_paths, int path_max_length, double coeff,
-                  int **input_path_d, const int *length_d, const double* path_coeff_d, int count,
-		  const GaugeField &meta_mom, const GaugeField &meta_u)
-      : mom(mom), u(u), threads(meta_mom.VolumeCB()), num_paths(num_paths),
-	path_max_length(path_max_length), coeff(coeff),
-	input_path_d{ input_path_d[0], input_path_d[1], input_path_d[2], input_path_d[3] },
-	length_d(length_d), path_coeff_d(path_coeff_d), count(count)
+    GaugeForceArg(Mom &mom, const Gauge &u, double coeff, const GaugePathNode *plan, const GaugePathPlan &plan_h,
+                  const GaugeField &meta_mom, const GaugeField &meta_u)
+      : mom(mom), u(u), threads(meta_mom.VolumeCB()), coeff(coeff), plan(plan),
+        multiplies(plan_h.multiplies), nodes(plan_h.nodes.size())
     {
       for(int i=0; i<4; i++) {
 	X[i] = meta_mom.X()[i];
 	E[i] = meta_u.X()[i];
 	border[i] = (E[i] - X[i])/2;
       }
+      for (int i=0; i<5; i++) begin[i] = plan_h.begin[i];
     }
 
     virtual ~GaugeForceArg() { }
   };
 
-  __device__ __host__ inline static int flipDir(int dir) { return (7-dir); }
-  __device__ __host__ inline static bool isForwards(int dir) { return (dir <= 3); }
-
-  // this ensures that array elements are held in cache
-  template <typename T>
-  __device__ __host__ inline static T cache(const T *ptr, int idx) {
-#ifdef __CUDA_ARCH__
-    return __ldg(ptr+idx);
-#else
-    return ptr[idx];
-#endif
-  }
-
   template<typename Float, typename Arg, int dir>
   __device__ __host__ inline void GaugeForceKernel(Arg &arg, int idx, int parity)
   {
@@ -69,66 +174,22 @@ namespace quda {
     getCoords(x, idx, arg.X, parity);
     for (int dr=0; dr<4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
 
-    //linkA: current matrix
-    //linkB: the loaded matrix in this round
-    Link linkA, linkB, staple;
-
-#ifdef __CUDA_ARCH__
-    extern __shared__ int s[];
-    int tid = (threadIdx.z*blockDim.y + threadIdx.y)*blockDim.x + threadIdx.x;
-    s[tid] = 0;
-    signed char *dx = (signed char*)&s[tid];
-#else
-    int dx[4] = {0, 0, 0, 0};
-#endif
-
-    for (int i=0; i<arg.num_paths; i++) {
-      Float coeff = cache(arg.path_coeff_d,i);
-      if (coeff == 0) continue;
-
-      const int* path = arg.input_path_d[dir] + i*arg.path_max_length;
+    // the partial product of the path up to each depth
+    Link path[gauge_force_max_depth];
+    Link staple;
 
-      // start from end of link in direction dir
-      int nbr_oddbit = (parity^1);
-      dx[dir]++;
+    for (int i=arg.begin[dir]; i<arg.begin[dir+1]; i++) {
+      const GaugePathNode &node = arg.plan[i];
 
-      int path0 = cache(path,0);
-      int lnkdir = isForwards(path0) ? path0 : flipDir(path0);
+      Link link = arg.u(node.dir, linkIndexShift(x,node.dx,arg.E), parity^node.odd);
+      if (node.dagger) link = conj(link);
+      path[node.depth] = node.depth == 0 ? link : path[node.depth-1] * link;
 
-      if (isForwards(path0)) {
-        linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-        linkA = linkB;
-        dx[lnkdir]++; // now have to update location
-	nbr_oddbit = nbr_oddbit^1;
-      } else {
-        dx[lnkdir]--; // if we are going backwards the link is on the adjacent site
-        nbr_oddbit = nbr_oddbit^1;
-	linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-        linkA = conj(linkB);
-      }
-	
-      for (int j=1; j<cache(arg.length_d,i); j++) {
-
-        int pathj = cache(path,j);
-        int lnkdir = isForwards(pathj) ? pathj : flipDir(pathj);
-
-        if (isForwards(pathj)) {
-          linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-          linkA = linkA * linkB;
-          dx[lnkdir]++; // now have to update to new location
-          nbr_oddbit = nbr_oddbit^1;	
-        } else {
-          dx[lnkdir]--; // if we are going backwards the link is on the adjacent site
-	  nbr_oddbit = nbr_oddbit^1;
-          linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-          linkA = linkA * conj(linkB);
-        }
-      } //j
-      staple = staple + coeff*linkA;
-    } //i
+      if (node.coeff != 0) staple = staple + static_cast<Float>(node.coeff) * path[node.depth];
+    }
 
     // multiply by U(x)
-    linkA = arg.u(dir, linkIndex(x,arg.E), parity);
+    Link linkA = arg.u(dir, linkIndex(x,arg.E), parity);
     linkA = linkA * staple;
 
     // update mom(x)
@@ -140,36 +201,8 @@ namespace quda {
   }
 
   template <typename Float, typename Arg>
-  void GaugeForceCPU(Arg &arg) {
-    for (int dir=0; dir<4; dir++) {
-      for (int parity=0; parity<2; parity++) {
-        for (int idx=0; idx<arg.threads; idx++) {
-	  switch(dir) {
-	  case 0:
-	    GaugeForceKernel<Float,Arg,0>(arg, idx, parity);
-	    break;
-	  case 1:
-	    GaugeForceKernel<Float,Arg,1>(arg, idx, parity);
-	    break;
-	  case 2:
-	    GaugeForceKernel<Float,Arg,2>(arg, idx, parity);
-	    break;
-	  case 3:
-	    GaugeForceKernel<Float,Arg,3>(arg, idx, parity);
-	    break;
-	  }
-        }
-      }
-    }
-    return;
-  }
-
-  template <typename Float, typename Arg>
-  __global__ void GaugeForceGPU(Arg arg) {
-    int idx = blockIdx.x * blockDim.x + threadIdx.x;
-    if (idx >= arg.threads) return;
-    int parity = blockIdx.y * blockDim.y + threadIdx.y;
-    int dir = blockIdx.z * blockDim.z + threadIdx.z;
+  __device__ __host__ inline void GaugeForceSite(Arg &arg, int idx, int parity, int dir)
+  {
     switch(dir) {
     case 0:
       GaugeForceKernel<Float,Arg,0>(arg, idx, parity);
@@ -184,6 +217,15 @@ namespace quda {
       GaugeForceKernel<Float,Arg,3>(arg, idx, parity);
       break;
     }
+  }
+
+  template <typename Float, typename Arg>
+  __global__ void GaugeForceGPU(Arg arg) {
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= arg.threads) return;
+    int parity = blockIdx.y * blockDim.y + threadIdx.y;
+    int dir = blockIdx.z * blockDim.z + threadIdx.z;
+    GaugeForceSite<Float>(arg, idx, parity, dir);
     return;
   }
 
@@ -194,7 +236,6 @@ namespace quda {
     Arg &arg;
     QudaFieldLocation location;
     const char *vol_str;
-    unsigned int sharedBytesPerThread() const { return 4; } // for dynamic indexing array
     unsigned int minThreads() const { return arg.threads; }
     bool tuneGridDim() const { return false; } // don't tune the grid dimension
 
@@ -204,19 +245,23 @@ namespace quda {
     virtual ~GaugeForce() { }
 
     void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (location == QUDA_CUDA_FIELD_LOCATION) {
-	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 	GaugeForceGPU<Float,Arg><<<tp.grid,tp.block,tp.shared_bytes>>>(arg);
       } else {
-	GaugeForceCPU<Float,Arg>(arg);
+        parallel_for(tp, 2, arg.threads, [&](int parity, int idx) {
+          for (int dir=0; dir<4; dir++) GaugeForceSite<Float>(arg, idx, parity, dir);
+        });
       }
     }
-  
+
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
+
     void preTune() { arg.mom.save(); }
     void postTune() { arg.mom.load(); } 
   
-    long long flops() const { return (arg.count - arg.num_paths + 1) * 198ll * 2 * arg.mom.volumeCB * 4; }
-    long long bytes() const { return ((arg.count + 1ll) * arg.u.Bytes() + 2ll*arg.mom.Bytes()) * 2 * arg.mom.volumeCB * 4; }
+    long long flops() const { return (arg.multiplies + 4) * 198ll * 2 * arg.mom.volumeCB; }
+    long long bytes() const { return ((arg.nodes + 4ll) * arg.u.Bytes() + 8ll*arg.mom.Bytes()) * 2 * arg.mom.volumeCB; }
 
     TuneKey tuneKey() const {
       std::stringstream aux;
@@ -226,7 +271,8 @@ namespace quda {
       comm[2] = (commDimPartitioned(2) ? '1' : '0');
       comm[3] = (commDimPartitioned(3) ? '1' : '0');
       comm[4] = '\0';
-      aux << "comm=" << comm << ",threads=" << arg.threads << ",num_paths=" << arg.num_paths;
+      aux << "comm=" << comm << ",threads=" << arg.threads << ",nodes=" << arg.nodes;
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(vol_str, typeid(*this).name(), aux.str().c_str());
     }  
 
@@ -264,56 +310,31 @@ namespace quda {
     }
   };
   
+  
   template <typename Float, typename Mom, typename Gauge>
   void gaugeForce(Mom mom, const Gauge &u, GaugeField& meta_mom, const GaugeField& meta_u, const double coeff,
-		  int ***input_path, const int* length_h, const double* path_coeff_h, const int num_paths, const int path_max_length)
+		  const GaugePathPlan &plan)
   {
-    size_t bytes = num_paths*path_max_length*sizeof(int);
-    int *input_path_d[4];
-
-    int count = 0;
-    for (int dir=0; dir<4; dir++) {
-      input_path_d[dir] = (int*)pool_device_malloc(bytes);
-      cudaMemset(input_path_d[dir], 0, bytes);
-
-      int* input_path_h = (int*)safe_malloc(bytes);
-      memset(input_path_h, 0, bytes);
-      
-      // flatten the input_path array for copying to the device
-      for (int i=0; i < num_paths; i++) {
-	for (int j=0; j < length_h[i]; j++) {
-	  input_path_h[i*path_max_length + j] = input_path[dir][i][j];
-          if (dir==0) count++;
-	}
-      }
-      qudaMemcpy(input_path_d[dir], input_path_h, bytes, cudaMemcpyHostToDevice);
-
-      host_free(input_path_h);
+    const GaugePathNode *plan_d = plan.nodes.data();
+    size_t bytes = plan.nodes.size()*sizeof(GaugePathNode);
+    if (meta_mom.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      plan_d = static_cast<GaugePathNode*>(pool_device_malloc(bytes));
+      qudaMemcpy(const_cast<GaugePathNode*>(plan_d), plan.nodes.data(), bytes, cudaMemcpyHostToDevice);
     }
-      
-    //length
-    int* length_d = (int*)pool_device_malloc(num_paths*sizeof(int));
-    qudaMemcpy(length_d, length_h, num_paths*sizeof(int), cudaMemcpyHostToDevice);
 
-    //path_coeff
-    double* path_coeff_d = (double*)pool_device_malloc(num_paths*sizeof(double));
-    qudaMemcpy(path_coeff_d, path_coeff_h, num_paths*sizeof(double), cudaMemcpyHostToDevice);
-
-    GaugeForceArg<Mom,Gauge> arg(mom, u, num_paths, path_max_length, coeff, input_path_d,
-				 length_d, path_coeff_d, count, meta_mom, meta_u);
+    GaugeForceArg<Mom,Gauge> arg(mom, u, coeff, plan_d, plan, meta_mom, meta_u);
     GaugeForce<Float,GaugeForceArg<Mom,Gauge> > gauge_force(arg, meta_mom, meta_u);
     gauge_force.apply(0);
-    checkCudaError();
 
-    pool_device_free(length_d);
-    pool_device_free(path_coeff_d);
-    for (int dir=0; dir<4; dir++) pool_device_free(input_path_d[dir]);
-    qudaDeviceSynchronize();
+    if (meta_mom.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      checkCudaError();
+      pool_device_free(const_cast<GaugePathNode*>(plan_d));
+      qudaDeviceSynchronize();
+    }
   }
 
   template <typename Float>
-  void gaugeForce(GaugeField& mom, const GaugeField& u, const double coeff, int ***input_path,
-		  const int* length, const double* path_coeff, const int num_paths, const int max_length)
+  void gaugeForce(GaugeField& mom, const GaugeField& u, const double coeff, const GaugePathPlan &plan)
   {
     if (mom.Reconstruct() != QUDA_RECONSTRUCT_10)
       errorQuda("Reconstruction type %d not supported", mom.Reconstruct());
@@ -322,13 +343,24 @@ namespace quda {
       typedef typename gauge::FloatNOrder<Float,18,2,11> M;
       if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type G;
-	gaugeForce<Float,M,G>(M(mom), G(u), mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+	gaugeForce<Float,M,G>(M(mom), G(u), mom, u, coeff, plan);
       } else if (u.Reconstruct() == QUDA_RECONSTRUCT_12) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type G;
-	gaugeForce<Float,M,G>(M(mom), G(u), mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);	
+	gaugeForce<Float,M,G>(M(mom), G(u), mom, u, coeff, plan);
       } else {
 	errorQuda("Reconstruction type %d not supported", u.Reconstruct());
       }
+    } else if (mom.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef MILCMomOrder<Float> M;
+      if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+	typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type G;
+	gaugeForce<Float,M,G>(M(mom), G(u), mom, u, coeff, plan);
+      } else if (u.Order() == QUDA_MILC_GAUGE_ORDER) {
+	typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type G;
+	gaugeForce<Float,M,G>(M(mom), G(u), mom, u, coeff, plan);
+      } else {
+	errorQuda("Gauge Field order %d not supported", u.Order());
+      }
     } else {
       errorQuda("Gauge Field order %d not supported", mom.Order());
     }
@@ -344,12 +376,19 @@ namespace quda {
     if (mom.Precision() != u.Precision()) errorQuda("Mixed precision not supported");
     if (mom.Location() != u.Location()) errorQuda("Mixed field locations not supported");
 
+    GaugePathPlan plan(input_path, length, path_coeff, num_paths);
+    if (plan.max_depth > gauge_force_max_depth)
+      errorQuda("Path length %d exceeds the maximum %d supported", plan.max_depth, gauge_force_max_depth);
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+      printfQuda("Gauge force: %d paths compiled into %lu nodes, %lld multiplies per site rather than %lld\n",
+                 plan.num_paths, plan.nodes.size(), plan.multiplies, plan.naive_multiplies);
+
     switch(mom.Precision()) {
     case QUDA_DOUBLE_PRECISION:
-      gaugeForce<double>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+      gaugeForce<double>(mom, u, coeff, plan);
       break;
     case QUDA_SINGLE_PRECISION:
-      gaugeForce<float>(mom, u, coeff, input_path, length, path_coeff, num_paths, max_length);
+      gaugeForce<float>(mom, u, coeff, plan);
       break;
     default:
       errorQuda("Unsupported precision %d", mom.Precision());
@@ -360,5 +399,3 @@ namespace quda {
   }
 
 } // namespace quda
-
-
@@ -0,0 +1,187 @@
+#include <vector>
+
+#include <quda_internal.h>
+#include <tune_quda.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <comm_quda.h>
+
+#include <host_parallel.h>
+#include <kernels/gauge_observables.cuh>
+
+namespace quda
+{
+
+#ifdef GPU_GAUGE_TOOLS
+
+  template <typename Float, typename Arg> class GaugeObservablesCompute : Tunable
+  {
+    Arg &arg;
+    const GaugeField &meta;
+
+private:
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+    bool tuneGridDim() const { return false; }
+    unsigned int minThreads() const { return arg.threads; }
+
+public:
+    GaugeObservablesCompute(Arg &arg, const GaugeField &meta) : arg(arg), meta(meta) {}
+    virtual ~GaugeObservablesCompute() {}
+
+    void apply(const cudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      arg.result = parallel_reduce_ordered(
+        tp, 1, arg.threads, GaugeObsReduceType(), [&](int, int s) { return gaugeObservablesSite<Float>(arg, s); },
+        [](GaugeObsReduceType a, const GaugeObsReduceType &b) {
+          a += b;
+          return a;
+        });
+    }
+
+    bool hostLaunch() const { return true; }
+
+    TuneKey tuneKey() const
+    {
+      std::stringstream aux;
+      aux << "threads=" << arg.threads << ",prec=" << sizeof(Float) << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    // per site: 6 clovers, 12 rectangles, the field strength products
+    // and the Polyakov line (just counts matrix multiplication)
+    long long flops() const { return (6 * (12 + 2 * 5 + 1) + 3 + 1) * 198ll * arg.X[3] * arg.threads; }
+    long long bytes() const { return (6 * (12 + 10) + 1) * arg.origin.Bytes() * arg.X[3] * (long long)arg.threads; }
+  }; // GaugeObservablesCompute
+
+  template <typename Float, typename Gauge>
+  GaugeObsReduceType gaugeObservables(const GaugeField &u, std::vector<complex<double>> &polyakov)
+  {
+    Gauge U(u);
+    GaugeObservablesArg<Float, Gauge> arg(U, u, polyakov.data());
+    GaugeObservablesCompute<Float, decltype(arg)> compute(arg, u);
+    compute.apply(0);
+    return arg.result;
+  }
+
+  template <typename Float>
+  GaugeObsReduceType gaugeObservables(const GaugeField &u, std::vector<complex<double>> &polyakov)
+  {
+    if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+      return gaugeObservables<Float, typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, 3>::type>(u, polyakov);
+    } else if (u.Order() == QUDA_MILC_GAUGE_ORDER) {
+      return gaugeObservables<Float, typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type>(u, polyakov);
+    } else {
+      errorQuda("Gauge field order %d not supported on the host", u.Order());
+    }
+    return GaugeObsReduceType();
+  }
+
+  /**
+     @brief Complete the Polyakov lines across the ranks along the time
+     direction.  The local lines are multiplied in rank order, each rank
+     receiving the product of the lines below it, so that the last rank
+     ends up with the complete loops.
+     @return Whether this rank holds the complete loops
+  */
+  static bool polyakovLoops(std::vector<complex<double>> &polyakov)
+  {
+    typedef Matrix<complex<double>, 3> Line;
+    const int nT = comm_dim(3);
+    const int coord = comm_coord(3);
+    if (nT == 1) return true;
+
+    const size_t bytes = polyakov.size() * sizeof(complex<double>);
+    const int Vs = polyakov.size() / 9;
+
+    if (coord > 0) {
+      std::vector<complex<double>> below(polyakov.size());
+      MsgHandle *mh = comm_declare_receive_relative(below.data(), 3, -1, bytes);
+      comm_start(mh);
+      comm_wait(mh);
+      comm_free(mh);
+
+      parallel_for(hostDefaultParam(), 1, Vs, [&](int, int s) {
+        Line P = Line(&below[9 * s]) * Line(&polyakov[9 * s]);
+        for (int i = 0; i < 9; i++) polyakov[9 * s + i] = P.data[i];
+      });
+    }
+
+    if (coord < nT - 1) {
+      MsgHandle *mh = comm_declare_send_relative(polyakov.data(), 3, +1, bytes);
+      comm_start(mh);
+      comm_wait(mh);
+      comm_free(mh);
+    }
+
+    return coord == nT - 1;
+  }
+
+#endif // GPU_GAUGE_TOOLS
+
+  GaugeObservables gaugeObservables(const GaugeField &U)
+  {
+    GaugeObservables obs = {};
+#ifdef GPU_GAUGE_TOOLS
+    if (U.Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Gauge observables are only implemented on the host");
+    if (U.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED) errorQuda("Gauge field must not be extended");
+    if (U.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Site order %d not supported", U.SiteOrder());
+
+    // the rectangles reach two sites forwards, the clovers one backwards
+    int R[4];
+    for (int d = 0; d < 4; d++) {
+      R[d] = comm_dim_partitioned(d) ? 2 : 0;
+      if (R[d] > U.X()[d])
+        errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", R[d], U.X()[d], d);
+    }
+    const GaugeField *u = (R[0] || R[1] || R[2] || R[3]) ? extendGaugeField(U, R) : &U;
+
+    const int Vs = U.X()[0] * U.X()[1] * U.X()[2];
+    std::vector<complex<double>> polyakov(9 * Vs);
+
+    GaugeObsReduceType sums;
+    if (U.Precision() == QUDA_DOUBLE_PRECISION) {
+      sums = gaugeObservables<double>(*u, polyakov);
+    } else if (U.Precision() == QUDA_SINGLE_PRECISION) {
+      sums = gaugeObservables<float>(*u, polyakov);
+    } else {
+      errorQuda("Precision %d not supported", U.Precision());
+    }
+    if (u != &U) delete u;
+
+    // the trace of the loops summed in spatial site order
+    double loop[2] = {0.0, 0.0};
+    if (polyakovLoops(polyakov)) {
+      for (int s = 0; s < Vs; s++) {
+        complex<double> tr = polyakov[9 * s] + polyakov[9 * s + 4] + polyakov[9 * s + 8];
+        loop[0] += tr.real();
+        loop[1] += tr.imag();
+      }
+    }
+
+    comm_allreduce_array(&sums[0], sums.size());
+    comm_allreduce_array(loop, 2);
+
+    const double V = (double)U.Volume() * comm_size();
+    const double V_s = V / (U.X()[3] * comm_dim(3));
+    obs.plaquette.y = sums[0] / (3 * 3 * V);
+    obs.plaquette.z = sums[1] / (3 * 3 * V);
+    obs.plaquette.x = 0.5 * (obs.plaquette.y + obs.plaquette.z);
+    obs.polyakov_loop = make_double2(loop[0] / (3 * V_s), loop[1] / (3 * V_s));
+    obs.rectangle = sums[2] / (3 * 12 * V);
+    obs.E = sums[3] / V;
+    obs.Q = sums[4];
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Gauge observables: plaq = (%.12e, %.12e, %.12e) poly = (%.12e, %.12e) rect = %.12e E = %.12e Q = "
+                 "%.12e\n",
+                 obs.plaquette.x, obs.plaquette.y, obs.plaquette.z, obs.polyakov_loop.x, obs.polyakov_loop.y,
+                 obs.rectangle, obs.E, obs.Q);
+#else
+    errorQuda("Gauge tools are not built");
+#endif
+    return obs;
+  }
+
+} // namespace quda
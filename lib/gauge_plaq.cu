@@ -1,6 +1,8 @@
 #include <tune_quda.h>
 #include <gauge_field.h>
+#include <gauge_tools.h>
 #include <jitify_helper.cuh>
+#include <host_parallel.h>
 #include <kernels/gauge_plaq.cuh>
 
 namespace quda {
@@ -38,11 +40,24 @@ namespace quda {
 	LAUNCH_KERNEL_LOCAL_PARITY(computePlaq, tp, stream, arg, Float, Gauge);
 #endif
       } else {
-	errorQuda("CPU not supported yet\n");
+        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+        ((double2*)arg.result_h)[0] = parallel_reduce_ordered(
+          tp, 2, arg.threads, make_double2(0.0, 0.0),
+          [&](int parity, int idx) { return plaquetteSite<Float>(arg, idx, parity); },
+          [](const double2 &a, const double2 &b) { return make_double2(a.x + b.x, a.y + b.y); });
       }
     }
 
-    TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
+    TuneKey tuneKey() const
+    {
+      if (!hostLaunch()) return TuneKey(meta.VolString(), typeid(*this).name(), aux);
+      char aux_host[TuneKey::aux_n];
+      strcpy(aux_host, aux);
+      strcat(aux_host, getOmpThreadStr());
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux_host);
+    }
     long long flops() const { return 6ll*2*arg.threads*(3*198+3); }
     long long bytes() const { return 6ll*2*arg.threads*4*arg.dataOr.Bytes(); }
   };
@@ -52,22 +67,50 @@ namespace quda {
     GaugePlaqArg<Gauge> arg(dataOr, data);
     GaugePlaq<Float,Gauge> gaugePlaq(arg, data);
     gaugePlaq.apply(0);
-    qudaDeviceSynchronize();
+    if (location == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
     comm_allreduce_array((double*)arg.result_h, 2);
     for (int i=0; i<2; i++) ((double*)&plq)[i] = ((double*)arg.result_h)[i] / (9.*2*arg.threads*comm_size());
   }
 
   template<typename Float>
   void plaquette(const GaugeField& data, double2 &plq, QudaFieldLocation location) {
-    INSTANTIATE_RECONSTRUCT(plaquette<Float>, data, plq, location);
+    if (location == QUDA_CUDA_FIELD_LOCATION) {
+      INSTANTIATE_RECONSTRUCT(plaquette<Float>, data, plq, location);
+    } else if (data.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, 3>::type Gauge;
+      plaquette<Float>(Gauge(data), data, plq, location);
+    } else if (data.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type Gauge;
+      plaquette<Float>(Gauge(data), data, plq, location);
+    } else {
+      errorQuda("Gauge field order %d not supported on the host", data.Order());
+    }
   }
 
   double3 plaquette(const GaugeField &data)
   {
     double2 plq;
     QudaFieldLocation location = data.Location();
-    INSTANTIATE_PRECISION(plaquette, data, plq, location);
+
+    // host fields need not come extended: add the halo here
+    const GaugeField *u = &data;
+    if (location == QUDA_CPU_FIELD_LOCATION && data.GhostExchange() != QUDA_GHOST_EXCHANGE_EXTENDED) {
+      if (data.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Site order %d not supported", data.SiteOrder());
+      // one site suffices, but an odd depth would flip the halo parity
+      int R[4];
+      for (int d = 0; d < 4; d++) {
+        R[d] = comm_dim_partitioned(d) ? 2 : 0;
+        if (R[d] > data.X()[d])
+          errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", R[d], data.X()[d], d);
+      }
+      if (R[0] || R[1] || R[2] || R[3]) u = extendGaugeField(data, R);
+    }
+
+    const GaugeField &U = *u;
+    INSTANTIATE_PRECISION(plaquette, U, plq, location);
     double3 plaq = make_double3(0.5*(plq.x + plq.y), plq.x, plq.y);
+
+    if (u != &data) delete u;
     return plaq;
   }
 
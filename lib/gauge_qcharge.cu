@@ -4,6 +4,7 @@
 
 #include <launch_kernel.cuh>
 #include <jitify_helper.cuh>
+#include <host_parallel.h>
 #include <kernels/gauge_qcharge.cuh>
 
 namespace quda
@@ -45,14 +46,20 @@ public:
 #endif
         qudaDeviceSynchronize();
       } else { // run the CPU code
-        errorQuda("qChargeComputeKernel not supported on CPU");
+        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+        arg.result_h[0] = parallel_reduce_ordered(
+          tp, 2, arg.threads, 0.0, [&](int parity, int x_cb) { return qChargeSite<Float>(arg, x_cb, parity); },
+          [](double a, double b) { return a + b; });
       }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const
     {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec=" << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -75,6 +82,12 @@ public:
   {
     Float qChg = 0.0;
 
+    if (Fmunu.Location() == QUDA_CPU_FIELD_LOCATION) {
+      typedef typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type Gauge;
+      computeQCharge<Float, Gauge, density>(Gauge(Fmunu), Fmunu, qDensity, qChg);
+      return qChg;
+    }
+
     if (!Fmunu.isNative()) errorQuda("Topological charge computation only supported on native ordered fields");
 
     if (Fmunu.Reconstruct() == QUDA_RECONSTRUCT_NO) {
@@ -92,13 +105,21 @@ public:
 
     return qChg;
   }
+  static void checkQChargeField(const GaugeField &Fmunu)
+  {
+    if (Fmunu.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (Fmunu.Order() != QUDA_MILC_GAUGE_ORDER) errorQuda("Order %d not supported on the host", Fmunu.Order());
+    } else if (!Fmunu.isNative()) {
+      errorQuda("Order %d with %d reconstruct not supported", Fmunu.Order(), Fmunu.Reconstruct());
+    }
+  }
 #endif // GPU_GAUGE_TOOLS
 
   double computeQCharge(const GaugeField &Fmunu)
   {
     double qChg = 0.0;
 #ifdef GPU_GAUGE_TOOLS
-    if (!Fmunu.isNative()) errorQuda("Order %d with %d reconstruct not supported", Fmunu.Order(), Fmunu.Reconstruct());
+    checkQChargeField(Fmunu);
 
     if (Fmunu.Precision() == QUDA_SINGLE_PRECISION) {
       qChg = computeQCharge<float, false>(Fmunu);
@@ -117,7 +138,7 @@ public:
   {
     double qChg = 0.0;
 #ifdef GPU_GAUGE_TOOLS
-    if (!Fmunu.isNative()) errorQuda("Order %d with %d reconstruct not supported", Fmunu.Order(), Fmunu.Reconstruct());
+    checkQChargeField(Fmunu);
 
     if (Fmunu.Precision() == QUDA_SINGLE_PRECISION) {
       qChg = computeQCharge<float, true>(Fmunu, (float *)qDensity);
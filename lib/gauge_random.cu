@@ -8,6 +8,8 @@
 #include <cub_helper.cuh>
 #include <index_helper.cuh>
 #include <random_quda.h>
+#include <random_philox.h>
+#include <host_parallel.h>
 
 namespace quda {
 
@@ -36,7 +38,7 @@ namespace quda {
     }
   };
 
-  template <typename real, typename Link> __device__ __host__ Link gauss_su3(cuRNGState &localState)
+  template <typename real, typename Link, typename State> __device__ __host__ Link gauss_su3(State &localState)
   {
     Link ret;
     real rand1[4], rand2[4], phi[4], radius[4], temp1[4], temp2[4];
@@ -134,6 +136,168 @@ public:
     void postTune() { arg.rngstate.restore(); }
   };
 
+  /**
+     Arguments for counter-based generation: link U_mu(x) draws from
+     stream mu of the Philox blocks of the global index of x, so the
+     field is a function of the seed and the global lattice only.
+  */
+  template <typename Float, typename Gauge_, bool group_> struct GaugeGaussPhiloxArg {
+    using Gauge = Gauge_;
+    using real = typename mapper<Float>::type;
+    static constexpr bool group = group_;
+    int threads; // number of active threads required
+    int E[4]; // extended grid dimensions
+    int X[4]; // true grid dimensions
+    int border[4];
+    int offset[4]; // origin of the local lattice on the global one
+    int global[4]; // global lattice dimensions
+    Gauge U;
+    unsigned long long seed;
+    real sigma; // where U = exp(sigma * H)
+
+    GaugeGaussPhiloxArg(const Gauge &U, const GaugeField &meta, unsigned long long seed, double sigma) :
+      U(U), seed(seed), sigma(sigma)
+    {
+      for (int dir = 0; dir < 4; ++dir) {
+        border[dir] = meta.R()[dir];
+        E[dir] = meta.X()[dir];
+        X[dir] = meta.X()[dir] - border[dir] * 2;
+        offset[dir] = comm_coord(dir) * X[dir];
+        global[dir] = comm_dim(dir) * X[dir];
+      }
+      threads = X[0]*X[1]*X[2]*X[3]/2;
+    }
+  };
+
+  template <typename Float, typename Arg> __device__ __host__ inline void genGaussPhilox(Arg &arg, int parity, int x_cb)
+  {
+    using real = typename mapper<Float>::type;
+    using Link = Matrix<complex<real>, 3>;
+
+    int x[4];
+    getCoords(x, x_cb, arg.X, parity);
+    const unsigned long long site = globalSiteIndex(x, arg.offset, arg.global);
+    for (int dr = 0; dr < 4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
+
+    for (int mu = 0; mu < 4; mu++) {
+      Link u;
+      if (arg.group && arg.sigma == 0.0) {
+        setIdentity(&u);
+      } else {
+        PhiloxState localState;
+        philoxInit(localState, arg.seed, site, static_cast<unsigned long long>(mu) << 32);
+        u = gauss_su3<real, Link>(localState);
+        if (arg.group) {
+          u = arg.sigma * u;
+          expsu3<real>(u);
+        }
+      }
+      arg.U(mu, linkIndex(x, arg.E), parity) = u;
+    }
+  }
+
+  template <typename Float, typename Arg> __global__ void computeGenGaussPhilox(Arg arg)
+  {
+    int x_cb = threadIdx.x + blockIdx.x * blockDim.x;
+    int parity = threadIdx.y + blockIdx.y * blockDim.y;
+    if (x_cb >= arg.threads) return;
+    genGaussPhilox<Float>(arg, parity, x_cb);
+  }
+
+  template <typename Float, typename Arg> class GaugeGaussPhilox : TunableVectorY
+  {
+    Arg &arg;
+    const GaugeField &meta;
+
+private:
+    unsigned int minThreads() const { return arg.threads; }
+    bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
+
+public:
+    GaugeGaussPhilox(Arg &arg, GaugeField &meta) : TunableVectorY(2), arg(arg), meta(meta) {}
+
+    void apply(const cudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        computeGenGaussPhilox<Float><<<tp.grid, tp.block, tp.shared_bytes>>>(arg);
+      } else {
+        parallel_for(tp, 2, arg.threads, [&](int parity, int x_cb) { genGaussPhilox<Float>(arg, parity, x_cb); });
+      }
+    }
+
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
+    TuneKey tuneKey() const
+    {
+      std::stringstream aux;
+      aux << meta.AuxString();
+      if (hostLaunch()) aux << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    long long flops() const { return 0; }
+    long long bytes() const { return meta.Bytes(); }
+    // the field is a function of the seed alone, so there is no state to back up
+  };
+
+  template <typename Float, bool group, typename Gauge>
+  void genGaussPhilox(const Gauge &u, GaugeField &U, unsigned long long seed, double sigma)
+  {
+    GaugeGaussPhiloxArg<Float, Gauge, group> arg(u, U, seed, sigma);
+    GaugeGaussPhilox<Float, decltype(arg)> gaugeGauss(arg, U);
+    gaugeGauss.apply(0);
+  }
+
+  template <typename Float, QudaReconstructType recon, bool group>
+  void genGaussPhilox(GaugeField &U, unsigned long long seed, double sigma)
+  {
+    genGaussPhilox<Float, group>(typename gauge_mapper<Float, recon>::type(U), U, seed, sigma);
+  }
+
+  /** Host fields are filled in place in QDP and MILC order without reconstruction */
+  template <typename Float, bool group> void genGaussPhiloxHost(GaugeField &U, unsigned long long seed, double sigma)
+  {
+    if (U.Reconstruct() == QUDA_RECONSTRUCT_NO && U.Order() == QUDA_QDP_GAUGE_ORDER) {
+      genGaussPhilox<Float, group>(typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, 3>::type(U), U, seed, sigma);
+    } else if (U.Reconstruct() == QUDA_RECONSTRUCT_NO && U.Order() == QUDA_MILC_GAUGE_ORDER) {
+      genGaussPhilox<Float, group>(typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type(U), U, seed, sigma);
+    } else {
+      errorQuda("Order %d with %d reconstruct not supported", U.Order(), U.Reconstruct());
+    }
+  }
+
+  template <typename Float> void gaugeGauss(GaugeField &U, unsigned long long seed, double sigma)
+  {
+    if (U.LinkType() == QUDA_SU3_LINKS) {
+      if (getVerbosity() >= QUDA_SUMMARIZE)
+        printfQuda("Creating Gaussian distrbuted gauge field with sigma = %e\n", sigma);
+      if (!U.isNative()) {
+        genGaussPhiloxHost<Float, true>(U, seed, sigma);
+        return;
+      }
+      switch (U.Reconstruct()) {
+      case QUDA_RECONSTRUCT_NO: genGaussPhilox<Float, QUDA_RECONSTRUCT_NO, true>(U, seed, sigma); break;
+      case QUDA_RECONSTRUCT_13: genGaussPhilox<Float, QUDA_RECONSTRUCT_13, true>(U, seed, sigma); break;
+      case QUDA_RECONSTRUCT_12: genGaussPhilox<Float, QUDA_RECONSTRUCT_12, true>(U, seed, sigma); break;
+      case QUDA_RECONSTRUCT_9: genGaussPhilox<Float, QUDA_RECONSTRUCT_9, true>(U, seed, sigma); break;
+      case QUDA_RECONSTRUCT_8: genGaussPhilox<Float, QUDA_RECONSTRUCT_8, true>(U, seed, sigma); break;
+      default: errorQuda("Reconstruction type %d of gauge field not supported", U.Reconstruct());
+      }
+    } else if (U.LinkType() == QUDA_MOMENTUM_LINKS) {
+      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Creating Gaussian distrbuted momentum field\n");
+      if (!U.isNative()) {
+        genGaussPhiloxHost<Float, false>(U, seed, sigma);
+        return;
+      }
+      switch (U.Reconstruct()) {
+      case QUDA_RECONSTRUCT_NO: genGaussPhilox<Float, QUDA_RECONSTRUCT_NO, false>(U, seed, sigma); break;
+      case QUDA_RECONSTRUCT_10: genGaussPhilox<Float, QUDA_RECONSTRUCT_10, false>(U, seed, sigma); break;
+      default: errorQuda("Reconstruction type %d of gauge field not supported", U.Reconstruct());
+      }
+    }
+  }
+
   template <typename Float, QudaReconstructType recon, bool group>
   void genGauss(GaugeField &U, RNG &rngstate, double sigma)
   {
@@ -165,18 +329,24 @@ public:
     }
   }
 
-  void gaugeGauss(GaugeField &U, RNG &rngstate, double sigma)
+  /**
+     @brief Fill U in its precision, with either the RNG-state or the
+     seeded generator
+  */
+  template <typename... Args> void gaugeGaussDispatch(GaugeField &U, Args &&... args)
   {
-    if (!U.isNative()) errorQuda("Order %d with %d reconstruct not supported", U.Order(), U.Reconstruct());
-    if (U.Ncolor() != 3) errorQuda("Nc = %d not supported", U.Ncolor());
-
     switch (U.Precision()) {
-    case QUDA_DOUBLE_PRECISION: gaugeGauss<double>(U, rngstate, sigma); break;
-    case QUDA_SINGLE_PRECISION: gaugeGauss<float>(U, rngstate, sigma); break;
+    case QUDA_DOUBLE_PRECISION: gaugeGauss<double>(U, std::forward<Args>(args)...); break;
+    case QUDA_SINGLE_PRECISION: gaugeGauss<float>(U, std::forward<Args>(args)...); break;
     default: errorQuda("Precision %d not supported", U.Precision());
     }
+  }
 
-    // ensure multi-gpu consistency if required
+  /**
+     @brief Ensure multi-gpu consistency of a filled field if required
+  */
+  void gaugeGaussExchange(GaugeField &U)
+  {
     if (U.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED) {
       U.exchangeExtendedGhost(U.R());
     } else if (U.GhostExchange() == QUDA_GHOST_EXCHANGE_PAD) {
@@ -184,12 +354,38 @@ public:
     }
   }
 
-  void gaugeGauss(GaugeField &U, unsigned long long seed, double sigma)
+  void gaugeGauss(GaugeField &U, RNG &rngstate, double sigma)
   {
-    RNG *randstates = new RNG(U, seed);
-    randstates->Init();
-    quda::gaugeGauss(U, *randstates, sigma);
-    randstates->Release();
-    delete randstates;
+    if (!U.isNative()) errorQuda("Order %d with %d reconstruct not supported", U.Order(), U.Reconstruct());
+    if (U.Ncolor() != 3) errorQuda("Nc = %d not supported", U.Ncolor());
+
+    gaugeGaussDispatch(U, rngstate, sigma);
+    gaugeGaussExchange(U);
+  }
+
+  void gaugeGauss(GaugeField &U_, unsigned long long seed, double sigma)
+  {
+    if (U_.Ncolor() != 3) errorQuda("Nc = %d not supported", U_.Ncolor());
+
+    // host fields in QDP or MILC order without reconstruction are
+    // filled in place, the rest via a native device field
+    GaugeField *U = &U_;
+    const bool host = U_.Location() == QUDA_CPU_FIELD_LOCATION && U_.Reconstruct() == QUDA_RECONSTRUCT_NO
+      && (U_.Order() == QUDA_QDP_GAUGE_ORDER || U_.Order() == QUDA_MILC_GAUGE_ORDER);
+    if (!host && U_.Location() == QUDA_CPU_FIELD_LOCATION) {
+      GaugeFieldParam param(U_);
+      param.location = QUDA_CUDA_FIELD_LOCATION;
+      param.create = QUDA_NULL_FIELD_CREATE;
+      param.setPrecision(U_.Precision(), true); // change to native field order
+      U = GaugeField::Create(param);
+    }
+
+    gaugeGaussDispatch(*U, seed, sigma);
+
+    if (U != &U_) {
+      U_.copy(*U); // download result
+      delete U;
+    }
+    gaugeGaussExchange(U_);
   }
 }
@@ -0,0 +1,103 @@
+#include <algorithm>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <comm_quda.h>
+
+namespace quda {
+
+  /**
+     @brief Run nSteps of a smearing step whose stencil reaches radius
+     sites.  The input is copied into an extended field with a halo
+     depth sites deep in the partitioned dimensions; after each
+     exchange the halo stays valid for depth / radius steps, each of
+     which smears the interior plus whatever of the halo it can.  The
+     two extended fields are reused for every step.
+  */
+  template <typename Step>
+  static void smearSteps(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, int radius, int depth,
+                         const char *name, Step step)
+  {
+    if (nSteps < 0) errorQuda("Invalid number of steps %d", nSteps);
+    if (dataOr.Location() != dataDs.Location())
+      errorQuda("Origin and destination fields must have the same location");
+    if (dataOr.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED || dataDs.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED)
+      errorQuda("Origin and destination fields must not be extended");
+
+    // an odd depth would flip the parity the extended copy and the
+    // ghost exchange assign to the halo
+    if (depth == 0) depth = 2 * radius;
+    if (depth < radius || depth % radius != 0 || depth % 2 != 0)
+      errorQuda("Halo depth %d must be a positive even multiple of the stencil radius %d", depth, radius);
+
+    int R[4];
+    for (int d = 0; d < 4; d++) {
+      R[d] = comm_dim_partitioned(d) ? depth : 0;
+      if (R[d] > dataOr.X()[d])
+        errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", depth, dataOr.X()[d], d);
+    }
+    const int steps_per_exchange = depth / radius;
+
+    GaugeFieldParam param(dataOr);
+    for (int d = 0; d < 4; d++) {
+      param.x[d] = dataOr.X()[d] + 2 * R[d];
+      param.r[d] = R[d];
+    }
+    param.pad = 0;
+    param.nFace = 1;
+    param.ghostExchange = QUDA_GHOST_EXCHANGE_EXTENDED;
+    param.create = QUDA_NULL_FIELD_CREATE;
+    GaugeField *in = GaugeField::Create(param);
+    GaugeField *out = GaugeField::Create(param);
+
+    // both copies hold the input, so that directions a step does not
+    // smear (the temporal links for APE and STOUT) are carried through
+    copyExtendedGauge(*in, dataOr, dataOr.Location());
+    copyExtendedGauge(*out, dataOr, dataOr.Location());
+
+    int exchanges = 0;
+    for (int i = 0; i < nSteps;) {
+      in->exchangeExtendedGhost(R, false);
+      exchanges++;
+
+      const int n = std::min(steps_per_exchange, nSteps - i);
+      for (int k = 1; k <= n; k++, i++) {
+        int halo[4];
+        for (int d = 0; d < 4; d++) halo[d] = R[d] ? R[d] - k * radius : 0;
+        step(*out, *in, halo);
+        std::swap(in, out);
+      }
+    }
+
+    copyExtendedGauge(dataDs, *in, dataDs.Location());
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("%s: %d steps with halo depth %d and %d halo exchanges\n", name, nSteps, depth, exchanges);
+
+    delete out;
+    delete in;
+  }
+
+  void APEnStep(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, double alpha, int depth)
+  {
+    smearSteps(dataDs, dataOr, nSteps, 1, depth, "APE",
+               [=](GaugeField &out, const GaugeField &in, const int *halo) { APEStep(out, in, alpha, halo); });
+  }
+
+  void STOUTnStep(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, double rho, int depth)
+  {
+    smearSteps(dataDs, dataOr, nSteps, 1, depth, "STOUT",
+               [=](GaugeField &out, const GaugeField &in, const int *halo) { STOUTStep(out, in, rho, halo); });
+  }
+
+  void OvrImpSTOUTnStep(GaugeField &dataDs, const GaugeField &dataOr, int nSteps, double rho, double epsilon,
+                        int depth)
+  {
+    smearSteps(dataDs, dataOr, nSteps, 2, depth, "OvrImpSTOUT",
+               [=](GaugeField &out, const GaugeField &in, const int *halo) {
+                 OvrImpSTOUTStep(out, in, rho, epsilon, halo);
+               });
+  }
+
+} // namespace quda
@@ -6,6 +6,7 @@
 #define  SINGLE_TOL	2e-6
 
 #include <jitify_helper.cuh>
+#include <host_parallel.h>
 #include <kernels/gauge_stout.cuh>
 
 namespace quda {
@@ -33,8 +34,8 @@ public:
 
     void apply(const cudaStream_t &stream)
     {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
-        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 #ifdef JITIFY
         using namespace jitify::reflection;
         jitify_error = program->kernel("quda::computeSTOUTStep")
@@ -45,15 +46,19 @@ public:
         computeSTOUTStep<Float><<<tp.grid, tp.block, tp.shared_bytes>>>(arg);
 #endif
       } else {
-        errorQuda("CPU not supported yet\n");
-        // computeSTOUTStepCPU(arg);
+        parallel_for(tp, 2, arg.threads, [&](int parity, int idx) {
+          for (int dir = 0; dir < 3; dir++) stoutSite<Float>(arg, idx, parity, dir);
+        });
       }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const
     {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec=" << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -65,28 +70,41 @@ public:
   }; // GaugeSTOUT
 
   template<typename Float,typename GaugeOr, typename GaugeDs>
-  void STOUTStep(GaugeOr origin, GaugeDs dest, const GaugeField& dataOr, Float rho) {
-    GaugeSTOUTArg<Float,GaugeOr,GaugeDs> arg(origin, dest, dataOr, rho, dataOr.Precision() == QUDA_DOUBLE_PRECISION ? DOUBLE_TOL : SINGLE_TOL);
+  void STOUTStep(GaugeOr origin, GaugeDs dest, const GaugeField& dataOr, Float rho, const int *halo) {
+    GaugeSTOUTArg<Float,GaugeOr,GaugeDs> arg(origin, dest, dataOr, rho, dataOr.Precision() == QUDA_DOUBLE_PRECISION ? DOUBLE_TOL : SINGLE_TOL, halo);
     GaugeSTOUT<Float, GaugeSTOUTArg<Float, GaugeOr, GaugeDs>> gaugeSTOUT(arg, dataOr);
     gaugeSTOUT.apply(0);
-    qudaDeviceSynchronize();
+    if (dataOr.Location() == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
   }
 
   template<typename Float>
-  void STOUTStep(GaugeField &dataDs, const GaugeField& dataOr, Float rho) {
+  void STOUTStep(GaugeField &dataDs, const GaugeField& dataOr, Float rho, const int *halo) {
+
+    if (dataDs.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (dataDs.Order() == QUDA_QDP_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type G;
+        STOUTStep(G(dataOr), G(dataDs), dataOr, rho, halo);
+      } else if (dataDs.Order() == QUDA_MILC_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type G;
+        STOUTStep(G(dataOr), G(dataDs), dataOr, rho, halo);
+      } else {
+        errorQuda("Gauge field order %d not supported on the host", dataDs.Order());
+      }
+      return;
+    }
 
     if(dataDs.Reconstruct() == QUDA_RECONSTRUCT_NO) {
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GDs;
 
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
       }
@@ -94,13 +112,13 @@ public:
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GDs;
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
       }
@@ -108,13 +126,13 @@ public:
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GDs;
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho);
+	STOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
             }
@@ -126,7 +144,7 @@ public:
 
 #endif
 
-  void STOUTStep(GaugeField &dataDs, const GaugeField& dataOr, double rho) {
+  void STOUTStep(GaugeField &dataDs, const GaugeField& dataOr, double rho, const int *halo) {
 
 #ifdef GPU_GAUGE_TOOLS
 
@@ -138,16 +156,29 @@ public:
       errorQuda("Half precision not supported\n");
     }
 
-    if (!dataOr.isNative())
-      errorQuda("Order %d with %d reconstruct not supported", dataOr.Order(), dataOr.Reconstruct());
+    if (dataOr.Location() != dataDs.Location())
+      errorQuda("Origin and destination fields must have the same location");
 
-    if (!dataDs.isNative())
-      errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+    if (dataDs.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      if (!dataOr.isNative())
+        errorQuda("Order %d with %d reconstruct not supported", dataOr.Order(), dataOr.Reconstruct());
+
+      if (!dataDs.isNative())
+        errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+    } else {
+      if (dataOr.Order() != dataDs.Order() || dataDs.Reconstruct() != QUDA_RECONSTRUCT_NO
+          || dataOr.Reconstruct() != QUDA_RECONSTRUCT_NO)
+        errorQuda("Orders %d %d with %d %d reconstruct not supported", dataOr.Order(), dataDs.Order(),
+                  dataOr.Reconstruct(), dataDs.Reconstruct());
+
+      if (dataOr.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER || dataDs.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+        errorQuda("Site orders %d %d not supported", dataOr.SiteOrder(), dataDs.SiteOrder());
+    }
 
     if (dataDs.Precision() == QUDA_SINGLE_PRECISION){
-      STOUTStep<float>(dataDs, dataOr, (float) rho);
+      STOUTStep<float>(dataDs, dataOr, (float) rho, halo);
     } else if(dataDs.Precision() == QUDA_DOUBLE_PRECISION) {
-      STOUTStep<double>(dataDs, dataOr, rho);
+      STOUTStep<double>(dataDs, dataOr, rho, halo);
     } else {
       errorQuda("Precision %d not supported", dataDs.Precision());
     }
@@ -167,14 +198,14 @@ private:
     unsigned int minThreads() const { return arg.threads; }
 
 public:
-    // (2,3): 2 for parity in the y thread dim, 3 corresponds to mapping direction to the z thread dim
-    GaugeOvrImpSTOUT(Arg &arg, const GaugeField &meta) : TunableVectorYZ(2, 3), arg(arg), meta(meta) {}
+    // (2,4): 2 for parity in the y thread dim, 4 corresponds to mapping direction to the z thread dim
+    GaugeOvrImpSTOUT(Arg &arg, const GaugeField &meta) : TunableVectorYZ(2, 4), arg(arg), meta(meta) {}
     virtual ~GaugeOvrImpSTOUT() {}
 
     void apply(const cudaStream_t &stream)
     {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
-        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 #ifdef JITIFY
         using namespace jitify::reflection;
         jitify_error = program->kernel("quda::computeOvrImpSTOUTStep")
@@ -185,15 +216,19 @@ public:
         computeOvrImpSTOUTStep<Float><<<tp.grid, tp.block, tp.shared_bytes>>>(arg);
 #endif
       } else {
-        errorQuda("CPU not supported yet\n");
-        // computeOvrImpSTOUTStepCPU(arg);
+        parallel_for(tp, 2, arg.threads, [&](int parity, int idx) {
+          for (int dir = 0; dir < 4; dir++) ovrImpStoutSite<Float>(arg, idx, parity, dir);
+        });
       }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const
     {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec=" << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -205,29 +240,42 @@ public:
   }; // GaugeOvrImpSTOUT
 
   template<typename Float,typename GaugeOr, typename GaugeDs>
-  void OvrImpSTOUTStep(GaugeOr origin, GaugeDs dest, const GaugeField& dataOr, Float rho, Float epsilon) {
+  void OvrImpSTOUTStep(GaugeOr origin, GaugeDs dest, const GaugeField& dataOr, Float rho, Float epsilon, const int *halo) {
     GaugeOvrImpSTOUTArg<Float, GaugeOr, GaugeDs> arg(
-        origin, dest, dataOr, rho, epsilon, dataOr.Precision() == QUDA_DOUBLE_PRECISION ? DOUBLE_TOL : SINGLE_TOL);
+        origin, dest, dataOr, rho, epsilon, dataOr.Precision() == QUDA_DOUBLE_PRECISION ? DOUBLE_TOL : SINGLE_TOL, halo);
     GaugeOvrImpSTOUT<Float, GaugeOvrImpSTOUTArg<Float, GaugeOr, GaugeDs>> gaugeOvrImpSTOUT(arg, dataOr);
     gaugeOvrImpSTOUT.apply(0);
-    qudaDeviceSynchronize();
+    if (dataOr.Location() == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
   }
 
   template<typename Float>
-  void OvrImpSTOUTStep(GaugeField &dataDs, const GaugeField& dataOr, Float rho, Float epsilon) {
+  void OvrImpSTOUTStep(GaugeField &dataDs, const GaugeField& dataOr, Float rho, Float epsilon, const int *halo) {
+
+    if (dataDs.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (dataDs.Order() == QUDA_QDP_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type G;
+        OvrImpSTOUTStep(G(dataOr), G(dataDs), dataOr, rho, epsilon, halo);
+      } else if (dataDs.Order() == QUDA_MILC_GAUGE_ORDER) {
+        typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type G;
+        OvrImpSTOUTStep(G(dataOr), G(dataDs), dataOr, rho, epsilon, halo);
+      } else {
+        errorQuda("Gauge field order %d not supported on the host", dataDs.Order());
+      }
+      return;
+    }
 
     if(dataDs.Reconstruct() == QUDA_RECONSTRUCT_NO) {
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GDs;
 
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
       }
@@ -235,13 +283,13 @@ public:
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GDs;
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
       }
@@ -249,13 +297,13 @@ public:
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GDs;
       if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_NO){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_12){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else if(dataOr.Reconstruct() == QUDA_RECONSTRUCT_8){
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type GOr;
-	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon);
+	OvrImpSTOUTStep(GOr(dataOr), GDs(dataDs), dataOr, rho, epsilon, halo);
       }else{
 	errorQuda("Reconstruction type %d of origin gauge field not supported", dataOr.Reconstruct());
             }
@@ -266,7 +314,7 @@ public:
   }
 
 
-  void OvrImpSTOUTStep(GaugeField &dataDs, const GaugeField& dataOr, double rho, double epsilon) {
+  void OvrImpSTOUTStep(GaugeField &dataDs, const GaugeField& dataOr, double rho, double epsilon, const int *halo) {
 
 #ifdef GPU_GAUGE_TOOLS
 
@@ -278,16 +326,29 @@ public:
       errorQuda("Half precision not supported\n");
     }
 
-    if (!dataOr.isNative())
-      errorQuda("Order %d with %d reconstruct not supported", dataOr.Order(), dataOr.Reconstruct());
+    if (dataOr.Location() != dataDs.Location())
+      errorQuda("Origin and destination fields must have the same location");
 
-    if (!dataDs.isNative())
-      errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+    if (dataDs.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      if (!dataOr.isNative())
+        errorQuda("Order %d with %d reconstruct not supported", dataOr.Order(), dataOr.Reconstruct());
+
+      if (!dataDs.isNative())
+        errorQuda("Order %d with %d reconstruct not supported", dataDs.Order(), dataDs.Reconstruct());
+    } else {
+      if (dataOr.Order() != dataDs.Order() || dataDs.Reconstruct() != QUDA_RECONSTRUCT_NO
+          || dataOr.Reconstruct() != QUDA_RECONSTRUCT_NO)
+        errorQuda("Orders %d %d with %d %d reconstruct not supported", dataOr.Order(), dataDs.Order(),
+                  dataOr.Reconstruct(), dataDs.Reconstruct());
+
+      if (dataOr.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER || dataDs.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+        errorQuda("Site orders %d %d not supported", dataOr.SiteOrder(), dataDs.SiteOrder());
+    }
 
     if (dataDs.Precision() == QUDA_SINGLE_PRECISION){
-      OvrImpSTOUTStep<float>(dataDs, dataOr, (float) rho, epsilon);
+      OvrImpSTOUTStep<float>(dataDs, dataOr, (float) rho, (float) epsilon, halo);
     } else if(dataDs.Precision() == QUDA_DOUBLE_PRECISION) {
-      OvrImpSTOUTStep<double>(dataDs, dataOr, rho, epsilon);
+      OvrImpSTOUTStep<double>(dataDs, dataOr, rho, epsilon, halo);
     } else {
       errorQuda("Precision %d not supported", dataDs.Precision());
     }
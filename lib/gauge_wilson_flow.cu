@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cmath>
+
+#include <quda_internal.h>
+#include <tune_quda.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+
+#include <launch_kernel.cuh>
+#include <jitify_helper.cuh>
+#include <host_parallel.h>
+#include <kernels/gauge_wilson_flow.cuh>
+
+namespace quda {
+
+#ifdef GPU_GAUGE_TOOLS
+
+  static const char *wflow_type_str(QudaWFlowType type)
+  {
+    switch (type) {
+    case QUDA_WFLOW_TYPE_WILSON: return "Wilson";
+    case QUDA_WFLOW_TYPE_SYMANZIK: return "Symanzik";
+    case QUDA_WFLOW_TYPE_ZEUTHEN: return "Zeuthen";
+    default: errorQuda("Unknown flow type %d", type);
+    }
+    return nullptr;
+  }
+
+  template <typename Float, typename Arg> class GaugeWFlowForce : TunableVectorYZ
+  {
+    Arg &arg;
+    const GaugeField &meta;
+
+private:
+    bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
+    unsigned int minThreads() const { return arg.threads; }
+
+public:
+    // (2,4): 2 for parity in the y thread dim, 4 corresponds to mapping direction to the z thread dim
+    GaugeWFlowForce(Arg &arg, const GaugeField &meta) : TunableVectorYZ(2, 4), arg(arg), meta(meta)
+    {
+#ifdef JITIFY
+      create_jitify_program("kernels/gauge_wilson_flow.cuh");
+#endif
+    }
+    virtual ~GaugeWFlowForce() {}
+
+    void apply(const cudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+#ifdef JITIFY
+        using namespace jitify::reflection;
+        jitify_error = program->kernel("quda::computeWFlowForce")
+                         .instantiate(Type<Float>(), Type<Arg>())
+                         .configure(tp.grid, tp.block, tp.shared_bytes, stream)
+                         .launch(arg);
+#else
+        computeWFlowForce<Float><<<tp.grid, tp.block, tp.shared_bytes>>>(arg);
+#endif
+      } else {
+        parallel_for(tp, 2, arg.threads, [&](int parity, int idx) {
+          for (int dir = 0; dir < 4; dir++) wflowForceSite<Float>(arg, idx, parity, dir);
+        });
+      }
+    }
+
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
+    TuneKey tuneKey() const
+    {
+      std::stringstream aux;
+      aux << "threads=" << arg.threads << ",prec=" << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    long long flops() const { return 4 * (18 + 2 + 2 * 4) * 198ll * arg.threads; } // just counts matrix multiplication
+    long long bytes() const { return 4 * ((1 + 2 * 12) * arg.origin.Bytes() + arg.force.Bytes()) * arg.threads; }
+  }; // GaugeWFlowForce
+
+  template <typename Float, typename Arg> class GaugeWFlowStep : TunableLocalParity
+  {
+    Arg &arg;
+    const GaugeField &meta;
+
+private:
+    bool tuneGridDim() const { return true; }
+
+public:
+    GaugeWFlowStep(Arg &arg, const GaugeField &meta) : TunableLocalParity(), arg(arg), meta(meta)
+    {
+#ifdef JITIFY
+      create_jitify_program("kernels/gauge_wilson_flow.cuh");
+#endif
+    }
+    virtual ~GaugeWFlowStep() {}
+
+    void apply(const cudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        arg.result_h[0] = WFlowReduceType();
+#ifdef JITIFY
+        using namespace jitify::reflection;
+        jitify_error = program->kernel("quda::computeWFlowStep")
+                         .instantiate((int)tp.block.x, Type<Float>(), Type<Arg>())
+                         .configure(tp.grid, tp.block, tp.shared_bytes, stream)
+                         .launch(arg);
+#else
+        LAUNCH_KERNEL_LOCAL_PARITY(computeWFlowStep, tp, stream, arg, Float, Arg);
+#endif
+      } else {
+        arg.result_h[0] = parallel_reduce_ordered(
+          tp, 2, arg.threads, WFlowReduceType(),
+          [&](int parity, int idx) { return wflowSite<Float>(arg, idx, parity); }, WFlowReducer());
+      }
+    }
+
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
+    TuneKey tuneKey() const
+    {
+      std::stringstream aux;
+      aux << "threads=" << arg.threads << ",prec=" << sizeof(Float) << ",type=" << wflow_type_str(arg.type)
+          << ",stage=" << arg.stage;
+      if (arg.measure) aux << ",measure";
+      if (arg.estimate) aux << ",estimate";
+      if (hostLaunch()) aux << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    // the second stage updates the accumulator in place
+    void preTune()
+    {
+      if (arg.stage == 1) arg.acc.save();
+    }
+    void postTune()
+    {
+      if (arg.stage == 1) arg.acc.load();
+    }
+
+    long long flops() const
+    {
+      long long site = arg.measure ? 6 * (16 * 198ll + 2 * 198) : 0;
+      if (arg.stage >= 0) {
+        long long link = (arg.type == QUDA_WFLOW_TYPE_WILSON ? 2 * 6 + 1 : 18 + 2 + 2 * 4) * 198ll + 4 * 198ll;
+        if (arg.type == QUDA_WFLOW_TYPE_ZEUTHEN) link = 5 * 198ll + 4 * 198ll;
+        site += 4 * link;
+      }
+      return 2 * site * arg.threads;
+    }
+
+    long long bytes() const
+    {
+      long long site = arg.measure ? 6 * 12 * arg.origin.Bytes() : 0;
+      if (arg.stage >= 0) {
+        long long link = (arg.type == QUDA_WFLOW_TYPE_WILSON ? 1 + 2 * 6 : 1 + 2 * 12) * arg.origin.Bytes();
+        if (arg.type == QUDA_WFLOW_TYPE_ZEUTHEN) link = 2 * arg.origin.Bytes() + 3 * arg.force.Bytes();
+        link += arg.dest.Bytes() + (arg.stage > 0 ? 2 : 1) * arg.acc.Bytes();
+        if (arg.estimate) link += 2 * arg.low.Bytes();
+        site += 4 * link;
+      }
+      return 2 * site * arg.threads;
+    }
+  }; // GaugeWFlowStep
+
+  /**
+     @brief Run one Runge-Kutta stage, preceded by the Symanzik force
+     pass for the Zeuthen flow.  Optional fields that are absent are
+     replaced by origin, which the kernels never touch in their place.
+  */
+  template <typename Float, typename Gauge>
+  WFlowReduceType WFlowStage(GaugeField &dest, const GaugeField &origin, GaugeField &acc, GaugeField *force,
+                             GaugeField *w0, GaugeField *low, QudaWFlowType type, int stage, Float epsilon,
+                             bool measure)
+  {
+    const bool estimate = low != nullptr;
+
+    if (type == QUDA_WFLOW_TYPE_ZEUTHEN && stage >= 0) {
+      // the second derivative reads the force one link beyond the region
+      int halo[4];
+      for (int d = 0; d < 4; d++) halo[d] = origin.R()[d] ? 1 : 0;
+      Gauge U(origin), F(*force);
+      GaugeWFlowArg<Float, Gauge> arg(U, U, U, F, U, U, origin, type, stage, epsilon, false, false, halo);
+      GaugeWFlowForce<Float, decltype(arg)> wflowForce(arg, origin);
+      wflowForce.apply(0);
+    }
+
+    Gauge U(origin), W(dest), A(acc), F(force ? *force : origin), W0(w0 ? *w0 : origin), L(low ? *low : origin);
+    GaugeWFlowArg<Float, Gauge> arg(U, W, A, F, W0, L, origin, type, stage, epsilon, measure, estimate);
+    GaugeWFlowStep<Float, decltype(arg)> wflowStep(arg, origin);
+    wflowStep.apply(0);
+    if (origin.Location() == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
+
+    WFlowReduceType result = arg.result_h[0];
+    comm_allreduce_array(&result[0], 3);
+    comm_allreduce_max(&result[3]);
+    return result;
+  }
+
+  template <typename Float>
+  WFlowReduceType WFlowStage(GaugeField &dest, const GaugeField &origin, GaugeField &acc, GaugeField *force,
+                             GaugeField *w0, GaugeField *low, QudaWFlowType type, int stage, double epsilon,
+                             bool measure)
+  {
+    if (origin.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      typedef typename gauge_mapper<Float, QUDA_RECONSTRUCT_NO>::type G;
+      return WFlowStage<Float, G>(dest, origin, acc, force, w0, low, type, stage, (Float)epsilon, measure);
+    } else if (origin.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, 3>::type G;
+      return WFlowStage<Float, G>(dest, origin, acc, force, w0, low, type, stage, (Float)epsilon, measure);
+    } else if (origin.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float, QUDA_MILC_GAUGE_ORDER, 3>::type G;
+      return WFlowStage<Float, G>(dest, origin, acc, force, w0, low, type, stage, (Float)epsilon, measure);
+    } else {
+      errorQuda("Gauge field order %d not supported on the host", origin.Order());
+    }
+    return WFlowReduceType();
+  }
+
+  static WFlowReduceType WFlowStage(GaugeField &dest, const GaugeField &origin, GaugeField &acc, GaugeField *force,
+                                    GaugeField *w0, GaugeField *low, QudaWFlowType type, int stage, double epsilon,
+                                    bool measure)
+  {
+    if (origin.Precision() == QUDA_DOUBLE_PRECISION) {
+      return WFlowStage<double>(dest, origin, acc, force, w0, low, type, stage, epsilon, measure);
+    } else if (origin.Precision() == QUDA_SINGLE_PRECISION) {
+      return WFlowStage<float>(dest, origin, acc, force, w0, low, type, stage, epsilon, measure);
+    } else {
+      errorQuda("Precision %d not supported", origin.Precision());
+    }
+    return WFlowReduceType();
+  }
+
+  /**
+     @brief Normalize the reduced sums of a measurement on a lattice of
+     global volume V
+  */
+  static WFlowObservables WFlowObservablesFrom(const WFlowReduceType &sums, double t, double V)
+  {
+    WFlowObservables obs;
+    obs.t = t;
+    obs.plaquette = sums[0] / (6 * 3 * V);
+    obs.E_plaq = 2.0 * (6 * 3 - sums[0] / V);
+    obs.E_clover = sums[1] / V;
+    obs.Q = sums[2];
+    return obs;
+  }
+
+  /**
+     @brief Create a reconstruct-no extended field with halo depth R
+     matching the field u (native order on the device)
+  */
+  static GaugeField *createWFlowField(const GaugeField &u, const int *R)
+  {
+    GaugeFieldParam param(u);
+    for (int d = 0; d < 4; d++) {
+      param.x[d] = u.X()[d] + 2 * R[d];
+      param.r[d] = R[d];
+    }
+    param.pad = 0;
+    param.nFace = 1;
+    param.ghostExchange = QUDA_GHOST_EXCHANGE_EXTENDED;
+    param.reconstruct = QUDA_RECONSTRUCT_NO;
+    param.link_type = QUDA_WILSON_LINKS;
+    param.create = QUDA_NULL_FIELD_CREATE;
+    if (u.Location() == QUDA_CUDA_FIELD_LOCATION) param.order = QUDA_FLOAT2_GAUGE_ORDER;
+    param.setPrecision(u.Precision());
+    return GaugeField::Create(param);
+  }
+
+  static void checkWFlowField(const GaugeField &u)
+  {
+    if (u.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED) errorQuda("Gauge field must not be extended");
+    if (u.Precision() == QUDA_HALF_PRECISION) errorQuda("Half precision not supported");
+    if (u.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (u.Order() != QUDA_QDP_GAUGE_ORDER && u.Order() != QUDA_MILC_GAUGE_ORDER)
+        errorQuda("Gauge field order %d not supported on the host", u.Order());
+      if (u.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Site order %d not supported", u.SiteOrder());
+    }
+  }
+
+#endif // GPU_GAUGE_TOOLS
+
+  WFlowObservables WFlowMeasure(const GaugeField &U)
+  {
+    WFlowObservables obs = {};
+#ifdef GPU_GAUGE_TOOLS
+    checkWFlowField(U);
+
+    // the clovers reach one site, but an odd halo depth would flip the
+    // parity the extended copy and the ghost exchange assign to the halo
+    int R[4];
+    for (int d = 0; d < 4; d++) {
+      R[d] = comm_dim_partitioned(d) ? 2 : 0;
+      if (R[d] > U.X()[d])
+        errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", R[d], U.X()[d], d);
+    }
+    GaugeField *W = createWFlowField(U, R);
+    copyExtendedGauge(*W, U, U.Location());
+    W->exchangeExtendedGhost(R, false);
+
+    WFlowReduceType sums
+      = WFlowStage(*W, *W, *W, nullptr, nullptr, nullptr, QUDA_WFLOW_TYPE_WILSON, -1, 0.0, true);
+    obs = WFlowObservablesFrom(sums, 0.0, (double)U.Volume() * comm_size());
+
+    delete W;
+#else
+    errorQuda("Gauge tools are not built");
+#endif
+    return obs;
+  }
+
+  std::vector<WFlowObservables> WFlow(GaugeField &out, const GaugeField &in, QudaWFlowType type, double t_max,
+                                      double epsilon, double tolerance, int meas_interval)
+  {
+    std::vector<WFlowObservables> obs;
+#ifdef GPU_GAUGE_TOOLS
+    checkWFlowField(in);
+    checkWFlowField(out);
+    if (in.Location() != out.Location()) errorQuda("Input and output fields must have the same location");
+    if (in.Precision() != out.Precision()) errorQuda("Input and output fields must have the same precision");
+    if (t_max < 0.0 || epsilon <= 0.0 || tolerance < 0.0 || meas_interval < 0)
+      errorQuda("Invalid flow parameters t_max=%e epsilon=%e tolerance=%e meas_interval=%d", t_max, epsilon,
+                tolerance, meas_interval);
+
+    // halo depth: the clover and Wilson staples reach one site, the
+    // rectangles two, and the Zeuthen derivative of the force one more,
+    // rounded up to even so that the halo keeps the parity of the bulk
+    if (type != QUDA_WFLOW_TYPE_WILSON && type != QUDA_WFLOW_TYPE_SYMANZIK && type != QUDA_WFLOW_TYPE_ZEUTHEN)
+      errorQuda("Unknown flow type %d", type);
+    const int depth = type == QUDA_WFLOW_TYPE_ZEUTHEN ? 4 : 2;
+    int R[4];
+    for (int d = 0; d < 4; d++) {
+      R[d] = comm_dim_partitioned(d) ? depth : 0;
+      if (R[d] > in.X()[d])
+        errorQuda("Halo depth %d exceeds the local lattice extent %d in dimension %d", R[d], in.X()[d], d);
+    }
+
+    // W[0] holds the field at the start of the step; an adaptive
+    // integrator keeps it intact in case the step is rejected, so the
+    // second stage writes to W[2], else it overwrites W[0]
+    const bool adaptive = tolerance > 0.0;
+    GaugeField *W[3];
+    W[0] = createWFlowField(in, R);
+    W[1] = createWFlowField(in, R);
+    W[2] = adaptive ? createWFlowField(in, R) : nullptr;
+    GaugeField *acc = createWFlowField(in, R);
+    GaugeField *force = type == QUDA_WFLOW_TYPE_ZEUTHEN ? createWFlowField(in, R) : nullptr;
+    GaugeField *low = adaptive ? createWFlowField(in, R) : nullptr;
+    copyExtendedGauge(*W[0], in, in.Location());
+
+    const double V = (double)in.Volume() * comm_size();
+    const double t_tol = 1e-10 * t_max;
+    double t = 0.0;
+    int steps = 0, rejected = 0;
+    bool measured = false; // at the current flow time
+
+    while (t < t_max - t_tol) {
+      const double eps = std::min(epsilon, t_max - t);
+      const bool measure = meas_interval > 0 && steps % meas_interval == 0 && !measured;
+
+      W[0]->exchangeExtendedGhost(R, false);
+      WFlowReduceType sums = WFlowStage(*W[1], *W[0], *acc, force, nullptr, nullptr, type, 0, eps, measure);
+      if (measure) {
+        obs.push_back(WFlowObservablesFrom(sums, t, V));
+        measured = true;
+      }
+
+      GaugeField *mid = adaptive ? W[2] : W[0];
+      W[1]->exchangeExtendedGhost(R, false);
+      WFlowStage(*mid, *W[1], *acc, force, adaptive ? W[0] : nullptr, low, type, 1, eps, false);
+
+      mid->exchangeExtendedGhost(R, false);
+      sums = WFlowStage(*W[1], *mid, *acc, force, nullptr, low, type, 2, eps, false);
+
+      if (adaptive) {
+        const double distance = sums[3];
+        const double factor = distance > 0.0 ? 0.95 * std::cbrt(tolerance / distance) : 2.0;
+        if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+          printfQuda("WFlow: t = %e, epsilon = %e, distance = %e\n", t, eps, distance);
+        if (distance > tolerance) {
+          // repeat the step from W[0] with a smaller step size
+          epsilon = eps * std::max(factor, 0.1);
+          rejected++;
+          continue;
+        }
+        // don't let a short final step shrink the step size
+        if (eps == epsilon) epsilon = eps * std::min(factor, 2.0);
+      }
+
+      std::swap(W[0], W[1]);
+      t += eps;
+      steps++;
+      measured = false;
+    }
+
+    if (meas_interval > 0) {
+      W[0]->exchangeExtendedGhost(R, false);
+      WFlowReduceType sums = WFlowStage(*W[0], *W[0], *acc, nullptr, nullptr, nullptr, type, -1, 0.0, true);
+      obs.push_back(WFlowObservablesFrom(sums, t, V));
+    }
+
+    copyExtendedGauge(out, *W[0], out.Location());
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      for (auto &o : obs)
+        printfQuda("WFlow: t = %e plaq = %.12e E = %.12e t^2 E = %.12e Q = %.12e\n", o.t, o.plaquette, o.E_clover,
+                   o.t * o.t * o.E_clover, o.Q);
+    }
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("WFlow: %s flow to t = %e in %d steps (%d rejected)\n", wflow_type_str(type), t, steps, rejected);
+
+    if (adaptive) {
+      delete low;
+      delete W[2];
+    }
+    if (force) delete force;
+    delete acc;
+    delete W[1];
+    delete W[0];
+#else
+    errorQuda("Gauge tools are not built");
+#endif
+    return obs;
+  }
+
+} // namespace quda
@@ -1,28 +1,38 @@
 /**
-   Generic blas kernel with four loads and up to four stores.
+   Generic blas kernel with four loads and up to four stores.  The
+   parity and site loops are flattened into a single OpenMP
+   work-sharing loop, and the inner spin-color loop (which is
+   contiguous in memory for space-spin-color ordered fields) is
+   marked for vectorization.
   */
 template <typename Float, int writeX, int writeY, int writeZ, int writeW, int writeV, typename SpinorX,
     typename SpinorY, typename SpinorZ, typename SpinorW, typename SpinorV, typename Functor>
 void genericBlas(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV &V, Functor f)
 {
+  const int nParity = X.Nparity();
+  const int volumeCB = X.VolumeCB();
+  const int nSpin = X.Nspin();
+  const int nColor = X.Ncolor();
 
-  for (int parity = 0; parity < X.Nparity(); parity++) {
-    for (int x = 0; x < X.VolumeCB(); x++) {
-      for (int s = 0; s < X.Nspin(); s++) {
-        for (int c = 0; c < X.Ncolor(); c++) {
-          complex<Float> X_(X(parity, x, s, c));
-          complex<Float> Y_ = Y(parity, x, s, c);
-          complex<Float> Z_ = Z(parity, x, s, c);
-          complex<Float> W_ = W(parity, x, s, c);
-          complex<Float> V_ = V(parity, x, s, c);
-          f(X_, Y_, Z_, W_, V_);
-          if (writeX) X(parity, x, s, c) = X_;
-          if (writeY) Y(parity, x, s, c) = Y_;
-          if (writeZ) Z(parity, x, s, c) = Z_;
-          if (writeW) W(parity, x, s, c) = W_;
-          if (writeV) V(parity, x, s, c) = V_;
-        }
-      }
+#pragma omp parallel for firstprivate(f)
+  for (int i = 0; i < nParity * volumeCB; i++) {
+    const int parity = i / volumeCB;
+    const int x = i - parity * volumeCB;
+#pragma omp simd
+    for (int sc = 0; sc < nSpin * nColor; sc++) {
+      const int s = sc / nColor;
+      const int c = sc - s * nColor;
+      complex<Float> X_(X(parity, x, s, c));
+      complex<Float> Y_ = Y(parity, x, s, c);
+      complex<Float> Z_ = Z(parity, x, s, c);
+      complex<Float> W_ = W(parity, x, s, c);
+      complex<Float> V_ = V(parity, x, s, c);
+      f(X_, Y_, Z_, W_, V_);
+      if (writeX) X(parity, x, s, c) = X_;
+      if (writeY) Y(parity, x, s, c) = Y_;
+      if (writeZ) Z(parity, x, s, c) = Z_;
+      if (writeW) W(parity, x, s, c) = W_;
+      if (writeV) V(parity, x, s, c) = V_;
     }
   }
 }
@@ -0,0 +1,322 @@
+/**
+   Upper bound on the thread-local footprint of the host multi-blas
+   tile buffers (all X, Y, Z and W tiles together).  This bounds the
+   tile sizes that are considered by the autotuner, and is chosen so
+   that a tile stays resident in the per-core L2 cache.
+ */
+constexpr size_t host_tile_bytes = 256 * 1024;
+
+/**
+   @brief Raw accessor used by the host multi-blas and multi-reduce
+   tile kernels.  For QUDA_SPACE_SPIN_COLOR_FIELD_ORDER the
+   degrees of freedom of a given site are contiguous, so a tile of
+   consecutive sites on a given parity is a contiguous run of
+   memory.  This allows the tiles to be streamed in and out without
+   having to instantiate the kernels on nSpin and nColor.
+ */
+template <typename Float> struct HostTileAccessor {
+  complex<Float> *v;
+  int offset_cb;
+  int site_size;
+  int volumeCB;
+
+  HostTileAccessor(const ColorSpinorField &field) :
+    v(static_cast<complex<Float> *>(const_cast<void *>(field.V()))),
+    offset_cb((field.Bytes() >> 1) / sizeof(complex<Float>)),
+    site_size(field.Nspin() * field.Ncolor()),
+    volumeCB(field.VolumeCB())
+  {
+    if (field.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+      errorQuda("CPU multi-blas not implemented for %d field order", field.FieldOrder());
+    if (field.Precision() != sizeof(Float))
+      errorQuda("Field precision %d does not match accessor precision %lu", field.Precision(), sizeof(Float));
+  }
+
+  /**
+     @brief Copy sites [begin, end) of this field into buf
+     @param[out] buf Tile buffer of length (end - begin) * site_size
+     @param[in] begin First site (parity * volumeCB + x_cb) in the tile
+     @param[in] end One past the last site in the tile
+   */
+  template <typename Float2> inline void load(Float2 *buf, int begin, int end) const
+  {
+    for (int i = begin; i < end; i++) {
+      const int parity = i / volumeCB;
+      const complex<Float> *site = v + parity * offset_cb + (i - parity * volumeCB) * site_size;
+      Float2 *b = buf + (i - begin) * site_size;
+#pragma omp simd
+      for (int e = 0; e < site_size; e++) {
+        b[e].x = site[e].real();
+        b[e].y = site[e].imag();
+      }
+    }
+  }
+
+  /**
+     @brief Copy buf back into sites [begin, end) of this field
+     @param[in] buf Tile buffer of length (end - begin) * site_size
+     @param[in] begin First site (parity * volumeCB + x_cb) in the tile
+     @param[in] end One past the last site in the tile
+   */
+  template <typename Float2> inline void store(const Float2 *buf, int begin, int end)
+  {
+    for (int i = begin; i < end; i++) {
+      const int parity = i / volumeCB;
+      complex<Float> *site = v + parity * offset_cb + (i - parity * volumeCB) * site_size;
+      const Float2 *b = buf + (i - begin) * site_size;
+#pragma omp simd
+      for (int e = 0; e < site_size; e++) site[e] = complex<Float>(b[e].x, b[e].y);
+    }
+  }
+};
+
+/**
+   @brief Convert a coefficient matrix to the compute precision of
+   the host kernel and point the host-side matrix pointer used by
+   the functors at it.
+ */
+template <typename Float2, typename T>
+inline void setHostCoeff(std::vector<Float2> &M, signed char *&M_h, const T *data, int NXZ, int NYW)
+{
+  if (!data) return;
+  M.resize(NXZ * NYW);
+  for (int i = 0; i < NXZ * NYW; i++) M[i] = make_Float2<Float2>(Complex(data[i]));
+  M_h = reinterpret_cast<signed char *>(M.data());
+}
+
+/**
+   @brief Base class for the host multi-blas and multi-reduce
+   kernels.  The sites are split into tiles; within a tile each
+   vector is streamed from memory exactly once into a thread-local
+   buffer and the full NXZ x NYW block is then applied to the
+   cache-resident tiles.  The number of sites per tile is the tuned
+   parameter, and is stored in aux.x.
+ */
+class HostMultiTile : public Tunable
+{
+
+protected:
+  std::vector<ColorSpinorField *> &x, &y, &z, &w;
+  const int NYW;
+  const int length;
+  const bool write_y;
+  const bool write_w;
+
+  // bytes of all tile buffers per lattice site
+  const size_t site_bytes;
+
+  // host backups of the output fields when tuning
+  std::vector<std::vector<char>> Y_h, W_h;
+
+  unsigned int sharedBytesPerThread() const { return 0; }
+  unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+
+  int maxTileSites() const { return std::max(1, std::min(length, (int)(host_tile_bytes / site_bytes))); }
+
+public:
+  HostMultiTile(std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y,
+                std::vector<ColorSpinorField *> &z, std::vector<ColorSpinorField *> &w, int NYW,
+                bool write_y, bool write_w, int n_buffer, size_t float2_size) :
+    x(x),
+    y(y),
+    z(z),
+    w(w),
+    NYW(NYW),
+    length(x[0]->SiteSubset() * x[0]->VolumeCB()),
+    write_y(write_y),
+    write_w(write_w),
+    site_bytes(n_buffer * x[0]->Nspin() * x[0]->Ncolor() * float2_size)
+  {
+    strcpy(aux, x[0]->AuxString());
+    if (x[0]->Precision() != y[0]->Precision()) {
+      strcat(aux, ",");
+      strcat(aux, y[0]->AuxString());
+    }
+    strcat(aux, ",cpu");
+  }
+
+  virtual ~HostMultiTile() {}
+
+  bool advanceTuneParam(TuneParam &param) const
+  {
+    if (2 * param.aux.x <= maxTileSites()) {
+      param.aux.x *= 2;
+      return true;
+    } else {
+      param.aux.x = 1;
+      return false;
+    }
+  }
+
+  void initTuneParam(TuneParam &param) const
+  {
+    Tunable::initTuneParam(param);
+    param.aux = make_int4(1, 0, 0, 0);
+  }
+
+  void defaultTuneParam(TuneParam &param) const
+  {
+    Tunable::defaultTuneParam(param);
+    param.aux = make_int4(std::min(16, maxTileSites()), 0, 0, 0);
+  }
+
+  std::string paramString(const TuneParam &param) const
+  {
+    std::stringstream ps;
+    ps << "tile_sites=" << param.aux.x;
+    return ps.str();
+  }
+
+  void preTune()
+  {
+    for (int i = 0; i < NYW; i++) {
+      if (write_y) Y_h.emplace_back((char *)y[i]->V(), (char *)y[i]->V() + y[i]->Bytes());
+      if (write_w) W_h.emplace_back((char *)w[i]->V(), (char *)w[i]->V() + w[i]->Bytes());
+    }
+  }
+
+  void postTune()
+  {
+    for (int i = 0; i < NYW; i++) {
+      if (write_y) memcpy(y[i]->V(), Y_h[i].data(), y[i]->Bytes());
+      if (write_w) memcpy(w[i]->V(), W_h[i].data(), w[i]->Bytes());
+    }
+    Y_h.clear();
+    W_h.clear();
+  }
+
+  int tuningIter() const { return 3; }
+};
+
+/**
+   Host multi-blas kernel: y[k] and w[k] are updated with the
+   contributions from all x[l] (and z[l]) for l < NXZ, applying the
+   functor in the same (k, l) order as the device kernel.
+ */
+template <int NXZ, typename Float2, typename xFloat, typename yFloat, typename Functor, typename write>
+class HostMultiBlas : public HostMultiTile
+{
+  mutable Functor f;
+  std::vector<HostTileAccessor<xFloat>> X, Z, W;
+  std::vector<HostTileAccessor<yFloat>> Y;
+  std::vector<Float2> A, B, C;
+
+public:
+  template <typename T>
+  HostMultiBlas(const coeff_array<T> &a, const coeff_array<T> &b, const coeff_array<T> &c,
+                std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y,
+                std::vector<ColorSpinorField *> &z, std::vector<ColorSpinorField *> &w) :
+    HostMultiTile(x, y, z, w, y.size(), write::Y, Functor::use_w && write::W,
+                  (Functor::use_z ? 2 : 1) * NXZ + (Functor::use_w ? 2 : 1) * y.size(), sizeof(Float2)),
+    f(y.size())
+  {
+    for (int l = 0; l < NXZ; l++) {
+      X.emplace_back(*x[l]);
+      if (Functor::use_z) Z.emplace_back(*z[l]);
+    }
+    for (int k = 0; k < NYW; k++) {
+      Y.emplace_back(*y[k]);
+      if (Functor::use_w) W.emplace_back(*w[k]);
+    }
+
+    setHostCoeff(A, Amatrix_h, a.data, NXZ, NYW);
+    setHostCoeff(B, Bmatrix_h, b.data, NXZ, NYW);
+    setHostCoeff(C, Cmatrix_h, c.data, NXZ, NYW);
+  }
+
+  TuneKey tuneKey() const
+  {
+    char name[TuneKey::name_n];
+    strcpy(name, num_to_string<NXZ>::value);
+    strcat(name, std::to_string(NYW).c_str());
+    strcat(name, typeid(f).name());
+    return TuneKey(x[0]->VolString(), name, aux);
+  }
+
+  void apply(const cudaStream_t &stream)
+  {
+    TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+    const int tile_sites = tp.aux.x;
+    const int tile_length = tile_sites * x[0]->Nspin() * x[0]->Ncolor();
+    const int n_tile = (length + tile_sites - 1) / tile_sites;
+
+#pragma omp parallel
+    {
+      Functor f_ = f;
+      std::vector<Float2> x_(NXZ * tile_length);
+      std::vector<Float2> z_(Functor::use_z ? NXZ * tile_length : 0);
+      std::vector<Float2> y_(NYW * tile_length);
+      std::vector<Float2> w_(Functor::use_w ? NYW * tile_length : 0);
+
+#pragma omp for schedule(static)
+      for (int t = 0; t < n_tile; t++) {
+        const int begin = t * tile_sites;
+        const int end = std::min(length, begin + tile_sites);
+        const int n = (end - begin) * x[0]->Nspin() * x[0]->Ncolor();
+
+        for (int l = 0; l < NXZ; l++) {
+          X[l].load(&x_[l * tile_length], begin, end);
+          if (Functor::use_z) Z[l].load(&z_[l * tile_length], begin, end);
+        }
+        for (int k = 0; k < NYW; k++) {
+          Y[k].load(&y_[k * tile_length], begin, end);
+          if (Functor::use_w) W[k].load(&w_[k * tile_length], begin, end);
+        }
+
+        for (int k = 0; k < NYW; k++) {
+          Float2 *yt = &y_[k * tile_length];
+          Float2 *wt = Functor::use_w ? &w_[k * tile_length] : yt;
+          for (int l = 0; l < NXZ; l++) {
+            Float2 *xt = &x_[l * tile_length];
+            Float2 *zt = Functor::use_z ? &z_[l * tile_length] : xt;
+#pragma omp simd
+            for (int e = 0; e < n; e++) f_(xt[e], yt[e], zt[e], wt[e], k, l);
+          }
+        }
+
+        for (int k = 0; k < NYW; k++) {
+          if (write::Y) Y[k].store(&y_[k * tile_length], begin, end);
+          if (Functor::use_w && write::W) W[k].store(&w_[k * tile_length], begin, end);
+        }
+      }
+    }
+  }
+
+  long long flops() const { return f.flops() * 2ll * x[0]->Nspin() * x[0]->Ncolor() * length; }
+
+  long long bytes() const
+  {
+    // the factor two here assumes we are reading and writing to the high precision vector
+    return ((f.streams() - 2) * x[0]->Bytes() + 2 * y[0]->Bytes());
+  }
+};
+
+/**
+   Driver for the host multi-blas kernel, instantiated on the storage
+   precision of the x/z/w and y fields.  The kernel computes in the
+   precision of y.
+ */
+template <int NXZ, template <int, typename, typename> class Functor, typename write, typename T>
+void genericMultiBlas(const coeff_array<T> &a, const coeff_array<T> &b, const coeff_array<T> &c,
+                      std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y,
+                      std::vector<ColorSpinorField *> &z, std::vector<ColorSpinorField *> &w)
+{
+  if (x[0]->Precision() == QUDA_DOUBLE_PRECISION && y[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+    HostMultiBlas<NXZ, double2, double, double, Functor<NXZ, double2, double2>, write> blas(a, b, c, x, y, z, w);
+    blas.apply(0);
+    blas::bytes += blas.bytes();
+    blas::flops += blas.flops();
+  } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION && y[0]->Precision() == QUDA_SINGLE_PRECISION) {
+    HostMultiBlas<NXZ, float2, float, float, Functor<NXZ, float2, float2>, write> blas(a, b, c, x, y, z, w);
+    blas.apply(0);
+    blas::bytes += blas.bytes();
+    blas::flops += blas.flops();
+  } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION && y[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+    HostMultiBlas<NXZ, double2, float, double, Functor<NXZ, double2, double2>, write> blas(a, b, c, x, y, z, w);
+    blas.apply(0);
+    blas::bytes += blas.bytes();
+    blas::flops += blas.flops();
+  } else {
+    errorQuda("Precision combination x=%d y=%d not supported\n", x[0]->Precision(), y[0]->Precision());
+  }
+}
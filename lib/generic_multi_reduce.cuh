@@ -0,0 +1,162 @@
+/**
+   Host multi-reduce kernel: computes the NXZ x NYW block of
+   reductions r(x[l], y[k], z[l], w[k]) with each vector streamed
+   once per tile.  The sites are first split into chunks of
+   host_reduce_chunk sites, whose partial sums are combined in a
+   fixed order, so the result depends on neither the thread count
+   nor the tuned tile size.
+ */
+template <int NXZ, typename doubleN, typename Float2, typename xFloat, typename yFloat, typename Reducer,
+          typename write>
+class HostMultiReduce : public HostMultiTile
+{
+  doubleN *result;
+  mutable Reducer r;
+  std::vector<HostTileAccessor<xFloat>> X, Z, W;
+  std::vector<HostTileAccessor<yFloat>> Y;
+  std::vector<Float2> A, B, C;
+
+public:
+  template <typename T>
+  HostMultiReduce(doubleN result[], const coeff_array<T> &a, const coeff_array<T> &b, const coeff_array<T> &c,
+                  std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y,
+                  std::vector<ColorSpinorField *> &z, std::vector<ColorSpinorField *> &w) :
+    HostMultiTile(x, y, z, w, y.size(), write::Y, Reducer::use_w && write::W,
+                  (Reducer::use_z ? 2 : 1) * NXZ + (Reducer::use_w ? 2 : 1) * y.size(), sizeof(Float2)),
+    result(result),
+    r(a, b, c, y.size())
+  {
+    for (int l = 0; l < NXZ; l++) {
+      X.emplace_back(*x[l]);
+      if (Reducer::use_z) Z.emplace_back(*z[l]);
+    }
+    for (int k = 0; k < NYW; k++) {
+      Y.emplace_back(*y[k]);
+      if (Reducer::use_w) W.emplace_back(*w[k]);
+    }
+
+    setHostCoeff(A, Amatrix_h, a.data, NXZ, NYW);
+    setHostCoeff(B, Bmatrix_h, b.data, NXZ, NYW);
+    setHostCoeff(C, Cmatrix_h, c.data, NXZ, NYW);
+  }
+
+  TuneKey tuneKey() const
+  {
+    char name[TuneKey::name_n];
+    strcpy(name, num_to_string<NXZ>::value);
+    strcat(name, std::to_string(NYW).c_str());
+    strcat(name, typeid(r).name());
+    return TuneKey(x[0]->VolString(), name, aux);
+  }
+
+  void apply(const cudaStream_t &stream)
+  {
+    TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+    const int site_size = x[0]->Nspin() * x[0]->Ncolor();
+    const int tile_sites = std::min(tp.aux.x, host_reduce_chunk);
+    const int tile_length = tile_sites * site_size;
+    const int n_chunk = (length + host_reduce_chunk - 1) / host_reduce_chunk;
+    std::vector<doubleN> partial(n_chunk * NXZ * NYW);
+
+#pragma omp parallel
+    {
+      Reducer r_ = r;
+      std::vector<Float2> x_(NXZ * tile_length);
+      std::vector<Float2> z_(Reducer::use_z ? NXZ * tile_length : 0);
+      std::vector<Float2> y_(NYW * tile_length);
+      std::vector<Float2> w_(Reducer::use_w ? NYW * tile_length : 0);
+
+#pragma omp for schedule(static)
+      for (int chunk = 0; chunk < n_chunk; chunk++) {
+        doubleN *sum = &partial[chunk * NXZ * NYW];
+        for (int i = 0; i < NXZ * NYW; i++) ::quda::zero(sum[i]);
+        const int chunk_end = std::min(length, (chunk + 1) * host_reduce_chunk);
+
+        for (int begin = chunk * host_reduce_chunk; begin < chunk_end; begin += tile_sites) {
+          const int end = std::min(chunk_end, begin + tile_sites);
+
+          for (int l = 0; l < NXZ; l++) {
+            X[l].load(&x_[l * tile_length], begin, end);
+            if (Reducer::use_z) Z[l].load(&z_[l * tile_length], begin, end);
+          }
+          for (int k = 0; k < NYW; k++) {
+            Y[k].load(&y_[k * tile_length], begin, end);
+            if (Reducer::use_w) W[k].load(&w_[k * tile_length], begin, end);
+          }
+
+          for (int k = 0; k < NYW; k++) {
+            Float2 *yt = &y_[k * tile_length];
+            Float2 *wt = Reducer::use_w ? &w_[k * tile_length] : yt;
+            for (int l = 0; l < NXZ; l++) {
+              Float2 *xt = &x_[l * tile_length];
+              Float2 *zt = Reducer::use_z ? &z_[l * tile_length] : xt;
+              for (int s = 0; s < end - begin; s++) {
+                doubleN site_sum;
+                ::quda::zero(site_sum);
+                r_.pre();
+                for (int e = s * site_size; e < (s + 1) * site_size; e++)
+                  r_(site_sum, xt[e], yt[e], zt[e], wt[e], k, l);
+                r_.post(site_sum);
+                sum[l * NYW + k] += site_sum;
+              }
+            }
+          }
+
+          for (int k = 0; k < NYW; k++) {
+            if (write::Y) Y[k].store(&y_[k * tile_length], begin, end);
+            if (Reducer::use_w && write::W) W[k].store(&w_[k * tile_length], begin, end);
+          }
+        }
+      }
+    }
+
+    for (int i = 0; i < NXZ * NYW; i++) {
+      KahanSum<doubleN> sum;
+      for (int chunk = 0; chunk < n_chunk; chunk++) sum += partial[chunk * NXZ * NYW + i];
+      result[i] = sum.result();
+    }
+  }
+
+  long long flops() const { return NYW * NXZ * r.flops() * 2ll * x[0]->Nspin() * x[0]->Ncolor() * length; }
+
+  long long bytes() const
+  {
+    // each vector is only streamed once regardless of the tile shape
+    return (NXZ * (Reducer::use_z ? 2 : 1)) * x[0]->Bytes()
+      + NYW * (1 + write::Y) * y[0]->Bytes() + (Reducer::use_w ? NYW * (1 + write::W) * w[0]->Bytes() : 0);
+  }
+};
+
+/**
+   Driver for the host multi-reduce kernel, instantiated on the
+   storage precision of the x/z/w and y fields.  The kernel computes
+   in the precision of y and accumulates in double precision.
+ */
+template <int NXZ, typename doubleN, template <int, typename, typename, typename> class Reducer, typename write,
+          typename T>
+void genericMultiReduce(doubleN result[], const coeff_array<T> &a, const coeff_array<T> &b, const coeff_array<T> &c,
+                        std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y,
+                        std::vector<ColorSpinorField *> &z, std::vector<ColorSpinorField *> &w)
+{
+  if (x[0]->Precision() == QUDA_DOUBLE_PRECISION && y[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+    HostMultiReduce<NXZ, doubleN, double2, double, double, Reducer<NXZ, doubleN, double2, double2>, write> reduce(
+      result, a, b, c, x, y, z, w);
+    reduce.apply(0);
+    blas::bytes += reduce.bytes();
+    blas::flops += reduce.flops();
+  } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION && y[0]->Precision() == QUDA_SINGLE_PRECISION) {
+    HostMultiReduce<NXZ, doubleN, float2, float, float, Reducer<NXZ, doubleN, float2, float2>, write> reduce(
+      result, a, b, c, x, y, z, w);
+    reduce.apply(0);
+    blas::bytes += reduce.bytes();
+    blas::flops += reduce.flops();
+  } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION && y[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+    HostMultiReduce<NXZ, doubleN, double2, float, double, Reducer<NXZ, doubleN, double2, double2>, write> reduce(
+      result, a, b, c, x, y, z, w);
+    reduce.apply(0);
+    blas::bytes += reduce.bytes();
+    blas::flops += reduce.flops();
+  } else {
+    errorQuda("Precision combination x=%d y=%d not supported\n", x[0]->Precision(), y[0]->Precision());
+  }
+}
@@ -1,17 +1,77 @@
 /**
-   Generic reduce kernel with four loads and up to four stores.
+   Number of sites in each work chunk of the host reduction.  The
+   chunk decomposition does not depend on the number of OpenMP
+   threads, so the order of summation, and hence the result, is
+   reproducible regardless of the thread count.
+ */
+constexpr int host_reduce_chunk = 1024;
+
+/**
+   @brief Compensated (Kahan) summation of a vector of doubles
+   (double, double2, double3 or double4).  This is the host
+   counterpart of the double-double accumulation used on the device,
+   and bounds the accumulated rounding error independently of the
+   length of the sum.
+ */
+template <typename ReduceType> struct KahanSum {
+  static constexpr int n = sizeof(ReduceType) / sizeof(double);
+  double sum[n];
+  double comp[n];
+
+  KahanSum()
+  {
+    for (int i = 0; i < n; i++) sum[i] = comp[i] = 0.0;
+  }
+
+  KahanSum &operator+=(const ReduceType &value)
+  {
+    const double *v = reinterpret_cast<const double *>(&value);
+    for (int i = 0; i < n; i++) {
+      double y = v[i] - comp[i];
+      double t = sum[i] + y;
+      comp[i] = (t - sum[i]) - y;
+      sum[i] = t;
+    }
+    return *this;
+  }
+
+  ReduceType result() const
+  {
+    ReduceType value;
+    double *v = reinterpret_cast<double *>(&value);
+    for (int i = 0; i < n; i++) v[i] = sum[i];
+    return value;
+  }
+};
+
+/**
+   Generic reduce kernel with four loads and up to four stores.  Each
+   chunk of sites is reduced by a single thread with its own copy of
+   the reducer (since pre() and post() may carry per-site state), and
+   the chunk partial sums are then combined in a fixed order.
   */
 template <typename ReduceType, typename Float, int writeX, int writeY, int writeZ, int writeW, int writeV,
     typename SpinorX, typename SpinorY, typename SpinorZ, typename SpinorW, typename SpinorV, typename Reducer>
 ReduceType genericReduce(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV &V, Reducer r)
 {
+  const int length = X.Nparity() * X.VolumeCB();
+  const int volumeCB = X.VolumeCB();
+  const int n_chunk = (length + host_reduce_chunk - 1) / host_reduce_chunk;
+  std::vector<ReduceType> partial(n_chunk);
+
+#pragma omp parallel for schedule(static)
+  for (int chunk = 0; chunk < n_chunk; chunk++) {
+    Reducer r_ = r;
+    KahanSum<ReduceType> chunk_sum;
+    const int end = std::min(length, (chunk + 1) * host_reduce_chunk);
 
-  ReduceType sum;
-  ::quda::zero(sum);
+    for (int i = chunk * host_reduce_chunk; i < end; i++) {
+      const int parity = i / volumeCB;
+      const int x = i - parity * volumeCB;
 
-  for (int parity = 0; parity < X.Nparity(); parity++) {
-    for (int x = 0; x < X.VolumeCB(); x++) {
-      r.pre();
+      ReduceType site_sum;
+      ::quda::zero(site_sum);
+      r_.pre();
       for (int s = 0; s < X.Nspin(); s++) {
         for (int c = 0; c < X.Ncolor(); c++) {
           complex<Float> X_ = X(parity, x, s, c);
@@ -19,7 +79,7 @@ ReduceType genericReduce(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV
           complex<Float> Z_ = Z(parity, x, s, c);
           complex<Float> W_ = W(parity, x, s, c);
           complex<Float> V_ = V(parity, x, s, c);
-          r(sum, X_, Y_, Z_, W_, V_);
+          r_(site_sum, X_, Y_, Z_, W_, V_);
           if (writeX) X(parity, x, s, c) = X_;
           if (writeY) Y(parity, x, s, c) = Y_;
           if (writeZ) Z(parity, x, s, c) = Z_;
@@ -27,11 +87,15 @@ ReduceType genericReduce(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV
           if (writeV) V(parity, x, s, c) = V_;
         }
       }
-      r.post(sum);
+      r_.post(site_sum);
+      chunk_sum += site_sum;
     }
+    partial[chunk] = chunk_sum.result();
   }
 
-  return sum;
+  KahanSum<ReduceType> sum;
+  for (int chunk = 0; chunk < n_chunk; chunk++) sum += partial[chunk];
+  return sum.result();
 }
 
 template <typename ReduceType, typename Float, typename zFloat, int nSpin, int nColor, QudaFieldOrder order, int writeX,
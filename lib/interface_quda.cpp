@@ -31,10 +31,9 @@
 #include <multigrid.h>
 
 #include <deflation.h>
+#include <tiered_vector_store.h>
 
-#ifdef NUMA_NVML
 #include <numa_affinity.h>
-#endif
 
 #ifdef QUDA_NVML
 #include <nvml.h>
@@ -148,7 +147,14 @@ std::vector<cudaColorSpinorField*> solutionResident;
 // vector of spinors used for forecasting solutions in HMC
 #define QUDA_MAX_CHRONO 12
 // each entry is one p
-std::vector< std::vector<ColorSpinorField*> > chronoResident(QUDA_MAX_CHRONO);
+std::vector<TieredVectorStore *> chronoResident(QUDA_MAX_CHRONO, nullptr);
+
+// subspace recycled between GCRO-DR solves
+static RecycleSpace *recycleResident = nullptr;
+
+// incremented whenever the gauge or clover field changes, so that
+// state carried between solves can tell that the operator has changed
+static int operatorGeneration = 0;
 
 // Mapped memory buffer used to hold unitarization failures
 static int *num_failures_h = nullptr;
@@ -222,6 +228,9 @@ static TimeProfile profileSTOUT("STOUTQuda");
 //!< Profiler for OvrImpSTOUTQuda
 static TimeProfile profileOvrImpSTOUT("OvrImpSTOUTQuda");
 
+//!< Profiler for WFlowQuda
+static TimeProfile profileWFlow("WFlowQuda");
+
 //!< Profiler for projectSU3Quda
 static TimeProfile profileProject("projectSU3Quda");
 
@@ -611,6 +620,10 @@ void initQudaDevice(int dev) {
   }
 #endif
 
+  // pin the host threads used for CPU-location kernels (after setting the NUMA affinity above)
+  char *enable_pinning_env = getenv("QUDA_ENABLE_THREAD_PINNING");
+  if (enable_pinning_env && strcmp(enable_pinning_env, "1") == 0) setHostThreadAffinity();
+
 
 
   cudaDeviceSetCacheConfig(cudaFuncCachePreferL1);
@@ -734,6 +747,7 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
   if (getVerbosity() == QUDA_DEBUG_VERBOSE) printQudaGaugeParam(param);
 
   checkGaugeParam(param);
+  operatorGeneration++;
 
   profileGauge.TPSTART(QUDA_PROFILE_INIT);
   // Set the specific input parameters and create the cpu gauge field
@@ -988,6 +1002,7 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
   profileClover.TPSTART(QUDA_PROFILE_INIT);
 
   checkCloverParam(inv_param);
+  operatorGeneration++;
   bool device_calc = false; // calculate clover and inverse on the device?
 
   pushVerbosity(inv_param->verbosity);
@@ -1450,12 +1465,18 @@ void flushChronoQuda(int i)
   if (i >= QUDA_MAX_CHRONO)
     errorQuda("Requested chrono index %d is outside of max %d\n", i, QUDA_MAX_CHRONO);
 
-  auto &basis = chronoResident[i];
+  if (chronoResident[i]) {
+    delete chronoResident[i];
+    chronoResident[i] = nullptr;
+  }
+}
 
-  for (auto v : basis) {
-    if (v)  delete v;
+void flushRecycleQuda(void)
+{
+  if (recycleResident) {
+    delete recycleResident;
+    recycleResident = nullptr;
   }
-  basis.clear();
 }
 
 void endQuda(void)
@@ -1468,6 +1489,7 @@ void endQuda(void)
   freeCloverQuda();
 
   for (int i=0; i<QUDA_MAX_CHRONO; i++) flushChronoQuda(i);
+  flushRecycleQuda();
 
   for (auto v : solutionResident) if (v) delete v;
   solutionResident.clear();
@@ -1530,6 +1552,7 @@ void endQuda(void)
     profileQCharge.Print();
     profileAPE.Print();
     profileSTOUT.Print();
+    profileWFlow.Print();
     profileProject.Print();
     profilePhase.Print();
     profileMomAction.Print();
@@ -2771,7 +2794,10 @@ deflated_solver::deflated_solver(QudaEigParam &eig_param, TimeProfile &profile)
   ritzParam.create        = QUDA_ZERO_FIELD_CREATE;
   ritzParam.is_composite  = true;
   ritzParam.is_component  = false;
+  // only the first ritz_resident_dim vectors are allocated here, the remainder are kept in host memory
   ritzParam.composite_dim = param->nev*param->deflation_grid;
+  if (eig_param.ritz_resident_dim > 0 && eig_param.ritz_resident_dim < ritzParam.composite_dim)
+    ritzParam.composite_dim = eig_param.ritz_resident_dim;
   ritzParam.setPrecision(param->cuda_prec_ritz);
 
   if (ritzParam.location==QUDA_CUDA_FIELD_LOCATION) {
@@ -2827,6 +2853,108 @@ void destroyDeflationQuda(void *df) {
   delete static_cast<deflated_solver*>(df);
 }
 
+/**
+   Return the subspace recycled between GCRO-DR solves, ready for a
+   solve of the given system.  The space is discarded if the field
+   geometry or storage precision has changed.  If the operator has
+   changed (the gauge or clover field, or the operator parameters), it
+   is either marked stale, so that the solver recomputes its image
+   under the new operator, or discarded, according to
+   param.recycle_keep_on_update.
+ */
+static RecycleSpace *recycleSpace(const QudaInvertParam &param, const ColorSpinorField &b, bool normal)
+{
+  if (recycleResident && recycleResident->Dim() > 0) {
+    const ColorSpinorField &u = *recycleResident->U[0];
+    if (u.Volume() != b.Volume() || u.SiteSubset() != b.SiteSubset() || u.Nspin() != b.Nspin()
+        || u.Ncolor() != b.Ncolor() || recycleResident->precision != param.cuda_prec_recycle)
+      flushRecycleQuda();
+  }
+  if (!recycleResident) recycleResident = new RecycleSpace(param.cuda_prec_recycle);
+
+  std::vector<double> op_key = {static_cast<double>(operatorGeneration),
+                                static_cast<double>(param.dslash_type),
+                                static_cast<double>(param.matpc_type),
+                                static_cast<double>(param.dagger),
+                                normal ? 1.0 : 0.0,
+                                param.kappa,
+                                param.mass,
+                                param.mu,
+                                param.epsilon,
+                                param.m5};
+
+  if (recycleResident->Dim() > 0 && op_key != recycleResident->op_key) {
+    if (param.recycle_keep_on_update) {
+      recycleResident->stale = true;
+    } else {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Operator changed, discarding the recycled subspace\n");
+      recycleResident->clear();
+    }
+  }
+  recycleResident->op_key = op_key;
+
+  return recycleResident;
+}
+
+/**
+   Construct the initial guess x for the solution of m x = b from the
+   chronological basis param.chrono_index by minimum residual
+   extrapolation.  When part of the basis is held in host memory, the
+   basis and its image under m are streamed rather than orthogonalized
+   in place.
+ */
+static void chronoForecast(ColorSpinorField &x, ColorSpinorField &b, DiracMatrix &m, DiracMatrix &mSloppy,
+                           const QudaInvertParam &param, bool hermitian)
+{
+  TieredVectorStore &basis = *chronoResident[param.chrono_index];
+
+  DiracMatrix *mat = nullptr;
+  if (param.chrono_precision == param.cuda_prec) {
+    mat = &m;
+  } else if (param.chrono_precision == param.cuda_prec_sloppy) {
+    mat = &mSloppy;
+  } else {
+    errorQuda("Unexpected precision %d for chrono vectors (doesn't match outer %d or sloppy precision %d)",
+              param.chrono_precision, param.cuda_prec, param.cuda_prec_sloppy);
+  }
+
+  ColorSpinorParam cs_param(basis.Param());
+  ColorSpinorField *tmp = ColorSpinorField::Create(cs_param);
+  ColorSpinorField *tmp2 = (param.chrono_precision == x.Precision()) ? &x : ColorSpinorField::Create(cs_param);
+
+  bool orthogonal = true;
+  bool apply_mat = false;
+  MinResExt mre(m, orthogonal, apply_mat, hermitian, profileInvert);
+
+  if (basis.AllResident()) {
+    std::vector<ColorSpinorField *> p = basis.Resident();
+    std::vector<ColorSpinorField *> Ap;
+    for (unsigned int k = 0; k < p.size(); k++) Ap.emplace_back(ColorSpinorField::Create(cs_param));
+    for (unsigned int j = 0; j < p.size(); j++) (*mat)(*Ap[j], *p[j], *tmp, *tmp2);
+
+    blas::copy(*tmp, b);
+    mre(x, *tmp, p, Ap);
+
+    for (auto ap : Ap) delete ap;
+  } else {
+    TieredVectorStore Ap(cs_param, basis.Size(), basis.NumResident(), param.chrono_spill_precision);
+    ColorSpinorField *ap = ColorSpinorField::Create(cs_param);
+    basis.apply([&](std::vector<ColorSpinorField *> &p, int offset) {
+      for (unsigned int j = 0; j < p.size(); j++) {
+        (*mat)(*ap, *p[j], *tmp, *tmp2);
+        Ap.set(offset + j, *ap);
+      }
+    });
+    delete ap;
+
+    blas::copy(*tmp, b);
+    mre(x, *tmp, basis, Ap);
+  }
+
+  delete tmp;
+  if (tmp2 != &x) delete tmp2;
+}
+
 void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
 {
   profilerStart(__func__);
@@ -3026,45 +3154,16 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     SolverParam solverParam(*param);
     // chronological forecasting
-    if (param->chrono_use_resident && chronoResident[param->chrono_index].size() > 0) {
+    if (param->chrono_use_resident && chronoResident[param->chrono_index]
+        && chronoResident[param->chrono_index]->Size() > 0) {
       profileInvert.TPSTART(QUDA_PROFILE_CHRONO);
-
-      auto &basis = chronoResident[param->chrono_index];
-
-      ColorSpinorParam cs_param(*basis[0]);
-      ColorSpinorField *tmp = ColorSpinorField::Create(cs_param);
-      ColorSpinorField *tmp2 = (param->chrono_precision == out->Precision()) ? out : ColorSpinorField::Create(cs_param);
-      std::vector<ColorSpinorField*> Ap;
-      for (unsigned int k=0; k < basis.size(); k++) {
-        Ap.emplace_back((ColorSpinorField::Create(cs_param)));
-      }
-
-      if (param->chrono_precision == param->cuda_prec) {
-        for (unsigned int j=0; j<basis.size(); j++) m(*Ap[j], *basis[j], *tmp, *tmp2);
-      } else if (param->chrono_precision == param->cuda_prec_sloppy) {
-        for (unsigned int j=0; j<basis.size(); j++) mSloppy(*Ap[j], *basis[j], *tmp, *tmp2);
-      } else {
-        errorQuda("Unexpected precision %d for chrono vectors (doesn't match outer %d or sloppy precision %d)",
-                  param->chrono_precision, param->cuda_prec, param->cuda_prec_sloppy);
-      }
-
-      bool orthogonal = true;
-      bool apply_mat = false;
       bool hermitian = false;
-      MinResExt mre(m, orthogonal, apply_mat, hermitian, profileInvert);
-
-      blas::copy(*tmp, *in);
-      mre(*out, *tmp, basis, Ap);
-
-      for (auto ap: Ap) {
-        if (ap) delete (ap);
-      }
-      delete tmp;
-      if (tmp2 != out) delete tmp2;
-
+      chronoForecast(*out, *in, m, mSloppy, *param, hermitian);
       profileInvert.TPSTOP(QUDA_PROFILE_CHRONO);
     }
 
+    if (param->inv_type == QUDA_GCRODR_INVERTER) solverParam.deflation_op = recycleSpace(*param, *in, false);
+
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
@@ -3074,45 +3173,16 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     SolverParam solverParam(*param);
 
     // chronological forecasting
-    if (param->chrono_use_resident && chronoResident[param->chrono_index].size() > 0) {
+    if (param->chrono_use_resident && chronoResident[param->chrono_index]
+        && chronoResident[param->chrono_index]->Size() > 0) {
       profileInvert.TPSTART(QUDA_PROFILE_CHRONO);
-
-      auto &basis = chronoResident[param->chrono_index];
-
-      ColorSpinorParam cs_param(*basis[0]);
-      std::vector<ColorSpinorField*> Ap;
-      ColorSpinorField *tmp = ColorSpinorField::Create(cs_param);
-      ColorSpinorField *tmp2 = (param->chrono_precision == out->Precision()) ? out : ColorSpinorField::Create(cs_param);
-      for (unsigned int k=0; k < basis.size(); k++) {
-        Ap.emplace_back((ColorSpinorField::Create(cs_param)));
-      }
-
-      if (param->chrono_precision == param->cuda_prec) {
-        for (unsigned int j=0; j<basis.size(); j++) m(*Ap[j], *basis[j], *tmp, *tmp2);
-      } else if (param->chrono_precision == param->cuda_prec_sloppy) {
-        for (unsigned int j=0; j<basis.size(); j++) mSloppy(*Ap[j], *basis[j], *tmp, *tmp2);
-      } else {
-        errorQuda("Unexpected precision %d for chrono vectors (doesn't match outer %d or sloppy precision %d)",
-                  param->chrono_precision, param->cuda_prec, param->cuda_prec_sloppy);
-      }
-
-      bool orthogonal = true;
-      bool apply_mat = false;
       bool hermitian = true;
-      MinResExt mre(m, orthogonal, apply_mat, hermitian, profileInvert);
-
-      blas::copy(*tmp, *in);
-      mre(*out, *tmp, basis, Ap);
-
-      for (auto ap: Ap) {
-        if (ap) delete(ap);
-      }
-      delete tmp;
-      if (tmp2 != out) delete tmp2;
-
+      chronoForecast(*out, *in, m, mSloppy, *param, hermitian);
       profileInvert.TPSTOP(QUDA_PROFILE_CHRONO);
     }
 
+    if (param->inv_type == QUDA_GCRODR_INVERTER) solverParam.deflation_op = recycleSpace(*param, *in, true);
+
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
@@ -3145,24 +3215,36 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
 
     auto &basis = chronoResident[i];
 
-    if(param->chrono_max_dim < (int)basis.size()){
-      errorQuda("Requested chrono_max_dim %i is smaller than already existing chroology %i",param->chrono_max_dim,(int)basis.size());
+    if (basis && param->chrono_max_dim < basis->Size()) {
+      errorQuda("Requested chrono_max_dim %i is smaller than already existing chroology %i",param->chrono_max_dim,basis->Size());
     }
 
-    if(not param->chrono_replace_last){
-      // if we have not filled the space yet just augment
-      if ((int)basis.size() < param->chrono_max_dim) {
-        ColorSpinorParam cs_param(*out);
-        cs_param.setPrecision(param->chrono_precision);
-        basis.emplace_back(ColorSpinorField::Create(cs_param));
+    // the first chrono_resident_dim vectors are kept on the device, the remainder in host memory
+    int n_resident = param->chrono_resident_dim > 0 ? param->chrono_resident_dim : param->chrono_max_dim;
+
+    if (!basis || basis->Capacity() != param->chrono_max_dim) {
+      ColorSpinorParam cs_param(*out);
+      cs_param.setPrecision(param->chrono_precision);
+      auto *grown = new TieredVectorStore(cs_param, param->chrono_max_dim, n_resident, param->chrono_spill_precision);
+      if (basis) {
+        // carry over the existing chronology
+        ColorSpinorField *tmp = ColorSpinorField::Create(cs_param);
+        for (int j = 0; j < basis->Size(); j++) {
+          basis->get(*tmp, j);
+          grown->set(j, *tmp);
+        }
+        delete tmp;
+        delete basis;
       }
+      basis = grown;
+    }
 
-      // shuffle every entry down one and bring the last to the front
-      ColorSpinorField *tmp = basis[basis.size()-1];
-      for (unsigned int j=basis.size()-1; j>0; j--) basis[j] = basis[j-1];
-        basis[0] = tmp;
+    if (not param->chrono_replace_last || basis->Size() == 0) {
+      // bring the new solution to the front, shuffling every entry down one
+      basis->pushFront(*out);
+    } else {
+      basis->set(0, *out); // set first entry to new solution
     }
-    *(basis[0]) = *out; // set first entry to new solution
   }
   dirac.reconstruct(*x, *b, param->solution_type);
 
@@ -3474,20 +3556,27 @@ for(int i=0; i < param->num_src; i++) {
       delete solve;
     }
 
-    if (direct_solve) {
-      DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
+    // CG solves share a single Krylov space across the sources, other
+    // solvers run the sources one after the other
+    auto blocksolve = [&](DiracMatrix &m, DiracMatrix &mSloppy, DiracMatrix &mPre) {
       SolverParam solverParam(*param);
-      Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
-      solve->blocksolve(*out,*in);
+      if (param->inv_type == QUDA_CG_INVERTER) {
+        BlockCG solve(m, mSloppy, solverParam, profileInvert);
+        solve.blocksolve(*out, *in);
+      } else {
+        Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
+        solve->blocksolve(*out, *in);
+        delete solve;
+      }
       solverParam.updateInvertParam(*param);
-      delete solve;
+    };
+
+    if (direct_solve) {
+      DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
+      blocksolve(m, mSloppy, mPre);
     } else if (!norm_error_solve) {
       DiracMdagM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
-      SolverParam solverParam(*param);
-      Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
-      solve->blocksolve(*out,*in);
-      solverParam.updateInvertParam(*param);
-      delete solve;
+      blocksolve(m, mSloppy, mPre);
     } else { // norm_error_solve
       DiracMMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre);
       errorQuda("norm_error_solve not supported in multi source solve");
@@ -3781,6 +3870,72 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
     Dirac &dirac = *d;
     Dirac &diracSloppy = *dRefine;
 
+    /*
+      In the case where the shifted systems have zero tolerance
+      specified, we refine these systems until either the limit of
+      precision is reached (prec_tol) or until the tolerance reaches
+      the iterated residual tolerance of the previous multi-shift
+      solver (iter_res_offset[i]), which ever is greater.
+    */
+    const double prec_tol = std::pow(10.,(-2*(int)param->cuda_prec+4)); // implicit refinment limit of 1e-12
+    auto iterTol = [&](int i) {
+      return param->iter_res_offset[i] < prec_tol ? prec_tol : (param->iter_res_offset[i] * 1.1);
+    };
+    auto refineTol = [&](int i) { return param->tol_offset[i] == 0.0 ? iterTol(i) : param->tol_offset[i]; };
+
+    // Solve every shift short of its L2 tolerance together.  The
+    // heavy-quark residual is not tracked here, so if it is requested
+    // this is left to the sequential refinement below, which also
+    // picks up any shift the batched solve does not converge.
+    if (param->batched_refinement && !(param->residual_type & QUDA_HEAVY_QUARK_RESIDUAL)) {
+      std::vector<ColorSpinorField *> x_refine;
+      std::vector<int> idx;
+      std::vector<double> shift, tol;
+      for (int i = 0; i < param->num_offset; i++) {
+        if (param->true_res_offset[i] > refineTol(i)) {
+          if (getVerbosity() >= QUDA_SUMMARIZE)
+            printfQuda("Refining shift %d: L2 residual %e / %e (actual / requested)\n", i, param->true_res_offset[i],
+                       param->tol_offset[i]);
+          x_refine.push_back(x[i]);
+          idx.push_back(i);
+          // for staggered the shift is a change in the mass term relative to the lowest shift
+          shift.push_back(param->dslash_type == QUDA_ASQTAD_DSLASH || param->dslash_type == QUDA_STAGGERED_DSLASH ?
+                            param->offset[i] - param->offset[0] :
+                            param->offset[i]);
+          tol.push_back(param->tol_offset[i] > 0.0 ? param->tol_offset[i] : iterTol(i));
+        }
+      }
+
+      if (x_refine.size() > 0) {
+        DiracMatrix *m, *mSloppy;
+        if (param->dslash_type == QUDA_ASQTAD_DSLASH || param->dslash_type == QUDA_STAGGERED_DSLASH) {
+          m = new DiracM(dirac);
+          mSloppy = new DiracM(diracSloppy);
+        } else {
+          m = new DiracMdagM(dirac);
+          mSloppy = new DiracMdagM(diracSloppy);
+        }
+
+        SolverParam solverParam(refineparam);
+        solverParam.iter = 0;
+        solverParam.secs = 0;
+        solverParam.gflops = 0;
+        solverParam.delta = param->reliable_delta_refinement;
+        for (int i = 0; i < param->num_offset; i++) {
+          solverParam.true_res_offset[i] = param->true_res_offset[i];
+          solverParam.iter_res_offset[i] = param->iter_res_offset[i];
+          solverParam.true_res_hq_offset[i] = param->true_res_hq_offset[i];
+        }
+
+        MultiShiftRefineCG refine(*m, *mSloppy, solverParam, profileMulti);
+        refine(x_refine, *b, idx, shift, tol);
+        solverParam.updateInvertParam(*param);
+
+        delete m;
+        delete mSloppy;
+      }
+    }
+
 #define REFINE_INCREASING_MASS
 #ifdef REFINE_INCREASING_MASS
     for(int i=0; i < param->num_offset; i++) {
@@ -3792,16 +3947,8 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
       double tol_hq = param->residual_type & QUDA_HEAVY_QUARK_RESIDUAL ?
 	param->tol_hq_offset[i] : 0;
 
-      /*
-	In the case where the shifted systems have zero tolerance
-	specified, we refine these systems until either the limit of
-	precision is reached (prec_tol) or until the tolerance reaches
-	the iterated residual tolerance of the previous multi-shift
-	solver (iter_res_offset[i]), which ever is greater.
-      */
-      const double prec_tol = std::pow(10.,(-2*(int)param->cuda_prec+4)); // implicit refinment limit of 1e-12
-      const double iter_tol = (param->iter_res_offset[i] < prec_tol ? prec_tol : (param->iter_res_offset[i] *1.1));
-      const double refine_tol = (param->tol_offset[i] == 0.0 ? iter_tol : param->tol_offset[i]);
+      const double iter_tol = iterTol(i);
+      const double refine_tol = refineTol(i);
       // refine if either L2 or heavy quark residual tolerances have not been met, only if desired residual is > 0
       if (param->true_res_offset[i] > refine_tol || rsd_hq > tol_hq) {
 	if (getVerbosity() >= QUDA_SUMMARIZE)
@@ -3971,6 +4118,55 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
   profilerStop(__func__);
 }
 
+#ifdef GPU_FATLINK
+/**
+   The host path of computeKSLinkQuda: the links are computed in place
+   in the caller's arrays, in the order and precision of the input
+   links, from a copy of the input extended by the halo.
+*/
+static void computeKSLinkHost(void *fatlink, void *longlink, void *ulink, void *inlink, double *path_coeff,
+                              QudaGaugeParam *param)
+{
+  profileFatLink.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(inlink, *param, QUDA_GENERAL_LINKS);
+  gParam.link_type = param->type;
+  cpuGaugeField cpuInLink(gParam);
+
+  // the fat link is needed for the unitarized link even when not returned
+  gParam.link_type = QUDA_GENERAL_LINKS;
+  gParam.gauge = fatlink;
+  gParam.create = fatlink ? QUDA_REFERENCE_FIELD_CREATE : QUDA_NULL_FIELD_CREATE;
+  cpuGaugeField cpuFatLink(gParam);
+
+  gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+  gParam.gauge = longlink;
+  cpuGaugeField *cpuLongLink = longlink ? new cpuGaugeField(gParam) : nullptr;
+  gParam.gauge = ulink;
+  cpuGaugeField *cpuUnitarizedLink = ulink ? new cpuGaugeField(gParam) : nullptr;
+  profileFatLink.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileFatLink.TPSTART(QUDA_PROFILE_COMMS);
+  GaugeField *inLinkEx = extendGaugeField(cpuInLink, R);
+  profileFatLink.TPSTOP(QUDA_PROFILE_COMMS);
+
+  profileFatLink.TPSTART(QUDA_PROFILE_COMPUTE);
+  fatLongKSLink(&cpuFatLink, cpuLongLink, *inLinkEx, path_coeff);
+
+  if (ulink) {
+    int num_failures = 0;
+    quda::unitarizeLinks(*cpuUnitarizedLink, cpuFatLink, &num_failures);
+    if (num_failures > 0) errorQuda("Error in unitarization component of the hisq fattening: %d failures\n", num_failures);
+  }
+  profileFatLink.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileFatLink.TPSTART(QUDA_PROFILE_FREE);
+  delete inLinkEx;
+  if (cpuUnitarizedLink) delete cpuUnitarizedLink;
+  if (cpuLongLink) delete cpuLongLink;
+  profileFatLink.TPSTOP(QUDA_PROFILE_FREE);
+}
+#endif // GPU_FATLINK
+
 void computeKSLinkQuda(void* fatlink, void* longlink, void* ulink, void* inlink, double *path_coeff, QudaGaugeParam *param) {
 
 #ifdef GPU_FATLINK
@@ -3990,6 +4186,13 @@ void computeKSLinkQuda(void* fatlink, void* longlink, void* ulink, void* inlink,
 				     svd_rel_error, svd_abs_error);
   }
 
+  if (param->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    profileFatLink.TPSTOP(QUDA_PROFILE_INIT);
+    computeKSLinkHost(fatlink, longlink, ulink, inlink, path_coeff, param);
+    profileFatLink.TPSTOP(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   GaugeFieldParam gParam(fatlink, *param, QUDA_GENERAL_LINKS);
   cpuGaugeField cpuFatLink(gParam);   // create the host fatlink
   gParam.gauge = longlink;
@@ -4072,6 +4275,49 @@ int getGaugePadding(GaugeFieldParam& param){
   return pad;
 }
 
+#ifdef GPU_GAUGE_FORCE
+/**
+   Host computation of the gauge force, threaded over the sites, on
+   the user's momentum and gauge fields in place
+*/
+static void computeGaugeForceHost(void *mom, void *siteLink, int ***input_path_buf, int *path_length,
+                                  double *loop_coeff, int num_paths, int max_length, double eb3,
+                                  QudaGaugeParam *qudaGaugeParam)
+{
+  if (qudaGaugeParam->use_resident_gauge || qudaGaugeParam->use_resident_mom || qudaGaugeParam->make_resident_gauge
+      || qudaGaugeParam->make_resident_mom)
+    errorQuda("Resident fields not supported by the host gauge force");
+
+  profileGaugeForce.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(siteLink, *qudaGaugeParam);
+  gParam.site_offset = qudaGaugeParam->gauge_offset;
+  gParam.site_size = qudaGaugeParam->site_size;
+  cpuGaugeField cpuSiteLink(gParam);
+
+  GaugeFieldParam gParamMom(mom, *qudaGaugeParam, QUDA_ASQTAD_MOM_LINKS);
+  if (gParamMom.order == QUDA_QDP_GAUGE_ORDER) gParamMom.order = QUDA_MILC_GAUGE_ORDER;
+  if (gParamMom.order != QUDA_MILC_GAUGE_ORDER) errorQuda("Momentum order %d not supported on the host", gParamMom.order);
+  gParamMom.reconstruct = QUDA_RECONSTRUCT_10;
+  gParamMom.site_offset = qudaGaugeParam->mom_offset;
+  gParamMom.site_size = qudaGaugeParam->site_size;
+  cpuGaugeField cpuMom(gParamMom);
+  if (qudaGaugeParam->overwrite_mom) cpuMom.zero();
+  profileGaugeForce.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileGaugeForce.TPSTART(QUDA_PROFILE_COMMS);
+  GaugeField *siteLinkEx = extendGaugeField(cpuSiteLink, R);
+  profileGaugeForce.TPSTOP(QUDA_PROFILE_COMMS);
+
+  profileGaugeForce.TPSTART(QUDA_PROFILE_COMPUTE);
+  gaugeForce(cpuMom, *siteLinkEx, eb3, input_path_buf, path_length, loop_coeff, num_paths, max_length);
+  profileGaugeForce.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileGaugeForce.TPSTART(QUDA_PROFILE_FREE);
+  delete siteLinkEx;
+  profileGaugeForce.TPSTOP(QUDA_PROFILE_FREE);
+}
+#endif // GPU_GAUGE_FORCE
+
 int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int* path_length,
 			  double* loop_coeff, int num_paths, int max_length, double eb3, QudaGaugeParam* qudaGaugeParam)
 {
@@ -4081,6 +4327,14 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
 
   checkGaugeParam(qudaGaugeParam);
 
+  if (qudaGaugeParam->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_INIT);
+    computeGaugeForceHost(mom, siteLink, input_path_buf, path_length, loop_coeff, num_paths, max_length, eb3,
+                          qudaGaugeParam);
+    profileGaugeForce.TPSTOP(QUDA_PROFILE_TOTAL);
+    return 0;
+  }
+
   GaugeFieldParam gParam(siteLink, *qudaGaugeParam);
   gParam.site_offset = qudaGaugeParam->gauge_offset;
   gParam.site_size = qudaGaugeParam->site_size;
@@ -4883,6 +5137,7 @@ void updateGaugeFieldQuda(void* gauge,
   profileGaugeUpdate.TPSTART(QUDA_PROFILE_TOTAL);
 
   checkGaugeParam(param);
+  operatorGeneration++;
 
   profileGaugeUpdate.TPSTART(QUDA_PROFILE_INIT);
 
@@ -5641,6 +5896,36 @@ void performOvrImpSTOUTnStep(unsigned int nSteps, double rho, double epsilon)
   profileOvrImpSTOUT.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+void performWFlowQuda(QudaWFlowType wflow_type, double t_max, double epsilon, double tolerance, int meas_interval)
+{
+  profileWFlow.TPSTART(QUDA_PROFILE_TOTAL);
+
+  if (gaugePrecise == nullptr) errorQuda("Gauge field must be loaded");
+
+  profileWFlow.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(*gaugePrecise);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  auto *cudaGaugeFlowed = new cudaGaugeField(gParam);
+  profileWFlow.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileWFlow.TPSTART(QUDA_PROFILE_COMPUTE);
+  std::vector<WFlowObservables> obs
+    = WFlow(*cudaGaugeFlowed, *gaugePrecise, wflow_type, t_max, epsilon, tolerance, meas_interval);
+  profileWFlow.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  if (getVerbosity() >= QUDA_SUMMARIZE) {
+    for (auto &o : obs)
+      printfQuda("Flow time %e: plaquette %le E %le t^2 E %le Q %le\n", o.t, o.plaquette, o.E_clover,
+                 o.t * o.t * o.E_clover, o.Q);
+  }
+
+  if (gaugeSmeared != nullptr) delete gaugeSmeared;
+  gaugeSmeared = createExtendedGauge(*cudaGaugeFlowed, R, profileWFlow);
+  delete cudaGaugeFlowed;
+
+  profileWFlow.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
 
 int computeGaugeFixingOVRQuda(void* gauge, const unsigned int gauge_dir,  const unsigned int Nsteps, \
   const unsigned int verbose_interval, const double relax_boost, const double tolerance, const unsigned int reunit_interval, \
@@ -5724,6 +6009,31 @@ int computeGaugeFixingOVRQuda(void* gauge, const unsigned int gauge_dir,  const
   return 0;
 }
 
+static void computeGaugeFixingFFTHost(void *gauge, const unsigned int gauge_dir, const unsigned int Nsteps,
+                                      const unsigned int verbose_interval, const double alpha,
+                                      const unsigned int autotune, const double tolerance,
+                                      const unsigned int stopWtheta, QudaGaugeParam *param, double *timeinfo)
+{
+  if (param->use_resident_gauge || param->make_resident_gauge)
+    errorQuda("Resident fields not supported by host gauge fixing");
+
+  GaugeFixFFTQuda.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(gauge, *param);
+  cpuGaugeField cpuGauge(gParam);
+  GaugeFixFFTQuda.TPSTOP(QUDA_PROFILE_INIT);
+
+  // fix the host field in place
+  GaugeFixFFTQuda.TPSTART(QUDA_PROFILE_COMPUTE);
+  gaugefixingFFT(cpuGauge, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+  GaugeFixFFTQuda.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  if (timeinfo) {
+    timeinfo[0] = 0.0;
+    timeinfo[1] = GaugeFixFFTQuda.Last(QUDA_PROFILE_COMPUTE);
+    timeinfo[2] = 0.0;
+  }
+}
+
 int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const unsigned int Nsteps, \
   const unsigned int verbose_interval, const double alpha, const unsigned int autotune, const double tolerance, \
   const unsigned int  stopWtheta, QudaGaugeParam* param , double* timeinfo)
@@ -5733,6 +6043,13 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
 
   checkGaugeParam(param);
 
+  if (param->compute_location == QUDA_CPU_FIELD_LOCATION) {
+    computeGaugeFixingFFTHost(gauge, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta,
+                              param, timeinfo);
+    GaugeFixFFTQuda.TPSTOP(QUDA_PROFILE_TOTAL);
+    return 0;
+  }
+
   GaugeFixFFTQuda.TPSTART(QUDA_PROFILE_INIT);
 
   GaugeFieldParam gParam(gauge, *param);
@@ -473,7 +473,9 @@ namespace quda {
     int pipeline = param.pipeline;
     
     // Create the worker class for updating non-critical r, u vectors.
-    BiCGstabLUpdate bicgstabl_update(&x_sloppy, r, u, &alpha, &beta, BICGSTABL_UPDATE_U, 0, matSloppy.getStencilSteps() );
+    const bool host = b.Location() == QUDA_CPU_FIELD_LOCATION;
+    BiCGstabLUpdate bicgstabl_update(&x_sloppy, r, u, &alpha, &beta, BICGSTABL_UPDATE_U, 0,
+                                     host ? 1 : matSloppy.getStencilSteps());
 
     
     // done with preamble, begin computing.
@@ -513,9 +515,11 @@ namespace quda {
         blas::caxpby(1.0, *r[j], -beta, *u[j]);
         if (j > 0)
         {
-          dslash::aux_worker = &bicgstabl_update;
           bicgstabl_update.update_j_max(j);
           bicgstabl_update.update_update_type(BICGSTABL_UPDATE_U);
+          // a host operator has no dslash to overlap the update with
+          if (host) bicgstabl_update.apply(0);
+          else dslash::aux_worker = &bicgstabl_update;
         }
         else
         {
@@ -537,9 +541,10 @@ namespace quda {
         }*/
         blas::caxpy(-alpha, *u[j+1], *r[j]);
         // We can always at least update x.
-        dslash::aux_worker = &bicgstabl_update;
         bicgstabl_update.update_j_max(j);
         bicgstabl_update.update_update_type(BICGSTABL_UPDATE_R);
+        if (host) bicgstabl_update.apply(0);
+        else dslash::aux_worker = &bicgstabl_update;
         
         // r[j+1] = A r[j], x = x + alpha*u[0]
         matSloppy(*r[j+1], *r[j], temp);
@@ -0,0 +1,482 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+/*!
+ * Block CG for a set of right-hand sides sharing one Krylov space
+ *
+ * This is the BCGrQ variant of Dubrulle: the block residual is kept
+ * in factored form R = Q C with Q orthonormal, so that the small
+ * matrices inverted each iteration remain well conditioned when the
+ * residuals of the different systems differ by orders of magnitude.
+ * The orthonormalization is rank revealing: directions of the new
+ * block residual that are numerically linearly dependent on the
+ * others are dropped rather than causing a breakdown, e.g., for
+ * linearly dependent sources or once the Krylov space has captured an
+ * invariant subspace.  Systems whose residual has converged are
+ * deflated from the block by rotating Q and P onto the directions
+ * still needed by the remaining systems, so the block size, and with
+ * it the number of matrix-vector products per iteration, shrinks as
+ * the solve proceeds.
+ *
+ * All inner products of an iteration are computed by a single
+ * multi-reduction and all updates by multi-blas.  There is no
+ * multi-RHS operator at present, so the block is applied as
+ * back-to-back single-RHS applications.
+ *
+ * With mixed precision the partial solutions are accumulated in
+ * sloppy precision, and once the largest residual has decreased by a
+ * factor of delta the solutions are folded into the high-precision
+ * ones and the iteration is restarted from the true residuals.  The
+ * same restart is used to verify convergence at the end of the solve.
+ */
+
+namespace quda {
+
+  using Eigen::MatrixXcd;
+  typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorDenseMatrix;
+
+  namespace {
+
+    // the coefficients of a multi-blas caxpy in the row-major order it expects
+    std::vector<Complex> coeff(const MatrixXcd &a)
+    {
+      RowMajorDenseMatrix a_row(a);
+      return std::vector<Complex>(a_row.data(), a_row.data() + a_row.size());
+    }
+
+    // Hermitian matrix of inner products G(i,j) = (u_i, v_j)
+    MatrixXcd gram(std::vector<ColorSpinorField *> &u, std::vector<ColorSpinorField *> &v)
+    {
+      std::vector<Complex> g(u.size() * v.size());
+      blas::cDotProduct(g.data(), u, v);
+      MatrixXcd G(u.size(), v.size());
+      for (unsigned int i = 0; i < u.size(); i++)
+        for (unsigned int j = 0; j < v.size(); j++) G(i, j) = g[i * v.size() + j];
+      return 0.5 * (G + G.adjoint());
+    }
+
+    // y = x a, where y must not alias x
+    void rotate(std::vector<ColorSpinorField *> &y, std::vector<ColorSpinorField *> &x, const MatrixXcd &a)
+    {
+      for (auto v : y) blas::zero(*v);
+      std::vector<Complex> a_ = coeff(a);
+      blas::caxpy(a_.data(), x, y);
+    }
+
+    // machine epsilon of the field storage
+    double epsilon(QudaPrecision precision)
+    {
+      switch (precision) {
+      case QUDA_DOUBLE_PRECISION: return std::numeric_limits<double>::epsilon();
+      case QUDA_SINGLE_PRECISION: return std::numeric_limits<float>::epsilon();
+      case QUDA_HALF_PRECISION: return std::pow(2.0, -15);
+      case QUDA_QUARTER_PRECISION: return std::pow(2.0, -7);
+      default: errorQuda("Invalid precision %d", precision);
+      }
+      return 0.0;
+    }
+
+  } // namespace
+
+  BlockCG::BlockCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile),
+    mat(mat),
+    matSloppy(matSloppy),
+    matvecs(0)
+  {
+  }
+
+  BlockCG::~BlockCG() {}
+
+  void BlockCG::operator()(ColorSpinorField &out, ColorSpinorField &in)
+  {
+    std::vector<ColorSpinorField *> x(1, &out), b(1, &in);
+    solve(x, b);
+    param.true_res = param.true_res_offset[0];
+    param.true_res_hq = param.true_res_hq_offset[0];
+  }
+
+  void BlockCG::blocksolve(ColorSpinorField &out, ColorSpinorField &in)
+  {
+    std::vector<ColorSpinorField *> x, b;
+    for (int i = 0; i < in.CompositeDim(); i++) {
+      x.push_back(&out.Component(i));
+      b.push_back(&in.Component(i));
+    }
+    solve(x, b);
+  }
+
+  /**
+     Rank-revealing orthonormalization V = Q S.  On return the leading
+     k fields of V hold Q and S is k x n, where n = V.size() and k is
+     the numerical rank: directions with a singular value below
+     rank_tol relative to the largest are dropped.  The Gram matrix is
+     orthonormalized twice (CholQR2) so that Q is orthonormal to
+     working precision.  work must hold at least n fields.
+  */
+  static int orthonormalize(std::vector<ColorSpinorField *> &V, MatrixXcd &S, std::vector<ColorSpinorField *> &work,
+                            double rank_tol)
+  {
+    const int n = V.size();
+    Eigen::SelfAdjointEigenSolver<MatrixXcd> eig(gram(V, V));
+    const double lambda_max = eig.eigenvalues()(n - 1);
+
+    // eigenvalues are in ascending order, keep the largest first
+    std::vector<int> keep;
+    for (int i = n - 1; i >= 0; i--)
+      if (lambda_max > 0.0 && eig.eigenvalues()(i) > rank_tol * rank_tol * lambda_max) keep.push_back(i);
+    const int k = keep.size();
+    if (k == 0) {
+      S.resize(0, n);
+      return 0;
+    }
+
+    MatrixXcd T(n, k);
+    S.resize(k, n);
+    for (int i = 0; i < k; i++) {
+      const double sigma = sqrt(eig.eigenvalues()(keep[i]));
+      T.col(i) = eig.eigenvectors().col(keep[i]) / sigma;
+      S.row(i) = sigma * eig.eigenvectors().col(keep[i]).adjoint();
+    }
+    std::vector<ColorSpinorField *> Q(work.begin(), work.begin() + k);
+    rotate(Q, V, T);
+
+    // second pass to restore orthogonality lost by forming the Gram matrix
+    Eigen::LLT<MatrixXcd> llt(gram(Q, Q));
+    std::vector<ColorSpinorField *> Vk(V.begin(), V.begin() + k);
+    if (llt.info() == Eigen::Success) {
+      MatrixXcd U = llt.matrixU();
+      rotate(Vk, Q, U.inverse());
+      S = U * S;
+    } else {
+      for (int i = 0; i < k; i++) blas::copy(*Vk[i], *Q[i]);
+    }
+
+    return k;
+  }
+
+  void BlockCG::solve(std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &b)
+  {
+    const int n = b.size();
+    if (x.size() != b.size()) errorQuda("Number of solutions %lu and sources %lu do not match", x.size(), b.size());
+    if (n == 0) return;
+    if (n > QUDA_MAX_MULTI_SHIFT) errorQuda("Number of sources %d exceeds maximum %d", n, QUDA_MAX_MULTI_SHIFT);
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL)
+      errorQuda("Heavy-quark residual not supported by the block CG solver");
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    ColorSpinorParam csParam(*x[0]);
+    csParam.is_composite = false;
+    csParam.composite_dim = 0;
+    csParam.is_component = false;
+    csParam.component_id = 0;
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *r = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmp2 = ColorSpinorField::Create(csParam);
+
+    csParam.setPrecision(param.precision_sloppy);
+    ColorSpinorField *tmpSloppy = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmp2Sloppy = ColorSpinorField::Create(csParam);
+
+    // orthonormal block residual, search directions, their image and
+    // a workspace, of which only the leading s fields are in use
+    std::vector<ColorSpinorField *> Q(n), P(n), AP(n), W(n);
+    for (int i = 0; i < n; i++) {
+      Q[i] = ColorSpinorField::Create(csParam);
+      P[i] = ColorSpinorField::Create(csParam);
+      AP[i] = ColorSpinorField::Create(csParam);
+      W[i] = ColorSpinorField::Create(csParam);
+    }
+
+    // with mixed precision the partial solutions since the last restart
+    const bool mixed = param.precision_sloppy != x[0]->Precision();
+    std::vector<ColorSpinorField *> xSloppy(x);
+    if (mixed) {
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      for (int j = 0; j < n; j++) xSloppy[j] = ColorSpinorField::Create(csParam);
+    }
+
+    // directions with a singular value below this (relative) are
+    // numerically dependent: Gram matrices are computed from fields
+    // stored to within epsilon, so singular values are resolved only
+    // to within about sqrt(epsilon)
+    const double rank_tol = 10.0 * sqrt(epsilon(param.precision_sloppy));
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    std::vector<double> b2(n), stop(n), r2(n), r2_true(n);
+    std::vector<int> resIncrease(n, 0);
+    std::vector<int> active; // systems still being iterated
+    for (int j = 0; j < n; j++) {
+      b2[j] = blas::norm2(*b[j]);
+      stop[j] = stopping(param.tol, b2[j], param.residual_type);
+      r2_true[j] = std::numeric_limits<double>::max();
+      if (b2[j] == 0.0) {
+        warningQuda("Inverting on zero-field source %d", j);
+        blas::zero(*x[j]);
+        r2[j] = r2_true[j] = 0.0;
+      } else {
+        active.push_back(j);
+      }
+    }
+    std::vector<double> b2_safe(b2);
+    for (auto &b2_j : b2_safe)
+      if (b2_j == 0.0) b2_j = 1.0;
+
+    // true residual r = b - A x, returning |r|^2
+    auto trueResidual = [&](int j) {
+      mat(*r, *x[j], *tmp, *tmp2);
+      matvecs++;
+      return blas::xmyNorm(*b[j], *r);
+    };
+
+    MatrixXcd C; // block residual coefficients R = Q C, s x active.size()
+    int s = 0;   // current block size
+    double max_r2_restart = 0.0;
+    int rUpdate = 0;
+    matvecs = 0;
+
+    // Fold in the partial solutions, recompute the true residuals,
+    // retire the systems that have converged (or stagnated) and restart
+    // the iteration from the orthonormalized residuals of the rest
+    auto restart = [&]() {
+      std::vector<int> still_active;
+      for (auto j : active) {
+        if (mixed) blas::xpy(*xSloppy[j], *x[j]);
+        r2[j] = trueResidual(j);
+        if (r2[j] < stop[j]) {
+          r2_true[j] = r2[j];
+          continue;
+        }
+        if (r2[j] > r2_true[j]) {
+          if (++resIncrease[j] > param.max_res_increase) {
+            warningQuda("BlockCG: system %d residual stagnated at %e", j, sqrt(r2[j] / b2[j]));
+            r2_true[j] = r2[j];
+            continue;
+          }
+        } else {
+          resIncrease[j] = 0;
+        }
+        r2_true[j] = r2[j];
+        blas::copy(*W[still_active.size()], *r);
+        still_active.push_back(j);
+      }
+      active = still_active;
+      const int m = active.size();
+      rUpdate++;
+      if (m == 0) return 0;
+
+      if (mixed)
+        for (auto j : active) blas::zero(*xSloppy[j]);
+
+      std::vector<ColorSpinorField *> R(W.begin(), W.begin() + m);
+      int k = orthonormalize(R, C, AP, rank_tol);
+      std::swap(Q, W);
+      for (int i = 0; i < k; i++) blas::copy(*P[i], *Q[i]);
+
+      max_r2_restart = 0.0;
+      for (auto j : active) max_r2_restart = std::max(max_r2_restart, r2[j]);
+      return k;
+    };
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    int k = 0;
+    s = restart();
+    rUpdate = 0;
+    bool restarted = true;
+
+    while (s > 0 && k < param.maxiter) {
+      const int m = active.size();
+      std::vector<ColorSpinorField *> Ps(P.begin(), P.begin() + s), APs(AP.begin(), AP.begin() + s),
+        Qs(Q.begin(), Q.begin() + s), X(m);
+      for (int a = 0; a < m; a++) X[a] = xSloppy[active[a]];
+
+      for (int i = 0; i < s; i++) matSloppy(*AP[i], *P[i], *tmpSloppy, *tmp2Sloppy);
+      matvecs += s;
+
+      Eigen::LLT<MatrixXcd> pAp(gram(Ps, APs));
+      if (pAp.info() != Eigen::Success) {
+        // conjugacy lost to rounding: restart from the true residuals
+        if (restarted) errorQuda("BlockCG: (P, AP) is not positive definite, is the operator HPD?");
+        s = restart();
+        restarted = true;
+        continue;
+      }
+      MatrixXcd alpha = pAp.solve(MatrixXcd::Identity(s, s));
+
+      // X += P alpha C and Q <- Q - AP alpha
+      std::vector<Complex> coeffs = coeff(alpha * C);
+      blas::caxpy(coeffs.data(), Ps, X);
+      coeffs = coeff(-alpha);
+      blas::caxpy(coeffs.data(), APs, Qs);
+
+      // Q S = Q - AP alpha, dropping dependent directions
+      MatrixXcd S;
+      const int s_new = orthonormalize(Qs, S, W, rank_tol);
+
+      // P <- Q + P S^dagger
+      std::vector<ColorSpinorField *> Pnew(W.begin(), W.begin() + s_new);
+      for (int i = 0; i < s_new; i++) blas::copy(*Pnew[i], *Q[i]);
+      coeffs = coeff(S.adjoint());
+      blas::caxpy(coeffs.data(), Ps, Pnew);
+      std::swap(P, W);
+
+      C = S * C;
+      s = s_new;
+      k++;
+      restarted = false;
+
+      // |r_j|^2 = |C e_j|^2 since Q is orthonormal
+      double r2_sum = 0.0, b2_sum = 0.0, max_r2 = 0.0;
+      std::vector<int> keep;
+      for (int a = 0; a < m; a++) {
+        const int j = active[a];
+        r2[j] = C.col(a).squaredNorm();
+        r2_sum += r2[j];
+        b2_sum += b2[j];
+        max_r2 = std::max(max_r2, r2[j]);
+        if (r2[j] >= stop[j]) keep.push_back(a);
+      }
+      PrintStats("BlockCG", k, r2_sum, b2_sum, 0.0);
+      if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printfQuda("BlockCG: block size %d, %d systems\n", s, m);
+
+      if (keep.size() == 0 || s == 0 || (mixed && max_r2 < param.delta * param.delta * max_r2_restart)) {
+        // all converged, nothing left to search or reliable update
+        s = restart();
+        restarted = true;
+      } else if ((int)keep.size() < m) {
+        // deflate the converged systems, checking their true residuals
+        bool verified = true;
+        for (int a = 0; a < m; a++) {
+          const int j = active[a];
+          if (r2[j] >= stop[j]) continue;
+          if (mixed) {
+            blas::xpy(*xSloppy[j], *x[j]);
+            blas::zero(*xSloppy[j]);
+          }
+          r2_true[j] = trueResidual(j);
+          if (r2_true[j] >= stop[j]) verified = false;
+        }
+
+        MatrixXcd Ck(s, keep.size());
+        std::vector<int> still_active;
+        for (unsigned int a = 0; a < keep.size(); a++) {
+          Ck.col(a) = C.col(keep[a]);
+          still_active.push_back(active[keep[a]]);
+        }
+
+        if (!verified) {
+          // the iterated residual has drifted, so let the restart
+          // reintroduce the systems that are not truly converged
+          for (int a = 0; a < m; a++)
+            if (r2[active[a]] < stop[active[a]] && r2_true[active[a]] >= stop[active[a]])
+              still_active.push_back(active[a]);
+          active = still_active;
+          s = restart();
+          restarted = true;
+          continue;
+        }
+        active = still_active;
+
+        // rotate Q and P onto the directions still needed: Ck = U Sigma V^dagger
+        Eigen::SelfAdjointEigenSolver<MatrixXcd> eig(Ck * Ck.adjoint());
+        const double sigma2_max = eig.eigenvalues()(s - 1);
+        std::vector<int> dirs;
+        for (int i = s - 1; i >= 0 && (int)dirs.size() < (int)keep.size(); i--)
+          if (eig.eigenvalues()(i) > rank_tol * rank_tol * sigma2_max) dirs.push_back(i);
+
+        MatrixXcd U(s, dirs.size());
+        for (unsigned int i = 0; i < dirs.size(); i++) U.col(i) = eig.eigenvectors().col(dirs[i]);
+
+        std::vector<ColorSpinorField *> Qk(Q.begin(), Q.begin() + s), Pk(P.begin(), P.begin() + s),
+          Wk(W.begin(), W.begin() + dirs.size());
+        rotate(Wk, Qk, U);
+        std::swap(Q, W);
+        Wk.assign(W.begin(), W.begin() + dirs.size());
+        rotate(Wk, Pk, U);
+        std::swap(P, W);
+
+        C = U.adjoint() * Ck;
+        s = dirs.size();
+        if (getVerbosity() >= QUDA_VERBOSE)
+          printfQuda("BlockCG: deflated to block size %d with %lu systems after %d iterations\n", s, active.size(), k);
+      }
+    }
+
+    // fold in the partial solutions of any system that ran out of iterations
+    for (auto j : active) {
+      if (mixed) blas::xpy(*xSloppy[j], *x[j]);
+      r2_true[j] = trueResidual(j);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    if (k == param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    param.gflops = (blas::flops + mat.flops() + matSloppy.flops()) * 1e-9;
+    param.iter += k;
+
+    param.true_res = 0.0;
+    for (int j = 0; j < n; j++) {
+      param.true_res_offset[j] = sqrt(r2_true[j] / b2_safe[j]);
+      param.iter_res_offset[j] = sqrt(r2[j] / b2_safe[j]);
+      param.true_res_hq_offset[j] = 0.0;
+      param.true_res = std::max(param.true_res, param.true_res_offset[j]);
+    }
+    param.true_res_hq = 0.0;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("BlockCG: %d sources converged in %d iterations (%lld matrix-vector products, %d restarts)\n", n, k,
+                 matvecs, rUpdate);
+      for (int j = 0; j < n; j++)
+        printfQuda(" source=%d, relative residual: iterated = %e, true = %e\n", j, param.iter_res_offset[j],
+                   param.true_res_offset[j]);
+    }
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (mixed)
+      for (auto v : xSloppy) delete v;
+    for (int i = 0; i < n; i++) {
+      delete W[i];
+      delete AP[i];
+      delete P[i];
+      delete Q[i];
+    }
+    delete tmp2Sloppy;
+    delete tmpSloppy;
+    delete tmp2;
+    delete tmp;
+    delete r;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+} // namespace quda
@@ -61,6 +61,7 @@ namespace quda {
   CACGNE::CACGNE(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
     CACG(mmdag, mmdagSloppy, param, profile), mmdag(mat.Expose()), mmdagSloppy(matSloppy.Expose()),
     xp(nullptr), yp(nullptr), init(false) {
+    if (!mat.Expose()) errorQuda("CA-CGNE requires an operator backed by a Dirac object");
   }
 
   CACGNE::~CACGNE() {
@@ -143,6 +144,7 @@ namespace quda {
   CACGNR::CACGNR(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
     CACG(mdagm, mdagmSloppy, param, profile), mdagm(mat.Expose()), mdagmSloppy(matSloppy.Expose()),
     bp(nullptr), init(false) {
+    if (!mat.Expose()) errorQuda("CA-CGNR requires an operator backed by a Dirac object");
   }
 
   CACGNR::~CACGNR() {
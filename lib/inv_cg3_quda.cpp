@@ -39,8 +39,7 @@ namespace quda {
 
   void CG3::operator()(ColorSpinorField &x, ColorSpinorField &b)
   {
-    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
-      errorQuda("Not supported");
+    checkLocation(x, b);
     if (x.Precision() != param.precision || b.Precision() != param.precision)
       errorQuda("Precision mismatch");
 
@@ -60,6 +60,7 @@ namespace quda {
   CGNE::CGNE(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
     CG(mmdag, mmdagSloppy, param, profile), mmdag(mat.Expose()), mmdagSloppy(matSloppy.Expose()),
     xp(nullptr), yp(nullptr), init(false) {
+    if (!mat.Expose()) errorQuda("CGNE requires an operator backed by a Dirac object");
   }
 
   CGNE::~CGNE() {
@@ -142,6 +143,7 @@ namespace quda {
   CGNR::CGNR(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
     CG(mdagm, mdagmSloppy, param, profile), mdagm(mat.Expose()), mdagmSloppy(matSloppy.Expose()),
     bp(nullptr), init(false) {
+    if (!mat.Expose()) errorQuda("CGNR requires an operator backed by a Dirac object");
   }
 
   CGNR::~CGNR() {
@@ -205,8 +207,7 @@ namespace quda {
 
   void CG::operator()(ColorSpinorField &x, ColorSpinorField &b, ColorSpinorField *p_init, double r2_old_init)
   {
-    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
-      errorQuda("Not supported");
+    checkLocation(x, b);
     if (checkPrecision(x, b) != param.precision)
       errorQuda("Precision mismatch: expected=%d, received=%d", param.precision, x.Precision());
 
@@ -756,8 +757,7 @@ void CG::blocksolve(ColorSpinorField& x, ColorSpinorField& b) {
   errorQuda("QUDA_BLOCKSOLVER not built.");
   #else
 
-  if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
-  errorQuda("Not supported");
+  checkLocation(x, b);
 
   profile.TPSTART(QUDA_PROFILE_INIT);
 
@@ -1136,8 +1136,7 @@ void CG::solve(ColorSpinorField& x, ColorSpinorField& b) {
   printfQuda("BCQ Solver\n");
   #endif
   const bool use_block = true;
-  if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
-  errorQuda("Not supported");
+  checkLocation(x, b);
 
   profile.TPSTART(QUDA_PROFILE_INIT);
 
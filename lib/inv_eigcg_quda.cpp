@@ -382,7 +382,7 @@ namespace quda {
 
     int k=0;
 
-    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)  errorQuda("Not supported");
+    checkLocation(x, b);
 
     profile.TPSTART(QUDA_PROFILE_INIT);
 
@@ -179,6 +179,8 @@ namespace quda {
       K = new SD(matSloppy, Kparam, profile);
     else if (param.inv_type_precondition == QUDA_CA_GCR_INVERTER) // inner CA-GCR solver
       K = new CAGCR(matSloppy, matPrecon, Kparam, profile);
+    else if (param.inv_type_precondition == QUDA_POLYNOMIAL_INVERTER) // GMRES polynomial
+      K = new PolynomialPreconditioner(matSloppy, matPrecon, Kparam, profile);
     else if (param.inv_type_precondition == QUDA_INVALID_INVERTER) // unsupported
       K = NULL;
     else 
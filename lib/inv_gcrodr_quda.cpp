@@ -0,0 +1,459 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+
+/*
+GCRO-DR algorithm:
+M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and S. Maiti, "Recycling Krylov subspaces for sequences of
+linear systems", SIAM J. Sci. Comput. 28 (2006) p. 1651-1674
+
+Each cycle minimizes the residual over [U, V_{m-k}] where U is the recycled subspace and V_{m-k} an Arnoldi basis
+built orthogonal to C = A U, and then replaces U with the k harmonic Ritz vectors of smallest magnitude from that
+space.  The first cycle of a solve without a recycled subspace is a plain GMRES(m) cycle.
+*/
+
+namespace quda {
+
+  using namespace Eigen;
+
+  using DenseMatrix = MatrixXcd;
+  using Vector = VectorXcd;
+
+  // special types needed for compatibility with QUDA blas:
+  using RowMajorDenseMatrix = Matrix<Complex, Dynamic, Dynamic, RowMajor>;
+
+  /**
+     @brief Compute M(i,j) = <a_i, b_j>
+   */
+  static DenseMatrix innerProducts(std::vector<ColorSpinorField *> &a, std::vector<ColorSpinorField *> &b)
+  {
+    RowMajorDenseMatrix M(a.size(), b.size());
+    blas::cDotProduct(M.data(), a, b);
+    return M;
+  }
+
+  /**
+     @brief Compute y_j = sum_i M(i,j) x_i
+   */
+  static void combine(const DenseMatrix &M, std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &y)
+  {
+    RowMajorDenseMatrix M_(M);
+    for (auto v : y) blas::zero(*v);
+    blas::caxpy(M_.data(), x, y);
+  }
+
+  /**
+     @brief Return the indices of the k eigenvalues of smallest (or
+     largest) magnitude
+   */
+  static std::vector<int> selectEigenvalues(const Vector &evals, int k, bool smallest)
+  {
+    std::vector<int> idx(evals.size());
+    for (unsigned int i = 0; i < idx.size(); i++) idx[i] = i;
+    std::stable_sort(idx.begin(), idx.end(), [&](int a, int b) {
+      return smallest ? std::abs(evals(a)) < std::abs(evals(b)) : std::abs(evals(a)) > std::abs(evals(b));
+    });
+    idx.resize(k);
+    return idx;
+  }
+
+  GCRODR::GCRODR(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile),
+    mat(mat),
+    matSloppy(matSloppy),
+    recycle(static_cast<RecycleSpace *>(param.deflation_op)),
+    init(false)
+  {
+    if (param.nev <= 0) errorQuda("Invalid recycled subspace dimension %d", param.nev);
+    if (param.m <= param.nev) errorQuda("Krylov subspace dimension %d must exceed the recycled dimension %d", param.m, param.nev);
+  }
+
+  GCRODR::~GCRODR()
+  {
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (init) {
+      for (auto v : V) delete v;
+      for (auto v : U) delete v;
+      for (auto v : C) delete v;
+      for (auto v : Unew) delete v;
+      for (auto v : Cnew) delete v;
+
+      delete tmp_sloppy;
+      delete e_sloppy;
+      delete r_sloppy;
+      delete tmpp;
+      delete rp;
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+  int GCRODR::arnoldi(Complex *H_, Complex *B_, int n, int k)
+  {
+    Map<DenseMatrix> H(H_, n + 1, n);
+    Map<DenseMatrix> B(B_, k, n);
+    ColorSpinorField &tmp = *tmp_sloppy;
+
+    for (int j = 0; j < n; j++) {
+      matSloppy(*V[j + 1], *V[j], tmp);
+
+      // classical Gram-Schmidt against [C_k, V_0..j], applied twice
+      std::vector<ColorSpinorField *> W(C.begin(), C.begin() + k);
+      W.insert(W.end(), V.begin(), V.begin() + j + 1);
+      std::vector<ColorSpinorField *> w {V[j + 1]};
+
+      Vector h = Vector::Zero(k + j + 1);
+      for (int pass = 0; pass < 2; pass++) {
+        Vector dh(k + j + 1);
+        blas::cDotProduct(dh.data(), W, w);
+        Vector minus_dh = -dh;
+        blas::caxpy(minus_dh.data(), W, w);
+        h += dh;
+      }
+
+      B.col(j) = h.head(k);
+      H.col(j).head(j + 1) = h.tail(j + 1);
+      const double h_next = sqrt(blas::norm2(*V[j + 1]));
+      H(j + 1, j) = h_next;
+
+      // breakdown: A V_j lies in the space already built, so it is invariant
+      if (h_next <= std::numeric_limits<double>::epsilon() * sqrt(h.squaredNorm() + h_next * h_next)) {
+        H(j + 1, j) = 0.0;
+        return j + 1;
+      }
+      blas::ax(1.0 / h_next, *V[j + 1]);
+    }
+
+    return n;
+  }
+
+  void GCRODR::orthonormalizeC(int k)
+  {
+    // modified Gram-Schmidt on C, keeping C = A U
+    for (int i = 0; i < k; i++) {
+      for (int j = 0; j < i; j++) {
+        Complex a = blas::cDotProduct(*C[j], *C[i]);
+        blas::caxpy(-a, *C[j], *C[i]);
+        blas::caxpy(-a, *U[j], *U[i]);
+      }
+      double nrm = sqrt(blas::norm2(*C[i]));
+      blas::ax(1.0 / nrm, *C[i]);
+      blas::ax(1.0 / nrm, *U[i]);
+    }
+  }
+
+  int GCRODR::load()
+  {
+    if (!recycle || recycle->Dim() == 0) return 0;
+
+    const int k = recycle->Dim();
+    for (int i = 0; i < k; i++) {
+      blas::copy(*U[i], *recycle->U[i]);
+      blas::copy(*C[i], *recycle->C[i]);
+    }
+
+    int matvecs = 0;
+    if (recycle->stale) {
+      // the operator has changed, so recompute its image of U
+      for (int i = 0; i < k; i++) matSloppy(*C[i], *U[i], *tmp_sloppy);
+      orthonormalizeC(k);
+      matvecs = k;
+      recycle->stale = false;
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("GCRO-DR: recomputed the recycled subspace image\n");
+    }
+    return matvecs;
+  }
+
+  void GCRODR::store()
+  {
+    if (!recycle) return;
+
+    const int k = U.size();
+    if (recycle->Dim() != k) {
+      recycle->clear();
+      ColorSpinorParam csParam(*U[0]);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      csParam.setPrecision(recycle->precision);
+      for (int i = 0; i < k; i++) {
+        recycle->U.push_back(ColorSpinorField::Create(csParam));
+        recycle->C.push_back(ColorSpinorField::Create(csParam));
+      }
+    }
+
+    for (int i = 0; i < k; i++) {
+      blas::copy(*recycle->U[i], *U[i]);
+      blas::copy(*recycle->C[i], *C[i]);
+    }
+  }
+
+  void GCRODR::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    const int m = param.m;
+    const int k_max = param.nev;
+
+    if (!init) {
+      ColorSpinorParam csParam(b);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      rp = ColorSpinorField::Create(csParam);
+      tmpp = ColorSpinorField::Create(csParam);
+
+      csParam.setPrecision(param.precision_sloppy);
+      r_sloppy = ColorSpinorField::Create(csParam);
+      tmp_sloppy = ColorSpinorField::Create(csParam);
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      e_sloppy = ColorSpinorField::Create(csParam);
+
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      for (int i = 0; i < m + 1; i++) V.push_back(ColorSpinorField::Create(csParam));
+      for (int i = 0; i < k_max; i++) {
+        U.push_back(ColorSpinorField::Create(csParam));
+        C.push_back(ColorSpinorField::Create(csParam));
+        Unew.push_back(ColorSpinorField::Create(csParam));
+        Cnew.push_back(ColorSpinorField::Create(csParam));
+      }
+
+      init = true;
+    }
+
+    ColorSpinorField &r = *rp;
+    ColorSpinorField &rSloppy = *r_sloppy;
+    ColorSpinorField &e = *e_sloppy;
+
+    if (recycle && recycle->Dim() > 0 && recycle->Dim() != k_max) {
+      warningQuda("Discarding recycled subspace of dimension %d (requested %d)", recycle->Dim(), k_max);
+      recycle->clear();
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    const double b2 = blas::norm2(b);
+    if (b2 == 0.0) {
+      profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    const double stop = stopping(param.tol, b2, param.residual_type);
+
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      mat(r, x, *tmpp);
+      blas::xpay(b, -1.0, r);
+    } else {
+      blas::zero(x);
+      blas::copy(r, b);
+    }
+    double r2 = blas::norm2(r);
+    blas::copy(rSloppy, r);
+    blas::zero(e);
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    int total_iter = load();
+    int k = recycle && recycle->Dim() > 0 ? k_max : 0;
+    int cycle = 0;
+
+    PrintStats("GCRO-DR", total_iter, r2, b2, 0.0);
+
+    while (r2 > stop && total_iter < param.maxiter) {
+
+      if (k > 0) {
+        // project the residual onto the complement of C
+        std::vector<ColorSpinorField *> C_(C.begin(), C.begin() + k), U_(U.begin(), U.begin() + k);
+        std::vector<ColorSpinorField *> r_ {&rSloppy}, e_ {&e};
+        Vector c(k);
+        blas::cDotProduct(c.data(), C_, r_);
+        blas::caxpy(c.data(), U_, e_);
+        Vector minus_c = -c;
+        blas::caxpy(minus_c.data(), C_, r_);
+      }
+
+      bool breakdown = false;
+      const double beta = sqrt(blas::norm2(rSloppy));
+      blas::copy(*V[0], rSloppy);
+      blas::ax(1.0 / beta, *V[0]);
+
+      if (k == 0) {
+        // GMRES(m) cycle to build the first recycled subspace
+        DenseMatrix H = DenseMatrix::Zero(m + 1, m);
+        DenseMatrix B(0, m);
+        const int n = arnoldi(H.data(), B.data(), m, 0);
+        total_iter += n;
+
+        // on breakdown only the leading n columns span the Krylov space
+        DenseMatrix Hn = H.topLeftCorner(n + 1, n);
+        Vector g = Vector::Zero(n + 1);
+        g(0) = beta;
+        Vector y = Hn.jacobiSvd(ComputeThinU | ComputeThinV).solve(g);
+
+        std::vector<ColorSpinorField *> Vm(V.begin(), V.begin() + n), Vm1(V.begin(), V.begin() + n + 1);
+        std::vector<ColorSpinorField *> e_ {&e}, r_ {&rSloppy};
+        blas::caxpy(y.data(), Vm, e_);
+        Vector minus_Hy = -(Hn * y);
+        blas::caxpy(minus_Hy.data(), Vm1, r_);
+
+        // the space is invariant so the cycle has converged: there is no
+        // harmonic Ritz problem to build the recycled subspace from
+        breakdown = n < m;
+        if (!breakdown) {
+          // harmonic Ritz vectors: eigenvectors of H_m + |h_{m+1,m}|^2 H_m^{-dagger} e_m e_m^dagger
+          DenseMatrix Hm = H.topRows(m);
+          Vector em = Vector::Zero(m);
+          em(m - 1) = std::norm(H(m, m - 1));
+          DenseMatrix G = Hm;
+          G.col(m - 1) += Hm.adjoint().colPivHouseholderQr().solve(em);
+
+          ComplexEigenSolver<DenseMatrix> es(G);
+          std::vector<int> sel = selectEigenvalues(es.eigenvalues(), k_max, true);
+          DenseMatrix P(m, k_max);
+          for (int i = 0; i < k_max; i++) P.col(i) = es.eigenvectors().col(sel[i]);
+
+          // C = V_{m+1} Q and U = V_m P R^{-1} with H P = Q R
+          HouseholderQR<DenseMatrix> qr(H * P);
+          DenseMatrix Q = qr.householderQ() * DenseMatrix::Identity(m + 1, k_max);
+          DenseMatrix R = qr.matrixQR().topLeftCorner(k_max, k_max).triangularView<Upper>();
+          DenseMatrix PRinv = R.triangularView<Upper>().solve<OnTheRight>(P);
+
+          combine(Q, Vm1, Cnew);
+          combine(PRinv, Vm, Unew);
+          k = k_max;
+        }
+      } else {
+        const int s = m - k;
+
+        DenseMatrix H = DenseMatrix::Zero(s + 1, s);
+        DenseMatrix B = DenseMatrix::Zero(k, s);
+        const int n = arnoldi(H.data(), B.data(), s, k);
+        total_iter += n;
+
+        // column scaling of U to unit norm
+        Vector d(k);
+        for (int i = 0; i < k; i++) d(i) = 1.0 / sqrt(blas::norm2(*U[i]));
+
+        // G = [[D_k, B], [0, H]] such that A [U D_k, V_s] = [C, V_{s+1}] G
+        DenseMatrix G = DenseMatrix::Zero(m + 1, m);
+        G.topLeftCorner(k, k) = d.asDiagonal();
+        G.topRightCorner(k, s) = B;
+        G.bottomRightCorner(s + 1, s) = H;
+
+        // the residual is orthogonal to C; on breakdown only the leading
+        // n columns of V span the Krylov space
+        DenseMatrix Gn = G.topLeftCorner(k + n + 1, k + n);
+        Vector g = Vector::Zero(k + n + 1);
+        g(k) = beta;
+        Vector y = Gn.jacobiSvd(ComputeThinU | ComputeThinV).solve(g);
+
+        std::vector<ColorSpinorField *> Vhat(U.begin(), U.begin() + k), What(C.begin(), C.begin() + k);
+        Vhat.insert(Vhat.end(), V.begin(), V.begin() + n);
+        What.insert(What.end(), V.begin(), V.begin() + n + 1);
+
+        // fold the column scaling of U into the coefficients
+        Vector y_ = y;
+        y_.head(k) = d.asDiagonal() * y.head(k);
+        std::vector<ColorSpinorField *> e_ {&e}, r_ {&rSloppy};
+        blas::caxpy(y_.data(), Vhat, e_);
+        Vector minus_Gy = -(Gn * y);
+        blas::caxpy(minus_Gy.data(), What, r_);
+
+        // keep the current recycled subspace if the cycle broke down
+        breakdown = n < s;
+        if (!breakdown) {
+          // harmonic Ritz vectors: G^dagger G z = theta G^dagger What^dagger Vhat z
+          std::vector<ColorSpinorField *> U_(U.begin(), U.begin() + k);
+          DenseMatrix WV = DenseMatrix::Zero(m + 1, m);
+          WV.leftCols(k) = innerProducts(What, U_) * d.asDiagonal();
+          WV.block(k, k, s, s) = DenseMatrix::Identity(s, s);
+
+          DenseMatrix GG = G.adjoint() * G;
+          DenseMatrix GWV = G.adjoint() * WV;
+          // the generalized eigenvalues theta are the inverse eigenvalues of GG^{-1} GWV
+          ComplexEigenSolver<DenseMatrix> es(GG.ldlt().solve(GWV));
+          std::vector<int> sel = selectEigenvalues(es.eigenvalues(), k, false);
+          DenseMatrix P(m, k);
+          for (int i = 0; i < k; i++) P.col(i) = es.eigenvectors().col(sel[i]);
+
+          // C = What Q and U = Vhat P R^{-1} with G P = Q R
+          HouseholderQR<DenseMatrix> qr(G * P);
+          DenseMatrix Q = qr.householderQ() * DenseMatrix::Identity(m + 1, k);
+          DenseMatrix R = qr.matrixQR().topLeftCorner(k, k).triangularView<Upper>();
+          DenseMatrix PRinv = R.triangularView<Upper>().solve<OnTheRight>(P);
+          PRinv.topRows(k) = d.asDiagonal() * PRinv.topRows(k);
+
+          combine(Q, What, Cnew);
+          combine(PRinv, Vhat, Unew);
+        }
+      }
+
+      if (!breakdown) {
+        std::swap(U, Unew);
+        std::swap(C, Cnew);
+      }
+
+      // accumulate the correction and compute the true residual
+      blas::xpy(e, x);
+      blas::zero(e);
+      mat(r, x, *tmpp);
+      r2 = blas::xmyNorm(b, r);
+      blas::copy(rSloppy, r);
+
+      cycle++;
+      if (getVerbosity() >= QUDA_VERBOSE)
+        printfQuda("GCRO-DR: cycle %d, %d iterations, true residual squared %e\n", cycle, total_iter, r2);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    if (total_iter >= param.maxiter && r2 > stop) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops()) * 1e-9;
+    param.gflops = gflops;
+    param.iter += total_iter;
+    param.true_res = sqrt(r2 / b2);
+    param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x, r).z);
+
+    PrintSummary("GCRO-DR", total_iter, r2, b2, stop, param.tol_hq);
+
+    if (k > 0) store();
+    if (recycle && k > 0) {
+      if (recycle->solves == 0) recycle->first_iter = total_iter;
+      recycle->solves++;
+      if (getVerbosity() >= QUDA_SUMMARIZE && recycle->solves > 1)
+        printfQuda("GCRO-DR: solve %d with a recycled subspace of dimension %d took %d iterations (%d for the first "
+                   "solve, reduction %.1f%%)\n",
+                   recycle->solves, k, total_iter, recycle->first_iter,
+                   100.0 * (1.0 - (double)total_iter / recycle->first_iter));
+    }
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+  }
+
+} // namespace quda
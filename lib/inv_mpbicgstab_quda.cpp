@@ -21,18 +21,21 @@ namespace quda {
   }
 
 
-  void MPBiCGstab::computeMatrixPowers(std::vector<cudaColorSpinorField>& pr, cudaColorSpinorField& p, cudaColorSpinorField& r, int nsteps){
-    cudaColorSpinorField temp(p);
-    pr[0] = p;
+  void MPBiCGstab::computeMatrixPowers(std::vector<ColorSpinorField*>& pr, ColorSpinorField& p, ColorSpinorField& r, int nsteps){
+    ColorSpinorParam csParam(p);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *temp = ColorSpinorField::Create(csParam);
+    blas::copy(*pr[0], p);
     for(int i=1; i<=(2*nsteps); ++i){
-      mat(pr[i], pr[i-1], temp);
+      mat(*pr[i], *pr[i-1], *temp);
     }
 
-    pr[(2*nsteps)+1] = r;
+    blas::copy(*pr[(2*nsteps)+1], r);
   //  for(int i=(2*nsteps+2); i<(4*nsteps+2); ++i){
     for(int i=(2*nsteps+2); i<(4*nsteps+1); ++i){
-      mat(pr[i], pr[i-1], temp);
+      mat(*pr[i], *pr[i-1], *temp);
     }
+    delete temp;
   }
 
 #ifdef SSTEP
@@ -57,24 +60,24 @@ namespace quda {
     }
 
 
-  static void computeGramMatrix(Complex** G, std::vector<cudaColorSpinorField>& v){
+  static void computeGramMatrix(Complex** G, std::vector<ColorSpinorField*>& v){
 
     const int dim = v.size();
 
     for(int i=0; i<dim; ++i){
       for(int j=0; j<dim; ++j){
-        G[i][j] = blas::cDotProduct(v[i],v[j]);
+        G[i][j] = blas::cDotProduct(*v[i],*v[j]);
       }
     }
     return;
   }
 
-  static void computeGramVector(Complex* g, cudaColorSpinorField& r0, std::vector<cudaColorSpinorField>& pr){
+  static void computeGramVector(Complex* g, ColorSpinorField& r0, std::vector<ColorSpinorField*>& pr){
 
     const int dim = pr.size();
 
     for(int i=0; i<dim; ++i){
-      g[i] = blas::cDotProduct(r0,pr[i]);
+      g[i] = blas::cDotProduct(r0,*pr[i]);
     }
   }
 
@@ -146,9 +149,10 @@ namespace quda {
     ColorSpinorParam csParam(x);
     csParam.create = QUDA_ZERO_FIELD_CREATE;
 
-    cudaColorSpinorField temp(b, csParam);
-
-    cudaColorSpinorField r(b);
+    ColorSpinorField *tempp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *rp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &temp = *tempp;
+    ColorSpinorField &r = *rp;
 
 
 
@@ -157,15 +161,19 @@ namespace quda {
 
 
 
-    cudaColorSpinorField r0(r);
-    cudaColorSpinorField p(r);
-    cudaColorSpinorField Ap(r);
+    ColorSpinorField *r0p = ColorSpinorField::Create(csParam);
+    ColorSpinorField *pp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &r0 = *r0p;
+    ColorSpinorField &p = *pp;
+    blas::copy(r0, r);
+    blas::copy(p, r);
 
 
     const int s = 3;
 
     // Vector of matrix powers
-    std::vector<cudaColorSpinorField> PR(4*s+2,cudaColorSpinorField(b,csParam));
+    std::vector<ColorSpinorField*> PR(4*s+2);
+    for (auto &v : PR) v = ColorSpinorField::Create(csParam);
 
 
     Complex r0r;
@@ -260,7 +268,7 @@ namespace quda {
         }
 	blas::zero(r);
         for(int i=0; i<(4*s+2); ++i){
-	  blas::caxpy(c[0][i], PR[i], r);
+	  blas::caxpy(c[0][i], *PR[i], r);
         }
         r2 = blas::norm2(r);
         j++;
@@ -269,8 +277,8 @@ namespace quda {
 
       blas::zero(p);
       for(int i=0; i<(4*s+2); ++i){
-	blas::caxpy(a[0][i], PR[i], p);
-	blas::caxpy(e[i], PR[i], x);
+	blas::caxpy(a[0][i], *PR[i], p);
+	blas::caxpy(e[i], *PR[i], x);
       }
 
       m++;
@@ -279,6 +287,8 @@ namespace quda {
     if(it >= param.maxiter)
       warningQuda("Exceeded maximum iterations %d", param.maxiter);
 
+    param.iter += it;
+
     // compute the true residual
     mat(r, x, temp);
     param.true_res = sqrt(blas::xmyNorm(b, r)/b2);
@@ -307,6 +317,12 @@ namespace quda {
     delete[] c;
     delete[] c_new;
     delete[] e;
+
+    for (auto &v : PR) delete v;
+    delete pp;
+    delete r0p;
+    delete rp;
+    delete tempp;
 #endif
     return;
   }
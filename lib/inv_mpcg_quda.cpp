@@ -100,43 +100,49 @@ namespace quda {
 
   }
 
-  void MPCG::computeMatrixPowers(cudaColorSpinorField out[], cudaColorSpinorField &in, int nvec)
+  void MPCG::computeMatrixPowers(ColorSpinorField *out[], ColorSpinorField &in, int nvec)
   {
-    cudaColorSpinorField temp(in);
-    out[0] = in;
+    ColorSpinorParam csParam(in);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *temp = ColorSpinorField::Create(csParam);
+    blas::copy(*out[0], in);
     for(int i=1; i<nvec; ++i){
-      mat(out[i], out[i-1], temp);
+      mat(*out[i], *out[i-1], *temp);
     }
+    delete temp;
     return;
   }
 
-  void MPCG::computeMatrixPowers(std::vector<cudaColorSpinorField>& out, std::vector<cudaColorSpinorField>& in, int nsteps)
+  void MPCG::computeMatrixPowers(std::vector<ColorSpinorField*>& out, std::vector<ColorSpinorField*>& in, int nsteps)
   {
-    cudaColorSpinorField temp(in[0]);
+    ColorSpinorParam csParam(*in[0]);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *temp = ColorSpinorField::Create(csParam);
 
-    for(int i=0; i<=nsteps; ++i) out[i] = in[i];
+    for(int i=0; i<=nsteps; ++i) blas::copy(*out[i], *in[i]);
 
     for(int i=(nsteps+1); i<=(2*nsteps); ++i){
-      mat(out[i], out[i-1], temp);
+      mat(*out[i], *out[i-1], *temp);
     }
+    delete temp;
     return;
   }
 
 #ifdef SSTEP
-  static void computeGramMatrix(double** G, std::vector<cudaColorSpinorField>& v, double* mu){
+  static void computeGramMatrix(double** G, std::vector<ColorSpinorField*>& v, double* mu){
 
     const int dim = v.size();
     const int nsteps = (dim-1)/2;
 
     {
-      std::vector<cudaColorSpinorField*> vp1; vp1.reserve((nsteps+1)*nsteps);
-      std::vector<cudaColorSpinorField*> vp2; vp2.reserve((nsteps+1)*nsteps);
+      std::vector<ColorSpinorField*> vp1; vp1.reserve((nsteps+1)*nsteps);
+      std::vector<ColorSpinorField*> vp2; vp2.reserve((nsteps+1)*nsteps);
       double g[(nsteps+1)*nsteps];
     
       for(int i=0; i<nsteps; ++i){
         for(int j=nsteps; j<dim; j++){
-          vp1.push_back(&v[i]);
-          vp2.push_back(&v[j]);
+          vp1.push_back(v[i]);
+          vp2.push_back(v[j]);
         }
       }
       blas::reDotProduct(g, vp1, vp2);
@@ -152,15 +158,15 @@ namespace quda {
     const int num = dim-nsteps;
     const int offset = nsteps;
     double d[2*nsteps+1];
-    std::vector<cudaColorSpinorField*> vp1; vp1.reserve(2*nsteps+1);
-    std::vector<cudaColorSpinorField*> vp2; vp2.reserve(2*nsteps+1);
+    std::vector<ColorSpinorField*> vp1; vp1.reserve(2*nsteps+1);
+    std::vector<ColorSpinorField*> vp2; vp2.reserve(2*nsteps+1);
     for(int i=0; i<=nsteps; ++i){
-      vp1.push_back(&v[0+offset]);
-      vp2.push_back(&v[i+offset]);
+      vp1.push_back(v[0+offset]);
+      vp2.push_back(v[i+offset]);
     }
     for(int i=1; i<=nsteps; ++i){
-      vp1.push_back(&v[i+offset]);
-      vp2.push_back(&v[nsteps+offset]);
+      vp1.push_back(v[i+offset]);
+      vp2.push_back(v[nsteps+offset]);
     }
 
 
@@ -217,27 +223,31 @@ namespace quda {
     }
 
 
-    cudaColorSpinorField temp(b); // temporary field
-
     // Use ColorSpinorParam to create zerod fields
     ColorSpinorParam csParam(x);
     csParam.create = QUDA_ZERO_FIELD_CREATE;
-    cudaColorSpinorField x_prev(x,csParam);
-    cudaColorSpinorField x_new(x,csParam);
+    ColorSpinorField *tempp = ColorSpinorField::Create(csParam); // temporary field
+    ColorSpinorField *x_prevp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *x_newp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &temp = *tempp;
+    ColorSpinorField &x_prev = *x_prevp;
+    ColorSpinorField &x_new = *x_newp;
 
 
     const int s = 2;
 
     // create the residual array and the matrix powers array
-    std::vector<cudaColorSpinorField> R(s+1,cudaColorSpinorField(b,csParam));
-    std::vector<cudaColorSpinorField> V(2*s+1,cudaColorSpinorField(b,csParam));
+    std::vector<ColorSpinorField*> R(s+1);
+    std::vector<ColorSpinorField*> V(2*s+1);
+    for (auto &v : R) v = ColorSpinorField::Create(csParam);
+    for (auto &v : V) v = ColorSpinorField::Create(csParam);
 
     // Set up the first residual
-    for(int i=0; i<s; ++i) blas::zero(R[i]);
+    for(int i=0; i<s; ++i) blas::zero(*R[i]);
 
 
-    mat(R[s], x, temp);
-    double r2 = blas::xmyNorm(b,R[s]);
+    mat(*R[s], x, temp);
+    double r2 = blas::xmyNorm(b,*R[s]);
 
     double stop = stopping(param.tol, b2, param.residual_type);
 
@@ -261,7 +271,8 @@ namespace quda {
     // v[s+1] holds A r
     // v[s+2] holds A^(2)r
     // v[2*s] holds A^(s)r
-    cudaColorSpinorField w(b);
+    ColorSpinorField *wp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &w = *wp;
 
     double rAr;
 
@@ -287,12 +298,12 @@ namespace quda {
       computeMatrixPowers(V, R, s); 
       computeGramMatrix(G,V, mu);
     
-      R[0] = R[s];
+      blas::copy(*R[0], *R[s]);
 
       int j = 0;
       while(!convergence(r2,0.0,stop,0.0) && j<s){ 
         const int prev_idx = j ? j-1 : s-1;
-        cudaColorSpinorField& R_prev = R[prev_idx];
+        ColorSpinorField& R_prev = *R[prev_idx];
         double& mu_prev    = mu[prev_idx];
         double& rho_prev   = rho[prev_idx];
         double& gamma_prev = gamma[prev_idx];
@@ -301,7 +312,7 @@ namespace quda {
 
         if(j == 0){ 
           zero(d, 2*s+1); d[s+1] = 1.0;
-          w = V[s+1];
+          blas::copy(w, *V[s+1]);
           zero(g, 2*s+1); g[s] = 1.0;
         }else{
           if(j==1){ 
@@ -324,7 +335,7 @@ namespace quda {
           computeCoeffs(d, d_p1, d_p2, k, j, s, gamma, rho, gamma_kprev, rho_kprev);
 	  blas::zero(w); 
           for(int i=0; i<(2*s+1); ++i){
-            if(d[i] != 0.) blas::axpy(d[i], V[i], w);
+            if(d[i] != 0.) blas::axpy(d[i], *V[i], w);
           }
         }
 
@@ -335,15 +346,15 @@ namespace quda {
         gamma[j] = r2/rAr;
         rho[j] = (it==0) ? 1.0 : 1.0/(1.0 - (gamma[j]/gamma_prev)*(mu[j]/mu_prev)*(1.0/rho_prev));  
 
-        R[j+1] = R_prev;
-	blas::ax((1.0 - rho[j]), R[j+1]);
-	blas::axpy(rho[j], R[j], R[j+1]);
-	blas::axpy(-rho[j]*gamma[j], w, R[j+1]);
+        blas::copy(*R[j+1], R_prev);
+	blas::ax((1.0 - rho[j]), *R[j+1]);
+	blas::axpy(rho[j], *R[j], *R[j+1]);
+	blas::axpy(-rho[j]*gamma[j], w, *R[j+1]);
 
-        x_new = x_prev;
+        blas::copy(x_new, x_prev);
 	blas::ax((1.0 - rho[j]), x_new);
 	blas::axpy(rho[j], x, x_new);
-	blas::axpy(gamma[j]*rho[j], R[j], x_new);
+	blas::axpy(gamma[j]*rho[j], *R[j], x_new);
 
 
 
@@ -359,8 +370,8 @@ namespace quda {
         PrintStats("MPCG", it, r2, b2, 0.0);
         it++;
 
-        x_prev = x;
-        x = x_new;
+        blas::copy(x_prev, x);
+        blas::copy(x, x_new);
         ++j;
       } // loop over j
 
@@ -374,8 +385,10 @@ namespace quda {
     }
 
 
-    mat(R[0], x_prev, temp);
-    param.true_res = sqrt(blas::xmyNorm(b, R[0]) / b2);
+    param.iter += it;
+
+    mat(*R[0], x, temp);
+    param.true_res = sqrt(blas::xmyNorm(b, *R[0]) / b2);
 
 
     PrintSummary("MPCG", it, r2, b2, stop, param.tol_hq);
@@ -392,6 +405,13 @@ namespace quda {
       delete[] G[i];
     }
     delete G;
+
+    for (auto &v : V) delete v;
+    for (auto &v : R) delete v;
+    delete wp;
+    delete x_newp;
+    delete x_prevp;
+    delete tempp;
 #endif // sstep
     return;
   }
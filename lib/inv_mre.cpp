@@ -161,6 +161,90 @@ namespace quda {
     if (!running) profile.TPSTOP(QUDA_PROFILE_CHRONO);
   }
 
+  /*
+    As above, but with the basis and its image streamed from tiered
+    storage.  Since orthonormalising the basis would require writing
+    the spilled vectors back, the normal equations are formed directly
+    from the raw basis and rescaled to unit diagonal before the
+    factorization.
+  */
+  void MinResExt::operator()(ColorSpinorField &x, ColorSpinorField &b, TieredVectorStore &p, TieredVectorStore &q)
+  {
+    using namespace Eigen;
+    typedef Matrix<Complex, Dynamic, Dynamic> matrix;
+    typedef Matrix<Complex, Dynamic, 1> vector;
+
+    bool running = profile.isRunning(QUDA_PROFILE_CHRONO);
+    if (!running) profile.TPSTART(QUDA_PROFILE_CHRONO);
+
+    const int N = p.Size();
+    if (q.Size() != N) errorQuda("Basis size %d does not match operator image size %d", N, q.Size());
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Constructing minimum residual extrapolation with basis size %d (%d resident)\n", N, p.NumResident());
+
+    if (N == 0) {
+      blas::zero(x);
+      if (!running) profile.TPSTOP(QUDA_PROFILE_CHRONO);
+      return;
+    }
+
+    double b2 = getVerbosity() >= QUDA_SUMMARIZE ? blas::norm2(b) : 0.0;
+
+    std::vector<Complex> A_(N * N), phi_(N);
+    std::vector<ColorSpinorField *> B;
+    B.push_back(&b);
+
+    if (hermitian) {
+      // P* Q = (p_i, A p_j) and phi = P* b
+      p.cDotProduct(A_.data(), q);
+      p.cDotProduct(phi_.data(), B);
+    } else {
+      // Q* Q = (A p_i, A p_j) and phi = Q* b
+      q.cDotProduct(A_.data(), q);
+      q.cDotProduct(phi_.data(), B);
+    }
+
+    // rescale to unit diagonal
+    vector d(N);
+    for (int i = 0; i < N; i++) d(i) = 1.0 / sqrt(abs(A_[i * N + i]));
+
+    matrix A(N, N);
+    vector phi(N), psi(N);
+    for (int i = 0; i < N; i++) {
+      phi(i) = d(i) * phi_[i];
+      for (int j = 0; j < N; j++) A(i, j) = d(i) * A_[i * N + j] * d(j);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_CHRONO);
+    profile.TPSTART(QUDA_PROFILE_EIGEN);
+
+    LDLT<matrix> cholesky(A);
+    psi = cholesky.solve(phi);
+
+    profile.TPSTOP(QUDA_PROFILE_EIGEN);
+    profile.TPSTART(QUDA_PROFILE_CHRONO);
+
+    std::vector<Complex> alpha(N);
+    for (int i = 0; i < N; i++) alpha[i] = d(i) * psi(i);
+
+    blas::zero(x);
+    std::vector<ColorSpinorField *> X;
+    X.push_back(&x);
+    p.caxpy(alpha.data(), X);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      // compute the residual only if we're going to print it
+      for (int i = 0; i < N; i++) alpha[i] = -alpha[i];
+      q.caxpy(alpha.data(), B);
+
+      double rsd = sqrt(blas::norm2(b) / b2);
+      printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, rsd);
+    }
+
+    if (!running) profile.TPSTOP(QUDA_PROFILE_CHRONO);
+  }
+
   // Wrapper for the above
   void MinResExt::operator()(ColorSpinorField &x, ColorSpinorField &b, std::vector<std::pair<ColorSpinorField*,ColorSpinorField*> > basis) {
     std::vector<ColorSpinorField*> p(basis.size()), q(basis.size());
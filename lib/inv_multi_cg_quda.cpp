@@ -156,8 +156,7 @@ namespace quda {
 
   void MultiShiftCG::operator()(std::vector<ColorSpinorField*>x, ColorSpinorField &b, std::vector<ColorSpinorField*> &p, double* r2_old_array )
   {
-    if (checkLocation(*(x[0]), b) != QUDA_CUDA_FIELD_LOCATION)
-      errorQuda("Not supported");
+    checkLocation(*(x[0]), b);
 
     profile.TPSTART(QUDA_PROFILE_INIT);
 
@@ -214,27 +213,30 @@ namespace quda {
       if (param.tol_offset[j] < param.delta) reliable = true;
 
 
-    auto *r = new cudaColorSpinorField(b);
+    ColorSpinorParam csParam(b);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *r = ColorSpinorField::Create(csParam);
+    blas::copy(*r, b);
     std::vector<ColorSpinorField*> x_sloppy;
     x_sloppy.resize(num_offset);
     std::vector<ColorSpinorField*> y;
-  
-    ColorSpinorParam csParam(b);
+
     csParam.create = QUDA_ZERO_FIELD_CREATE;
 
     if (reliable) {
       y.resize(num_offset);
-      for (int i=0; i<num_offset; i++) y[i] = new cudaColorSpinorField(*r, csParam);
+      for (int i=0; i<num_offset; i++) y[i] = ColorSpinorField::Create(csParam);
     }
 
     csParam.setPrecision(param.precision_sloppy);
   
-    cudaColorSpinorField *r_sloppy;
+    ColorSpinorField *r_sloppy;
     if (param.precision_sloppy == x[0]->Precision()) {
       r_sloppy = r;
     } else {
-      csParam.create = QUDA_COPY_FIELD_CREATE;
-      r_sloppy = new cudaColorSpinorField(*r, csParam);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      r_sloppy = ColorSpinorField::Create(csParam);
+      blas::copy(*r_sloppy, *r);
     }
   
     if (param.precision_sloppy == x[0]->Precision() ||
@@ -246,28 +248,33 @@ namespace quda {
     } else {
       csParam.create = QUDA_ZERO_FIELD_CREATE;
       for (int i=0; i<num_offset; i++)
-	x_sloppy[i] = new cudaColorSpinorField(*x[i], csParam);
+	x_sloppy[i] = ColorSpinorField::Create(csParam);
     }
   
     p.resize(num_offset);
-    for (int i=0; i<num_offset; i++) p[i] = new cudaColorSpinorField(*r_sloppy);    
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    for (int i=0; i<num_offset; i++) {
+      p[i] = ColorSpinorField::Create(csParam);
+      blas::copy(*p[i], *r_sloppy);
+    }
   
     csParam.create = QUDA_ZERO_FIELD_CREATE;
-    auto* Ap = new cudaColorSpinorField(*r_sloppy, csParam);
+    ColorSpinorField *Ap = ColorSpinorField::Create(csParam);
   
-    cudaColorSpinorField tmp1(*Ap, csParam);
+    ColorSpinorField *tmp1_p = ColorSpinorField::Create(csParam);
+    ColorSpinorField &tmp1 = *tmp1_p;
 
     // tmp2 only needed for multi-gpu Wilson-like kernels
-    cudaColorSpinorField *tmp2_p = !mat.isStaggered() ?
-      new cudaColorSpinorField(*Ap, csParam) : &tmp1;
-    cudaColorSpinorField &tmp2 = *tmp2_p;
+    ColorSpinorField *tmp2_p = !mat.isStaggered() ?
+      ColorSpinorField::Create(csParam) : &tmp1;
+    ColorSpinorField &tmp2 = *tmp2_p;
 
     // additional high-precision temporary if Wilson and mixed-precision
     csParam.setPrecision(param.precision);
-    cudaColorSpinorField *tmp3_p =
+    ColorSpinorField *tmp3_p =
       (param.precision != param.precision_sloppy && !mat.isStaggered()) ?
-      new cudaColorSpinorField(*r, csParam) : &tmp1;
-    cudaColorSpinorField &tmp3 = *tmp3_p;
+      ColorSpinorField::Create(csParam) : &tmp1;
+    ColorSpinorField &tmp3 = *tmp3_p;
 
     profile.TPSTOP(QUDA_PROFILE_INIT);
     profile.TPSTART(QUDA_PROFILE_PREAMBLE);
@@ -319,6 +326,8 @@ namespace quda {
 
     // now create the worker class for updating the shifted solutions and gradient vectors
     ShiftUpdate shift_update(r_sloppy, p, x_sloppy, alpha, beta, zeta, zeta_old, j_low, num_offset_now);
+    const bool host = b.Location() == QUDA_CPU_FIELD_LOCATION;
+    if (host) shift_update.updateNupdate(1);
     
     profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
     profile.TPSTART(QUDA_PROFILE_COMPUTE);
@@ -328,7 +337,11 @@ namespace quda {
     
     while ( !convergence(r2, stop, num_offset_now) &&  !exit_early && k < param.maxiter) {
 
-      if (aux_update) dslash::aux_worker = &shift_update;
+      if (aux_update) {
+        // a host operator has no dslash to overlap the shifted updates with
+        if (host) shift_update.apply(0);
+        else dslash::aux_worker = &shift_update;
+      }
       matSloppy(*Ap, *p[0], tmp1, tmp2);
       dslash::aux_worker = nullptr;
       aux_update = false;
@@ -566,6 +579,7 @@ namespace quda {
 
     if (&tmp3 != &tmp1) delete tmp3_p;
     if (&tmp2 != &tmp1) delete tmp2_p;
+    delete tmp1_p;
 
     if (r_sloppy->Precision() != r->Precision()) delete r_sloppy;
     for (int i=0; i<num_offset; i++) 
@@ -0,0 +1,284 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+#include <comm_quda.h>
+
+/*!
+ * Lock-step CG refinement of the shifted systems (A + shift_i) x_i = b
+ *
+ * After a multi-shift solve some of the shifted systems can be left
+ * short of their tolerance, e.g., because the shifted residuals are
+ * only iterated in sloppy precision.  Rather than solving these one
+ * at a time, all of them are iterated together here.  The systems do
+ * not share a Krylov space (each has its own initial residual), so
+ * the operator is still applied once per system and iteration, but
+ * these applications are issued back to back.  Each system only
+ * needs its own (p, Ap) and (r, r), so these are computed as local
+ * reductions per system (the r update fused with its norm) and then
+ * summed over the nodes in one global reduction each per iteration,
+ * regardless of the number of systems.
+ *
+ * For staggered the mass is folded into the operator, so the shifts
+ * passed are relative to the lowest offset, else they are the offsets
+ * themselves.
+ */
+
+namespace quda {
+
+  // Per-system reductions: local(a) returns the node-local value of
+  // system a, and the values of all the systems are then summed over
+  // the nodes in a single global reduction
+  template <typename F> static std::vector<double> batchReduce(int m, F &&local)
+  {
+    std::vector<double> result(m);
+    const bool global = commGlobalReduction();
+    commGlobalReductionSet(false);
+    for (int a = 0; a < m; a++) result[a] = local(a);
+    commGlobalReductionSet(global);
+    reduceDoubleArray(result.data(), m);
+    return result;
+  }
+
+  MultiShiftRefineCG::MultiShiftRefineCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param,
+                                         TimeProfile &profile) :
+    MultiShiftSolver(param, profile),
+    mat(mat),
+    matSloppy(matSloppy)
+  {
+  }
+
+  MultiShiftRefineCG::~MultiShiftRefineCG() {}
+
+  void MultiShiftRefineCG::operator()(std::vector<ColorSpinorField *> x, ColorSpinorField &b,
+                                      const std::vector<int> &idx, const std::vector<double> &shift,
+                                      const std::vector<double> &tol)
+  {
+    const int n = x.size();
+    if (n == 0) return;
+    if (idx.size() != x.size() || shift.size() != x.size() || tol.size() != x.size())
+      errorQuda("Mismatched number of systems %lu %lu %lu %lu", x.size(), idx.size(), shift.size(), tol.size());
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    const double b2 = blas::norm2(b);
+    if (b2 == 0) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      for (int j = 0; j < n; j++) {
+        blas::zero(*x[j]);
+        param.true_res_offset[idx[j]] = 0.0;
+        param.iter_res_offset[idx[j]] = 0.0;
+        param.true_res_hq_offset[idx[j]] = 0.0;
+      }
+      return;
+    }
+
+    ColorSpinorParam csParam(b);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *r = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmp2 = ColorSpinorField::Create(csParam);
+
+    csParam.setPrecision(param.precision_sloppy);
+    ColorSpinorField *tmpSloppy = ColorSpinorField::Create(csParam);
+    ColorSpinorField *tmp2Sloppy = ColorSpinorField::Create(csParam);
+
+    // per system sloppy residual, search direction, its image and the
+    // partial solution accumulated since the last reliable update
+    std::vector<ColorSpinorField *> rSloppy(n), p(n), Ap(n), xSloppy(n);
+    for (int j = 0; j < n; j++) {
+      rSloppy[j] = ColorSpinorField::Create(csParam);
+      p[j] = ColorSpinorField::Create(csParam);
+      Ap[j] = ColorSpinorField::Create(csParam);
+      xSloppy[j] = ColorSpinorField::Create(csParam);
+    }
+
+    // true residual r = b - (A + shift_j) x_j, returning |r|^2
+    auto trueResidual = [&](int j) {
+      mat(*r, *x[j], *tmp, *tmp2);
+      if (shift[j] != 0.0) blas::axpy(shift[j], *x[j], *r);
+      return blas::xmyNorm(b, *r);
+    };
+
+    std::vector<double> stop(n), r2(n), r2_true(n), maxr(n);
+    std::vector<int> iter(n, 0), resIncrease(n, 0);
+    std::vector<int> active;
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    for (int j = 0; j < n; j++) {
+      stop[j] = Solver::stopping(tol[j], b2, QUDA_L2_RELATIVE_RESIDUAL);
+      r2[j] = r2_true[j] = trueResidual(j);
+      maxr[j] = sqrt(r2[j]);
+      if (r2[j] > stop[j]) {
+        blas::copy(*rSloppy[j], *r);
+        blas::copy(*p[j], *rSloppy[j]);
+        blas::zero(*xSloppy[j]);
+        active.push_back(j);
+      } else {
+        param.true_res_hq_offset[idx[j]] = sqrt(blas::HeavyQuarkResidualNorm(*x[j], *r).z);
+      }
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    int k = 0;
+    int rUpdate = 0;
+    while (active.size() > 0 && k < param.maxiter) {
+      const int m = active.size();
+      std::vector<ColorSpinorField *> P(m), AP(m), R(m), X(m);
+      for (int a = 0; a < m; a++) {
+        const int j = active[a];
+        P[a] = p[j];
+        AP[a] = Ap[j];
+        R[a] = rSloppy[j];
+        X[a] = xSloppy[j];
+      }
+
+      for (int a = 0; a < m; a++) {
+        const int j = active[a];
+        matSloppy(*Ap[j], *p[j], *tmpSloppy, *tmp2Sloppy);
+        if (shift[j] != 0.0) blas::axpy(shift[j], *p[j], *Ap[j]);
+      }
+
+      // curvature of every active system in one reduction
+      const std::vector<double> pAp
+        = batchReduce(m, [&](int a) { return blas::reDotProduct(*P[a], *AP[a]); });
+
+      // x_j += alpha_j p_j and r_j -= alpha_j Ap_j, with the new residual norms in one reduction
+      const std::vector<double> rr = batchReduce(m, [&](int a) {
+        const double alpha = r2[active[a]] / pAp[a];
+        blas::axpy(alpha, *P[a], *X[a]);
+        return blas::axpyNorm(-alpha, *AP[a], *R[a]);
+      });
+
+      k++;
+      std::vector<int> still_active;
+      for (int a = 0; a < m; a++) {
+        const int j = active[a];
+        double r2_new = rr[a];
+        iter[j]++;
+
+        const bool converged = r2_new < stop[j];
+        const bool reliable = sqrt(r2_new) < param.delta * maxr[j];
+
+        if (converged || reliable) {
+          blas::xpy(*xSloppy[j], *x[j]);
+          blas::zero(*xSloppy[j]);
+          r2_new = trueResidual(j);
+          blas::copy(*rSloppy[j], *r);
+          maxr[j] = sqrt(r2_new);
+          rUpdate++;
+
+          if (r2_new < stop[j]) {
+            r2[j] = r2_true[j] = r2_new;
+            param.true_res_hq_offset[idx[j]] = sqrt(blas::HeavyQuarkResidualNorm(*x[j], *r).z);
+            if (getVerbosity() >= QUDA_VERBOSE)
+              printfQuda("MultiShift Refine CG: Shift %d converged after %d iterations\n", idx[j], iter[j]);
+            continue;
+          }
+
+          // give up on a system whose true residual no longer decreases,
+          // e.g., when the tolerance is beyond the precision limit
+          if (r2_new > r2_true[j]) {
+            if (++resIncrease[j] > param.max_res_increase) {
+              warningQuda("MultiShift Refine CG: Shift %d residual stagnated at %e after %d iterations", idx[j],
+                          sqrt(r2_new / b2), iter[j]);
+              r2[j] = r2_true[j] = r2_new;
+              param.true_res_hq_offset[idx[j]] = sqrt(blas::HeavyQuarkResidualNorm(*x[j], *r).z);
+              continue;
+            }
+          } else {
+            resIncrease[j] = 0;
+          }
+          r2_true[j] = r2_new;
+
+          if (converged) {
+            // the iterated residual had converged but the true one has
+            // not, so restart the search direction
+            blas::copy(*p[j], *rSloppy[j]);
+            r2[j] = r2_new;
+            still_active.push_back(j);
+            continue;
+          }
+        }
+
+        const double beta = r2_new / r2[j];
+        r2[j] = r2_new;
+        blas::xpay(*rSloppy[j], beta, *p[j]);
+        still_active.push_back(j);
+      }
+      active = still_active;
+
+      if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
+        for (auto j : active)
+          printfQuda("MultiShift Refine CG: %d iterations, shift %d, |r|/|b| = %e\n", k, idx[j], sqrt(r2[j] / b2));
+      }
+    }
+
+    // fold in the partial solutions of any system that ran out of iterations
+    for (auto j : active) {
+      blas::xpy(*xSloppy[j], *x[j]);
+      r2_true[j] = trueResidual(j);
+      param.true_res_hq_offset[idx[j]] = sqrt(blas::HeavyQuarkResidualNorm(*x[j], *r).z);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    if (k == param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    int matvecs = 0;
+    for (int j = 0; j < n; j++) {
+      matvecs += iter[j];
+      param.true_res_offset[idx[j]] = sqrt(r2_true[j] / b2);
+      param.iter_res_offset[idx[j]] = sqrt(r2[j] / b2);
+    }
+
+    param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+    param.gflops += (blas::flops + mat.flops() + matSloppy.flops()) * 1e-9;
+    param.iter += matvecs;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("MultiShift Refine CG: %d systems refined in %d iterations (%d matrix-vector products, %d reliable "
+                 "updates)\n",
+                 n, k, matvecs, rUpdate);
+      for (int j = 0; j < n; j++)
+        printfQuda(" shift=%d, %d iterations, relative residual: iterated = %e, true = %e\n", idx[j], iter[j],
+                   param.iter_res_offset[idx[j]], param.true_res_offset[idx[j]]);
+    }
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    for (int j = 0; j < n; j++) {
+      delete xSloppy[j];
+      delete Ap[j];
+      delete p[j];
+      delete rSloppy[j];
+    }
+    delete tmp2Sloppy;
+    delete tmpSloppy;
+    delete tmp2;
+    delete tmp;
+    delete r;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+} // namespace quda
@@ -48,6 +48,8 @@ namespace quda {
       K = new MR(matPrecon, matPrecon, Kparam, profile);
     }else if(param.inv_type_precondition == QUDA_SD_INVERTER){
       K = new SD(matPrecon, Kparam, profile);
+    }else if(param.inv_type_precondition == QUDA_POLYNOMIAL_INVERTER){
+      K = new PolynomialPreconditioner(matPrecon, matPrecon, Kparam, profile, true);
     }else if(param.inv_type_precondition != QUDA_INVALID_INVERTER){ // unknown preconditioner
       errorQuda("Unknown inner solver %d", param.inv_type_precondition);
     }
@@ -74,56 +76,63 @@ namespace quda {
       x=b;
       param.true_res = 0.0;
       param.true_res_hq = 0.0;
+      return;
     }
 
     int k=0;
     int rUpdate=0;
 
-    cudaColorSpinorField* minvrPre = NULL;
-    cudaColorSpinorField* rPre = NULL;
-    cudaColorSpinorField* minvr = NULL;
-    cudaColorSpinorField* minvrSloppy = NULL;
-    cudaColorSpinorField* p = NULL;
+    ColorSpinorField* minvrPre = NULL;
+    ColorSpinorField* rPre = NULL;
+    ColorSpinorField* minvr = NULL;
+    ColorSpinorField* minvrSloppy = NULL;
+    ColorSpinorField* p = NULL;
 
 
     ColorSpinorParam csParam(b);
-    cudaColorSpinorField r(b);
-    if(K) minvr = new cudaColorSpinorField(b);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *rp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &r = *rp;
+    if(K) minvr = ColorSpinorField::Create(csParam);
     csParam.create = QUDA_ZERO_FIELD_CREATE;
-    cudaColorSpinorField y(b,csParam);
+    ColorSpinorField *yp = ColorSpinorField::Create(csParam);
+    ColorSpinorField &y = *yp;
 
     mat(r, x, y); // => r = A*x;
     double r2 = xmyNorm(b,r);
 
     csParam.setPrecision(param.precision_sloppy);
-    cudaColorSpinorField tmpSloppy(x,csParam);
-    cudaColorSpinorField Ap(x,csParam);
+    ColorSpinorField *tmpSloppyp = ColorSpinorField::Create(csParam);
+    ColorSpinorField *App = ColorSpinorField::Create(csParam);
+    ColorSpinorField &tmpSloppy = *tmpSloppyp;
+    ColorSpinorField &Ap = *App;
 
-    cudaColorSpinorField *r_sloppy;
+    ColorSpinorField *r_sloppy;
     if(param.precision_sloppy == x.Precision())
     {
       r_sloppy = &r;
       minvrSloppy = minvr;
     }else{
-      csParam.create = QUDA_COPY_FIELD_CREATE;
-      r_sloppy = new cudaColorSpinorField(r,csParam);
-      if(K) minvrSloppy = new cudaColorSpinorField(*minvr,csParam);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      r_sloppy = ColorSpinorField::Create(csParam);
+      copy(*r_sloppy, r);
+      if(K) minvrSloppy = ColorSpinorField::Create(csParam);
     }
   
 
-    cudaColorSpinorField *x_sloppy;
+    ColorSpinorField *x_sloppy;
     if(param.precision_sloppy == x.Precision() ||
         !param.use_sloppy_partial_accumulator) {
-      csParam.create = QUDA_REFERENCE_FIELD_CREATE;
-      x_sloppy = &static_cast<cudaColorSpinorField&>(x);
+      x_sloppy = &x;
     }else{
-      csParam.create = QUDA_COPY_FIELD_CREATE;
-      x_sloppy = new cudaColorSpinorField(x,csParam);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      x_sloppy = ColorSpinorField::Create(csParam);
+      copy(*x_sloppy, x);
     }
 
 
-    cudaColorSpinorField &xSloppy = *x_sloppy;
-    cudaColorSpinorField &rSloppy = *r_sloppy;
+    ColorSpinorField &xSloppy = *x_sloppy;
+    ColorSpinorField &rSloppy = *r_sloppy;
 
     if(&x != &xSloppy){
       copy(y, x); // copy x to y
@@ -135,20 +144,23 @@ namespace quda {
     const bool use_heavy_quark_res = (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
 
     if(K){
-      csParam.create = QUDA_COPY_FIELD_CREATE;
+      csParam.create = QUDA_NULL_FIELD_CREATE;
       csParam.setPrecision(param.precision_precondition);
-      rPre = new cudaColorSpinorField(rSloppy,csParam);
+      rPre = ColorSpinorField::Create(csParam);
+      copy(*rPre, rSloppy);
       // Create minvrPre 
-      minvrPre = new cudaColorSpinorField(*rPre);
+      minvrPre = ColorSpinorField::Create(csParam);
       commGlobalReductionSet(false);
       (*K)(*minvrPre, *rPre);  
       commGlobalReductionSet(true);
-      *minvrSloppy = *minvrPre;
-      p = new cudaColorSpinorField(*minvrSloppy);
-    }else{
-      p = new cudaColorSpinorField(rSloppy);
+      copy(*minvrSloppy, *minvrPre);
     }
 
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    csParam.setPrecision(param.precision_sloppy);
+    p = ColorSpinorField::Create(csParam);
+    copy(*p, K ? *minvrSloppy : rSloppy);
+
   
     profile.TPSTOP(QUDA_PROFILE_INIT);
 
@@ -224,13 +236,13 @@ namespace quda {
 
         if(K){
           r_new_Minvr_old = reDotProduct(rSloppy,*minvrSloppy);
-          *rPre = rSloppy;
+          copy(*rPre, rSloppy);
 	  commGlobalReductionSet(false);
           (*K)(*minvrPre, *rPre);
 	  commGlobalReductionSet(true);
       
 
-          *minvrSloppy = *minvrPre;
+          copy(*minvrSloppy, *minvrPre);
 
           rMinvr = reDotProduct(rSloppy,*minvrSloppy);
           beta = (rMinvr - r_new_Minvr_old)/rMinvr_old; 
@@ -271,12 +283,12 @@ namespace quda {
         ++rUpdate;
 
         if(K){
-          *rPre = rSloppy;
+          copy(*rPre, rSloppy);
 	  commGlobalReductionSet(false);
           (*K)(*minvrPre, *rPre);
 	  commGlobalReductionSet(true);
 
-          *minvrSloppy = *minvrPre;
+          copy(*minvrSloppy, *minvrPre);
 
           rMinvr = reDotProduct(rSloppy,*minvrSloppy);
           beta = rMinvr/rMinvr_old;        
@@ -342,10 +354,12 @@ namespace quda {
     }
     delete p;
 
-    if(x.Precision() != param.precision_sloppy){
-      delete x_sloppy;
-      delete r_sloppy;
-    }
+    if(x_sloppy != &x) delete x_sloppy;
+    if(r_sloppy != &r) delete r_sloppy;
+    delete App;
+    delete tmpSloppyp;
+    delete yp;
+    delete rp;
 
     profile.TPSTOP(QUDA_PROFILE_FREE);
     return;
@@ -0,0 +1,279 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+/*!
+ * GMRES polynomial preconditioner
+ *
+ * The roots theta_i of the GMRES residual polynomial
+ *
+ *   pi(z) = 1 - z p(z) = prod_i (1 - z / theta_i)
+ *
+ * are the harmonic Ritz values of an Arnoldi run of length d, so the
+ * polynomial p(A) ~ A^{-1} can be applied as
+ *
+ *   y = sum_i (1 / theta_i) w_i,  w_1 = v,  w_{i+1} = (1 - A / theta_i) w_i
+ *
+ * which needs d - 1 matrix-vector products, two caxpys per product
+ * and no reductions at all.  For stability the roots are Leja ordered
+ * and outlying roots are repeated (Loe and Morgan, "Toward efficient
+ * polynomial preconditioning for GMRES").
+ */
+
+namespace quda {
+
+  using Eigen::MatrixXcd;
+  using Eigen::VectorXcd;
+
+  PolynomialPreconditioner::PolynomialPreconditioner(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param,
+                                                     TimeProfile &profile, bool hermitian) :
+    Solver(param, profile),
+    mat(mat),
+    matSloppy(matSloppy),
+    hermitian(hermitian),
+    init(false),
+    wp(nullptr),
+    Awp(nullptr),
+    tmpp(nullptr),
+    y_sloppy(nullptr),
+    in_sloppy(nullptr)
+  {
+    if (param.maxiter < 1) errorQuda("Invalid polynomial degree %d", param.maxiter);
+  }
+
+  PolynomialPreconditioner::~PolynomialPreconditioner()
+  {
+    if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_FREE);
+    if (in_sloppy) delete in_sloppy;
+    if (y_sloppy) delete y_sloppy;
+    if (tmpp) delete tmpp;
+    if (Awp) delete Awp;
+    if (wp) delete wp;
+    if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+  // modified Leja ordering: start from the largest root, then each
+  // next root maximizes the product of distances to those before it
+  static std::vector<Complex> lejaOrder(std::vector<Complex> z)
+  {
+    std::vector<Complex> ordered;
+    std::vector<double> log_prod(z.size(), 0.0);
+
+    auto largest = std::max_element(z.begin(), z.end(), [](Complex a, Complex b) { return abs(a) < abs(b); });
+    std::swap(*largest, z.back());
+
+    while (z.size() > 0) {
+      ordered.push_back(z.back());
+      z.pop_back();
+      log_prod.pop_back();
+      if (z.size() == 0) break;
+
+      for (unsigned int i = 0; i < z.size(); i++) log_prod[i] += log(abs(z[i] - ordered.back()) + 1e-300);
+      auto next = std::max_element(log_prod.begin(), log_prod.end()) - log_prod.begin();
+      std::swap(z[next], z.back());
+      std::swap(log_prod[next], log_prod.back());
+    }
+    return ordered;
+  }
+
+  void PolynomialPreconditioner::construct(ColorSpinorField &v)
+  {
+    const int d = param.maxiter;
+
+    // Arnoldi with classical Gram-Schmidt and reorthogonalization, one
+    // multi-reduction per pass
+    ColorSpinorParam csParam(v);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    std::vector<ColorSpinorField *> V;
+    V.push_back(ColorSpinorField::Create(csParam));
+    blas::copy(*V[0], v);
+    double beta = sqrt(blas::norm2(*V[0]));
+    if (beta == 0.0) errorQuda("Cannot construct polynomial from a zero vector");
+    blas::ax(1.0 / beta, *V[0]);
+
+    MatrixXcd H = MatrixXcd::Zero(d + 1, d);
+    int k = 0;
+    for (; k < d; k++) {
+      V.push_back(ColorSpinorField::Create(csParam));
+      ColorSpinorField &w = *V[k + 1];
+      matSloppy(w, *V[k], *tmpp);
+
+      std::vector<ColorSpinorField *> Vk(V.begin(), V.begin() + k + 1), W(1, &w);
+      std::vector<Complex> h(k + 1);
+      for (int pass = 0; pass < 2; pass++) {
+        blas::cDotProduct(h.data(), Vk, W);
+        for (int i = 0; i <= k; i++) {
+          H(i, k) += h[i];
+          h[i] = -h[i];
+        }
+        blas::caxpy(h.data(), Vk, W);
+      }
+
+      H(k + 1, k) = sqrt(blas::norm2(w));
+      if (abs(H(k + 1, k)) < 1e-12 * H.col(k).norm()) {
+        // invariant subspace found: the polynomial is exact at this degree
+        k++;
+        break;
+      }
+      blas::ax(1.0 / H(k + 1, k).real(), w);
+    }
+    const int n = k;
+    for (auto vec : V) delete vec;
+
+    MatrixXcd Hn = H.topLeftCorner(n, n);
+    if (hermitian) Hn = 0.5 * (Hn + Hn.adjoint()).eval();
+
+    // harmonic Ritz values: eigenvalues of H + |h_{n+1,n}|^2 H^{-dagger} e_n e_n^T
+    VectorXcd e_n = VectorXcd::Zero(n);
+    e_n(n - 1) = 1.0;
+    VectorXcd f = Hn.adjoint().partialPivLu().solve(e_n);
+    MatrixXcd Hh = Hn;
+    Hh.col(n - 1) += std::norm(H(n, n - 1)) * f;
+
+    Eigen::ComplexEigenSolver<MatrixXcd> eig(Hh, false);
+    std::vector<Complex> roots(n);
+    for (int i = 0; i < n; i++) {
+      roots[i] = hermitian ? Complex(eig.eigenvalues()(i).real(), 0.0) : eig.eigenvalues()(i);
+      if (abs(roots[i]) == 0.0) errorQuda("Zero harmonic Ritz value, the operator is singular");
+    }
+    roots = lejaOrder(roots);
+
+    // repeat roots where the polynomial is steep, so that the partial
+    // products do not grow large enough to lose the other roots
+    std::vector<Complex> added;
+    for (int i = 0; i < n; i++) {
+      double log_pof = 0.0;
+      for (int j = 0; j < n; j++)
+        if (j != i) log_pof += log10(abs(1.0 - roots[i] / roots[j]) + 1e-300);
+      if (log_pof > 4.0) {
+        const int copies = static_cast<int>(ceil((log_pof - 4.0) / 14.0));
+        for (int c = 0; c < copies; c++) added.push_back(roots[i]);
+      }
+    }
+
+    theta = roots;
+    for (unsigned int i = 0; i < added.size(); i++) {
+      // interleave the added roots through the second half of the product
+      theta.insert(theta.begin() + std::min<size_t>(theta.size(), n / 2 + 2 * i + 1), added[i]);
+    }
+
+    if (hermitian) {
+      // p must be positive on the spectrum for use in PCG, i.e., |pi(z)| < 1
+      double lambda_max = 0.0;
+      for (auto t : theta) lambda_max = std::max(lambda_max, t.real());
+      for (int i = 1; i <= 100; i++) {
+        const double z = i * 1.05 * lambda_max / 100;
+        Complex pi = 1.0;
+        for (auto t : theta) pi *= 1.0 - z / t;
+        if (pi.real() >= 1.0) {
+          warningQuda("Polynomial is not positive at z = %e, the preconditioned operator is not HPD", z);
+          break;
+        }
+      }
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      printfQuda("Polynomial preconditioner: degree %lu (%lu added roots) from %d Arnoldi steps\n", theta.size(),
+                 added.size(), n);
+      if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+        for (unsigned int i = 0; i < theta.size(); i++)
+          printfQuda("theta[%d] = (%e, %e)\n", i, theta[i].real(), theta[i].imag());
+    }
+  }
+
+  void PolynomialPreconditioner::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_INIT);
+
+    const bool mixed = param.precision_sloppy != x.Precision();
+    if (!init) {
+      ColorSpinorParam csParam(x);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      csParam.setPrecision(param.precision_sloppy);
+      wp = ColorSpinorField::Create(csParam);
+      Awp = ColorSpinorField::Create(csParam);
+      tmpp = ColorSpinorField::Create(csParam);
+      if (mixed) {
+        y_sloppy = ColorSpinorField::Create(csParam);
+        in_sloppy = ColorSpinorField::Create(csParam);
+      }
+      init = true;
+    }
+
+    ColorSpinorField &w = *wp;
+    ColorSpinorField &Aw = *Awp;
+    ColorSpinorField &tmp = *tmpp;
+    ColorSpinorField &y = mixed ? *y_sloppy : x;
+
+    if (mixed) blas::copy(*in_sloppy, b);
+    ColorSpinorField &bSloppy = mixed ? *in_sloppy : b;
+
+    if (theta.size() == 0) {
+      if (blas::norm2(bSloppy) == 0.0) {
+        blas::zero(x);
+        if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_INIT);
+        return;
+      }
+      construct(bSloppy);
+    }
+
+    if (!param.is_preconditioner) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      profile.TPSTART(QUDA_PROFILE_COMPUTE);
+      blas::flops = 0;
+    }
+
+    const int n = theta.size();
+    blas::copy(w, bSloppy);
+    blas::zero(y);
+    for (int i = 0; i < n; i++) {
+      const Complex inv_theta = 1.0 / theta[i];
+      blas::caxpy(inv_theta, w, y);
+      if (i < n - 1) {
+        matSloppy(Aw, w, tmp);
+        blas::caxpy(-inv_theta, Aw, w);
+      }
+    }
+    if (mixed) blas::copy(x, y);
+
+    param.iter += n - 1;
+
+    if (!param.is_preconditioner) {
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+      param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+      param.gflops += (blas::flops + matSloppy.flops()) * 1e-9;
+
+      // the polynomial is a fixed approximate inverse, so report how good it is
+      ColorSpinorParam csParam(x);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      ColorSpinorField *r = ColorSpinorField::Create(csParam);
+      ColorSpinorField *tmp2 = ColorSpinorField::Create(csParam);
+      mat(*r, x, *tmp2);
+      param.true_res = sqrt(blas::xmyNorm(b, *r) / blas::norm2(b));
+      param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x, *r).z);
+      PrintSummary("Polynomial", n - 1, param.true_res * param.true_res, 1.0, 0.0, 0.0);
+      delete tmp2;
+      delete r;
+
+      blas::flops = 0;
+      mat.flops();
+      matSloppy.flops();
+
+      profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    }
+  }
+
+} // namespace quda
@@ -36,9 +36,11 @@ namespace quda {
     commGlobalReductionSet(param.global_reduction);
 
     if(!init){
-      r = new cudaColorSpinorField(b);
-      Ar = new cudaColorSpinorField(b);
-      y = new cudaColorSpinorField(b);
+      ColorSpinorParam csParam(b);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      r = ColorSpinorField::Create(csParam);
+      Ar = ColorSpinorField::Create(csParam);
+      y = ColorSpinorField::Create(csParam);
       init = true;
     }
 
@@ -0,0 +1,119 @@
+#include <array>
+#include <map>
+
+#include <lattice_geometry.h>
+
+namespace quda {
+
+  LatticeGeometry::LatticeGeometry(const int *X_, const int *R_) :
+    halo(false),
+    table(new std::atomic<const int *>[n_table])
+  {
+    volume = 1;
+    volumeEx = 1;
+    for (int d = 0; d < 4; d++) {
+      X[d] = X_[d];
+      R[d] = R_ ? R_[d] : 0;
+      E[d] = X[d] + 2 * R[d];
+      if (R[d] < 0) errorQuda("Invalid halo depth %d in dimension %d", R[d], d);
+      if (R[d] > 0) halo = true;
+      volume *= X[d];
+      volumeEx *= E[d];
+    }
+    if (X[0] % 2 || E[0] % 2) errorQuda("Lattice x dimensions %d %d must be even", X[0], E[0]);
+    volumeCB = volume / 2;
+    volumeExCB = volumeEx / 2;
+
+    for (int i = 0; i < n_table; i++) table[i].store(nullptr, std::memory_order_relaxed);
+
+    const int_fastdiv Xh(X[0] / 2);
+    const int_fastdiv X1(X[1]);
+    const int_fastdiv X2(X[2]);
+
+    coord.resize(4 * volume);
+#pragma omp parallel for
+    for (int i = 0; i < volume; i++) {
+      const int parity = i >= volumeCB ? 1 : 0;
+      const int x_cb = i - parity * volumeCB;
+      const int za = x_cb / Xh;
+      const int x0h = x_cb - za * (X[0] / 2);
+      const int zb = za / X1;
+      const int x1 = za - zb * X[1];
+      const int x3 = zb / X2;
+      const int x2 = zb - x3 * X[2];
+
+      coord[4 * i + 0] = 2 * x0h + ((x1 + x2 + x3 + parity) & 1);
+      coord[4 * i + 1] = x1;
+      coord[4 * i + 2] = x2;
+      coord[4 * i + 3] = x3;
+    }
+  }
+
+  int LatticeGeometry::Index(const int x_[4]) const
+  {
+    int x[4];
+    if (halo) {
+      for (int d = 0; d < 4; d++) {
+        x[d] = x_[d] + R[d];
+        if (x[d] < 0 || x[d] >= E[d])
+          errorQuda("Coordinate %d in dimension %d outside of halo of depth %d", x_[d], d, R[d]);
+      }
+    } else {
+      for (int d = 0; d < 4; d++) {
+        x[d] = x_[d] % X[d];
+        if (x[d] < 0) x[d] += X[d];
+      }
+    }
+
+    const int parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+    return parity * volumeExCB + ((((x[3] * E[2] + x[2]) * E[1] + x[1]) * E[0] + x[0]) >> 1);
+  }
+
+  const int *LatticeGeometry::buildTable(const int dx[4]) const
+  {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    auto &entry = table[tableIndex(dx)];
+    const int *t = entry.load(std::memory_order_acquire);
+    if (t) return t; // another thread won the race
+
+    std::unique_ptr<int[]> nbr(new int[volume]);
+    for (int d = 0; d < 4; d++) {
+      if (halo && (dx[d] > R[d] || -dx[d] > R[d]))
+        errorQuda("Displacement %d in dimension %d exceeds halo depth %d", dx[d], d, R[d]);
+    }
+
+    int *n = nbr.get();
+#pragma omp parallel for
+    for (int i = 0; i < volume; i++) {
+      int y[4];
+      for (int d = 0; d < 4; d++) y[d] = coord[4 * i + d] + dx[d];
+      n[i] = Index(y);
+    }
+
+    table_store.push_back(std::move(nbr));
+    entry.store(n, std::memory_order_release);
+    return n;
+  }
+
+  const LatticeGeometry &getLatticeGeometry(const int *X, const int *R)
+  {
+    static std::map<std::array<int, 8>, std::unique_ptr<LatticeGeometry>> cache;
+    static std::mutex cache_mutex;
+
+    // most callers query the same geometry repeatedly, so check the last one first
+    static thread_local const LatticeGeometry *last = nullptr;
+    if (last) {
+      bool match = true;
+      for (int d = 0; d < 4; d++) match = match && last->Dims()[d] == X[d] && last->Halo()[d] == (R ? R[d] : 0);
+      if (match) return *last;
+    }
+
+    std::array<int, 8> key = {X[0], X[1], X[2], X[3], R ? R[0] : 0, R ? R[1] : 0, R ? R[2] : 0, R ? R[3] : 0};
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(key);
+    if (it == cache.end()) it = cache.emplace(key, std::unique_ptr<LatticeGeometry>(new LatticeGeometry(X, R))).first;
+    last = it->second.get();
+    return *last;
+  }
+
+} // namespace quda
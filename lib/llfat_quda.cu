@@ -9,6 +9,8 @@
 #include <gauge_field_order.h>
 #include <fast_intdiv.h>
 #include <tune_quda.h>
+#include <host_parallel.h>
+#include <su3_batch.h>
 
 #define MIN_COEFF 1e-7
 
@@ -16,6 +18,25 @@ namespace quda {
 
 #ifdef GPU_FATLINK
 
+  /**
+     On the host every field of a fattening step has the order and
+     precision of the input links, with no reconstruction
+  */
+#define hostFatLinkDispatch(func, u, ...)                                                                              \
+  {                                                                                                                    \
+    if (u.Precision() == QUDA_DOUBLE_PRECISION) {                                                                      \
+      if (u.Order() == QUDA_QDP_GAUGE_ORDER) func<double, QUDA_QDP_GAUGE_ORDER>(__VA_ARGS__);                         \
+      else if (u.Order() == QUDA_MILC_GAUGE_ORDER) func<double, QUDA_MILC_GAUGE_ORDER>(__VA_ARGS__);                  \
+      else errorQuda("Gauge field order %d not supported on the host", u.Order());                                     \
+    } else if (u.Precision() == QUDA_SINGLE_PRECISION) {                                                               \
+      if (u.Order() == QUDA_QDP_GAUGE_ORDER) func<float, QUDA_QDP_GAUGE_ORDER>(__VA_ARGS__);                          \
+      else if (u.Order() == QUDA_MILC_GAUGE_ORDER) func<float, QUDA_MILC_GAUGE_ORDER>(__VA_ARGS__);                   \
+      else errorQuda("Gauge field order %d not supported on the host", u.Order());                                     \
+    } else {                                                                                                           \
+      errorQuda("Unsupported precision %d\n", u.Precision());                                                          \
+    }                                                                                                                  \
+  }
+
   template <typename Float, typename Link, typename Gauge>
   struct LinkArg {
     unsigned int threads;
@@ -46,11 +67,10 @@ namespace quda {
   };
 
   template <typename Float, int dir, typename Arg>
-  __device__ void longLinkDir(Arg &arg, int idx, int parity) {
-    int x[4];
+  __device__ __host__ inline void longLinkDir(Arg &arg, int idx, int parity) {
+    int x[4], y[4];
     int dx[4] = {0, 0, 0, 0};
 
-    int *y = arg.u.coords;
     getCoords(x, idx, arg.X, parity);
     for (int d=0; d<4; d++) x[d] += arg.border[d];
 
@@ -68,6 +88,51 @@ namespace quda {
     arg.link(dir, idx, parity) = arg.coeff * a * b * c;
   }
 
+  template <typename Float, typename Arg>
+  __device__ __host__ inline void longLinkSite(Arg &arg, int idx, int parity, int dir) {
+    switch(dir) {
+    case 0: longLinkDir<Float, 0>(arg, idx, parity); break;
+    case 1: longLinkDir<Float, 1>(arg, idx, parity); break;
+    case 2: longLinkDir<Float, 2>(arg, idx, parity); break;
+    case 3: longLinkDir<Float, 3>(arg, idx, parity); break;
+    }
+  }
+
+  /**
+     @brief The long links of su3BatchWidth consecutive sites on the
+     host, with the products taken across the sites of an SU3Batch
+  */
+  template <typename Float, typename Arg> inline void longLinkBatch(Arg &arg, int idx0, int parity)
+  {
+    constexpr int W = su3BatchWidth<Float>();
+    const int n = std::min(W, (int)arg.threads - idx0);
+    SU3Batch<Float> a, b, c, lng;
+
+    int x[W][4];
+    for (int l = 0; l < W; l++) {
+      // the lanes past the end of the last batch repeat its first site
+      getCoords(x[l], idx0 + (l < n ? l : 0), arg.X, parity);
+      for (int d = 0; d < 4; d++) x[l][d] += arg.border[d];
+    }
+
+    for (int dir = 0; dir < 4; dir++) {
+      for (int l = 0; l < W; l++) {
+        int y[4], dx[4] = {0, 0, 0, 0};
+        a.set(l, arg.u(dir, linkIndex(y, x[l], arg.E), parity));
+        dx[dir]++;
+        b.set(l, arg.u(dir, linkIndexShift(y, x[l], dx, arg.E), 1 - parity));
+        dx[dir]++;
+        c.set(l, arg.u(dir, linkIndexShift(y, x[l], dx, arg.E), parity));
+      }
+
+      mul<false, false>(a, a, b);
+      lng.zero();
+      mulAdd<false, false>(lng, a, c, arg.coeff);
+
+      for (int l = 0; l < n; l++) arg.link(dir, idx0 + l, parity) = lng.get(l);
+    }
+  }
+
   template <typename Float, typename Arg>
   __global__ void computeLongLink(Arg arg) {
 
@@ -77,13 +142,7 @@ namespace quda {
     if (idx >= arg.threads) return;
     if (dir >= 4) return;
 
-    switch(dir) {
-    case 0: longLinkDir<Float, 0>(arg, idx, parity); break;
-    case 1: longLinkDir<Float, 1>(arg, idx, parity); break;
-    case 2: longLinkDir<Float, 2>(arg, idx, parity); break;
-    case 3: longLinkDir<Float, 3>(arg, idx, parity); break;
-    }
-    return;
+    longLinkSite<Float>(arg, idx, parity, dir);
   }
 
   template <typename Float, typename Arg>
@@ -99,12 +158,21 @@ namespace quda {
 
     void apply(const cudaStream_t &stream) {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      computeLongLink<Float><<<tp.grid,tp.block,tp.shared_bytes>>>(arg);
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        computeLongLink<Float><<<tp.grid,tp.block,tp.shared_bytes>>>(arg);
+      } else {
+        constexpr int W = su3BatchWidth<Float>();
+        parallel_for(tp, 2, (arg.threads + W - 1) / W,
+                     [&](int parity, int batch) { longLinkBatch<Float>(arg, batch * W, parity); });
+      }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec="  << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -112,8 +180,24 @@ namespace quda {
     long long bytes() const { return 2*4*arg.threads*(3*arg.u.Bytes()+arg.link.Bytes()); }
   };
 
+  template <typename Float, QudaGaugeFieldOrder order>
+  void hostLongLink(GaugeField &lng, const GaugeField &u, double coeff)
+  {
+    typedef typename gauge_order_mapper<Float, order, 3>::type L;
+    typedef LinkArg<Float,L,L> Arg;
+    L lng_(lng), u_(u);
+    Arg arg(lng_, u_, coeff, lng, u);
+    LongLink<Float,Arg> longLink(arg,lng);
+    longLink.apply(0);
+  }
+
   void computeLongLink(GaugeField &lng, const GaugeField &u, double coeff)
   {
+    if (u.Location() == QUDA_CPU_FIELD_LOCATION) {
+      hostFatLinkDispatch(hostLongLink, u, lng, u, coeff);
+      return;
+    }
+
     if (u.Precision() == QUDA_DOUBLE_PRECISION) {
       typedef typename gauge_mapper<double,QUDA_RECONSTRUCT_NO>::type L;
       if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
@@ -161,15 +245,8 @@ namespace quda {
   }
 
   template <typename Float, typename Arg>
-  __global__ void computeOneLink(Arg arg)  {
-
-    int idx = blockIdx.x*blockDim.x + threadIdx.x;
-    int parity = blockIdx.y * blockDim.y + threadIdx.y;
-    int dir =  blockIdx.z * blockDim.z + threadIdx.z;
-    if (idx >= arg.threads) return;
-    if (dir >= 4) return;
-
-    int *x = arg.u.coords;
+  __device__ __host__ inline void oneLinkSite(Arg &arg, int idx, int parity, int dir) {
+    int x[4];
     getCoords(x, idx, arg.X, parity);
     for (int d=0; d<4; d++) x[d] += arg.border[d];
 
@@ -178,8 +255,18 @@ namespace quda {
     Link a = arg.u(dir, linkIndex(x,x,arg.E), parity);
 
     arg.link(dir, idx, parity) = arg.coeff*a;
+  }
 
-    return;
+  template <typename Float, typename Arg>
+  __global__ void computeOneLink(Arg arg)  {
+
+    int idx = blockIdx.x*blockDim.x + threadIdx.x;
+    int parity = blockIdx.y * blockDim.y + threadIdx.y;
+    int dir =  blockIdx.z * blockDim.z + threadIdx.z;
+    if (idx >= arg.threads) return;
+    if (dir >= 4) return;
+
+    oneLinkSite<Float>(arg, idx, parity, dir);
   }
 
   template <typename Float, typename Arg>
@@ -195,12 +282,21 @@ namespace quda {
 
     void apply(const cudaStream_t &stream) {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      computeOneLink<Float><<<tp.grid,tp.block>>>(arg);
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        computeOneLink<Float><<<tp.grid,tp.block>>>(arg);
+      } else {
+        parallel_for(tp, 2, arg.threads, [&](int parity, int idx) {
+          for (int dir = 0; dir < 4; dir++) oneLinkSite<Float>(arg, idx, parity, dir);
+        });
+      }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec="  << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -208,8 +304,24 @@ namespace quda {
     long long bytes() const { return 2*4*arg.threads*(arg.u.Bytes()+arg.link.Bytes()); }
   };
 
+  template <typename Float, QudaGaugeFieldOrder order>
+  void hostOneLink(GaugeField &fat, const GaugeField &u, double coeff)
+  {
+    typedef typename gauge_order_mapper<Float, order, 3>::type L;
+    typedef LinkArg<Float,L,L> Arg;
+    L fat_(fat), u_(u);
+    Arg arg(fat_, u_, coeff, fat, u);
+    OneLink<Float,Arg> oneLink(arg,fat);
+    oneLink.apply(0);
+  }
+
   void computeOneLink(GaugeField &fat, const GaugeField &u, double coeff)
   {
+    if (u.Location() == QUDA_CPU_FIELD_LOCATION) {
+      hostFatLinkDispatch(hostOneLink, u, fat, u, coeff);
+      return;
+    }
+
     if (u.Precision() == QUDA_DOUBLE_PRECISION) {
       typedef typename gauge_mapper<double,QUDA_RECONSTRUCT_NO>::type L;
       if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
@@ -293,9 +405,9 @@ namespace quda {
   };
 
   template<typename Float, int mu, int nu, typename Arg>
-  __device__ inline void computeStaple(Matrix<complex<Float>,3> &staple, Arg &arg, int x[], int parity) {
+  __device__ __host__ inline void computeStaple(Matrix<complex<Float>,3> &staple, Arg &arg, int x[], int parity) {
     typedef Matrix<complex<Float>,3> Link;
-    int *y = arg.u.coords, *y_mu = arg.mulink.coords, dx[4] = {0, 0, 0, 0};
+    int y[4], y_mu[4], dx[4] = {0, 0, 0, 0};
 
     /* Computes the upper staple :
      *                 mu (B)
@@ -346,16 +458,41 @@ namespace quda {
     }
   }
 
-  template<typename Float, bool save_staple, typename Arg>
-  __global__ void computeStaple(Arg arg, int nu)
+  /**
+     @brief Accumulate the staple of the link in direction mu at
+     extended coordinates x into the fat link in the interior, and
+     optionally save it for the next level of staples
+  */
+  template <typename Float, bool save_staple, typename Arg>
+  __device__ __host__ inline void stapleStore(Arg &arg, int x[], int parity, int mu,
+                                              const Matrix<complex<Float>, 3> &staple)
   {
-    int idx = blockIdx.x*blockDim.x + threadIdx.x;
-    int parity = blockIdx.y*blockDim.y + threadIdx.y;
-    if (idx >= arg.threads) return;
+    typedef Matrix<complex<Float>,3> Link;
 
-    int mu_idx = blockIdx.z*blockDim.z + threadIdx.z;
-    if (mu_idx >= arg.n_mu) return;
-    int mu;
+    // exclude inner halo
+    if ( !(x[0] < arg.inner_border[0] || x[0] >= arg.inner_X[0] + arg.inner_border[0] ||
+	   x[1] < arg.inner_border[1] || x[1] >= arg.inner_X[1] + arg.inner_border[1] ||
+	   x[2] < arg.inner_border[2] || x[2] >= arg.inner_X[2] + arg.inner_border[2] ||
+	   x[3] < arg.inner_border[3] || x[3] >= arg.inner_X[3] + arg.inner_border[3]) ) {
+      // convert to inner coords
+      int inner_x[] = {x[0]-arg.inner_border[0], x[1]-arg.inner_border[1], x[2]-arg.inner_border[2], x[3]-arg.inner_border[3]};
+      Link fat = arg.fat(mu, linkIndex(inner_x, arg.inner_X), parity);
+      fat += arg.coeff * staple;
+      arg.fat(mu, linkIndex(inner_x, arg.inner_X), parity) = fat;
+    }
+
+    if (save_staple) arg.staple(mu, linkIndex(x, arg.E), parity) = staple;
+  }
+
+  /**
+     @brief The staple in the nu direction of the link in the mu_idx-th
+     remaining direction at a site, accumulated into the fat link in the
+     interior and optionally saved for the next level of staples
+  */
+  template<typename Float, bool save_staple, typename Arg>
+  __device__ __host__ inline void stapleSite(Arg &arg, int idx, int parity, int mu_idx, int nu)
+  {
+    int mu = 0;
     switch(mu_idx) {
     case 0: mu = arg.mu_map[0]; break;
     case 1: mu = arg.mu_map[1]; break;
@@ -395,20 +532,67 @@ namespace quda {
       } break;
     }
 
-    // exclude inner halo
-    if ( !(x[0] < arg.inner_border[0] || x[0] >= arg.inner_X[0] + arg.inner_border[0] ||
-	   x[1] < arg.inner_border[1] || x[1] >= arg.inner_X[1] + arg.inner_border[1] ||
-	   x[2] < arg.inner_border[2] || x[2] >= arg.inner_X[2] + arg.inner_border[2] ||
-	   x[3] < arg.inner_border[3] || x[3] >= arg.inner_X[3] + arg.inner_border[3]) ) {
-      // convert to inner coords
-      int inner_x[] = {x[0]-arg.inner_border[0], x[1]-arg.inner_border[1], x[2]-arg.inner_border[2], x[3]-arg.inner_border[3]};
-      Link fat = arg.fat(mu, linkIndex(inner_x, arg.inner_X), parity);
-      fat += arg.coeff * staple;
-      arg.fat(mu, linkIndex(inner_x, arg.inner_X), parity) = fat;
+    stapleStore<Float, save_staple>(arg, x, parity, mu, staple);
+  }
+
+  /**
+     @brief The host staples of su3BatchWidth consecutive sites, with
+     the products taken across the sites of an SU3Batch
+  */
+  template <typename Float, bool save_staple, typename Arg>
+  inline void stapleBatch(Arg &arg, int idx0, int parity, int mu_idx, int nu)
+  {
+    constexpr int W = su3BatchWidth<Float>();
+    const int mu = arg.mu_map[mu_idx];
+    const int n = std::min(W, (int)arg.threads - idx0);
+    SU3Batch<Float> a, b, c, staple;
+
+    int x[W][4];
+    for (int l = 0; l < W; l++) {
+      // the lanes past the end of the last batch repeat its first site
+      getCoords(x[l], idx0 + (l < n ? l : 0), arg.X, (parity + arg.odd_bit) % 2);
+      for (int d = 0; d < 4; d++) x[l][d] += arg.border[d];
     }
 
-    if (save_staple) arg.staple(mu, linkIndex(x, arg.E), parity) = staple;
-    return;
+    // upper staple A B C^dagger
+    for (int l = 0; l < W; l++) {
+      int y[4], dx[4] = {0, 0, 0, 0};
+      a.set(l, arg.u(nu, linkIndex(y, x[l], arg.E), parity));
+      dx[nu]++;
+      b.set(l, arg.mulink(mu, linkIndexShift(y, x[l], dx, arg.E), 1 - parity));
+      dx[nu]--;
+      dx[mu]++;
+      c.set(l, arg.u(nu, linkIndexShift(y, x[l], dx, arg.E), 1 - parity));
+    }
+    mul<false, false>(staple, a, b);
+    mul<false, true>(staple, staple, c);
+
+    // lower staple A^dagger B C
+    for (int l = 0; l < W; l++) {
+      int y[4], dx[4] = {0, 0, 0, 0};
+      dx[nu]--;
+      a.set(l, arg.u(nu, linkIndexShift(y, x[l], dx, arg.E), 1 - parity));
+      b.set(l, arg.mulink(mu, linkIndexShift(y, x[l], dx, arg.E), 1 - parity));
+      dx[mu]++;
+      c.set(l, arg.u(nu, linkIndexShift(y, x[l], dx, arg.E), parity));
+    }
+    mul<true, false>(a, a, b);
+    mulAdd<false, false>(staple, a, c, static_cast<Float>(1.0));
+
+    for (int l = 0; l < n; l++) stapleStore<Float, save_staple>(arg, x[l], parity, mu, staple.get(l));
+  }
+
+  template<typename Float, bool save_staple, typename Arg>
+  __global__ void computeStaple(Arg arg, int nu)
+  {
+    int idx = blockIdx.x*blockDim.x + threadIdx.x;
+    int parity = blockIdx.y*blockDim.y + threadIdx.y;
+    if (idx >= arg.threads) return;
+
+    int mu_idx = blockIdx.z*blockDim.z + threadIdx.z;
+    if (mu_idx >= arg.n_mu) return;
+
+    stapleSite<Float, save_staple>(arg, idx, parity, mu_idx, nu);
   }
 
   template <typename Float, typename Arg>
@@ -443,16 +627,33 @@ namespace quda {
 
     void apply(const cudaStream_t &stream) {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      if (save_staple)
-	computeStaple<Float,true><<<tp.grid,tp.block>>>(arg, nu);
-      else
-	computeStaple<Float,false><<<tp.grid,tp.block>>>(arg, nu);
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        if (save_staple)
+          computeStaple<Float,true><<<tp.grid,tp.block>>>(arg, nu);
+        else
+          computeStaple<Float,false><<<tp.grid,tp.block>>>(arg, nu);
+      } else {
+        // all the directions mu of a batch of sites in one pass, so
+        // the links they share are read while still in cache
+        constexpr int W = su3BatchWidth<Float>();
+        parallel_for(tp, 2, (arg.threads + W - 1) / W, [&](int parity, int batch) {
+          for (int mu_idx = 0; mu_idx < arg.n_mu; mu_idx++) {
+            if (save_staple)
+              stapleBatch<Float, true>(arg, batch * W, parity, mu_idx, nu);
+            else
+              stapleBatch<Float, false>(arg, batch * W, parity, mu_idx, nu);
+          }
+        });
+      }
     }
 
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec="  << sizeof(Float);
       aux << ",nu=" << nu << ",dir1=" << dir1 << ",dir2=" << dir2 << ",save=" << save_staple;
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }
 
@@ -468,10 +669,26 @@ namespace quda {
     }
   };
 
+  template <typename Float, QudaGaugeFieldOrder order>
+  void hostStaple(GaugeField &fat, GaugeField &staple, const GaugeField &mulink, const GaugeField &u,
+		     int nu, int dir1, int dir2, double coeff, bool save_staple) {
+    typedef typename gauge_order_mapper<Float, order, 3>::type L;
+    typedef StapleArg<Float,L,L,L,L> Arg;
+    L fat_(fat), staple_(staple), mulink_(mulink), u_(u);
+    Arg arg(fat_, staple_, mulink_, u_, coeff, fat, u);
+    Staple<Float,Arg> stapler(arg, nu, dir1, dir2, save_staple, fat);
+    stapler.apply(0);
+  }
+
   // Compute the staple field for direction nu,excluding the directions dir1 and dir2.
   void computeStaple(GaugeField &fat, GaugeField &staple, const GaugeField &mulink, const GaugeField &u,
 		     int nu, int dir1, int dir2, double coeff, bool save_staple) {
 
+    if (u.Location() == QUDA_CPU_FIELD_LOCATION) {
+      hostFatLinkDispatch(hostStaple, u, fat, staple, mulink, u, nu, dir1, dir2, coeff, save_staple);
+      return;
+    }
+
     if (u.Precision() == QUDA_DOUBLE_PRECISION) {
       typedef typename gauge_mapper<double,QUDA_RECONSTRUCT_NO>::type L;
       if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
@@ -529,16 +746,24 @@ namespace quda {
 
 #endif //GPU_FATLINK
 
-  void fatLongKSLink(cudaGaugeField* fat, cudaGaugeField* lng,  const cudaGaugeField& u, const double *coeff)
+  void fatLongKSLink(GaugeField *fat, GaugeField *lng, const GaugeField &u, const double *coeff)
   {
 
 #ifdef GPU_FATLINK
+    if (fat->Location() != u.Location() || (lng && lng->Location() != u.Location()))
+      errorQuda("Fat, long and input links must have the same location");
+
+    if (u.Location() == QUDA_CPU_FIELD_LOCATION) {
+      if (u.Reconstruct() != QUDA_RECONSTRUCT_NO || fat->Order() != u.Order() || fat->Precision() != u.Precision()
+          || (lng && (lng->Order() != u.Order() || lng->Precision() != u.Precision())))
+        errorQuda("Host links must share the order and precision of the input links, without reconstruction");
+      if (u.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER) errorQuda("Site order %d not supported", u.SiteOrder());
+    }
+
     GaugeFieldParam gParam(u);
     gParam.reconstruct = QUDA_RECONSTRUCT_NO;
     gParam.setPrecision(gParam.Precision());
     gParam.create = QUDA_NULL_FIELD_CREATE;
-    cudaGaugeField staple(gParam);
-    cudaGaugeField staple1(gParam);
 
     if( ((fat->X()[0] % 2 != 0) || (fat->X()[1] % 2 != 0) || (fat->X()[2] % 2 != 0) || (fat->X()[3] % 2 != 0))
 	&& (u.Reconstruct()  != QUDA_RECONSTRUCT_NO)){
@@ -551,33 +776,41 @@ namespace quda {
     // if this pointer is not NULL, compute the long link
     if (lng) computeLongLink(*lng, u, coeff[1]);
 
-    // Check the coefficients. If all of the following are zero, return.
-    if (fabs(coeff[2]) < MIN_COEFF && fabs(coeff[3]) < MIN_COEFF &&
-	fabs(coeff[4]) < MIN_COEFF && fabs(coeff[5]) < MIN_COEFF) return;
+    // Check the coefficients. If all of the following are zero, skip the staples.
+    if (fabs(coeff[2]) >= MIN_COEFF || fabs(coeff[3]) >= MIN_COEFF ||
+	fabs(coeff[4]) >= MIN_COEFF || fabs(coeff[5]) >= MIN_COEFF) {
+      GaugeField *staple = GaugeField::Create(gParam);
+      GaugeField *staple1 = GaugeField::Create(gParam);
 
-    for (int nu = 0; nu < 4; nu++) {
-      computeStaple(*fat, staple, u, u, nu, -1, -1, coeff[2], 1);
+      for (int nu = 0; nu < 4; nu++) {
+        computeStaple(*fat, *staple, u, u, nu, -1, -1, coeff[2], 1);
 
-      if (coeff[5] != 0.0) computeStaple(*fat, staple, staple, u, nu, -1, -1, coeff[5], 0);
+        if (coeff[5] != 0.0) computeStaple(*fat, *staple, *staple, u, nu, -1, -1, coeff[5], 0);
 
-      for (int rho = 0; rho < 4; rho++) {
-        if (rho != nu) {
+        for (int rho = 0; rho < 4; rho++) {
+          if (rho != nu) {
 
-          computeStaple(*fat, staple1, staple, u, rho, nu, -1, coeff[3], 1);
+            computeStaple(*fat, *staple1, *staple, u, rho, nu, -1, coeff[3], 1);
 
-	  if (fabs(coeff[4]) > MIN_COEFF) {
-	    for (int sig = 0; sig < 4; sig++) {
-              if (sig != nu && sig != rho) {
-                computeStaple(*fat, staple, staple1, u, sig, nu, rho, coeff[4], 0);
-              }
-	    } //sig
-	  } // MIN_COEFF
-	}
-      } //rho
-    } //nu
+	    if (fabs(coeff[4]) > MIN_COEFF) {
+	      for (int sig = 0; sig < 4; sig++) {
+                if (sig != nu && sig != rho) {
+                  computeStaple(*fat, *staple, *staple1, u, sig, nu, rho, coeff[4], 0);
+                }
+	      } //sig
+	    } // MIN_COEFF
+	  }
+        } //rho
+      } //nu
+
+      delete staple1;
+      delete staple;
+    }
 
-    qudaDeviceSynchronize();
-    checkCudaError();
+    if (u.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      qudaDeviceSynchronize();
+      checkCudaError();
+    }
 #else
     errorQuda("Fat-link computation not enabled");
 #endif
@@ -586,5 +819,6 @@ namespace quda {
   }
 
 #undef MIN_COEFF
+#undef hostFatLinkDispatch
 
 } // namespace quda
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <cstring> // needed for memset
 #include <typeinfo>
+#include <vector>
+#include <algorithm>
 
 #include <tune_quda.h>
 #include <blas_quda.h>
@@ -24,6 +26,8 @@ namespace quda {
       static constexpr int W = writeW;
     };
 
+#include <generic_multi_blas.cuh>
+
     template <int NXZ, typename FloatN, int M, typename SpinorX, typename SpinorY, typename SpinorZ, typename SpinorW,
         typename Functor, typename T>
     class MultiBlas : public TunableVectorY
@@ -402,7 +406,7 @@ namespace quda {
           errorQuda("Precision combination x=%d not supported\n", x[0]->Precision());
         }
       } else { // fields on the cpu
-        errorQuda("Not implemented");
+        genericMultiBlas<NXZ, Functor, write>(a, b, c, x, y, z, w);
       }
     }
 
@@ -565,7 +569,7 @@ namespace quda {
           errorQuda("Precision combination x=%d y=%d not supported\n", x[0]->Precision(), y[0]->Precision());
         }
       } else { // fields on the cpu
-        errorQuda("Not implemented");
+        genericMultiBlas<NXZ, Functor, write>(a, b, c, x, y, z, w);
       }
     }
 
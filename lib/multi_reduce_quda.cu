@@ -1,3 +1,6 @@
+#include <vector>
+#include <algorithm>
+
 #include <blas_quda.h>
 #include <tune_quda.h>
 #include <float_vector.h>
@@ -24,6 +27,10 @@ namespace quda {
       static constexpr int W = writeW;
     };
 
+#include <generic_reduce.cuh>
+#include <generic_multi_blas.cuh>
+#include <generic_multi_reduce.cuh>
+
     template <typename doubleN, typename ReduceType, typename FloatN, int M, int NXZ, typename Arg>
     void multiReduceLaunch(doubleN result[], Arg &arg, const TuneParam &tp, const cudaStream_t &stream, Tunable &tunable)
     {
@@ -587,6 +594,15 @@ namespace quda {
         CompositeColorSpinorField &w, int i, int j)
     {
 
+      if (checkLocation(*x[0], *y[0], *z[0], *w[0]) == QUDA_CPU_FIELD_LOCATION) {
+        if (i == j) { // we are on the diagonal so invoke the diagonal reducer
+          genericMultiReduce<NXZ, doubleN, ReducerDiagonal, writeDiagonal>(result, a, b, c, x, y, z, w);
+        } else { // we are off the diagonal so invoke the off-diagonal reducer
+          genericMultiReduce<NXZ, doubleN, ReducerOffDiagonal, writeOffDiagonal>(result, a, b, c, x, y, z, w);
+        }
+        return;
+      }
+
       if (x[0]->Precision() == y[0]->Precision()) {
         if (i == j) { // we are on the diagonal so invoke the diagonal reducer
           uniMultiReduce<NXZ, doubleN, ReduceType, ReducerDiagonal, writeDiagonal, siteUnroll, T>(result, a, b, c, x, y,
@@ -911,6 +927,7 @@ namespace quda {
       	strcat(aux, y[0]->AuxString());
         if (hermitian) strcat(aux, ",hermitian");
         if (Anorm) strcat(aux, ",Anorm");
+        if (x[0]->Location() == QUDA_CPU_FIELD_LOCATION) strcat(aux, ",cpu");
 	strcat(aux,",n=");
 	char size[8];
 	u64toa(size, x.size());
@@ -1082,6 +1099,7 @@ namespace quda {
         strcat(aux, y[0]->AuxString());
         if (hermitian) strcat(aux, ",hermitian");
         if (Anorm) strcat(aux, ",Anorm");
+        if (x[0]->Location() == QUDA_CPU_FIELD_LOCATION) strcat(aux, ",cpu");
         strcat(aux, ",n=");
         char size[8];
         u64toa(size, x.size());
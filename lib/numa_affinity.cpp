@@ -11,6 +11,18 @@
 #include <nvml.h>
 #endif
 
+#ifdef __linux__
+#include <sched.h>
+#include <dirent.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 int setNumaAffinityNVML(int devid)
 {
@@ -51,3 +63,69 @@ int setNumaAffinityNVML(int devid)
   return -1;
 #endif
 }
+
+#ifdef __linux__
+/**
+ * Return the NUMA node of a given cpu by looking for the nodeN entry
+ * in its sysfs directory, or 0 if this cannot be determined.
+ */
+static int cpuNumaNode(int cpu)
+{
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+  DIR *dir = opendir(path);
+  if (!dir) return 0;
+
+  int node = 0;
+  while (struct dirent *entry = readdir(dir)) {
+    if (strncmp(entry->d_name, "node", 4) == 0 && sscanf(entry->d_name + 4, "%d", &node) == 1) break;
+  }
+  closedir(dir);
+  return node;
+}
+#endif
+
+int setHostThreadAffinity()
+{
+#if defined(__linux__) && defined(_OPENMP)
+  cpu_set_t process_set;
+  if (sched_getaffinity(0, sizeof(process_set), &process_set) != 0) {
+    warningQuda("Failed to set host thread affinity (sched_getaffinity failed)");
+    return -1;
+  }
+
+  // order the cpus we may run on by NUMA node, so that a team of n
+  // threads is packed onto as few nodes as possible starting from
+  // the node of the master thread
+  std::vector<std::pair<int, int>> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    if (CPU_ISSET(cpu, &process_set)) cpus.push_back(std::make_pair(cpuNumaNode(cpu), cpu));
+  if (cpus.empty()) return -1;
+
+  const int master_node = cpuNumaNode(sched_getcpu());
+  std::stable_sort(cpus.begin(), cpus.end(), [master_node](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+    if ((a.first == master_node) != (b.first == master_node)) return a.first == master_node;
+    return a < b;
+  });
+
+  int failed = 0;
+#pragma omp parallel reduction(+ : failed)
+  {
+    cpu_set_t thread_set;
+    CPU_ZERO(&thread_set);
+    CPU_SET(cpus[omp_get_thread_num() % cpus.size()].second, &thread_set);
+    failed += sched_setaffinity(0, sizeof(thread_set), &thread_set) != 0 ? 1 : 0;
+  }
+
+  if (failed) {
+    warningQuda("Failed to set host thread affinity for %d threads (sched_setaffinity failed)", failed);
+    return -1;
+  }
+  if (getVerbosity() >= QUDA_VERBOSE)
+    printfQuda("Pinned %d host threads to %lu cpus\n", omp_get_max_threads(), cpus.size());
+  return 0;
+#else
+  warningQuda("Failed to set host thread affinity (not supported in quda build)");
+  return -1;
+#endif
+}
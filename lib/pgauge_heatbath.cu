@@ -11,6 +11,14 @@
 #include <index_helper.cuh>
 #include <atomic.cuh>
 #include <cub_helper.cuh>
+#include <random_philox.h>
+#include <host_parallel.h>
+#include <timer.h>
+#include <tuple>
+
+#ifdef MPI_COMMS
+#include <mpi.h>
+#endif
 
 
 
@@ -89,12 +97,15 @@ namespace quda {
     @brief Generate full SU(2) matrix (four real numbers instead of 2x2 complex matrix) and update link matrix.
     Get from MILC code.
     @param al weight
-    @param localstate CURAND rng state
+    @param localstate rng state (CURAND on the device, Philox on the host)
+    @param trials incremented by the number of candidates drawn
+    @param failures incremented if no candidate was accepted
  */
-  template <class T>
-  __device__ static inline Matrix<T,2> generate_su2_matrix_milc(T al, cuRNGState& localState){
+  template <class T, class State>
+  __host__ __device__ static inline Matrix<T,2> generate_su2_matrix_milc(T al, State& localState, int &trials, int &failures){
     T xr1, xr2, xr3, xr4, d, r;
     int k;
+    trials++;
     xr1 = Random<T>(localState);
     xr1 = (log((xr1 + 1.e-10)));
     xr2 = Random<T>(localState);
@@ -108,6 +119,7 @@ namespace quda {
     if ((1.00 - 0.5 * d) > xr4 * xr4 ) nacd = 1;
     if ( nacd == 0 && al > 2.0 ) { //k-p algorithm
       for ( k = 0; k < 20; k++ ) {
+        trials++;
         //get four random numbers (add a small increment to prevent taking log(0.)
         xr1 = Random<T>(localState);
         xr1 = (log((xr1 + 1.e-10)));
@@ -119,12 +131,14 @@ namespace quda {
         d = -(xr2 + xr1 * xr3 * xr3) / al;
         if ((1.00 - 0.5 * d) > xr4 * xr4 ) break;
       }
+      if ( k == 20 ) failures++;
     } //endif nacd
     Matrix<T,2> a;
     if ( nacd == 0 && al <= 2.0 ) { //creutz algorithm
       xr3 = exp(-2.0 * al);
       xr4 = 1.0 - xr3;
       for ( k = 0; k < 20; k++ ) {
+        trials++;
         //get two random numbers
         xr1 = Random<T>(localState);
         xr2 = Random<T>(localState);
@@ -132,6 +146,7 @@ namespace quda {
         a(0,0) = 1.00 + log(r) / al;
         if ((1.0 - a(0,0) * a(0,0)) > xr2 * xr2 ) break;
       }
+      if ( k == 20 ) failures++;
       d = 1.0 - a(0,0);
     } //endif nacd
       //generate the four su(2) elements
@@ -300,11 +315,13 @@ namespace quda {
     @brief Link update by pseudo-heatbath
     @param U link to be updated
     @param F staple
-    @param localstate CURAND rng state
+    @param localstate rng state (CURAND on the device, Philox on the host)
+    @param trials incremented by the number of SU(2) candidates drawn
+    @param failures incremented by the number of SU(2) updates with no candidate accepted
  */
-  template <class Float, int NCOLORS>
-  __device__ inline void heatBathSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F,
-                                      cuRNGState& localState, Float BetaOverNc ){
+  template <class Float, int NCOLORS, class State>
+  __host__ __device__ inline void heatBathSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F,
+                                               State& localState, Float BetaOverNc, int &trials, int &failures ){
 
     if ( NCOLORS == 3 ) {
       //////////////////////////////////////////////////////////////////
@@ -348,7 +365,7 @@ namespace quda {
         Float ap = BetaOverNc * k;
         k = 1.0 / k;
         r *= k;
-        Matrix<Float,2> a = generate_su2_matrix_milc<Float>(ap, localState);
+        Matrix<Float,2> a = generate_su2_matrix_milc<Float>(ap, localState, trials, failures);
         r = mulsu2UVDagger<Float>( a, r);
         ///////////////////////////////////////
         a0 = complex<Float>( r(0,0), r(1,1) );
@@ -377,7 +394,7 @@ namespace quda {
         Float ap = BetaOverNc * k;
         k = 1.0 / k;
         r *= k;
-        Matrix<Float,2> a = generate_su2_matrix_milc<Float>(ap, localState);
+        Matrix<Float,2> a = generate_su2_matrix_milc<Float>(ap, localState, trials, failures);
         Matrix<Float,2> rr = mulsu2UVDagger<Float>( a, r);
         ///////////////////////////////////////
         mul_block_sun<Float, NCOLORS>( rr, U, id);
@@ -436,7 +453,7 @@ namespace quda {
      @param F staple
    */
   template <class Float, int NCOLORS>
-  __device__ inline void overrelaxationSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F ){
+  __host__ __device__ inline void overrelaxationSUN( Matrix<complex<Float>,NCOLORS>& U, Matrix<complex<Float>,NCOLORS> F ){
 
     if ( NCOLORS == 3 ) {
       //////////////////////////////////////////////////////////////////
@@ -584,8 +601,9 @@ namespace quda {
     cudaGaugeField &data;
     Float BetaOverNc;
     RNG rngstate;
+    unsigned long long *stats; // SU(2) candidates and failures, accumulated if set
     MonteArg(const Gauge &dataOr, cudaGaugeField & data, Float Beta, RNG &rngstate)
-      : dataOr(dataOr), data(data), rngstate(rngstate) {
+      : dataOr(dataOr), data(data), rngstate(rngstate), stats(nullptr) {
       BetaOverNc = Beta / (Float)NCOLORS;
 #ifdef MULTI_GPU
       for ( int dir = 0; dir < 4; ++dir ) {
@@ -600,6 +618,48 @@ namespace quda {
   };
 
 
+/**
+    @brief Sum of the staples of the link U_mu(x)
+    @param dataOr gauge field accessor
+    @param x coordinates of the site on the lattice held by dataOr
+    @param X dimensions of the lattice held by dataOr
+    @param idx checkerboard index of x
+    @param mu direction of the link
+    @param parity parity of x
+ */
+  template<typename Float, int NCOLORS, typename Gauge>
+  __host__ __device__ inline Matrix<complex<Float>,NCOLORS> computeStaple( const Gauge &dataOr, int x[4], const int X[4],
+                                                                          int idx, int mu, int parity ){
+    Matrix<complex<Float>,NCOLORS> staple;
+    setZero(&staple);
+
+    Matrix<complex<Float>,NCOLORS> U;
+    for ( int nu = 0; nu < 4; nu++ ) if ( mu != nu ) {
+        int dx[4] = { 0, 0, 0, 0 };
+        Matrix<complex<Float>,NCOLORS> link;
+        dataOr.load((Float*)(link.data), idx, nu, parity);
+        dx[nu]++;
+        dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), mu, 1 - parity);
+        link *= U;
+        dx[nu]--;
+        dx[mu]++;
+        dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), nu, 1 - parity);
+        link *= conj(U);
+        staple += link;
+        dx[mu]--;
+        dx[nu]--;
+        dataOr.load((Float*)(link.data), linkIndexShift(x,dx,X), nu, 1 - parity);
+        dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), mu, 1 - parity);
+        link = conj(link) * U;
+        dx[mu]++;
+        dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), nu, parity);
+        link *= U;
+        staple += link;
+      }
+    return staple;
+  }
+
+
   template<typename Float, typename Gauge, int NCOLORS, bool HeatbathOrRelax>
   __global__ void compute_heatBath(MonteArg<Gauge, Float, NCOLORS> arg, int mu, int parity){
     int idx = threadIdx.x + blockIdx.x * blockDim.x;
@@ -620,37 +680,19 @@ namespace quda {
     idx = linkIndex(x,X);
 #endif
 
-    Matrix<complex<Float>,NCOLORS> staple;
-    setZero(&staple);
+    Matrix<complex<Float>,NCOLORS> staple = computeStaple<Float, NCOLORS>(arg.dataOr, x, X, idx, mu, parity);
 
     Matrix<complex<Float>,NCOLORS> U;
-    for ( int nu = 0; nu < 4; nu++ ) if ( mu != nu ) {
-        int dx[4] = { 0, 0, 0, 0 };
-        Matrix<complex<Float>,NCOLORS> link;
-        arg.dataOr.load((Float*)(link.data), idx, nu, parity);
-        dx[nu]++;
-        arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), mu, 1 - parity);
-        link *= U;
-        dx[nu]--;
-        dx[mu]++;
-        arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), nu, 1 - parity);
-        link *= conj(U);
-        staple += link;
-        dx[mu]--;
-        dx[nu]--;
-        arg.dataOr.load((Float*)(link.data), linkIndexShift(x,dx,X), nu, 1 - parity);
-        arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), mu, 1 - parity);
-        link = conj(link) * U;
-        dx[mu]++;
-        arg.dataOr.load((Float*)(U.data), linkIndexShift(x,dx,X), nu, parity);
-        link *= U;
-        staple += link;
-      }
     arg.dataOr.load((Float*)(U.data), idx, mu, parity);
     if ( HeatbathOrRelax ) {
       cuRNGState localState = arg.rngstate.State()[ id ];
-      heatBathSUN<Float, NCOLORS>( U, conj(staple), localState, arg.BetaOverNc );
+      int trials = 0, failures = 0;
+      heatBathSUN<Float, NCOLORS>( U, conj(staple), localState, arg.BetaOverNc, trials, failures );
       arg.rngstate.State()[ id ] = localState;
+      if ( arg.stats ) {
+        atomicAdd(arg.stats, (unsigned long long)trials);
+        if ( failures ) atomicAdd(arg.stats + 1, (unsigned long long)failures);
+      }
     }
     else{
       overrelaxationSUN<Float, NCOLORS>( U, conj(staple) );
@@ -664,6 +706,7 @@ namespace quda {
     MonteArg<Gauge, Float, NCOLORS> arg;
     int mu;
     int parity;
+    unsigned long long *stats;
     mutable char aux_string[128];       // used as a label in the autotuner
     private:
     unsigned int sharedBytesPerThread() const {
@@ -682,7 +725,7 @@ namespace quda {
 
     public:
     GaugeHB(MonteArg<Gauge, Float, NCOLORS> &arg)
-      : arg(arg), mu(0), parity(0) {
+      : arg(arg), mu(0), parity(0), stats(arg.stats) {
     }
     ~GaugeHB () {
     }
@@ -708,10 +751,13 @@ namespace quda {
     void preTune() {
       arg.data.backup();
       if(HeatbathOrRelax) arg.rngstate.backup();
+      stats = arg.stats; // don't count the tuning launches
+      arg.stats = nullptr;
     }
     void postTune() {
       arg.data.restore();
       if(HeatbathOrRelax) arg.rngstate.restore();
+      arg.stats = stats;
     }
     long long flops() const {
 
@@ -765,11 +811,16 @@ namespace quda {
 
 
   template<typename Float, int NElems, int NCOLORS, typename Gauge>
-  void Monte( Gauge dataOr,  cudaGaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover) {
+  void Monte( Gauge dataOr,  cudaGaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover, MonteStats *stats) {
 
     TimeProfile profileHBOVR("HeatBath_OR_Relax", false);
     MonteArg<Gauge, Float, NCOLORS> montearg(dataOr, data, Beta, rngstate);
-    if ( getVerbosity() >= QUDA_SUMMARIZE ) profileHBOVR.TPSTART(QUDA_PROFILE_COMPUTE);
+    const bool timing = stats || getVerbosity() >= QUDA_SUMMARIZE;
+    if ( stats ) {
+      montearg.stats = (unsigned long long*)device_malloc(2 * sizeof(unsigned long long));
+      cudaMemset(montearg.stats, 0, 2 * sizeof(unsigned long long));
+    }
+    if ( timing ) profileHBOVR.TPSTART(QUDA_PROFILE_COMPUTE);
     GaugeHB<Float, Gauge, NCOLORS, NElems, true> hb(montearg);
     for ( int step = 0; step < nhb; ++step ) {
       for ( int parity = 0; parity < 2; ++parity ) {
@@ -782,20 +833,32 @@ namespace quda {
         }
       }
     }
-    if ( getVerbosity() >= QUDA_SUMMARIZE ) {
+    if ( timing ) {
       qudaDeviceSynchronize();
       profileHBOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
       double secs = profileHBOVR.Last(QUDA_PROFILE_COMPUTE);
       double gflops = (hb.flops() * 8 * nhb * 1e-9) / (secs);
       double gbytes = hb.bytes() * 8 * nhb / (secs * 1e9);
+      if ( stats ) stats->hb_secs += secs;
+      if ( getVerbosity() >= QUDA_SUMMARIZE ) {
     #ifdef MULTI_GPU
-      printfQuda("HB: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops * comm_size(), gbytes * comm_size());
+        printfQuda("HB: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops * comm_size(), gbytes * comm_size());
     #else
-      printfQuda("HB: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
+        printfQuda("HB: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
     #endif
+      }
+    }
+    if ( stats ) {
+      unsigned long long count[2];
+      qudaMemcpy(count, montearg.stats, sizeof(count), cudaMemcpyDeviceToHost);
+      device_free(montearg.stats);
+      montearg.stats = nullptr;
+      stats->updates += (NCOLORS * (NCOLORS - 1) / 2) * 8LL * montearg.threads * nhb;
+      stats->trials += count[0];
+      stats->failures += count[1];
     }
 
-    if ( getVerbosity() >= QUDA_SUMMARIZE ) profileHBOVR.TPSTART(QUDA_PROFILE_COMPUTE);
+    if ( timing ) profileHBOVR.TPSTART(QUDA_PROFILE_COMPUTE);
     GaugeHB<Float, Gauge, NCOLORS, NElems, false> relax(montearg);
     for ( int step = 0; step < nover; ++step ) {
       for ( int parity = 0; parity < 2; ++parity ) {
@@ -808,35 +871,38 @@ namespace quda {
         }
       }
     }
-    if ( getVerbosity() >= QUDA_SUMMARIZE ) {
+    if ( timing ) {
       qudaDeviceSynchronize();
       profileHBOVR.TPSTOP(QUDA_PROFILE_COMPUTE);
       double secs = profileHBOVR.Last(QUDA_PROFILE_COMPUTE);
       double gflops = (relax.flops() * 8 * nover * 1e-9) / (secs);
       double gbytes = relax.bytes() * 8 * nover / (secs * 1e9);
+      if ( stats ) stats->ovr_secs += secs;
+      if ( getVerbosity() >= QUDA_SUMMARIZE ) {
     #ifdef MULTI_GPU
-      printfQuda("OVR: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops * comm_size(), gbytes * comm_size());
+        printfQuda("OVR: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops * comm_size(), gbytes * comm_size());
     #else
-      printfQuda("OVR: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
+        printfQuda("OVR: Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
     #endif
+      }
     }
   }
 
 
 
   template<typename Float>
-  void Monte( cudaGaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover) {
+  void Monte( cudaGaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover, MonteStats *stats) {
 
     if ( data.isNative() ) {
       if ( data.Reconstruct() == QUDA_RECONSTRUCT_NO ) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type Gauge;	
-        Monte<Float, 18, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+        Monte<Float, 18, 3>(Gauge(data), data, rngstate, Beta, nhb, nover, stats);
       } else if ( data.Reconstruct() == QUDA_RECONSTRUCT_12 ) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type Gauge;	
-        Monte<Float, 12, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+        Monte<Float, 12, 3>(Gauge(data), data, rngstate, Beta, nhb, nover, stats);
       } else if ( data.Reconstruct() == QUDA_RECONSTRUCT_8 ) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type Gauge;	
-        Monte<Float, 8, 3>(Gauge(data), data, rngstate, Beta, nhb, nover);
+        Monte<Float, 8, 3>(Gauge(data), data, rngstate, Beta, nhb, nover, stats);
       } else {
         errorQuda("Reconstruction type %d of gauge field not supported", data.Reconstruct());
       }
@@ -844,6 +910,353 @@ namespace quda {
       errorQuda("Invalid Gauge Order\n");
     }
   }
+
+
+  /*
+    Host heatbath and overrelaxation.  The device kernels update one
+    (mu, parity) checkerboard of links per launch, with a
+    per-thread CURAND state.  On the host each checkerboard pass is
+    split further into the sites within one site of a partitioned
+    face (the boundary) and the rest (the interior): the boundary is
+    updated first, and its links are then sent to the neighbours by
+    the master thread while the other threads update the interior, so
+    the halo exchange is hidden behind the bulk of the sweep.  The
+    random numbers come from a counter-based Philox stream per link,
+    keyed on the global link index and the sweep, so a run does not
+    depend on the number of threads, the schedule or the process grid.
+  */
+
+  struct MonteCount {
+    long long trials;
+    long long failures;
+  };
+
+  template <typename Gauge, typename Float, int NCOLORS>
+  struct MonteHostArg {
+    int X[4];       // local lattice dimensions
+    int Xe[4];      // dimensions of the (possibly extended) field
+    int border[4];
+    int coord[4];   // offset of the local lattice in the global one
+    int globalX[4];
+    Gauge dataOr;
+    Float BetaOverNc;
+    PhiloxRNG rng;  // the streams of the current heatbath sweep
+    std::vector<int> sites[2][2]; // checkerboard indices of the [parity][boundary, interior] sites
+
+    MonteHostArg(const Gauge &dataOr, const GaugeField &data, Float Beta, const PhiloxRNG &rng)
+      : dataOr(dataOr), BetaOverNc(Beta / (Float)NCOLORS), rng(rng) {
+      for ( int dir = 0; dir < 4; ++dir ) {
+        border[dir] = data.R()[dir];
+        Xe[dir] = data.X()[dir];
+        X[dir] = Xe[dir] - 2 * border[dir];
+        coord[dir] = comm_coord(dir) * X[dir];
+        globalX[dir] = comm_dim(dir) * X[dir];
+      }
+      const int volumeCB = X[0] * X[1] * X[2] * X[3] >> 1;
+      for ( int parity = 0; parity < 2; ++parity ) {
+        for ( int idx = 0; idx < volumeCB; ++idx ) {
+          int x[4];
+          getCoords(x, idx, X, parity);
+          bool boundary = false;
+          for ( int dir = 0; dir < 4; ++dir )
+            if ( comm_dim_partitioned(dir) && ( x[dir] == 0 || x[dir] == X[dir] - 1 ) ) boundary = true;
+          sites[parity][boundary ? 0 : 1].push_back(idx);
+        }
+      }
+    }
+  };
+
+
+  /**
+     @brief Update the link U_mu(x) of the local checkerboard site idx
+     @return The SU(2) candidates drawn and failures of a heatbath update
+   */
+  template<typename Float, int NCOLORS, bool HeatbathOrRelax, typename Arg>
+  inline MonteCount monteSite(Arg &arg, int idx, int mu, int parity){
+    int x[4];
+    getCoords(x, idx, arg.X, parity);
+    long long global = 0;
+    for ( int dr = 3; dr >= 0; --dr ) global = global * arg.globalX[dr] + arg.coord[dr] + x[dr];
+    for ( int dr = 0; dr < 4; ++dr ) x[dr] += arg.border[dr];
+    idx = linkIndex(x, arg.Xe);
+
+    Matrix<complex<Float>,NCOLORS> staple = computeStaple<Float, NCOLORS>(arg.dataOr, x, arg.Xe, idx, mu, parity);
+
+    Matrix<complex<Float>,NCOLORS> U;
+    arg.dataOr.load((Float*)(U.data), idx, mu, parity);
+    int trials = 0, failures = 0;
+    if ( HeatbathOrRelax ) {
+      PhiloxState localState = arg.rng.State(4 * global + mu);
+      heatBathSUN<Float, NCOLORS>( U, conj(staple), localState, arg.BetaOverNc, trials, failures );
+    }
+    else{
+      overrelaxationSUN<Float, NCOLORS>( U, conj(staple) );
+    }
+    arg.dataOr.save((Float*)(U.data), idx, mu, parity);
+    return MonteCount{trials, failures};
+  }
+
+
+  /**
+     @brief Whether the master thread of an OpenMP parallel region may
+     drive the communications while the other threads compute, which
+     takes MPI_THREAD_FUNNELED or better.  The thread level of QMP
+     cannot be queried, so it is assumed to be single.
+   */
+  static bool commThreadFunneled() {
+#ifdef MPI_COMMS
+    int provided;
+    MPI_Query_thread(&provided);
+    return provided >= MPI_THREAD_FUNNELED;
+#else
+    return false;
+#endif
+  }
+
+  /**
+     @brief Exchange of the links of one direction and parity on the
+     faces of a host extended field, the host analogue of
+     PGaugeExchange.  The dimensions are exchanged in turn, each
+     including the borders received in the previous ones, so the
+     corners are filled too.  The exchange overlaps the update of the
+     interior only if the communications allow it (see
+     commThreadFunneled).
+   */
+  template<typename Float, typename Gauge>
+  class MonteHostExchange {
+    Gauge &dataOr;
+    int X[4];
+    int R[4];
+    int faceVolumeCB[4];
+    std::vector<Float> buffer[4][4]; // send forward, send back, receive from back, receive from forward
+    MsgHandle *mh_send_fwd[4];
+    MsgHandle *mh_send_back[4];
+    MsgHandle *mh_recv_back[4];
+    MsgHandle *mh_recv_fwd[4];
+    bool active_;
+    bool overlap_;
+
+    template <bool pack> void packFace(Float *array, int dim, int borderid, int mu, int parity) {
+      int d[3];
+      for ( int dr = 0, i = 0; dr < 4; ++dr ) if ( dr != dim ) d[i++] = dr;
+      for ( int idx = 0; idx < faceVolumeCB[dim]; ++idx ) {
+        int x[4];
+        int za = idx / ( X[d[0]] / 2 );
+        x[d[2]] = za / X[d[1]];
+        x[d[1]] = za - x[d[2]] * X[d[1]];
+        x[dim] = borderid;
+        int xodd = ( borderid + x[d[1]] + x[d[2]] + parity ) & 1;
+        x[d[0]] = ( 2 * idx + xodd ) - za * X[d[0]];
+        int id = linkIndex(x, X);
+        if ( pack ) dataOr.load(array + 18 * idx, id, mu, parity);
+        else dataOr.save(array + 18 * idx, id, mu, parity);
+      }
+    }
+
+  public:
+    MonteHostExchange(Gauge &dataOr, const GaugeField &data) : dataOr(dataOr), active_(false), overlap_(false) {
+      for ( int d = 0; d < 4; d++ ) {
+        X[d] = data.X()[d];
+        R[d] = data.R()[d];
+        faceVolumeCB[d] = X[0] * X[1] * X[2] * X[3] / ( 2 * X[d] );
+      }
+      for ( int d = 0; d < 4; d++ ) {
+        if ( !comm_dim_partitioned(d) ) continue;
+        for ( int i = 0; i < 4; i++ ) buffer[d][i].resize(18 * faceVolumeCB[d]);
+        const size_t bytes = buffer[d][0].size() * sizeof(Float);
+        mh_send_fwd[d] = comm_declare_send_relative(buffer[d][0].data(), d, +1, bytes);
+        mh_send_back[d] = comm_declare_send_relative(buffer[d][1].data(), d, -1, bytes);
+        mh_recv_back[d] = comm_declare_receive_relative(buffer[d][2].data(), d, -1, bytes);
+        mh_recv_fwd[d] = comm_declare_receive_relative(buffer[d][3].data(), d, +1, bytes);
+        active_ = true;
+      }
+      overlap_ = active_ && commThreadFunneled();
+    }
+
+    ~MonteHostExchange() {
+      for ( int d = 0; d < 4; d++ ) {
+        if ( !comm_dim_partitioned(d) ) continue;
+        comm_free(mh_send_fwd[d]);
+        comm_free(mh_send_back[d]);
+        comm_free(mh_recv_back[d]);
+        comm_free(mh_recv_fwd[d]);
+      }
+    }
+
+    bool active() const { return active_; }
+    bool overlap() const { return overlap_; }
+
+    void operator()(int mu, int parity) {
+      for ( int d = 0; d < 4; d++ ) {
+        if ( !comm_dim_partitioned(d) ) continue;
+        comm_start(mh_recv_back[d]);
+        comm_start(mh_recv_fwd[d]);
+        packFace<true>(buffer[d][0].data(), d, X[d] - R[d] - 1, mu, parity);
+        comm_start(mh_send_fwd[d]);
+        packFace<true>(buffer[d][1].data(), d, R[d], mu, parity);
+        comm_start(mh_send_back[d]);
+        comm_wait(mh_recv_back[d]);
+        packFace<false>(buffer[d][2].data(), d, R[d] - 1, mu, parity);
+        comm_wait(mh_recv_fwd[d]);
+        packFace<false>(buffer[d][3].data(), d, X[d] - R[d], mu, parity);
+        comm_wait(mh_send_back[d]);
+        comm_wait(mh_send_fwd[d]);
+      }
+    }
+  };
+
+
+  template<typename Float, typename Gauge, int NCOLORS, bool HeatbathOrRelax>
+  class GaugeHBHost : Tunable {
+    typedef MonteHostArg<Gauge, Float, NCOLORS> Arg;
+    Arg &arg;
+    MonteHostExchange<Float, Gauge> &exchange;
+    const GaugeField &meta;
+    int mu;
+    int parity;
+    int part; // 0 for the boundary sites, 1 for the interior
+    MonteCount count;
+    private:
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+    bool tuneGridDim() const { return false; }
+    unsigned int minThreads() const { return sites(); }
+    int sites() const { return arg.sites[parity][part].size(); }
+
+    public:
+    GaugeHBHost(Arg &arg, MonteHostExchange<Float, Gauge> &exchange, const GaugeField &meta)
+      : arg(arg), exchange(exchange), meta(meta), mu(0), parity(0), part(0), count{0, 0} {
+    }
+    void SetParam(int _mu, int _parity, int _part){
+      mu = _mu;
+      parity = _parity;
+      part = _part;
+    }
+    const MonteCount &Count() const { return count; }
+
+    void apply(const cudaStream_t &stream){
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      const std::vector<int> &site = arg.sites[parity][part];
+      auto update = [&](int, int i) { return monteSite<Float, NCOLORS, HeatbathOrRelax>(arg, site[i], mu, parity); };
+      auto sum = [](const MonteCount &a, const MonteCount &b) {
+        return MonteCount{a.trials + b.trials, a.failures + b.failures};
+      };
+      if ( part == 1 && exchange.overlap() ) {
+        // the boundary links of this pass go out while the interior is updated
+        count = parallel_reduce_overlap(tp, 1, sites(), MonteCount{0, 0}, update, sum, [&]() { exchange(mu, parity); });
+      } else {
+        if ( part == 1 && exchange.active() ) exchange(mu, parity);
+        count = parallel_reduce(tp, 1, sites(), MonteCount{0, 0}, update, sum);
+      }
+    }
+
+    bool hostLaunch() const { return true; }
+
+    TuneKey tuneKey() const {
+      std::stringstream aux;
+      aux << "sites=" << sites() << ",prec=" << sizeof(Float) << (part ? ",interior" : ",boundary");
+      aux << getOmpThreadStr();
+      return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
+    }
+
+    void preTune() { arg.dataOr.save(); }
+    void postTune() { arg.dataOr.load(); }
+
+    long long flops() const {
+      long long flop = NCOLORS * NCOLORS * NCOLORS * 84LL;
+      if ( NCOLORS == 3 ) flop = 2268LL + ( HeatbathOrRelax ? 801LL : 843LL );
+      return flop * sites();
+    }
+    long long bytes() const { return 20LL * NCOLORS * NCOLORS * 2 * sizeof(Float) * sites(); }
+  };
+
+
+  template<typename Float, int NCOLORS, typename Gauge>
+  void MonteHost( Gauge dataOr, GaugeField& data, PhiloxRNG &rng, Float Beta, int nhb, int nover, MonteStats *stats) {
+
+    typedef MonteHostArg<Gauge, Float, NCOLORS> Arg;
+    Arg arg(dataOr, data, Beta, rng);
+    MonteHostExchange<Float, Gauge> exchange(arg.dataOr, data);
+    GaugeHBHost<Float, Gauge, NCOLORS, true> hb(arg, exchange, data);
+    GaugeHBHost<Float, Gauge, NCOLORS, false> relax(arg, exchange, data);
+
+    // one sweep: every (mu, parity) pass updates its boundary sites
+    // then its interior, overlapped with the exchange of the boundary
+    auto sweep = [&](auto &update) {
+      MonteCount count = {0, 0};
+      long long flops = 0, bytes = 0;
+      for ( int parity = 0; parity < 2; ++parity ) {
+        for ( int mu = 0; mu < 4; ++mu ) {
+          for ( int part = 0; part < 2; ++part ) {
+            update.SetParam(mu, parity, part);
+            if ( arg.sites[parity][part].empty() ) {
+              if ( part == 1 ) exchange(mu, parity);
+              continue;
+            }
+            update.apply(0);
+            count.trials += update.Count().trials;
+            count.failures += update.Count().failures;
+            flops += update.flops();
+            bytes += update.bytes();
+          }
+        }
+      }
+      return std::make_tuple(count, flops, bytes);
+    };
+
+    long long flops = 0, bytes = 0;
+    Timer timer;
+    timer.Start(__func__, __FILE__, __LINE__);
+    for ( int step = 0; step < nhb; ++step ) {
+      arg.rng = rng;
+      auto result = sweep(hb);
+      rng.advance();
+      if ( stats ) {
+        stats->trials += std::get<0>(result).trials;
+        stats->failures += std::get<0>(result).failures;
+        stats->updates += (NCOLORS * (NCOLORS - 1) / 2) * 4LL * arg.X[0] * arg.X[1] * arg.X[2] * arg.X[3];
+      }
+      flops += std::get<1>(result);
+      bytes += std::get<2>(result);
+    }
+    timer.Stop(__func__, __FILE__, __LINE__);
+    if ( stats ) stats->hb_secs += timer.Last();
+    if ( getVerbosity() >= QUDA_SUMMARIZE ) {
+      double secs = timer.Last();
+      printfQuda("HB (host): Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs,
+                 flops * comm_size() * 1e-9 / secs, bytes * comm_size() * 1e-9 / secs);
+    }
+
+    flops = 0;
+    bytes = 0;
+    timer.Start(__func__, __FILE__, __LINE__);
+    for ( int step = 0; step < nover; ++step ) {
+      auto result = sweep(relax);
+      flops += std::get<1>(result);
+      bytes += std::get<2>(result);
+    }
+    timer.Stop(__func__, __FILE__, __LINE__);
+    if ( stats ) stats->ovr_secs += timer.Last();
+    if ( getVerbosity() >= QUDA_SUMMARIZE ) {
+      double secs = timer.Last();
+      printfQuda("OVR (host): Time = %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs,
+                 flops * comm_size() * 1e-9 / secs, bytes * comm_size() * 1e-9 / secs);
+    }
+  }
+
+
+  template<typename Float>
+  void MonteHost( GaugeField& data, PhiloxRNG &rng, Float Beta, int nhb, int nover, MonteStats *stats) {
+    if ( data.Order() == QUDA_QDP_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type Gauge;
+      MonteHost<Float, 3>(Gauge(data), data, rng, Beta, nhb, nover, stats);
+    } else if ( data.Order() == QUDA_MILC_GAUGE_ORDER ) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type Gauge;
+      MonteHost<Float, 3>(Gauge(data), data, rng, Beta, nhb, nover, stats);
+    } else {
+      errorQuda("Gauge field order %d not supported", data.Order());
+    }
+  }
 #endif // GPU_GAUGE_ALG
 
 /** @brief Perform heatbath and overrelaxation. Performs nhb heatbath steps followed by nover overrelaxation steps.
@@ -853,13 +1266,37 @@ namespace quda {
  * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
  * @param[in] nhb number of heatbath steps
  * @param[in] nover number of overrelaxation steps
+ * @param[in,out] stats if set, accumulates the heatbath statistics and timings
  */
-  void Monte( cudaGaugeField& data, RNG &rngstate, double Beta, int nhb, int nover) {
+  void Monte( cudaGaugeField& data, RNG &rngstate, double Beta, int nhb, int nover, MonteStats *stats) {
+#ifdef GPU_GAUGE_ALG
+    if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
+      Monte<float> (data, rngstate, (float)Beta, nhb, nover, stats);
+    } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
+      Monte<double>(data, rngstate, Beta, nhb, nover, stats);
+    } else {
+      errorQuda("Precision %d not supported", data.Precision());
+    }
+#else
+    errorQuda("Pure gauge code has not been built");
+#endif // GPU_GAUGE_ALG
+  }
+
+  void Monte( GaugeField& data, PhiloxRNG &rng, double Beta, int nhb, int nover, MonteStats *stats) {
 #ifdef GPU_GAUGE_ALG
+    if ( data.Location() != QUDA_CPU_FIELD_LOCATION ) errorQuda("Host heatbath requires a host field");
+    if ( data.Reconstruct() != QUDA_RECONSTRUCT_NO ) errorQuda("Reconstruction type %d not supported", data.Reconstruct());
+    for ( int d = 0; d < 4; d++ ) {
+      const int X = data.X()[d] - 2 * data.R()[d];
+      if ( X % 2 != 0 || data.R()[d] % 2 != 0 )
+        errorQuda("Dimension %d requires an even local extent and border, not %d and %d", d, X, data.R()[d]);
+      if ( comm_dim_partitioned(d) && data.R()[d] == 0 )
+        errorQuda("Partitioned dimension %d requires an extended field", d);
+    }
     if ( data.Precision() == QUDA_SINGLE_PRECISION ) {
-      Monte<float> (data, rngstate, (float)Beta, nhb, nover);
+      MonteHost<float> (data, rng, (float)Beta, nhb, nover, stats);
     } else if ( data.Precision() == QUDA_DOUBLE_PRECISION ) {
-      Monte<double>(data, rngstate, Beta, nhb, nover);
+      MonteHost<double>(data, rng, Beta, nhb, nover, stats);
     } else {
       errorQuda("Precision %d not supported", data.Precision());
     }
@@ -1,6 +1,7 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
 #include <tune_quda.h>
+#include <host_parallel.h>
 #include <typeinfo>
 #include <multigrid_helper.cuh>
 
@@ -96,19 +97,17 @@ namespace quda {
   }
 
   template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, int fine_colors_per_thread, typename Arg>
-  void Prolongate(Arg &arg) {
-    for (int parity=0; parity<arg.nParity; parity++) {
-      parity = (arg.nParity == 2) ? parity : arg.parity;
+  void Prolongate(Arg &arg, const TuneParam &tp) {
+    parallel_for(tp, arg.nParity, arg.out.VolumeCB(), [&](int parity, int x_cb) {
+	parity = (arg.nParity == 2) ? parity : arg.parity;
 
-      for (int x_cb=0; x_cb<arg.out.VolumeCB(); x_cb++) {
 	complex<Float> tmp[fineSpin*coarseColor];
 	prolongate<Float,fineSpin,coarseColor>(tmp, arg.in, parity, x_cb, arg.geo_map, arg.spin_map, arg.out.VolumeCB());
 	for (int fine_color_block=0; fine_color_block<fineColor; fine_color_block+=fine_colors_per_thread) {
 	  rotateFineColor<Float,fineSpin,fineColor,coarseColor,fine_colors_per_thread>
 	    (arg.out, tmp, arg.V, parity, arg.nParity, x_cb, fine_color_block);
 	}
-      }
-    }
+      }); // parity and c/b volume
   }
 
   template <typename Float, int fineSpin, int fineColor, int coarseSpin, int coarseColor, int fine_colors_per_thread, typename Arg>
@@ -154,22 +153,24 @@ namespace quda {
       strcpy(aux, out.AuxString());
       strcat(aux, ",");
       strcat(aux, in.AuxString());
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
     }
 
     virtual ~ProlongateLaunch() { }
 
     void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+
       if (location == QUDA_CPU_FIELD_LOCATION) {
 	if (out.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
 	  ProlongateArg<Float,vFloat,fineSpin,fineColor,coarseSpin,coarseColor,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER>
 	    arg(out, in, V, fine_to_coarse, parity);
-	  Prolongate<Float,fineSpin,fineColor,coarseSpin,coarseColor,fine_colors_per_thread>(arg);
+	  Prolongate<Float,fineSpin,fineColor,coarseSpin,coarseColor,fine_colors_per_thread>(arg, tp);
 	} else {
 	  errorQuda("Unsupported field order %d", out.FieldOrder());
 	}
       } else {
 	if (out.FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
-	  TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 	  ProlongateArg<Float,vFloat,fineSpin,fineColor,coarseSpin,coarseColor,QUDA_FLOAT2_FIELD_ORDER>
 	    arg(out, in, V, fine_to_coarse, parity);
 	  ProlongateKernel<Float,fineSpin,fineColor,coarseSpin,coarseColor,fine_colors_per_thread>
@@ -180,6 +181,8 @@ namespace quda {
       }
     }
 
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
+
     TuneKey tuneKey() const { return TuneKey(vol, typeid(*this).name(), aux); }
 
     long long flops() const { return 8 * fineSpin * fineColor * coarseColor * out.SiteSubset()*(long long)out.VolumeCB(); }
@@ -31,6 +31,10 @@ namespace quda
   void arpack_solve(std::vector<ColorSpinorField *> &h_evecs, std::vector<Complex> &h_evals, const DiracMatrix &mat,
                     QudaEigParam *eig_param, TimeProfile &profile)
   {
+    // the filter parameters are only estimated by the TRLM and block TRLM restart loops
+    if (eig_param->use_poly_acc && eig_param->poly_acc_auto)
+      errorQuda("Automatic Chebyshev filter parameters are not supported with ARPACK");
+
     // Create Eigensolver object for member function use
     EigenSolver *eig_solver = EigenSolver::create(eig_param, mat, profile);
 
@@ -1,3 +1,6 @@
+#include <vector>
+#include <algorithm>
+
 #include <blas_quda.h>
 #include <tune_quda.h>
 #include <float_vector.h>
@@ -321,6 +324,25 @@ namespace quda {
       half   short2  M = 3/3
     */
 
+    /**
+       @brief Book-keeping common to all host reductions: update the
+       flop and byte counters, and when asynchronous reductions are
+       requested leave the (process-local) result in the host reduce
+       buffer, from where a subsequent host blas kernel can consume it
+       (e.g., caxpyXmazMR).  Since host reductions are synchronous
+       this is the host analogue of leaving the result on the device.
+       @param[in] value The result of the reduction
+       @param[in] x The low-precision field (sets the stream size)
+       @param[in] z The high-precision field (the mixed-precision field)
+    */
+    template <typename Reducer, typename doubleN>
+    void hostReduceAccounting(const doubleN &value, const ColorSpinorField &x, const ColorSpinorField &z)
+    {
+      blas::bytes += (Reducer::streams() - 2) * x.Bytes() + 2 * z.Bytes();
+      blas::flops += Reducer::flops() * x.Length();
+      if (commAsyncReduction()) memcpy(h_reduce, &value, sizeof(doubleN));
+    }
+
     /**
        Driver for generic reduction routine with five loads.
        @param ReduceType
@@ -484,6 +506,7 @@ namespace quda {
         } else {
           errorQuda("Precision %d not implemented", x.Precision());
         }
+        hostReduceAccounting<Reducer<doubleN, double2, double2>>(value, x, z);
       }
 
       const int Nreduce = sizeof(doubleN) / sizeof(double);
@@ -685,6 +708,7 @@ namespace quda {
         } else {
           errorQuda("Precision %d not implemented", x.Precision());
         }
+        hostReduceAccounting<Reducer<doubleN, double2, double2>>(value, x, z);
       }
 
       const int Nreduce = sizeof(doubleN) / sizeof(double);
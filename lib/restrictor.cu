@@ -47,6 +47,8 @@ namespace quda {
       strcat(aux, ",");
       strcat(aux, in.AuxString());
 
+      if (location == QUDA_CPU_FIELD_LOCATION) strcat(aux, getOmpThreadStr());
+
       strcpy(vol, out.VolString());
       strcat(vol, ",");
       strcat(vol, in.VolString());
@@ -54,17 +56,17 @@ namespace quda {
     virtual ~RestrictLaunch() { }
 
     void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+
       if (location == QUDA_CPU_FIELD_LOCATION) {
 	if (out.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
 	  RestrictArg<Float,vFloat,fineSpin,fineColor,coarseSpin,coarseColor,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER>
 	    arg(out, in, v, fine_to_coarse, coarse_to_fine, parity);
-	  Restrict<Float,fineSpin,fineColor,coarseSpin,coarseColor,coarse_colors_per_thread>(arg);
+	  Restrict<Float,fineSpin,fineColor,coarseSpin,coarseColor,coarse_colors_per_thread>(arg, tp);
 	} else {
 	  errorQuda("Unsupported field order %d", out.FieldOrder());
 	}
       } else {
-	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-
 	if (out.FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
 	  typedef RestrictArg<Float,vFloat,fineSpin,fineColor,coarseSpin,coarseColor,QUDA_FLOAT2_FIELD_ORDER> Arg;
 	  Arg arg(out, in, v, fine_to_coarse, coarse_to_fine, parity);
@@ -129,15 +131,28 @@ namespace quda {
 #endif
     }
 
+    bool hostLaunch() const { return location == QUDA_CPU_FIELD_LOCATION; }
+
     // only tune shared memory per thread (disable tuning for block.z for now)
-    bool advanceTuneParam(TuneParam &param) const { return advanceSharedBytes(param) || advanceAux(param); }
+    bool advanceTuneParam(TuneParam &param) const
+    {
+      if (hostLaunch()) return advanceHostTuneParam(param);
+      return advanceSharedBytes(param) || advanceAux(param);
+    }
 
     TuneKey tuneKey() const { return TuneKey(vol, typeid(*this).name(), aux); }
 
-    void initTuneParam(TuneParam &param) const { defaultTuneParam(param); }
+    void initTuneParam(TuneParam &param) const {
+      if (hostLaunch()) initHostTuneParam(param);
+      else defaultTuneParam(param);
+    }
 
     /** sets default values for when tuning is disabled */
     void defaultTuneParam(TuneParam &param) const {
+      if (hostLaunch()) {
+        defaultHostTuneParam(param);
+        return;
+      }
       param.block = dim3(block_size, in.SiteSubset(), 1);
       param.grid = dim3( (minThreads()+param.block.x-1) / param.block.x, 1, 1);
       param.shared_bytes = 0;
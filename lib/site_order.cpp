@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <cstdlib>
+#include <cstring>
+
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <host_parallel.h>
+#include <site_order.h>
+
+namespace quda {
+
+  // sort key for the blocked order: tile index first, then position within the tile
+  static uint64_t blockedKey(const int c[4], const int Xc[4], const int Bc[4])
+  {
+    uint64_t tile = 0, within = 0, tile_volume = 1;
+    for (int d = 3; d >= 0; d--) {
+      const int n_tile = (Xc[d] + Bc[d] - 1) / Bc[d];
+      tile = tile * n_tile + c[d] / Bc[d];
+      within = within * Bc[d] + c[d] % Bc[d];
+      tile_volume *= Bc[d];
+    }
+    return tile * tile_volume + within;
+  }
+
+  // sort key for the Morton order: interleave the bits of the four coordinates
+  static uint64_t mortonKey(const int c[4])
+  {
+    uint64_t key = 0;
+    for (int b = 0; b < 16; b++)
+      for (int d = 0; d < 4; d++) key |= static_cast<uint64_t>((c[d] >> b) & 1) << (4 * b + d);
+    return key;
+  }
+
+  SiteOrdering::SiteOrdering(const int *X_, QudaSiteOrder order, const int *block_) : order(order)
+  {
+    for (int d = 0; d < 4; d++) {
+      X[d] = X_[d];
+      block[d] = block_ ? block_[d] : 4;
+      if (block[d] < 1) errorQuda("Invalid block size %d in dimension %d", block[d], d);
+      if (X[d] >= (1 << 16)) errorQuda("Lattice dimension %d = %d too large", d, X[d]);
+    }
+    if (X[0] % 2) errorQuda("Lattice x dimension %d must be even", X[0]);
+    if (block[0] % 2) errorQuda("Block x dimension %d must be even", block[0]);
+    volumeCB = X[0] * X[1] * X[2] * X[3] / 2;
+
+    // the permutation acts on the checkerboarded coordinates so it is the same for both parities
+    const int Xc[4] = {X[0] / 2, X[1], X[2], X[3]};
+    const int Bc[4] = {block[0] / 2, block[1], block[2], block[3]};
+
+    std::vector<uint64_t> key(volumeCB);
+#pragma omp parallel for
+    for (int x_cb = 0; x_cb < volumeCB; x_cb++) {
+      int c[4];
+      int r = x_cb;
+      for (int d = 0; d < 4; d++) {
+        c[d] = r % Xc[d];
+        r /= Xc[d];
+      }
+
+      switch (order) {
+      case QUDA_EVEN_ODD_SITE_ORDER: key[x_cb] = x_cb; break;
+      case QUDA_BLOCKED_SITE_ORDER: key[x_cb] = blockedKey(c, Xc, Bc); break;
+      case QUDA_MORTON_SITE_ORDER: key[x_cb] = mortonKey(c); break;
+      default: break;
+      }
+    }
+    if (order != QUDA_EVEN_ODD_SITE_ORDER && !isReorderedSiteOrder(order))
+      errorQuda("Site order %d not supported", order);
+
+    cb.resize(volumeCB);
+    std::iota(cb.begin(), cb.end(), 0);
+    std::stable_sort(cb.begin(), cb.end(), [&](int a, int b) { return key[a] < key[b]; });
+
+    storage.resize(volumeCB);
+    for (int s = 0; s < volumeCB; s++) storage[cb[s]] = s;
+
+    for (int parity = 0; parity < 2; parity++) {
+      nbr[parity].resize(8 * volumeCB);
+#pragma omp parallel for
+      for (int s = 0; s < volumeCB; s++) {
+        const int x_cb = cb[s];
+        int x[4];
+        int r = x_cb;
+        x[0] = 2 * (r % Xc[0]);
+        r /= Xc[0];
+        for (int d = 1; d < 4; d++) {
+          x[d] = r % X[d];
+          r /= X[d];
+        }
+        x[0] += (x[1] + x[2] + x[3] + parity) & 1;
+
+        for (int dim = 0; dim < 4; dim++) {
+          for (int dir = 0; dir < 2; dir++) {
+            int y[4] = {x[0], x[1], x[2], x[3]};
+            y[dim] = (y[dim] + (dir ? X[dim] - 1 : 1)) % X[dim];
+            const int y_cb = (((y[3] * X[2] + y[2]) * X[1] + y[1]) * X[0] + y[0]) >> 1;
+            nbr[parity][8 * s + 2 * dim + dir] = storage[y_cb];
+          }
+        }
+      }
+    }
+  }
+
+  const SiteOrdering &getSiteOrdering(const int *X, QudaSiteOrder order)
+  {
+    static std::map<std::array<int, 5>, std::unique_ptr<SiteOrdering>> cache;
+
+    std::array<int, 5> key = {X[0], X[1], X[2], X[3], static_cast<int>(order)};
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+      // tile size of the blocked order, e.g., QUDA_SITE_ORDER_BLOCK=4,4,4,8
+      int block[4] = {4, 4, 4, 4};
+      char *block_env = getenv("QUDA_SITE_ORDER_BLOCK");
+      if (block_env
+          && sscanf(block_env, "%d,%d,%d,%d", &block[0], &block[1], &block[2], &block[3]) != 4)
+        errorQuda("Invalid QUDA_SITE_ORDER_BLOCK=%s, expected four comma-separated integers", block_env);
+
+      it = cache.emplace(key, std::unique_ptr<SiteOrdering>(new SiteOrdering(X, order, block))).first;
+    }
+    return *it->second;
+  }
+
+  /**
+     Copy nBlock consecutive blocks of volumeCB sites, applying the
+     inverse permutation of the input ordering followed by the
+     permutation of the output ordering.
+   */
+  static void permuteSites(char *out, const SiteOrdering &out_order, const char *in, const SiteOrdering &in_order,
+                           size_t site_bytes, int nBlock)
+  {
+    const size_t volumeCB = out_order.VolumeCB();
+    parallel_for(hostDefaultParam(), nBlock, volumeCB, [&](int b, int x_cb) {
+      memcpy(out + (b * volumeCB + out_order.Index(x_cb)) * site_bytes,
+             in + (b * volumeCB + in_order.Index(x_cb)) * site_bytes, site_bytes);
+    });
+  }
+
+  static void checkSiteOrders(QudaSiteOrder out, QudaSiteOrder in)
+  {
+    if (out != QUDA_EVEN_ODD_SITE_ORDER && !isReorderedSiteOrder(out))
+      errorQuda("Cannot reorder into site order %d", out);
+    if (in != QUDA_EVEN_ODD_SITE_ORDER && !isReorderedSiteOrder(in))
+      errorQuda("Cannot reorder from site order %d", in);
+  }
+
+  void reorderSites(ColorSpinorField &out, const ColorSpinorField &in)
+  {
+    if (out.Location() != QUDA_CPU_FIELD_LOCATION || in.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Site reordering only supported for host fields");
+    checkSiteOrders(out.SiteOrder(), in.SiteOrder());
+    if (out.Precision() != in.Precision())
+      errorQuda("Precisions do not match %d %d", out.Precision(), in.Precision());
+    if (out.FieldOrder() != in.FieldOrder())
+      errorQuda("Field orders do not match %d %d", out.FieldOrder(), in.FieldOrder());
+    if (in.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER && in.FieldOrder() != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER)
+      errorQuda("Field order %d not supported", in.FieldOrder());
+    if (out.SiteSubset() != in.SiteSubset())
+      errorQuda("Site subsets do not match %d %d", out.SiteSubset(), in.SiteSubset());
+    if (in.Ndim() != 4 && in.Ndim() != 5) errorQuda("Number of dimensions %d not supported", in.Ndim());
+
+    int X[4];
+    for (int d = 0; d < 4; d++) X[d] = in.X(d);
+    if (in.SiteSubset() == QUDA_PARITY_SITE_SUBSET) X[0] *= 2;
+    const int Ls = in.Ndim() == 5 ? in.X(4) : 1;
+
+    const size_t site_bytes = 2 * in.Nspin() * in.Ncolor() * in.Precision();
+    const int nBlock = in.SiteSubset() * Ls; // parity-major, then the fifth dimension
+
+    permuteSites(static_cast<char *>(out.V()), getSiteOrdering(X, out.SiteOrder()),
+                 static_cast<const char *>(in.V()), getSiteOrdering(X, in.SiteOrder()), site_bytes, nBlock);
+  }
+
+  void reorderSites(GaugeField &out, const GaugeField &in)
+  {
+    if (out.Location() != QUDA_CPU_FIELD_LOCATION || in.Location() != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("Site reordering only supported for host fields");
+    checkSiteOrders(out.SiteOrder(), in.SiteOrder());
+    if (out.Precision() != in.Precision())
+      errorQuda("Precisions do not match %d %d", out.Precision(), in.Precision());
+    if (out.Order() != in.Order()) errorQuda("Gauge orders do not match %d %d", out.Order(), in.Order());
+    if (out.Reconstruct() != in.Reconstruct())
+      errorQuda("Reconstruct types do not match %d %d", out.Reconstruct(), in.Reconstruct());
+    if (out.Geometry() != in.Geometry())
+      errorQuda("Geometries do not match %d %d", out.Geometry(), in.Geometry());
+
+    const SiteOrdering &out_order = getSiteOrdering(in.X(), out.SiteOrder());
+    const SiteOrdering &in_order = getSiteOrdering(in.X(), in.SiteOrder());
+    const size_t link_bytes = in.Bytes() / (in.Geometry() * in.Volume());
+
+    void *out_p = out.Gauge_p();
+    const void *in_p = in.Gauge_p();
+
+    if (in.Order() == QUDA_QDP_GAUGE_ORDER) {
+      for (int d = 0; d < in.Geometry(); d++)
+        permuteSites(static_cast<char **>(out_p)[d], out_order, static_cast<char *const *>(in_p)[d], in_order,
+                     link_bytes, 2);
+    } else if (in.Order() == QUDA_MILC_GAUGE_ORDER) {
+      permuteSites(static_cast<char *>(out_p), out_order, static_cast<const char *>(in_p), in_order,
+                   in.Geometry() * link_bytes, 2);
+    } else {
+      errorQuda("Gauge order %d not supported", in.Order());
+    }
+  }
+
+} // namespace quda
@@ -85,6 +85,10 @@ namespace quda {
       report("SD");
       solver = new SD(mat, param, profile);
       break;
+    case QUDA_POLYNOMIAL_INVERTER:
+      report("POLYNOMIAL");
+      solver = new PolynomialPreconditioner(mat, matSloppy, param, profile);
+      break;
     case QUDA_XSD_INVERTER:
 #ifdef MULTI_GPU
       report("XSD");
@@ -128,6 +132,10 @@ namespace quda {
 	solver = new GMResDR(mat, matSloppy, matPrecon, param, profile);
       }
       break;
+    case QUDA_GCRODR_INVERTER:
+      report("GCRODR");
+      solver = new GCRODR(mat, matSloppy, param, profile);
+      break;
     case QUDA_CGNE_INVERTER:
       report("CGNE");
       solver = new CGNE(mat, matSloppy, param, profile);
@@ -13,6 +13,9 @@
 #include <tune_quda.h>
 #include <utility> // for std::swap
 #include <random_quda.h>
+#include <random_philox.h>
+#include <host_parallel.h>
+#include <index_helper.cuh>
 
 namespace quda {
 
@@ -139,44 +142,192 @@ namespace quda {
     }
   }
 
+  /**
+     Arguments for counter-based noise: each site draws from the Philox
+     blocks of its global index, so the noise is a function of the
+     seed and the global lattice only, independent of the process
+     grid, the thread count and the location of the field.
+  */
+  template<typename real, int Ns, int Nc, QudaFieldOrder order>
+  struct PhiloxNoiseArg {
+    typedef typename colorspinor::FieldOrderCB<real,Ns,Nc,1,order> V;
+    V v;
+    const int nParity;
+    const int volumeCB;
+    const int volume4CB; // checkerboarded 4-d volume
+    int X[4];            // local 4-d lattice dimensions
+    int offset[5];       // origin of the local lattice on the global one
+    int global[5];       // global lattice dimensions, with Ls as the fifth
+    const unsigned long long seed;
+    PhiloxNoiseArg(ColorSpinorField &v, unsigned long long seed) :
+      v(v), nParity(v.SiteSubset()), volumeCB(v.VolumeCB()),
+      volume4CB(v.VolumeCB() / (v.Ndim() == 5 ? v.X(4) : 1)), seed(seed)
+    {
+      for (int d = 0; d < 4; d++) {
+        X[d] = v.X(d);
+        if (d == 0 && v.SiteSubset() == QUDA_PARITY_SITE_SUBSET) X[d] *= 2;
+        offset[d] = comm_coord(d) * X[d];
+        global[d] = comm_dim(d) * X[d];
+      }
+      offset[4] = 0;
+      global[4] = v.Ndim() == 5 ? v.X(4) : 1;
+    }
+  };
+
+  /**
+     Fill a site with counter-based noise.  Element i = s * Nc + c
+     takes block i of the site's stream (stream id 0), whose first two
+     and last two words give the two uniform numbers, so each element
+     can be computed independently.  On the host the blocks of a site
+     are generated together in a SIMD loop; on the device one at a
+     time to save registers.  A single-parity field is treated as the
+     even sublattice.
+  */
+  template <typename real, int Ns, int Nc, QudaNoiseType type, typename Arg>
+  __device__ __host__ inline void genPhilox(Arg &arg, int parity, int x_cb)
+  {
+    const int s5 = x_cb / arg.volume4CB;
+    int x[5];
+    getCoords(x, x_cb - s5 * arg.volume4CB, arg.X, parity);
+    x[4] = s5;
+    const unsigned long long site = globalSiteIndex(x, arg.offset, arg.global, 5);
+
+#ifdef __CUDA_ARCH__
+    constexpr int batch = 1;
+#else
+    constexpr int batch = Ns * Nc;
+#endif
+    for (int i0 = 0; i0 < Ns * Nc; i0 += batch) {
+      unsigned int word[batch][4];
+#pragma omp simd
+      for (int j = 0; j < batch; j++) philoxBlock(word[j], arg.seed, site, 0, i0 + j);
+
+      for (int j = 0; j < batch; j++) {
+        real a = philoxUniform<real>(word[j]);
+        real b = philoxUniform<real>(word[j] + 2);
+        const int s = (i0 + j) / Nc;
+        const int c = (i0 + j) % Nc;
+        if (type == QUDA_NOISE_GAUSS) {
+          const real phi = 2.0 * M_PI * a;
+          const real radius = sqrt(-1.0 * log(b));
+          arg.v(parity, x_cb, s, c) = complex<real>(radius * cos(phi), radius * sin(phi));
+        } else {
+          arg.v(parity, x_cb, s, c) = complex<real>(a, b);
+        }
+      }
+    }
+  }
+
+  template <typename real, int Ns, int Nc, QudaNoiseType type, typename Arg>
+  __global__ void SpinorNoisePhiloxGPU(Arg arg)
+  {
+    int x_cb = blockIdx.x * blockDim.x + threadIdx.x;
+    if (x_cb >= arg.volumeCB) return;
+
+    int parity = blockIdx.y * blockDim.y + threadIdx.y;
+    if (parity >= arg.nParity) return;
+
+    genPhilox<real, Ns, Nc, type>(arg, parity, x_cb);
+  }
+
+  template <typename real, int Ns, int Nc, QudaNoiseType type, typename Arg>
+  class SpinorNoisePhilox : TunableVectorY {
+    Arg &arg;
+    const ColorSpinorField &meta; // this reference is for meta data only
+
+  private:
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+    bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
+    unsigned int minThreads() const { return meta.VolumeCB(); }
+
+  public:
+    SpinorNoisePhilox(Arg &arg, const ColorSpinorField &meta)
+      : TunableVectorY(meta.SiteSubset()), arg(arg), meta(meta) {
+      strcpy(aux, meta.AuxString());
+      strcat(aux, meta.Location()==QUDA_CUDA_FIELD_LOCATION ? ",GPU" : ",CPU");
+      if (hostLaunch()) strcat(aux, getOmpThreadStr());
+    }
+
+    void apply(const cudaStream_t &stream) {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        SpinorNoisePhiloxGPU<real, Ns, Nc, type><<<tp.grid, tp.block, tp.shared_bytes, stream>>>(arg);
+      } else {
+        parallel_for(tp, arg.nParity, arg.volumeCB,
+                     [&](int parity, int x_cb) { genPhilox<real, Ns, Nc, type>(arg, parity, x_cb); });
+      }
+    }
+
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
+    TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
+    long long flops() const { return 0; }
+    long long bytes() const { return meta.Bytes(); }
+    // the noise is a function of the seed alone, so there is no state to back up
+  };
+
+  template <typename real, int Ns, int Nc, QudaFieldOrder order>
+  void spinorNoise(ColorSpinorField &in, unsigned long long &seed, QudaNoiseType type) {
+    PhiloxNoiseArg<real, Ns, Nc, order> arg(in, seed);
+    switch (type) {
+    case QUDA_NOISE_GAUSS:
+      {
+        SpinorNoisePhilox<real, Ns, Nc, QUDA_NOISE_GAUSS, PhiloxNoiseArg<real, Ns, Nc, order> > noise(arg, in);
+        noise.apply(0);
+        break;
+      }
+    case QUDA_NOISE_UNIFORM:
+      {
+        SpinorNoisePhilox<real, Ns, Nc, QUDA_NOISE_UNIFORM, PhiloxNoiseArg<real, Ns, Nc, order> > noise(arg, in);
+        noise.apply(0);
+        break;
+      }
+    default:
+      errorQuda("Noise type %d not implemented", type);
+    }
+  }
+
   /** Decide on the input order*/
-  template <typename real, int Ns, int Nc>
-  void spinorNoise(ColorSpinorField &in, RNG &rngstate, QudaNoiseType type)
+  template <typename real, int Ns, int Nc, typename Gen>
+  void spinorNoise(ColorSpinorField &in, Gen &gen, QudaNoiseType type)
   {
     if (in.FieldOrder() == QUDA_FLOAT2_FIELD_ORDER) {
-      spinorNoise<real,Ns,Nc,QUDA_FLOAT2_FIELD_ORDER>(in, rngstate, type);
+      spinorNoise<real,Ns,Nc,QUDA_FLOAT2_FIELD_ORDER>(in, gen, type);
     } else if (in.FieldOrder() == QUDA_FLOAT4_FIELD_ORDER) {
-      spinorNoise<real,Ns,Nc,QUDA_FLOAT4_FIELD_ORDER>(in, rngstate, type);
+      spinorNoise<real,Ns,Nc,QUDA_FLOAT4_FIELD_ORDER>(in, gen, type);
+    } else if (in.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
+      spinorNoise<real,Ns,Nc,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER>(in, gen, type);
     } else {
       errorQuda("Order %d not defined (Ns=%d, Nc=%d)", in.FieldOrder(), Ns, Nc);
     }
   }
 
-  template <typename real, int Ns>
-  void spinorNoise(ColorSpinorField &src, RNG& randstates, QudaNoiseType type)
+  template <typename real, int Ns, typename Gen>
+  void spinorNoise(ColorSpinorField &src, Gen &gen, QudaNoiseType type)
   {
     if (src.Ncolor() == 3) {
-      spinorNoise<real,Ns,3>(src, randstates, type);
+      spinorNoise<real,Ns,3>(src, gen, type);
     } else if (src.Ncolor() == 6) {
-      spinorNoise<real,Ns,6>(src, randstates, type);
+      spinorNoise<real,Ns,6>(src, gen, type);
     } else if (src.Ncolor() == 24) {
-      spinorNoise<real,Ns,24>(src, randstates, type);
+      spinorNoise<real,Ns,24>(src, gen, type);
     } else if (src.Ncolor() == 32) {
-      spinorNoise<real,Ns,32>(src, randstates, type);
+      spinorNoise<real,Ns,32>(src, gen, type);
     } else {
       errorQuda("nColor = %d not implemented", src.Ncolor());
     }
   }
 
-  template <typename real>
-  void spinorNoise(ColorSpinorField &src, RNG& randstates, QudaNoiseType type)
+  template <typename real, typename Gen>
+  void spinorNoise(ColorSpinorField &src, Gen &gen, QudaNoiseType type)
   {
     if (src.Nspin() == 4) {
-      spinorNoise<real,4>(src, randstates, type);
+      spinorNoise<real,4>(src, gen, type);
     } else if (src.Nspin() == 2) {
-      spinorNoise<real,2>(src, randstates, type);
+      spinorNoise<real,2>(src, gen, type);
     } else if (src.Nspin() == 1) {
-      spinorNoise<real,1>(src, randstates, type);
+      spinorNoise<real,1>(src, gen, type);
     } else {
       errorQuda("Nspin = %d not implemented", src.Nspin());
     }
@@ -207,13 +358,32 @@ namespace quda {
     }
   }
 
-  void spinorNoise(ColorSpinorField &src, unsigned long long seed, QudaNoiseType type)
+  void spinorNoise(ColorSpinorField &src_, unsigned long long seed, QudaNoiseType type)
   {
-    RNG *randstates = new RNG(src, seed);
-    randstates->Init();
-    spinorNoise(src, *randstates, type);
-    randstates->Release();
-    delete randstates;
+    // host fields in space-spin-color order are filled in place, the
+    // rest via a device field of at least single precision
+    ColorSpinorField *src = &src_;
+    const bool host = src_.Location() == QUDA_CPU_FIELD_LOCATION
+      && src_.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    if (!host && (src_.Location() == QUDA_CPU_FIELD_LOCATION || src_.Precision() < QUDA_SINGLE_PRECISION)) {
+      ColorSpinorParam param(src_);
+      QudaPrecision prec = std::max(src_.Precision(), QUDA_SINGLE_PRECISION);
+      param.setPrecision(prec, prec, true); // change to native field order
+      param.create = QUDA_NULL_FIELD_CREATE;
+      param.location = QUDA_CUDA_FIELD_LOCATION;
+      src = ColorSpinorField::Create(param);
+    }
+
+    switch (src->Precision()) {
+    case QUDA_DOUBLE_PRECISION: spinorNoise<double>(*src, seed, type); break;
+    case QUDA_SINGLE_PRECISION: spinorNoise<float>(*src, seed, type); break;
+    default: errorQuda("Precision %d not implemented", src->Precision());
+    }
+
+    if (src != &src_) {
+      src_ = *src; // upload result
+      delete src;
+    }
   }
 
 } // namespace quda
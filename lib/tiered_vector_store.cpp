@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cstring>
+
+#include <tiered_vector_store.h>
+#include <blas_quda.h>
+#include <quda_cuda_api.h>
+
+namespace quda
+{
+
+  TieredVectorStore::TieredVectorStore(const ColorSpinorParam &param, int n_max, int n_resident,
+                                       QudaPrecision spill_precision, int block_size) :
+    param(param),
+    n_max(n_max),
+    n_resident(std::min(n_resident, n_max)),
+    spill_precision(spill_precision),
+    block_size(block_size),
+    size(0),
+    resident(this->n_resident, nullptr),
+    own_resident(true)
+  {
+    init();
+  }
+
+  TieredVectorStore::TieredVectorStore(const std::vector<ColorSpinorField *> &resident, int n_max,
+                                       QudaPrecision spill_precision, int block_size) :
+    param(*resident[0]),
+    n_max(n_max),
+    n_resident(std::min(static_cast<int>(resident.size()), n_max)),
+    spill_precision(spill_precision),
+    block_size(block_size),
+    size(0),
+    resident(resident.begin(), resident.begin() + n_resident),
+    own_resident(false)
+  {
+    init();
+  }
+
+  void TieredVectorStore::init()
+  {
+    if (n_max <= 0) errorQuda("Invalid capacity %d", n_max);
+    if (n_resident < 0) errorQuda("Invalid number of resident vectors %d", n_resident);
+    if (block_size <= 0) errorQuda("Invalid block size %d", block_size);
+
+    // the vectors are stand-alone fields even when adopted from a composite field
+    param.is_composite = false;
+    param.composite_dim = 0;
+    param.is_component = false;
+    param.component_id = 0;
+    param.create = QUDA_NULL_FIELD_CREATE;
+    if (param.location == QUDA_CUDA_FIELD_LOCATION) param.mem_type = QUDA_MEMORY_DEVICE;
+
+    if (spill_precision == QUDA_INVALID_PRECISION) spill_precision = param.Precision();
+    if (param.location == QUDA_CPU_FIELD_LOCATION && spill_precision < QUDA_SINGLE_PRECISION)
+      errorQuda("Spill precision %d not supported for host fields", spill_precision);
+
+    spill_bytes = 0;
+    spill_norm_offset = 0;
+    copy_stream = 0;
+    if (n_max == n_resident) return; // nothing will ever be spilled
+
+    ColorSpinorParam spill_param(param);
+    spill_param.setPrecision(spill_precision, QUDA_INVALID_PRECISION, param.location == QUDA_CUDA_FIELD_LOCATION);
+
+    for (int b = 0; b < 2; b++) {
+      for (int i = 0; i < block_size; i++) {
+        stage[b].push_back(ColorSpinorField::Create(param));
+        if (spill_precision != param.Precision()) spill_stage[b].push_back(ColorSpinorField::Create(spill_param));
+      }
+      if (spill_stage[b].size() == 0) spill_stage[b] = stage[b];
+    }
+
+    spill_norm_offset = spill_stage[0][0]->Bytes();
+    spill_bytes = spill_norm_offset + spill_stage[0][0]->NormBytes();
+
+    if (param.location == QUDA_CUDA_FIELD_LOCATION) {
+      cudaStreamCreateWithFlags(&copy_stream, cudaStreamNonBlocking);
+      for (int b = 0; b < 2; b++) cudaEventCreateWithFlags(&copy_event[b], cudaEventDisableTiming);
+    }
+  }
+
+  TieredVectorStore::~TieredVectorStore()
+  {
+    if (own_resident)
+      for (auto v : resident)
+        if (v) delete v;
+
+    for (int b = 0; b < 2; b++) {
+      if (host_copy[b].valid()) host_copy[b].wait();
+      if (spill_stage[b] != stage[b])
+        for (auto v : spill_stage[b]) delete v;
+      for (auto v : stage[b]) delete v;
+    }
+
+    for (auto image : spilled) host_free(image);
+
+    if (copy_stream) {
+      for (int b = 0; b < 2; b++) cudaEventDestroy(copy_event[b]);
+      cudaStreamDestroy(copy_stream);
+    }
+  }
+
+  ColorSpinorField &TieredVectorStore::residentField(int i)
+  {
+    if (!resident[i]) resident[i] = ColorSpinorField::Create(param);
+    return *resident[i];
+  }
+
+  char *TieredVectorStore::spillImage(int i)
+  {
+    int j = i - n_resident;
+    while (static_cast<int>(spilled.size()) <= j) {
+      // pinned memory so that the prefetch can overlap with computation
+      spilled.push_back(static_cast<char *>(param.location == QUDA_CUDA_FIELD_LOCATION ? pinned_malloc(spill_bytes) :
+                                                                                         safe_malloc(spill_bytes)));
+    }
+    return spilled[j];
+  }
+
+  void TieredVectorStore::spill(char *image, const ColorSpinorField &v)
+  {
+    ColorSpinorField &tmp = *spill_stage[0][0];
+    tmp = v;
+
+    if (param.location == QUDA_CUDA_FIELD_LOCATION) {
+      qudaMemcpy(image, tmp.V(), tmp.Bytes(), cudaMemcpyDeviceToHost);
+      if (tmp.NormBytes()) qudaMemcpy(image + spill_norm_offset, tmp.Norm(), tmp.NormBytes(), cudaMemcpyDeviceToHost);
+    } else {
+      std::memcpy(image, tmp.V(), tmp.Bytes());
+    }
+  }
+
+  void TieredVectorStore::prefetch(int buffer, int first, int n)
+  {
+    std::vector<ColorSpinorField *> &dst = spill_stage[buffer];
+
+    if (param.location == QUDA_CUDA_FIELD_LOCATION) {
+      for (int i = 0; i < n; i++) {
+        const char *image = spilled[first + i - n_resident];
+        qudaMemcpyAsync(dst[i]->V(), image, dst[i]->Bytes(), cudaMemcpyHostToDevice, copy_stream);
+        if (dst[i]->NormBytes())
+          qudaMemcpyAsync(dst[i]->Norm(), image + spill_norm_offset, dst[i]->NormBytes(), cudaMemcpyHostToDevice,
+                          copy_stream);
+      }
+      qudaEventRecord(copy_event[buffer], copy_stream);
+    } else {
+      std::vector<const char *> src(n);
+      for (int i = 0; i < n; i++) src[i] = spilled[first + i - n_resident];
+      size_t bytes = dst[0]->Bytes();
+      host_copy[buffer] = std::async(std::launch::async, [&dst, src, bytes]() {
+        for (unsigned int i = 0; i < src.size(); i++) std::memcpy(dst[i]->V(), src[i], bytes);
+      });
+    }
+  }
+
+  std::vector<ColorSpinorField *> &TieredVectorStore::wait(int buffer, int n)
+  {
+    if (param.location == QUDA_CUDA_FIELD_LOCATION)
+      qudaEventSynchronize(copy_event[buffer]);
+    else
+      host_copy[buffer].get();
+
+    if (spill_stage[buffer] != stage[buffer])
+      for (int i = 0; i < n; i++) *stage[buffer][i] = *spill_stage[buffer][i];
+
+    return stage[buffer];
+  }
+
+  void TieredVectorStore::set(int i, const ColorSpinorField &v)
+  {
+    if (i < 0 || i > size || i >= n_max) errorQuda("Invalid index %d (size = %d, capacity = %d)", i, size, n_max);
+    if (i == size) size++;
+
+    if (i < n_resident)
+      residentField(i) = v;
+    else
+      spill(spillImage(i), v);
+  }
+
+  void TieredVectorStore::get(ColorSpinorField &v, int i)
+  {
+    if (i < 0 || i >= size) errorQuda("Invalid index %d (size = %d)", i, size);
+
+    if (i < n_resident) {
+      v = *resident[i];
+    } else {
+      prefetch(0, i, 1);
+      v = *wait(0, 1)[0];
+    }
+  }
+
+  void TieredVectorStore::pushFront(const ColorSpinorField &v)
+  {
+    int new_size = std::min(size + 1, n_max);
+
+    if (new_size > n_resident) {
+      // move the last resident vector (or v itself if nothing is resident) to the front of the spilled vectors,
+      // recycling the image of the last spilled vector
+      spillImage(new_size - 1);
+      int n = new_size - n_resident;
+      std::rotate(spilled.begin(), spilled.begin() + (n - 1), spilled.begin() + n);
+      spill(spilled[0], n_resident > 0 ? *resident[n_resident - 1] : v);
+    }
+
+    if (n_resident > 0) {
+      int n = std::min(new_size, n_resident);
+      residentField(n - 1);
+      std::rotate(resident.begin(), resident.begin() + (n - 1), resident.begin() + n);
+      *resident[0] = v;
+    }
+
+    size = new_size;
+  }
+
+  void TieredVectorStore::apply(const std::function<void(std::vector<ColorSpinorField *> &, int)> &f, int n)
+  {
+    if (n < 0) n = size;
+    if (n > size) errorQuda("Requested %d vectors but only %d held", n, size);
+
+    int n_hot = std::min(n, n_resident);
+    if (n_hot > 0) {
+      std::vector<ColorSpinorField *> hot(resident.begin(), resident.begin() + n_hot);
+      f(hot, 0);
+    }
+
+    int n_cold = n - n_hot;
+    int n_block = (n_cold + block_size - 1) / block_size;
+    if (n_block == 0) return;
+
+    prefetch(0, n_hot, std::min(block_size, n_cold));
+    for (int k = 0; k < n_block; k++) {
+      int first = n_hot + k * block_size;
+      int count = std::min(block_size, n - first);
+      std::vector<ColorSpinorField *> &buffer = wait(k % 2, count);
+
+      // the other buffer was last used by block k-1, which has completed
+      if (k + 1 < n_block) prefetch((k + 1) % 2, first + count, std::min(block_size, n - first - count));
+
+      std::vector<ColorSpinorField *> block(buffer.begin(), buffer.begin() + count);
+      f(block, first);
+      if (param.location == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
+    }
+  }
+
+  void TieredVectorStore::cDotProduct(Complex *result, std::vector<ColorSpinorField *> &y, int n)
+  {
+    const int ylen = y.size();
+    apply([&](std::vector<ColorSpinorField *> &v, int offset) { blas::cDotProduct(result + offset * ylen, v, y); }, n);
+  }
+
+  void TieredVectorStore::cDotProduct(Complex *result, TieredVectorStore &y, int n)
+  {
+    if (n < 0) n = size;
+    const int ylen = y.Size();
+
+    // y is traversed in the outer loop without prefetch, so that its
+    // staging buffers are free for the inner loop when y is this store
+    int n_hot = y.NumResident();
+    std::vector<ColorSpinorField *> tmp;
+    std::vector<Complex> block_result;
+
+    for (int first = 0; first < ylen;) {
+      int count;
+      std::vector<ColorSpinorField *> y_block;
+      if (first < n_hot) {
+        count = n_hot;
+        y_block = y.Resident();
+      } else {
+        count = std::min(y.block_size, ylen - first);
+        while (static_cast<int>(tmp.size()) < count) tmp.push_back(ColorSpinorField::Create(y.param));
+        for (int j = 0; j < count; j++) y.get(*tmp[j], first + j);
+        y_block.assign(tmp.begin(), tmp.begin() + count);
+      }
+
+      block_result.resize(n * count);
+      cDotProduct(block_result.data(), y_block, n);
+      for (int i = 0; i < n; i++)
+        for (int j = 0; j < count; j++) result[i * ylen + first + j] = block_result[i * count + j];
+
+      first += count;
+    }
+
+    for (auto v : tmp) delete v;
+  }
+
+  void TieredVectorStore::caxpy(const Complex *a, std::vector<ColorSpinorField *> &y, int n)
+  {
+    const int ylen = y.size();
+    apply([&](std::vector<ColorSpinorField *> &v, int offset) { blas::caxpy(a + offset * ylen, v, y); }, n);
+  }
+
+} // namespace quda
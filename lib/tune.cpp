@@ -16,6 +16,10 @@
 #include <queue>
 #include <functional>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //#define LAUNCH_TIMER
 extern char* gitversion;
 
@@ -127,6 +131,15 @@ namespace quda {
 
   const map& getTuneCache() { return tunecache; }
 
+  int hostMaxThreads()
+  {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
 
   /**
    * Deserialize tunecache from an istream, useful for reading a file or receiving from other nodes.
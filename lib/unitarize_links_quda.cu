@@ -12,6 +12,7 @@
 
 #include <su3_project.cuh>
 #include <index_helper.cuh>
+#include <host_parallel.h>
 
 
 namespace quda{
@@ -360,26 +361,34 @@ namespace{
 
 #ifdef GPU_UNITARIZE
 
+  /**
+     @brief Unitarize a link
+     @return Whether the unitarized link failed the unitarity check
+  */
   template<typename Float, typename Out, typename In>
-  __global__ void DoUnitarizedLink(UnitarizeLinksArg<Out,In> arg){
-    int idx = threadIdx.x + blockIdx.x*blockDim.x;
-    int parity = threadIdx.y + blockIdx.y*blockDim.y;
-    int mu = threadIdx.z + blockIdx.z*blockDim.z;
-    if (idx >= arg.threads) return;
-    if (mu >= 4) return;
-
+  __device__ __host__ inline bool unitarizeLinkSite(UnitarizeLinksArg<Out,In> &arg, int idx, int parity, int mu) {
     // result is always in double precision
     Matrix<complex<double>,3> v, result;
     Matrix<complex<Float>,3> tmp = arg.input(mu, idx, parity);
 
     v = tmp;
     unitarizeLinkMILC(v, &result, arg);
-    if (arg.check_unitarization) {
-      if (isUnitary(result,arg.max_error) == false) atomicAdd(arg.fails, 1);
-    }
+    bool failed = arg.check_unitarization && isUnitary(result,arg.max_error) == false;
     tmp = result;
 
     arg.output(mu, idx, parity) = tmp;
+    return failed;
+  }
+
+  template<typename Float, typename Out, typename In>
+  __global__ void DoUnitarizedLink(UnitarizeLinksArg<Out,In> arg){
+    int idx = threadIdx.x + blockIdx.x*blockDim.x;
+    int parity = threadIdx.y + blockIdx.y*blockDim.y;
+    int mu = threadIdx.z + blockIdx.z*blockDim.z;
+    if (idx >= arg.threads) return;
+    if (mu >= 4) return;
+
+    if (unitarizeLinkSite<Float>(arg, idx, parity, mu)) atomicAdd(arg.fails, 1);
   }
 
 
@@ -388,6 +397,7 @@ namespace{
   class UnitarizeLinks : TunableVectorYZ {
     UnitarizeLinksArg<Out,In> arg;
     const GaugeField &meta;
+    const bool inplace; // whether tuning has to preserve the input
 
     unsigned int sharedBytesPerThread() const { return 0; }
     unsigned int sharedBytesPerBlock(const TuneParam &) const { return 0; }
@@ -397,17 +407,33 @@ namespace{
     unsigned int minThreads() const { return arg.threads; }
 
   public:
-    UnitarizeLinks(UnitarizeLinksArg<Out,In> &arg, const GaugeField &meta)
-      : TunableVectorYZ(2,4), arg(arg), meta(meta) { }
+    UnitarizeLinks(UnitarizeLinksArg<Out,In> &arg, const GaugeField &meta, bool inplace)
+      : TunableVectorYZ(2,4), arg(arg), meta(meta), inplace(inplace) { }
     
     void apply(const cudaStream_t &stream){
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      DoUnitarizedLink<Float,Out,In><<<tp.grid, tp.block, tp.shared_bytes, stream>>>(arg);
+      if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) {
+        DoUnitarizedLink<Float,Out,In><<<tp.grid, tp.block, tp.shared_bytes, stream>>>(arg);
+      } else {
+        *arg.fails += parallel_reduce(tp, 2, arg.threads, 0,
+                                      [&](int parity, int idx) {
+                                        int fails = 0;
+                                        for (int mu = 0; mu < 4; mu++)
+                                          fails += unitarizeLinkSite<Float>(arg, idx, parity, mu) ? 1 : 0;
+                                        return fails;
+                                      },
+                                      [](int a, int b) { return a + b; });
+      }
     }
-    void preTune() { if (arg.input.gauge == arg.output.gauge) arg.output.save(); }
+
+    bool hostLaunch() const { return meta.Location() == QUDA_CPU_FIELD_LOCATION; }
+
+    void preTune() { if (inplace) arg.output.save(); }
     void postTune() {
-      if (arg.input.gauge == arg.output.gauge) arg.output.load();
-      cudaMemset(arg.fails, 0, sizeof(int)); // reset fails counter
+      if (inplace) arg.output.load();
+      // reset fails counter
+      if (hostLaunch()) *arg.fails = 0;
+      else cudaMemset(arg.fails, 0, sizeof(int));
     }
     
     long long flops() const { 
@@ -419,36 +445,53 @@ namespace{
     TuneKey tuneKey() const {
       std::stringstream aux;
       aux << "threads=" << arg.threads << ",prec=" << sizeof(Float);
+      if (hostLaunch()) aux << getOmpThreadStr();
       return TuneKey(meta.VolString(), typeid(*this).name(), aux.str().c_str());
     }  
   }; 
   
   
   template<typename Float, typename Out, typename In>
-  void unitarizeLinks(Out output, const In input, const cudaGaugeField& meta, int* fails) {
+  void unitarizeLinks(Out output, const In input, const GaugeField& meta, int* fails, bool inplace) {
     UnitarizeLinksArg<Out,In> arg(output, input, meta, fails, max_iter, unitarize_eps, max_error,
                                   reunit_allow_svd, reunit_svd_only, svd_rel_error, svd_abs_error);
-    UnitarizeLinks<Float, Out, In> unitlinks(arg, meta);
+    UnitarizeLinks<Float, Out, In> unitlinks(arg, meta, inplace);
     unitlinks.apply(0);
-    qudaDeviceSynchronize(); // need to synchronize to ensure failure write has completed
+    // need to synchronize to ensure failure write has completed
+    if (meta.Location() == QUDA_CUDA_FIELD_LOCATION) qudaDeviceSynchronize();
   }
   
 template<typename Float>
-void unitarizeLinks(cudaGaugeField& output, const cudaGaugeField &input, int* fails) {
-
-  if( output.isNative() && input.isNative() ) {
+void unitarizeLinks(GaugeField& output, const GaugeField &input, int* fails) {
+
+  const bool inplace = output.Gauge_p() == input.Gauge_p();
+  if (output.Location() == QUDA_CPU_FIELD_LOCATION) {
+    if (output.Order() != input.Order() || output.Reconstruct() != QUDA_RECONSTRUCT_NO
+        || input.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Orders %d %d with %d %d reconstruct not supported", output.Order(), input.Order(),
+                output.Reconstruct(), input.Reconstruct());
+    if (output.Order() == QUDA_QDP_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_QDP_GAUGE_ORDER,3>::type G;
+      unitarizeLinks<Float>(G(output), G(input), input, fails, inplace);
+    } else if (output.Order() == QUDA_MILC_GAUGE_ORDER) {
+      typedef typename gauge_order_mapper<Float,QUDA_MILC_GAUGE_ORDER,3>::type G;
+      unitarizeLinks<Float>(G(output), G(input), input, fails, inplace);
+    } else {
+      errorQuda("Gauge field order %d not supported on the host", output.Order());
+    }
+  } else if( output.isNative() && input.isNative() ) {
     if(output.Reconstruct() == QUDA_RECONSTRUCT_NO) {
       typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type Out;
 
       if(input.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else if(input.Reconstruct() == QUDA_RECONSTRUCT_12) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else if(input.Reconstruct() == QUDA_RECONSTRUCT_8) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else {
 	errorQuda("Reconstruction type %d of gauge field not supported", input.Reconstruct());
       }
@@ -458,13 +501,13 @@ void unitarizeLinks(cudaGaugeField& output, const cudaGaugeField &input, int* fa
 
       if(input.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else if(input.Reconstruct() == QUDA_RECONSTRUCT_12) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else if(input.Reconstruct() == QUDA_RECONSTRUCT_8) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else {
 	errorQuda("Reconstruction type %d of gauge field not supported", input.Reconstruct());
       }
@@ -475,13 +518,13 @@ void unitarizeLinks(cudaGaugeField& output, const cudaGaugeField &input, int* fa
 
       if(input.Reconstruct() == QUDA_RECONSTRUCT_NO) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_NO>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else if(input.Reconstruct() == QUDA_RECONSTRUCT_12) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_12>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else if(input.Reconstruct() == QUDA_RECONSTRUCT_8) {
 	typedef typename gauge_mapper<Float,QUDA_RECONSTRUCT_8>::type In;
-	unitarizeLinks<Float>(Out(output), In(input), input, fails) ;
+	unitarizeLinks<Float>(Out(output), In(input), input, fails, inplace);
       } else {
 	errorQuda("Reconstruction type %d of gauge field not supported", input.Reconstruct());
       }
@@ -497,10 +540,12 @@ void unitarizeLinks(cudaGaugeField& output, const cudaGaugeField &input, int* fa
   
 #endif // GPU_UNITARIZE
   
-  void unitarizeLinks(cudaGaugeField& output, const cudaGaugeField &input, int* fails) {
+  void unitarizeLinks(GaugeField& output, const GaugeField &input, int* fails) {
 #ifdef GPU_UNITARIZE
     if (input.Precision() != output.Precision()) 
       errorQuda("input (%d) and output (%d) precisions must match", output.Precision(), input.Precision());
+    if (input.Location() != output.Location())
+      errorQuda("input (%d) and output (%d) locations must match", output.Location(), input.Location());
 
     if (input.Precision() == QUDA_SINGLE_PRECISION) {
       unitarizeLinks<float>(output, input, fails);
@@ -514,7 +559,7 @@ void unitarizeLinks(cudaGaugeField& output, const cudaGaugeField &input, int* fa
 #endif
   }
 
-  void unitarizeLinks(cudaGaugeField &links, int* fails) {
+  void unitarizeLinks(GaugeField &links, int* fails) {
     unitarizeLinks(links, links, fails);
   }
 
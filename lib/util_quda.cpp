@@ -8,6 +8,7 @@
 #include <enum_quda.h>
 #include <util_quda.h>
 #include <malloc_quda.h>
+#include <tune_quda.h>
 
 static const size_t MAX_PREFIX_SIZE = 100;
 
@@ -132,13 +133,8 @@ void popOutputPrefix()
 char *getPrintBuffer() { return buffer_; }
 
 char* getOmpThreadStr() {
+  // the host thread count is tuned, so the key records the number available
   static char omp_thread_string[128];
-  static bool init = false;
-  if (!init) {
-    strcpy(omp_thread_string,",omp_threads=");
-    char *omp_threads = getenv("OMP_NUM_THREADS");
-    strcat(omp_thread_string, omp_threads ? omp_threads : "1");
-    init = true;
-  }
+  snprintf(omp_thread_string, sizeof(omp_thread_string), ",omp_threads=%d", quda::hostMaxThreads());
   return omp_thread_string;
 }
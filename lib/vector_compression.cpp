@@ -0,0 +1,573 @@
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include <comm_quda.h>
+#include <lattice_geometry.h>
+#include <timer.h>
+#include <vector_compression.h>
+
+namespace quda
+{
+
+  static const char store_magic[8] = {'Q', 'U', 'D', 'A', 'C', 'V', 'S', '1'};
+
+  // storage widths of a coefficient group in bits, narrowest first
+  static constexpr int n_width = 5;
+  static constexpr int width[n_width] = {0, 8, 16, 32, 64};
+
+  VectorCompressionParam::VectorCompressionParam() : n_basis(0), tol(0.0)
+  {
+    for (int d = 0; d < 4; d++) block_size[d] = 0;
+  }
+
+  VectorCompressionParam::VectorCompressionParam(const QudaEigParam &param) :
+    n_basis(param.vec_compress_n_basis),
+    tol(param.vec_compress_tol)
+  {
+    for (int d = 0; d < 4; d++) block_size[d] = param.vec_compress_block_size[d];
+  }
+
+  VectorCompressionParam::VectorCompressionParam(const QudaMultigridParam &param, int level) :
+    n_basis(param.vec_compress_n_basis[level]),
+    tol(param.vec_compress_tol[level])
+  {
+    for (int d = 0; d < 4; d++) block_size[d] = param.geo_block_size[level][d];
+  }
+
+  // one file per process, so a store must be read back on the same decomposition
+  static std::string rankFile(const std::string &file)
+  {
+    return comm_size() > 1 ? file + ".rank" + std::to_string(comm_rank()) : file;
+  }
+
+  static int groupBytes(int bits, int n) { return 2 * n * bits / 8; }
+
+  static double quantizeError(const Complex *c, int n, int bits, float scale)
+  {
+    double err = 0.0;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < 2; j++) {
+        const double x = j == 0 ? c[i].real() : c[i].imag();
+        double q;
+        switch (bits) {
+        case 0: q = 0.0; break;
+        case 8: q = std::round(x / scale * 127.0) * scale / 127.0; break;
+        case 16: q = std::round(x / scale * 32767.0) * scale / 32767.0; break;
+        case 32: q = static_cast<float>(x); break;
+        default: q = x;
+        }
+        err += (x - q) * (x - q);
+      }
+    }
+    return err;
+  }
+
+  template <typename T> static void encodeFixed(const Complex *c, int n, float scale, double q, char *dst)
+  {
+    T *d = reinterpret_cast<T *>(dst);
+    for (int i = 0; i < n; i++) {
+      d[2 * i + 0] = static_cast<T>(std::round(c[i].real() / scale * q));
+      d[2 * i + 1] = static_cast<T>(std::round(c[i].imag() / scale * q));
+    }
+  }
+
+  template <typename T> static void decodeFixed(const char *src, int n, double s, Complex *c)
+  {
+    const T *d = reinterpret_cast<const T *>(src);
+    for (int i = 0; i < n; i++) c[i] = Complex(s * d[2 * i + 0], s * d[2 * i + 1]);
+  }
+
+  static void encode(const Complex *c, int n, int bits, float scale, char *dst)
+  {
+    switch (bits) {
+    case 0: break;
+    case 8: encodeFixed<int8_t>(c, n, scale, 127.0, dst); break;
+    case 16: encodeFixed<int16_t>(c, n, scale, 32767.0, dst); break;
+    case 32:
+      for (int i = 0; i < n; i++) {
+        reinterpret_cast<float *>(dst)[2 * i + 0] = c[i].real();
+        reinterpret_cast<float *>(dst)[2 * i + 1] = c[i].imag();
+      }
+      break;
+    default: memcpy(dst, c, n * sizeof(Complex));
+    }
+  }
+
+  static void decode(const char *src, int n, int bits, float scale, Complex *c)
+  {
+    switch (bits) {
+    case 0:
+      for (int i = 0; i < n; i++) c[i] = 0.0;
+      break;
+    case 8: decodeFixed<int8_t>(src, n, scale / 127.0, c); break;
+    case 16: decodeFixed<int16_t>(src, n, scale / 32767.0, c); break;
+    case 32: decodeFixed<float>(src, n, 1.0, c); break;
+    default: memcpy(c, src, n * sizeof(Complex));
+    }
+  }
+
+  CompressedVectorStore::CompressedVectorStore(const VectorCompressionParam &param) :
+    param(param),
+    Ls(1),
+    site_subset(QUDA_INVALID_SITE_SUBSET),
+    nColor(0),
+    nSpin(0),
+    precision(QUDA_INVALID_PRECISION),
+    n_block(0),
+    block_volume(0),
+    agg_length(0),
+    n_agg(0),
+    n_group_agg(0),
+    max_proj_res(0.0)
+  {
+    for (int d = 0; d < 4; d++) X[d] = 0;
+    for (int i = 0; i < n_width; i++) group_count[i] = 0;
+  }
+
+  void CompressedVectorStore::setGeometry(const int *X_, int Ls_, QudaSiteSubset site_subset_, int nColor_, int nSpin_,
+                                          QudaPrecision precision_)
+  {
+    for (int d = 0; d < 4; d++) X[d] = X_[d];
+    Ls = Ls_;
+    site_subset = site_subset_;
+    nColor = nColor_;
+    nSpin = nSpin_;
+    precision = precision_;
+
+    // chirality is the spin block index, as for the multigrid aggregates
+    n_chiral = nSpin == 1 ? 1 : 2;
+    chiral_length = nSpin / n_chiral * nColor;
+
+    int n_block_dim[4];
+    int block_volume_4d = 1;
+    n_block = Ls;
+    for (int d = 0; d < 4; d++) {
+      if (param.block_size[d] <= 0 || X[d] % param.block_size[d])
+        errorQuda("Block size %d does not divide the local lattice dimension %d in dimension %d", param.block_size[d],
+                  X[d], d);
+      n_block_dim[d] = X[d] / param.block_size[d];
+      n_block *= n_block_dim[d];
+      block_volume_4d *= param.block_size[d];
+    }
+    if (site_subset == QUDA_PARITY_SITE_SUBSET && block_volume_4d % 2)
+      errorQuda("Blocks of odd volume %d cannot hold a single parity", block_volume_4d);
+    block_volume = site_subset == QUDA_PARITY_SITE_SUBSET ? block_volume_4d / 2 : block_volume_4d;
+    agg_length = block_volume * chiral_length;
+    n_agg = n_block * n_chiral;
+    n_group_agg = (param.n_basis + group_size - 1) / group_size;
+
+    if (param.n_basis > agg_length)
+      errorQuda("Number of basis vectors %d exceeds the aggregate length %d", param.n_basis, agg_length);
+
+    // the sites of a parity field are addressed as if they were even
+    const LatticeGeometry &geom = getLatticeGeometry(X);
+    const int volume_4d_cb = geom.VolumeCB();
+    const int n_parity = site_subset == QUDA_PARITY_SITE_SUBSET ? 1 : 2;
+    const int volume = n_parity * Ls * volume_4d_cb;
+
+    std::vector<int> block_of(volume);
+    for (int i = 0; i < volume; i++) {
+      const int parity = i / (Ls * volume_4d_cb);
+      const int s = (i / volume_4d_cb) % Ls;
+      int x[4];
+      geom.Coords(x, parity * volume_4d_cb + i % volume_4d_cb);
+      int b = s;
+      for (int d = 3; d >= 0; d--) b = b * n_block_dim[d] + x[d] / param.block_size[d];
+      block_of[i] = b;
+    }
+
+    std::vector<int> fill(n_block, 0);
+    block_sites.resize(volume);
+    for (int i = 0; i < volume; i++) {
+      const int b = block_of[i];
+      if (fill[b] == block_volume) errorQuda("Block %d holds more than %d sites", b, block_volume);
+      block_sites[b * block_volume + fill[b]++] = i;
+    }
+  }
+
+  void CompressedVectorStore::checkGeometry(const ColorSpinorField &v) const
+  {
+    int Y[4];
+    for (int d = 0; d < 4; d++) Y[d] = v.X(d);
+    if (v.SiteSubset() == QUDA_PARITY_SITE_SUBSET) Y[0] *= 2;
+    for (int d = 0; d < 4; d++)
+      if (Y[d] != X[d]) errorQuda("Lattice dimension %d = %d does not match the stored %d", d, Y[d], X[d]);
+    if ((v.Ndim() == 5 ? v.X(4) : 1) != Ls) errorQuda("Fifth dimension does not match the stored %d", Ls);
+    if (v.SiteSubset() != site_subset) errorQuda("Site subset %d does not match the stored %d", v.SiteSubset(), site_subset);
+    if (v.Ncolor() != nColor || v.Nspin() != nSpin)
+      errorQuda("Field with nColor = %d, nSpin = %d does not match the stored %d, %d", v.Ncolor(), v.Nspin(), nColor,
+                nSpin);
+  }
+
+  // host staging field in the order and precision the store works with
+  ColorSpinorField *CompressedVectorStore::hostField(const ColorSpinorField &v) const
+  {
+    ColorSpinorParam csParam(v);
+    csParam.location = QUDA_CPU_FIELD_LOCATION;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    csParam.setPrecision(precision);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    return ColorSpinorField::Create(csParam);
+  }
+
+  template <typename Float> void CompressedVectorStore::addBasis(const Float *v_, int k)
+  {
+    const std::complex<Float> *v = reinterpret_cast<const std::complex<Float> *>(v_);
+    std::complex<Float> *B = reinterpret_cast<std::complex<Float> *>(basis.data());
+    const int site_length = nSpin * nColor;
+
+#pragma omp parallel
+    {
+      std::vector<Complex> w(agg_length);
+#pragma omp for
+      for (int a = 0; a < n_agg; a++) {
+        const int b = a / n_chiral;
+        const int c = a % n_chiral;
+        for (int s = 0; s < block_volume; s++) {
+          const std::complex<Float> *src = v + block_sites[b * block_volume + s] * site_length + c * chiral_length;
+          for (int e = 0; e < chiral_length; e++) w[s * chiral_length + e] = src[e];
+        }
+
+        double norm0 = 0.0;
+        for (int j = 0; j < agg_length; j++) norm0 += std::norm(w[j]);
+
+        // modified Gram-Schmidt against the existing basis, applied twice
+        for (int pass = 0; pass < 2; pass++) {
+          for (int l = 0; l < k; l++) {
+            const std::complex<Float> *Bl = B + ((size_t)a * param.n_basis + l) * agg_length;
+            Complex dot = 0.0;
+            for (int j = 0; j < agg_length; j++) dot += std::conj(Complex(Bl[j])) * w[j];
+            for (int j = 0; j < agg_length; j++) w[j] -= dot * Complex(Bl[j]);
+          }
+        }
+
+        double norm = 0.0;
+        for (int j = 0; j < agg_length; j++) norm += std::norm(w[j]);
+
+        // a direction already spanned by the basis is left zero
+        const double eps = precision == QUDA_DOUBLE_PRECISION ? 1e-24 : 1e-12;
+        const double inv_norm = norm > eps * norm0 ? 1.0 / sqrt(norm) : 0.0;
+        std::complex<Float> *Bk = B + ((size_t)a * param.n_basis + k) * agg_length;
+        for (int j = 0; j < agg_length; j++) Bk[j] = inv_norm * w[j];
+      }
+    }
+  }
+
+  template <typename Float> void CompressedVectorStore::project(const Float *v_, int n_k, Coefficients &coeff)
+  {
+    const std::complex<Float> *v = reinterpret_cast<const std::complex<Float> *>(v_);
+    const std::complex<Float> *B = reinterpret_cast<const std::complex<Float> *>(basis.data());
+    const int site_length = nSpin * nColor;
+    const int n_group = n_agg * n_group_agg;
+
+    std::vector<Complex> c((size_t)n_agg * param.n_basis, 0.0);
+    double norm[2] = {0.0, 0.0}; // norm of the vector and of its projection
+
+#pragma omp parallel
+    {
+      std::vector<Complex> w(agg_length);
+      double norm_v = 0.0;
+      double norm_c = 0.0;
+#pragma omp for
+      for (int a = 0; a < n_agg; a++) {
+        const int b = a / n_chiral;
+        const int ch = a % n_chiral;
+        for (int s = 0; s < block_volume; s++) {
+          const std::complex<Float> *src = v + block_sites[b * block_volume + s] * site_length + ch * chiral_length;
+          for (int e = 0; e < chiral_length; e++) w[s * chiral_length + e] = src[e];
+        }
+        for (int j = 0; j < agg_length; j++) norm_v += std::norm(w[j]);
+
+        for (int k = 0; k < n_k; k++) {
+          const std::complex<Float> *Bk = B + ((size_t)a * param.n_basis + k) * agg_length;
+          Complex dot = 0.0;
+          for (int j = 0; j < agg_length; j++) dot += std::conj(Complex(Bk[j])) * w[j];
+          c[(size_t)a * param.n_basis + k] = dot;
+          norm_c += std::norm(dot);
+        }
+      }
+#pragma omp critical
+      {
+        norm[0] += norm_v;
+        norm[1] += norm_c;
+      }
+    }
+    comm_allreduce_array(norm, 2);
+    if (norm[0] > 0.0) max_proj_res = std::max(max_proj_res, sqrt(std::max(norm[0] - norm[1], 0.0) / norm[0]));
+
+    // split the error budget evenly over the groups of all processes
+    const double budget = param.tol * param.tol * norm[0] / (static_cast<double>(n_group) * comm_size());
+    const int max_bits = precision == QUDA_DOUBLE_PRECISION ? 64 : 32;
+
+    coeff.bits.resize(n_group);
+    coeff.scale.resize(n_group);
+#pragma omp parallel for
+    for (int g = 0; g < n_group; g++) {
+      const int a = g / n_group_agg;
+      const int k0 = (g % n_group_agg) * group_size;
+      const int n = std::min(group_size, param.n_basis - k0);
+      const Complex *cg = c.data() + (size_t)a * param.n_basis + k0;
+
+      double s = 0.0;
+      for (int i = 0; i < n; i++) s = std::max(s, std::max(std::abs(cg[i].real()), std::abs(cg[i].imag())));
+      // round the scale up so the largest coefficient cannot overflow the fixed-point range
+      float scale = s;
+      if (scale < s) scale = std::nextafter(scale, std::numeric_limits<float>::max());
+      coeff.scale[g] = scale;
+
+      int bits = max_bits;
+      for (int i = 0; i < n_width && width[i] < max_bits; i++) {
+        if (s == 0.0 || quantizeError(cg, n, width[i], coeff.scale[g]) <= budget) {
+          bits = width[i];
+          break;
+        }
+      }
+      coeff.bits[g] = bits;
+    }
+
+    std::vector<size_t> offset(n_group + 1, 0);
+    for (int g = 0; g < n_group; g++) {
+      const int n = std::min(group_size, param.n_basis - (g % n_group_agg) * group_size);
+      offset[g + 1] = offset[g] + groupBytes(coeff.bits[g], n);
+      for (int i = 0; i < n_width; i++)
+        if (coeff.bits[g] == width[i]) group_count[i]++;
+    }
+
+    coeff.data.resize(offset[n_group]);
+#pragma omp parallel for
+    for (int g = 0; g < n_group; g++) {
+      const int a = g / n_group_agg;
+      const int k0 = (g % n_group_agg) * group_size;
+      const int n = std::min(group_size, param.n_basis - k0);
+      encode(c.data() + (size_t)a * param.n_basis + k0, n, coeff.bits[g], coeff.scale[g], coeff.data.data() + offset[g]);
+    }
+  }
+
+  template <typename Float> void CompressedVectorStore::expand(const Coefficients &coeff, Float *v_) const
+  {
+    std::complex<Float> *v = reinterpret_cast<std::complex<Float> *>(v_);
+    const std::complex<Float> *B = reinterpret_cast<const std::complex<Float> *>(basis.data());
+    const int site_length = nSpin * nColor;
+    const int n_group = n_agg * n_group_agg;
+
+    std::vector<size_t> offset(n_group + 1, 0);
+    for (int g = 0; g < n_group; g++) {
+      const int n = std::min(group_size, param.n_basis - (g % n_group_agg) * group_size);
+      offset[g + 1] = offset[g] + groupBytes(coeff.bits[g], n);
+    }
+
+#pragma omp parallel
+    {
+      std::vector<Complex> c(param.n_basis);
+      std::vector<Complex> w(agg_length);
+#pragma omp for
+      for (int a = 0; a < n_agg; a++) {
+        for (int gl = 0; gl < n_group_agg; gl++) {
+          const int g = a * n_group_agg + gl;
+          const int k0 = gl * group_size;
+          decode(coeff.data.data() + offset[g], std::min(group_size, param.n_basis - k0), coeff.bits[g], coeff.scale[g],
+                 c.data() + k0);
+        }
+
+        for (int j = 0; j < agg_length; j++) w[j] = 0.0;
+        for (int k = 0; k < param.n_basis; k++) {
+          if (c[k] == 0.0) continue;
+          const std::complex<Float> *Bk = B + ((size_t)a * param.n_basis + k) * agg_length;
+          for (int j = 0; j < agg_length; j++) w[j] += c[k] * Complex(Bk[j]);
+        }
+
+        const int b = a / n_chiral;
+        const int ch = a % n_chiral;
+        for (int s = 0; s < block_volume; s++) {
+          std::complex<Float> *dst = v + block_sites[b * block_volume + s] * site_length + ch * chiral_length;
+          for (int e = 0; e < chiral_length; e++) dst[e] = w[s * chiral_length + e];
+        }
+      }
+    }
+  }
+
+  void CompressedVectorStore::compress(const std::vector<ColorSpinorField *> &v)
+  {
+    if (param.n_basis <= 0) errorQuda("Invalid number of basis vectors %d", param.n_basis);
+    if ((int)v.size() < param.n_basis)
+      errorQuda("Number of vectors %lu less than the number of basis vectors %d", v.size(), param.n_basis);
+
+    int Y[4];
+    for (int d = 0; d < 4; d++) Y[d] = v[0]->X(d);
+    if (v[0]->SiteSubset() == QUDA_PARITY_SITE_SUBSET) Y[0] *= 2;
+    setGeometry(Y, v[0]->Ndim() == 5 ? v[0]->X(4) : 1, v[0]->SiteSubset(), v[0]->Ncolor(), v[0]->Nspin(),
+                v[0]->Precision() < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : v[0]->Precision());
+    basis.assign((size_t)n_agg * param.n_basis * agg_length * 2 * precision, 0);
+    coeff.resize(v.size());
+    max_proj_res = 0.0;
+    for (int i = 0; i < n_width; i++) group_count[i] = 0;
+
+    const bool stage = v[0]->Location() == QUDA_CUDA_FIELD_LOCATION || v[0]->Precision() != precision
+      || v[0]->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    ColorSpinorField *tmp = stage ? hostField(*v[0]) : nullptr;
+
+    for (int i = 0; i < (int)v.size(); i++) {
+      checkGeometry(*v[i]);
+      ColorSpinorField *h = v[i];
+      if (stage) {
+        *tmp = *v[i];
+        h = tmp;
+      }
+
+      // the vectors defining the basis are only projected onto the part built so far
+      if (precision == QUDA_DOUBLE_PRECISION) {
+        if (i < param.n_basis) addBasis(static_cast<const double *>(h->V()), i);
+        project(static_cast<const double *>(h->V()), std::min(i + 1, param.n_basis), coeff[i]);
+      } else {
+        if (i < param.n_basis) addBasis(static_cast<const float *>(h->V()), i);
+        project(static_cast<const float *>(h->V()), std::min(i + 1, param.n_basis), coeff[i]);
+      }
+    }
+    if (tmp) delete tmp;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      double bytes[2] = {static_cast<double>(Bytes()), static_cast<double>(VectorBytes())};
+      double count[n_width];
+      for (int i = 0; i < n_width; i++) count[i] = group_count[i];
+      comm_allreduce_array(bytes, 2);
+      comm_allreduce_array(count, n_width);
+      double n_group = 0.0;
+      for (int i = 0; i < n_width; i++) n_group += count[i];
+      printfQuda("Compressed %lu vectors with %d basis vectors per aggregate: compression ratio %.2f, projection "
+                 "residual %e\n",
+                 v.size(), param.n_basis, bytes[1] / bytes[0], max_proj_res);
+      printfQuda("Coefficient groups stored at 0/8/16/32/64 bits: %.1f%% %.1f%% %.1f%% %.1f%% %.1f%%\n",
+                 100 * count[0] / n_group, 100 * count[1] / n_group, 100 * count[2] / n_group,
+                 100 * count[3] / n_group, 100 * count[4] / n_group);
+    }
+  }
+
+  void CompressedVectorStore::reconstruct(std::vector<ColorSpinorField *> &v) const
+  {
+    if (v.size() > coeff.size()) errorQuda("Requested %lu vectors but only %lu are stored", v.size(), coeff.size());
+    if (v.size() == 0) return;
+
+    const bool stage = v[0]->Location() == QUDA_CUDA_FIELD_LOCATION || v[0]->Precision() != precision
+      || v[0]->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    ColorSpinorField *tmp = stage ? hostField(*v[0]) : nullptr;
+
+    for (int i = 0; i < (int)v.size(); i++) {
+      checkGeometry(*v[i]);
+      ColorSpinorField *h = stage ? tmp : v[i];
+      if (precision == QUDA_DOUBLE_PRECISION)
+        expand(coeff[i], static_cast<double *>(h->V()));
+      else
+        expand(coeff[i], static_cast<float *>(h->V()));
+      if (stage) *v[i] = *tmp;
+    }
+    if (tmp) delete tmp;
+  }
+
+  void CompressedVectorStore::save(const std::string &file) const
+  {
+    const std::string name = rankFile(file);
+    FILE *fp = fopen(name.c_str(), "wb");
+    if (!fp) errorQuda("Unable to open %s for writing", name.c_str());
+
+    int header[22];
+    for (int d = 0; d < 4; d++) {
+      header[d] = X[d];
+      header[4 + d] = comm_dim(d);
+      header[8 + d] = param.block_size[d];
+    }
+    header[12] = Ls;
+    header[13] = site_subset;
+    header[14] = nColor;
+    header[15] = nSpin;
+    header[16] = precision;
+    header[17] = param.n_basis;
+    header[18] = group_size;
+    header[19] = Nvec();
+    header[20] = 0;
+    header[21] = 0;
+
+    bool ok = fwrite(store_magic, sizeof(store_magic), 1, fp) == 1;
+    ok = ok && fwrite(header, sizeof(header), 1, fp) == 1;
+    ok = ok && fwrite(&param.tol, sizeof(double), 1, fp) == 1;
+    ok = ok && fwrite(basis.data(), basis.size(), 1, fp) == 1;
+    for (auto &c : coeff) {
+      const uint64_t data_bytes = c.data.size();
+      ok = ok && fwrite(&data_bytes, sizeof(data_bytes), 1, fp) == 1;
+      ok = ok && fwrite(c.bits.data(), c.bits.size(), 1, fp) == 1;
+      ok = ok && fwrite(c.scale.data(), c.scale.size() * sizeof(float), 1, fp) == 1;
+      ok = ok && (data_bytes == 0 || fwrite(c.data.data(), data_bytes, 1, fp) == 1);
+    }
+    if (!ok) errorQuda("Failed writing %s", name.c_str());
+    fclose(fp);
+  }
+
+  void CompressedVectorStore::load(const std::string &file)
+  {
+    const std::string name = rankFile(file);
+    FILE *fp = fopen(name.c_str(), "rb");
+    if (!fp) errorQuda("Unable to open %s for reading", name.c_str());
+
+    char magic[sizeof(store_magic)];
+    int header[22];
+    bool ok = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, store_magic, sizeof(magic)) == 0;
+    if (!ok) errorQuda("%s is not a compressed vector store", name.c_str());
+    ok = fread(header, sizeof(header), 1, fp) == 1;
+    ok = ok && fread(&param.tol, sizeof(double), 1, fp) == 1;
+    if (!ok) errorQuda("Failed reading the header of %s", name.c_str());
+
+    for (int d = 0; d < 4; d++) {
+      if (header[4 + d] != comm_dim(d))
+        errorQuda("Process grid dimension %d = %d does not match the stored %d", d, comm_dim(d), header[4 + d]);
+      param.block_size[d] = header[8 + d];
+    }
+    if (header[18] != group_size) errorQuda("Group size %d does not match %d", header[18], group_size);
+    param.n_basis = header[17];
+
+    setGeometry(header, header[12], static_cast<QudaSiteSubset>(header[13]), header[14], header[15],
+                static_cast<QudaPrecision>(header[16]));
+
+    basis.resize((size_t)n_agg * param.n_basis * agg_length * 2 * precision);
+    ok = fread(basis.data(), basis.size(), 1, fp) == 1;
+
+    const int n_group = n_agg * n_group_agg;
+    coeff.resize(header[19]);
+    for (auto &c : coeff) {
+      uint64_t data_bytes = 0;
+      c.bits.resize(n_group);
+      c.scale.resize(n_group);
+      ok = ok && fread(&data_bytes, sizeof(data_bytes), 1, fp) == 1;
+      ok = ok && fread(c.bits.data(), c.bits.size(), 1, fp) == 1;
+      ok = ok && fread(c.scale.data(), c.scale.size() * sizeof(float), 1, fp) == 1;
+      c.data.resize(data_bytes);
+      ok = ok && (data_bytes == 0 || fread(c.data.data(), data_bytes, 1, fp) == 1);
+    }
+    if (!ok) errorQuda("Failed reading %s", name.c_str());
+    fclose(fp);
+  }
+
+  bool CompressedVectorStore::isCompressed(const std::string &file)
+  {
+    FILE *fp = fopen(rankFile(file).c_str(), "rb");
+    if (!fp) return false;
+    char magic[sizeof(store_magic)];
+    const bool compressed = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, store_magic, sizeof(magic)) == 0;
+    fclose(fp);
+    return compressed;
+  }
+
+  size_t CompressedVectorStore::Bytes() const
+  {
+    size_t bytes = basis.size();
+    for (auto &c : coeff) bytes += sizeof(uint64_t) + c.bits.size() + c.scale.size() * sizeof(float) + c.data.size();
+    return bytes;
+  }
+
+  size_t CompressedVectorStore::VectorBytes() const
+  {
+    return coeff.size() * block_sites.size() * nSpin * nColor * 2 * precision;
+  }
+
+} // namespace quda
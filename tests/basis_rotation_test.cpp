@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <eigensolve_quda.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the single pass basis rotation used by the thick
+// restarted eigensolvers, V_new = V_old * Q, against the one multi-blas
+// call per output vector it replaces, and benchmarks both on host
+// fields.  The basis size and number of kept vectors are taken from
+// --eig-nKr and --eig-nEv.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern int niter;
+extern int eig_nEv;
+extern int eig_nKr;
+extern void usage(char **argv);
+
+ColorSpinorParam csParam;
+
+class BasisRotationTest : public ::testing::Test
+{
+protected:
+  std::vector<ColorSpinorField *> kSpace;
+  std::vector<ColorSpinorField *> ref;
+  std::vector<Complex> rot;
+  int dim;
+  int keep;
+
+  void SetUp()
+  {
+    dim = eig_nKr;
+    keep = eig_nEv;
+    for (int i = 0; i < dim; i++) {
+      kSpace.push_back(ColorSpinorField::Create(csParam));
+      kSpace.back()->Source(QUDA_RANDOM_SOURCE);
+    }
+    for (int i = 0; i < keep; i++) ref.push_back(ColorSpinorField::Create(csParam));
+
+    // columns of unit norm on average, so repeated rotation neither grows nor decays the basis
+    rot.resize(dim * keep);
+    const double scale = sqrt(6.0 / dim);
+    for (auto &r : rot) r = scale * Complex(rand() / (double)RAND_MAX - 0.5, rand() / (double)RAND_MAX - 0.5);
+  }
+
+  void TearDown()
+  {
+    for (auto &v : kSpace) delete v;
+    for (auto &v : ref) delete v;
+  }
+
+  // one multi-blas call per output vector, each of which reads the whole basis
+  void rotatePerVector()
+  {
+    std::vector<ColorSpinorField *> basis(kSpace.begin(), kSpace.begin() + dim);
+    std::vector<Complex> col(dim);
+    for (int i = 0; i < keep; i++) {
+      for (int j = 0; j < dim; j++) col[j] = rot[j * keep + i];
+      std::vector<ColorSpinorField *> y(1, ref[i]);
+      blas::zero(*ref[i]);
+      blas::caxpy(col.data(), basis, y);
+    }
+  }
+};
+
+TEST_F(BasisRotationTest, verify)
+{
+  rotatePerVector();
+  EigenSolver::rotateVecs(kSpace, rot.data(), dim, dim, keep, 0);
+
+  const double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5;
+  for (int i = 0; i < keep; i++) {
+    const double ref_norm = blas::norm2(*ref[i]);
+    blas::axpy(-1.0, *kSpace[i], *ref[i]);
+    EXPECT_LE(sqrt(blas::norm2(*ref[i]) / ref_norm), tol) << "vector " << i;
+  }
+}
+
+TEST_F(BasisRotationTest, real)
+{
+  // the real rotation must agree with the complex one when the latter is real
+  std::vector<double> rot_re(dim * keep);
+  for (int i = 0; i < dim * keep; i++) {
+    rot_re[i] = rot[i].real();
+    rot[i] = Complex(rot[i].real(), 0.0);
+  }
+
+  std::vector<ColorSpinorField *> copy;
+  for (int i = 0; i < dim; i++) {
+    copy.push_back(ColorSpinorField::Create(csParam));
+    *copy[i] = *kSpace[i];
+  }
+
+  EigenSolver::rotateVecs(kSpace, rot_re.data(), dim, dim, keep, 0);
+  EigenSolver::rotateVecs(copy, rot.data(), dim, dim, keep, 0);
+
+  const double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5;
+  for (int i = 0; i < keep; i++) {
+    const double norm = blas::norm2(*copy[i]);
+    blas::axpy(-1.0, *kSpace[i], *copy[i]);
+    EXPECT_LE(sqrt(blas::norm2(*copy[i]) / norm), tol) << "vector " << i;
+  }
+  for (auto &v : copy) delete v;
+}
+
+TEST_F(BasisRotationTest, benchmark)
+{
+  // warm up the tuned tile sizes of both paths
+  rotatePerVector();
+  EigenSolver::rotateVecs(kSpace, rot.data(), dim, dim, keep, 0);
+
+  quda::Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) rotatePerVector();
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double per_vector_secs = timer.Last() / niter;
+
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) EigenSolver::rotateVecs(kSpace, rot.data(), dim, dim, keep, 0);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double single_pass_secs = timer.Last() / niter;
+
+  printfQuda("Basis rotation %d -> %d vectors: per vector %.3f ms, single pass %.3f ms (%.1fx)\n", dim, keep,
+             1e3 * per_vector_secs, 1e3 * single_pass_secs, per_vector_secs / single_pass_secs);
+  RecordProperty("PerVectorMs", std::to_string(1e3 * per_vector_secs));
+  RecordProperty("SinglePassMs", std::to_string(1e3 * single_pass_secs));
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  if (eig_nEv > eig_nKr) errorQuda("Number of kept vectors %d exceeds basis size %d", eig_nEv, eig_nKr);
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+
+  // host fields only
+  if (prec != QUDA_DOUBLE_PRECISION) prec = QUDA_SINGLE_PRECISION;
+
+  int X[4] = {xdim, ydim, zdim, tdim};
+  setDims(X);
+
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+  csParam.x[0] /= 2;
+  csParam.setPrecision(prec);
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_PARITY_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  csParam.location = QUDA_CPU_FIELD_LOCATION;
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -45,6 +45,9 @@ std::vector<cpuColorSpinorField*> zmH;
 int Nspin;
 int Ncolor;
 
+// used for timing the host kernels
+quda::Timer host_timer;
+
 void setPrec(ColorSpinorParam &param, const QudaPrecision precision)
 {
   param.setPrecision(precision);
@@ -98,6 +101,17 @@ bool skip_kernel(int precision, int kernel) {
   return false;
 }
 
+bool skip_host_kernel(int precision, int kernel)
+{
+  // the host fields are always double precision so only run these once
+  if (getPrecision(precision) != QUDA_DOUBLE_PRECISION) return true;
+
+  // mixed-precision copies are meaningless with double-precision host fields
+  if (kernel == 1 || kernel == 2) return true;
+
+  return false;
+}
+
 void initFields(int prec)
 {
   // precisions used for the source field in the copyCuda() benchmark
@@ -300,7 +314,27 @@ void freeFields()
 }
 
 
-double benchmark(int kernel, const int niter) {
+double benchmark(int kernel, const int niter, bool host = false)
+{
+  // select whether we are benchmarking the device or the host fields
+  ColorSpinorField &x = host ? *xH : *xD;
+  ColorSpinorField &y = host ? *yH : *yD;
+  ColorSpinorField &z = host ? *zH : *zD;
+  ColorSpinorField &w = host ? *wH : *wD;
+  ColorSpinorField &v = host ? *vH : *vD;
+  ColorSpinorField &h = host ? *hH : *hD;
+  ColorSpinorField &m = host ? *mH : *mD;
+  ColorSpinorField &l = host ? *lH : *lD;
+  std::vector<ColorSpinorField *> xm, ym, zm;
+  if (host) {
+    xm.assign(xmH.begin(), xmH.end());
+    ym.assign(ymH.begin(), ymH.end());
+    zm.assign(zmH.begin(), zmH.end());
+  } else {
+    xm = xmD->Components();
+    ym = ymD->Components();
+    zm = zmD->Components();
+  }
 
   double a = 1.0, b = 2.0, c = 3.0;
   quda::Complex a2, b2;
@@ -314,183 +348,184 @@ double benchmark(int kernel, const int niter) {
   cudaEventCreate(&start);
   cudaEventCreate(&end);
   cudaEventRecord(start, 0);
+  host_timer.Start(__func__, __FILE__, __LINE__);
 
   {
     switch (kernel) {
 
     case 0:
-      for (int i=0; i < niter; ++i) blas::copy(*yD, *hD);
+      for (int i=0; i < niter; ++i) blas::copy(y, h);
       break;
 
     case 1:
-      for (int i=0; i < niter; ++i) blas::copy(*yD, *mD);
+      for (int i=0; i < niter; ++i) blas::copy(y, m);
       break;
 
     case 2:
-      for (int i=0; i < niter; ++i) blas::copy(*yD, *lD);
+      for (int i=0; i < niter; ++i) blas::copy(y, l);
       break;
 
     case 3:
-      for (int i=0; i < niter; ++i) blas::axpby(a, *xD, b, *yD);
+      for (int i=0; i < niter; ++i) blas::axpby(a, x, b, y);
       break;
 
     case 4:
-      for (int i=0; i < niter; ++i) blas::xpy(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::xpy(x, y);
       break;
 
     case 5:
-      for (int i=0; i < niter; ++i) blas::axpy(a, *xD, *yD);
+      for (int i=0; i < niter; ++i) blas::axpy(a, x, y);
       break;
 
     case 6:
-      for (int i=0; i < niter; ++i) blas::xpay(*xD, a, *yD);
+      for (int i=0; i < niter; ++i) blas::xpay(x, a, y);
       break;
 
     case 7:
-      for (int i=0; i < niter; ++i) blas::mxpy(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::mxpy(x, y);
       break;
 
     case 8:
-      for (int i=0; i < niter; ++i) blas::ax(a, *xD);
+      for (int i=0; i < niter; ++i) blas::ax(a, x);
       break;
 
     case 9:
-      for (int i=0; i < niter; ++i) blas::caxpy(a2, *xD, *yD);
+      for (int i=0; i < niter; ++i) blas::caxpy(a2, x, y);
       break;
 
     case 10:
-      for (int i=0; i < niter; ++i) blas::caxpby(a2, *xD, b2, *yD);
+      for (int i=0; i < niter; ++i) blas::caxpby(a2, x, b2, y);
       break;
 
     case 11:
-      for (int i=0; i < niter; ++i) blas::cxpaypbz(*xD, a2, *yD, b2, *zD);
+      for (int i=0; i < niter; ++i) blas::cxpaypbz(x, a2, y, b2, z);
       break;
 
     case 12:
-      for (int i=0; i < niter; ++i) blas::axpyBzpcx(a, *xD, *yD, b, *zD, c);
+      for (int i=0; i < niter; ++i) blas::axpyBzpcx(a, x, y, b, z, c);
       break;
 
     case 13:
-      for (int i=0; i < niter; ++i) blas::axpyZpbx(a, *xD, *yD, *zD, b);
+      for (int i=0; i < niter; ++i) blas::axpyZpbx(a, x, y, z, b);
       break;
 
     case 14:
-      for (int i=0; i < niter; ++i) blas::caxpbypzYmbw(a2, *xD, b2, *yD, *zD, *wD);
+      for (int i=0; i < niter; ++i) blas::caxpbypzYmbw(a2, x, b2, y, z, w);
       break;
 
     case 15:
-      for (int i=0; i < niter; ++i) blas::cabxpyAx(a, b2, *xD, *yD);
+      for (int i=0; i < niter; ++i) blas::cabxpyAx(a, b2, x, y);
       break;
 
     case 16:
-      for (int i=0; i < niter; ++i) blas::caxpyXmaz(a2, *xD, *yD, *zD);
+      for (int i=0; i < niter; ++i) blas::caxpyXmaz(a2, x, y, z);
       break;
 
       // double
     case 17:
-      for (int i=0; i < niter; ++i) blas::norm2(*xD);
+      for (int i=0; i < niter; ++i) blas::norm2(x);
       break;
 
     case 18:
-      for (int i=0; i < niter; ++i) blas::reDotProduct(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::reDotProduct(x, y);
       break;
 
     case 19:
-      for (int i=0; i < niter; ++i) blas::axpyNorm(a, *xD, *yD);
+      for (int i=0; i < niter; ++i) blas::axpyNorm(a, x, y);
       break;
 
     case 20:
-      for (int i=0; i < niter; ++i) blas::xmyNorm(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::xmyNorm(x, y);
       break;
 
     case 21:
-      for (int i=0; i < niter; ++i) blas::caxpyNorm(a2, *xD, *yD);
+      for (int i=0; i < niter; ++i) blas::caxpyNorm(a2, x, y);
       break;
 
     case 22:
-      for (int i=0; i < niter; ++i) blas::caxpyXmazNormX(a2, *xD, *yD, *zD);
+      for (int i=0; i < niter; ++i) blas::caxpyXmazNormX(a2, x, y, z);
       break;
 
     case 23:
-      for (int i=0; i < niter; ++i) blas::cabxpyzAxNorm(a, b2, *xD, *yD, *yD);
+      for (int i=0; i < niter; ++i) blas::cabxpyzAxNorm(a, b2, x, y, y);
       break;
 
     // double2
     case 24:
-      for (int i=0; i < niter; ++i) blas::cDotProduct(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::cDotProduct(x, y);
       break;
 
     case 25:
-      for (int i=0; i < niter; ++i) blas::caxpyDotzy(a2, *xD, *yD, *zD);
+      for (int i=0; i < niter; ++i) blas::caxpyDotzy(a2, x, y, z);
       break;
 
     // double3
     case 26:
-      for (int i=0; i < niter; ++i) blas::cDotProductNormA(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::cDotProductNormA(x, y);
       break;
 
     case 27:
-      for (int i=0; i < niter; ++i) blas::cDotProductNormB(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::cDotProductNormB(x, y);
       break;
 
     case 28:
-      for (int i=0; i < niter; ++i) blas::caxpbypzYmbwcDotProductUYNormY(a2, *xD, b2, *yD, *zD, *wD, *vD);
+      for (int i=0; i < niter; ++i) blas::caxpbypzYmbwcDotProductUYNormY(a2, x, b2, y, z, w, v);
       break;
 
     case 29:
-      for (int i=0; i < niter; ++i) blas::HeavyQuarkResidualNorm(*xD, *yD);
+      for (int i=0; i < niter; ++i) blas::HeavyQuarkResidualNorm(x, y);
       break;
 
     case 30:
-      for (int i=0; i < niter; ++i) blas::xpyHeavyQuarkResidualNorm(*xD, *yD, *zD);
+      for (int i=0; i < niter; ++i) blas::xpyHeavyQuarkResidualNorm(x, y, z);
       break;
 
     case 31:
-      for (int i=0; i < niter; ++i) blas::tripleCGReduction(*xD, *yD, *zD);
+      for (int i=0; i < niter; ++i) blas::tripleCGReduction(x, y, z);
       break;
 
     case 32:
-      for (int i=0; i < niter; ++i) blas::tripleCGUpdate(a, b, *xD, *yD, *zD, *wD);
+      for (int i=0; i < niter; ++i) blas::tripleCGUpdate(a, b, x, y, z, w);
       break;
 
     case 33:
-      for (int i=0; i < niter; ++i) blas::axpyReDot(a, *xD, *yD);
+      for (int i=0; i < niter; ++i) blas::axpyReDot(a, x, y);
       break;
 
     case 34:
-      for (int i=0; i < niter; ++i) blas::caxpy(A, *xmD,* ymD);
+      for (int i=0; i < niter; ++i) blas::caxpy(A, xm, ym);
       break;
 
     case 35:
-      for (int i=0; i < niter; ++i) blas::axpyBzpcx((double*)A, xmD->Components(), zmD->Components(), (double*)B, *yD, (double*)C);
+      for (int i=0; i < niter; ++i) blas::axpyBzpcx((double*)A, xm, zm, (double*)B, y, (double*)C);
       break;
 
     case 36:
-      for (int i=0; i < niter; ++i) blas::caxpyBxpz(a2, *xD, *yD, b2, *zD);
+      for (int i=0; i < niter; ++i) blas::caxpyBxpz(a2, x, y, b2, z);
       break;
 
     case 37:
-      for (int i=0; i < niter; ++i) blas::caxpyBzpx(a2, *xD, *yD, b2, *zD);
+      for (int i=0; i < niter; ++i) blas::caxpyBzpx(a2, x, y, b2, z);
       break;
 
     case 38:
-      for (int i=0; i < niter; ++i) blas::cDotProduct(A2, xmD->Components(), xmD->Components());
+      for (int i=0; i < niter; ++i) blas::cDotProduct(A2, xm, xm);
       break;
 
     case 39:
-      for (int i=0; i < niter; ++i) blas::cDotProduct(A, xmD->Components(), ymD->Components());
+      for (int i=0; i < niter; ++i) blas::cDotProduct(A, xm, ym);
       break;
 
     case 40:
-      for (int i=0; i < niter; ++i) blas::reDotProduct((double*)A2, xmD->Components(), xmD->Components());
+      for (int i=0; i < niter; ++i) blas::reDotProduct((double*)A2, xm, xm);
       break;
 
     case 41:
-      for (int i=0; i < niter; ++i) blas::reDotProduct((double*)A, xmD->Components(), ymD->Components());
+      for (int i=0; i < niter; ++i) blas::reDotProduct((double*)A, xm, ym);
       break;
 
     case 42:
-      for (int i = 0; i < niter; ++i) blas::axpy(Ar, xmD->Components(), ymD->Components());
+      for (int i = 0; i < niter; ++i) blas::axpy(Ar, xm, ym);
       break;
 
     default:
@@ -500,6 +535,7 @@ double benchmark(int kernel, const int niter) {
 
   cudaEventRecord(end, 0);
   cudaEventSynchronize(end);
+  host_timer.Stop(__func__, __FILE__, __LINE__);
   float runTime;
   cudaEventElapsedTime(&runTime, start, end);
   cudaEventDestroy(start);
@@ -509,7 +545,7 @@ double benchmark(int kernel, const int niter) {
   delete[] C;
   delete[] A2;
   delete[] Ar;
-  double secs = runTime / 1000;
+  double secs = host ? host_timer.last : runTime / 1000;
   return secs;
 }
 
@@ -1128,6 +1164,92 @@ TEST_P(BlasTest, benchmark) {
   printfQuda("%-31s: Gflop/s = %6.1f, GB/s = %6.1f\n", names[kernel], gflops, gbytes);
 }
 
+/**
+   Measure the host memory bandwidth attainable with a simple
+   threaded copy (the STREAM copy kernel).  This is the roofline
+   against which the host blas kernels are measured.
+ */
+double hostStreamBandwidth(const int niter)
+{
+  const size_t n = xH->Bytes() / sizeof(double);
+  const double *a = static_cast<const double *>(xH->V());
+  double *b = static_cast<double *>(yH->V());
+
+  host_timer.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) {
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++) b[i] = a[i];
+  }
+  host_timer.Stop(__func__, __FILE__, __LINE__);
+
+  return 2.0 * n * sizeof(double) * niter / (host_timer.last * 1e9);
+}
+
+/**
+   Time the host block kernels computed instead as repeated single
+   blas calls, one per (x, y) pair.  This is the baseline against
+   which the tiled host kernels, which stream each vector once, are
+   measured.  Returns zero if the kernel has no such decomposition.
+ */
+double benchmarkHostRepeated(int kernel, const int niter)
+{
+  if (kernel != 34 && kernel != 39 && kernel != 41 && kernel != 42) return 0.0;
+
+  quda::Complex *A = new quda::Complex[Nsrc * Msrc]();
+  double *Ar = new double[Nsrc * Msrc]();
+
+  host_timer.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) {
+    for (int i = 0; i < Nsrc; i++) {
+      for (int j = 0; j < Msrc; j++) {
+        switch (kernel) {
+        case 34: blas::caxpy(A[Msrc * i + j], *xmH[i], *ymH[j]); break;
+        case 39: A[Msrc * i + j] = blas::cDotProduct(*xmH[i], *ymH[j]); break;
+        case 41: Ar[Msrc * i + j] = blas::reDotProduct(*xmH[i], *ymH[j]); break;
+        case 42: blas::axpy(Ar[Msrc * i + j], *xmH[i], *ymH[j]); break;
+        }
+      }
+    }
+  }
+  host_timer.Stop(__func__, __FILE__, __LINE__);
+
+  delete[] A;
+  delete[] Ar;
+  return host_timer.last;
+}
+
+TEST_P(BlasTest, benchmark_host)
+{
+  int prec = ::testing::get<0>(GetParam());
+  int kernel = ::testing::get<1>(GetParam());
+  if (skip_kernel(prec, kernel) || skip_host_kernel(prec, kernel)) GTEST_SKIP();
+
+  double stream_gbytes = hostStreamBandwidth(niter);
+
+  // warm up
+  benchmark(kernel, 1, true);
+
+  quda::blas::flops = 0;
+  quda::blas::bytes = 0;
+
+  double secs = benchmark(kernel, niter, true);
+
+  double gflops = (quda::blas::flops * 1e-9) / (secs);
+  double gbytes = quda::blas::bytes / (secs * 1e9);
+  RecordProperty("Gflops", std::to_string(gflops));
+  RecordProperty("GBs", std::to_string(gbytes));
+  RecordProperty("StreamGBs", std::to_string(stream_gbytes));
+  printfQuda("%-31s: Gflop/s = %6.1f, GB/s = %6.1f (%5.1f%% of host copy bandwidth %6.1f GB/s)\n", names[kernel],
+             gflops, gbytes, 100.0 * gbytes / stream_gbytes, stream_gbytes);
+
+  double secs_repeated = benchmarkHostRepeated(kernel, niter);
+  if (secs_repeated > 0.0) {
+    RecordProperty("TileSpeedup", std::to_string(secs_repeated / secs));
+    printfQuda("%-31s: %5.2fx faster than %d x %d single blas calls\n", names[kernel], secs_repeated / secs, Nsrc,
+               Msrc);
+  }
+}
+
 std::string getblasname(testing::TestParamInfo<::testing::tuple<int, int>> param){
   int prec = ::testing::get<0>(param.param);
   int kernel = ::testing::get<1>(param.param);
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <host_dirac_matrix.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the block CG solver against the Wilson normal
+// operator applied by the host reference dslash, so the solver runs
+// end to end on host fields.  The number of sources is taken from
+// --nsrc (default 12, a spin-colour propagator), the precisions from
+// --prec and --prec-sloppy and the tolerance from --tol.  The benchmark
+// compares the block solve against solving the sources independently,
+// repeated --niter times.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern QudaPrecision prec_sloppy;
+extern QudaMatPCType matpc_type;
+extern QudaVerbosity verbosity;
+extern int Nsrc;
+extern int niter;
+extern double kappa;
+extern double tol;
+extern double reliable_delta;
+extern void usage(char **argv);
+
+ColorSpinorParam csParam;
+QudaGaugeParam gauge_param;
+void *hostGauge[2][4]; // double and single precision copies
+
+class BlockCGTest : public ::testing::Test
+{
+protected:
+  std::vector<ColorSpinorField *> b;
+  std::vector<ColorSpinorField *> x;
+  int n_src;
+  HostWilsonMatrix *mat;
+  QudaInvertParam inv_param;
+  TimeProfile profile;
+
+  BlockCGTest() : profile("BlockCGTest") {}
+
+  void SetUp()
+  {
+    n_src = Nsrc > 1 ? Nsrc : 12;
+    for (int i = 0; i < n_src; i++) {
+      b.push_back(ColorSpinorField::Create(csParam));
+      b.back()->Source(QUDA_RANDOM_SOURCE);
+      x.push_back(ColorSpinorField::Create(csParam));
+    }
+    mat = new HostWilsonMatrix(hostGauge, gauge_param, kappa > 0.0 ? kappa : 0.12, matpc_type, true);
+
+    inv_param = newQudaInvertParam();
+    inv_param.inv_type = QUDA_CG_INVERTER;
+    inv_param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+    inv_param.tol = tol;
+    inv_param.maxiter = 10000;
+    inv_param.reliable_delta = reliable_delta;
+    inv_param.max_res_increase = 1;
+    inv_param.cuda_prec = prec;
+    inv_param.cuda_prec_sloppy = prec_sloppy;
+    inv_param.num_src = n_src;
+    inv_param.use_sloppy_partial_accumulator = 0;
+    inv_param.iter = 0;
+    inv_param.secs = 0;
+    inv_param.gflops = 0;
+  }
+
+  void TearDown()
+  {
+    for (auto &v : b) delete v;
+    for (auto &v : x) delete v;
+    delete mat;
+  }
+
+  // |b - A x| / |b| computed independently of the solver
+  double residual(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    ColorSpinorField *r = ColorSpinorField::Create(csParam);
+    (*mat)(*r, x);
+    double r2 = blas::xmyNorm(b, *r);
+    delete r;
+    return sqrt(r2 / blas::norm2(b));
+  }
+
+  // solve with the block solver, returning the number of block iterations
+  int solve(std::vector<ColorSpinorField *> &x, std::vector<ColorSpinorField *> &b)
+  {
+    for (auto v : x) blas::zero(*v);
+    SolverParam param(inv_param);
+    BlockCG bcg(*mat, *mat, param, profile);
+    bcg.solve(x, b);
+    return param.iter;
+  }
+};
+
+TEST_F(BlockCGTest, verify)
+{
+  const int iter = solve(x, b);
+  EXPECT_GT(iter, 0);
+  for (int i = 0; i < n_src; i++) EXPECT_LE(residual(*x[i], *b[i]), 2 * tol) << "source " << i;
+}
+
+TEST_F(BlockCGTest, rankDeficient)
+{
+  // the second half of the sources are linear combinations of the
+  // first half, including an exact duplicate, so the block residual
+  // is rank deficient from the outset
+  const int h = std::max(n_src / 2, 1);
+  for (int i = h; i < n_src; i++) {
+    blas::copy(*b[i], *b[i - h]);
+    if (i > h) blas::caxpy(Complex(0.5, -1.0), *b[(i - h + 1) % h], *b[i]);
+  }
+
+  const int iter = solve(x, b);
+  EXPECT_LT(iter, inv_param.maxiter);
+  for (int i = 0; i < n_src; i++) EXPECT_LE(residual(*x[i], *b[i]), 2 * tol) << "source " << i;
+}
+
+TEST_F(BlockCGTest, benchmark)
+{
+  quda::Timer timer;
+  int block_iter = 0;
+  mat->resetApplications();
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int k = 0; k < niter; k++) block_iter = solve(x, b);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double block_secs = timer.Last() / niter;
+  const long long block_matvecs = mat->Applications() / niter;
+
+  // the same sources solved one at a time, for which block CG is CG
+  int max_iter = 0, total_iter = 0;
+  mat->resetApplications();
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int k = 0; k < niter; k++) {
+    max_iter = total_iter = 0;
+    for (int i = 0; i < n_src; i++) {
+      std::vector<ColorSpinorField *> x_i(1, x[i]), b_i(1, b[i]);
+      int iter = solve(x_i, b_i);
+      max_iter = std::max(max_iter, iter);
+      total_iter += iter;
+    }
+  }
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double independent_secs = timer.Last() / niter;
+  const long long independent_matvecs = mat->Applications() / niter;
+
+  printfQuda("%d sources: block CG %d iterations, %lld matvecs, %.3f s; independent CG %d iterations (max %d), %lld "
+             "matvecs, %.3f s\n",
+             n_src, block_iter, block_matvecs, block_secs, total_iter, max_iter, independent_matvecs,
+             independent_secs);
+  RecordProperty("BlockIterations", block_iter);
+  RecordProperty("IndependentMaxIterations", max_iter);
+  RecordProperty("BlockMatVecs", std::to_string(block_matvecs));
+  RecordProperty("IndependentMatVecs", std::to_string(independent_matvecs));
+  RecordProperty("BlockSecs", std::to_string(block_secs));
+  RecordProperty("IndependentSecs", std::to_string(independent_secs));
+
+  // the block Krylov space contains that of each source
+  EXPECT_LE(block_iter, max_iter);
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  initHostWilson(hostGauge, gauge_param, csParam, X, prec, prec_sloppy);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  freeHostWilson(hostGauge);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -4,6 +4,7 @@
 #include <math.h>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 #include <util_quda.h>
 #include <test_util.h>
@@ -87,6 +88,10 @@ extern QudaExtLibType   deflation_ext_lib;
 
 extern QudaFieldLocation location_ritz;
 extern QudaMemoryType    mem_type_ritz;
+extern int ritz_resident_dim;
+extern QudaPrecision prec_ritz_spill;
+extern QudaPrecision prec_recycle;
+extern bool recycle_keep_on_update;
 
 extern QudaMassNormalization normalization; // mass normalization of Dirac operators
 extern QudaVerbosity verbosity;
@@ -230,7 +235,8 @@ void setInvertParam(QudaInvertParam &inv_param) {
   inv_param.solve_type = solve_type;
   inv_param.matpc_type = matpc_type;
 
-  if (inv_type != QUDA_EIGCG_INVERTER && inv_type != QUDA_INC_EIGCG_INVERTER && inv_type != QUDA_GMRESDR_INVERTER)
+  if (inv_type != QUDA_EIGCG_INVERTER && inv_type != QUDA_INC_EIGCG_INVERTER && inv_type != QUDA_GMRESDR_INVERTER
+      && inv_type != QUDA_GCRODR_INVERTER)
     errorQuda("Unknown deflated solver type %d.", inv_type);
 
   //! For deflated solvers only:
@@ -255,6 +261,11 @@ void setInvertParam(QudaInvertParam &inv_param) {
   }else if(inv_param.inv_type == QUDA_GMRESDR_INVERTER) {
     inv_param.solve_type = QUDA_DIRECT_PC_SOLVE;
     inv_param.tol_restart = 0.0;//restart is not requested...
+  } else if (inv_param.inv_type == QUDA_GCRODR_INVERTER) {
+    // the recycled subspace is carried over from one source to the next
+    inv_param.solve_type = QUDA_DIRECT_PC_SOLVE;
+    inv_param.cuda_prec_recycle = prec_recycle;
+    inv_param.recycle_keep_on_update = recycle_keep_on_update ? 1 : 0;
   }
 
   inv_param.cuda_prec_ritz = cuda_prec_ritz;
@@ -296,6 +307,8 @@ void setDeflationParam(QudaEigParam &df_param) {
   df_param.cuda_prec_ritz = prec_ritz;
   df_param.location       = location_ritz;
   df_param.mem_type_ritz  = mem_type_ritz;
+  df_param.ritz_resident_dim = ritz_resident_dim;
+  df_param.ritz_spill_precision = prec_ritz_spill;
 
   // set file i/o parameters
   strcpy(df_param.vec_infile, eig_vec_infile);
@@ -440,6 +453,8 @@ int main(int argc, char **argv)
   void *df_preconditioner  = newDeflationQuda(&df_param);
   inv_param.deflation_op   = df_preconditioner;
 
+  std::vector<int> iter(Nsrc);
+
   for (int i=0; i<Nsrc; i++) {
     // create a point source at 0 (in each subvolume...  FIXME)
     memset(spinorIn, 0, inv_param.Ls*V*spinorSiteSize*sSize);
@@ -455,9 +470,15 @@ int main(int argc, char **argv)
     }
 
     invertQuda(spinorOut, spinorIn, &inv_param);
+    iter[i] = inv_param.iter;
     printfQuda("\nDone for %d rhs.\n", inv_param.rhs_idx);
   }
 
+  // iteration reduction over the sequence of solves
+  for (int i = 0; i < Nsrc; i++)
+    printfQuda("Source %d: %d iterations (%.1f%% of the first solve)\n", i, iter[i], 100.0 * iter[i] / iter[0]);
+  if (inv_param.inv_type == QUDA_GCRODR_INVERTER) flushRecycleQuda();
+
   destroyDeflationQuda(df_preconditioner);
 
   // stop the timer
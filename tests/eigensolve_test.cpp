@@ -82,16 +82,23 @@ extern bool eig_use_poly_acc;
 extern int eig_poly_deg;
 extern double eig_amin;
 extern double eig_amax;
+extern bool eig_poly_acc_auto;
+extern double eig_poly_acc_rate;
 extern bool eig_use_normop;
 extern bool eig_use_dagger;
 extern bool eig_compute_svd;
 extern QudaEigSpectrumType eig_spectrum;
 extern QudaEigType eig_type;
+extern int eig_block_size;
+extern bool eig_benchmark;
 extern bool eig_arpack_check;
 extern char eig_arpack_logfile[];
 extern char eig_QUDA_logfile[];
 extern char eig_vec_infile[];
 extern char eig_vec_outfile[];
+extern int eig_vec_compress_n_basis;
+extern int eig_vec_compress_block[4];
+extern double eig_vec_compress_tol;
 
 extern bool verify_results;
 
@@ -111,6 +118,7 @@ void display_test_info()
 
   printfQuda("\n   Eigensolver parameters\n");
   printfQuda(" - solver mode %s\n", get_eig_type_str(eig_type));
+  if (eig_type == QUDA_EIG_BLK_TR_LANCZOS) printfQuda(" - block size %d\n", eig_block_size);
   printfQuda(" - spectrum requested %s\n", get_eig_spectrum_str(eig_spectrum));
   printfQuda(" - number of eigenvectors requested %d\n", eig_nConv);
   printfQuda(" - size of eigenvector search space %d\n", eig_nEv);
@@ -127,7 +135,10 @@ void display_test_info()
     printfQuda(" - Operator: daggered (%s) , norm-op (%s)\n", eig_use_dagger ? "true" : "false",
                eig_use_normop ? "true" : "false");
   }
-  if (eig_use_poly_acc) {
+  if (eig_use_poly_acc && eig_poly_acc_auto) {
+    printfQuda(" - Chebyshev polynomial estimated, maximum degree %d\n", eig_poly_deg);
+    printfQuda(" - Chebyshev polynomial target rate %e\n\n", eig_poly_acc_rate);
+  } else if (eig_use_poly_acc) {
     printfQuda(" - Chebyshev polynomial degree %d\n", eig_poly_deg);
     printfQuda(" - Chebyshev polynomial minumum %e\n", eig_amin);
     printfQuda(" - Chebyshev polynomial maximum %e\n\n", eig_amax);
@@ -288,7 +299,7 @@ void setEigParam(QudaEigParam &eig_param)
 {
   eig_param.eig_type = eig_type;
   eig_param.spectrum = eig_spectrum;
-  if ((eig_type == QUDA_EIG_TR_LANCZOS || eig_type == QUDA_EIG_IR_LANCZOS)
+  if ((eig_type == QUDA_EIG_TR_LANCZOS || eig_type == QUDA_EIG_BLK_TR_LANCZOS || eig_type == QUDA_EIG_IR_LANCZOS)
       && !(eig_spectrum == QUDA_SPECTRUM_LR_EIG || eig_spectrum == QUDA_SPECTRUM_SR_EIG)) {
     errorQuda("Only real spectrum type (LR or SR) can be passed to Lanczos type solver");
   }
@@ -307,6 +318,7 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.require_convergence = eig_require_convergence ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
   eig_param.check_interval = eig_check_interval;
   eig_param.max_restarts = eig_max_restarts;
+  eig_param.block_size = eig_block_size;
   eig_param.cuda_prec_ritz = cuda_prec;
 
   eig_param.use_norm_op = eig_use_normop ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
@@ -321,6 +333,8 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.poly_deg = eig_poly_deg;
   eig_param.a_min = eig_amin;
   eig_param.a_max = eig_amax;
+  eig_param.poly_acc_auto = eig_poly_acc_auto ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
+  eig_param.poly_acc_rate = eig_poly_acc_rate;
 
   eig_param.arpack_check = eig_arpack_check ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
   strcpy(eig_param.arpack_logfile, eig_arpack_logfile);
@@ -328,6 +342,9 @@ void setEigParam(QudaEigParam &eig_param)
 
   strcpy(eig_param.vec_infile, eig_vec_infile);
   strcpy(eig_param.vec_outfile, eig_vec_outfile);
+  eig_param.vec_compress_n_basis = eig_vec_compress_n_basis;
+  for (int d = 0; d < 4; d++) eig_param.vec_compress_block_size[d] = eig_vec_compress_block[d];
+  eig_param.vec_compress_tol = eig_vec_compress_tol;
 }
 
 int main(int argc, char **argv)
@@ -449,6 +466,23 @@ int main(int argc, char **argv)
   time += (double)clock();
   printfQuda("Time for %s solution = %f\n", eig_param.arpack_check ? "ARPACK" : "QUDA", time / CLOCKS_PER_SEC);
 
+  // Rerun the same problem with the single vector TRLM and compare the
+  // number of operator applications and the time to convergence
+  if (eig_benchmark && !eig_param.arpack_check && eig_type != QUDA_EIG_TR_LANCZOS) {
+    const int iter = eig_param.iter;
+    QudaEigParam trlm_param = eig_param;
+    trlm_param.eig_type = QUDA_EIG_TR_LANCZOS;
+    trlm_param.block_size = 1;
+    double trlm_time = -((double)clock());
+    eigensolveQuda(host_evecs, host_evals, &trlm_param);
+    trlm_time += (double)clock();
+
+    printfQuda("Eigensolver benchmark: %d eigenpairs, nKr = %d\n", eig_nConv, eig_nKr);
+    printfQuda("%-8s OP*x = %6d time = %f\n", get_eig_type_str(eig_type), iter, time / CLOCKS_PER_SEC);
+    printfQuda("%-8s OP*x = %6d time = %f\n", get_eig_type_str(QUDA_EIG_TR_LANCZOS), trlm_param.iter,
+               trlm_time / CLOCKS_PER_SEC);
+  }
+
   // Deallocate host memory
   for (int i = 0; i < eig_nConv; i++) free(host_evecs[i]);
   free(host_evecs);
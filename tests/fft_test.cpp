@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <random>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <fft_quda.h>
+#include <complex_quda.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the 4-d FFTs of fft_quda.h: the built-in host FFT
+// against a plain DFT on lattices whose extents exercise every
+// butterfly (radix 4, 2, 3, 5 and generic primes, two of them in
+// one extent), the round trip forward and backward, and FFTW and
+// cuFFT against the built-in FFT.
+// The benchmark times --niter transforms of the --dim lattice.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int niter;
+extern QudaVerbosity verbosity;
+extern int gridsize_from_cmdline[];
+extern void usage(char **argv);
+
+template <typename Float> static std::vector<complex<Float>> randomField(long long volume, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<complex<Float>> field(volume);
+  for (auto &z : field) z = complex<Float>(uniform(gen), uniform(gen));
+  return field;
+}
+
+// momentum index of the lexicographic p in the layout of a plan
+static long long momentumIndex(const int *p, const int *X, const int *layout)
+{
+  long long idx = 0;
+  for (int i = 3; i >= 0; i--) idx = idx * X[layout[i]] + p[layout[i]];
+  return idx;
+}
+
+// a plain 4-d DFT, one dimension at a time, with the momenta in lexicographic order
+static std::vector<complex<double>> dft(const std::vector<complex<double>> &in, const int *X, int sign)
+{
+  std::vector<complex<double>> a(in), b(in.size());
+  long long stride = 1;
+  for (int d = 0; d < 4; d++) {
+    const int n = X[d];
+    for (size_t i = 0; i < a.size(); i++) {
+      const long long base = i - ((i / stride) % n) * stride;
+      const int k = (i / stride) % n;
+      complex<double> sum(0.0, 0.0);
+      for (int j = 0; j < n; j++) {
+        const double phase = sign * 2.0 * M_PI * ((long long)k * j % n) / n;
+        sum += a[base + j * stride] * complex<double>(cos(phase), sin(phase));
+      }
+      b[i] = sum;
+    }
+    std::swap(a, b);
+    stride *= n;
+  }
+  return a;
+}
+
+// largest difference between a lexicographic field and one in the layout of a plan
+template <typename Float>
+static double maxDeviation(const std::vector<complex<double>> &ref, const std::vector<complex<Float>> &field,
+                           const int *X, const int *layout)
+{
+  double dev = 0.0;
+  for (size_t i = 0; i < ref.size(); i++) {
+    int p[4];
+    long long rem = i;
+    for (int d = 0; d < 4; d++) {
+      p[d] = rem % X[d];
+      rem /= X[d];
+    }
+    const complex<Float> z = field[momentumIndex(p, X, layout)];
+    dev = std::max(dev, abs(ref[i] - complex<double>(z.real(), z.imag())));
+  }
+  return dev;
+}
+
+template <typename Float> static void checkDFT(const int *X, QudaPrecision precision, double tol)
+{
+  const long long volume = (long long)X[0] * X[1] * X[2] * X[3];
+  FFTPlan *fft = FFTPlan::create(FFT_BACKEND_BUILTIN, X, precision);
+  const std::vector<complex<Float>> field = randomField<Float>(volume, 1234);
+  std::vector<complex<double>> ref(volume);
+  for (long long i = 0; i < volume; i++) ref[i] = complex<double>(field[i].real(), field[i].imag());
+
+  for (int sign : {-1, +1}) {
+    std::vector<complex<Float>> in(field), out(volume);
+    if (sign < 0) fft->forward(in.data(), out.data());
+    else fft->backward(in.data(), out.data());
+    const std::vector<complex<double>> expected = dft(ref, X, sign);
+    const double dev = maxDeviation(expected, out, X, fft->Layout());
+    printfQuda("%dx%dx%dx%d %s %s: max deviation %e\n", X[0], X[1], X[2], X[3],
+               precision == QUDA_DOUBLE_PRECISION ? "double" : "single", sign < 0 ? "forward" : "backward", dev);
+    EXPECT_LT(dev, tol * sqrt((double)volume));
+  }
+  delete fft;
+}
+
+TEST(FFTTest, builtin_double)
+{
+  const int dims[][4] = {{6, 10, 15, 8}, {7, 9, 12, 5}, {2, 3, 5, 7}, {11, 13, 1, 4}, {16, 4, 2, 8}, {77, 3, 2, 2}};
+  for (auto &X : dims) checkDFT<double>(X, QUDA_DOUBLE_PRECISION, 1e-14);
+}
+
+TEST(FFTTest, builtin_single)
+{
+  const int dims[][4] = {{6, 10, 15, 8}, {7, 9, 12, 5}, {16, 4, 2, 8}};
+  for (auto &X : dims) checkDFT<float>(X, QUDA_SINGLE_PRECISION, 1e-6);
+}
+
+template <typename Float> static void roundTrip(FFTBackend backend, QudaPrecision precision, double tol)
+{
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  FFTPlan *fft = FFTPlan::create(backend, X, precision);
+  const long long volume = fft->Volume();
+  const std::vector<complex<Float>> field = randomField<Float>(volume, 4321);
+  std::vector<complex<Float>> in(field), out(volume);
+  fft->forward(in.data(), out.data());
+  fft->backward(out.data(), in.data());
+  double dev = 0.0;
+  for (long long i = 0; i < volume; i++) dev = std::max(dev, (double)abs(in[i] / (Float)volume - field[i]));
+  printfQuda("%s round trip %s: max deviation %e\n", fftBackendString(backend),
+             precision == QUDA_DOUBLE_PRECISION ? "double" : "single", dev);
+  EXPECT_LT(dev, tol);
+  delete fft;
+}
+
+TEST(FFTTest, round_trip)
+{
+  roundTrip<double>(FFT_BACKEND_BUILTIN, QUDA_DOUBLE_PRECISION, 1e-14);
+  roundTrip<float>(FFT_BACKEND_BUILTIN, QUDA_SINGLE_PRECISION, 1e-5);
+#ifdef FFTW_LIB
+  roundTrip<double>(FFT_BACKEND_FFTW, QUDA_DOUBLE_PRECISION, 1e-14);
+  roundTrip<float>(FFT_BACKEND_FFTW, QUDA_SINGLE_PRECISION, 1e-5);
+#endif
+}
+
+// the forward transform of a backend against the built-in one, on the host or the device
+template <typename Float> static double compareBackend(FFTBackend backend, QudaPrecision precision)
+{
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  FFTPlan *builtin = FFTPlan::create(FFT_BACKEND_BUILTIN, X, precision);
+  FFTPlan *fft = FFTPlan::create(backend, X, precision);
+  const long long volume = fft->Volume();
+  const size_t bytes = volume * sizeof(complex<Float>);
+  const std::vector<complex<Float>> field = randomField<Float>(volume, 5678);
+
+  std::vector<complex<Float>> in(field), ref(volume), out(volume);
+  builtin->forward(in.data(), ref.data());
+  in = field;
+  if (backend == FFT_BACKEND_CUFFT) {
+    void *in_d = device_malloc(bytes);
+    void *out_d = device_malloc(bytes);
+    qudaMemcpy(in_d, in.data(), bytes, cudaMemcpyHostToDevice);
+    fft->forward(in_d, out_d);
+    qudaMemcpy(out.data(), out_d, bytes, cudaMemcpyDeviceToHost);
+    device_free(out_d);
+    device_free(in_d);
+  } else {
+    fft->forward(in.data(), out.data());
+  }
+
+  std::vector<complex<double>> expected(volume);
+  for (long long i = 0; i < volume; i++) expected[i] = complex<double>(ref[i].real(), ref[i].imag());
+  const double dev = maxDeviation(expected, out, X, fft->Layout()) / sqrt((double)volume);
+  printfQuda("%s against builtin %s: max deviation %e\n", fftBackendString(backend),
+             precision == QUDA_DOUBLE_PRECISION ? "double" : "single", dev);
+  delete fft;
+  delete builtin;
+  return dev;
+}
+
+#ifdef FFTW_LIB
+TEST(FFTTest, fftw)
+{
+  EXPECT_LT(compareBackend<double>(FFT_BACKEND_FFTW, QUDA_DOUBLE_PRECISION), 1e-14);
+  EXPECT_LT(compareBackend<float>(FFT_BACKEND_FFTW, QUDA_SINGLE_PRECISION), 1e-6);
+}
+#endif
+
+#ifdef GPU_GAUGE_ALG
+TEST(FFTTest, cufft)
+{
+  EXPECT_LT(compareBackend<double>(FFT_BACKEND_CUFFT, QUDA_DOUBLE_PRECISION), 1e-14);
+  EXPECT_LT(compareBackend<float>(FFT_BACKEND_CUFFT, QUDA_SINGLE_PRECISION), 1e-6);
+}
+#endif
+
+template <typename Float> static double benchmark(FFTBackend backend, QudaPrecision precision)
+{
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  FFTPlan *fft = FFTPlan::create(backend, X, precision);
+  std::vector<complex<Float>> in = randomField<Float>(fft->Volume(), 8765), out(fft->Volume());
+  fft->forward(in.data(), out.data()); // tune
+
+  Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) {
+    fft->forward(in.data(), out.data());
+    fft->backward(out.data(), in.data());
+  }
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double gflops = 2.0 * niter * fft->flops() * 1e-9 / timer.time;
+  printfQuda("%s %s: %.3f ms per transform, Gflop/s = %6.2f, GB/s = %6.2f\n", fftBackendString(backend),
+             precision == QUDA_DOUBLE_PRECISION ? "double" : "single", 1e3 * timer.time / (2 * niter), gflops,
+             2.0 * niter * fft->bytes() * 1e-9 / timer.time);
+  delete fft;
+  return gflops;
+}
+
+TEST(FFTTest, benchmark)
+{
+  RecordProperty("BuiltinDoubleGflops", std::to_string(benchmark<double>(FFT_BACKEND_BUILTIN, QUDA_DOUBLE_PRECISION)));
+  RecordProperty("BuiltinSingleGflops", std::to_string(benchmark<float>(FFT_BACKEND_BUILTIN, QUDA_SINGLE_PRECISION)));
+#ifdef FFTW_LIB
+  RecordProperty("FFTWDoubleGflops", std::to_string(benchmark<double>(FFT_BACKEND_FFTW, QUDA_DOUBLE_PRECISION)));
+  RecordProperty("FFTWSingleGflops", std::to_string(benchmark<float>(FFT_BACKEND_FFTW, QUDA_SINGLE_PRECISION)));
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <memory>
 
 #include <quda.h>
 #include <quda_internal.h>
@@ -137,6 +138,35 @@ class GaugeAlgTest : public ::testing::Test {
     cudaMemset(num_failures_dev, 0, sizeof(int));
   }
 
+  // Gauge fix a host copy of the field and the field itself with FFTs,
+  // and check that the plaquette is unchanged and that both converge
+  // to the same gauge functional
+  void HostFFT(int gauge_dir){
+    GaugeFieldParam gParamHost(*cudaInGauge);
+    gParamHost.location = QUDA_CPU_FIELD_LOCATION;
+    gParamHost.create = QUDA_NULL_FIELD_CREATE;
+    gParamHost.order = QUDA_QDP_GAUGE_ORDER;
+    gParamHost.reconstruct = QUDA_RECONSTRUCT_NO;
+    gParamHost.pad = 0;
+    gParamHost.setPrecision(cudaInGauge->Precision());
+    std::unique_ptr<cpuGaugeField> hostGauge(new cpuGaugeField(gParamHost));
+    hostGauge->copy(*cudaInGauge);
+
+    GaugeFixHistory host = {}, device = {};
+    gaugefixingFFT(*hostGauge, gauge_dir, 100, 10, 0.08, 0, 0, 1, &host);
+    gaugefixingFFT(*cudaInGauge, gauge_dir, 100, 10, 0.08, 0, 0, 1, &device);
+
+    for(size_t i=0; i<host.steps.size(); i+=10)
+      printfQuda("Host step %d: action %.16e theta %.16e\n", host.steps[i].step, host.steps[i].action, host.steps[i].theta);
+    printfQuda("Host (%s): %.6f s, FFT %.6f s, Gflop/s = %6.1f\n", host.fft_backend, host.secs, host.fft_secs, host.gflops);
+    printfQuda("Device (%s): %.6f s, Gflop/s = %6.1f\n", device.fft_backend, device.secs, device.gflops);
+
+    ASSERT_TRUE(comparePlaquette(plaq, plaquette(*hostGauge)));
+    ASSERT_LT(host.steps.back().theta, host.steps.front().theta);
+    double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4;
+    ASSERT_NEAR(host.steps.back().action, device.steps.back().action, tol);
+  }
+
   virtual void SetUp() {
     setVerbosity(QUDA_VERBOSE);
 
@@ -305,6 +335,20 @@ TEST_F(GaugeAlgTest,Coulomb_FFT){
   }
 }
 
+TEST_F(GaugeAlgTest,Landau_FFT_Host){
+  if(!checkDimsPartitioned()){
+    printfQuda("Landau gauge fixing with steepest descent method with FFTs on the host\n");
+    HostFFT(4);
+  }
+}
+
+TEST_F(GaugeAlgTest,Coulomb_FFT_Host){
+  if(!checkDimsPartitioned()){
+    printfQuda("Coulomb gauge fixing with steepest descent method with FFTs on the host\n");
+    HostFFT(3);
+  }
+}
+
 
 int main(int argc, char **argv){
   // initalize google test, includes command line options
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <gauge_ensemble.h>
+#include <comm_quda.h>
+
+#include <misc.h>
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test runs a pipeline of smearing, flow and measurements over a
+// small ensemble of random host configurations written to a temporary
+// directory.  The streamed records are compared against the same
+// operations applied by hand, and must not depend on whether the next
+// configuration is prefetched.  The benchmark reads --niter
+// configurations through a reader slowed down to mimic a file system,
+// with and without prefetching.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaVerbosity verbosity;
+extern int niter;
+extern void usage(char **argv);
+
+QudaGaugeParam gauge_param;
+
+static const int n_configs = 3;
+static std::string ensemble_dir;
+static std::vector<std::string> ensemble;
+
+// each rank reads and writes its own part of the lattice
+static std::string rankFile(const std::string &file) { return file + ".rank" + std::to_string(comm_rank()); }
+
+static void writeConfig(const std::string &file, void **gauge)
+{
+  FILE *f = fopen(rankFile(file).c_str(), "wb");
+  if (!f) errorQuda("Cannot open %s", rankFile(file).c_str());
+  for (int d = 0; d < 4; d++) fwrite(gauge[d], sizeof(double), (size_t)V * gaugeSiteSize, f);
+  fclose(f);
+}
+
+static void readConfig(const std::string &file, void **gauge)
+{
+  FILE *f = fopen(rankFile(file).c_str(), "rb");
+  if (!f) errorQuda("Cannot open %s", rankFile(file).c_str());
+  for (int d = 0; d < 4; d++)
+    if (fread(gauge[d], sizeof(double), (size_t)V * gaugeSiteSize, f) != (size_t)V * gaugeSiteSize)
+      errorQuda("Short read from %s", rankFile(file).c_str());
+  fclose(f);
+}
+
+static std::vector<GaugeOperation> pipeline()
+{
+  return {GaugeOperation::measure(), GaugeOperation::stout(2, 0.1),
+          GaugeOperation::wflow(QUDA_WFLOW_TYPE_WILSON, 0.02, 0.01), GaugeOperation::measure()};
+}
+
+// value of a scalar field, or of the first element of an array field, of a record
+static double recordValue(const std::string &record, const std::string &key)
+{
+  size_t pos = record.find("\"" + key + "\": ");
+  if (pos == std::string::npos) return NAN;
+  pos += key.size() + 4;
+  if (record[pos] == '[') pos++;
+  return strtod(record.c_str() + pos, nullptr);
+}
+
+static std::vector<std::string> records(const std::string &output)
+{
+  std::vector<std::string> lines;
+  std::istringstream stream(output);
+  for (std::string line; std::getline(stream, line);) lines.push_back(line);
+  return lines;
+}
+
+TEST(GaugeEnsembleTest, verify)
+{
+  std::ostringstream out;
+  EnsembleSummary summary = analyzeEnsemble(ensemble, pipeline(), gauge_param, readConfig, out);
+  EXPECT_EQ(summary.n_configs, n_configs);
+
+  // two measurements and three flow records per configuration, all
+  // written by rank 0
+  std::vector<std::string> lines = records(out.str());
+  ASSERT_EQ(lines.size(), comm_rank() == 0 ? 5u * n_configs : 0u);
+
+  void *gauge[4];
+  for (int d = 0; d < 4; d++) gauge[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+  GaugeFieldParam param(gauge, gauge_param);
+  GaugeField *u = GaugeField::Create(param);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  GaugeField *smeared = GaugeField::Create(param);
+  GaugeField *flowed = GaugeField::Create(param);
+
+  for (int i = 0; i < n_configs; i++) {
+    readConfig(ensemble[i], gauge);
+    GaugeObservables obs0 = gaugeObservables(*u);
+    STOUTnStep(*smeared, *u, 2, 0.1);
+    std::vector<WFlowObservables> flow = WFlow(*flowed, *smeared, QUDA_WFLOW_TYPE_WILSON, 0.02, 0.01);
+    GaugeObservables obs1 = gaugeObservables(*flowed);
+    ASSERT_EQ(flow.size(), 3u);
+    if (comm_rank() != 0) continue;
+
+    const std::string *rec = &lines[5 * i];
+    EXPECT_NE(rec[0].find("\"file\": \"" + ensemble[i] + "\""), std::string::npos);
+    EXPECT_NE(rec[0].find("\"type\": \"measure\""), std::string::npos);
+    EXPECT_EQ(recordValue(rec[0], "config"), i);
+    EXPECT_EQ(recordValue(rec[0], "plaquette"), obs0.plaquette.x);
+    EXPECT_EQ(recordValue(rec[0], "polyakov_loop"), obs0.polyakov_loop.x);
+    EXPECT_EQ(recordValue(rec[0], "Q"), obs0.Q);
+
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(recordValue(rec[1 + j], "op"), 2);
+      EXPECT_EQ(recordValue(rec[1 + j], "t"), flow[j].t);
+      EXPECT_EQ(recordValue(rec[1 + j], "E"), flow[j].E_clover);
+    }
+
+    EXPECT_EQ(recordValue(rec[4], "op"), 3);
+    EXPECT_EQ(recordValue(rec[4], "rectangle"), obs1.rectangle);
+    EXPECT_EQ(recordValue(rec[4], "E"), obs1.E);
+  }
+
+  delete flowed;
+  delete smeared;
+  delete u;
+  for (int d = 0; d < 4; d++) free(gauge[d]);
+}
+
+TEST(GaugeEnsembleTest, prefetch)
+{
+  std::ostringstream serial, prefetched;
+  analyzeEnsemble(ensemble, pipeline(), gauge_param, readConfig, serial, QUDA_CPU_FIELD_LOCATION, false);
+  analyzeEnsemble(ensemble, pipeline(), gauge_param, readConfig, prefetched, QUDA_CPU_FIELD_LOCATION, true);
+  EXPECT_EQ(serial.str(), prefetched.str());
+}
+
+TEST(GaugeEnsembleTest, benchmark)
+{
+  // a reader as slow as the pipeline, as for configurations on a
+  // network file system
+  std::vector<GaugeOperation> ops = {GaugeOperation::stout(1, 0.1), GaugeOperation::measure()};
+  std::ostringstream out;
+  EnsembleSummary pipeline_only = analyzeEnsemble({ensemble[0]}, ops, gauge_param, readConfig, out);
+  const auto delay = std::chrono::duration<double>(pipeline_only.compute_secs);
+  GaugeReader slow_reader = [&](const std::string &file, void **gauge) {
+    std::this_thread::sleep_for(delay);
+    readConfig(file, gauge);
+  };
+
+  std::vector<std::string> files(niter);
+  for (int i = 0; i < niter; i++) files[i] = ensemble[i % n_configs];
+
+  EnsembleSummary serial
+    = analyzeEnsemble(files, ops, gauge_param, slow_reader, out, QUDA_CPU_FIELD_LOCATION, false);
+  EnsembleSummary prefetched
+    = analyzeEnsemble(files, ops, gauge_param, slow_reader, out, QUDA_CPU_FIELD_LOCATION, true);
+
+  printfQuda("%d configurations: serial %.3f s, prefetched %.3f s (waiting for reads %.3f s of %.3f s read)\n",
+             niter, serial.total_secs, prefetched.total_secs, prefetched.wait_secs, prefetched.read_secs);
+  RecordProperty("Configurations", niter);
+  RecordProperty("SerialSecs", std::to_string(serial.total_secs));
+  RecordProperty("PrefetchedSecs", std::to_string(prefetched.total_secs));
+  RecordProperty("WaitSecs", std::to_string(prefetched.wait_secs));
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+  setDims(gauge_param.X);
+  gauge_param.anisotropy = 1.0;
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.cuda_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.ga_pad = 0;
+
+  // a synthetic ensemble of random configurations
+  char dir[] = "/tmp/quda_ensemble_XXXXXX";
+  if (comm_rank() == 0 && !mkdtemp(dir)) errorQuda("Cannot create a temporary directory");
+  comm_broadcast(dir, sizeof(dir));
+  ensemble_dir = dir;
+
+  void *gauge[4];
+  for (int d = 0; d < 4; d++) gauge[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+  for (int i = 0; i < n_configs; i++) {
+    ensemble.push_back(ensemble_dir + "/config." + std::to_string(i));
+    construct_gauge_field(gauge, 1, QUDA_DOUBLE_PRECISION, &gauge_param);
+    writeConfig(ensemble[i], gauge);
+  }
+  for (int d = 0; d < 4; d++) free(gauge[d]);
+  comm_barrier();
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  for (auto &file : ensemble) remove(rankFile(file).c_str());
+  comm_barrier();
+  if (comm_rank() == 0) rmdir(ensemble_dir.c_str());
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -3,11 +3,13 @@
 #include <math.h>
 #include <string.h>
 #include <type_traits>
+#include <vector>
 
 #include "quda.h"
 #include "test_util.h"
 #include "misc.h"
 #include "gauge_force_reference.h"
+#include <lattice_geometry.h>
 
 extern int Z[4];
 extern int V;
@@ -213,64 +215,20 @@ print_su3_matrix(su3_matrix *a)
 }
 
 
-int
-gf_neighborIndexFullLattice(int i, int dx4, int dx3, int dx2, int dx1) 
+// geometry of the lattice the gauge force reads its links from: the
+// extended lattice (halo depth 2) when multi-GPU, else the periodic
+// local lattice
+static const quda::LatticeGeometry &gf_geometry()
 {
-  int oddBit = 0;
-  int half_idx = i;
-  if (i >= Vh){
-    oddBit =1;
-    half_idx = i - Vh;
-  }
-  int X1 = Z[0];  
-  int X2 = Z[1];
-  int X3 = Z[2];
-  //int X4 = Z[3];
-  int X1h =X1/2;
-
-  int za = half_idx/X1h;
-  int x1h = half_idx - za*X1h;
-  int zb = za/X2;
-  int x2 = za - zb*X2;
-  int x4 = zb/X3;
-  int x3 = zb - x4*X3;
-  int x1odd = (x2 + x3 + x4 + oddBit) & 1;
-  int x1 = 2*x1h + x1odd;
-
 #ifdef MULTI_GPU
-  x4 = x4+dx4;
-  x3 = x3+dx3;
-  x2 = x2+dx2;
-  x1 = x1+dx1;
-  
-  int nbr_half_idx = ( (x4+2)*(E[2]*E[1]*E[0]) + (x3+2)*(E[1]*E[0]) + (x2+2)*(E[0]) + (x1+2)) / 2;
+  const int R[4] = {2, 2, 2, 2};
+  return quda::getLatticeGeometry(Z, R);
 #else
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
- 
-  int nbr_half_idx = (x4*(Z[2]*Z[1]*Z[0]) + x3*(Z[1]*Z[0]) + x2*(Z[0]) + x1) / 2;
+  return quda::getLatticeGeometry(Z);
 #endif
-
-  int oddBitChanged = (dx4+dx3+dx2+dx1)%2;
-  if (oddBitChanged){
-    oddBit = 1 - oddBit;
-  }
-  int ret = nbr_half_idx;
-  if (oddBit){
-#ifdef MULTI_GPU
-    ret = Vh_ex + nbr_half_idx;    
-#else
-    ret = Vh + nbr_half_idx;
-#endif
-  }
-    
-  return ret;
 }
 
 
-
 //this functon compute one path for all lattice sites
 template<typename su3_matrix, typename Float>
 static void
@@ -280,30 +238,38 @@ compute_path_product(su3_matrix* staple, su3_matrix** sitelink, su3_matrix** sit
   int i, j;
 
     su3_matrix prev_matrix, curr_matrix, tmat;
-    int dx[4];
+
+    // the displacement of each link along the path is the same for
+    // every site, so look up the neighbour tables once per path
+    std::vector<const int*> nbr(len);
+    {
+	int dx[4] = {0, 0, 0, 0};
+	dx[dir] =1;
+	for(j=0; j < len;j++){
+	    if (!GOES_FORWARDS(path[j])) dx[OPP_DIR(path[j])] -=1;
+	    nbr[j] = gf_geometry().Neighbors(dx);
+	    if (GOES_FORWARDS(path[j])) dx[path[j]] +=1;
+	}
+    }
 
     for(i=0;i<V;i++){
-	memset(dx,0, sizeof(dx));
 	memset(&curr_matrix, 0, sizeof(curr_matrix));
 	
 	curr_matrix.e[0][0].real = 1.0;
 	curr_matrix.e[1][1].real = 1.0;
 	curr_matrix.e[2][2].real = 1.0;
 	
-	dx[dir] =1;
 	for(j=0; j < len;j++){
 	    int lnkdir;
 
 	    prev_matrix = curr_matrix;
 	    if (GOES_FORWARDS(path[j])){
-		//dx[path[j]] +=1;
 		lnkdir = path[j];
 	    }else{		
-		dx[OPP_DIR(path[j])] -=1;
 		lnkdir=OPP_DIR(path[j]);
 	    }
 	    
-	    int nbr_idx = gf_neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+	    int nbr_idx = nbr[j][i];
 #ifdef MULTI_GPU
 	    su3_matrix* lnk = sitelink_ex_2d[lnkdir] + nbr_idx;
 #else	    
@@ -314,14 +280,6 @@ compute_path_product(su3_matrix* staple, su3_matrix** sitelink, su3_matrix** sit
 	    }else{
 		mult_su3_na(&prev_matrix, lnk, &curr_matrix);		
 	    }
-
-	    if (GOES_FORWARDS(path[j])){
-		dx[path[j]] +=1;
-	    }else{		
-	      //we already substract one in the code above
-	    }	    
-
-	    
 	}//j
 
 	su3_adjoint(&curr_matrix, &tmat );
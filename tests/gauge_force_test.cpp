@@ -15,6 +15,7 @@ extern int device;
 
 static QudaGaugeParam qudaGaugeParam;
 QudaGaugeFieldOrder gauge_order =  QUDA_QDP_GAUGE_ORDER;
+static QudaFieldLocation compute_location = QUDA_CUDA_FIELD_LOCATION;
 extern bool verify_results;
 extern int tdim;
 extern QudaPrecision prec;
@@ -371,6 +372,7 @@ gauge_force_test(void)
   qudaGaugeParam.gauge_fix = QUDA_GAUGE_FIXED_NO;
   qudaGaugeParam.ga_pad = 0;
   qudaGaugeParam.mom_ga_pad = 0;
+  qudaGaugeParam.compute_location = compute_location;
 
   size_t gSize = qudaGaugeParam.cpu_prec;
     
@@ -527,6 +529,7 @@ gauge_force_test(void)
   int flops=153004;
     
   if (verify_results){	
+    gettimeofday(&t0, NULL);
 #ifdef MULTI_GPU
     //last arg=0 means no optimization for communication, i.e. exchange data in all directions
     //even they are not partitioned
@@ -539,6 +542,11 @@ gauge_force_test(void)
     gauge_force_reference(refmom, eb3, sitelink_2d, NULL, qudaGaugeParam.cpu_prec,
 			  input_path_buf, length, loop_coeff, num_paths);
 #endif
+    gettimeofday(&t1, NULL);
+    double ref_time = t1.tv_sec - t0.tv_sec + 0.000001*(t1.tv_usec - t0.tv_usec);
+    printfQuda("reference force computation time = %.2f ms, QUDA (%s) = %.2f ms, speedup %.1f\n",
+               ref_time*1e+3, compute_location == QUDA_CPU_FIELD_LOCATION ? "host" : "device",
+               total_time*1e+3/niter, ref_time/(total_time/niter));
   
     int res;
     res = compare_floats(mom, refmom, 4*V*momSiteSize, 1e-3, qudaGaugeParam.cpu_prec);
@@ -551,6 +559,34 @@ gauge_force_test(void)
   double perf = 1.0*niter*flops*V/(total_time*1e+9);
   printfQuda("total time =%.2f ms\n", total_time*1e+3);
   printfQuda("overall performance : %.2f GFLOPS\n",perf);
+
+  // The paths are compiled into prefix trees, so the partial products
+  // shared by several paths are computed once.  The leading paths of
+  // the table make up the standard actions: the staples of the Wilson
+  // action, the rectangles added by the tree-level Symanzik, Iwasaki
+  // and DBW2 actions (which differ only in the coefficients) and the
+  // parallelograms of the one-loop Symanzik action.
+  const char *action[] = {"Wilson", "Symanzik/Iwasaki", "one-loop Symanzik"};
+  const int action_paths[] = {6, 24, num_paths};
+  for (int a = 0; a < 3; a++) {
+    quda::GaugePathPlan plan(input_path_buf, length, loop_coeff_d, action_paths[a]);
+    double action_time = 0.0;
+    for (int i = 0; i < niter; i++) {
+      memcpy(mom, refmom, 4*V*momSiteSize*gSize);
+      gettimeofday(&t0, NULL);
+      computeGaugeForceQuda(mom, sitelink, input_path_buf, length, loop_coeff_d, action_paths[a], max_length, eb3,
+                            &qudaGaugeParam);
+      gettimeofday(&t1, NULL);
+      action_time += t1.tv_sec - t0.tv_sec + 0.000001*(t1.tv_usec - t0.tv_usec);
+    }
+    // every path loads one link more than it multiplies
+    long long loads = plan.nodes.size(), naive_loads = plan.naive_multiplies + 4*plan.num_paths;
+    printfQuda("%-18s %2d paths: %4lld multiplies per site (%lld uncompiled, %.0f%% saved), %4lld link loads (%lld "
+               "uncompiled, %.0f%% saved), %.2f ms, %.2f Msites/s\n",
+               action[a], plan.num_paths, plan.multiplies, plan.naive_multiplies,
+               100.0 * (plan.naive_multiplies - plan.multiplies) / plan.naive_multiplies, loads, naive_loads,
+               100.0 * (naive_loads - loads) / naive_loads, action_time*1e+3/niter, 1.0*niter*V/(action_time*1e+6));
+  }
   
   for(int dir = 0; dir < 4; dir++){
     for(int i=0;i < num_paths; i++) host_free(input_path_buf[dir][i]);
@@ -577,13 +613,14 @@ display_test_info()
 {
   printfQuda("running the following test:\n");
     
-  printfQuda("link_precision           link_reconstruct           space_dim(x/y/z)              T_dimension        Gauge_order    niter\n");
-  printfQuda("%s                       %s                         %d/%d/%d                       %d                  %s           %d\n",
+  printfQuda("link_precision           link_reconstruct           space_dim(x/y/z)              T_dimension        Gauge_order    niter    Location\n");
+  printfQuda("%s                       %s                         %d/%d/%d                       %d                  %s           %d        %s\n",
 	 get_prec_str(link_prec),
 	 get_recon_str(link_recon), 
 	 xdim,ydim,zdim, tdim, 
 	 get_gauge_order_str(gauge_order),
-	 niter);
+	 niter,
+	 compute_location == QUDA_CPU_FIELD_LOCATION ? "cpu" : "cuda");
   return ;
     
 }
@@ -593,6 +630,7 @@ usage_extra(char** argv )
 {
   printfQuda("Extra options:\n");
   printfQuda("    --gauge-order  <qdp/milc>                 # Gauge storing order in CPU\n");
+  printfQuda("    --compute-location <cpu/cuda>             # where the force is computed (default cuda)\n");
   return ;
 }
 
@@ -623,6 +661,15 @@ main(int argc, char **argv)
       continue;
     }
      
+    if( strcmp(argv[i], "--compute-location") == 0){
+      if(i+1 >= argc){
+	usage(argv);
+      }
+      compute_location = get_location(argv[i+1]);
+      i++;
+      continue;
+    }
+
     if( strcmp(argv[i], "--verify") == 0){
       verify_results=1;
       continue;	    
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <gauge_smear_reference.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test measures the plaquette, the field strength, the
+// topological charge and the fused gauge observables on host gauge
+// fields, comparing them against the serial reference on the unsplit
+// lattice, also when the lattice is partitioned, and checks that the
+// fused observables do not depend on the number of threads.
+// The benchmark times --niter fused measurements against the
+// separate plaquette, field strength and charge passes.  The
+// precision is taken from --prec.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern QudaVerbosity verbosity;
+extern int niter;
+extern void usage(char **argv);
+
+QudaGaugeParam gauge_param;
+void *hostGauge[4];
+
+class GaugeObservablesTest : public ::testing::Test
+{
+protected:
+  GaugeField *in;
+  GaugeField *Fmunu;
+
+  void SetUp()
+  {
+    GaugeFieldParam param(hostGauge, gauge_param);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(prec);
+    in = GaugeField::Create(param);
+
+    param.create = QUDA_REFERENCE_FIELD_CREATE;
+    param.setPrecision(QUDA_DOUBLE_PRECISION);
+    GaugeField *host = GaugeField::Create(param);
+    in->copy(*host);
+    delete host;
+
+    GaugeFieldParam tensorParam(in->X(), in->Precision(), QUDA_RECONSTRUCT_NO, 0, QUDA_TENSOR_GEOMETRY);
+    tensorParam.location = QUDA_CPU_FIELD_LOCATION;
+    tensorParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    tensorParam.order = QUDA_MILC_GAUGE_ORDER;
+    tensorParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    tensorParam.create = QUDA_NULL_FIELD_CREATE;
+    Fmunu = GaugeField::Create(tensorParam);
+  }
+
+  void TearDown()
+  {
+    delete Fmunu;
+    delete in;
+  }
+
+  double tolerance() const { return prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5; }
+};
+
+TEST_F(GaugeObservablesTest, plaquette)
+{
+  double ref[8];
+  {
+    GlobalReferenceGauge global(hostGauge, gauge_param.X);
+    gaugeObservablesReference(ref, global.gauge);
+  }
+  double3 plaq = plaquette(*in);
+
+  EXPECT_NEAR(plaq.x, ref[0], tolerance());
+  EXPECT_NEAR(plaq.y, ref[1], tolerance());
+  EXPECT_NEAR(plaq.z, ref[2], tolerance());
+}
+
+TEST_F(GaugeObservablesTest, qcharge)
+{
+  computeFmunu(*Fmunu, *in);
+  const double Q = computeQCharge(*Fmunu);
+
+  // the density sums to the charge
+  std::vector<double> density(in->Volume());
+  double Q_density = 0.0;
+  if (prec == QUDA_DOUBLE_PRECISION) {
+    EXPECT_EQ(computeQChargeDensity(*Fmunu, density.data()), Q);
+    for (auto q : density) Q_density += q;
+  } else {
+    std::vector<float> density_f(in->Volume());
+    EXPECT_EQ(computeQChargeDensity(*Fmunu, density_f.data()), Q);
+    for (auto q : density_f) Q_density += q;
+  }
+  comm_allreduce(&Q_density);
+  EXPECT_NEAR(Q_density, Q, tolerance() * V);
+
+  GlobalReferenceGauge global(hostGauge, gauge_param.X);
+  EXPECT_NEAR(Q, qChargeReference(global.gauge), tolerance() * V);
+}
+
+TEST_F(GaugeObservablesTest, observables)
+{
+  GaugeObservables obs = gaugeObservables(*in);
+
+  // the fused pass agrees with the separate ones
+  double3 plaq = plaquette(*in);
+  EXPECT_NEAR(obs.plaquette.x, plaq.x, tolerance());
+  EXPECT_NEAR(obs.plaquette.y, plaq.y, tolerance());
+  EXPECT_NEAR(obs.plaquette.z, plaq.z, tolerance());
+  WFlowObservables wflow = WFlowMeasure(*in);
+  EXPECT_NEAR(obs.E, wflow.E_clover, tolerance() * fabs(wflow.E_clover));
+  EXPECT_NEAR(obs.Q, wflow.Q, tolerance() * V);
+
+  double ref[8];
+  {
+    GlobalReferenceGauge global(hostGauge, gauge_param.X);
+    gaugeObservablesReference(ref, global.gauge);
+  }
+  EXPECT_NEAR(obs.polyakov_loop.x, ref[3], tolerance());
+  EXPECT_NEAR(obs.polyakov_loop.y, ref[4], tolerance());
+  EXPECT_NEAR(obs.rectangle, ref[5], tolerance());
+  EXPECT_NEAR(obs.E, ref[6], tolerance() * fabs(ref[6]));
+  EXPECT_NEAR(obs.Q, ref[7], tolerance() * V * comm_size());
+}
+
+TEST_F(GaugeObservablesTest, deterministic)
+{
+#ifdef _OPENMP
+  const int max_threads = omp_get_max_threads();
+  GaugeObservables obs = gaugeObservables(*in);
+  const double plaq = plaquette(*in).x;
+  for (int threads : {1, 3, max_threads}) {
+    omp_set_num_threads(threads);
+    GaugeObservables obs_n = gaugeObservables(*in);
+    EXPECT_EQ(obs_n.plaquette.x, obs.plaquette.x) << threads << " threads";
+    EXPECT_EQ(obs_n.polyakov_loop.x, obs.polyakov_loop.x) << threads << " threads";
+    EXPECT_EQ(obs_n.rectangle, obs.rectangle) << threads << " threads";
+    EXPECT_EQ(obs_n.E, obs.E) << threads << " threads";
+    EXPECT_EQ(obs_n.Q, obs.Q) << threads << " threads";
+    EXPECT_EQ(plaquette(*in).x, plaq) << threads << " threads";
+  }
+  omp_set_num_threads(max_threads);
+#endif
+}
+
+TEST_F(GaugeObservablesTest, benchmark)
+{
+  quda::Timer timer;
+
+  gaugeObservables(*in); // warm up and tune
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) gaugeObservables(*in);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double fused_secs = timer.Last();
+
+  plaquette(*in);
+  computeFmunu(*Fmunu, *in);
+  computeQCharge(*Fmunu);
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) {
+    plaquette(*in);
+    computeFmunu(*Fmunu, *in);
+    computeQCharge(*Fmunu);
+  }
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double separate_secs = timer.Last();
+
+  printfQuda("%d measurements: fused observables %.3f s, plaquette + Fmunu + Q %.3f s\n", niter, fused_secs,
+             separate_secs);
+  RecordProperty("Measurements", niter);
+  RecordProperty("FusedSecs", std::to_string(fused_secs));
+  RecordProperty("SeparateSecs", std::to_string(separate_secs));
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  initReferenceGauge(hostGauge, gauge_param, X, prec);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  freeReferenceGauge(hostGauge);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
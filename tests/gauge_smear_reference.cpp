@@ -0,0 +1,463 @@
+#include <stdlib.h>
+#include <complex>
+#include <string.h>
+#include <vector>
+#include <math.h>
+
+#include <lattice_geometry.h>
+#include <comm_quda.h>
+#include <test_util.h>
+#include <gauge_smear_reference.h>
+
+extern int V;
+
+typedef std::complex<double> Complex;
+
+struct su3 {
+  Complex e[3][3];
+};
+
+static su3 zero()
+{
+  su3 a;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) a.e[i][j] = 0.0;
+  return a;
+}
+
+static su3 identity()
+{
+  su3 a = zero();
+  for (int i = 0; i < 3; i++) a.e[i][i] = 1.0;
+  return a;
+}
+
+static su3 operator*(const su3 &a, const su3 &b)
+{
+  su3 c = zero();
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      for (int k = 0; k < 3; k++) c.e[i][j] += a.e[i][k] * b.e[k][j];
+  return c;
+}
+
+static su3 operator*(Complex s, const su3 &a)
+{
+  su3 c;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) c.e[i][j] = s * a.e[i][j];
+  return c;
+}
+
+static su3 operator+(const su3 &a, const su3 &b)
+{
+  su3 c;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) c.e[i][j] = a.e[i][j] + b.e[i][j];
+  return c;
+}
+
+static su3 operator-(const su3 &a, const su3 &b) { return a + Complex(-1.0) * b; }
+
+static su3 dagger(const su3 &a)
+{
+  su3 c;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) c.e[i][j] = std::conj(a.e[j][i]);
+  return c;
+}
+
+static Complex trace(const su3 &a) { return a.e[0][0] + a.e[1][1] + a.e[2][2]; }
+
+static Complex det(const su3 &a)
+{
+  return a.e[0][0] * (a.e[1][1] * a.e[2][2] - a.e[1][2] * a.e[2][1])
+    - a.e[0][1] * (a.e[1][0] * a.e[2][2] - a.e[1][2] * a.e[2][0])
+    + a.e[0][2] * (a.e[1][0] * a.e[2][1] - a.e[1][1] * a.e[2][0]);
+}
+
+static su3 inverse(const su3 &a)
+{
+  su3 c;
+  const Complex d = 1.0 / det(a);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+      const int i1 = (j + 1) % 3, i2 = (j + 2) % 3, j1 = (i + 1) % 3, j2 = (i + 2) % 3;
+      c.e[i][j] = d * (a.e[i1][j1] * a.e[i2][j2] - a.e[i1][j2] * a.e[i2][j1]);
+    }
+  return c;
+}
+
+static double distance(const su3 &a, const su3 &b)
+{
+  double d = 0.0;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) d += std::norm(a.e[i][j] - b.e[i][j]);
+  return d;
+}
+
+static su3 load(void **gauge, int dir, int i)
+{
+  su3 a;
+  const double *u = static_cast<double *>(gauge[dir]) + i * gaugeSiteSize;
+  for (int r = 0; r < 3; r++)
+    for (int c = 0; c < 3; c++) a.e[r][c] = Complex(u[(r * 3 + c) * 2], u[(r * 3 + c) * 2 + 1]);
+  return a;
+}
+
+static void store(void **gauge, int dir, int i, const su3 &a)
+{
+  double *u = static_cast<double *>(gauge[dir]) + i * gaugeSiteSize;
+  for (int r = 0; r < 3; r++)
+    for (int c = 0; c < 3; c++) {
+      u[(r * 3 + c) * 2] = a.e[r][c].real();
+      u[(r * 3 + c) * 2 + 1] = a.e[r][c].imag();
+    }
+}
+
+static int shift(int i, int dir, int sign)
+{
+  int dx[4] = {0, 0, 0, 0};
+  dx[dir] = sign;
+  return neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+}
+
+// product of links along a path starting at site i, where step d + 1
+// is a forward hop in direction d and -(d + 1) a backward hop
+static su3 path(void **gauge, int i, const std::vector<int> &steps)
+{
+  su3 p = identity();
+  for (int s : steps) {
+    const int dir = abs(s) - 1;
+    if (s > 0) {
+      p = p * load(gauge, dir, i);
+      i = shift(i, dir, +1);
+    } else {
+      i = shift(i, dir, -1);
+      p = p * dagger(load(gauge, dir, i));
+    }
+  }
+  return p;
+}
+
+// sum of the staples of U_nu(x) over directions mu < n_mu
+static su3 staple(void **gauge, int i, int nu, int n_mu)
+{
+  su3 s = zero();
+  for (int mu = 0; mu < n_mu; mu++) {
+    if (mu == nu) continue;
+    const int m = mu + 1, n = nu + 1;
+    s = s + path(gauge, i, {m, n, -m}) + path(gauge, i, {-m, n, m});
+  }
+  return s;
+}
+
+// sum of the 1x2 and 2x1 rectangles of U_nu(x)
+static su3 rectangle(void **gauge, int i, int nu)
+{
+  su3 r = zero();
+  for (int mu = 0; mu < 4; mu++) {
+    if (mu == nu) continue;
+    const int n = nu + 1;
+    for (int m : {mu + 1, -(mu + 1)}) {
+      r = r + path(gauge, i, {m, m, n, -m, -m});
+      r = r + path(gauge, i, {m, n, n, -m, -n});
+      r = r + path(gauge, i, {-n, m, n, n, -m});
+    }
+  }
+  return r;
+}
+
+// exp(iQ) summed as a Taylor series to machine precision
+static su3 expi(const su3 &Q)
+{
+  const su3 iQ = Complex(0.0, 1.0) * Q;
+  su3 e = identity(), term = identity();
+  for (int k = 1; k < 40; k++) {
+    term = Complex(1.0 / k) * (term * iQ);
+    e = e + term;
+    if (distance(term, zero()) < 1e-34) break;
+  }
+  return e;
+}
+
+// STOUT update exp(iQ) U with Q the traceless Hermitian part of i Omega
+static su3 stout(const su3 &U, const su3 &Omega)
+{
+  const su3 diff = dagger(Omega) - Omega;
+  const su3 Q = Complex(0.0, 0.5) * (diff - (trace(diff) / 3.0) * identity());
+  return expi(Q) * U;
+}
+
+// projection onto SU(3) by the polar decomposition, removing the phase
+// of the determinant
+static su3 project(const su3 &A)
+{
+  su3 W = A;
+  for (int iter = 0; iter < 100; iter++) {
+    const su3 W_ = Complex(0.5) * (W + dagger(inverse(W)));
+    const bool converged = distance(W_, W) < 1e-30;
+    W = W_;
+    if (converged) break;
+  }
+  const Complex d = det(W);
+  return (std::pow(std::norm(d), -1.0 / 6.0) * std::polar(1.0, -std::arg(d) / 3.0)) * W;
+}
+
+void apeStepReference(void **out, void **in, double alpha)
+{
+  for (int i = 0; i < V; i++) {
+    for (int dir = 0; dir < 3; dir++) {
+      const su3 U = load(in, dir, i);
+      const su3 S = Complex(alpha / 4.0) * staple(in, i, dir, 3);
+      store(out, dir, i, project(Complex(1.0 - alpha) * identity() + S * dagger(U)) * U);
+    }
+    store(out, 3, i, load(in, 3, i));
+  }
+}
+
+void stoutStepReference(void **out, void **in, double rho)
+{
+  for (int i = 0; i < V; i++) {
+    for (int dir = 0; dir < 3; dir++) {
+      const su3 U = load(in, dir, i);
+      store(out, dir, i, stout(U, Complex(rho) * staple(in, i, dir, 3) * dagger(U)));
+    }
+    store(out, 3, i, load(in, 3, i));
+  }
+}
+
+void ovrImpStoutStepReference(void **out, void **in, double rho, double epsilon)
+{
+  const double staple_coeff = (5.0 - 2.0 * epsilon) / 3.0;
+  const double rectangle_coeff = (1.0 - epsilon) / 12.0;
+  for (int i = 0; i < V; i++) {
+    for (int dir = 0; dir < 4; dir++) {
+      const su3 U = load(in, dir, i);
+      const su3 C = Complex(rho * staple_coeff) * staple(in, i, dir, 4)
+        - Complex(rho * rectangle_coeff) * rectangle(in, i, dir);
+      store(out, dir, i, stout(U, C * dagger(U)));
+    }
+  }
+}
+
+// traceless anti-Hermitian part of a
+static su3 antiHerm(const su3 &a)
+{
+  const su3 d = Complex(0.5) * (a - dagger(a));
+  return d - (trace(d) / 3.0) * identity();
+}
+
+// exp(A) summed as a Taylor series to machine precision
+static su3 expm(const su3 &A) { return expi(Complex(0.0, -1.0) * A); }
+
+// force of the flow action on U_dir(x) for every link
+static std::vector<su3> wflowForce(void **gauge, QudaWFlowType type)
+{
+  std::vector<su3> Z(4 * V);
+  for (int i = 0; i < V; i++) {
+    for (int dir = 0; dir < 4; dir++) {
+      const su3 U = load(gauge, dir, i);
+      const su3 C = type == QUDA_WFLOW_TYPE_WILSON ?
+        staple(gauge, i, dir, 4) :
+        Complex(5.0 / 3.0) * staple(gauge, i, dir, 4) - Complex(1.0 / 12.0) * rectangle(gauge, i, dir);
+      Z[4 * i + dir] = antiHerm(C * dagger(U));
+    }
+  }
+
+  if (type == QUDA_WFLOW_TYPE_ZEUTHEN) {
+    // apply 1 + 1/12 of the covariant second derivative along dir
+    std::vector<su3> F(Z);
+    for (int i = 0; i < V; i++) {
+      for (int dir = 0; dir < 4; dir++) {
+        const int ip = shift(i, dir, +1), im = shift(i, dir, -1);
+        const su3 U = load(gauge, dir, i), Um = load(gauge, dir, im);
+        const su3 D = U * F[4 * ip + dir] * dagger(U) + dagger(Um) * F[4 * im + dir] * Um
+          - Complex(2.0) * F[4 * i + dir];
+        Z[4 * i + dir] = antiHerm(F[4 * i + dir] + Complex(1.0 / 12.0) * D);
+      }
+    }
+  }
+
+  return Z;
+}
+
+void wflowReference(void **out, void **in, QudaWFlowType type, double epsilon, int nSteps)
+{
+  std::vector<std::vector<double>> W1(4, std::vector<double>(V * gaugeSiteSize));
+  std::vector<std::vector<double>> W2(4, std::vector<double>(V * gaugeSiteSize));
+  void *w1[4], *w2[4];
+  for (int d = 0; d < 4; d++) {
+    w1[d] = W1[d].data();
+    w2[d] = W2[d].data();
+    memcpy(out[d], in[d], V * gaugeSiteSize * sizeof(double));
+  }
+
+  const Complex eps(epsilon);
+  for (int step = 0; step < nSteps; step++) {
+    std::vector<su3> Z0 = wflowForce(out, type);
+    for (int i = 0; i < V; i++)
+      for (int dir = 0; dir < 4; dir++)
+        store(w1, dir, i, expm(Complex(0.25) * eps * Z0[4 * i + dir]) * load(out, dir, i));
+
+    std::vector<su3> Z1 = wflowForce(w1, type);
+    for (int i = 0; i < V; i++)
+      for (int dir = 0; dir < 4; dir++)
+        store(w2, dir, i,
+              expm(eps * (Complex(8.0 / 9.0) * Z1[4 * i + dir] - Complex(17.0 / 36.0) * Z0[4 * i + dir]))
+                * load(w1, dir, i));
+
+    std::vector<su3> Z2 = wflowForce(w2, type);
+    for (int i = 0; i < V; i++)
+      for (int dir = 0; dir < 4; dir++)
+        store(out, dir, i,
+              expm(eps
+                   * (Complex(3.0 / 4.0) * Z2[4 * i + dir] - Complex(8.0 / 9.0) * Z1[4 * i + dir]
+                      + Complex(17.0 / 36.0) * Z0[4 * i + dir]))
+                * load(w2, dir, i));
+  }
+}
+
+void wflowObservablesReference(double obs[4], void **gauge)
+{
+  double plaq = 0.0, E = 0.0, Q = 0.0;
+  for (int i = 0; i < V; i++) {
+    su3 F[4][4];
+    for (int mu = 1; mu < 4; mu++) {
+      for (int nu = 0; nu < mu; nu++) {
+        const int m = mu + 1, n = nu + 1;
+        const su3 P = path(gauge, i, {m, n, -m, -n});
+        const su3 C = P + path(gauge, i, {n, -m, -n, m}) + path(gauge, i, {-m, -n, m, n})
+          + path(gauge, i, {-n, m, n, -m});
+        plaq += trace(P).real();
+        F[mu][nu] = Complex(0.25) * antiHerm(C);
+        E -= trace(F[mu][nu] * F[mu][nu]).real();
+      }
+    }
+    Q += (trace(F[1][0] * F[3][2]) + trace(F[3][0] * F[2][1]) - trace(F[2][0] * F[3][1])).real();
+  }
+
+  obs[0] = plaq / (6 * 3 * V);
+  obs[1] = 2.0 * (6 * 3 - plaq / V);
+  obs[2] = E / V;
+  obs[3] = Q / (4 * M_PI * M_PI);
+}
+
+void gaugeObservablesReference(double obs[8], void **gauge)
+{
+  double plaq[2] = {0.0, 0.0}, rect = 0.0, wflow[4];
+  Complex poly = 0.0;
+  for (int i = 0; i < V; i++) {
+    for (int mu = 1; mu < 4; mu++) {
+      for (int nu = 0; nu < mu; nu++) {
+        const int m = mu + 1, n = nu + 1;
+        plaq[mu == 3 ? 1 : 0] += trace(path(gauge, i, {m, n, -m, -n})).real();
+        rect += trace(path(gauge, i, {m, m, n, -m, -m, -n})).real();
+        rect += trace(path(gauge, i, {m, n, n, -m, -n, -n})).real();
+      }
+    }
+    // the loops start on the t = 0 time slice
+    int x[4];
+    quda::getLatticeGeometry(Z).Coords(x, i);
+    if (x[3] == 0) poly += trace(path(gauge, i, std::vector<int>(Z[3], 4)));
+  }
+  wflowObservablesReference(wflow, gauge);
+
+  obs[1] = plaq[0] / (3 * 3 * V);
+  obs[2] = plaq[1] / (3 * 3 * V);
+  obs[0] = 0.5 * (obs[1] + obs[2]);
+  obs[3] = poly.real() / (3.0 * V / Z[3]);
+  obs[4] = poly.imag() / (3.0 * V / Z[3]);
+  obs[5] = rect / (3 * 12 * V);
+  obs[6] = wflow[2];
+  obs[7] = wflow[3];
+}
+
+double qChargeReference(void **gauge)
+{
+  double Q = 0.0;
+  for (int i = 0; i < V; i++) {
+    su3 F[4][4];
+    for (int mu = 1; mu < 4; mu++) {
+      for (int nu = 0; nu < mu; nu++) {
+        const int m = mu + 1, n = nu + 1;
+        const su3 C = path(gauge, i, {m, n, -m, -n}) + path(gauge, i, {n, -m, -n, m})
+          + path(gauge, i, {-m, -n, m, n}) + path(gauge, i, {-n, m, n, -m});
+        F[mu][nu] = Complex(0.125) * (C - dagger(C));
+      }
+    }
+    Q += (trace(F[1][0] * F[3][2]) + trace(F[3][0] * F[2][1]) - trace(F[2][0] * F[3][1])).real();
+  }
+  return Q / (4 * M_PI * M_PI);
+}
+
+void initReferenceGauge(void *gauge[4], QudaGaugeParam &gauge_param, const int X[4], QudaPrecision &prec)
+{
+  if (prec != QUDA_DOUBLE_PRECISION) prec = QUDA_SINGLE_PRECISION;
+
+  gauge_param = newQudaGaugeParam();
+  for (int d = 0; d < 4; d++) gauge_param.X[d] = X[d];
+  setDims(gauge_param.X);
+  gauge_param.anisotropy = 1.0;
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.ga_pad = 0;
+
+  for (int dir = 0; dir < 4; dir++) gauge[dir] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+  construct_gauge_field(gauge, 1, QUDA_DOUBLE_PRECISION, &gauge_param);
+}
+
+void freeReferenceGauge(void *gauge[4])
+{
+  for (int dir = 0; dir < 4; dir++) free(gauge[dir]);
+}
+
+GlobalReferenceGauge::GlobalReferenceGauge(void **local, const int X_[4])
+{
+  for (int d = 0; d < 4; d++) {
+    X[d] = X_[d];
+    G[d] = X[d] * comm_dim(d);
+  }
+  const quda::LatticeGeometry &l = quda::getLatticeGeometry(X);
+  const quda::LatticeGeometry &g = quda::getLatticeGeometry(G);
+
+  // each process fills in its own sites and the sum assembles the field
+  for (int dir = 0; dir < 4; dir++) gauge[dir] = calloc((size_t)g.Volume() * gaugeSiteSize, sizeof(double));
+  for (int i = 0; i < l.Volume(); i++) {
+    int x[4];
+    l.Coords(x, i);
+    for (int d = 0; d < 4; d++) x[d] += comm_coord(d) * X[d];
+    const int j = g.Index(x);
+    for (int dir = 0; dir < 4; dir++)
+      memcpy(static_cast<double *>(gauge[dir]) + (size_t)j * gaugeSiteSize,
+             static_cast<double *>(local[dir]) + (size_t)i * gaugeSiteSize, gaugeSiteSize * sizeof(double));
+  }
+  for (int dir = 0; dir < 4; dir++)
+    comm_allreduce_array(static_cast<double *>(gauge[dir]), (size_t)g.Volume() * gaugeSiteSize);
+
+  setDims(G);
+}
+
+GlobalReferenceGauge::~GlobalReferenceGauge()
+{
+  freeReferenceGauge(gauge);
+  setDims(X);
+}
+
+void GlobalReferenceGauge::scatter(void **local, void **global) const
+{
+  const quda::LatticeGeometry &l = quda::getLatticeGeometry(X);
+  const quda::LatticeGeometry &g = quda::getLatticeGeometry(G);
+  for (int i = 0; i < l.Volume(); i++) {
+    int x[4];
+    l.Coords(x, i);
+    for (int d = 0; d < 4; d++) x[d] += comm_coord(d) * X[d];
+    const int j = g.Index(x);
+    for (int dir = 0; dir < 4; dir++)
+      memcpy(static_cast<double *>(local[dir]) + (size_t)i * gaugeSiteSize,
+             static_cast<double *>(global[dir]) + (size_t)j * gaugeSiteSize, gaugeSiteSize * sizeof(double));
+  }
+}
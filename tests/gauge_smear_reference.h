@@ -0,0 +1,77 @@
+#ifndef _GAUGE_SMEAR_REFERENCE_H
+#define _GAUGE_SMEAR_REFERENCE_H
+
+#include <quda.h>
+
+/**
+   Serial reference for the smearing steps on a single-process
+   double-precision QDP-ordered gauge field with periodic boundaries.
+   The staples and rectangles are built as generic path products and
+   exp(iQ) is summed as a Taylor series, so the reference shares no
+   code with the library.
+*/
+
+void apeStepReference(void **out, void **in, double alpha);
+
+void stoutStepReference(void **out, void **in, double rho);
+
+void ovrImpStoutStepReference(void **out, void **in, double rho, double epsilon);
+
+/**
+   nSteps of the third-order Runge-Kutta gradient flow with step size
+   epsilon, written in its original (not low-storage) form
+*/
+void wflowReference(void **out, void **in, QudaWFlowType type, double epsilon, int nSteps);
+
+/**
+   The average plaquette, the energy density from the plaquette and
+   from the clover, and the topological charge, in the order of
+   WFlowObservables
+*/
+void wflowObservablesReference(double obs[4], void **gauge);
+
+/**
+   The plaquette, spatial and temporal plaquettes, the real and
+   imaginary parts of the Polyakov loop, the rectangle, the clover
+   energy density and the topological charge, in the order of
+   GaugeObservables
+*/
+void gaugeObservablesReference(double obs[8], void **gauge);
+
+/**
+   The topological charge from the field strength (C - C^dag) / 8 of
+   the clover C, as computeFmunu forms it
+*/
+double qChargeReference(void **gauge);
+
+/**
+   Set up the random host gauge field of dimensions X the references
+   act on, and restrict prec to the precisions of host fields
+*/
+void initReferenceGauge(void *gauge[4], QudaGaugeParam &gauge_param, const int X[4], QudaPrecision &prec);
+
+void freeReferenceGauge(void *gauge[4]);
+
+/**
+   The host gauge fields of all processes gathered into the unsplit
+   global field on every process, so that partitioned runs are checked
+   against the references on the global lattice.  While it exists the
+   dimensions of the test utilities (V, Z) are those of the global
+   lattice; on a single process it is a copy of the local field.
+*/
+struct GlobalReferenceGauge {
+  void *gauge[4];
+  int X[4]; // local dimensions
+  int G[4]; // global dimensions
+
+  GlobalReferenceGauge(void **local, const int X[4]);
+  ~GlobalReferenceGauge();
+
+  /**
+     Copy the sites of a global field owned by this process into a
+     local field
+  */
+  void scatter(void **local, void **global) const;
+};
+
+#endif // _GAUGE_SMEAR_REFERENCE_H
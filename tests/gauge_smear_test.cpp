@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <gauge_smear_reference.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test runs the APE, STOUT and over-improved STOUT smearing
+// steps on host gauge fields and compares them against the serial
+// reference on the unsplit lattice, also when the lattice is
+// partitioned.  The benchmark times --niter steps with the serial
+// reference, with one host step at a time (copying the field and
+// exchanging the halo every step) and with the multi-step pipeline.
+// The precision is taken from --prec.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern QudaVerbosity verbosity;
+extern int niter;
+extern void usage(char **argv);
+
+QudaGaugeParam gauge_param;
+void *hostGauge[4];
+
+enum SmearType { APE_SMEAR, STOUT_SMEAR, OVRIMP_STOUT_SMEAR };
+
+static const char *smear_names[] = {"APE", "STOUT", "OvrImpSTOUT"};
+
+static const double alpha = 0.6;
+static const double rho = 0.1;
+static const double epsilon = -0.25;
+
+class GaugeSmearTest : public ::testing::TestWithParam<int>
+{
+protected:
+  GaugeField *in;
+  GaugeField *out;
+
+  void SetUp()
+  {
+    GaugeFieldParam param(hostGauge, gauge_param);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(prec);
+    in = GaugeField::Create(param);
+    out = GaugeField::Create(param);
+
+    param.create = QUDA_REFERENCE_FIELD_CREATE;
+    param.setPrecision(QUDA_DOUBLE_PRECISION);
+    GaugeField *host = GaugeField::Create(param);
+    in->copy(*host);
+    delete host;
+  }
+
+  void TearDown()
+  {
+    delete in;
+    delete out;
+  }
+
+  void step(GaugeField &out, const GaugeField &in)
+  {
+    switch (GetParam()) {
+    case APE_SMEAR: APEStep(out, in, alpha); break;
+    case STOUT_SMEAR: STOUTStep(out, in, rho); break;
+    case OVRIMP_STOUT_SMEAR: OvrImpSTOUTStep(out, in, rho, epsilon); break;
+    }
+  }
+
+  void nStep(GaugeField &out, const GaugeField &in, int nSteps, int depth = 0)
+  {
+    switch (GetParam()) {
+    case APE_SMEAR: APEnStep(out, in, nSteps, alpha, depth); break;
+    case STOUT_SMEAR: STOUTnStep(out, in, nSteps, rho, depth); break;
+    case OVRIMP_STOUT_SMEAR: OvrImpSTOUTnStep(out, in, nSteps, rho, epsilon, depth); break;
+    }
+  }
+
+  void stepReference(void **out, void **in)
+  {
+    switch (GetParam()) {
+    case APE_SMEAR: apeStepReference(out, in, alpha); break;
+    case STOUT_SMEAR: stoutStepReference(out, in, rho); break;
+    case OVRIMP_STOUT_SMEAR: ovrImpStoutStepReference(out, in, rho, epsilon); break;
+    }
+  }
+
+  // nSteps of the serial reference on the unsplit lattice, starting
+  // from hostGauge, restricted to the sites of this process
+  void reference(void **ref, int nSteps)
+  {
+    GlobalReferenceGauge global(hostGauge, gauge_param.X);
+    void *tmp[4], *smeared[4];
+    for (int d = 0; d < 4; d++) {
+      tmp[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+      smeared[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+      memcpy(smeared[d], global.gauge[d], (size_t)V * gaugeSiteSize * sizeof(double));
+    }
+    for (int i = 0; i < nSteps; i++) {
+      stepReference(tmp, smeared);
+      for (int d = 0; d < 4; d++) std::swap(tmp[d], smeared[d]);
+    }
+    global.scatter(ref, smeared);
+    freeReferenceGauge(tmp);
+    freeReferenceGauge(smeared);
+  }
+
+  // largest element-wise deviation of a host field from a double QDP field
+  double deviation(const GaugeField &u, void **ref)
+  {
+    GaugeFieldParam param(hostGauge, gauge_param);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    GaugeField *u_d = GaugeField::Create(param);
+    u_d->copy(u);
+    double dev = 0.0;
+    for (int d = 0; d < 4; d++)
+      for (size_t i = 0; i < (size_t)V * gaugeSiteSize; i++)
+        dev = std::max(dev, fabs(static_cast<double **>(u_d->Gauge_p())[d][i] - static_cast<double *>(ref[d])[i]));
+    delete u_d;
+    return dev;
+  }
+
+  double tolerance() const { return prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-4; }
+};
+
+TEST_P(GaugeSmearTest, verify)
+{
+  const int nSteps = 3;
+  void *ref[4];
+  for (int d = 0; d < 4; d++) ref[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+
+  reference(ref, 1);
+  step(*out, *in);
+  EXPECT_LE(deviation(*out, ref), tolerance()) << "single step";
+
+  reference(ref, nSteps);
+  nStep(*out, *in, nSteps);
+  EXPECT_LE(deviation(*out, ref), tolerance()) << nSteps << " steps";
+
+  for (int d = 0; d < 4; d++) free(ref[d]);
+}
+
+TEST_P(GaugeSmearTest, depth)
+{
+  // every halo depth must give the same field: the halo only changes
+  // where each step is computed, not what.  The shallowest depth
+  // exchanges before every step (every other step for APE and STOUT),
+  // the deepest only once.
+  const int radius = GetParam() == OVRIMP_STOUT_SMEAR ? 2 : 1;
+  const int nSteps = 4;
+
+  nStep(*out, *in, nSteps, 2);
+  GaugeFieldParam param(*out);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  GaugeField *out2 = GaugeField::Create(param);
+  nStep(*out2, *in, nSteps, nSteps * radius);
+
+  void *ref[4];
+  for (int d = 0; d < 4; d++) ref[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+  GaugeFieldParam refParam(ref, gauge_param);
+  refParam.create = QUDA_REFERENCE_FIELD_CREATE;
+  GaugeField *ref_field = GaugeField::Create(refParam);
+  ref_field->copy(*out2);
+  EXPECT_EQ(deviation(*out, ref), 0.0);
+
+  // and the same as on the unsplit lattice
+  reference(ref, nSteps);
+  EXPECT_LE(deviation(*out, ref), tolerance());
+
+  delete ref_field;
+  for (int d = 0; d < 4; d++) free(ref[d]);
+  delete out2;
+}
+
+TEST_P(GaugeSmearTest, benchmark)
+{
+  quda::Timer timer;
+
+  double ref_secs = 0.0;
+  if (comm_size() == 1) {
+    void *ref[4];
+    for (int d = 0; d < 4; d++) ref[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+    timer.Start(__func__, __FILE__, __LINE__);
+    reference(ref, niter);
+    timer.Stop(__func__, __FILE__, __LINE__);
+    ref_secs = timer.Last();
+    for (int d = 0; d < 4; d++) free(ref[d]);
+  }
+
+  // one step at a time on an extended field, refreshing the halo every
+  // step as performSTOUTnStep does on the device; the depth is even for
+  // all three stencils so that the halo keeps the parity of the bulk
+  int R[4];
+  for (int d = 0; d < 4; d++) R[d] = comm_dim_partitioned(d) ? 2 : 0;
+  GaugeFieldParam param(*in);
+  for (int d = 0; d < 4; d++) {
+    param.x[d] += 2 * R[d];
+    param.r[d] = R[d];
+  }
+  param.nFace = 1;
+  param.ghostExchange = QUDA_GHOST_EXCHANGE_EXTENDED;
+  param.create = QUDA_NULL_FIELD_CREATE;
+  GaugeField *smeared = GaugeField::Create(param);
+  GaugeField *tmp = GaugeField::Create(param);
+  copyExtendedGauge(*smeared, *in, QUDA_CPU_FIELD_LOCATION);
+
+  step(*out, *in); // warm up and tune
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) {
+    tmp->copy(*smeared);
+    tmp->exchangeExtendedGhost(R, false);
+    step(*smeared, *tmp);
+  }
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double step_secs = timer.Last();
+  delete tmp;
+  delete smeared;
+
+  timer.Start(__func__, __FILE__, __LINE__);
+  nStep(*out, *in, niter);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double pipeline_secs = timer.Last();
+
+  printfQuda("%s, %d steps: reference %.3f s, host step %.3f s, host pipeline %.3f s\n", smear_names[GetParam()],
+             niter, ref_secs, step_secs, pipeline_secs);
+  RecordProperty("Steps", niter);
+  RecordProperty("ReferenceSecs", std::to_string(ref_secs));
+  RecordProperty("StepSecs", std::to_string(step_secs));
+  RecordProperty("PipelineSecs", std::to_string(pipeline_secs));
+}
+
+std::string getSmearName(testing::TestParamInfo<int> param) { return smear_names[param.param]; }
+
+INSTANTIATE_TEST_SUITE_P(QUDA, GaugeSmearTest, ::testing::Values(APE_SMEAR, STOUT_SMEAR, OVRIMP_STOUT_SMEAR),
+                         getSmearName);
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  initReferenceGauge(hostGauge, gauge_param, X, prec);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  freeReferenceGauge(hostGauge);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
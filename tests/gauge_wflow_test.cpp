@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <gauge_smear_reference.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test runs the Wilson, Symanzik and Zeuthen gradient flows on
+// host gauge fields.  The fixed-step integrator and the measurements
+// are compared against the serial reference on the unsplit lattice,
+// also when the lattice is partitioned, and the adaptive integrator
+// against a fixed step size much smaller than its own.  The benchmark
+// times --niter steps with and without the measurement fused into
+// every step, and --niter separate measurement passes.  The precision
+// is taken from --prec.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern QudaVerbosity verbosity;
+extern int niter;
+extern void usage(char **argv);
+
+QudaGaugeParam gauge_param;
+void *hostGauge[4];
+
+static const QudaWFlowType flow_types[] = {QUDA_WFLOW_TYPE_WILSON, QUDA_WFLOW_TYPE_SYMANZIK, QUDA_WFLOW_TYPE_ZEUTHEN};
+static const char *flow_names[] = {"Wilson", "Symanzik", "Zeuthen"};
+
+static const double epsilon = 0.01;
+
+class GaugeWFlowTest : public ::testing::TestWithParam<int>
+{
+protected:
+  GaugeField *in;
+  GaugeField *out;
+  QudaWFlowType type;
+
+  void SetUp()
+  {
+    type = flow_types[GetParam()];
+
+    GaugeFieldParam param(hostGauge, gauge_param);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(prec);
+    in = GaugeField::Create(param);
+    out = GaugeField::Create(param);
+
+    param.create = QUDA_REFERENCE_FIELD_CREATE;
+    param.setPrecision(QUDA_DOUBLE_PRECISION);
+    GaugeField *host = GaugeField::Create(param);
+    in->copy(*host);
+    delete host;
+  }
+
+  void TearDown()
+  {
+    delete in;
+    delete out;
+  }
+
+  // largest element-wise deviation of a host field from a double QDP field
+  double deviation(const GaugeField &u, void **ref)
+  {
+    GaugeFieldParam param(hostGauge, gauge_param);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    GaugeField *u_d = GaugeField::Create(param);
+    u_d->copy(u);
+    double dev = 0.0;
+    for (int d = 0; d < 4; d++)
+      for (size_t i = 0; i < (size_t)V * gaugeSiteSize; i++)
+        dev = std::max(dev, fabs(static_cast<double **>(u_d->Gauge_p())[d][i] - static_cast<double *>(ref[d])[i]));
+    delete u_d;
+    return dev;
+  }
+
+  double tolerance() const { return prec == QUDA_DOUBLE_PRECISION ? 1e-11 : 1e-4; }
+};
+
+TEST_P(GaugeWFlowTest, observables)
+{
+  double ref[4];
+  {
+    GlobalReferenceGauge global(hostGauge, gauge_param.X);
+    wflowObservablesReference(ref, global.gauge);
+  }
+  WFlowObservables obs = WFlowMeasure(*in);
+
+  EXPECT_NEAR(obs.plaquette, ref[0], tolerance());
+  EXPECT_NEAR(obs.E_plaq, ref[1], tolerance() * fabs(ref[1]));
+  EXPECT_NEAR(obs.E_clover, ref[2], tolerance() * fabs(ref[2]));
+  EXPECT_NEAR(obs.Q, ref[3], tolerance() * V * comm_size());
+}
+
+TEST_P(GaugeWFlowTest, verify)
+{
+  const int nSteps = 2;
+  std::vector<WFlowObservables> obs = WFlow(*out, *in, type, nSteps * epsilon, epsilon, 0.0, 1);
+
+  // a measurement at every step and at the end, the first fused with
+  // the first step
+  ASSERT_EQ(obs.size(), (size_t)nSteps + 1);
+  WFlowObservables obs0 = WFlowMeasure(*in);
+  EXPECT_EQ(obs[0].t, 0.0);
+  EXPECT_NEAR(obs[0].E_clover, obs0.E_clover, 1e-12 * fabs(obs0.E_clover));
+  EXPECT_NEAR(obs[0].Q, obs0.Q, 1e-12 * V);
+  EXPECT_NEAR(obs[nSteps].t, nSteps * epsilon, 1e-12);
+  WFlowObservables obsN = WFlowMeasure(*out);
+  EXPECT_NEAR(obs[nSteps].E_clover, obsN.E_clover, 1e-12 * fabs(obsN.E_clover));
+
+  // the flow decreases the action
+  for (int i = 0; i < nSteps; i++) EXPECT_LT(obs[i + 1].E_plaq, obs[i].E_plaq);
+
+  void *ref[4];
+  for (int d = 0; d < 4; d++) ref[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+  {
+    GlobalReferenceGauge global(hostGauge, gauge_param.X);
+    void *ref_global[4];
+    for (int d = 0; d < 4; d++) ref_global[d] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+    wflowReference(ref_global, global.gauge, type, epsilon, nSteps);
+    global.scatter(ref, ref_global);
+    freeReferenceGauge(ref_global);
+  }
+  EXPECT_LE(deviation(*out, ref), tolerance());
+  for (int d = 0; d < 4; d++) free(ref[d]);
+}
+
+TEST_P(GaugeWFlowTest, adaptive)
+{
+  const double t_max = 0.1;
+  std::vector<WFlowObservables> fixed = WFlow(*out, *in, type, t_max, 0.1 * epsilon, 0.0, 0);
+  fixed.push_back(WFlowMeasure(*out));
+
+  std::vector<WFlowObservables> adaptive = WFlow(*out, *in, type, t_max, epsilon, 1e-6, 1);
+  ASSERT_GE(adaptive.size(), 2u);
+  EXPECT_NEAR(adaptive.back().t, t_max, 1e-12);
+  EXPECT_NEAR(adaptive.back().E_clover, fixed.back().E_clover, 1e-5 * fabs(fixed.back().E_clover));
+  EXPECT_NEAR(adaptive.back().Q, fixed.back().Q, 1e-4);
+}
+
+TEST_P(GaugeWFlowTest, benchmark)
+{
+  quda::Timer timer;
+
+  WFlow(*out, *in, type, epsilon, epsilon, 0.0, 1); // warm up and tune
+  WFlowMeasure(*out);
+
+  timer.Start(__func__, __FILE__, __LINE__);
+  WFlow(*out, *in, type, niter * epsilon, epsilon, 0.0, 1);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double fused_secs = timer.Last();
+
+  // the same steps and allocations without measuring, so that the
+  // difference is the cost of the fused measurement
+  timer.Start(__func__, __FILE__, __LINE__);
+  WFlow(*out, *in, type, niter * epsilon, epsilon, 0.0, 0);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double flow_secs = timer.Last();
+
+  // a measurement between calls is a separate pass, which also extends
+  // the field and exchanges its halo
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) WFlowMeasure(*out);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double separate_secs = timer.Last();
+
+  printfQuda("%s flow, %d steps: %.3f s, fused measurement %.3f s, separate measurement passes %.3f s\n",
+             flow_names[GetParam()], niter, flow_secs, fused_secs - flow_secs, separate_secs);
+  RecordProperty("Steps", niter);
+  RecordProperty("FlowSecs", std::to_string(flow_secs));
+  RecordProperty("FusedSecs", std::to_string(fused_secs));
+  RecordProperty("SeparateSecs", std::to_string(separate_secs));
+}
+
+std::string getFlowName(testing::TestParamInfo<int> param) { return flow_names[param.param]; }
+
+INSTANTIATE_TEST_SUITE_P(QUDA, GaugeWFlowTest, ::testing::Range(0, 3), getFlowName);
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  initReferenceGauge(hostGauge, gauge_param, X, prec);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  freeReferenceGauge(hostGauge);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -17,6 +17,8 @@
 
 #include <qio_field.h>
 
+#include <gtest/gtest.h>
+
 #if defined(QMP_COMMS)
 #include <qmp.h>
 #elif defined(MPI_COMMS)
@@ -146,8 +148,84 @@ void CallUnitarizeLinks(quda::cudaGaugeField *cudaInGauge){
    device_free(num_failures_dev);
   }
 
+// largest difference of any link element between two host fields
+template <typename Float>
+double maxLinkDeviation(const quda::GaugeField &a, const quda::GaugeField &b){
+  double dev = 0.0;
+  for (int dir = 0; dir < 4; dir++) {
+    const Float *u = static_cast<const Float*>(static_cast<void* const*>(a.Gauge_p())[dir]);
+    const Float *v = static_cast<const Float*>(static_cast<void* const*>(b.Gauge_p())[dir]);
+    for (size_t i = 0; i < (size_t)a.Volume() * gaugeSiteSize; i++) dev = MAX(dev, DABS(u[i] - v[i]));
+  }
+  comm_allreduce_max(&dev);
+  return dev;
+}
+
+// the state of the device run the host heatbath is checked against
+struct HostHeatbathInput {
+  quda::cudaGaugeField *gaugeEx;
+  quda::RNG *randstates;
+  double beta_value;
+  int nhbsteps;
+};
+static HostHeatbathInput host_heatbath;
+
+TEST(HostHeatbath, benchmark)
+{
+  using namespace quda;
+  cudaGaugeField *gaugeEx = host_heatbath.gaugeEx;
+  RNG *randstates = host_heatbath.randstates;
+  const double beta_value = host_heatbath.beta_value;
+  const int nhbsteps = host_heatbath.nhbsteps;
+
+  // host copy of the extended field in QDP order
+  GaugeFieldParam gParamHost(*gaugeEx);
+  gParamHost.location = QUDA_CPU_FIELD_LOCATION;
+  gParamHost.create = QUDA_NULL_FIELD_CREATE;
+  gParamHost.order = QUDA_QDP_GAUGE_ORDER;
+  gParamHost.reconstruct = QUDA_RECONSTRUCT_NO;
+  gParamHost.pad = 0;
+  gParamHost.setPrecision(gaugeEx->Precision());
+  cpuGaugeField *hostEx = new cpuGaugeField(gParamHost);
+  cpuGaugeField *check = new cpuGaugeField(gParamHost);
+  hostEx->copy(*gaugeEx);
+
+  // overrelaxation is deterministic, so both must agree to rounding
+  PhiloxRNG rng(1234);
+  Monte(*hostEx, rng, beta_value, 0, 1);
+  Monte(*gaugeEx, *randstates, beta_value, 0, 1);
+  check->copy(*gaugeEx);
+  double dev = gaugeEx->Precision() == QUDA_DOUBLE_PRECISION ? maxLinkDeviation<double>(*hostEx, *check) :
+    maxLinkDeviation<float>(*hostEx, *check);
+  printfQuda("Overrelaxation: max host-device link deviation = %e\n", dev);
+  EXPECT_LE(dev, gaugeEx->Precision() == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4);
+
+  // the heatbath draws different random numbers, so compare its statistics
+  MonteStats host = {}, device = {};
+  Monte(*hostEx, rng, beta_value, nhbsteps, 0, &host);
+  Monte(*gaugeEx, *randstates, beta_value, nhbsteps, 0, &device);
+  double3 host_plaq = plaquette(*hostEx);
+  double3 device_plaq = plaquette(*gaugeEx);
+  double counts[6] = {(double)host.updates, (double)host.trials, (double)host.failures,
+                      (double)device.updates, (double)device.trials, (double)device.failures};
+  comm_allreduce_array(counts, 6);
+  printfQuda("Heatbath (%d sweeps): host %.6f s/sweep, acceptance %.6f, failures %.0f, plaquette %e\n", nhbsteps,
+             host.hb_secs / nhbsteps, counts[0] / counts[1], counts[2], host_plaq.x);
+  printfQuda("Heatbath (%d sweeps): device %.6f s/sweep, acceptance %.6f, failures %.0f, plaquette %e\n", nhbsteps,
+             device.hb_secs / nhbsteps, counts[3] / counts[4], counts[5], device_plaq.x);
+  // the Kennedy-Pendleton acceptance stays well above one half, and the
+  // two rates agree to many times their statistical error
+  EXPECT_GT(counts[0] / counts[1], 0.5);
+  EXPECT_NEAR(counts[0] / counts[1], counts[3] / counts[4], 0.02);
+
+  delete check;
+  delete hostEx;
+}
+
 int main(int argc, char **argv)
 {
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
 
   for (int i = 1; i < argc; i++){
     if(process_command_line_option(argc, argv, &i) == 0){
@@ -195,6 +273,7 @@ int main(int argc, char **argv)
 
   // start the timer
   double time0 = -((double)clock());
+  int test_rc = 0;
 
   // initialize the QUDA library
   initQuda(device);
@@ -346,6 +425,12 @@ int main(int argc, char **argv)
       printfQuda("No output file specified.\n");
     }
 
+    // host heatbath and overrelaxation against the device ones
+    host_heatbath = {gaugeEx, randstates, beta_value, MAX(nhbsteps, 1)};
+    ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+    if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+    test_rc = RUN_ALL_TESTS();
+
     delete gauge;
     delete gaugeEx;
     //Release all temporary memory used for data exchange between GPUs in multi-GPU mode
@@ -374,5 +459,5 @@ int main(int argc, char **argv)
 
   for (int dir = 0; dir<4; dir++) free(load_gauge[dir]);
 
-  return 0;
+  return test_rc;
 }
@@ -0,0 +1,241 @@
+#ifndef _HOST_DIRAC_MATRIX_H
+#define _HOST_DIRAC_MATRIX_H
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <dirac_quda.h>
+#include <multigrid.h>
+#include <comm_quda.h>
+#include <wilson_dslash_reference.h>
+#include <test_util.h>
+
+/**
+   The even-odd preconditioned Wilson operator M, or the normal
+   operator M^dag M, applied with the host reference dslash so that
+   solvers can be run end to end on host fields.  There is no
+   underlying Dirac object, so flops are not counted, but the
+   applications are.
+*/
+class HostWilsonMatrix : public quda::DiracMatrix
+{
+  void *const *gauge[2]; // double and single precision copies
+  const QudaGaugeParam &gauge_param;
+  const double kappa;
+  const QudaMatPCType matpc_type;
+  const bool normal;
+  mutable long long applications;
+
+  void apply(quda::ColorSpinorField &out, const quda::ColorSpinorField &in) const
+  {
+    const QudaPrecision precision = in.Precision();
+    void **g = const_cast<void **>(gauge[precision == QUDA_DOUBLE_PRECISION ? 0 : 1]);
+    QudaGaugeParam param = gauge_param;
+    param.cpu_prec = precision;
+
+    void *v = const_cast<quda::ColorSpinorField &>(in).V();
+    if (normal) {
+      quda::ColorSpinorParam tmpParam(in);
+      tmpParam.create = QUDA_NULL_FIELD_CREATE;
+      quda::ColorSpinorField *tmp = quda::ColorSpinorField::Create(tmpParam);
+      wil_matpc(tmp->V(), g, v, kappa, matpc_type, 0, precision, param);
+      wil_matpc(out.V(), g, tmp->V(), kappa, matpc_type, 1, precision, param);
+      delete tmp;
+    } else {
+      wil_matpc(out.V(), g, v, kappa, matpc_type, 0, precision, param);
+    }
+    applications++;
+  }
+
+public:
+  HostWilsonMatrix(void *gauge_[2][4], const QudaGaugeParam &gauge_param, double kappa, QudaMatPCType matpc_type,
+                   bool normal) :
+    DiracMatrix(static_cast<const quda::Dirac *>(nullptr)),
+    gauge {gauge_[0], gauge_[1]},
+    gauge_param(gauge_param),
+    kappa(kappa),
+    matpc_type(matpc_type),
+    normal(normal),
+    applications(0)
+  {
+  }
+
+  void operator()(quda::ColorSpinorField &out, const quda::ColorSpinorField &in) const { apply(out, in); }
+  void operator()(quda::ColorSpinorField &out, const quda::ColorSpinorField &in, quda::ColorSpinorField &) const
+  {
+    apply(out, in);
+  }
+  void operator()(quda::ColorSpinorField &out, const quda::ColorSpinorField &in, quda::ColorSpinorField &,
+                  quda::ColorSpinorField &) const
+  {
+    apply(out, in);
+  }
+
+  int getStencilSteps() const { return normal ? 2 : 1; }
+
+  long long Applications() const { return applications; }
+  void resetApplications() { applications = 0; }
+};
+
+/**
+   Set up the fields the host Wilson tests run on: a random gauge
+   field of dimensions X in double precision with a single-precision
+   copy, and the parity spinor parameters in precision prec.  The
+   precisions are restricted to those of host fields.
+*/
+inline void initHostWilson(void *hostGauge[2][4], QudaGaugeParam &gauge_param, quda::ColorSpinorParam &csParam,
+                           const int X[4], QudaPrecision &prec, QudaPrecision &prec_sloppy)
+{
+  if (prec != QUDA_DOUBLE_PRECISION) prec = QUDA_SINGLE_PRECISION;
+  if (prec_sloppy == QUDA_INVALID_PRECISION) prec_sloppy = prec;
+  if (prec_sloppy != QUDA_DOUBLE_PRECISION) prec_sloppy = QUDA_SINGLE_PRECISION;
+
+  gauge_param = newQudaGaugeParam();
+  for (int d = 0; d < 4; d++) gauge_param.X[d] = X[d];
+  setDims(gauge_param.X);
+  gauge_param.anisotropy = 1.0;
+  gauge_param.type = QUDA_WILSON_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_ANTI_PERIODIC_T;
+  gauge_param.cpu_prec = QUDA_DOUBLE_PRECISION;
+  gauge_param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  gauge_param.ga_pad = 0;
+
+  for (int dir = 0; dir < 4; dir++) {
+    hostGauge[0][dir] = malloc((size_t)V * gaugeSiteSize * sizeof(double));
+    hostGauge[1][dir] = malloc((size_t)V * gaugeSiteSize * sizeof(float));
+  }
+  construct_gauge_field(hostGauge[0], 1, QUDA_DOUBLE_PRECISION, &gauge_param);
+  for (int dir = 0; dir < 4; dir++)
+    for (size_t i = 0; i < (size_t)V * gaugeSiteSize; i++)
+      static_cast<float *>(hostGauge[1][dir])[i] = static_cast<double *>(hostGauge[0][dir])[i];
+
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+  csParam.setPrecision(prec);
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_PARITY_SITE_SUBSET;
+  csParam.x[0] /= 2;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  csParam.location = QUDA_CPU_FIELD_LOCATION;
+}
+
+inline void freeHostWilson(void *hostGauge[2][4])
+{
+  for (int p = 0; p < 2; p++)
+    for (int dir = 0; dir < 4; dir++) free(hostGauge[p][dir]);
+}
+
+/**
+   A coarsest-level multigrid operator on host fields: random coarse
+   links Y and clover X with nColor colors and two spins, wrapped in
+   a DiracCoarse and its even-odd preconditioned DiracCoarsePC as the
+   multigrid sets up a level whose location is the host.  The hopping
+   terms are scaled so that the operator stays well conditioned.
+   Solvers run on it through DiracM and friends, which expose the
+   Dirac object to the normal-equation solvers.
+*/
+class HostCoarseDirac
+{
+  quda::cpuGaugeField *Y, *X, *Yhat, *Xinv;
+  quda::DiracCoarse *coarse;
+
+  template <typename Float> static void random(quda::GaugeField &u, int geometry, double scale, bool identity)
+  {
+    const int n = u.Ncolor();
+    for (int g = 0; g < geometry; g++) {
+      Float *v = static_cast<Float **>(u.Gauge_p())[g];
+      for (size_t i = 0; i < (size_t)u.Volume() * n * n; i++) {
+        v[2 * i + 0] = scale * (2.0 * rand() / RAND_MAX - 1.0);
+        v[2 * i + 1] = scale * (2.0 * rand() / RAND_MAX - 1.0);
+        if (identity && (i % (n * n)) % (n + 1) == 0) v[2 * i] += 1.0;
+      }
+    }
+  }
+
+  static void random(quda::GaugeField &u, int geometry, double scale, bool identity)
+  {
+    if (u.Precision() == QUDA_DOUBLE_PRECISION) random<double>(u, geometry, scale, identity);
+    else random<float>(u, geometry, scale, identity);
+  }
+
+public:
+  quda::DiracCoarsePC *dirac;
+  quda::ColorSpinorParam csParam; // parity spinors of the operator
+
+  HostCoarseDirac(const int dims[4], int nColor, QudaPrecision precision)
+  {
+    quda::GaugeFieldParam gParam;
+    for (int d = 0; d < 4; d++) gParam.x[d] = dims[d];
+    gParam.nColor = 2 * nColor;
+    gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+    gParam.order = QUDA_QDP_GAUGE_ORDER;
+    gParam.link_type = QUDA_COARSE_LINKS;
+    gParam.t_boundary = QUDA_PERIODIC_T;
+    gParam.create = QUDA_ZERO_FIELD_CREATE;
+    gParam.setPrecision(precision);
+    gParam.nDim = 4;
+    gParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
+    gParam.nFace = 1;
+    gParam.geometry = QUDA_COARSE_GEOMETRY;
+    gParam.pad = 0;
+    Y = new quda::cpuGaugeField(gParam);
+    Yhat = new quda::cpuGaugeField(gParam);
+
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    gParam.nFace = 0;
+    gParam.geometry = QUDA_SCALAR_GEOMETRY;
+    X = new quda::cpuGaugeField(gParam);
+    Xinv = new quda::cpuGaugeField(gParam);
+
+    // the eight hopping terms sum to well below the identity clover
+    random(*Y, 8, 1.0 / (8 * sqrt(2.0 * nColor)), false);
+    random(*X, 1, 0.1 / sqrt(2.0 * nColor), true);
+    quda::calculateYhat(*Yhat, *Xinv, *Y, *X);
+
+    quda::DiracParam param;
+    param.type = QUDA_COARSEPC_DIRAC;
+    param.kappa = 1.0;
+    param.mass = 0.0;
+    param.matpcType = QUDA_MATPC_EVEN_EVEN;
+    param.dagger = QUDA_DAG_NO;
+    for (int d = 0; d < 4; d++) param.commDim[d] = comm_dim_partitioned(d);
+    coarse = new quda::DiracCoarse(param, Y, X, Xinv, Yhat, nullptr, nullptr, nullptr, nullptr);
+    dirac = new quda::DiracCoarsePC(*coarse, param);
+
+    csParam.nColor = nColor;
+    csParam.nSpin = 2;
+    csParam.nDim = 4;
+    for (int d = 0; d < 4; d++) csParam.x[d] = dims[d];
+    csParam.setPrecision(precision);
+    csParam.pad = 0;
+    csParam.siteSubset = QUDA_PARITY_SITE_SUBSET;
+    csParam.x[0] /= 2;
+    csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    csParam.location = QUDA_CPU_FIELD_LOCATION;
+  }
+
+  ~HostCoarseDirac()
+  {
+    delete dirac;
+    delete coarse;
+    delete Xinv;
+    delete X;
+    delete Yhat;
+    delete Y;
+  }
+};
+
+#endif // _HOST_DIRAC_MATRIX_H
@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <host_dirac_matrix.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test runs the solvers end to end on host fields, with the
+// Wilson operator applied by the host reference dslash.  Hermitian
+// solvers are given the normal operator M^dag M, the others the
+// even-odd preconditioned operator M.  A second set of solves runs on
+// a random coarsest-level multigrid operator on the host, including
+// the normal-equation solvers, which need its Dirac object.  The
+// precisions are taken from --prec and --prec-sloppy and the
+// tolerance from --tol.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern QudaPrecision prec_sloppy;
+extern QudaMatPCType matpc_type;
+extern QudaVerbosity verbosity;
+extern double kappa;
+extern double tol;
+extern void usage(char **argv);
+
+ColorSpinorParam csParam;
+QudaGaugeParam gauge_param;
+void *hostGauge[2][4]; // double and single precision copies
+
+struct HostSolver {
+  QudaInverterType inv_type;
+  QudaInverterType precon_type;
+  bool hermitian;
+  int n_krylov;
+};
+
+static const HostSolver solvers[] = {
+  {QUDA_CG_INVERTER, QUDA_INVALID_INVERTER, true, 0},
+  {QUDA_CG3_INVERTER, QUDA_INVALID_INVERTER, true, 0},
+  {QUDA_PCG_INVERTER, QUDA_INVALID_INVERTER, true, 0},
+  {QUDA_PCG_INVERTER, QUDA_POLYNOMIAL_INVERTER, true, 0},
+  {QUDA_CA_CG_INVERTER, QUDA_INVALID_INVERTER, true, 4},
+  {QUDA_BICGSTAB_INVERTER, QUDA_INVALID_INVERTER, false, 0},
+  {QUDA_BICGSTABL_INVERTER, QUDA_INVALID_INVERTER, false, 4},
+  {QUDA_GCR_INVERTER, QUDA_INVALID_INVERTER, false, 16},
+  {QUDA_GCR_INVERTER, QUDA_MR_INVERTER, false, 16},
+  {QUDA_CA_GCR_INVERTER, QUDA_INVALID_INVERTER, false, 4},
+  {QUDA_GMRESDR_INVERTER, QUDA_INVALID_INVERTER, false, 32},
+  {QUDA_GCRODR_INVERTER, QUDA_INVALID_INVERTER, false, 32},
+#ifdef SSTEP
+  {QUDA_MPCG_INVERTER, QUDA_INVALID_INVERTER, true, 0},
+  {QUDA_MPBICGSTAB_INVERTER, QUDA_INVALID_INVERTER, false, 0},
+#endif
+};
+
+// solvers run on the coarsest level; the CGNE and CGNR variants form
+// the normal operators from the Dirac object behind M
+static const HostSolver coarse_solvers[] = {
+  {QUDA_CG_INVERTER, QUDA_INVALID_INVERTER, true, 0},
+  {QUDA_CGNE_INVERTER, QUDA_INVALID_INVERTER, false, 0},
+  {QUDA_CGNR_INVERTER, QUDA_INVALID_INVERTER, false, 0},
+  {QUDA_CA_CGNE_INVERTER, QUDA_INVALID_INVERTER, false, 4},
+  {QUDA_CA_CGNR_INVERTER, QUDA_INVALID_INVERTER, false, 4},
+  {QUDA_BICGSTAB_INVERTER, QUDA_INVALID_INVERTER, false, 0},
+  {QUDA_GCR_INVERTER, QUDA_INVALID_INVERTER, false, 16},
+  {QUDA_CA_GCR_INVERTER, QUDA_INVALID_INVERTER, false, 4},
+};
+
+static QudaInvertParam hostInvertParam(const HostSolver &solver, QudaPrecision prec, QudaPrecision prec_sloppy)
+{
+  QudaInvertParam inv_param = newQudaInvertParam();
+  inv_param.inv_type = solver.inv_type;
+  inv_param.inv_type_precondition = solver.precon_type;
+  inv_param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  inv_param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+  inv_param.preserve_source = QUDA_PRESERVE_SOURCE_YES;
+  inv_param.tol = tol;
+  inv_param.tol_restart = 1e-3;
+  inv_param.tol_hq = 0.0;
+  inv_param.heavy_quark_check = 0;
+  inv_param.maxiter = 10000;
+  inv_param.reliable_delta = 1e-1;
+  inv_param.use_alternative_reliable = 0;
+  inv_param.max_res_increase = 1;
+  inv_param.max_res_increase_total = 10;
+  inv_param.compute_true_res = 1;
+  inv_param.pipeline = 0;
+  inv_param.solution_accumulator_pipeline = 1;
+  inv_param.use_sloppy_partial_accumulator = 0;
+  inv_param.Nsteps = 2;
+  inv_param.gcrNkrylov = solver.n_krylov;
+  // search space, deflated subspace and restart cycles of the deflating GMRES solvers
+  inv_param.max_search_dim = solver.n_krylov;
+  inv_param.nev = 8;
+  inv_param.deflation_grid = 64;
+  inv_param.ca_basis = QUDA_POWER_BASIS;
+  inv_param.ca_lambda_min = 0.0;
+  inv_param.ca_lambda_max = -1.0;
+  inv_param.schwarz_type = QUDA_INVALID_SCHWARZ;
+  inv_param.precondition_cycle = 1;
+  inv_param.tol_precondition = 1e-1;
+  inv_param.maxiter_precondition = 8;
+  inv_param.verbosity_precondition = QUDA_SILENT;
+  inv_param.omega = 1.0;
+  inv_param.cuda_prec = prec;
+  inv_param.cuda_prec_sloppy = prec_sloppy;
+  inv_param.cuda_prec_refinement_sloppy = prec;
+  inv_param.cuda_prec_precondition = prec_sloppy;
+  inv_param.num_offset = 0;
+  inv_param.iter = 0;
+  inv_param.secs = 0;
+  inv_param.gflops = 0;
+  return inv_param;
+}
+
+class HostSolverTest : public ::testing::TestWithParam<int>
+{
+protected:
+  ColorSpinorField *b;
+  ColorSpinorField *x;
+  HostWilsonMatrix *mat;
+  QudaInvertParam inv_param;
+  TimeProfile profile;
+
+  HostSolverTest() : profile("HostSolverTest") {}
+
+  void SetUp()
+  {
+    const HostSolver &solver = solvers[GetParam()];
+
+    b = ColorSpinorField::Create(csParam);
+    b->Source(QUDA_RANDOM_SOURCE);
+    x = ColorSpinorField::Create(csParam);
+    mat = new HostWilsonMatrix(hostGauge, gauge_param, kappa > 0.0 ? kappa : 0.12, matpc_type, solver.hermitian);
+
+    inv_param = hostInvertParam(solver, prec, prec_sloppy);
+  }
+
+  void TearDown()
+  {
+    delete b;
+    delete x;
+    delete mat;
+  }
+
+  // |b - (A + shift) x| / |b| computed independently of the solver
+  double residual(ColorSpinorField &x, ColorSpinorField &b, double shift = 0.0)
+  {
+    ColorSpinorField *r = ColorSpinorField::Create(csParam);
+    (*mat)(*r, x);
+    if (shift != 0.0) blas::axpy(shift, x, *r);
+    double r2 = blas::xmyNorm(b, *r);
+    delete r;
+    return sqrt(r2 / blas::norm2(b));
+  }
+};
+
+TEST_P(HostSolverTest, verify)
+{
+  SolverParam param(inv_param);
+  Solver *solver = Solver::create(param, *mat, *mat, *mat, profile);
+  (*solver)(*x, *b);
+  delete solver;
+
+  EXPECT_GT(param.iter, 0);
+  EXPECT_LT(param.iter, inv_param.maxiter);
+  EXPECT_LE(residual(*x, *b), 2 * tol);
+}
+
+TEST_P(HostSolverTest, multiShift)
+{
+  if (inv_param.inv_type != QUDA_CG_INVERTER) GTEST_SKIP();
+
+  inv_param.num_offset = 3;
+  for (int i = 0; i < inv_param.num_offset; i++) {
+    inv_param.offset[i] = 0.01 * (i + 1);
+    inv_param.tol_offset[i] = tol;
+  }
+  inv_param.cuda_prec_sloppy = prec;
+
+  std::vector<ColorSpinorField *> xs(inv_param.num_offset);
+  for (auto &v : xs) v = ColorSpinorField::Create(csParam);
+
+  SolverParam param(inv_param);
+  MultiShiftCG cg(*mat, *mat, param, profile);
+  cg(xs, *b);
+
+  for (int i = 0; i < inv_param.num_offset; i++)
+    EXPECT_LE(residual(*xs[i], *b, inv_param.offset[i]), 2 * tol) << "shift " << i;
+
+  for (auto &v : xs) delete v;
+}
+
+std::string getSolverName(testing::TestParamInfo<int> param)
+{
+  const HostSolver &solver = solvers[param.param];
+  std::string name = get_solver_str(solver.inv_type);
+  if (solver.precon_type != QUDA_INVALID_INVERTER) name += std::string("_") + get_solver_str(solver.precon_type);
+  for (auto &c : name)
+    if (c == '-') c = '_';
+  return name;
+}
+
+INSTANTIATE_TEST_SUITE_P(QUDA, HostSolverTest, ::testing::Range(0, (int)(sizeof(solvers) / sizeof(solvers[0]))),
+                         getSolverName);
+
+class HostCoarseSolverTest : public ::testing::TestWithParam<int>
+{
+protected:
+  HostCoarseDirac *coarse;
+  DiracMatrix *mat;
+  ColorSpinorField *b;
+  ColorSpinorField *x;
+  QudaInvertParam inv_param;
+  TimeProfile profile;
+
+  HostCoarseSolverTest() : coarse(nullptr), mat(nullptr), b(nullptr), x(nullptr), profile("HostCoarseSolverTest") {}
+
+  void SetUp()
+  {
+#ifndef GPU_MULTIGRID
+    GTEST_SKIP() << "multigrid is not built";
+#endif
+    // a 4^4 blocking of the fine lattice with 24 null-space vectors
+    int dims[4];
+    for (int d = 0; d < 4; d++) {
+      dims[d] = gauge_param.X[d] / 4;
+      if (dims[d] < 2 || dims[d] % 2 != 0) GTEST_SKIP() << "lattice does not block to an even coarse lattice";
+    }
+#ifdef GPU_MULTIGRID_DOUBLE
+    const QudaPrecision coarse_prec = prec;
+#else
+    const QudaPrecision coarse_prec = QUDA_SINGLE_PRECISION;
+#endif
+    coarse = new HostCoarseDirac(dims, 24, coarse_prec);
+
+    const HostSolver &solver = coarse_solvers[GetParam()];
+    if (solver.hermitian) mat = new DiracMdagM(coarse->dirac);
+    else mat = new DiracM(coarse->dirac);
+
+    b = ColorSpinorField::Create(coarse->csParam);
+    b->Source(QUDA_RANDOM_SOURCE);
+    x = ColorSpinorField::Create(coarse->csParam);
+
+    inv_param = hostInvertParam(solver, coarse_prec, coarse_prec);
+    if (coarse_prec != QUDA_DOUBLE_PRECISION) inv_param.tol = std::max(tol, 1e-5);
+  }
+
+  void TearDown()
+  {
+    delete b;
+    delete x;
+    delete mat;
+    delete coarse;
+  }
+};
+
+TEST_P(HostCoarseSolverTest, verify)
+{
+  SolverParam param(inv_param);
+  Solver *solver = Solver::create(param, *mat, *mat, *mat, profile);
+  (*solver)(*x, *b);
+  delete solver;
+
+  EXPECT_GT(param.iter, 0);
+  EXPECT_LT(param.iter, inv_param.maxiter);
+
+  // CGNE and CGNR return the solution of M x = b
+  ColorSpinorField *r = ColorSpinorField::Create(coarse->csParam);
+  (*mat)(*r, *x);
+  EXPECT_LE(sqrt(blas::xmyNorm(*b, *r) / blas::norm2(*b)), 2 * inv_param.tol);
+  delete r;
+}
+
+std::string getCoarseSolverName(testing::TestParamInfo<int> param)
+{
+  std::string name = get_solver_str(coarse_solvers[param.param].inv_type);
+  for (auto &c : name)
+    if (c == '-') c = '_';
+  return name;
+}
+
+INSTANTIATE_TEST_SUITE_P(QUDA, HostCoarseSolverTest,
+                         ::testing::Range(0, (int)(sizeof(coarse_solvers) / sizeof(coarse_solvers[0]))),
+                         getCoarseSolverName);
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  initHostWilson(hostGauge, gauge_param, csParam, X, prec, prec_sloppy);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  freeHostWilson(hostGauge);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -46,6 +46,9 @@ extern double reliable_delta; // reliable update parameter
 extern bool alternative_reliable;
 extern QudaInverterType  precon_type;
 extern int multishift; // whether to test multi-shift or standard solver
+extern int multishift_num_offset; // number of shifts in the multi-shift solver
+extern bool batched_refinement; // whether to refine the under-converged shifts together
+extern bool compare_refinement; // whether to compare batched against sequential refinement
 extern double mass; // mass of Dirac operator
 extern double kappa; // kappa of Dirac operator
 extern double mu;
@@ -208,9 +211,9 @@ int main(int argc, char **argv)
   }
 
   // offsets used only by multi-shift solver
-  inv_param.num_offset = 12;
-  double offset[12] = {0.01, 0.02, 0.03, 0.04, 0.05, 0.06, 0.07, 0.08, 0.09, 0.1, 0.11, 0.12};
-  for (int i=0; i<inv_param.num_offset; i++) inv_param.offset[i] = offset[i];
+  inv_param.num_offset = multishift_num_offset;
+  for (int i=0; i<inv_param.num_offset; i++) inv_param.offset[i] = 0.01 * (i + 1);
+  inv_param.batched_refinement = batched_refinement ? 1 : 0;
 
   inv_param.inv_type = inv_type;
   inv_param.solution_type = solution_type;
@@ -387,11 +390,25 @@ int main(int argc, char **argv)
   auto *rng = new quda::RNG(quda::LatticeFieldParam(gauge_param), 1234);
   rng->Init();
 
+  // iterations and time of the sequential and batched refinement when comparing them
+  int refine_iter[2] = {0, 0};
+  double refine_secs[2] = {0.0, 0.0};
+
   for (int i = 0; i < Nsrc; i++) {
 
     construct_spinor_source(spinorIn, 4, 3, inv_param.cpu_prec, gauge_param.X, *rng);
 
-    if (multishift) {
+    if (multishift && compare_refinement) {
+      // the multi-shift solves are identical, so the differences are those of the refinement
+      for (int batched = 0; batched < 2; batched++) {
+        inv_param.batched_refinement = batched;
+        invertMultiShiftQuda(spinorOutMulti, spinorIn, &inv_param);
+        printfQuda("%s refinement: %i iter / %g secs\n", batched ? "Batched" : "Sequential", inv_param.iter,
+                   inv_param.secs);
+        refine_iter[batched] += inv_param.iter;
+        refine_secs[batched] += inv_param.secs;
+      }
+    } else if (multishift) {
       invertMultiShiftQuda(spinorOutMulti, spinorIn, &inv_param);
     } else {
       invertQuda(spinorOut, spinorIn, &inv_param);
@@ -429,6 +446,11 @@ int main(int argc, char **argv)
   delete[] time;
   delete[] gflops;
 
+  if (multishift && compare_refinement) {
+    printfQuda("Refinement of %d shifts over %d solves: sequential %d iter / %g secs, batched %d iter / %g secs\n",
+               inv_param.num_offset, Nsrc, refine_iter[0], refine_secs[0], refine_iter[1], refine_secs[1]);
+  }
+
   if (multishift) {
     if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
       errorQuda("Mass normalization not supported for multi-shift solver in invert_test");
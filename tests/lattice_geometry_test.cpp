@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <lattice_geometry.h>
+#include <timer.h>
+
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the host LatticeGeometry neighbour tables against
+// the direct coordinate arithmetic they replace, with and without a
+// halo, and benchmarks a host stencil sweep with both so the cost of
+// the per-neighbour index computation can be read off.
+
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern int niter;
+extern void usage(char **argv);
+
+int X[4];
+
+// reference: decode the full even-odd index, displace, re-encode
+static int directNeighbor(const int *X, const int *R, int i, const int dx[4])
+{
+  const int volumeCB = X[0] * X[1] * X[2] * X[3] / 2;
+  const int parity = i >= volumeCB ? 1 : 0;
+  const int x_cb = i - parity * volumeCB;
+
+  int x[4];
+  int za = x_cb / (X[0] / 2);
+  int zb = za / X[1];
+  x[1] = za - zb * X[1];
+  x[3] = zb / X[2];
+  x[2] = zb - x[3] * X[2];
+  x[0] = 2 * (x_cb - za * (X[0] / 2)) + ((x[1] + x[2] + x[3] + parity) & 1);
+
+  int E[4];
+  for (int d = 0; d < 4; d++) {
+    E[d] = X[d] + 2 * R[d];
+    x[d] = R[d] ? x[d] + dx[d] + R[d] : (x[d] + dx[d] + 64 * X[d]) % X[d];
+  }
+  const int volumeExCB = E[0] * E[1] * E[2] * E[3] / 2;
+  return ((x[0] + x[1] + x[2] + x[3]) & 1) * volumeExCB + (((x[3] * E[2] + x[2]) * E[1] + x[1]) * E[0] + x[0]) / 2;
+}
+
+// displacements exercised by the host stencils: single hops up to the
+// Naik and long-link range, and the diagonal offsets of staples and
+// gauge-force paths
+static std::vector<std::vector<int>> displacements()
+{
+  std::vector<std::vector<int>> dxs;
+  for (int d = 0; d < 4; d++)
+    for (int hop = -3; hop <= 3; hop++) {
+      std::vector<int> dx(4, 0);
+      dx[d] = hop;
+      dxs.push_back(dx);
+    }
+  for (int mu = 0; mu < 4; mu++)
+    for (int nu = 0; nu < 4; nu++) {
+      if (mu == nu) continue;
+      std::vector<int> dx(4, 0);
+      dx[mu] = 1;
+      dx[nu] = -1;
+      dxs.push_back(dx);
+      dx[nu] = -2;
+      dxs.push_back(dx);
+    }
+  return dxs;
+}
+
+TEST(LatticeGeometryTest, periodic)
+{
+  const LatticeGeometry &geom = getLatticeGeometry(X);
+  const int R[4] = {0, 0, 0, 0};
+  for (auto &dx : displacements()) {
+    const int *nbr = geom.Neighbors(dx.data());
+    int errors = 0;
+    for (int i = 0; i < geom.Volume(); i++) errors += nbr[i] != directNeighbor(X, R, i, dx.data());
+    EXPECT_EQ(errors, 0) << "dx = " << dx[0] << " " << dx[1] << " " << dx[2] << " " << dx[3];
+  }
+
+  // the test_util wrappers must be unchanged by the tables
+  for (int i = 0; i < Vh; i++) {
+    for (int parity = 0; parity < 2; parity++) {
+      const int dx[4] = {0, 0, -1, 0};
+      const int expected = directNeighbor(X, R, i + parity * Vh, dx);
+      ASSERT_EQ(neighborIndex(i, parity, 0, -1, 0, 0), expected >= Vh ? expected - Vh : expected);
+      ASSERT_EQ(neighborIndexFullLattice(i + parity * Vh, 0, -1, 0, 0), expected);
+    }
+  }
+}
+
+TEST(LatticeGeometryTest, halo)
+{
+  const int R[4] = {2, 2, 2, 2};
+  const LatticeGeometry &geom = getLatticeGeometry(X, R);
+  for (auto &dx : displacements()) {
+    bool in_halo = true;
+    for (int d = 0; d < 4; d++) in_halo = in_halo && abs(dx[d]) <= R[d];
+    if (!in_halo) continue;
+
+    const int *nbr = geom.Neighbors(dx.data());
+    int errors = 0;
+    for (int i = 0; i < geom.Volume(); i++) errors += nbr[i] != directNeighbor(X, R, i, dx.data());
+    EXPECT_EQ(errors, 0) << "dx = " << dx[0] << " " << dx[1] << " " << dx[2] << " " << dx[3];
+  }
+}
+
+TEST(LatticeGeometryTest, benchmark)
+{
+  const LatticeGeometry &geom = getLatticeGeometry(X);
+  const int R[4] = {0, 0, 0, 0};
+  const int *nbr[8];
+  for (int dim = 0; dim < 4; dim++) {
+    nbr[2 * dim + 0] = geom.Neighbors(dim, +1);
+    nbr[2 * dim + 1] = geom.Neighbors(dim, -1);
+  }
+
+  // sweep the lattice visiting the eight nearest neighbours of every
+  // site, as a Wilson-like host stencil does, accumulating the
+  // indices so the work cannot be elided
+  auto sweep = [&](bool table) {
+    long sum = 0;
+    for (int iter = 0; iter < niter; iter++) {
+#pragma omp parallel for reduction(+ : sum)
+      for (int i = 0; i < geom.Volume(); i++) {
+        for (int dim = 0; dim < 4; dim++) {
+          for (int dir = 0; dir < 2; dir++) {
+            int dx[4] = {0, 0, 0, 0};
+            dx[dim] = dir ? -1 : 1;
+            sum += table ? nbr[2 * dim + dir][i] : directNeighbor(X, R, i, dx);
+          }
+        }
+      }
+    }
+    return sum;
+  };
+
+  quda::Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
+  const long direct_sum = sweep(false);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double direct_secs = timer.Last();
+
+  timer.Start(__func__, __FILE__, __LINE__);
+  const long table_sum = sweep(true);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double table_secs = timer.Last();
+
+  EXPECT_EQ(direct_sum, table_sum);
+
+  const double lookups = 8.0 * geom.Volume() * niter;
+  printfQuda("Neighbour index cost: direct %.3f ns, table %.3f ns per lookup (%.1fx)\n", 1e9 * direct_secs / lookups,
+             1e9 * table_secs / lookups, direct_secs / table_secs);
+  RecordProperty("DirectNsPerLookup", std::to_string(1e9 * direct_secs / lookups));
+  RecordProperty("TableNsPerLookup", std::to_string(1e9 * table_secs / lookups));
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  X[0] = xdim;
+  X[1] = ydim;
+  X[2] = zdim;
+  X[3] = tdim;
+  setDims(X);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  finalizeComms();
+  return test_rc;
+}
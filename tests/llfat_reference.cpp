@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include <llfat_reference.h>
+#include <lattice_geometry.h>
 
 #include <quda_internal.h>
 #include <complex>
@@ -139,7 +140,10 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
    * It also adds the computed staple to the fatlink[mu] with weight coef.
    */
 
-  int dx[4];
+  const quda::LatticeGeometry &geom = quda::getLatticeGeometry(Z);
+  const int *fwd_nu = geom.Neighbors(nu, +1);
+  const int *fwd_mu = geom.Neighbors(mu, +1);
+  const int *back_nu = geom.Neighbors(nu, -1);
 
   /* upper staple */
 
@@ -148,9 +152,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
     fat1 = ((su3_matrix*)fatlink[mu]) + i;
     su3_matrix* A = sitelink[nu] + i;
 
-    memset(dx, 0, sizeof(dx));
-    dx[nu] =1;
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    int nbr_idx = fwd_nu[i];
     su3_matrix* B;
     if (use_staple){
       B = mulink + nbr_idx;
@@ -158,9 +160,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
       B = mulink + nbr_idx;
     }
 
-    memset(dx, 0, sizeof(dx));
-    dx[mu] =1;
-    nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2],dx[1],dx[0]);
+    nbr_idx = fwd_mu[i];
     su3_matrix* C = sitelink[nu] + nbr_idx;
 
     llfat_mult_su3_nn( A, B,&tmat1);
@@ -185,9 +185,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
   for(i=0;i < V;i++){	    
 
     fat1 = ((su3_matrix*)fatlink[mu]) + i;
-    memset(dx, 0, sizeof(dx));
-    dx[nu] = -1;
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);	
+    int nbr_idx = back_nu[i];
     if (nbr_idx >= V || nbr_idx <0){
       fprintf(stderr, "ERROR: invliad nbr_idx(%d), line=%d\n", nbr_idx, __LINE__);
       exit(1);
@@ -201,9 +199,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
       B = mulink + nbr_idx;
     }
 
-    memset(dx, 0, sizeof(dx));
-    dx[mu] = 1;
-    nbr_idx = neighborIndexFullLattice(nbr_idx, dx[3], dx[2],dx[1],dx[0]);
+    nbr_idx = fwd_mu[nbr_idx];
     su3_matrix* C = sitelink[nu] + nbr_idx;
 
     llfat_mult_su3_an( A, B,&tmat1);	
@@ -305,19 +301,17 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelink,
     Float* act_path_coeff)
 {
 
+  const quda::LatticeGeometry &geom = quda::getLatticeGeometry(Z);
   su3_matrix temp;
   for(int dir=XUP; dir<=TUP; ++dir){
-    int dx[4] = {0,0,0,0}; 
+    const int *fwd1 = geom.Neighbors(dir, 1);
+    const int *fwd2 = geom.Neighbors(dir, 2);
     for(int i=0; i<V; ++i){
       // Initialize the longlinks
       su3_matrix* llink = ((su3_matrix*)longlink[dir]) + i;
       llfat_scalar_mult_su3_matrix(sitelink[dir]+i, act_path_coeff[1], llink);
-      dx[dir] = 1;
-      int nbr_idx = neighborIndexFullLattice(Z, i, dx);
-      llfat_mult_su3_nn(llink, sitelink[dir]+nbr_idx, &temp);
-      dx[dir] = 2;  
-      nbr_idx = neighborIndexFullLattice(Z, i, dx);
-      llfat_mult_su3_nn(&temp, sitelink[dir]+nbr_idx, llink);
+      llfat_mult_su3_nn(llink, sitelink[dir]+fwd1[i], &temp);
+      llfat_mult_su3_nn(&temp, sitelink[dir]+fwd2[i], llink);
     }
   }
   return;
@@ -332,6 +326,13 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelinkEx, Float* act_pat
 
  const int extended_volume = E[3]*E[2]*E[1]*E[0];
 
+  const quda::LatticeGeometry &geom = quda::getLatticeGeometry(E);
+  const int *fwd1[4], *fwd2[4];
+  for (int dir = 0; dir < 4; dir++) {
+    fwd1[dir] = geom.Neighbors(dir, 1);
+    fwd2[dir] = geom.Neighbors(dir, 2);
+  }
+
   su3_matrix temp;
   for(int t=0; t<Z[3]; ++t){
     for(int z=0; z<Z[2]; ++z){
@@ -343,15 +344,10 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelinkEx, Float* act_pat
         
       
           for(int dir=XUP; dir<=TUP; ++dir){
-            int dx[4] = {0,0,0,0};
             su3_matrix* llink = ((su3_matrix*)longlink[dir]) + little_index;
             llfat_scalar_mult_su3_matrix(sitelinkEx[dir]+large_index, act_path_coeff[1], llink);
-            dx[dir] = 1;
-            int nbr_index = neighborIndexFullLattice(E, large_index, dx);
-            llfat_mult_su3_nn(llink, sitelinkEx[dir]+nbr_index, &temp);
-            dx[dir] = 2;
-            nbr_index = neighborIndexFullLattice(E, large_index, dx);  
-            llfat_mult_su3_nn(&temp, sitelinkEx[dir]+nbr_index, llink);
+            llfat_mult_su3_nn(llink, sitelinkEx[dir]+fwd1[dir][large_index], &temp);
+            llfat_mult_su3_nn(&temp, sitelinkEx[dir]+fwd2[dir][large_index], llink);
           }
         } // x
       } // y
@@ -32,6 +32,7 @@ extern int niter;
 static QudaPrecision cpu_prec = QUDA_DOUBLE_PRECISION;
 //static QudaGaugeFieldOrder gauge_order = QUDA_QDP_GAUGE_ORDER;
 static QudaGaugeFieldOrder gauge_order = QUDA_MILC_GAUGE_ORDER;
+static QudaFieldLocation compute_location = QUDA_CUDA_FIELD_LOCATION;
 
 static size_t gSize;
 
@@ -69,6 +70,7 @@ static void llfat_test()
   qudaGaugeParam.staggered_phase_type = QUDA_STAGGERED_PHASE_MILC;
   qudaGaugeParam.gauge_fix = QUDA_GAUGE_FIXED_NO;
   qudaGaugeParam.ga_pad = 0;
+  qudaGaugeParam.compute_location = compute_location;
 
   void* fatlink = pinned_malloc(4*V*gaugeSiteSize*gSize);
   void* longlink = pinned_malloc(4*V*gaugeSiteSize*gSize);
@@ -191,6 +193,9 @@ static void llfat_test()
     for (int i=0; i < 6;i++) coeff_sp[i] = coeff_dp[i] = act_path_coeff[i];
     coeff = (prec == QUDA_DOUBLE_PRECISION) ? (void*)coeff_dp : (void*)coeff_sp;
 
+    struct timeval ref0, ref1;
+    gettimeofday(&ref0, NULL);
+
 #ifdef MULTI_GPU
     int optflag = 0;
     //we need x,y,z site links in the back and forward T slice
@@ -241,6 +246,11 @@ static void llfat_test()
     computeLongLinkCPU(long_reflink, sitelink, qudaGaugeParam.cpu_prec, coeff);
 #endif
 
+    gettimeofday(&ref1, NULL);
+    printfQuda("reference link computation time = %.2f ms, QUDA (%s) = %.2f ms, speedup %.1f\n",
+               TDIFF(ref0, ref1) * 1000, compute_location == QUDA_CPU_FIELD_LOCATION ? "host" : "device",
+               (secs * 1000) / niter, TDIFF(ref0, ref1) / (secs / niter));
+
   }//verify_results
 
   //format change for fatlink and longlink
@@ -272,7 +282,7 @@ static void llfat_test()
       res &= compare_floats(fat_reflink[dir], myfatlink[dir], V*gaugeSiteSize, 1e-3, qudaGaugeParam.cpu_prec);
     }
     
-    strong_check_link(myfatlink, "GPU results: ",
+    strong_check_link(myfatlink, "QUDA results: ",
 		      fat_reflink, "CPU reference results:",
 		      V, qudaGaugeParam.cpu_prec);
     
@@ -284,7 +294,7 @@ static void llfat_test()
       res &= compare_floats(long_reflink[dir], mylonglink[dir], V*gaugeSiteSize, 1e-3, qudaGaugeParam.cpu_prec);
     }
       
-    strong_check_link(mylonglink, "GPU results: ",
+    strong_check_link(mylonglink, "QUDA results: ",
 		      long_reflink, "CPU reference results:",
 		      V, qudaGaugeParam.cpu_prec);
       
@@ -335,12 +345,13 @@ static void display_test_info()
 {
   printfQuda("running the following test:\n");
 
-  printfQuda("link_precision           link_reconstruct           space_dimension        T_dimension       Ordering\n");
-  printfQuda("%s                       %s                         %d/%d/%d/                  %d             %s \n", 
+  printfQuda("link_precision           link_reconstruct           space_dimension        T_dimension       Ordering       Location\n");
+  printfQuda("%s                       %s                         %d/%d/%d/                  %d             %s           %s\n", 
       get_prec_str(prec),
       get_recon_str(link_recon), 
       xdim, ydim, zdim, tdim,
-      get_gauge_order_str(gauge_order));
+      get_gauge_order_str(gauge_order),
+      compute_location == QUDA_CPU_FIELD_LOCATION ? "cpu" : "cuda");
 
   printfQuda("Grid partition info:     X  Y  Z  T\n");
   printfQuda("                         %d  %d  %d  %d\n",
@@ -357,6 +368,7 @@ void usage_extra(char** argv )
 {
   printfQuda("Extra options:\n");
   printfQuda("    --gauge-order <qdp/milc>		   # ordering of the input gauge-field\n");
+  printfQuda("    --compute-location <cpu/cuda>	   # where the links are computed (default cuda)\n");
   return ;
 }
 
@@ -391,6 +403,15 @@ int main(int argc, char **argv)
       continue;
     }
 
+    if( strcmp(argv[i], "--compute-location") == 0){
+      if(i+1 >= argc){
+        usage(argv);
+      }
+      compute_location = get_location(argv[i+1]);
+      i++;
+      continue;
+    }
+
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -1040,6 +1040,8 @@ QudaEigType get_eig_type(char *s)
     ret = QUDA_EIG_IR_LANCZOS;
   } else if (strcmp(s, "iram") == 0) {
     ret = QUDA_EIG_IR_ARNOLDI;
+  } else if (strcmp(s, "blktrlm") == 0) {
+    ret = QUDA_EIG_BLK_TR_LANCZOS;
   } else {
     fprintf(stderr, "Error: invalid quda eigensolver type\n");
     exit(1);
@@ -1056,6 +1058,7 @@ const char *get_eig_type_str(QudaEigType type)
   case QUDA_EIG_TR_LANCZOS: ret = "trlm"; break;
   case QUDA_EIG_IR_LANCZOS: ret = "irlm"; break;
   case QUDA_EIG_IR_ARNOLDI: ret = "iram"; break;
+  case QUDA_EIG_BLK_TR_LANCZOS: ret = "blktrlm"; break;
   default: ret = "unknown eigensolver"; break;
   }
 
@@ -1326,6 +1329,10 @@ get_solver_type(char* s)
     ret = QUDA_GMRESDR_SH_INVERTER;
   } else if (strcmp(s, "fgmresdr") == 0){
     ret = QUDA_FGMRESDR_INVERTER;
+  } else if (strcmp(s, "gcrodr") == 0) {
+    ret = QUDA_GCRODR_INVERTER;
+  } else if (strcmp(s, "poly") == 0) {
+    ret = QUDA_POLYNOMIAL_INVERTER;
   } else if (strcmp(s, "mg") == 0){
     ret = QUDA_MG_INVERTER;
   } else if (strcmp(s, "bicgstab-l") == 0){
@@ -1404,6 +1411,12 @@ get_solver_str(QudaInverterType type)
   case QUDA_FGMRESDR_INVERTER:
     ret = "fgmresdr";
     break;
+  case QUDA_GCRODR_INVERTER:
+    ret = "gcrodr";
+    break;
+  case QUDA_POLYNOMIAL_INVERTER:
+    ret = "poly";
+    break;
   case QUDA_MG_INVERTER:
     ret= "mg";
     break;
@@ -118,6 +118,8 @@ extern QudaSolveType solve_type;
 
 extern char mg_vec_infile[QUDA_MAX_MG_LEVEL][256];
 extern char mg_vec_outfile[QUDA_MAX_MG_LEVEL][256];
+extern int mg_vec_compress_n_basis[QUDA_MAX_MG_LEVEL];
+extern double mg_vec_compress_tol[QUDA_MAX_MG_LEVEL];
 
 //Twisted mass flavor type
 extern QudaTwistFlavorType twist_flavor;
@@ -129,6 +131,9 @@ extern bool compute_clover;
 
 extern bool verify_results;
 
+extern int chrono_resident_dim;
+extern QudaPrecision prec_chrono_spill;
+
 namespace quda {
   extern void setTransferGPU(bool);
 }
@@ -427,6 +432,8 @@ void setMultigridParam(QudaMultigridParam &mg_param) {
   for (int i = 0; i < mg_param.n_level; i++) {
     strcpy(mg_param.vec_infile[i], mg_vec_infile[i]);
     strcpy(mg_param.vec_outfile[i], mg_vec_outfile[i]);
+    mg_param.vec_compress_n_basis[i] = mg_vec_compress_n_basis[i];
+    mg_param.vec_compress_tol[i] = mg_vec_compress_tol[i] ? mg_vec_compress_tol[i] : 1e-3;
     if (strcmp(mg_param.vec_infile[i], "") != 0) mg_param.vec_load[i] = QUDA_BOOLEAN_YES;
     if (strcmp(mg_param.vec_outfile[i], "") != 0) mg_param.vec_store[i] = QUDA_BOOLEAN_YES;
   }
@@ -787,6 +794,8 @@ int main(int argc, char **argv)
     inv_param2.chrono_index = 0 ;
     inv_param2.chrono_max_dim = 7;
     inv_param2.chrono_precision = inv_param2.cuda_prec_sloppy; // use sloppy precision for chrono basis
+    inv_param2.chrono_resident_dim = chrono_resident_dim;
+    inv_param2.chrono_spill_precision = prec_chrono_spill;
     inv_param2.use_init_guess = QUDA_USE_INIT_GUESS_YES;
 
     invertQuda(spinorOut, spinorIn, &inv_param2);
@@ -102,6 +102,8 @@ extern QudaSolveType solve_type;
 
 extern char mg_vec_infile[QUDA_MAX_MG_LEVEL][256];
 extern char mg_vec_outfile[QUDA_MAX_MG_LEVEL][256];
+extern int mg_vec_compress_n_basis[QUDA_MAX_MG_LEVEL];
+extern double mg_vec_compress_tol[QUDA_MAX_MG_LEVEL];
 
 //Twisted mass flavor type
 extern QudaTwistFlavorType twist_flavor;
@@ -238,7 +240,8 @@ void setEigParam(QudaEigParam &mg_eig_param, int level)
 {
   mg_eig_param.eig_type = mg_eig_type[level];
   mg_eig_param.spectrum = mg_eig_spectrum[level];
-  if ((mg_eig_type[level] == QUDA_EIG_TR_LANCZOS || mg_eig_type[level] == QUDA_EIG_IR_LANCZOS)
+  if ((mg_eig_type[level] == QUDA_EIG_TR_LANCZOS || mg_eig_type[level] == QUDA_EIG_BLK_TR_LANCZOS
+       || mg_eig_type[level] == QUDA_EIG_IR_LANCZOS)
       && !(mg_eig_spectrum[level] == QUDA_SPECTRUM_LR_EIG || mg_eig_spectrum[level] == QUDA_SPECTRUM_SR_EIG)) {
     errorQuda("Only real spectrum type (LR or SR) can be passed to the a Lanczos type solver");
   }
@@ -495,6 +498,8 @@ void setMultigridParam(QudaMultigridParam &mg_param)
   for (int i = 0; i < mg_param.n_level; i++) {
     strcpy(mg_param.vec_infile[i], mg_vec_infile[i]);
     strcpy(mg_param.vec_outfile[i], mg_vec_outfile[i]);
+    mg_param.vec_compress_n_basis[i] = mg_vec_compress_n_basis[i];
+    mg_param.vec_compress_tol[i] = mg_vec_compress_tol[i] ? mg_vec_compress_tol[i] : 1e-3;
     if (strcmp(mg_param.vec_infile[i], "") != 0) mg_param.vec_load[i] = QUDA_BOOLEAN_YES;
     if (strcmp(mg_param.vec_outfile[i], "") != 0) mg_param.vec_store[i] = QUDA_BOOLEAN_YES;
   }
@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <gauge_tools.h>
+#include <random_quda.h>
+#include <random_philox.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the counter-based Philox generator: the
+// Random123 known-answer vectors, the moments and histogram of its
+// uniform and Gaussian numbers, and that the seeded spinorNoise and
+// gaugeGauss give fields that are fixed by the seed alone -- the same
+// for any thread count, on the host and the device, and for a parity
+// field and the matching half of a full field.  The benchmarks time
+// --niter fills against the scalar stream and the CURAND states.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int niter;
+extern QudaVerbosity verbosity;
+extern int gridsize_from_cmdline[];
+extern void usage(char **argv);
+
+static const unsigned long long seed = 1234;
+
+static ColorSpinorParam spinorParam(QudaFieldLocation location, QudaPrecision precision,
+                                    QudaSiteSubset subset = QUDA_FULL_SITE_SUBSET)
+{
+  ColorSpinorParam param;
+  param.nColor = 3;
+  param.nSpin = 4;
+  param.nDim = 4;
+  param.x[0] = subset == QUDA_FULL_SITE_SUBSET ? xdim : xdim / 2;
+  param.x[1] = ydim;
+  param.x[2] = zdim;
+  param.x[3] = tdim;
+  param.siteSubset = subset;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.pad = 0;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  param.location = location;
+  if (location == QUDA_CPU_FIELD_LOCATION) {
+    param.setPrecision(precision);
+    param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  } else {
+    param.setPrecision(precision, precision, true);
+  }
+  return param;
+}
+
+static GaugeFieldParam gaugeParam(QudaFieldLocation location, QudaPrecision precision)
+{
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  GaugeFieldParam param(X, precision, QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY, QUDA_GHOST_EXCHANGE_NO);
+  param.link_type = QUDA_SU3_LINKS;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  param.location = location;
+  param.order = location == QUDA_CPU_FIELD_LOCATION ? QUDA_QDP_GAUGE_ORDER : QUDA_FLOAT2_GAUGE_ORDER;
+  return param;
+}
+
+// global lexicographic index of a checkerboarded site of the local lattice
+static unsigned long long globalIndex(int parity, int x_cb)
+{
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  int x[4];
+  int za = x_cb / (X[0] / 2);
+  int zb = za / X[1];
+  x[1] = za - zb * X[1];
+  x[3] = zb / X[2];
+  x[2] = zb - x[3] * X[2];
+  x[0] = 2 * x_cb + ((x[1] + x[2] + x[3] + parity) & 1) - za * X[0];
+  unsigned long long index = 0;
+  for (int d = 3; d >= 0; d--) index = index * comm_dim(d) * X[d] + comm_coord(d) * X[d] + x[d];
+  return index;
+}
+
+TEST(PhiloxTest, known_answer)
+{
+  // Random123 known-answer vectors for Philox-4x32-10
+  const unsigned int counter[3][4] = {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+                                      {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                                      {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+  const unsigned int key[3][2] = {{0x00000000, 0x00000000}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}};
+  const unsigned int answer[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+                                     {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+                                     {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+  for (int i = 0; i < 3; i++) {
+    unsigned int out[4];
+    philox4x32(out, counter[i], key[i]);
+    for (int j = 0; j < 4; j++) EXPECT_EQ(out[j], answer[i][j]) << "vector " << i << " word " << j;
+  }
+
+  // direct addressing agrees with the streams
+  PhiloxState state;
+  philoxInit(state, seed, 42, 3ull << 32);
+  for (int b = 0; b < 4; b++) {
+    unsigned int out[4];
+    philoxBlock(out, seed, 42, 3, b);
+    for (int j = 0; j < 4; j++) EXPECT_EQ(philoxNext(state), out[j]);
+  }
+}
+
+template <typename Float> static void uniformStatistics()
+{
+  const int n = 1 << 20;
+  const int bins = 100;
+  std::vector<int> histogram(bins, 0);
+  double sum = 0.0, sum2 = 0.0, lag = 0.0, last = 0.5;
+  PhiloxState state;
+  philoxInit(state, seed, 0, 0);
+  for (int i = 0; i < n; i++) {
+    double r = Random<Float>(state);
+    ASSERT_TRUE(r > 0.0 && r < 1.0);
+    sum += r;
+    sum2 += r * r;
+    lag += (r - 0.5) * (last - 0.5);
+    last = r;
+    histogram[std::min(bins - 1, static_cast<int>(r * bins))]++;
+  }
+
+  // moments to six standard deviations
+  EXPECT_NEAR(sum / n, 0.5, 6.0 * sqrt(1.0 / (12.0 * n)));
+  EXPECT_NEAR(sum2 / n - (sum / n) * (sum / n), 1.0 / 12.0, 6.0 * sqrt(1.0 / (180.0 * n)));
+  EXPECT_NEAR(lag / n, 0.0, 6.0 / (12.0 * sqrt(n)));
+
+  double chi2 = 0.0;
+  const double expected = static_cast<double>(n) / bins;
+  for (int b = 0; b < bins; b++) chi2 += (histogram[b] - expected) * (histogram[b] - expected) / expected;
+  EXPECT_LT(chi2, (bins - 1) + 6.0 * sqrt(2.0 * (bins - 1)));
+}
+
+TEST(PhiloxTest, uniform_double) { uniformStatistics<double>(); }
+
+TEST(PhiloxTest, uniform_float) { uniformStatistics<float>(); }
+
+TEST(PhiloxTest, spinor_noise)
+{
+  ColorSpinorParam param = spinorParam(QUDA_CPU_FIELD_LOCATION, QUDA_DOUBLE_PRECISION);
+  cpuColorSpinorField uniform(param), gauss(param);
+  spinorNoise(uniform, seed, QUDA_NOISE_UNIFORM);
+  spinorNoise(gauss, seed, QUDA_NOISE_GAUSS);
+
+  // each element is (the uniform numbers of) its block of the site's stream
+  const int n_elem = param.nSpin * param.nColor;
+  const double *u = static_cast<const double *>(uniform.V());
+  for (int parity = 0; parity < 2; parity++) {
+    for (int x_cb = 0; x_cb < uniform.VolumeCB(); x_cb += 97) {
+      for (int i = 0; i < n_elem; i++) {
+        unsigned int word[4];
+        philoxBlock(word, seed, globalIndex(parity, x_cb), 0, i);
+        const double *z = u + 2 * ((parity * uniform.VolumeCB() + x_cb) * n_elem + i);
+        EXPECT_EQ(z[0], philoxUniform<double>(word));
+        EXPECT_EQ(z[1], philoxUniform<double>(word + 2));
+      }
+    }
+  }
+
+  // Gaussian moments: each real component has mean 0 and variance 1/2
+  const double *g = static_cast<const double *>(gauss.V());
+  const size_t n = 2 * gauss.Volume() * n_elem;
+  double sum = 0.0, sum2 = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    sum += g[i];
+    sum2 += g[i] * g[i];
+  }
+  double moments[3] = {sum, sum2, static_cast<double>(n)};
+  comm_allreduce_array(moments, 3);
+  EXPECT_NEAR(moments[0] / moments[2], 0.0, 6.0 * sqrt(0.5 / moments[2]));
+  EXPECT_NEAR(moments[1] / moments[2], 0.5, 6.0 * sqrt(0.5 / moments[2]));
+}
+
+TEST(PhiloxTest, reproducible)
+{
+  ColorSpinorParam param = spinorParam(QUDA_CPU_FIELD_LOCATION, QUDA_DOUBLE_PRECISION);
+  cpuColorSpinorField a(param), b(param);
+  spinorNoise(a, seed, QUDA_NOISE_GAUSS);
+
+#ifdef _OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  spinorNoise(b, seed, QUDA_NOISE_GAUSS);
+  omp_set_num_threads(threads);
+#else
+  spinorNoise(b, seed, QUDA_NOISE_GAUSS);
+#endif
+  EXPECT_EQ(memcmp(a.V(), b.V(), a.Bytes()), 0) << "noise depends on the thread count";
+
+  // a parity field is the even half of the full field
+  ColorSpinorParam parityParam = spinorParam(QUDA_CPU_FIELD_LOCATION, QUDA_DOUBLE_PRECISION, QUDA_PARITY_SITE_SUBSET);
+  cpuColorSpinorField even(parityParam);
+  spinorNoise(even, seed, QUDA_NOISE_GAUSS);
+  EXPECT_EQ(memcmp(a.V(), even.V(), even.Bytes()), 0) << "parity noise differs from the full field";
+
+  // a different seed gives different noise
+  spinorNoise(b, seed + 1, QUDA_NOISE_GAUSS);
+  EXPECT_NE(memcmp(a.V(), b.V(), a.Bytes()), 0);
+}
+
+TEST(PhiloxTest, host_device)
+{
+  for (QudaPrecision precision : {QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION}) {
+    for (QudaNoiseType type : {QUDA_NOISE_UNIFORM, QUDA_NOISE_GAUSS}) {
+      ColorSpinorParam hostParam = spinorParam(QUDA_CPU_FIELD_LOCATION, precision);
+      cpuColorSpinorField host(hostParam), check(hostParam);
+      cudaColorSpinorField dev(spinorParam(QUDA_CUDA_FIELD_LOCATION, precision));
+      spinorNoise(host, seed, type);
+      spinorNoise(dev, seed, type);
+      check = dev;
+
+      // uniform noise is exact integer arithmetic, Gaussian noise goes through log and sincos
+      const double tol = type == QUDA_NOISE_UNIFORM ? 0.0 : (precision == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-4);
+      const size_t n = 2 * host.Volume() * hostParam.nSpin * hostParam.nColor;
+      double dev_max = 0.0;
+      for (size_t i = 0; i < n; i++) {
+        const double a = precision == QUDA_DOUBLE_PRECISION ? static_cast<const double *>(host.V())[i] :
+                                                              static_cast<const float *>(host.V())[i];
+        const double b = precision == QUDA_DOUBLE_PRECISION ? static_cast<const double *>(check.V())[i] :
+                                                              static_cast<const float *>(check.V())[i];
+        dev_max = std::max(dev_max, fabs(a - b));
+      }
+      EXPECT_LE(dev_max, tol) << "precision " << precision << " noise " << type;
+    }
+  }
+
+  // gauge fields, which exponentiate the Gaussian algebra element
+  cpuGaugeField host(gaugeParam(QUDA_CPU_FIELD_LOCATION, QUDA_DOUBLE_PRECISION));
+  cpuGaugeField check(gaugeParam(QUDA_CPU_FIELD_LOCATION, QUDA_DOUBLE_PRECISION));
+  cudaGaugeField dev(gaugeParam(QUDA_CUDA_FIELD_LOCATION, QUDA_DOUBLE_PRECISION));
+  gaugeGauss(host, seed, 0.5);
+  gaugeGauss(dev, seed, 0.5);
+  check.copy(dev);
+
+  double dev_max = 0.0, unitarity = 0.0;
+  for (int d = 0; d < 4; d++) {
+    const double *a = static_cast<const double *>(static_cast<void *const *>(host.Gauge_p())[d]);
+    const double *b = static_cast<const double *>(static_cast<void *const *>(check.Gauge_p())[d]);
+    for (size_t x = 0; x < (size_t)host.Volume(); x++) {
+      for (int i = 0; i < 18; i++) dev_max = std::max(dev_max, fabs(a[18 * x + i] - b[18 * x + i]));
+      // U U^dagger = 1, row-major complex 3x3
+      for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+          double re = 0.0, im = 0.0;
+          for (int k = 0; k < 3; k++) {
+            const double *p = a + 18 * x + 2 * (3 * r + k), *q = a + 18 * x + 2 * (3 * c + k);
+            re += p[0] * q[0] + p[1] * q[1];
+            im += p[1] * q[0] - p[0] * q[1];
+          }
+          unitarity = std::max(unitarity, fabs(re - (r == c ? 1.0 : 0.0)) + fabs(im));
+        }
+      }
+    }
+  }
+  EXPECT_LE(dev_max, 1e-12);
+  EXPECT_LE(unitarity, 1e-12);
+}
+
+TEST(PhiloxTest, benchmark)
+{
+  ColorSpinorParam hostParam = spinorParam(QUDA_CPU_FIELD_LOCATION, QUDA_DOUBLE_PRECISION);
+  cpuColorSpinorField host(hostParam);
+  const int n_elem = hostParam.nSpin * hostParam.nColor;
+  const long long n_blocks = static_cast<long long>(host.Volume()) * n_elem;
+
+  // one thread: direct SIMD block generation against the scalar stream
+  Timer simd, scalar;
+  std::vector<unsigned int> words(4 * n_elem);
+  unsigned int check = 0;
+  simd.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) {
+    for (int x = 0; x < host.Volume(); x++) {
+      unsigned int *w = words.data();
+#pragma omp simd
+      for (int i = 0; i < n_elem; i++) philoxBlock(w + 4 * i, seed, x, iter, i);
+      check ^= words[4 * x % words.size()];
+    }
+  }
+  simd.Stop(__func__, __FILE__, __LINE__);
+  scalar.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) {
+    for (int x = 0; x < host.Volume(); x++) {
+      PhiloxState state;
+      philoxInit(state, seed, x, static_cast<unsigned long long>(iter) << 32);
+      for (int i = 0; i < 4 * n_elem; i++) words[i] = philoxNext(state);
+      check ^= words[4 * x % words.size()];
+    }
+  }
+  scalar.Stop(__func__, __FILE__, __LINE__);
+
+  // threaded host fill
+  spinorNoise(host, seed, QUDA_NOISE_GAUSS); // tune
+  Timer host_fill;
+  host_fill.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) spinorNoise(host, seed + iter, QUDA_NOISE_GAUSS);
+  host_fill.Stop(__func__, __FILE__, __LINE__);
+
+  // device: counter-based against CURAND, including its state set up
+  cudaColorSpinorField dev(spinorParam(QUDA_CUDA_FIELD_LOCATION, QUDA_SINGLE_PRECISION));
+  spinorNoise(dev, seed, QUDA_NOISE_GAUSS);
+  qudaDeviceSynchronize();
+  Timer philox_dev, curand_dev;
+  philox_dev.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) spinorNoise(dev, seed + iter, QUDA_NOISE_GAUSS);
+  qudaDeviceSynchronize();
+  philox_dev.Stop(__func__, __FILE__, __LINE__);
+
+  curand_dev.Start(__func__, __FILE__, __LINE__);
+  RNG rng(dev, seed);
+  rng.Init();
+  for (int iter = 0; iter < niter; iter++) spinorNoise(dev, rng, QUDA_NOISE_GAUSS);
+  qudaDeviceSynchronize();
+  curand_dev.Stop(__func__, __FILE__, __LINE__);
+  rng.Release();
+
+  const double blocks = static_cast<double>(n_blocks) * niter;
+  printfQuda("Philox blocks (one thread): SIMD %.1f M/s, scalar stream %.1f M/s (%u)\n", 1e-6 * blocks / simd.time,
+             1e-6 * blocks / scalar.time, check & 1);
+  printfQuda("Host spinorNoise: %.3f ms per field\n", 1e3 * host_fill.time / niter);
+  printfQuda("Device spinorNoise: Philox %.3f ms per field, CURAND %.3f ms per field (with %lu bytes of state)\n",
+             1e3 * philox_dev.time / niter, 1e3 * curand_dev.time / niter, dev.Volume() * sizeof(cuRNGState));
+
+  RecordProperty("SIMDBlocksPerSec", std::to_string(blocks / simd.time));
+  RecordProperty("ScalarBlocksPerSec", std::to_string(blocks / scalar.time));
+  RecordProperty("HostFieldSecs", std::to_string(host_fill.time / niter));
+  RecordProperty("PhiloxFieldSecs", std::to_string(philox_dev.time / niter));
+  RecordProperty("CurandFieldSecs", std::to_string(curand_dev.time / niter));
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <host_dirac_matrix.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the GMRES polynomial preconditioner on the
+// even-odd preconditioned Wilson operator applied by the host
+// reference dslash.  The polynomial degree is a test parameter; the
+// precisions are taken from --prec and --prec-sloppy, the tolerance
+// from --tol and the Krylov space size from --ngcrkrylov.  The
+// benchmark compares GCR against polynomial-preconditioned GCR,
+// repeated --niter times.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern QudaPrecision prec_sloppy;
+extern QudaMatPCType matpc_type;
+extern QudaVerbosity verbosity;
+extern int niter;
+extern int gcrNkrylov;
+extern double kappa;
+extern double tol;
+extern void usage(char **argv);
+
+ColorSpinorParam csParam;
+QudaGaugeParam gauge_param;
+void *hostGauge[2][4]; // double and single precision copies
+
+class PolynomialPreconditionerTest : public ::testing::TestWithParam<int>
+{
+protected:
+  ColorSpinorField *b;
+  ColorSpinorField *x;
+  HostWilsonMatrix *mat;
+  QudaInvertParam inv_param;
+  TimeProfile profile;
+
+  PolynomialPreconditionerTest() : profile("PolynomialPreconditionerTest") {}
+
+  void SetUp()
+  {
+    b = ColorSpinorField::Create(csParam);
+    b->Source(QUDA_RANDOM_SOURCE);
+    x = ColorSpinorField::Create(csParam);
+    mat = new HostWilsonMatrix(hostGauge, gauge_param, kappa > 0.0 ? kappa : 0.12, matpc_type, false);
+
+    inv_param = newQudaInvertParam();
+    inv_param.inv_type = QUDA_GCR_INVERTER;
+    inv_param.inv_type_precondition = QUDA_POLYNOMIAL_INVERTER;
+    inv_param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+    inv_param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+    inv_param.preserve_source = QUDA_PRESERVE_SOURCE_YES;
+    inv_param.tol = tol;
+    inv_param.tol_hq = 0.0;
+    inv_param.heavy_quark_check = 0;
+    inv_param.maxiter = 10000;
+    inv_param.reliable_delta = 1e-1;
+    inv_param.max_res_increase = 1;
+    inv_param.max_res_increase_total = 10;
+    inv_param.compute_true_res = 1;
+    inv_param.pipeline = 0;
+    inv_param.gcrNkrylov = gcrNkrylov;
+    inv_param.schwarz_type = QUDA_INVALID_SCHWARZ;
+    inv_param.precondition_cycle = 1;
+    inv_param.tol_precondition = 1e-1;
+    inv_param.maxiter_precondition = GetParam();
+    inv_param.verbosity_precondition = QUDA_SILENT;
+    inv_param.omega = 1.0;
+    inv_param.cuda_prec = prec;
+    inv_param.cuda_prec_sloppy = prec_sloppy;
+    inv_param.cuda_prec_precondition = prec_sloppy;
+    inv_param.use_sloppy_partial_accumulator = 0;
+    inv_param.iter = 0;
+    inv_param.secs = 0;
+    inv_param.gflops = 0;
+  }
+
+  void TearDown()
+  {
+    delete b;
+    delete x;
+    delete mat;
+  }
+
+  // |b - A x| / |b| computed independently of the solver
+  double residual(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    ColorSpinorField *r = ColorSpinorField::Create(csParam);
+    (*mat)(*r, x);
+    double r2 = blas::xmyNorm(b, *r);
+    delete r;
+    return sqrt(r2 / blas::norm2(b));
+  }
+
+  // solve with GCR, returning the number of outer iterations
+  int solve(QudaInverterType precon)
+  {
+    blas::zero(*x);
+    inv_param.inv_type_precondition = precon;
+    SolverParam param(inv_param);
+    GCR gcr(*mat, *mat, *mat, param, profile);
+    gcr(*x, *b);
+    return param.iter;
+  }
+};
+
+TEST_P(PolynomialPreconditionerTest, approximateInverse)
+{
+  // p(A) on its own is an approximate inverse: the residual of x = p(A) b
+  // must be smaller than that of x = 0
+  SolverParam param(inv_param);
+  param.maxiter = GetParam();
+  param.is_preconditioner = true;
+  PolynomialPreconditioner poly(*mat, *mat, param, profile);
+  poly(*x, *b);
+  EXPECT_GT(poly.Degree(), 0);
+  EXPECT_LT(residual(*x, *b), 1.0);
+
+  // the polynomial is fixed once constructed, so it is linear in b
+  ColorSpinorField *y = ColorSpinorField::Create(csParam);
+  ColorSpinorField *b2 = ColorSpinorField::Create(csParam);
+  blas::copy(*b2, *b);
+  blas::ax(2.0, *b2);
+  poly(*y, *b2);
+  blas::axpy(-2.0, *x, *y);
+  EXPECT_LE(sqrt(blas::norm2(*y) / blas::norm2(*x)), prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5);
+  delete b2;
+  delete y;
+}
+
+TEST_P(PolynomialPreconditionerTest, verify)
+{
+  const int iter = solve(QUDA_POLYNOMIAL_INVERTER);
+  EXPECT_GT(iter, 0);
+  EXPECT_LE(residual(*x, *b), 2 * tol);
+}
+
+TEST_P(PolynomialPreconditionerTest, benchmark)
+{
+  quda::Timer timer;
+
+  int gcr_iter = 0;
+  mat->resetApplications();
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int k = 0; k < niter; k++) gcr_iter = solve(QUDA_INVALID_INVERTER);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double gcr_secs = timer.Last() / niter;
+  const long long gcr_matvecs = mat->Applications() / niter;
+
+  int poly_iter = 0;
+  mat->resetApplications();
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int k = 0; k < niter; k++) poly_iter = solve(QUDA_POLYNOMIAL_INVERTER);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double poly_secs = timer.Last() / niter;
+  const long long poly_matvecs = mat->Applications() / niter;
+
+  // each outer GCR iteration is one orthogonalization, i.e., one
+  // multi-reduction, while the polynomial itself has none
+  printfQuda("Degree %d: GCR %d iterations, %lld matvecs, %.3f s; polynomial GCR %d iterations, %lld matvecs, %.3f s\n",
+             GetParam(), gcr_iter, gcr_matvecs, gcr_secs, poly_iter, poly_matvecs, poly_secs);
+  RecordProperty("Degree", GetParam());
+  RecordProperty("GCRIterations", gcr_iter);
+  RecordProperty("PolynomialIterations", poly_iter);
+  RecordProperty("GCRMatVecs", std::to_string(gcr_matvecs));
+  RecordProperty("PolynomialMatVecs", std::to_string(poly_matvecs));
+  RecordProperty("GCRSecs", std::to_string(gcr_secs));
+  RecordProperty("PolynomialSecs", std::to_string(poly_secs));
+
+  EXPECT_LT(poly_iter, gcr_iter);
+}
+
+INSTANTIATE_TEST_SUITE_P(QUDA, PolynomialPreconditionerTest, ::testing::Values(4, 8, 16));
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+  setVerbosity(verbosity);
+
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  initHostWilson(hostGauge, gauge_param, csParam, X, prec, prec_sloppy);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  freeHostWilson(hostGauge);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
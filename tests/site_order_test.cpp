@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <site_order.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+#include <dslash_util.h>
+#include <covdev_reference.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// Compares the host hopping stencil (the sum of the covariant
+// derivative over all eight directions) in even-odd, blocked and
+// Morton site order.  The stencil is verified against the covariant
+// derivative reference and reports throughput and cache misses.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern bool verify_results;
+extern int niter;
+extern void usage(char **argv);
+
+QudaGaugeParam gauge_param;
+void *links[4];
+cpuGaugeField *gauge_eo = nullptr;
+cpuColorSpinorField *spinor_eo = nullptr;
+cpuColorSpinorField *spinor_ref = nullptr;
+
+const char *site_order_str(QudaSiteOrder order)
+{
+  switch (order) {
+  case QUDA_EVEN_ODD_SITE_ORDER: return "even_odd";
+  case QUDA_BLOCKED_SITE_ORDER: return "blocked";
+  case QUDA_MORTON_SITE_ORDER: return "morton";
+  default: return "invalid";
+  }
+}
+
+/**
+   Counts hardware cache misses of the calling threads using one
+   perf event per OpenMP thread.  If the counters are not available
+   (e.g., restricted by perf_event_paranoid) stop() returns -1.
+ */
+class CacheMissCounter
+{
+  std::vector<int> fd;
+
+public:
+  CacheMissCounter()
+  {
+#ifdef _OPENMP
+    fd.resize(omp_get_max_threads(), -1);
+#else
+    fd.resize(1, -1);
+#endif
+  }
+
+  void start()
+  {
+#ifdef __linux__
+#pragma omp parallel
+    {
+#ifdef _OPENMP
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+      if (fd[tid] < 0) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd[tid] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      }
+      if (fd[tid] >= 0) {
+        ioctl(fd[tid], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd[tid], PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  long long stop()
+  {
+    long long total = 0;
+    bool valid = true;
+#ifdef __linux__
+#pragma omp parallel reduction(+ : total) reduction(&& : valid)
+    {
+#ifdef _OPENMP
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+      long long count = 0;
+      if (fd[tid] >= 0) {
+        ioctl(fd[tid], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd[tid], &count, sizeof(count)) != sizeof(count)) valid = false;
+      } else {
+        valid = false;
+      }
+      total += count;
+    }
+#else
+    valid = false;
+#endif
+    return valid ? total : -1;
+  }
+
+  ~CacheMissCounter()
+  {
+#ifdef __linux__
+    for (auto f : fd)
+      if (f >= 0) close(f);
+#endif
+  }
+};
+
+/**
+   out(x) = \sum_mu U_mu(x) in(x+mu) + U_mu(x-mu)^\dagger in(x-mu) for
+   the sites of the given parity, with all indexing through the
+   neighbour table of the site ordering.
+ */
+template <typename Float>
+void hoppingStencil(Float *out, Float **gauge, const Float *in, const SiteOrdering &order, int parity)
+{
+  const int volumeCB = order.VolumeCB();
+  const int *nbr = order.Neighbors(parity);
+  Float *gauge_this[4], *gauge_other[4];
+  for (int d = 0; d < 4; d++) {
+    gauge_this[d] = gauge[d] + parity * volumeCB * gaugeSiteSize;
+    gauge_other[d] = gauge[d] + (1 - parity) * volumeCB * gaugeSiteSize;
+  }
+
+#pragma omp parallel for
+  for (int s = 0; s < volumeCB; s++) {
+    Float result[spinorSiteSize] = {};
+    Float hop[spinorSiteSize];
+
+    for (int d = 0; d < 4; d++) {
+      const int fwd = nbr[8 * s + 2 * d + 0];
+      const int bwd = nbr[8 * s + 2 * d + 1];
+
+      Float *U = gauge_this[d] + s * gaugeSiteSize;
+      Float *psi = const_cast<Float *>(in) + fwd * spinorSiteSize;
+      for (int spin = 0; spin < 4; spin++) su3Mul(&hop[spin * 6], U, &psi[spin * 6]);
+      sum(result, result, hop, spinorSiteSize);
+
+      U = gauge_other[d] + bwd * gaugeSiteSize;
+      psi = const_cast<Float *>(in) + bwd * spinorSiteSize;
+      for (int spin = 0; spin < 4; spin++) su3Tmul(&hop[spin * 6], U, &psi[spin * 6]);
+      sum(result, result, hop, spinorSiteSize);
+    }
+
+    for (int i = 0; i < spinorSiteSize; i++) out[s * spinorSiteSize + i] = result[i];
+  }
+}
+
+template <typename Float> void hopping(cpuColorSpinorField &out, cpuGaugeField &gauge, const cpuColorSpinorField &in)
+{
+  const SiteOrdering &order = getSiteOrdering(gauge.X(), in.SiteOrder());
+  Float **U = static_cast<Float **>(gauge.Gauge_p());
+  const size_t offset = order.VolumeCB() * spinorSiteSize;
+  Float *out_p = static_cast<Float *>(out.V());
+  const Float *in_p = static_cast<const Float *>(in.V());
+  for (int parity = 0; parity < 2; parity++)
+    hoppingStencil(out_p + parity * offset, U, in_p + (1 - parity) * offset, order, parity);
+}
+
+void hopping(cpuColorSpinorField &out, cpuGaugeField &gauge, const cpuColorSpinorField &in)
+{
+  if (in.Precision() == QUDA_DOUBLE_PRECISION) hopping<double>(out, gauge, in);
+  else hopping<float>(out, gauge, in);
+}
+
+// reference: sum the covariant derivative over the eight directions
+void hoppingReference(cpuColorSpinorField &out, const cpuColorSpinorField &in)
+{
+  const size_t parity_bytes = in.Bytes() / 2;
+  std::vector<char> tmp(parity_bytes);
+  memset(out.V(), 0, in.Bytes());
+
+  for (int parity = 0; parity < 2; parity++) {
+    char *out_p = static_cast<char *>(out.V()) + parity * parity_bytes;
+    char *in_p = static_cast<char *>(const_cast<void *>(in.V())) + (1 - parity) * parity_bytes;
+    for (int mu = 0; mu < 8; mu++) {
+      covdev_dslash(tmp.data(), links, in_p, parity, mu % 2, mu, in.Precision(), gauge_param.cpu_prec);
+      if (in.Precision() == QUDA_DOUBLE_PRECISION)
+        sum((double *)out_p, (double *)out_p, (double *)tmp.data(), Vh * spinorSiteSize);
+      else
+        sum((float *)out_p, (float *)out_p, (float *)tmp.data(), Vh * spinorSiteSize);
+    }
+  }
+}
+
+class SiteOrderTest : public ::testing::TestWithParam<QudaSiteOrder>
+{
+};
+
+TEST_P(SiteOrderTest, neighbors)
+{
+  const SiteOrdering &order = getSiteOrdering(gauge_param.X, GetParam());
+
+  for (int parity = 0; parity < 2; parity++) {
+    for (int s = 0; s < order.VolumeCB(); s++) {
+      const int x_cb = order.CbIndex(s);
+      ASSERT_EQ(order.Index(x_cb), s);
+      for (int dim = 0; dim < 4; dim++) {
+        for (int dir = 0; dir < 2; dir++) {
+          int dx[4] = {0, 0, 0, 0};
+          dx[dim] = dir ? -1 : 1;
+          const int expected = neighborIndex(x_cb, parity, dx[3], dx[2], dx[1], dx[0]);
+          ASSERT_EQ(order.CbIndex(order.Neighbor(parity, s, dim, dir)), expected)
+            << "parity=" << parity << " x_cb=" << x_cb << " dim=" << dim << " dir=" << dir;
+        }
+      }
+    }
+  }
+}
+
+TEST_P(SiteOrderTest, reorder)
+{
+  ColorSpinorParam param(*spinor_eo);
+  param.siteOrder = GetParam();
+  param.create = QUDA_NULL_FIELD_CREATE;
+  cpuColorSpinorField ordered(param);
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  cpuColorSpinorField round_trip(param);
+
+  ordered = *spinor_eo;
+  round_trip = ordered;
+  ASSERT_EQ(memcmp(round_trip.V(), spinor_eo->V(), spinor_eo->Bytes()), 0);
+
+  // parity subsets are reordered with the same permutation
+  ordered.Odd() = spinor_eo->Odd();
+  round_trip.Odd() = ordered.Odd();
+  ASSERT_EQ(memcmp(round_trip.Odd().V(), spinor_eo->Odd().V(), spinor_eo->Odd().Bytes()), 0);
+}
+
+TEST_P(SiteOrderTest, stencil)
+{
+  const QudaSiteOrder site_order = GetParam();
+
+  GaugeFieldParam gParam(*gauge_eo);
+  gParam.create = QUDA_NULL_FIELD_CREATE;
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  gParam.siteOrder = site_order;
+  cpuGaugeField gauge(gParam);
+  gauge.copy(*gauge_eo);
+
+  ColorSpinorParam param(*spinor_eo);
+  param.siteOrder = site_order;
+  param.create = QUDA_NULL_FIELD_CREATE;
+  cpuColorSpinorField in(param);
+  cpuColorSpinorField out(param);
+  in = *spinor_eo;
+
+  hopping(out, gauge, in); // warm up and build the neighbour table
+
+  CacheMissCounter counter;
+  counter.start();
+  quda::Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int i = 0; i < niter; i++) hopping(out, gauge, in);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const long long misses = counter.stop();
+
+  const double secs = timer.Last();
+  const double flops = niter * (8.0 * 4 * 66 + 7.0 * spinorSiteSize) * in.Volume();
+  const double gflops = 1e-9 * flops / secs;
+  RecordProperty("Gflops", std::to_string(gflops));
+  RecordProperty("CacheMisses", std::to_string(misses));
+  if (misses >= 0)
+    printfQuda("%-9s order: Gflop/s = %6.2f, cache misses per site = %6.2f\n", site_order_str(site_order), gflops,
+               static_cast<double>(misses) / (niter * in.Volume()));
+  else
+    printfQuda("%-9s order: Gflop/s = %6.2f, cache misses unavailable\n", site_order_str(site_order), gflops);
+
+  if (verify_results) {
+    param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    cpuColorSpinorField result(param);
+    result = out;
+    double deviation = pow(10, -(double)(cpuColorSpinorField::Compare(*spinor_ref, result)));
+    double tol = (prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5);
+    ASSERT_LE(deviation, tol) << "Reordered stencil does not agree with the reference";
+  }
+}
+
+std::string getsiteordername(testing::TestParamInfo<QudaSiteOrder> param) { return site_order_str(param.param); }
+
+INSTANTIATE_TEST_SUITE_P(QUDA, SiteOrderTest,
+                         ::testing::Values(QUDA_EVEN_ODD_SITE_ORDER, QUDA_BLOCKED_SITE_ORDER, QUDA_MORTON_SITE_ORDER),
+                         getsiteordername);
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%s   %d/%d/%d          %d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n", dimPartitioned(0), dimPartitioned(1), dimPartitioned(2),
+             dimPartitioned(3));
+}
+
+void usage_extra(char **argv) { return; }
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  for (int d = 0; d < 4; d++)
+    if (comm_dim_partitioned(d)) errorQuda("Host site reordering is a single-process layout");
+
+  display_test_info();
+  initQuda(device);
+
+  // host fields only
+  if (prec != QUDA_DOUBLE_PRECISION) prec = QUDA_SINGLE_PRECISION;
+
+  gauge_param = newQudaGaugeParam();
+  gauge_param.X[0] = xdim;
+  gauge_param.X[1] = ydim;
+  gauge_param.X[2] = zdim;
+  gauge_param.X[3] = tdim;
+  setDims(gauge_param.X);
+  setSpinorSiteSize(24);
+
+  gauge_param.cpu_prec = prec;
+  gauge_param.type = QUDA_SU3_LINKS;
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  gauge_param.anisotropy = 1.0;
+
+  for (int dir = 0; dir < 4; dir++) links[dir] = malloc(V * gaugeSiteSize * prec);
+  construct_gauge_field(links, 1, prec, &gauge_param);
+
+  GaugeFieldParam gParam(links, gauge_param);
+  gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  gauge_eo = new cpuGaugeField(gParam);
+
+  ColorSpinorParam csParam;
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = gauge_param.X[d];
+  csParam.setPrecision(prec);
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_UKQCD_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  csParam.location = QUDA_CPU_FIELD_LOCATION;
+
+  spinor_eo = new cpuColorSpinorField(csParam);
+  spinor_ref = new cpuColorSpinorField(csParam);
+  spinor_eo->Source(QUDA_RANDOM_SOURCE);
+  if (verify_results) hoppingReference(*spinor_ref, *spinor_eo);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  delete spinor_ref;
+  delete spinor_eo;
+  delete gauge_eo;
+  for (int dir = 0; dir < 4; dir++) free(links[dir]);
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
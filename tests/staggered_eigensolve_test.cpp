@@ -102,16 +102,22 @@ extern bool eig_use_poly_acc;
 extern int eig_poly_deg;
 extern double eig_amin;
 extern double eig_amax;
+extern bool eig_poly_acc_auto;
+extern double eig_poly_acc_rate;
 extern bool eig_use_normop;
 extern bool eig_use_dagger;
 extern bool eig_compute_svd;
 extern QudaEigSpectrumType eig_spectrum;
 extern QudaEigType eig_type;
+extern int eig_block_size;
 extern bool eig_arpack_check;
 extern char eig_arpack_logfile[];
 extern char eig_QUDA_logfile[];
 extern char eig_vec_infile[];
 extern char eig_vec_outfile[];
+extern int eig_vec_compress_n_basis;
+extern int eig_vec_compress_block[4];
+extern double eig_vec_compress_tol;
 
 extern bool verify_results;
 
@@ -279,7 +285,7 @@ void setEigParam(QudaEigParam &eig_param)
 {
   eig_param.eig_type = eig_type;
   eig_param.spectrum = eig_spectrum;
-  if ((eig_type == QUDA_EIG_TR_LANCZOS || eig_type == QUDA_EIG_IR_LANCZOS)
+  if ((eig_type == QUDA_EIG_TR_LANCZOS || eig_type == QUDA_EIG_BLK_TR_LANCZOS || eig_type == QUDA_EIG_IR_LANCZOS)
       && !(eig_spectrum == QUDA_SPECTRUM_LR_EIG || eig_spectrum == QUDA_SPECTRUM_SR_EIG)) {
     errorQuda("Only real spectrum type (LR or SR) can be passed to Lanczos type solver");
   }
@@ -298,6 +304,7 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.require_convergence = eig_require_convergence ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
   eig_param.check_interval = eig_check_interval;
   eig_param.max_restarts = eig_max_restarts;
+  eig_param.block_size = eig_block_size;
   eig_param.cuda_prec_ritz = prec;
 
   eig_param.use_norm_op = eig_use_normop ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
@@ -312,6 +319,8 @@ void setEigParam(QudaEigParam &eig_param)
   eig_param.poly_deg = eig_poly_deg;
   eig_param.a_min = eig_amin;
   eig_param.a_max = eig_amax;
+  eig_param.poly_acc_auto = eig_poly_acc_auto ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
+  eig_param.poly_acc_rate = eig_poly_acc_rate;
 
   eig_param.arpack_check = eig_arpack_check ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
   strcpy(eig_param.arpack_logfile, eig_arpack_logfile);
@@ -319,6 +328,9 @@ void setEigParam(QudaEigParam &eig_param)
 
   strcpy(eig_param.vec_infile, eig_vec_infile);
   strcpy(eig_param.vec_outfile, eig_vec_outfile);
+  eig_param.vec_compress_n_basis = eig_vec_compress_n_basis;
+  for (int d = 0; d < 4; d++) eig_param.vec_compress_block_size[d] = eig_vec_compress_block[d];
+  eig_param.vec_compress_tol = eig_vec_compress_tol;
 }
 
 void eigensolve_test()
@@ -85,6 +85,7 @@ extern bool compute_fatlong; // build the true fat/long links or use random numb
 extern double tadpole_factor;
 // relativistic correction for naik term
 extern double eps_naik;
+extern bool batched_refinement; // whether to refine the under-converged shifts together
 // Number of naiks. If eps_naik is 0.0, we only need
 // to construct one naik.
 static int n_naiks = 1;
@@ -497,6 +498,7 @@ int invert_test()
   {
         double masses[NUM_OFFSETS] ={0.06, 0.061, 0.064, 0.070, 0.077, 0.081, 0.1, 0.11, 0.12, 0.13, 0.14, 0.205};
         inv_param.num_offset = NUM_OFFSETS;
+        inv_param.batched_refinement = batched_refinement ? 1 : 0;
         // these can be set independently
         for (int i = 0; i < inv_param.num_offset; i++) {
           inv_param.tol_offset[i] = inv_param.tol;
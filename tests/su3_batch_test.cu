@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#include <quda_internal.h>
+#include <quda_matrix.h>
+#include <su3_project.cuh>
+#include <su3_batch.h>
+#include <comm_quda.h>
+#include <timer.h>
+
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks every operation of the batched host SU(3) library
+// against the scalar Matrix<complex<Float>,3> operations of
+// quda_matrix.h and su3_project.cuh, in both precisions, and
+// benchmarks the multiplication, exponentiation and projection of
+// batches against the scalar versions over --niter sweeps of a
+// lattice-sized set of matrices.
+
+extern int niter;
+extern int gridsize_from_cmdline[];
+extern void usage(char **argv);
+
+template <typename Float> using Link = Matrix<complex<Float>, 3>;
+
+// batches on the heap need their 64-byte alignment
+template <typename Float> SU3Batch<Float> *alignedBatches(int n)
+{
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, 64, n * sizeof(SU3Batch<Float>)) != 0) errorQuda("Failed to allocate %d batches", n);
+  return static_cast<SU3Batch<Float> *>(ptr);
+}
+
+template <typename Float> class SU3BatchTest : public ::testing::Test
+{
+protected:
+  static constexpr int W = su3BatchWidth<Float>();
+  std::mt19937 rng;
+
+  SU3BatchTest() : rng(1234) { }
+
+  Float tolerance() const { return sizeof(Float) == sizeof(double) ? 1e-12 : 2e-5; }
+
+  Float uniform() { return std::uniform_real_distribution<Float>(-1.0, 1.0)(rng); }
+
+  Link<Float> random()
+  {
+    Link<Float> m;
+    for (int k = 0; k < 9; k++) m.data[k] = complex<Float>(uniform(), uniform());
+    return m;
+  }
+
+  // a traceless Hermitian matrix
+  Link<Float> hermitian()
+  {
+    Link<Float> m = random();
+    m = static_cast<Float>(0.5) * (m + conj(m));
+    complex<Float> tr = getTrace(m) / static_cast<Float>(3.0);
+    for (int i = 0; i < 3; i++) m(i, i) -= tr;
+    return m;
+  }
+
+  Link<Float> su3()
+  {
+    Link<Float> u;
+    exponentiate_iQ(hermitian(), &u);
+    return u;
+  }
+
+  void expectNear(const Link<Float> &a, const Link<Float> &b, Float tol, int lane)
+  {
+    for (int k = 0; k < 9; k++) {
+      EXPECT_NEAR(a.data[k].real(), b.data[k].real(), tol) << "lane " << lane << " element " << k;
+      EXPECT_NEAR(a.data[k].imag(), b.data[k].imag(), tol) << "lane " << lane << " element " << k;
+    }
+  }
+};
+
+typedef ::testing::Types<double, float> Precisions;
+TYPED_TEST_CASE(SU3BatchTest, Precisions);
+
+TYPED_TEST(SU3BatchTest, multiply)
+{
+  typedef TypeParam Float;
+  constexpr int W = SU3BatchTest<Float>::W;
+  std::vector<Link<Float>> a(W), b(W), c(W);
+  SU3Batch<Float> A, B, C, D, E, F, G;
+  for (int l = 0; l < W; l++) {
+    a[l] = this->random();
+    b[l] = this->random();
+    c[l] = this->random();
+    A.set(l, a[l]);
+    B.set(l, b[l]);
+    G.set(l, c[l]);
+  }
+
+  mul<false, false>(C, A, B);
+  mul<false, true>(D, A, B);
+  mul<true, false>(E, A, B);
+  mul<true, true>(F, A, B);
+  mulAdd<false, true>(G, A, B, static_cast<Float>(0.5));
+  for (int l = 0; l < W; l++) {
+    this->expectNear(C.get(l), a[l] * b[l], this->tolerance(), l);
+    this->expectNear(D.get(l), a[l] * conj(b[l]), this->tolerance(), l);
+    this->expectNear(E.get(l), conj(a[l]) * b[l], this->tolerance(), l);
+    this->expectNear(F.get(l), conj(a[l]) * conj(b[l]), this->tolerance(), l);
+    this->expectNear(G.get(l), c[l] + static_cast<Float>(0.5) * (a[l] * conj(b[l])), this->tolerance(), l);
+  }
+
+  // in place
+  mul<false, false>(A, A, B);
+  for (int l = 0; l < W; l++) this->expectNear(A.get(l), a[l] * b[l], this->tolerance(), l);
+}
+
+TYPED_TEST(SU3BatchTest, adjoint_trace_inverse)
+{
+  typedef TypeParam Float;
+  constexpr int W = SU3BatchTest<Float>::W;
+  std::vector<Link<Float>> a(W), b(W);
+  SU3Batch<Float> A, B, C;
+  for (int l = 0; l < W; l++) {
+    a[l] = this->random();
+    b[l] = this->random();
+    A.set(l, a[l]);
+    B.set(l, b[l]);
+  }
+
+  adjoint(C, A);
+  for (int l = 0; l < W; l++) this->expectNear(C.get(l), conj(a[l]), this->tolerance(), l);
+
+  Float tr_re[W], tr_im[W], det_re[W], det_im[W], rtr[W];
+  trace(tr_re, tr_im, A);
+  determinant(det_re, det_im, A);
+  realTraceNA(rtr, A, B);
+  for (int l = 0; l < W; l++) {
+    complex<Float> tr = getTrace(a[l]);
+    complex<Float> det = getDeterminant(a[l]);
+    EXPECT_NEAR(tr_re[l], tr.real(), this->tolerance());
+    EXPECT_NEAR(tr_im[l], tr.imag(), this->tolerance());
+    EXPECT_NEAR(det_re[l], det.real(), this->tolerance());
+    EXPECT_NEAR(det_im[l], det.imag(), this->tolerance());
+    EXPECT_NEAR(rtr[l], getTrace(a[l] * conj(b[l])).real(), this->tolerance());
+  }
+
+  // the inverse is checked against the identity, as it may be ill
+  // conditioned for a random matrix
+  inverse(C, A);
+  mul<false, false>(C, C, A);
+  Link<Float> unit;
+  setIdentity(&unit);
+  for (int l = 0; l < W; l++) this->expectNear(C.get(l), unit, 100 * this->tolerance(), l);
+
+  inverse(C, A);
+  for (int l = 0; l < W; l++) {
+    if (norm(getDeterminant(a[l])) < 1e-2) continue;
+    this->expectNear(C.get(l), inverse(a[l]), 100 * this->tolerance(), l);
+  }
+}
+
+TYPED_TEST(SU3BatchTest, exponential)
+{
+  typedef TypeParam Float;
+  constexpr int W = SU3BatchTest<Float>::W;
+  std::vector<Link<Float>> q(W);
+  SU3Batch<Float> Q, E, P, F;
+  for (int l = 0; l < W; l++) {
+    // a range of scales, including zero and the series regime
+    q[l] = (l == 0 ? static_cast<Float>(0.0) : std::pow(static_cast<Float>(10.0), static_cast<Float>(-l % 5))) * this->hermitian();
+    Q.set(l, q[l]);
+    // the momentum of the gauge update is the anti-Hermitian iQ
+    P.set(l, complex<Float>(0.0, 1.0) * q[l]);
+  }
+
+  expiQ(E, Q);
+  expAntiHerm(F, P);
+  Link<Float> unit;
+  setIdentity(&unit);
+  for (int l = 0; l < W; l++) {
+    Link<Float> ref;
+    if (l == 0) {
+      ref = unit;
+    } else {
+      exponentiate_iQ(q[l], &ref);
+    }
+    this->expectNear(E.get(l), ref, 10 * this->tolerance(), l);
+    this->expectNear(F.get(l), ref, 10 * this->tolerance(), l);
+
+    // expsu3 needs a non-degenerate matrix, and is only instantiated
+    // in double precision
+    if (l > 0 && l % 5 < 2) {
+      Link<double> p;
+      for (int k = 0; k < 9; k++) p.data[k] = complex<double>(-q[l].data[k].imag(), q[l].data[k].real());
+      expsu3<double>(p);
+      Link<Float> p_;
+      for (int k = 0; k < 9; k++) p_.data[k] = complex<Float>(p.data[k].real(), p.data[k].imag());
+      this->expectNear(F.get(l), p_, 100 * this->tolerance(), l);
+    }
+  }
+}
+
+TYPED_TEST(SU3BatchTest, projection)
+{
+  typedef TypeParam Float;
+  constexpr int W = SU3BatchTest<Float>::W;
+  const Float tol = sizeof(Float) == sizeof(double) ? 1e-14 : 1e-6;
+  std::vector<Link<Float>> u(W), v(W);
+  SU3Batch<Float> U, V, G;
+  for (int l = 0; l < W; l++) {
+    u[l] = this->su3();
+    v[l] = u[l] + static_cast<Float>(0.1) * this->random();
+    U.set(l, u[l]);
+    V.set(l, v[l]);
+  }
+
+  // projection of an SU(3) matrix leaves it unchanged
+  G = U;
+  reunitarize(G);
+  for (int l = 0; l < W; l++) this->expectNear(G.get(l), u[l], 10 * this->tolerance(), l);
+  G = U;
+  polarProject(G, tol);
+  for (int l = 0; l < W; l++) this->expectNear(G.get(l), u[l], 10 * this->tolerance(), l);
+
+  // projection of a perturbed matrix agrees with polarSu3 and is in SU(3)
+  G = V;
+  int iter = polarProject(G, tol);
+  EXPECT_LT(iter, 100);
+  reunitarize(V);
+  for (int l = 0; l < W; l++) {
+    Link<Float> ref = v[l];
+    polarSu3(ref, tol);
+    this->expectNear(G.get(l), ref, 100 * this->tolerance(), l);
+
+    for (auto w : {G.get(l), V.get(l)}) {
+      EXPECT_LT(ErrorSU3(w), 100 * this->tolerance());
+      complex<Float> det = getDeterminant(w);
+      EXPECT_NEAR(det.real(), 1.0, 100 * this->tolerance());
+      EXPECT_NEAR(det.imag(), 0.0, 100 * this->tolerance());
+    }
+  }
+}
+
+TYPED_TEST(SU3BatchTest, benchmark)
+{
+  typedef TypeParam Float;
+  constexpr int W = SU3BatchTest<Float>::W;
+  const int n_batch = 8192 / W; // a few MB of matrices, as for a small local volume
+  const Float tol = sizeof(Float) == sizeof(double) ? 1e-14 : 1e-6;
+
+  std::vector<Link<Float>> a(n_batch * W), b(n_batch * W), c(n_batch * W);
+  SU3Batch<Float> *A = alignedBatches<Float>(n_batch);
+  SU3Batch<Float> *B = alignedBatches<Float>(n_batch);
+  SU3Batch<Float> *C = alignedBatches<Float>(n_batch);
+  for (int i = 0; i < n_batch * W; i++) {
+    a[i] = this->su3();
+    b[i] = static_cast<Float>(0.1) * this->hermitian();
+    A[i / W].set(i % W, a[i]);
+    B[i / W].set(i % W, b[i]);
+  }
+
+  quda::Timer timer;
+  auto time = [&](auto &&f) {
+    f();
+    timer.Start(__func__, __FILE__, __LINE__);
+    for (int n = 0; n < niter; n++) f();
+    timer.Stop(__func__, __FILE__, __LINE__);
+    return 1e9 * timer.Last() / ((double)niter * n_batch * W);
+  };
+
+  struct Kernel {
+    const char *name;
+    double scalar_ns;
+    double batch_ns;
+  };
+  std::vector<Kernel> kernels;
+
+  kernels.push_back({"multiply", time([&]() {
+                       for (size_t i = 0; i < a.size(); i++) c[i] = a[i] * conj(b[i]);
+                     }),
+                     time([&]() {
+                       for (int i = 0; i < n_batch; i++) mul<false, true>(C[i], A[i], B[i]);
+                     })});
+  kernels.push_back({"expiQ", time([&]() {
+                       for (size_t i = 0; i < b.size(); i++) exponentiate_iQ(b[i], &c[i]);
+                     }),
+                     time([&]() {
+                       for (int i = 0; i < n_batch; i++) expiQ(C[i], B[i]);
+                     })});
+  kernels.push_back({"polar projection", time([&]() {
+                       for (size_t i = 0; i < a.size(); i++) {
+                         c[i] = a[i] + b[i];
+                         polarSu3(c[i], tol);
+                       }
+                     }),
+                     time([&]() {
+                       for (int i = 0; i < n_batch; i++) {
+                         axpy(C[i], A[i], static_cast<Float>(1.0), B[i]);
+                         polarProject(C[i], tol);
+                       }
+                     })});
+
+  for (auto &k : kernels) {
+    printfQuda("%-16s %s: scalar %7.2f ns, batch of %2d %7.2f ns per matrix (%.1fx)\n", k.name,
+               sizeof(Float) == sizeof(double) ? "double" : "single", k.scalar_ns, W, k.batch_ns,
+               k.scalar_ns / k.batch_ns);
+    std::string key(k.name);
+    for (auto &ch : key)
+      if (ch == ' ') ch = '_';
+    this->RecordProperty(key + "_ScalarNs", std::to_string(k.scalar_ns));
+    this->RecordProperty(key + "_BatchNs", std::to_string(k.batch_ns));
+  }
+
+  free(C);
+  free(B);
+  free(A);
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  finalizeComms();
+  return test_rc;
+}
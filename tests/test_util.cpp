@@ -13,6 +13,7 @@
 #include <test_util.h>
 
 #include <dslash_quda.h>
+#include <lattice_geometry.h>
 #include "misc.h"
 
 using namespace std;
@@ -102,7 +103,9 @@ void initComms(int argc, char **argv, int *const commDims)
     QMP_declare_logical_topology_map(commDims, 4, map, 4);
   }
 #elif defined(MPI_COMMS)
-  MPI_Init(&argc, &argv);
+  // funneled lets the host heatbath overlap its halo exchange with the bulk
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
 #endif
 
   QudaCommsMap func = rank_order == 0 ? lex_rank_from_coords_t : lex_rank_from_coords_x;
@@ -427,43 +430,21 @@ int compare_floats(void *a, void *b, int len, double epsilon, QudaPrecision prec
   else return compareFloats((float*)a, (float*)b, len, epsilon);
 }
 
-int fullLatticeIndex(int dim[4], int index, int oddBit){
-
-  int za = index/(dim[0]>>1);
-  int zb = za/dim[1];
-  int x2 = za - zb*dim[1];
-  int x4 = zb/dim[2];
-  int x3 = zb - x4*dim[2];
+// The index helpers below are thin wrappers around the cached
+// LatticeGeometry of the lattice in question: coordinates are decoded
+// once per lattice and neighbours are read from per-displacement
+// tables, rather than recomputed with a chain of divisions per call.
+// Loops over the lattice should hoist LatticeGeometry::Neighbors().
 
-  return  2*index + ((x2 + x3 + x4 + oddBit) & 1);
+int fullLatticeIndex(int dim[4], int index, int oddBit){
+  const quda::LatticeGeometry &geom = quda::getLatticeGeometry(dim);
+  return geom.LexIndex(index + oddBit * geom.VolumeCB());
 }
 
 // given a "half index" i into either an even or odd half lattice (corresponding
 // to oddBit = {0, 1}), returns the corresponding full lattice index.
 int fullLatticeIndex(int i, int oddBit) {
-  /*
-    int boundaryCrossings = i/(Z[0]/2) + i/(Z[1]*Z[0]/2) + i/(Z[2]*Z[1]*Z[0]/2);
-    return 2*i + (boundaryCrossings + oddBit) % 2;
-  */
-
-  int X1 = Z[0];
-  int X2 = Z[1];
-  int X3 = Z[2];
-  //int X4 = Z[3];
-  int X1h =X1/2;
-
-  int sid =i;
-  int za = sid/X1h;
-  //int x1h = sid - za*X1h;
-  int zb = za/X2;
-  int x2 = za - zb*X2;
-  int x4 = zb/X3;
-  int x3 = zb - x4*X3;
-  int x1odd = (x2 + x3 + x4 + oddBit) & 1;
-  //int x1 = 2*x1h + x1odd;
-  int X = 2 * sid + x1odd;
-
-  return X;
+  return quda::getLatticeGeometry(Z).LexIndex(i + oddBit * Vh);
 }
 
 // i represents a "half index" into an even or odd "half lattice".
@@ -477,37 +458,16 @@ int fullLatticeIndex(int i, int oddBit) {
 //
 
 int neighborIndex(int i, int oddBit, int dx4, int dx3, int dx2, int dx1) {
-  int Y = fullLatticeIndex(i, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-
-  // assert (oddBit == (x+y+z+t)%2);
-
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-
-  return (x4*(Z[2]*Z[1]*Z[0]) + x3*(Z[1]*Z[0]) + x2*(Z[0]) + x1) / 2;
+  const int dx[4] = {dx1, dx2, dx3, dx4};
+  const int nbr = quda::getLatticeGeometry(Z).Neighbor(i + oddBit * Vh, dx);
+  return nbr >= Vh ? nbr - Vh : nbr;
 }
 
 
 int neighborIndex(int dim[4], int index, int oddBit, int dx[4]){
-
-  const int fullIndex = fullLatticeIndex(dim, index, oddBit);
-
-  int x[4];
-  x[3] = fullIndex/(dim[2]*dim[1]*dim[0]);
-  x[2] = (fullIndex/(dim[1]*dim[0])) % dim[2];
-  x[1] = (fullIndex/dim[0]) % dim[1];
-  x[0] = fullIndex % dim[0];
-
-  for(int dir=0; dir<4; ++dir)
-    x[dir] = (x[dir]+dx[dir]+dim[dir]) % dim[dir];
-
-  return (((x[3]*dim[2] + x[2])*dim[1] + x[1])*dim[0] + x[0])/2;
+  const quda::LatticeGeometry &geom = quda::getLatticeGeometry(dim);
+  const int nbr = geom.Neighbor(index + oddBit * geom.VolumeCB(), dx);
+  return nbr >= geom.VolumeCB() ? nbr - geom.VolumeCB() : nbr;
 }
 
 int
@@ -515,11 +475,12 @@ neighborIndex_mg(int i, int oddBit, int dx4, int dx3, int dx2, int dx1)
 {
   int ret;
 
-  int Y = fullLatticeIndex(i, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
+  int x[4];
+  quda::getLatticeGeometry(Z).Coords(x, i + oddBit * Vh);
+  int x4 = x[3];
+  int x3 = x[2];
+  int x2 = x[1];
+  int x1 = x[0];
 
   int ghost_x4 = x4+ dx4;
 
@@ -546,64 +507,30 @@ neighborIndex_mg(int i, int oddBit, int dx4, int dx3, int dx2, int dx1)
 
 int neighborIndexFullLattice(int i, int dx4, int dx3, int dx2, int dx1)
 {
-  int oddBit = 0;
-  int half_idx = i;
-  if (i >= Vh){
-    oddBit =1;
-    half_idx = i - Vh;
-  }
-
-  int nbr_half_idx = neighborIndex(half_idx, oddBit, dx4,dx3,dx2,dx1);
-  int oddBitChanged = (dx4+dx3+dx2+dx1)%2;
-  if (oddBitChanged){
-    oddBit = 1 - oddBit;
-  }
-  int ret = nbr_half_idx;
-  if (oddBit){
-    ret = Vh + nbr_half_idx;
-  }
-
-  return ret;
+  const int dx[4] = {dx1, dx2, dx3, dx4};
+  return quda::getLatticeGeometry(Z).Neighbor(i, dx);
 }
 
 int
 neighborIndexFullLattice(int dim[4], int index, int dx[4])
 {
-  const int volume = dim[0]*dim[1]*dim[2]*dim[3];
-  const int halfVolume = volume/2;
-  int oddBit = 0;
-  int halfIndex = index;
-
-  if(index >= halfVolume){
-    oddBit = 1;
-    halfIndex = index - halfVolume;
-  }
-
-  int neighborHalfIndex = neighborIndex(dim, halfIndex, oddBit, dx);
-
-  int oddBitChanged = (dx[0]+dx[1]+dx[2]+dx[3])%2;
-  if(oddBitChanged){
-    oddBit = 1 - oddBit;
-  }
-
-  return neighborHalfIndex + oddBit*halfVolume;
+  return quda::getLatticeGeometry(dim).Neighbor(index, dx);
 }
 
 int neighborIndexFullLattice_mg(int i, int dx4, int dx3, int dx2, int dx1)
 {
   int ret;
   int oddBit = 0;
-  int half_idx = i;
   if (i >= Vh){
     oddBit =1;
-    half_idx = i - Vh;
   }
 
-  int Y = fullLatticeIndex(half_idx, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
+  int x[4];
+  quda::getLatticeGeometry(Z).Coords(x, i);
+  int x4 = x[3];
+  int x3 = x[2];
+  int x2 = x[1];
+  int x1 = x[0];
   int ghost_x4 = x4+ dx4;
 
   x4 = (x4+dx4+Z[3]) % Z[3];
@@ -1650,9 +1577,14 @@ int test_type = 0;
 int nvec[QUDA_MAX_MG_LEVEL] = { };
 char mg_vec_infile[QUDA_MAX_MG_LEVEL][256];
 char mg_vec_outfile[QUDA_MAX_MG_LEVEL][256];
+int mg_vec_compress_n_basis[QUDA_MAX_MG_LEVEL] = {};
+double mg_vec_compress_tol[QUDA_MAX_MG_LEVEL] = {};
 QudaInverterType inv_type;
 QudaInverterType precon_type = QUDA_INVALID_INVERTER;
 int multishift = 0;
+int multishift_num_offset = 12;
+bool batched_refinement = true;
+bool compare_refinement = false;
 bool verify_results = true;
 bool low_mode_check = false;
 bool oblique_proj_check = false;
@@ -1731,6 +1663,12 @@ QudaExtLibType solver_ext_lib     = QUDA_EIGEN_EXTLIB;
 QudaExtLibType deflation_ext_lib  = QUDA_EIGEN_EXTLIB;
 QudaFieldLocation location_ritz   = QUDA_CUDA_FIELD_LOCATION;
 QudaMemoryType    mem_type_ritz   = QUDA_MEMORY_DEVICE;
+int ritz_resident_dim = 0;
+QudaPrecision prec_ritz_spill = QUDA_INVALID_PRECISION;
+int chrono_resident_dim = 0;
+QudaPrecision prec_chrono_spill = QUDA_INVALID_PRECISION;
+QudaPrecision prec_recycle = QUDA_INVALID_PRECISION;
+bool recycle_keep_on_update = true;
 
 // Parameters for the stand alone eigensolver
 int eig_nEv = 16;
@@ -1744,16 +1682,23 @@ bool eig_use_poly_acc = true;
 int eig_poly_deg = 100;
 double eig_amin = 0.1;
 double eig_amax = 4.0;
+bool eig_poly_acc_auto = false;
+double eig_poly_acc_rate = 1e-2;
 bool eig_use_normop = true;
 bool eig_use_dagger = false;
 bool eig_compute_svd = false;
 QudaEigSpectrumType eig_spectrum = QUDA_SPECTRUM_LR_EIG;
 QudaEigType eig_type = QUDA_EIG_TR_LANCZOS;
+int eig_block_size = 1;
+bool eig_benchmark = false;
 bool eig_arpack_check = false;
 char eig_arpack_logfile[256] = "arpack_logfile.log";
 char eig_QUDA_logfile[256] = "QUDA_logfile.log";
 char eig_vec_infile[256] = "";
 char eig_vec_outfile[256] = "";
+int eig_vec_compress_n_basis = 0;
+int eig_vec_compress_block[4] = {4, 4, 4, 4};
+double eig_vec_compress_tol = 1e-3;
 
 // Parameters for the MG eigensolver.
 // The coarsest grid params are for deflation,
@@ -1846,8 +1791,10 @@ void usage(char** argv )
   printf("    --pipeline <n>                            # The pipeline length for fused operations in GCR, BiCGstab-l (default 0, no pipelining)\n");
   printf("    --solution-pipeline <n>                   # The pipeline length for fused solution accumulation (default 0, no pipelining)\n");
   printf("    --inv-type <cg/bicgstab/gcr>              # The type of solver to use (default cg)\n");
-  printf("    --precon-type <mr/ (unspecified)>         # The type of solver to use (default none (=unspecified)).\n");
+  printf("    --precon-type <mr/poly/ (unspecified)>    # The type of solver to use (default none (=unspecified)).\n");
   printf("    --multishift <true/false>                 # Whether to do a multi-shift solver test or not (default false)\n");
+  printf("    --multishift-num-offset <n>               # The number of shifts in the multi-shift solver test (default 12)\n");
+  printf("    --multishift-refine <batched/sequential/compare> # Refinement of the under-converged shifts, compare times both (default batched)\n");
   printf("    --mass                                    # Mass of Dirac operator (default 0.1)\n");
   printf("    --kappa                                   # Kappa of Dirac operator (default 0.12195122... [equiv to mass])\n");
   printf("    --mu                                      # Twisted-Mass chiral twist of Dirac operator (default 0.1)\n");
@@ -1923,6 +1870,10 @@ void usage(char** argv )
          "QIO)\n");
   printf("    --mg-save-vec <level file>                # Save the generated null-space vectors \"file\" from the "
          "multigrid_test (requires QIO)\n");
+  printf("    --mg-compress-vec <level n>               # Save the null-space vectors compressed with n block-local "
+         "basis vectors per aggregate (default 0, uncompressed)\n");
+  printf("    --mg-compress-tol <level tol>             # Target relative quantization error of the compressed "
+         "null-space vectors (default 1e-3)\n");
   printf("    --mg-verbosity <level verb>               # The verbosity to use on each level of the multigrid (default "
          "summarize)\n");
 
@@ -1940,6 +1891,12 @@ void usage(char** argv )
   printf("    --df-ext-lib-type <eigen/magma>           # Set external library for the deflation methods  (default Eigen library)\n");
   printf("    --df-location-ritz <host/cuda>            # Set memory location for the ritz vectors  (default cuda memory location)\n");
   printf("    --df-mem-type-ritz <device/pinned/mapped> # Set memory type for the ritz vectors  (default device memory type)\n");
+  printf("    --df-resident-ritz <n>                    # Number of ritz vectors kept resident, the rest spill to host memory (default 0 = all)\n");
+  printf("    --df-spill-prec-ritz <double/single/half> # Precision of the ritz vectors spilled to host memory (default ritz precision)\n");
+  printf("    --chrono-resident-dim <n>                 # Number of chronological vectors kept on the device, the rest spill to host memory (default 0 = all)\n");
+  printf("    --chrono-spill-prec <double/single/half>  # Precision of the chronological vectors spilled to host memory (default chrono precision)\n");
+  printf("    --recycle-prec <double/single/half>       # Precision to store the GCRO-DR recycled subspace in between solves (default prec_sloppy)\n");
+  printf("    --recycle-keep <true/false>               # Whether GCRO-DR keeps the recycled subspace when the operator changes (default true)\n");
 
   // Eigensolver
   printf("    --eig-nEv <n>                             # The size of eigenvector search space in the eigensolver\n");
@@ -1956,6 +1913,10 @@ void usage(char** argv )
          "the eigensolver\n");
   printf("    --eig-amin <Float>                        # The minimum in the polynomial acceleration\n");
   printf("    --eig-amax <Float>                        # The maximum in the polynomial acceleration\n");
+  printf("    --eig-poly-acc-auto <true/false>          # Estimate the polynomial acceleration parameters, with "
+         "--eig-poly-deg the maximum degree (default false)\n");
+  printf("    --eig-poly-acc-rate <Float>               # The target damping per polynomial application when estimating "
+         "the parameters (default 1e-2)\n");
   printf("    --eig-use-normop <true/false>             # Solve the MdagM problem instead of M (MMdag if "
          "eig-use-dagger == true) (default false)\n");
   printf("    --eig-use-dagger <true/false>             # Solve the Mdag  problem instead of M (MMdag if "
@@ -1965,11 +1926,20 @@ void usage(char** argv )
   printf("    --eig-spectrum <SR/LR/SM/LM/SI/LI>        # The spectrum part to be calulated. S=smallest L=largest "
          "R=real M=modulus I=imaginary\n");
   printf("    --eig-type <eigensolver>                  # The type of eigensolver to use (default trlm)\n");
+  printf("    --eig-block-size <n>                      # The block size of the block eigensolver (default 1)\n");
+  printf("    --eig-benchmark <true/false>              # Also run the TRLM eigensolver and compare the operator "
+         "applications and time to convergence (default false)\n");
   printf("    --eig-QUDA-logfile <file_name>            # The filename storing the stdout from the QUDA eigensolver\n");
   printf("    --eig-arpack-check <true/false>           # Cross check the device data against ARPACK (requires ARPACK, "
          "default false)\n");
   printf("    --eig-load-vec <file>                     # Load eigenvectors to <file> (requires QIO)\n");
   printf("    --eig-save-vec <file>                     # Save eigenvectors to <file> (requires QIO)\n");
+  printf("    --eig-compress-vec <n>                    # Save eigenvectors compressed with n block-local basis vectors "
+         "per aggregate (default 0, uncompressed)\n");
+  printf("    --eig-compress-block <x y z t>            # Block dimensions of the compressed eigenvectors (default 4 4 4 "
+         "4)\n");
+  printf("    --eig-compress-tol <tol>                  # Target relative quantization error of the compressed "
+         "eigenvectors (default 1e-3)\n");
 
   // Multigrid Eigensolver
   printf("    --mg-eig <level> <true/false>                     # Use the eigensolver on this level (default false)\n");
@@ -2373,6 +2343,39 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if (strcmp(argv[i], "--multishift-num-offset") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    multishift_num_offset = atoi(argv[i + 1]);
+    if (multishift_num_offset < 1 || multishift_num_offset > QUDA_MAX_MULTI_SHIFT) {
+      printf("ERROR: invalid number of shifts %d\n", multishift_num_offset);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--multishift-refine") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+
+    if (strcmp(argv[i + 1], "batched") == 0) {
+      batched_refinement = true;
+      compare_refinement = false;
+    } else if (strcmp(argv[i + 1], "sequential") == 0) {
+      batched_refinement = false;
+      compare_refinement = false;
+    } else if (strcmp(argv[i + 1], "compare") == 0) {
+      compare_refinement = true;
+    } else {
+      fprintf(stderr, "ERROR: invalid multishift refinement %s\n", argv[i + 1]);
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--gridsize") == 0){
     if (i + 4 >= argc) { usage(argv); }
     int xsize =  atoi(argv[i+1]);
@@ -3562,6 +3565,42 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if (strcmp(argv[i], "--mg-compress-vec") == 0) {
+    if (i + 2 >= argc) { usage(argv); }
+    int level = atoi(argv[i + 1]);
+    if (level < 0 || level >= QUDA_MAX_MG_LEVEL) {
+      printf("ERROR: invalid multigrid level %d", level);
+      usage(argv);
+    }
+    i++;
+    mg_vec_compress_n_basis[level] = atoi(argv[i + 1]);
+    if (mg_vec_compress_n_basis[level] < 0) {
+      printf("ERROR: invalid number of compression basis vectors %d\n", mg_vec_compress_n_basis[level]);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--mg-compress-tol") == 0) {
+    if (i + 2 >= argc) { usage(argv); }
+    int level = atoi(argv[i + 1]);
+    if (level < 0 || level >= QUDA_MAX_MG_LEVEL) {
+      printf("ERROR: invalid multigrid level %d", level);
+      usage(argv);
+    }
+    i++;
+    mg_vec_compress_tol[level] = atof(argv[i + 1]);
+    if (mg_vec_compress_tol[level] < 0.0) {
+      printf("ERROR: invalid compression tolerance %e\n", mg_vec_compress_tol[level]);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--df-nev") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -3691,6 +3730,71 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if (strcmp(argv[i], "--df-resident-ritz") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    ritz_resident_dim = atoi(argv[i + 1]);
+    if (ritz_resident_dim < 0) {
+      printf("ERROR: invalid number of resident ritz vectors %d\n", ritz_resident_dim);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--df-spill-prec-ritz") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    prec_ritz_spill = get_prec(argv[i + 1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--chrono-resident-dim") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    chrono_resident_dim = atoi(argv[i + 1]);
+    if (chrono_resident_dim < 0) {
+      printf("ERROR: invalid number of resident chronological vectors %d\n", chrono_resident_dim);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--chrono-spill-prec") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    prec_chrono_spill = get_prec(argv[i + 1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--recycle-prec") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    prec_recycle = get_prec(argv[i + 1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--recycle-keep") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+
+    if (strcmp(argv[i + 1], "true") == 0) {
+      recycle_keep_on_update = true;
+    } else if (strcmp(argv[i + 1], "false") == 0) {
+      recycle_keep_on_update = false;
+    } else {
+      fprintf(stderr, "ERROR: invalid recycle-keep type\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if (strcmp(argv[i], "--eig-nEv") == 0) {
     if (i + 1 >= argc) { usage(argv); }
     eig_nEv = atoi(argv[i + 1]);
@@ -3773,6 +3877,35 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if (strcmp(argv[i], "--eig-poly-acc-auto") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+
+    if (strcmp(argv[i + 1], "true") == 0) {
+      eig_poly_acc_auto = true;
+    } else if (strcmp(argv[i + 1], "false") == 0) {
+      eig_poly_acc_auto = false;
+    } else {
+      fprintf(stderr, "ERROR: invalid value for poly-acc-auto (true/false)\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--eig-poly-acc-rate") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    eig_poly_acc_rate = atof(argv[i + 1]);
+    if (eig_poly_acc_rate <= 0.0 || eig_poly_acc_rate >= 1.0) {
+      printf("ERROR: invalid polynomial acceleration rate %e\n", eig_poly_acc_rate);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if (strcmp(argv[i], "--eig-poly-deg") == 0) {
     if (i + 1 >= argc) { usage(argv); }
     eig_poly_deg = atoi(argv[i + 1]);
@@ -3864,6 +3997,35 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if (strcmp(argv[i], "--eig-block-size") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    eig_block_size = atoi(argv[i + 1]);
+    if (eig_block_size < 1) {
+      printf("ERROR: invalid eigensolver block size %d\n", eig_block_size);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--eig-benchmark") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+
+    if (strcmp(argv[i + 1], "true") == 0) {
+      eig_benchmark = true;
+    } else if (strcmp(argv[i + 1], "false") == 0) {
+      eig_benchmark = false;
+    } else {
+      fprintf(stderr, "ERROR: invalid value for eig-benchmark (true/false)\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if (strcmp(argv[i], "--eig-ARPACK-logfile") == 0) {
     if (i + 1 >= argc) { usage(argv); }
     strcpy(eig_arpack_logfile, argv[i + 1]);
@@ -3913,6 +4075,44 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if (strcmp(argv[i], "--eig-compress-vec") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    eig_vec_compress_n_basis = atoi(argv[i + 1]);
+    if (eig_vec_compress_n_basis < 0) {
+      printf("ERROR: invalid number of compression basis vectors %d\n", eig_vec_compress_n_basis);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--eig-compress-block") == 0) {
+    if (i + 4 >= argc) { usage(argv); }
+    for (int d = 0; d < 4; d++) {
+      eig_vec_compress_block[d] = atoi(argv[i + 1]);
+      if (eig_vec_compress_block[d] <= 0) {
+        printf("ERROR: invalid compression block size %d\n", eig_vec_compress_block[d]);
+        usage(argv);
+      }
+      i++;
+    }
+    ret = 0;
+    goto out;
+  }
+
+  if (strcmp(argv[i], "--eig-compress-tol") == 0) {
+    if (i + 1 >= argc) { usage(argv); }
+    eig_vec_compress_tol = atof(argv[i + 1]);
+    if (eig_vec_compress_tol < 0.0) {
+      printf("ERROR: invalid compression tolerance %e\n", eig_vec_compress_tol);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if (strcmp(argv[i], "--mg-eig") == 0) {
     if (i + 1 >= argc) { usage(argv); }
     int level = atoi(argv[i + 1]);
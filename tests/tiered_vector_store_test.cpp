@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <tiered_vector_store.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test checks the two-tier vector store used for deflation spaces
+// and chronological bases against the same vectors held entirely in
+// resident fields, and benchmarks streaming the spilled vectors.  The
+// logic is independent of the location, so it is exercised on host
+// fields.  The number of vectors is taken from --eig-nEv, the number
+// kept resident from --df-resident-ritz (default a quarter of them) and
+// the spill precision from --df-spill-prec-ritz.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern int niter;
+extern int eig_nEv;
+extern int ritz_resident_dim;
+extern QudaPrecision prec_ritz_spill;
+extern void usage(char **argv);
+
+ColorSpinorParam csParam;
+
+class TieredVectorStoreTest : public ::testing::Test
+{
+protected:
+  std::vector<ColorSpinorField *> ref;
+  std::vector<ColorSpinorField *> y;
+  int n;
+  int n_resident;
+  const int block_size = 4;
+  const int n_rhs = 3;
+
+  void SetUp()
+  {
+    n = eig_nEv;
+    n_resident = ritz_resident_dim > 0 ? std::min(ritz_resident_dim, n) : n / 4;
+    for (int i = 0; i < n; i++) {
+      ref.push_back(ColorSpinorField::Create(csParam));
+      ref.back()->Source(QUDA_RANDOM_SOURCE);
+    }
+    for (int j = 0; j < n_rhs; j++) {
+      y.push_back(ColorSpinorField::Create(csParam));
+      y.back()->Source(QUDA_RANDOM_SOURCE);
+    }
+  }
+
+  void TearDown()
+  {
+    for (auto &v : ref) delete v;
+    for (auto &v : y) delete v;
+  }
+
+  void fill(TieredVectorStore &store)
+  {
+    for (int i = 0; i < n; i++) store.set(i, *ref[i]);
+  }
+
+  // the tolerance allowed by rounding the spilled vectors to the spill precision
+  double tol(QudaPrecision spill_precision) const
+  {
+    QudaPrecision p = std::min(spill_precision, prec);
+    return p == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5;
+  }
+
+  double relDiff(ColorSpinorField &a, ColorSpinorField &b)
+  {
+    ColorSpinorField *tmp = ColorSpinorField::Create(csParam);
+    *tmp = a;
+    blas::axpy(-1.0, b, *tmp);
+    double diff = sqrt(blas::norm2(*tmp) / blas::norm2(b));
+    delete tmp;
+    return diff;
+  }
+};
+
+TEST_F(TieredVectorStoreTest, verify)
+{
+  TieredVectorStore store(csParam, n, n_resident, prec, block_size);
+  fill(store);
+  ASSERT_EQ(store.Size(), n);
+  ASSERT_EQ(store.NumResident(), n_resident);
+
+  // at the resident precision the store must reproduce the vectors exactly
+  ColorSpinorField *v = ColorSpinorField::Create(csParam);
+  for (int i = 0; i < n; i++) {
+    store.get(*v, i);
+    blas::axpy(-1.0, *ref[i], *v);
+    EXPECT_EQ(blas::norm2(*v), 0.0) << "vector " << i;
+  }
+  delete v;
+
+  // streamed blocks must visit every vector once and in order
+  int next = 0;
+  store.apply([&](std::vector<ColorSpinorField *> &block, int offset) {
+    EXPECT_EQ(offset, next);
+    EXPECT_TRUE(offset < n_resident || (int)block.size() <= block_size);
+    for (unsigned int i = 0; i < block.size(); i++) EXPECT_EQ(relDiff(*block[i], *ref[offset + i]), 0.0);
+    next += block.size();
+  });
+  EXPECT_EQ(next, n);
+}
+
+TEST_F(TieredVectorStoreTest, blas)
+{
+  for (QudaPrecision spill_precision : {prec, prec_ritz_spill}) {
+    if (spill_precision == QUDA_INVALID_PRECISION) continue;
+    TieredVectorStore store(csParam, n, n_resident, spill_precision, block_size);
+    fill(store);
+    const double eps = tol(spill_precision);
+
+    // rounding errors are bounded relative to the norms of the factors
+    std::vector<double> ref_norm(n), y_norm(n_rhs);
+    for (int i = 0; i < n; i++) ref_norm[i] = sqrt(blas::norm2(*ref[i]));
+    for (int j = 0; j < n_rhs; j++) y_norm[j] = sqrt(blas::norm2(*y[j]));
+
+    // inner products with a set of vectors
+    std::vector<Complex> dot(n * n_rhs), dot_ref(n * n_rhs);
+    store.cDotProduct(dot.data(), y);
+    blas::cDotProduct(dot_ref.data(), ref, y);
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n_rhs; j++)
+        EXPECT_LE(abs(dot[i * n_rhs + j] - dot_ref[i * n_rhs + j]), eps * ref_norm[i] * y_norm[j]) << i << " " << j;
+
+    // inner products of the store with itself
+    std::vector<Complex> gram(n * n), gram_ref(n * n);
+    store.cDotProduct(gram.data(), store);
+    blas::cDotProduct(gram_ref.data(), ref, ref);
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        EXPECT_LE(abs(gram[i * n + j] - gram_ref[i * n + j]), eps * ref_norm[i] * ref_norm[j]) << i << " " << j;
+
+    // linear combinations of a leading subset
+    const int m = n - 1;
+    std::vector<Complex> a(m * n_rhs);
+    for (auto &z : a) z = Complex(rand() / (double)RAND_MAX - 0.5, rand() / (double)RAND_MAX - 0.5);
+    std::vector<ColorSpinorField *> z, z_ref;
+    for (int j = 0; j < n_rhs; j++) {
+      z.push_back(ColorSpinorField::Create(csParam));
+      z_ref.push_back(ColorSpinorField::Create(csParam));
+      *z[j] = *y[j];
+      *z_ref[j] = *y[j];
+    }
+    std::vector<ColorSpinorField *> ref_m(ref.begin(), ref.begin() + m);
+    store.caxpy(a.data(), z, m);
+    blas::caxpy(a.data(), ref_m, z_ref);
+    for (int j = 0; j < n_rhs; j++) {
+      EXPECT_LE(relDiff(*z[j], *z_ref[j]), eps) << "rhs " << j;
+      delete z[j];
+      delete z_ref[j];
+    }
+  }
+}
+
+TEST_F(TieredVectorStoreTest, chronology)
+{
+  // a chronology shorter than the number of vectors pushed: the newest
+  // vector is at the front and the oldest are dropped
+  const int capacity = n / 2;
+  TieredVectorStore store(csParam, capacity, std::min(n_resident, capacity / 2), prec, block_size);
+  std::deque<ColorSpinorField *> history;
+
+  ColorSpinorField *v = ColorSpinorField::Create(csParam);
+  for (int k = 0; k < n; k++) {
+    if (k % 5 == 4) {
+      // replace the newest entry as with chrono_replace_last
+      store.set(0, *ref[k]);
+      history.front() = ref[k];
+    } else {
+      store.pushFront(*ref[k]);
+      history.push_front(ref[k]);
+      if ((int)history.size() > capacity) history.pop_back();
+    }
+
+    ASSERT_EQ(store.Size(), (int)history.size());
+    for (int i = 0; i < store.Size(); i++) {
+      store.get(*v, i);
+      EXPECT_EQ(relDiff(*v, *history[i]), 0.0) << "push " << k << " vector " << i;
+    }
+  }
+  delete v;
+}
+
+TEST_F(TieredVectorStoreTest, benchmark)
+{
+  QudaPrecision spill_precision = prec_ritz_spill == QUDA_INVALID_PRECISION ? prec : prec_ritz_spill;
+  TieredVectorStore store(csParam, n, n_resident, spill_precision, block_size);
+  fill(store);
+
+  std::vector<Complex> dot(n * n_rhs);
+  quda::Timer timer;
+
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) blas::cDotProduct(dot.data(), ref, y);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double resident_secs = timer.Last() / niter;
+
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) store.cDotProduct(dot.data(), y);
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double tiered_secs = timer.Last() / niter;
+
+  const double bytes = (double)n * ref[0]->Bytes();
+  printfQuda("Projection onto %d vectors (%d resident, spill precision %d): resident %.3f GB/s, tiered %.3f GB/s, "
+             "spilled %.1f MiB\n",
+             n, n_resident, spill_precision, 1e-9 * bytes / resident_secs, 1e-9 * bytes / tiered_secs,
+             store.SpilledBytes() / (double)(1 << 20));
+  RecordProperty("ResidentGBs", std::to_string(1e-9 * bytes / resident_secs));
+  RecordProperty("TieredGBs", std::to_string(1e-9 * bytes / tiered_secs));
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+
+  // host fields only
+  if (prec != QUDA_DOUBLE_PRECISION) prec = QUDA_SINGLE_PRECISION;
+  if (prec_ritz_spill != QUDA_INVALID_PRECISION && prec_ritz_spill != QUDA_DOUBLE_PRECISION)
+    prec_ritz_spill = QUDA_SINGLE_PRECISION;
+
+  int X[4] = {xdim, ydim, zdim, tdim};
+  setDims(X);
+
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+  csParam.setPrecision(prec);
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_PARITY_SITE_SUBSET;
+  csParam.x[0] /= 2;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  csParam.location = QUDA_CPU_FIELD_LOCATION;
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}
@@ -0,0 +1,315 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <lattice_geometry.h>
+#include <vector_compression.h>
+#include <timer.h>
+
+#include <misc.h>
+#include <test_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace quda;
+
+// This test compresses the low modes of a test operator, the free
+// lattice Laplacian acting on Wilson spinors, with the local coherence
+// store and reports the compression ratio, the bandwidth of loading
+// and reconstructing the vectors, and the loss of deflation quality
+// as the eigen-residual of the reconstructed modes.  The number of
+// modes is taken from --eig-nEv, and the compression parameters from
+// --eig-compress-vec, --eig-compress-block and --eig-compress-tol.
+
+extern int device;
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaPrecision prec;
+extern int niter;
+extern int eig_nEv;
+extern int eig_vec_compress_n_basis;
+extern int eig_vec_compress_block[4];
+extern double eig_vec_compress_tol;
+extern void usage(char **argv);
+
+ColorSpinorParam csParam;
+VectorCompressionParam compress_param;
+const char *store_file = "vector_compression_test.dat";
+
+// apply the periodic free Laplacian of the local lattice to each spin-color component
+template <typename Float> void laplace(Float *out, const Float *in)
+{
+  const LatticeGeometry &geom = getLatticeGeometry(csParam.x);
+  const int *nbr[8];
+  for (int d = 0; d < 4; d++) {
+    nbr[2 * d + 0] = geom.Neighbors(d, +1);
+    nbr[2 * d + 1] = geom.Neighbors(d, -1);
+  }
+  const int site_length = 2 * csParam.nSpin * csParam.nColor;
+#pragma omp parallel for
+  for (int i = 0; i < geom.Volume(); i++) {
+    for (int j = 0; j < site_length; j++) {
+      double sum = 8.0 * in[i * site_length + j];
+      for (int n = 0; n < 8; n++) sum -= in[nbr[n][i] * site_length + j];
+      out[i * site_length + j] = sum;
+    }
+  }
+}
+
+void laplace(ColorSpinorField &out, const ColorSpinorField &in)
+{
+  if (in.Precision() == QUDA_DOUBLE_PRECISION)
+    laplace(static_cast<double *>(out.V()), static_cast<const double *>(in.V()));
+  else
+    laplace(static_cast<float *>(out.V()), static_cast<const float *>(in.V()));
+}
+
+class VectorCompressionTest : public ::testing::Test
+{
+protected:
+  std::vector<ColorSpinorField *> evecs;
+  std::vector<ColorSpinorField *> recon;
+  std::vector<double> evals;
+  ColorSpinorField *tmp;
+
+  // Eigenvectors of the Laplacian are plane waves with a constant
+  // spin-color polarization.  Modes are taken in order of increasing
+  // eigenvalue, with orthonormal polarizations for each momentum.
+  template <typename Float> void planeWave(Float *v_, const int n[4], const Complex *u)
+  {
+    std::complex<Float> *v = reinterpret_cast<std::complex<Float> *>(v_);
+    const LatticeGeometry &geom = getLatticeGeometry(csParam.x);
+    const int site_length = csParam.nSpin * csParam.nColor;
+#pragma omp parallel for
+    for (int i = 0; i < geom.Volume(); i++) {
+      int x[4];
+      geom.Coords(x, i);
+      double phase = 0.0;
+      for (int d = 0; d < 4; d++) phase += 2 * M_PI * n[d] * x[d] / csParam.x[d];
+      const Complex e(cos(phase), sin(phase));
+      for (int j = 0; j < site_length; j++) v[i * site_length + j] = e * u[j];
+    }
+  }
+
+  void SetUp()
+  {
+    std::vector<std::vector<int>> momenta;
+    for (int n0 = -2; n0 <= 2; n0++)
+      for (int n1 = -2; n1 <= 2; n1++)
+        for (int n2 = -2; n2 <= 2; n2++)
+          for (int n3 = -2; n3 <= 2; n3++) momenta.push_back({n0, n1, n2, n3});
+    auto lambda = [](const std::vector<int> &n) {
+      double l = 0.0;
+      for (int d = 0; d < 4; d++) l += 4 * pow(sin(M_PI * n[d] / csParam.x[d]), 2);
+      return l;
+    };
+    std::stable_sort(momenta.begin(), momenta.end(),
+                     [&](const std::vector<int> &a, const std::vector<int> &b) { return lambda(a) < lambda(b); });
+
+    const int site_length = csParam.nSpin * csParam.nColor;
+    std::vector<Complex> u(site_length * site_length);
+    for (int i = 0; i < eig_nEv; i++) {
+      const int p = i / site_length;
+      const int a = i % site_length;
+
+      // orthonormal polarizations for each momentum by Gram-Schmidt
+      if (a == 0) {
+        for (auto &z : u) z = Complex(rand() / (double)RAND_MAX - 0.5, rand() / (double)RAND_MAX - 0.5);
+        for (int j = 0; j < site_length; j++) {
+          Complex *uj = &u[j * site_length];
+          for (int k = 0; k < j; k++) {
+            Complex dot = 0.0;
+            for (int l = 0; l < site_length; l++) dot += conj(u[k * site_length + l]) * uj[l];
+            for (int l = 0; l < site_length; l++) uj[l] -= dot * u[k * site_length + l];
+          }
+          double norm = 0.0;
+          for (int l = 0; l < site_length; l++) norm += std::norm(uj[l]);
+          for (int l = 0; l < site_length; l++) uj[l] /= sqrt(norm);
+        }
+      }
+
+      evecs.push_back(ColorSpinorField::Create(csParam));
+      if (prec == QUDA_DOUBLE_PRECISION)
+        planeWave(static_cast<double *>(evecs[i]->V()), momenta[p].data(), &u[a * site_length]);
+      else
+        planeWave(static_cast<float *>(evecs[i]->V()), momenta[p].data(), &u[a * site_length]);
+      evals.push_back(lambda(momenta[p]));
+      recon.push_back(ColorSpinorField::Create(csParam));
+    }
+    tmp = ColorSpinorField::Create(csParam);
+  }
+
+  void TearDown()
+  {
+    for (auto &v : evecs) delete v;
+    for (auto &v : recon) delete v;
+    delete tmp;
+  }
+
+  // relative eigen-residual of a mode, the measure of its quality for deflation
+  double residual(ColorSpinorField &v, double lambda)
+  {
+    laplace(*tmp, v);
+    blas::axpy(-lambda, v, *tmp);
+    return sqrt(blas::norm2(*tmp) / blas::norm2(v));
+  }
+};
+
+TEST_F(VectorCompressionTest, verify)
+{
+  CompressedVectorStore store(compress_param);
+  store.compress(evecs);
+  store.save(store_file);
+
+  // the round trip through the file must reproduce the in-memory store exactly
+  CompressedVectorStore loaded {VectorCompressionParam()};
+  loaded.load(store_file);
+  ASSERT_EQ(loaded.Nvec(), eig_nEv);
+  ASSERT_EQ(loaded.Bytes(), store.Bytes());
+  store.reconstruct(recon);
+  loaded.reconstruct(evecs);
+  for (int i = 0; i < eig_nEv; i++) {
+    blas::axpy(-1.0, *recon[i], *evecs[i]);
+    EXPECT_EQ(blas::norm2(*evecs[i]), 0.0) << "vector " << i;
+  }
+  remove(store_file);
+}
+
+TEST_F(VectorCompressionTest, quality)
+{
+  CompressedVectorStore store(compress_param);
+  store.compress(evecs);
+  store.reconstruct(recon);
+
+  // the basis vectors only carry quantization error, and every other
+  // vector at most its projection residual on top of it
+  const double eps = prec == QUDA_DOUBLE_PRECISION ? 1e-12 : 1e-5;
+  const double tol = compress_param.tol;
+  const double bound = sqrt(tol * tol + store.ProjectionResidual() * store.ProjectionResidual());
+  double max_res = 0.0;
+  double max_res_ref = 0.0;
+  double max_err = 0.0;
+  for (int i = 0; i < eig_nEv; i++) {
+    max_res_ref = std::max(max_res_ref, residual(*evecs[i], evals[i]));
+    max_res = std::max(max_res, residual(*recon[i], evals[i]));
+
+    blas::axpy(-1.0, *evecs[i], *recon[i]);
+    const double err = sqrt(blas::norm2(*recon[i]) / blas::norm2(*evecs[i]));
+    max_err = std::max(max_err, err);
+    EXPECT_LE(err, (i < compress_param.n_basis ? tol : bound) + eps) << "vector " << i;
+  }
+
+  const double ratio = (double)store.VectorBytes() / store.Bytes();
+  printfQuda("Compressed %d modes with %d basis vectors: ratio %.2f, max relative error %e, eigen-residual %e "
+             "(uncompressed %e)\n",
+             eig_nEv, compress_param.n_basis, ratio, max_err, max_res, max_res_ref);
+  RecordProperty("CompressionRatio", std::to_string(ratio));
+  RecordProperty("MaxRelativeError", std::to_string(max_err));
+  RecordProperty("EigenResidual", std::to_string(max_res));
+  RecordProperty("EigenResidualUncompressed", std::to_string(max_res_ref));
+}
+
+TEST_F(VectorCompressionTest, benchmark)
+{
+  CompressedVectorStore store(compress_param);
+  store.compress(evecs);
+  store.save(store_file);
+
+  // reference: the raw vectors written and read at full precision
+  const std::string raw_file = std::string(store_file) + ".raw";
+  FILE *fp = fopen(raw_file.c_str(), "wb");
+  ASSERT_NE(fp, nullptr);
+  for (auto &v : evecs) fwrite(v->V(), v->Bytes(), 1, fp);
+  fclose(fp);
+
+  quda::Timer timer;
+  timer.Start(__func__, __FILE__, __LINE__);
+  for (int iter = 0; iter < niter; iter++) {
+    fp = fopen(raw_file.c_str(), "rb");
+    for (auto &v : recon) ASSERT_EQ(fread(v->V(), v->Bytes(), 1, fp), 1u);
+    fclose(fp);
+  }
+  timer.Stop(__func__, __FILE__, __LINE__);
+  const double raw_secs = timer.Last() / niter;
+
+  CompressedVectorStore loaded {VectorCompressionParam()};
+  double load_secs = 0.0;
+  double recon_secs = 0.0;
+  for (int iter = 0; iter < niter; iter++) {
+    timer.Start(__func__, __FILE__, __LINE__);
+    loaded.load(store_file);
+    timer.Stop(__func__, __FILE__, __LINE__);
+    load_secs += timer.Last() / niter;
+
+    timer.Start(__func__, __FILE__, __LINE__);
+    loaded.reconstruct(recon);
+    timer.Stop(__func__, __FILE__, __LINE__);
+    recon_secs += timer.Last() / niter;
+  }
+
+  const double bytes = store.VectorBytes();
+  printfQuda("Loading %d modes (%.1f MiB): raw %.3f GB/s, compressed %.3f GB/s (read %.3f s, reconstruct %.3f s)\n",
+             eig_nEv, bytes / (1 << 20), 1e-9 * bytes / raw_secs, 1e-9 * bytes / (load_secs + recon_secs),
+             load_secs, recon_secs);
+  RecordProperty("RawLoadGBs", std::to_string(1e-9 * bytes / raw_secs));
+  RecordProperty("CompressedLoadGBs", std::to_string(1e-9 * bytes / (load_secs + recon_secs)));
+
+  remove(store_file);
+  remove(raw_file.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  // initalize google test
+  ::testing::InitGoogleTest(&argc, argv);
+  for (int i = 1; i < argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+    fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+    usage(argv);
+  }
+
+  if (eig_vec_compress_n_basis <= 0) eig_vec_compress_n_basis = eig_nEv / 2;
+  if (eig_vec_compress_n_basis > eig_nEv)
+    errorQuda("Number of basis vectors %d exceeds number of modes %d", eig_vec_compress_n_basis, eig_nEv);
+  compress_param.n_basis = eig_vec_compress_n_basis;
+  for (int d = 0; d < 4; d++) compress_param.block_size[d] = eig_vec_compress_block[d];
+  compress_param.tol = eig_vec_compress_tol;
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  initQuda(device);
+
+  // host fields only
+  if (prec != QUDA_DOUBLE_PRECISION) prec = QUDA_SINGLE_PRECISION;
+
+  int X[4] = {xdim, ydim, zdim, tdim};
+  setDims(X);
+
+  csParam.nColor = 3;
+  csParam.nSpin = 4;
+  csParam.nDim = 4;
+  for (int d = 0; d < 4; d++) csParam.x[d] = X[d];
+  csParam.setPrecision(prec);
+  csParam.pad = 0;
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  csParam.location = QUDA_CPU_FIELD_LOCATION;
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int test_rc = RUN_ALL_TESTS();
+
+  endQuda();
+  finalizeComms();
+  return test_rc;
+}